@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+# Copyright (c) Facebook, Inc. and its affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+#
+# Startup-time report: lists every translation unit in the built
+# library that still registers a dynamic initializer (_GLOBAL__sub_I_*
+# in .init_array), i.e. work that runs before main() in all processes
+# linking proxygen.  The heavyweight tables are already clean - the
+# HPACK/QPACK static tables and the huffman tree are lazy
+# function-local statics built on first use, and the SPDY dictionaries
+# are plain char arrays in rodata - so what this reports is the long
+# tail of namespace-scope std::string constants and similar.
+#
+# Usage: ./check-static-init.sh <build-dir>   (default: _build)
+# Exit status 1 when any initializer is found, so CI can hold the line
+# once a target reaches zero.
+
+set -e
+
+BUILD_DIR=${1:-_build}
+found=0
+
+while IFS= read -r object; do
+  inits=$(nm -C "$object" 2>/dev/null | grep -c "_GLOBAL__sub_I" || true)
+  if [ "$inits" -gt 0 ]; then
+    echo "$inits  $object"
+    found=1
+  fi
+done < <(find "$BUILD_DIR" -name '*.o' -path '*proxygen*' | sort)
+
+if [ "$found" -eq 0 ]; then
+  echo "no dynamic initializers found"
+fi
+exit $found
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/httpclient/loadgen/LoadGenerator.h>
+
+#include <glog/logging.h>
+#include <proxygen/lib/http/codec/HTTP2Constants.h>
+
+namespace proxygen {
+
+/**
+ * Pooled per-request bookkeeping: stamps the send time, records the
+ * send-to-EOM latency, and returns itself to the generator's pool on
+ * detach.
+ */
+class LoadGenerator::RequestRecorder : public HTTPTransactionHandler {
+ public:
+  explicit RequestRecorder(LoadGenerator* generator)
+      : generator_(generator) {
+  }
+
+  void arm() {
+    startTime_ = std::chrono::steady_clock::now();
+    failed_ = false;
+  }
+
+  void setTransaction(HTTPTransaction* txn) noexcept override {
+    txn_ = txn;
+  }
+  void detachTransaction() noexcept override {
+    txn_ = nullptr;
+    generator_->recorderPool_.emplace_back(this);
+    generator_->inFlight_--;
+    generator_->maybeComplete();
+  }
+  void onHeadersComplete(std::unique_ptr<HTTPMessage>) noexcept override {
+  }
+  void onBody(std::unique_ptr<folly::IOBuf>) noexcept override {
+  }
+  void onChunkHeader(size_t) noexcept override {
+  }
+  void onChunkComplete() noexcept override {
+  }
+  void onTrailers(std::unique_ptr<HTTPHeaders>) noexcept override {
+  }
+  void onEOM() noexcept override {
+    if (!failed_) {
+      auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - startTime_);
+      generator_->latency_.record(uint64_t(latency.count()));
+      generator_->responsesReceived_++;
+    }
+  }
+  void onUpgrade(UpgradeProtocol) noexcept override {
+  }
+  void onError(const HTTPException&) noexcept override {
+    failed_ = true;
+    generator_->errors_++;
+  }
+  void onEgressPaused() noexcept override {
+  }
+  void onEgressResumed() noexcept override {
+  }
+
+ private:
+  LoadGenerator* generator_;
+  HTTPTransaction* txn_{nullptr};
+  std::chrono::steady_clock::time_point startTime_;
+  bool failed_{false};
+};
+
+LoadGenerator::LoadGenerator(Options options)
+    : options_(std::move(options)) {
+  CHECK_GT(options_.requestsPerSecond, 0);
+  // default canned request
+  requestTemplate_.setMethod(HTTPMethod::GET);
+  requestTemplate_.setHTTPVersion(1, 1);
+  requestTemplate_.setURL("/");
+}
+
+LoadGenerator::~LoadGenerator() {
+  stop();
+}
+
+void LoadGenerator::setRequestTemplate(HTTPMessage request) {
+  requestTemplate_ = std::move(request);
+}
+
+void LoadGenerator::setRequestCustomizer(
+    folly::Function<void(HTTPMessage&)> customizer) {
+  customizer_ = std::move(customizer);
+}
+
+void LoadGenerator::start(folly::EventBase* evb,
+                          folly::Function<void()> onComplete) {
+  CHECK(!running_);
+  evb_ = evb;
+  attachEventBase(evb);
+  onComplete_ = std::move(onComplete);
+  running_ = true;
+  startTime_ = std::chrono::steady_clock::now();
+  timer_ = folly::HHWheelTimer::newTimer(evb);
+
+  for (uint32_t i = 0; i < options_.numConnections; i++) {
+    auto connector = std::make_unique<HTTPConnector>(this, timer_.get());
+    if (options_.useHttp2) {
+      connector->setPlaintextProtocol(http2::kProtocolCleartextString);
+    }
+    connector->connect(evb_, options_.target, options_.connectTimeout);
+    connectors_.push_back(std::move(connector));
+  }
+  scheduleTimeout(1);
+}
+
+void LoadGenerator::stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+  cancelTimeout();
+  // drain a copy: destruction re-enters onDestroy, which edits the
+  // list; also detach the info callback, since the generator may be
+  // destroyed before the sessions finish dying
+  auto sessions = sessions_;
+  for (auto* session : sessions) {
+    session->setInfoCallback(nullptr);
+    session->drain();
+  }
+  sessions_.clear();
+}
+
+void LoadGenerator::connectSuccess(HTTPUpstreamSession* session) {
+  if (!running_) {
+    session->drain();
+    return;
+  }
+  session->setInfoCallback(this);
+  session->setMaxConcurrentOutgoingStreams(
+      options_.maxConcurrentStreamsPerConnection);
+  if (sessions_.empty()) {
+    // the arrival clock starts with the first usable connection, so
+    // connect latency doesn't get booked as a burst of shed arrivals
+    startTime_ = std::chrono::steady_clock::now();
+  }
+  sessions_.push_back(session);
+}
+
+void LoadGenerator::connectError(const folly::AsyncSocketException& ex) {
+  LOG(ERROR) << "loadgen connect failed: " << ex.what();
+  errors_++;
+}
+
+void LoadGenerator::onDestroy(const HTTPSessionBase& session) {
+  for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+    if (*it == &session) {
+      sessions_.erase(it);
+      break;
+    }
+  }
+}
+
+void LoadGenerator::timeoutExpired() noexcept {
+  issueDueArrivals();
+  if (running_) {
+    scheduleTimeout(1);
+  }
+}
+
+void LoadGenerator::issueDueArrivals() {
+  // open loop: arrivals owed by the wall clock, regardless of
+  // completions
+  if (sessions_.empty()) {
+    return; // not connected yet; the clock starts at first connect
+  }
+  auto elapsed = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - startTime_);
+  uint64_t due =
+      uint64_t(elapsed.count() * options_.requestsPerSecond);
+  if (options_.totalRequests > 0) {
+    due = std::min(due, options_.totalRequests);
+  }
+  uint64_t alreadyAccounted = requestsSent_ + shedArrivals_;
+  while (alreadyAccounted < due && running_) {
+    if (!issueOne()) {
+      shedArrivals_++;
+    }
+    alreadyAccounted++;
+  }
+  if (options_.totalRequests > 0 &&
+      requestsSent_ + shedArrivals_ >= options_.totalRequests) {
+    running_ = false;
+    cancelTimeout();
+    maybeComplete();
+  }
+}
+
+bool LoadGenerator::issueOne() {
+  auto session = pickSession();
+  if (!session) {
+    return false;
+  }
+  RequestRecorder* recorder;
+  if (!recorderPool_.empty()) {
+    recorder = recorderPool_.back().release();
+    recorderPool_.pop_back();
+  } else {
+    recorder = new RequestRecorder(this);
+  }
+  auto txn = session->newTransaction(recorder);
+  if (!txn) {
+    recorderPool_.emplace_back(recorder);
+    return false;
+  }
+  recorder->arm();
+  inFlight_++;
+  requestsSent_++;
+  if (customizer_) {
+    scratch_ = requestTemplate_;
+    customizer_(scratch_);
+    txn->sendHeaders(scratch_);
+  } else {
+    txn->sendHeaders(requestTemplate_);
+  }
+  txn->sendEOM();
+  return true;
+}
+
+HTTPUpstreamSession* LoadGenerator::pickSession() {
+  for (size_t i = 0; i < sessions_.size(); i++) {
+    auto* session = sessions_[(nextSession_ + i) % sessions_.size()];
+    if (session->supportsMoreTransactions()) {
+      nextSession_ = (nextSession_ + i + 1) % sessions_.size();
+      return session;
+    }
+  }
+  return nullptr;
+}
+
+void LoadGenerator::maybeComplete() {
+  if (!running_ && inFlight_ == 0 && onComplete_) {
+    auto sessions = sessions_; // drain may destroy and re-enter onDestroy
+    for (auto* session : sessions) {
+      session->drain();
+    }
+    auto complete = std::move(onComplete_);
+    onComplete_ = nullptr;
+    complete();
+  }
+}
+
+} // namespace proxygen
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/HHWheelTimer.h>
+#include <proxygen/lib/http/HTTPConnector.h>
+#include <proxygen/lib/http/session/HTTPUpstreamSession.h>
+#include <proxygen/lib/utils/PercentileHistogram.h>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * In-process load generator over HTTPUpstreamSession: the client-side
+ * counterpart to ScopedHTTPServer, so integration perf tests stop
+ * shelling out to external tools and latency attribution shares one
+ * clock with the server under test.
+ *
+ * Arrivals are open-loop: the schedule is derived from the configured
+ * rate and wall time, independent of completions, so a slow server
+ * builds visible queueing (or sheds, when concurrency is exhausted)
+ * instead of silently slowing the generator.  Arrivals that find no
+ * session with stream capacity are counted as shed, never queued.
+ *
+ * Requests come from a canned template reused for every send (the
+ * codec serializes from a const message, so steady-state issue
+ * allocates nothing) or from a customizer that stamps variations into
+ * a reusable scratch message; per-request bookkeeping objects are
+ * pooled.  Latencies (send to EOM, steady clock) land in a
+ * PercentileHistogram.
+ *
+ * h1 and h2 (cleartext upgrade) are supported through HTTPConnector;
+ * an h3 generator plugs in at the same seam via HQConnector once the
+ * deployment builds with QUIC - the scheduling, pooling and recording
+ * here are protocol-agnostic.
+ *
+ * Single event base; create, start and destroy on the same loop.
+ */
+class LoadGenerator : private folly::AsyncTimeout,
+                      private HTTPConnector::Callback,
+                      private HTTPSessionBase::InfoCallback {
+ public:
+  struct Options {
+    folly::SocketAddress target;
+    uint32_t numConnections{1};
+    /** Streams in flight per connection (h1 effectively caps at 1). */
+    uint32_t maxConcurrentStreamsPerConnection{8};
+    /** Open-loop arrival rate. */
+    double requestsPerSecond{1000};
+    /** Stop after this many sends; 0 = run until stop(). */
+    uint64_t totalRequests{0};
+    bool useHttp2{false};
+    std::chrono::milliseconds connectTimeout{1000};
+  };
+
+  explicit LoadGenerator(Options options);
+  ~LoadGenerator() override;
+
+  /** Canned request; reused as-is for every send. */
+  void setRequestTemplate(HTTPMessage request);
+
+  /** Stamps per-request variation into the reusable scratch message. */
+  void setRequestCustomizer(folly::Function<void(HTTPMessage&)> customizer);
+
+  /**
+   * Connect and start the arrival schedule.  onComplete fires once
+   * totalRequests have been sent and all responses (or errors) are
+   * accounted for; never fires when totalRequests is 0.
+   */
+  void start(folly::EventBase* evb,
+             folly::Function<void()> onComplete = nullptr);
+
+  /** Stop arrivals and drain connections. */
+  void stop();
+
+  uint64_t requestsSent() const {
+    return requestsSent_;
+  }
+  uint64_t responsesReceived() const {
+    return responsesReceived_;
+  }
+  uint64_t errors() const {
+    return errors_;
+  }
+  /** Arrivals that found no stream capacity (open-loop overload). */
+  uint64_t shedArrivals() const {
+    return shedArrivals_;
+  }
+  const PercentileHistogram& latencyHistogramUsecs() const {
+    return latency_;
+  }
+
+ private:
+  class RequestRecorder;
+  friend class RequestRecorder;
+
+  // arrival timer
+  void timeoutExpired() noexcept override;
+  void issueDueArrivals();
+  bool issueOne();
+  HTTPUpstreamSession* pickSession();
+  void maybeComplete();
+
+  // HTTPConnector::Callback
+  void connectSuccess(HTTPUpstreamSession* session) override;
+  void connectError(const folly::AsyncSocketException& ex) override;
+
+  // HTTPSessionBase::InfoCallback (session lifetime tracking)
+  void onDestroy(const HTTPSessionBase& session) override;
+
+  Options options_;
+  folly::EventBase* evb_{nullptr};
+  folly::HHWheelTimer::UniquePtr timer_;
+  std::vector<std::unique_ptr<HTTPConnector>> connectors_;
+  std::vector<HTTPUpstreamSession*> sessions_;
+  size_t nextSession_{0};
+
+  HTTPMessage requestTemplate_;
+  folly::Function<void(HTTPMessage&)> customizer_;
+  HTTPMessage scratch_;
+
+  std::vector<std::unique_ptr<RequestRecorder>> recorderPool_;
+  folly::Function<void()> onComplete_;
+
+  std::chrono::steady_clock::time_point startTime_;
+  uint64_t requestsSent_{0};
+  uint64_t responsesReceived_{0};
+  uint64_t errors_{0};
+  uint64_t shedArrivals_{0};
+  uint64_t inFlight_{0};
+  bool running_{false};
+  PercentileHistogram latency_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/httpclient/loadgen/LoadGenerator.h>
+
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/ScopedHTTPServer.h>
+
+using namespace proxygen;
+
+TEST(LoadGeneratorTest, OpenLoopAgainstScopedServer) {
+  // fast-lane responder keeps the server side trivial
+  HTTPServerOptions serverOptions;
+  serverOptions.threads = 2;
+  serverOptions.fastLaneRoutes.push_back(
+      [](const HTTPMessage&, HTTPServerOptions::PrebuiltResponse& response) {
+        response.body = folly::IOBuf::copyBuffer("pong");
+        return true;
+      });
+  HTTPServer::IPConfig cfg{folly::SocketAddress("127.0.0.1", 0),
+                           HTTPServer::Protocol::HTTP};
+  auto server = ScopedHTTPServer::start(cfg, std::move(serverOptions));
+  ASSERT_NE(server, nullptr);
+
+  LoadGenerator::Options options;
+  options.target =
+      folly::SocketAddress("127.0.0.1", uint16_t(server->getPort()));
+  options.numConnections = 2;
+  options.requestsPerSecond = 2000;
+  options.totalRequests = 50;
+
+  folly::EventBase evb;
+  LoadGenerator generator(options);
+  HTTPMessage request;
+  request.setMethod(HTTPMethod::GET);
+  request.setHTTPVersion(1, 1);
+  request.setURL("/ping");
+  generator.setRequestTemplate(std::move(request));
+
+  bool completed = false;
+  generator.start(&evb, [&] {
+    completed = true;
+    evb.terminateLoopSoon();
+  });
+  evb.loopForever();
+
+  EXPECT_TRUE(completed);
+  EXPECT_EQ(generator.requestsSent() + generator.shedArrivals(), 50);
+  EXPECT_GT(generator.responsesReceived(), 0);
+  EXPECT_EQ(generator.responsesReceived(),
+            generator.latencyHistogramUsecs().count());
+  // in-process, loopback: p99 should be well under a second
+  EXPECT_LT(generator.latencyHistogramUsecs().estimatePercentile(99.0),
+            1000000);
+}
+
+TEST(LoadGeneratorTest, CustomizerStampsRequests) {
+  HTTPServerOptions serverOptions;
+  serverOptions.threads = 1;
+  std::atomic<uint32_t> distinctPaths{0};
+  serverOptions.fastLaneRoutes.push_back(
+      [&distinctPaths](const HTTPMessage& msg,
+                       HTTPServerOptions::PrebuiltResponse&) {
+        if (msg.getPath().find("/item/") == 0) {
+          distinctPaths++;
+        }
+        return true;
+      });
+  HTTPServer::IPConfig cfg{folly::SocketAddress("127.0.0.1", 0),
+                           HTTPServer::Protocol::HTTP};
+  auto server = ScopedHTTPServer::start(cfg, std::move(serverOptions));
+
+  LoadGenerator::Options options;
+  options.target =
+      folly::SocketAddress("127.0.0.1", uint16_t(server->getPort()));
+  options.requestsPerSecond = 2000;
+  options.totalRequests = 10;
+
+  folly::EventBase evb;
+  LoadGenerator generator(options);
+  uint64_t counter = 0;
+  generator.setRequestCustomizer([&counter](HTTPMessage& msg) {
+    msg.setURL(folly::to<std::string>("/item/", counter++));
+  });
+  generator.start(&evb, [&] { evb.terminateLoopSoon(); });
+  evb.loopForever();
+
+  EXPECT_GT(distinctPaths.load(), 0);
+}
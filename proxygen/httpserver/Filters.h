@@ -84,6 +84,14 @@ class Filter : public RequestHandler, public ResponseHandler {
   }
 
   // Response handler
+  void yield(folly::Function<void()> continuation) noexcept override {
+    downstream_->yield(std::move(continuation));
+  }
+
+  bool shouldYield(std::chrono::microseconds budget) const noexcept override {
+    return downstream_->shouldYield(budget);
+  }
+
   void sendHeaders(HTTPMessage& msg) noexcept override {
     downstream_->sendHeaders(msg);
   }
@@ -112,14 +112,11 @@ class HandlerCallbacks : public ThreadPoolExecutor::Observer {
 };
 
 folly::Expected<folly::Unit, std::exception_ptr> HTTPServer::startTcpServer() {
-  auto accExe = std::make_shared<IOThreadPoolExecutor>(1);
-  auto exe = std::make_shared<IOThreadPoolExecutor>(options_->threads,
-    std::make_shared<folly::NamedThreadFactory>("HTTPSrvExec"));
   auto exeObserver = std::make_shared<HandlerCallbacks>(options_);
-  // Observer has to be set before bind(), so onServerStart() callbacks run
-  exe->addObserver(exeObserver);
 
-  try {
+  auto bindOneShard = [&](std::shared_ptr<IOThreadPoolExecutor> acceptExe,
+                          std::shared_ptr<IOThreadPoolExecutor> childExe,
+                          bool reusePort) {
     FOR_EACH_RANGE (i, 0, addresses_.size()) {
       auto codecFactory = addresses_[i].codecFactory;
       auto accConfig = HTTPServerAcceptor::makeConfig(addresses_[i], *options_);
@@ -130,29 +127,76 @@ folly::Expected<folly::Unit, std::exception_ptr> HTTPServer::startTcpServer() {
           sessionInfoCb_);
       bootstrap_.push_back(
           wangle::ServerBootstrap<wangle::DefaultPipeline>());
-      bootstrap_[i].childHandler(factory);
+      auto& bootstrap = bootstrap_.back();
+      bootstrap.childHandler(factory);
       if (accConfig.enableTCPFastOpen) {
         // We need to do this because wangle's bootstrap has 2 acceptor configs
         // and the socketConfig gets passed to the SocketFactory. The number of
         // configs should really be one, and when that happens, we can remove
         // this code path.
-        bootstrap_[i].socketConfig.enableTCPFastOpen = true;
-        bootstrap_[i].socketConfig.fastOpenQueueSize =
+        bootstrap.socketConfig.enableTCPFastOpen = true;
+        bootstrap.socketConfig.fastOpenQueueSize =
             accConfig.fastOpenQueueSize;
       }
-      bootstrap_[i].group(accExe, exe);
-      if (options_->preboundSockets_.size() > 0) {
-        bootstrap_[i].bind(std::move(options_->preboundSockets_[i]));
+      if (reusePort) {
+        bootstrap.setReusePort(true);
+        // accept and serve on the same single-thread group: no
+        // cross-thread handoff per connection
+        bootstrap.group(childExe, childExe);
+      } else {
+        bootstrap.group(acceptExe, childExe);
+      }
+      if (!reusePort && options_->preboundSockets_.size() > 0) {
+        bootstrap.bind(std::move(options_->preboundSockets_[i]));
       } else {
-        bootstrap_[i].bind(addresses_[i].address);
+        bootstrap.bind(addresses_[i].address);
       }
     }
+  };
+
+  try {
+    if (options_->useReusePortSharding) {
+      // One single-thread shard per worker, each accepting on its own
+      // SO_REUSEPORT socket: the kernel balances connections across
+      // workers and there is no accept-thread handoff.
+      CHECK(options_->preboundSockets_.empty())
+          << "pre-bound sockets are incompatible with SO_REUSEPORT sharding";
+      for (size_t w = 0; w < options_->threads; w++) {
+        auto shardExe = std::make_shared<IOThreadPoolExecutor>(1,
+          std::make_shared<folly::NamedThreadFactory>("HTTPSrvExec"));
+        // Observer has to be set before bind() so onServerStart runs
+        shardExe->addObserver(exeObserver);
+        bindOneShard(nullptr, shardExe, true /* reusePort */);
+      }
+    } else {
+      auto accExe = std::make_shared<IOThreadPoolExecutor>(1);
+      auto exe = std::make_shared<IOThreadPoolExecutor>(options_->threads,
+        std::make_shared<folly::NamedThreadFactory>("HTTPSrvExec"));
+      // Observer has to be set before bind(), so onServerStart() callbacks run
+      exe->addObserver(exeObserver);
+      bindOneShard(accExe, exe, false /* reusePort */);
+    }
   } catch (const std::exception&) {
     stop();
 
     return folly::makeUnexpected(std::current_exception());
   }
 
+  if (options_->maxAcceptsPerWakeup > 0) {
+    // Batch the accept path: each ready listen socket drains up to this
+    // many connections per wakeup.  Plain int setter, read by the accept
+    // callback on its next wakeup.
+    for (auto& bootstrap : bootstrap_) {
+      for (auto& socket : bootstrap.getSockets()) {
+        auto serverSocket =
+            std::dynamic_pointer_cast<folly::AsyncServerSocket>(socket);
+        if (serverSocket) {
+          serverSocket->setMaxAcceptAtOnce(options_->maxAcceptsPerWakeup);
+        }
+      }
+    }
+  }
+
   return folly::unit;
 }
 
@@ -244,6 +288,23 @@ int HTTPServer::getListenSocket() const {
   return socketFds[0].toFd();
 }
 
+std::vector<int> HTTPServer::getListenSocketFds() const {
+  std::vector<int> fds;
+  for (auto& bootstrap : bootstrap_) {
+    for (auto& socket : bootstrap.getSockets()) {
+      auto serverSocket =
+          std::dynamic_pointer_cast<folly::AsyncServerSocket>(socket);
+      if (!serverSocket) {
+        continue;
+      }
+      for (auto networkSocket : serverSocket->getNetworkSockets()) {
+        fds.push_back(networkSocket.toFd());
+      }
+    }
+  }
+  return fds;
+}
+
 
 void HTTPServer::updateTLSCredentials() {
   for (auto& bootstrap : bootstrap_) {
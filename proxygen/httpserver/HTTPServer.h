@@ -18,6 +18,7 @@
 
 namespace proxygen {
 
+struct AcceptorConfiguration;
 class SignalHandler;
 class HTTPServerAcceptor;
 
@@ -76,6 +77,32 @@ class HTTPServer final {
     bool strictSSL{true};
 
     folly::Optional<folly::AsyncSocket::OptionMap> acceptorSocketOptions;
+
+    /*
+     * Per-VIP acceptor overrides, applied to this address's
+     * AcceptorConfiguration after the shared HTTPServerOptions-derived
+     * defaults.  Lets one process serve differently tuned VIPs - e.g.
+     * an internal address with huge windows and no limits beside a
+     * strict public one - without running separate fleets.
+     */
+    folly::Optional<std::chrono::milliseconds> idleTimeoutOverride;
+    folly::Optional<size_t> initialReceiveWindowOverride;
+    folly::Optional<size_t> receiveStreamWindowSizeOverride;
+    folly::Optional<size_t> receiveSessionWindowSizeOverride;
+    folly::Optional<uint32_t> maxConcurrentIncomingStreamsOverride;
+
+    /*
+     * Escape hatch for settings without a dedicated override: runs
+     * last against the fully built configuration.
+     */
+    std::function<void(AcceptorConfiguration&)> acceptorConfigFn;
+
+    /*
+     * Per-VIP stats scope.  When set, this acceptor's HTTPSessionStats
+     * are recorded under this name (see HTTPServerAcceptor), isolating
+     * each address's counters instead of aggregating across VIPs.
+     */
+    std::string statsNamespace;
   };
 
   /**
@@ -153,6 +180,14 @@ class HTTPServer final {
    */
   int getListenSocket() const;
 
+  /**
+   * Returns every listening socket fd across all bound addresses (and
+   * all SO_REUSEPORT shards), in bind order. Combined with
+   * SocketHandover these let a replacement process resume accepting on
+   * the same sockets while this one drains.
+   */
+  std::vector<int> getListenSocketFds() const;
+
   /**
    * Re-reads the certificate / key pair for all SSL vips on all acceptors
    */
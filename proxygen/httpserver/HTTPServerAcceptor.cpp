@@ -8,12 +8,24 @@
 
 #include <proxygen/httpserver/HTTPServerAcceptor.h>
 
+#include <folly/Conv.h>
 #include <folly/ExceptionString.h>
 #include <proxygen/httpserver/RequestHandlerAdaptor.h>
 #include <proxygen/httpserver/RequestHandlerFactory.h>
 #include <proxygen/lib/http/codec/HTTP1xCodec.h>
 #include <proxygen/lib/http/codec/HTTP2Constants.h>
 #include <proxygen/lib/http/session/HTTPDownstreamSession.h>
+#include <proxygen/lib/http/stats/ThreadLocalHTTPSessionStats.h>
+
+#include <folly/Synchronized.h>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 using folly::SocketAddress;
 
@@ -32,6 +44,9 @@ AcceptorConfiguration HTTPServerAcceptor::makeConfig(
   conf.receiveSessionWindowSize = opts.receiveSessionWindowSize;
   conf.acceptBacklog = opts.listenBacklog;
   conf.maxConcurrentIncomingStreams = opts.maxConcurrentIncomingStreams;
+  conf.maxAcceptsPerWakeup = opts.maxAcceptsPerWakeup;
+  conf.listenBacklogSampleInterval = opts.listenBacklogSampleInterval;
+  conf.burstAcceptsPerWakeup = opts.burstAcceptsPerWakeup;
 
   if (opts.enableExHeaders) {
     conf.egressSettings.push_back(
@@ -58,6 +73,30 @@ AcceptorConfiguration HTTPServerAcceptor::makeConfig(
   if (ipConfig.acceptorSocketOptions.hasValue()) {
     conf.setSocketOptions(ipConfig.acceptorSocketOptions.value());
   }
+
+  // per-VIP overrides beat the shared option-derived defaults
+  if (ipConfig.idleTimeoutOverride) {
+    conf.connectionIdleTimeout = *ipConfig.idleTimeoutOverride;
+    conf.transactionIdleTimeout = *ipConfig.idleTimeoutOverride;
+  }
+  if (ipConfig.initialReceiveWindowOverride) {
+    conf.initialReceiveWindow = *ipConfig.initialReceiveWindowOverride;
+  }
+  if (ipConfig.receiveStreamWindowSizeOverride) {
+    conf.receiveStreamWindowSize = *ipConfig.receiveStreamWindowSizeOverride;
+  }
+  if (ipConfig.receiveSessionWindowSizeOverride) {
+    conf.receiveSessionWindowSize = *ipConfig.receiveSessionWindowSizeOverride;
+  }
+  if (ipConfig.maxConcurrentIncomingStreamsOverride) {
+    conf.maxConcurrentIncomingStreams =
+        *ipConfig.maxConcurrentIncomingStreamsOverride;
+  }
+  conf.statsNamespace = ipConfig.statsNamespace;
+  // escape hatch runs last against the fully built configuration
+  if (ipConfig.acceptorConfigFn) {
+    ipConfig.acceptorConfigFn(conf);
+  }
   return conf;
 }
 
@@ -85,19 +124,261 @@ HTTPServerAcceptor::HTTPServerAcceptor(
     : HTTPSessionAcceptor(conf, codecFactory),
       serverOptions_(options),
       handlerFactories_(handlerFactories) {
+  if (!conf.statsNamespace.empty()) {
+    // thread-cached: each worker's acceptor instance feeds the same
+    // per-VIP counters through its own cache
+    vipSessionStats_ =
+        std::make_unique<TLHTTPSessionStats>(conf.statsNamespace);
+    downstreamSessionStats_ = vipSessionStats_.get();
+  }
 }
 
 void HTTPServerAcceptor::setCompletionCallback(std::function<void()> f) {
   completionCallback_ = f;
 }
 
+namespace {
+
+// Steering targets: one acceptor per pinned CPU, grouped by listen
+// address so a connection never jumps to another VIP's acceptor (each
+// VIP has its own TLS and protocol configuration).  Written from each
+// worker's loop at init/teardown, read on every steered accept.
+using SteeringGroups = std::unordered_map<
+    std::string,
+    std::unordered_map<int, HTTPServerAcceptor*>>;
+folly::Synchronized<SteeringGroups>& steeringRegistry() {
+  static folly::Synchronized<SteeringGroups> registry;
+  return registry;
+}
+
+} // namespace
+
 HTTPServerAcceptor::~HTTPServerAcceptor() {
+  if (pinnedCpu_ >= 0) {
+    auto registry = steeringRegistry().wlock();
+    auto group = registry->find(steeringGroup_);
+    if (group != registry->end()) {
+      auto it = group->second.find(pinnedCpu_);
+      if (it != group->second.end() && it->second == this) {
+        group->second.erase(it);
+      }
+      if (group->second.empty()) {
+        registry->erase(group);
+      }
+    }
+  }
 }
 
+void HTTPServerAcceptor::init(folly::AsyncServerSocket* serverSocket,
+                              folly::EventBase* eventBase,
+                              wangle::SSLStats* stats) {
+  HTTPSessionAcceptor::init(serverSocket, eventBase, stats);
+#if defined(__linux__)
+  if (!serverOptions_.enableFlowHashSteering) {
+    return;
+  }
+  // Discover the worker's pin from its own thread: pinning (whether
+  // via WorkerThread::setCpuAffinity or an external taskset) is an
+  // affinity mask with exactly one CPU set.
+  eventBase->runInEventBaseThread([this] {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus) != 0 ||
+        CPU_COUNT(&cpus) != 1) {
+      return;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &cpus)) {
+        pinnedCpu_ = cpu;
+        break;
+      }
+    }
+    steeringGroup_ = getConfig().bindAddress.describe();
+    (*steeringRegistry().wlock())[steeringGroup_].emplace(pinnedCpu_, this);
+  });
+#endif
+}
+
+void HTTPServerAcceptor::connectionAccepted(
+    int fd, const folly::SocketAddress& clientAddr) noexcept {
+#if defined(__linux__)
+  if (serverOptions_.enableFlowHashSteering && pinnedCpu_ >= 0) {
+    // SO_INCOMING_CPU reports the CPU whose softirq context processed
+    // the connection's packets, i.e. where its RSS queue lands
+    int cpu = -1;
+    socklen_t len = sizeof(cpu);
+    if (getsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, &len) == 0 &&
+        cpu >= 0 && cpu != pinnedCpu_) {
+      folly::EventBase* targetEvb = nullptr;
+      {
+        auto registry = steeringRegistry().rlock();
+        auto group = registry->find(steeringGroup_);
+        if (group != registry->end()) {
+          auto it = group->second.find(cpu);
+          if (it != group->second.end()) {
+            targetEvb = it->second->getEventBase();
+          }
+        }
+      }
+      if (targetEvb) {
+        // Re-home the raw fd before any transport state exists.  The
+        // lambda re-resolves the target on its own loop so a torn-down
+        // acceptor (HTTPServer stops listening before workers go away)
+        // closes the fd instead of being dereferenced.  The accept at
+        // the target is a qualified call: steering happens at most
+        // once, so a flapping SO_INCOMING_CPU reading cannot bounce a
+        // connection between workers.
+        targetEvb->runInEventBaseThread(
+            [group = steeringGroup_, cpu, fd, clientAddr] {
+          HTTPServerAcceptor* target = nullptr;
+          {
+            auto registry = steeringRegistry().rlock();
+            auto groupIt = registry->find(group);
+            if (groupIt != registry->end()) {
+              auto it = groupIt->second.find(cpu);
+              if (it != groupIt->second.end()) {
+                target = it->second;
+              }
+            }
+          }
+          if (target) {
+            target->HTTPSessionAcceptor::connectionAccepted(fd, clientAddr);
+          } else {
+            ::close(fd);
+          }
+        });
+        return;
+      }
+    }
+  }
+#endif
+  HTTPSessionAcceptor::connectionAccepted(fd, clientAddr);
+}
+
+namespace {
+
+/**
+ * Bridges a fast-lane route's prebuilt response onto the transaction:
+ * replies at onHeadersComplete and ignores the rest of the ingress.
+ * Instances are pooled per worker and reused, so the steady-state
+ * fast lane allocates nothing; the reply HTTPMessage lives on the
+ * stack.
+ */
+class RunToCompletionHandler : public HTTPTransactionHandler {
+ public:
+  void prime(HTTPServerOptions::PrebuiltResponse response) {
+    response_ = std::move(response);
+  }
+
+  void setTransaction(HTTPTransaction* txn) noexcept override {
+    txn_ = txn;
+  }
+
+  void detachTransaction() noexcept override;
+
+  void onHeadersComplete(std::unique_ptr<HTTPMessage>) noexcept override {
+    HTTPMessage reply;
+    reply.setHTTPVersion(1, 1);
+    reply.setStatusCode(response_.statusCode);
+    reply.setStatusMessage(response_.statusMessage);
+    reply.getHeaders() = std::move(response_.headers);
+    size_t bodyLength =
+        response_.body ? response_.body->computeChainDataLength() : 0;
+    reply.getHeaders().set(HTTP_HEADER_CONTENT_LENGTH,
+                           folly::to<std::string>(bodyLength));
+    txn_->sendHeaders(reply);
+    if (bodyLength > 0) {
+      txn_->sendBody(std::move(response_.body));
+    }
+    txn_->sendEOM();
+  }
+
+  // a fast-lane endpoint has no use for the rest of the request
+  void onBody(std::unique_ptr<folly::IOBuf>) noexcept override {
+  }
+  void onChunkHeader(size_t) noexcept override {
+  }
+  void onChunkComplete() noexcept override {
+  }
+  void onTrailers(std::unique_ptr<HTTPHeaders>) noexcept override {
+  }
+  void onEOM() noexcept override {
+  }
+  void onUpgrade(UpgradeProtocol) noexcept override {
+  }
+  void onError(const HTTPException&) noexcept override {
+  }
+  void onEgressPaused() noexcept override {
+  }
+  void onEgressResumed() noexcept override {
+  }
+
+ private:
+  HTTPTransaction* txn_{nullptr};
+  HTTPServerOptions::PrebuiltResponse response_;
+};
+
+constexpr size_t kMaxPooledFastLaneHandlers = 64;
+
+std::vector<std::unique_ptr<RunToCompletionHandler>>& fastLaneHandlerPool() {
+  static thread_local std::vector<std::unique_ptr<RunToCompletionHandler>>
+      pool;
+  return pool;
+}
+
+RunToCompletionHandler* acquireFastLaneHandler(
+    HTTPServerOptions::PrebuiltResponse response) {
+  auto& pool = fastLaneHandlerPool();
+  RunToCompletionHandler* handler;
+  if (!pool.empty()) {
+    handler = pool.back().release();
+    pool.pop_back();
+  } else {
+    handler = new RunToCompletionHandler();
+  }
+  handler->prime(std::move(response));
+  return handler;
+}
+
+void RunToCompletionHandler::detachTransaction() noexcept {
+  txn_ = nullptr;
+  response_ = HTTPServerOptions::PrebuiltResponse();
+  auto& pool = fastLaneHandlerPool();
+  if (pool.size() < kMaxPooledFastLaneHandlers) {
+    pool.emplace_back(this);
+  } else {
+    delete this;
+  }
+}
+
+} // namespace
+
 HTTPTransactionHandler* HTTPServerAcceptor::newHandler(
     HTTPTransaction& txn,
     HTTPMessage* msg) noexcept {
 
+  if (msg && serverOptions_.requestPipeline) {
+    // fused validate/normalize/route-key pass; the handler chain (and
+    // fast lane) below see the attached RoutingDescriptor
+    if (!serverOptions_.requestPipeline->process(*msg)) {
+      HTTPServerOptions::PrebuiltResponse badRequest;
+      badRequest.statusCode = 400;
+      badRequest.statusMessage = "Bad Request";
+      return acquireFastLaneHandler(std::move(badRequest));
+    }
+  }
+
+  if (msg && !serverOptions_.fastLaneRoutes.empty()) {
+    // run-to-completion fast lane: the route's responder executes
+    // inline, right here in the session's onHeadersComplete path
+    HTTPServerOptions::PrebuiltResponse response;
+    for (const auto& route : serverOptions_.fastLaneRoutes) {
+      if (route(*msg, response)) {
+        return acquireFastLaneHandler(std::move(response));
+      }
+    }
+  }
+
   SocketAddress clientAddr, vipAddr;
   txn.getPeerAddress(clientAddr);
   txn.getLocalAddress(vipAddr);
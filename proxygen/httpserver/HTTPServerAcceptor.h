@@ -32,6 +32,20 @@ class HTTPServerAcceptor final : public HTTPSessionAcceptor {
 
   ~HTTPServerAcceptor() override;
 
+  void init(folly::AsyncServerSocket* serverSocket,
+            folly::EventBase* eventBase,
+            wangle::SSLStats* stats = nullptr) override;
+
+  /**
+   * When flow-hash steering is enabled, re-homes each accepted fd to
+   * the acceptor whose worker is pinned to the CPU that received the
+   * connection's packets (SO_INCOMING_CPU), so softirq processing and
+   * session work stay on the same cache domain.
+   */
+  void connectionAccepted(int fd,
+                          const folly::SocketAddress& clientAddr)
+      noexcept override;
+
  private:
   HTTPServerAcceptor(const AcceptorConfiguration& conf,
                      const std::shared_ptr<HTTPCodecFactory>& codecFactory,
@@ -51,8 +65,16 @@ class HTTPServerAcceptor final : public HTTPSessionAcceptor {
   void onConnectionsDrained() override;
 
   const HTTPServerOptions& serverOptions_;
+  // CPU this acceptor's worker is pinned to, discovered at init();
+  // -1 when unpinned (the acceptor then neither steers nor receives)
+  int pinnedCpu_{-1};
+  // listen-address key scoping the steering registry to this VIP
+  std::string steeringGroup_;
   std::function<void()> completionCallback_;
   const std::vector<RequestHandlerFactory*> handlerFactories_{nullptr};
+  // per-VIP session stats (see IPConfig::statsNamespace); installed as
+  // downstreamSessionStats_ when a namespace is configured
+  std::unique_ptr<HTTPSessionStats> vipSessionStats_;
 };
 
 }
@@ -12,6 +12,7 @@
 #include <folly/SocketAddress.h>
 #include <folly/io/async/AsyncServerSocket.h>
 #include <proxygen/httpserver/Filters.h>
+#include <proxygen/lib/http/RequestPipeline.h>
 #include <proxygen/httpserver/RequestHandlerFactory.h>
 #include <signal.h>
 
@@ -48,6 +49,108 @@ class HTTPServerOptions {
    */
   size_t threads = 1;
 
+  /**
+   * Event loop / transport backend selection. Only kLibevent exists
+   * here: the session layer does its I/O through
+   * folly::AsyncTransportWrapper, and the folly this tree builds
+   * against has no pluggable EventBase backend, so an io_uring
+   * transport (registered ingress buffers, multishot accept, linked
+   * submits) first needs backend support in folly before proxygen can
+   * offer it. The enum exists so deployments can state the intent and
+   * fail fast at configuration time instead of silently not getting
+   * the backend they asked for.
+   */
+  enum class TransportBackend : uint8_t {
+    kLibevent = 0,
+  };
+  TransportBackend transportBackend = TransportBackend::kLibevent;
+
+  /**
+   * Shard accepting across workers with SO_REUSEPORT: each worker
+   * thread listens on its own socket bound to the same addresses and
+   * the kernel load-balances incoming connections, eliminating the
+   * accept-thread handoff and its cross-thread wakeup per connection.
+   * Incompatible with preboundSockets_.
+   *
+   * For NUMA deployments, pair this with pinned workers (see
+   * WorkerThread::setCpuAffinity) and NIC IRQ affinity so connections
+   * stay on the node that owns their RX queue; steering the kernel's
+   * reuseport pick itself (SO_INCOMING_CPU) would need per-socket
+   * option plumbing that wangle's ServerSocketConfig does not expose.
+   */
+  bool useReusePortSharding = false;
+
+  /**
+   * Maximum connections accepted per acceptor wakeup.  Each ready
+   * listen socket drains up to this many connections in one accept4
+   * loop before returning to the event loop, amortizing the wakeup
+   * across a connection storm instead of interleaving one accept with
+   * request processing.  0 leaves folly's default in place.
+   */
+  uint32_t maxAcceptsPerWakeup = 0;
+
+  /**
+   * How often each acceptor samples its listen socket's accept-queue
+   * depth (TCP_INFO).  The samples are readable per acceptor
+   * (HTTPAcceptor::getListenBacklogSampler) and aggregated
+   * process-wide (ListenBacklogSampler::getProcessStats) for export
+   * through ResourceStats, so an accept queue filling while workers
+   * idle shows up in telemetry instead of client timeouts.  0 disables
+   * sampling.
+   */
+  std::chrono::milliseconds listenBacklogSampleInterval{0};
+
+  /**
+   * Accept budget applied while the sampled backlog depth exceeds a
+   * quarter of the kernel's limit, replacing maxAcceptsPerWakeup until
+   * the queue recedes; each wakeup then drains a connection storm
+   * instead of trickling it.  0 disables burst mode.
+   */
+  uint32_t burstAcceptsPerWakeup = 0;
+
+  /**
+   * Steer each accepted connection to the worker pinned to the CPU
+   * that received its packets (SO_INCOMING_CPU), keeping softirq
+   * processing and session work on one cache domain instead of
+   * handing every packet across CPUs.  Only workers pinned to a
+   * single CPU (WorkerThread::setCpuAffinity, taskset) participate;
+   * with no pins this is a no-op.  Complements useReusePortSharding,
+   * whose kernel listener pick is by flow hash, not by the RX CPU.
+   */
+  bool enableFlowHashSteering = false;
+
+  /**
+   * Run-to-completion fast lane for trivial endpoints (health checks,
+   * tiny lookups): a route claims a request by returning true and
+   * filling the response, which is then serialized straight from the
+   * session's onHeadersComplete path - no RequestHandler chain, no
+   * adaptor, no ResponseBuilder; the reply message lives on the stack
+   * and the tiny bridging handler comes from a per-worker pool.  First
+   * matching route wins; unmatched requests take the normal handler
+   * chain.  Routes run on every worker concurrently and must be
+   * thread-safe; they must also be fast - they execute inline in the
+   * event loop.
+   */
+  struct PrebuiltResponse {
+    uint16_t statusCode{200};
+    std::string statusMessage{"OK"};
+    HTTPHeaders headers;
+    std::unique_ptr<folly::IOBuf> body;
+  };
+  using FastLaneRoute =
+      std::function<bool(const HTTPMessage&, PrebuiltResponse&)>;
+  std::vector<FastLaneRoute> fastLaneRoutes;
+
+  /**
+   * Fused validate/normalize/route-key ingress stage (see
+   * RequestPipeline): when set, the acceptor runs one pass over each
+   * request at onHeadersComplete time and attaches the resulting
+   * RoutingDescriptor to the message before the handler chain sees
+   * it; invalid requests are answered 400 without building a chain.
+   * Stateless and shared across workers.
+   */
+  std::shared_ptr<const RequestPipeline> requestPipeline;
+
   /**
    * Chain of RequestHandlerFactory that are used to create RequestHandler
    * which handles requests.
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/httpserver/MultipartDecoder.h>
+
+#include <cstring>
+#include <folly/String.h>
+#include <folly/io/Cursor.h>
+#include <glog/logging.h>
+
+namespace proxygen {
+
+namespace {
+
+// search a chain for needle; per-block memmem plus a stitch window for
+// matches straddling block edges
+size_t findInChain(const folly::IOBuf* head,
+                   size_t totalLength,
+                   folly::StringPiece needle) {
+  if (needle.size() > totalLength) {
+    return std::string::npos;
+  }
+  const size_t stitchSpan = needle.size() - 1;
+  std::string stitch;
+  size_t blockOffset = 0;
+  const folly::IOBuf* current = head;
+  do {
+    const char* data = reinterpret_cast<const char*>(current->data());
+    const size_t length = current->length();
+    if (length > 0) {
+      if (stitchSpan > 0 && !stitch.empty()) {
+        // check for a match straddling the previous block edge
+        auto tailLen = std::min(stitchSpan, length);
+        auto probe = stitch;
+        probe.append(data, tailLen);
+        auto hit = probe.find(needle.data(), 0, needle.size());
+        if (hit != std::string::npos) {
+          return blockOffset - stitch.size() + hit;
+        }
+      }
+      auto hit = ::memmem(data, length, needle.data(), needle.size());
+      if (hit != nullptr) {
+        return blockOffset + (static_cast<const char*>(hit) - data);
+      }
+      if (stitchSpan > 0) {
+        auto keep = std::min(stitchSpan, length);
+        if (length >= stitchSpan) {
+          stitch.assign(data + length - keep, keep);
+        } else {
+          stitch.append(data, length);
+          if (stitch.size() > stitchSpan) {
+            stitch.erase(0, stitch.size() - stitchSpan);
+          }
+        }
+      }
+      blockOffset += length;
+    }
+    current = current->next();
+  } while (current != head);
+  return std::string::npos;
+}
+
+} // anonymous namespace
+
+MultipartDecoder::MultipartDecoder(const std::string& boundary,
+                                   Callback& callback)
+    : delimiter_("\r\n--" + boundary), callback_(callback) {
+  // uniform delimiter handling: a synthetic leading CRLF makes the
+  // first dash-boundary look like every later one
+  pending_.append(folly::IOBuf::copyBuffer("\r\n"));
+}
+
+void MultipartDecoder::onIngress(std::unique_ptr<folly::IOBuf> chain) {
+  if (state_ == State::DONE || state_ == State::ERROR || !chain) {
+    return;
+  }
+  pending_.append(std::move(chain));
+  parse();
+}
+
+void MultipartDecoder::onIngressEOM() {
+  if (state_ == State::DONE || state_ == State::ERROR) {
+    return;
+  }
+  parse();
+  if (state_ != State::DONE) {
+    fail("message ended before the closing boundary");
+  }
+}
+
+size_t MultipartDecoder::findDelimiter() {
+  if (pending_.empty()) {
+    return std::string::npos;
+  }
+  return findInChain(pending_.front(), pending_.chainLength(), delimiter_);
+}
+
+void MultipartDecoder::fail(const std::string& what) {
+  state_ = State::ERROR;
+  pending_.move();
+  callback_.onError(what);
+}
+
+void MultipartDecoder::parse() {
+  while (state_ != State::DONE && state_ != State::ERROR) {
+    if (state_ == State::PREAMBLE || state_ == State::BODY) {
+      auto offset = findDelimiter();
+      if (offset == std::string::npos) {
+        // stream out everything that provably precedes any delimiter
+        if (state_ == State::BODY &&
+            pending_.chainLength() > delimiter_.size() - 1) {
+          auto data =
+              pending_.split(pending_.chainLength() - (delimiter_.size() - 1));
+          callback_.onPartData(std::move(data));
+        }
+        return; // need more bytes
+      }
+      // everything before the delimiter belongs to the current part
+      if (offset > 0) {
+        auto data = pending_.split(offset);
+        if (state_ == State::BODY) {
+          callback_.onPartData(std::move(data));
+        }
+        // preamble bytes are discarded
+      }
+      // the delimiter plus the two bytes deciding close-vs-next
+      if (pending_.chainLength() < delimiter_.size() + 2) {
+        return; // need more bytes
+      }
+      pending_.trimStart(delimiter_.size());
+      std::array<char, 2> tag;
+      folly::io::Cursor cursor(pending_.front());
+      cursor.pull(tag.data(), 2);
+      if (tag[0] == '-' && tag[1] == '-') {
+        if (state_ == State::BODY) {
+          callback_.onPartEnd();
+        }
+        pending_.move();
+        state_ = State::DONE;
+        callback_.onDone();
+        return;
+      }
+      if (tag[0] != '\r' || tag[1] != '\n') {
+        fail("malformed bytes after boundary");
+        return;
+      }
+      pending_.trimStart(2);
+      if (state_ == State::BODY) {
+        callback_.onPartEnd();
+      }
+      state_ = State::HEADERS;
+    } else { // HEADERS
+      if (!parseHeaders()) {
+        return; // need more bytes, or failed
+      }
+    }
+  }
+}
+
+bool MultipartDecoder::parseHeaders() {
+  static const folly::StringPiece kHeadersEnd("\r\n\r\n");
+  if (pending_.chainLength() < 2) {
+    return false;
+  }
+  {
+    // a part may legally have no headers: a blank line directly.  This
+    // must be decided before searching, or a CRLFCRLF inside the
+    // headerless part's body would be mistaken for a header block end.
+    std::array<char, 2> head;
+    folly::io::Cursor cursor(pending_.front());
+    cursor.pull(head.data(), 2);
+    if (head[0] == '\r' && head[1] == '\n') {
+      pending_.trimStart(2);
+      callback_.onPartBegin(HTTPHeaders());
+      state_ = State::BODY;
+      return true;
+    }
+  }
+  auto end = findInChain(pending_.front(), pending_.chainLength(), kHeadersEnd);
+  if (end == std::string::npos) {
+    return false; // need more bytes
+  }
+
+  // materialize just the header block; payload bytes stay zero-copy
+  auto headerBlock = pending_.split(end + 2); // include the final CRLF
+  pending_.trimStart(2);                      // the blank line
+  std::string flat;
+  flat.reserve(end + 2);
+  for (auto range : *headerBlock) {
+    flat.append(reinterpret_cast<const char*>(range.data()), range.size());
+  }
+
+  HTTPHeaders headers;
+  std::vector<folly::StringPiece> lines;
+  folly::split("\r\n", flat, lines, true /* ignoreEmpty */);
+  for (auto line : lines) {
+    auto colon = line.find(':');
+    if (colon == std::string::npos) {
+      fail("malformed part header");
+      return false;
+    }
+    auto name = line.subpiece(0, colon);
+    auto value = folly::trimWhitespace(line.subpiece(colon + 1));
+    headers.add(name, value);
+  }
+  callback_.onPartBegin(std::move(headers));
+  state_ = State::BODY;
+  return true;
+}
+
+} // namespace proxygen
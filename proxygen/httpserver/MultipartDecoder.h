@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBufQueue.h>
+#include <proxygen/lib/http/HTTPHeaders.h>
+#include <string>
+
+namespace proxygen {
+
+/**
+ * Streaming multipart/form-data decoder for handler onBody chains.
+ *
+ * Feed it the body IOBufs as they arrive; parts come back as
+ * callbacks: per-part headers parsed into an HTTPHeaders map, and part
+ * data delivered as zero-copy sub-chains split off the ingress buffers
+ * (no coalescing of payload bytes - only boundary scanning reads
+ * them).  Parsing is resumable across onIngress calls: boundaries,
+ * part headers and even the closing delimiter may arrive split across
+ * arbitrarily many chains.  Malformed input surfaces one onError and
+ * stops the decoder.
+ *
+ *   MultipartDecoder decoder(boundaryFromContentType, callback);
+ *   void onBody(unique_ptr<IOBuf> chain) { decoder.onIngress(move(chain)); }
+ *   void onEOM() { decoder.onIngressEOM(); }
+ *
+ * The boundary scan is a per-block memmem with straddle stitching;
+ * a SIMD scanner can replace findDelimiter without touching the state
+ * machine.
+ */
+class MultipartDecoder {
+ public:
+  class Callback {
+   public:
+    virtual ~Callback() = default;
+    virtual void onPartBegin(HTTPHeaders headers) = 0;
+    virtual void onPartData(std::unique_ptr<folly::IOBuf> data) = 0;
+    virtual void onPartEnd() = 0;
+    virtual void onDone() = 0;
+    virtual void onError(const std::string& what) = 0;
+  };
+
+  MultipartDecoder(const std::string& boundary, Callback& callback);
+
+  void onIngress(std::unique_ptr<folly::IOBuf> chain);
+  void onIngressEOM();
+
+  bool inError() const {
+    return state_ == State::ERROR;
+  }
+
+ private:
+  enum class State : uint8_t {
+    PREAMBLE, // searching for the first delimiter
+    HEADERS,  // accumulating a part's header block
+    BODY,     // streaming part data until the next delimiter
+    DONE,
+    ERROR,
+  };
+
+  void parse();
+  bool parseHeaders();
+  void fail(const std::string& what);
+
+  // offset of delimiter_ in pending_, or npos
+  size_t findDelimiter();
+
+  std::string delimiter_; // CRLF -- boundary
+  Callback& callback_;
+  folly::IOBufQueue pending_{folly::IOBufQueue::cacheChainLength()};
+  State state_{State::PREAMBLE};
+};
+
+} // namespace proxygen
@@ -20,6 +20,16 @@ class ExMessageHandler;
  * client. ResponseHandler acts as the client for these objects and
  * provides methods to send back the response
  */
+/*
+ * Note on a coroutine-native surface (co_await body()/send()): this
+ * interface stays callback-based because the tree builds as C++14 and
+ * folly::coro requires C++17 with compiler coroutine support. Once the
+ * toolchain moves, the right shape is an adaptor over
+ * HTTPTransactionHandlerAdaptor that owns the coroutine frame and
+ * resumes inline from these callbacks (no extra EventBase hops), with
+ * frames drawn from the per-transaction arena so async hops allocate
+ * nothing.
+ */
 class RequestHandler {
  public:
   /**
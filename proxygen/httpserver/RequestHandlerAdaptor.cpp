@@ -59,11 +59,13 @@ void RequestHandlerAdaptor::onHeadersComplete(std::unique_ptr<HTTPMessage> msg)
 
   // Only in case of no error
   if (err_ == kErrorNone) {
+    sliceStart_ = std::chrono::steady_clock::now();
     upstream_->onRequest(std::move(msg));
   }
 }
 
 void RequestHandlerAdaptor::onBody(std::unique_ptr<folly::IOBuf> c) noexcept {
+  sliceStart_ = std::chrono::steady_clock::now();
   upstream_->onBody(std::move(c));
 }
 
@@ -79,6 +81,7 @@ void RequestHandlerAdaptor::onTrailers(
 
 void RequestHandlerAdaptor::onEOM() noexcept {
   if (err_ == kErrorNone) {
+    sliceStart_ = std::chrono::steady_clock::now();
     upstream_->onEOM();
   }
 }
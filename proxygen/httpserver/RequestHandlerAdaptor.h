@@ -69,11 +69,18 @@ class RequestHandlerAdaptor
                                 bool unidirectional) noexcept override;
   const wangle::TransportInfo& getSetupTransportInfo() const noexcept override;
   void getCurrentTransportInfo(wangle::TransportInfo* tinfo) const override;
+  bool shouldYield(std::chrono::microseconds budget) const noexcept override {
+    return std::chrono::steady_clock::now() - sliceStart_ > budget;
+  }
 
   // Helper method
   void setError(ProxygenError err) noexcept;
 
   ProxygenError err_{kErrorNone};
+  // start of the handler callback currently on the loop; see
+  // ResponseHandler::shouldYield
+  std::chrono::steady_clock::time_point sliceStart_{
+      std::chrono::steady_clock::now()};
 };
 
 }
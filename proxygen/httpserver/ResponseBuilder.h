@@ -10,6 +10,7 @@
 
 #include <folly/ScopeGuard.h>
 #include <proxygen/httpserver/ResponseHandler.h>
+#include <proxygen/lib/utils/FileRegion.h>
 
 namespace proxygen {
 
@@ -117,8 +118,21 @@ class ResponseBuilder {
 
   template <typename T>
   ResponseBuilder& body(T&& t) {
-    return body(folly::IOBuf::maybeCopyBuffer(
-        folly::to<std::string>(std::forward<T>(t))));
+    // reserve headroom so framed codecs can write frame headers in
+    // place instead of allocating a buffer per DATA frame
+    return body(
+        folly::IOBuf::maybeCopyBuffer(folly::to<std::string>(std::forward<T>(t)),
+                                      HTTPCodec::kMaxFrameHeadroom));
+  }
+
+  /**
+   * Send the [offset, offset + length) range of an open file as body,
+   * backed by a memory mapping instead of user-space copies. The fd only
+   * needs to stay open until this call returns. On mapping failure no
+   * body is added.
+   */
+  ResponseBuilder& bodyFile(int fd, off_t offset, size_t length) {
+    return body(FileRegion::mmapRange(fd, offset, length));
   }
 
   ResponseBuilder& closeConnection() {
@@ -130,6 +144,26 @@ class ResponseBuilder {
     return *this;
   }
 
+  /**
+   * Send a 103 Early Hints interim response carrying the given headers
+   * (typically Link preloads).  Flushes with the current write-loop
+   * iteration like any other send, and leaves the builder and the
+   * egress state machine untouched: the transaction permits repeated
+   * sendHeaders until the final response on every protocol, so the
+   * real response follows through the normal status()/send() calls.
+   * May be called multiple times before the final response.
+   */
+  void sendEarlyHints(const HTTPHeaders& hints) {
+    HTTPMessage interim;
+    interim.setHTTPVersion(1, 1);
+    interim.setStatusCode(103);
+    interim.setStatusMessage("Early Hints");
+    hints.forEach([&](const std::string& name, const std::string& value) {
+      interim.getHeaders().add(name, value);
+    });
+    txn_->sendHeaders(interim);
+  }
+
   void sendWithEOM() {
     sendEOM_ = true;
     send();
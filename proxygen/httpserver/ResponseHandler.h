@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <folly/io/async/EventBaseManager.h>
 #include <proxygen/lib/http/session/HTTPTransaction.h>
 
 namespace proxygen {
@@ -89,10 +90,59 @@ class ResponseHandler {
 
   virtual void getCurrentTransportInfo(wangle::TransportInfo* tinfo) const = 0;
 
+  /**
+   * Cooperative slicing for on-loop handlers: checkpoint your state in
+   * the continuation and yield(); it requeues on the worker loop for
+   * the NEXT iteration, so every other session gets a turn before the
+   * computation resumes - a 5ms render stops taxing its neighbors
+   * without a thread-pool hop.  The continuation must tolerate the
+   * request having errored or completed in between (capture what you
+   * need; recheck your own state).
+   */
+  virtual void yield(folly::Function<void()> continuation) noexcept {
+    folly::EventBaseManager::get()->getEventBase()->runInLoop(
+        std::move(continuation), false /* next iteration */);
+  }
+
+  /**
+   * True once the current handler callback has been on the loop longer
+   * than budget - the signal to checkpoint and yield().  Only
+   * meaningful inside handler callbacks delivered through the adaptor;
+   * elsewhere it returns false.
+   */
+  virtual bool shouldYield(std::chrono::microseconds /*budget*/) const
+      noexcept {
+    return false;
+  }
+
   HTTPTransaction* getTransaction() const noexcept {
     return txn_;
   }
 
+  /**
+   * Egress-buffer visibility for streaming producers: current
+   * buffered bytes, this response's share of the session's buffered
+   * egress, and high/low watermark callbacks with hysteresis (see
+   * HTTPTransaction::setEgressWatermarks) - so generation rate can be
+   * modulated before the onEgressPaused cliff.
+   */
+  uint64_t getEgressBufferedBytes() const noexcept {
+    return txn_ ? txn_->getEgressBufferedBytes() : 0;
+  }
+
+  double getEgressBufferShare() const noexcept {
+    return txn_ ? txn_->getSessionEgressBufferShare() : 0.0;
+  }
+
+  void setEgressWatermarks(uint64_t highBytes,
+                           uint64_t lowBytes,
+                           folly::Function<void(bool aboveHigh)> callback)
+      noexcept {
+    if (txn_) {
+      txn_->setEgressWatermarks(highBytes, lowBytes, std::move(callback));
+    }
+  }
+
  protected:
   RequestHandler* upstream_{nullptr};
   HTTPTransaction* txn_{nullptr};
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/httpserver/SocketHandover.h>
+
+#include <cstring>
+#include <glog/logging.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kMaxHandoverFds = 64;
+
+bool makeUnixAddress(const std::string& path, struct sockaddr_un* addr) {
+  if (path.size() >= sizeof(addr->sun_path)) {
+    LOG(ERROR) << "handover path too long: " << path;
+    return false;
+  }
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy(addr->sun_path, path.data(), path.size());
+  return true;
+}
+
+} // anonymous namespace
+
+namespace proxygen {
+
+bool SocketHandover::sendFds(const std::string& path,
+                             const std::vector<int>& fds) {
+  if (fds.empty() || fds.size() > kMaxHandoverFds) {
+    LOG(ERROR) << "refusing to hand over " << fds.size() << " fds";
+    return false;
+  }
+  struct sockaddr_un addr;
+  if (!makeUnixAddress(path, &addr)) {
+    return false;
+  }
+  const int sock = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (sock < 0) {
+    PLOG(ERROR) << "handover socket()";
+    return false;
+  }
+  if (::connect(sock, reinterpret_cast<struct sockaddr*>(&addr),
+                sizeof(addr)) != 0) {
+    PLOG(ERROR) << "handover connect(" << path << ")";
+    ::close(sock);
+    return false;
+  }
+
+  // one data byte carries the fd count; the fds ride in the cmsg
+  const uint8_t numFds = uint8_t(fds.size());
+  struct iovec iov;
+  iov.iov_base = const_cast<uint8_t*>(&numFds);
+  iov.iov_len = sizeof(numFds);
+
+  const size_t fdBytes = fds.size() * sizeof(int);
+  std::vector<char> control(CMSG_SPACE(fdBytes));
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(fdBytes);
+  memcpy(CMSG_DATA(cmsg), fds.data(), fdBytes);
+
+  const auto rc = ::sendmsg(sock, &msg, 0);
+  ::close(sock);
+  if (rc < 0) {
+    PLOG(ERROR) << "handover sendmsg";
+    return false;
+  }
+  return true;
+}
+
+std::vector<int> SocketHandover::receiveFds(const std::string& path,
+                                            std::chrono::milliseconds timeout) {
+  std::vector<int> result;
+  struct sockaddr_un addr;
+  if (!makeUnixAddress(path, &addr)) {
+    return result;
+  }
+  const int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listener < 0) {
+    PLOG(ERROR) << "handover socket()";
+    return result;
+  }
+  ::unlink(path.c_str());
+  if (::bind(listener, reinterpret_cast<struct sockaddr*>(&addr),
+             sizeof(addr)) != 0 ||
+      ::listen(listener, 1) != 0) {
+    PLOG(ERROR) << "handover bind/listen(" << path << ")";
+    ::close(listener);
+    return result;
+  }
+
+  struct pollfd pfd;
+  pfd.fd = listener;
+  pfd.events = POLLIN;
+  const int pollRc = ::poll(&pfd, 1, int(timeout.count()));
+  if (pollRc <= 0) {
+    LOG(ERROR) << "handover timed out waiting on " << path;
+    ::close(listener);
+    ::unlink(path.c_str());
+    return result;
+  }
+  const int conn = ::accept(listener, nullptr, nullptr);
+  ::close(listener);
+  ::unlink(path.c_str());
+  if (conn < 0) {
+    PLOG(ERROR) << "handover accept";
+    return result;
+  }
+
+  uint8_t numFds = 0;
+  struct iovec iov;
+  iov.iov_base = &numFds;
+  iov.iov_len = sizeof(numFds);
+  std::vector<char> control(CMSG_SPACE(kMaxHandoverFds * sizeof(int)));
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.data();
+  msg.msg_controllen = control.size();
+
+  const auto rc = ::recvmsg(conn, &msg, 0);
+  ::close(conn);
+  if (rc <= 0) {
+    PLOG(ERROR) << "handover recvmsg";
+    return result;
+  }
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+      continue;
+    }
+    const size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    result.resize(count);
+    memcpy(result.data(), CMSG_DATA(cmsg), count * sizeof(int));
+  }
+  if ((msg.msg_flags & MSG_CTRUNC) != 0) {
+    // the kernel installed fds we can't account for; close what we
+    // did parse rather than leak a partial set into the caller
+    LOG(ERROR) << "handover control message truncated";
+    for (int fd : result) {
+      ::close(fd);
+    }
+    result.clear();
+    return result;
+  }
+  if (result.size() != numFds) {
+    LOG(WARNING) << "handover fd count mismatch: header=" << int(numFds)
+                 << " received=" << result.size();
+  }
+  return result;
+}
+
+} // namespace proxygen
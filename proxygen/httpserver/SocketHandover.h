@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * SCM_RIGHTS handover of listening sockets for zero-downtime restart.
+ *
+ * The replacement process calls receiveFds() first - it binds a unix
+ * socket at the agreed path and waits. The draining process then calls
+ * sendFds() with HTTPServer::getListenSocketFds(); the kernel
+ * duplicates the descriptors into the receiver, which feeds them to
+ * HTTPServerOptions::useExistingSockets and starts accepting on the
+ * same sockets, listen queue intact, while the old process finishes
+ * draining its sessions. No client ever sees a closed listener or a
+ * forced reconnect.
+ */
+class SocketHandover {
+ public:
+  /**
+   * Connect to the unix socket at path and pass the fds. Returns false
+   * on any socket error (receiver not ready, path wrong). The caller
+   * keeps ownership of its fd copies.
+   */
+  static bool sendFds(const std::string& path, const std::vector<int>& fds);
+
+  /**
+   * Bind a unix socket at path (unlinking any stale one), wait up to
+   * timeout for the old process to connect, and return the received
+   * fds; empty on timeout or error. The path is unlinked before
+   * returning.
+   */
+  static std::vector<int> receiveFds(
+      const std::string& path,
+      std::chrono::milliseconds timeout = std::chrono::milliseconds(30000));
+};
+
+} // namespace proxygen
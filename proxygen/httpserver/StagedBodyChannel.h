@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <folly/ProducerConsumerQueue.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/io/async/EventBase.h>
+#include <glog/logging.h>
+#include <memory>
+#include <proxygen/httpserver/ResponseHandler.h>
+
+namespace proxygen {
+
+/**
+ * Staged egress for handlers running off the session's event base.
+ * ResponseBuilder requires every send on the event loop, so a CPU-pool
+ * handler pays a runInEventBaseThread hop per body chunk.  This
+ * channel lets exactly one producer thread append IOBuf chains to a
+ * lock-free SPSC ring; the event loop drains the whole backlog in one
+ * callback and forwards it as a single sendBody burst, so a stream of
+ * chunks costs one cross-thread notification per burst instead of one
+ * per chunk.
+ *
+ * Lifecycle: create on the event base after sending headers, share via
+ * shared_ptr with the producer.  The handler must invalidate() on the
+ * event base when the client goes away (onError/requestComplete);
+ * appends after that drain into the void.  sendBody returning false
+ * means the ring is full - the producer should back off (the client
+ * isn't consuming; pushing harder only buffers more).
+ */
+class StagedBodyChannel
+    : public std::enable_shared_from_this<StagedBodyChannel> {
+ public:
+  static std::shared_ptr<StagedBodyChannel> create(
+      folly::EventBase* evb,
+      ResponseHandler* downstream,
+      uint32_t ringCapacity = 256) {
+    return std::shared_ptr<StagedBodyChannel>(
+        new StagedBodyChannel(evb, downstream, ringCapacity));
+  }
+
+  /**
+   * Producer thread: stage one chunk.  False when the ring is full;
+   * the chunk is returned to the caller untouched in that case.
+   */
+  bool sendBody(std::unique_ptr<folly::IOBuf>& chunk) {
+    if (!queue_.write(std::move(chunk))) {
+      return false; // chunk untouched on failed write
+    }
+    notify();
+    return true;
+  }
+
+  /**
+   * Producer thread: no more body.  The EOM is delivered after every
+   * staged chunk has drained.
+   */
+  void sendEOM() {
+    eomStaged_.store(true, std::memory_order_release);
+    notify();
+  }
+
+  /**
+   * Event base only: detach from the response handler; staged and
+   * future appends are discarded.
+   */
+  void invalidate() {
+    downstream_ = nullptr;
+  }
+
+ private:
+  StagedBodyChannel(folly::EventBase* evb,
+                    ResponseHandler* downstream,
+                    uint32_t ringCapacity)
+      : evb_(CHECK_NOTNULL(evb)),
+        downstream_(downstream),
+        queue_(std::max<uint32_t>(ringCapacity, 2)) {
+  }
+
+  void notify() {
+    if (notifyPending_.exchange(true, std::memory_order_acq_rel)) {
+      return; // a drain is already on its way
+    }
+    auto self = shared_from_this();
+    evb_->runInEventBaseThread([self] { self->drain(); });
+  }
+
+  void drain() {
+    // clear before reading so a producer that appends after our reads
+    // re-arms the notification
+    notifyPending_.store(false, std::memory_order_release);
+    folly::IOBufQueue burst{folly::IOBufQueue::cacheChainLength()};
+    std::unique_ptr<folly::IOBuf> chunk;
+    while (queue_.read(chunk)) {
+      burst.append(std::move(chunk));
+    }
+    if (downstream_ && !burst.empty()) {
+      downstream_->sendBody(burst.move());
+    }
+    if (eomStaged_.load(std::memory_order_acquire) && queue_.isEmpty() &&
+        !eomDelivered_) {
+      eomDelivered_ = true;
+      if (downstream_) {
+        downstream_->sendEOM();
+      }
+    }
+  }
+
+  folly::EventBase* evb_;
+  ResponseHandler* downstream_;
+  folly::ProducerConsumerQueue<std::unique_ptr<folly::IOBuf>> queue_;
+  std::atomic<bool> notifyPending_{false};
+  std::atomic<bool> eomStaged_{false};
+  bool eomDelivered_{false}; // event base only
+};
+
+} // namespace proxygen
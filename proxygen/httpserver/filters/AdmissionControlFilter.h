@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <glog/logging.h>
+#include <folly/Function.h>
+#include <folly/ThreadLocal.h>
+#include <folly/io/IOBufQueue.h>
+#include <list>
+#include <proxygen/httpserver/Filters.h>
+#include <proxygen/httpserver/RequestHandlerFactory.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/utils/Time.h>
+
+namespace proxygen {
+
+/**
+ * Front-door admission control: caps in-flight requests per worker and
+ * parks the overflow in a bounded two-class (interactive/batch) queue.
+ * Queued requests pause their ingress and buffer early body; when a
+ * running request finishes the oldest interactive (then batch) request
+ * dispatches, unless it already waited past the deadline, in which
+ * case it is answered with a fast 503. A full queue rejects
+ * immediately.
+ *
+ * Add the factory LAST in handlerFactories so it sits closest to the
+ * client and runs before any application work.
+ */
+class AdmissionControlFilterFactory : public RequestHandlerFactory {
+ public:
+  struct Options {
+    Options() = default;
+    // per-worker cap on concurrently executing requests
+    uint32_t maxInFlight = 1000;
+    // per-worker cap on parked requests across both classes
+    uint32_t maxQueued = 100;
+    // parked longer than this gets a 503 instead of dispatch
+    std::chrono::milliseconds maxQueueDelay{100};
+    // classify a request as interactive (dispatched first); nullptr
+    // treats everything as batch
+    folly::Function<bool(const HTTPMessage&) const> isInteractive;
+  };
+
+  class AdmissionFilter;
+
+  // Per-worker admission state; lives in the factory's thread locals.
+  class Controller {
+   public:
+    explicit Controller(const Options* options) : options_(options) {
+    }
+
+    bool tryAdmit() {
+      if (inFlight_ < options_->maxInFlight) {
+        inFlight_++;
+        return true;
+      }
+      return false;
+    }
+
+    bool tryEnqueue(AdmissionFilter* filter, bool interactive) {
+      if (interactiveQueue_.size() + batchQueue_.size() >=
+          options_->maxQueued) {
+        return false;
+      }
+      auto& queue = interactive ? interactiveQueue_ : batchQueue_;
+      queue.push_back(filter);
+      return true;
+    }
+
+    void remove(AdmissionFilter* filter) {
+      interactiveQueue_.remove(filter);
+      batchQueue_.remove(filter);
+    }
+
+    // a running request finished; hand its slot to a parked one
+    void onComplete();
+
+    uint32_t numInFlight() const {
+      return inFlight_;
+    }
+
+    uint32_t numQueued() const {
+      return interactiveQueue_.size() + batchQueue_.size();
+    }
+
+   private:
+    const Options* options_;
+    uint32_t inFlight_{0};
+    std::list<AdmissionFilter*> interactiveQueue_;
+    std::list<AdmissionFilter*> batchQueue_;
+  };
+
+  class AdmissionFilter : public Filter {
+   public:
+    AdmissionFilter(RequestHandler* upstream,
+                    Controller* controller,
+                    std::chrono::milliseconds maxQueueDelay)
+        : Filter(upstream),
+          controller_(controller),
+          maxQueueDelay_(maxQueueDelay) {
+    }
+
+    void onRequest(std::unique_ptr<HTTPMessage> headers) noexcept override {
+      interactive_ = classifier_ && (*classifier_)(*headers);
+      if (controller_->tryAdmit()) {
+        admitted_ = true;
+        Filter::onRequest(std::move(headers));
+        return;
+      }
+      if (!controller_->tryEnqueue(this, interactive_)) {
+        reject();
+        return;
+      }
+      queued_ = true;
+      enqueueTime_ = getCurrentTime();
+      pendingHeaders_ = std::move(headers);
+      downstream_->pauseIngress();
+    }
+
+    void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override {
+      if (queued_ || rejected_) {
+        if (queued_) {
+          pendingBody_.append(std::move(body));
+        }
+        return;
+      }
+      Filter::onBody(std::move(body));
+    }
+
+    void onEOM() noexcept override {
+      if (queued_ || rejected_) {
+        pendingEOM_ = true;
+        return;
+      }
+      Filter::onEOM();
+    }
+
+    void requestComplete() noexcept override {
+      onFinished();
+      Filter::requestComplete(); // deletes this
+    }
+
+    void onError(ProxygenError err) noexcept override {
+      onFinished();
+      Filter::onError(err); // deletes this
+    }
+
+    /**
+     * Controller interface: a slot became available. Returns true if
+     * the request is now running, false if it was rejected on
+     * deadline (the slot stays free).
+     */
+    bool dispatch() {
+      queued_ = false;
+      if (millisecondsSince(enqueueTime_) > maxQueueDelay_) {
+        // waited too long; the client would rather hear no quickly
+        reject();
+        return false;
+      }
+      admitted_ = true;
+      downstream_->resumeIngress();
+      Filter::onRequest(std::move(pendingHeaders_));
+      if (!pendingBody_.empty()) {
+        Filter::onBody(pendingBody_.move());
+      }
+      if (pendingEOM_) {
+        Filter::onEOM();
+      }
+      return true;
+    }
+
+    void setClassifier(
+        const folly::Function<bool(const HTTPMessage&) const>* classifier) {
+      classifier_ = classifier;
+    }
+
+   private:
+    void reject() {
+      rejected_ = true;
+      pendingHeaders_.reset();
+      pendingBody_.move();
+      ResponseBuilder(downstream_)
+          .status(503, "Service Unavailable")
+          .closeConnection()
+          .sendWithEOM();
+    }
+
+    void onFinished() {
+      if (admitted_) {
+        admitted_ = false;
+        controller_->onComplete();
+      } else if (queued_) {
+        queued_ = false;
+        controller_->remove(this);
+      }
+    }
+
+    Controller* controller_;
+    const std::chrono::milliseconds maxQueueDelay_;
+    const folly::Function<bool(const HTTPMessage&) const>* classifier_{
+        nullptr};
+    std::unique_ptr<HTTPMessage> pendingHeaders_;
+    folly::IOBufQueue pendingBody_{folly::IOBufQueue::cacheChainLength()};
+    TimePoint enqueueTime_;
+    bool interactive_{false};
+    bool admitted_{false};
+    bool queued_{false};
+    bool rejected_{false};
+    bool pendingEOM_{false};
+  };
+
+  explicit AdmissionControlFilterFactory(Options options)
+      : options_(std::move(options)),
+        controller_([this] { return new Controller(&options_); }) {
+  }
+
+  void onServerStart(folly::EventBase* /*evb*/) noexcept override {
+  }
+
+  void onServerStop() noexcept override {
+  }
+
+  RequestHandler* onRequest(RequestHandler* h,
+                            HTTPMessage* /*msg*/) noexcept override {
+    auto filter = new AdmissionFilter(
+        h, &*controller_, options_.maxQueueDelay);
+    if (options_.isInteractive) {
+      filter->setClassifier(&options_.isInteractive);
+    }
+    return filter;
+  }
+
+ private:
+  Options options_;
+  folly::ThreadLocal<Controller> controller_;
+};
+
+inline void AdmissionControlFilterFactory::Controller::onComplete() {
+  CHECK_GT(inFlight_, 0);
+  inFlight_--;
+  // Hand freed slots to parked requests, interactive first. The slot
+  // is claimed before dispatch so synchronous completion inside
+  // dispatch() keeps the accounting balanced; deadline rejections give
+  // the slot back and the loop tries the next parked request.
+  while (inFlight_ < options_->maxInFlight &&
+         (!interactiveQueue_.empty() || !batchQueue_.empty())) {
+    auto& queue =
+        interactiveQueue_.empty() ? batchQueue_ : interactiveQueue_;
+    auto filter = queue.front();
+    queue.pop_front();
+    inFlight_++;
+    if (!filter->dispatch()) {
+      inFlight_--;
+    }
+  }
+}
+
+} // namespace proxygen
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <folly/String.h>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <glog/logging.h>
+#include <proxygen/httpserver/Filters.h>
+#include <proxygen/httpserver/RequestHandlerFactory.h>
+#include <proxygen/lib/utils/Time.h>
+#include <unordered_map>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * In-process response cache, built as a Filter like CompressionFilter.
+ *
+ * GET responses are cached in a sharded LRU shared across workers,
+ * keyed by method + URL + the values of the configured vary headers
+ * (e.g. accept-encoding).  Cache-Control is honored: no-store/private
+ * suppress caching, max-age sets freshness, and
+ * stale-while-revalidate lets a stale entry be served immediately
+ * while the wrapped handler refreshes it in the background of the
+ * same request.  Responses carrying their own Vary header beyond the
+ * configured list are not cached.
+ *
+ * The revalidation ride-along is best effort: the client transaction
+ * finishes as soon as the stale response is delivered, so the refresh
+ * only lands if the wrapped handler produces its response before the
+ * transaction detaches - true for the synchronous in-process handlers
+ * this filter fronts.  A truncated refresh leaves the stale entry in
+ * place and re-dispatches any collapsed waiters.
+ *
+ * Concurrent misses for one key on the same worker collapse: the
+ * first becomes the fetch, later ones park (ingress untouched; GETs
+ * have no body) and are served from the filled entry, or dispatched
+ * to their own handlers if the fetch fails.  Workers collapse
+ * independently - cross-thread collapsing would buy little and cost a
+ * cross-loop hop on every hot hit.
+ *
+ * Entries store parsed headers plus the body chain; serves clone the
+ * refcounted body, so a hot key costs no payload copies.  Headers are
+ * re-serialized per response by the codec - pre-encoding them per
+ * protocol would need codec-level sharing (see
+ * HTTP2Codec::generateSharedHeaderBlock) and is left to callers
+ * composing the two.
+ */
+class CacheFilterFactory : public RequestHandlerFactory {
+ public:
+  struct Options {
+    Options() = default;
+    // total cached responses, spread over the shards
+    size_t maxEntries = 8192;
+    size_t shards = 8;
+    // responses with bodies beyond this are not cached
+    uint64_t maxBodyBytes = 1 << 20;
+    // freshness for 200s without Cache-Control; 0 caches only
+    // explicitly cacheable responses
+    std::chrono::seconds defaultTtl{0};
+    // request headers folded into the cache key
+    std::vector<std::string> varyHeaders = {"accept-encoding"};
+  };
+
+  struct Entry {
+    HTTPMessage headers;
+    std::unique_ptr<folly::IOBuf> body;
+    TimePoint freshUntil;
+    TimePoint staleServableUntil;
+  };
+  using EntryPtr = std::shared_ptr<Entry>;
+
+  class ResponseCache {
+   public:
+    ResponseCache(size_t maxEntries, size_t shards) {
+      shards_.reserve(shards);
+      for (size_t i = 0; i < shards; i++) {
+        shards_.emplace_back(std::make_unique<Shard>(
+            std::max<size_t>(maxEntries / shards, 1)));
+      }
+    }
+
+    EntryPtr lookup(const std::string& key) {
+      auto& shard = *shards_[shardFor(key)];
+      auto map = shard.map.wlock(); // get() bumps LRU position
+      auto it = map->find(key);
+      return it != map->end() ? it->second : nullptr;
+    }
+
+    void store(const std::string& key, EntryPtr entry) {
+      auto& shard = *shards_[shardFor(key)];
+      shard.map.wlock()->set(key, std::move(entry));
+    }
+
+   private:
+    struct Shard {
+      explicit Shard(size_t maxSize) : map(maxSize) {
+      }
+      folly::Synchronized<folly::EvictingCacheMap<std::string, EntryPtr>> map;
+    };
+
+    size_t shardFor(const std::string& key) const {
+      return std::hash<std::string>()(key) % shards_.size();
+    }
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+  };
+
+  class CacheFilter;
+  using PendingMap = std::unordered_map<std::string, std::vector<CacheFilter*>>;
+
+  class CacheFilter : public Filter {
+   public:
+    CacheFilter(RequestHandler* upstream,
+                const Options* options,
+                ResponseCache* cache,
+                PendingMap* pending)
+        : Filter(upstream),
+          options_(options),
+          cache_(cache),
+          pending_(pending) {
+    }
+
+    ~CacheFilter() override {
+      unregisterWaiter();
+      abandonFetch();
+    }
+
+    void onRequest(std::unique_ptr<HTTPMessage> headers) noexcept override {
+      if (headers->getMethod() != HTTPMethod::GET) {
+        mode_ = Mode::PASSTHROUGH;
+        Filter::onRequest(std::move(headers));
+        return;
+      }
+      key_ = buildKey(*headers);
+      auto entry = cache_->lookup(key_);
+      auto now = getCachedNow();
+      if (entry && now < entry->freshUntil) {
+        mode_ = Mode::SERVED;
+        serveEntry(*entry);
+        return; // the wrapped handler never runs
+      }
+      if (entry && now < entry->staleServableUntil) {
+        // serve stale now; the handler's response refreshes the entry
+        // instead of going to the client
+        serveEntry(*entry);
+        mode_ = Mode::REVALIDATE;
+        beginFetch();
+        Filter::onRequest(std::move(headers));
+        return;
+      }
+      auto pendingIt = pending_->find(key_);
+      if (pendingIt != pending_->end()) {
+        // collapse onto the in-flight fetch for this key
+        mode_ = Mode::WAITER;
+        heldHeaders_ = std::move(headers);
+        pendingIt->second.push_back(this);
+        return;
+      }
+      mode_ = Mode::FILL;
+      beginFetch();
+      Filter::onRequest(std::move(headers));
+    }
+
+    void onEOM() noexcept override {
+      if (mode_ == Mode::SERVED || mode_ == Mode::WAITER) {
+        return; // nothing upstream to finish
+      }
+      Filter::onEOM();
+    }
+
+    void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override {
+      if (mode_ == Mode::SERVED || mode_ == Mode::WAITER) {
+        return; // GET bodies are ignored on cache-handled paths
+      }
+      Filter::onBody(std::move(body));
+    }
+
+    // response side: tee (FILL) or swallow (REVALIDATE) the handler's
+    // response while judging cacheability
+    void sendHeaders(HTTPMessage& msg) noexcept override {
+      if (mode_ == Mode::FILL || mode_ == Mode::REVALIDATE) {
+        startEntry(msg);
+      }
+      if (mode_ != Mode::REVALIDATE) {
+        Filter::sendHeaders(msg);
+      }
+    }
+
+    void sendBody(std::unique_ptr<folly::IOBuf> body) noexcept override {
+      if (fillEntry_ &&
+          (mode_ == Mode::FILL || mode_ == Mode::REVALIDATE)) {
+        fillBytes_ += body->computeChainDataLength();
+        if (fillBytes_ > options_->maxBodyBytes) {
+          fillEntry_.reset(); // too large to cache; keep streaming
+        } else if (fillEntry_->body) {
+          fillEntry_->body->prependChain(body->clone());
+        } else {
+          fillEntry_->body = body->clone();
+        }
+      }
+      if (mode_ != Mode::REVALIDATE) {
+        Filter::sendBody(std::move(body));
+      }
+    }
+
+    void sendEOM() noexcept override {
+      if (mode_ == Mode::FILL || mode_ == Mode::REVALIDATE) {
+        if (fillEntry_) {
+          cache_->store(key_, fillEntry_);
+        }
+        completeFetch(fillEntry_);
+        fillEntry_.reset();
+      }
+      if (mode_ != Mode::REVALIDATE) {
+        Filter::sendEOM();
+      }
+    }
+
+    void sendAbort() noexcept override {
+      if (mode_ == Mode::FILL || mode_ == Mode::REVALIDATE) {
+        fillEntry_.reset();
+        abandonFetch();
+      }
+      if (mode_ != Mode::REVALIDATE) {
+        Filter::sendAbort();
+      }
+      // a REVALIDATE abort has nowhere to go; the stale response was
+      // already delivered
+    }
+
+   private:
+    enum class Mode : uint8_t {
+      UNDECIDED,
+      PASSTHROUGH, // not cacheable by request shape
+      SERVED,      // fresh hit, answered from cache
+      REVALIDATE,  // stale served; handler refreshes the entry
+      FILL,        // miss; handler's response fills the entry
+      WAITER,      // parked on another filter's fetch
+    };
+
+    std::string buildKey(const HTTPMessage& msg) const {
+      std::string key = msg.getMethodString();
+      key += ' ';
+      key += msg.getURL();
+      for (const auto& name : options_->varyHeaders) {
+        key += '\n';
+        key += msg.getHeaders().getSingleOrEmpty(name);
+      }
+      return key;
+    }
+
+    void serveEntry(const Entry& entry) {
+      HTTPMessage headers = entry.headers;
+      downstream_->sendHeaders(headers);
+      if (entry.body) {
+        downstream_->sendBody(entry.body->clone());
+      }
+      downstream_->sendEOM();
+    }
+
+    void startEntry(const HTTPMessage& msg) {
+      if (msg.getStatusCode() != 200 || msg.getHeaders().exists("vary")) {
+        return;
+      }
+      std::chrono::seconds ttl = options_->defaultTtl;
+      std::chrono::seconds swr{0};
+      bool storable = true;
+      msg.getHeaders().forEachValueOfHeader(
+          HTTP_HEADER_CACHE_CONTROL, [&](const std::string& value) {
+            parseCacheControl(value, ttl, swr, storable);
+            return false;
+          });
+      if (!storable || ttl.count() <= 0) {
+        return;
+      }
+      fillEntry_ = std::make_shared<Entry>();
+      fillEntry_->headers = msg;
+      auto now = getCachedNow();
+      fillEntry_->freshUntil = now + ttl;
+      fillEntry_->staleServableUntil = now + ttl + swr;
+      fillBytes_ = 0;
+    }
+
+    static void parseCacheControl(const std::string& value,
+                                  std::chrono::seconds& ttl,
+                                  std::chrono::seconds& swr,
+                                  bool& storable) {
+      std::vector<folly::StringPiece> directives;
+      folly::split(',', value, directives);
+      for (auto directive : directives) {
+        directive = folly::trimWhitespace(directive);
+        if (directive == "no-store" || directive == "no-cache" ||
+            directive == "private") {
+          storable = false;
+        } else if (directive.startsWith("max-age=")) {
+          auto seconds = folly::tryTo<int64_t>(directive.subpiece(8));
+          if (seconds.hasValue()) {
+            ttl = std::chrono::seconds(*seconds);
+          }
+        } else if (directive.startsWith("stale-while-revalidate=")) {
+          auto seconds = folly::tryTo<int64_t>(directive.subpiece(23));
+          if (seconds.hasValue()) {
+            swr = std::chrono::seconds(*seconds);
+          }
+        }
+      }
+    }
+
+    void beginFetch() {
+      (*pending_)[key_]; // claims the key with an empty waiter list
+      fetching_ = true;
+    }
+
+    void completeFetch(const EntryPtr& entry) {
+      if (!fetching_) {
+        return;
+      }
+      fetching_ = false;
+      auto it = pending_->find(key_);
+      if (it == pending_->end()) {
+        return;
+      }
+      auto waiters = std::move(it->second);
+      pending_->erase(it);
+      for (auto waiter : waiters) {
+        waiter->fetchDone(entry);
+      }
+    }
+
+    void abandonFetch() {
+      // failed fill: waiters each run their own handler
+      completeFetch(nullptr);
+    }
+
+    void fetchDone(const EntryPtr& entry) {
+      DCHECK(mode_ == Mode::WAITER);
+      if (entry) {
+        mode_ = Mode::SERVED;
+        serveEntry(*entry);
+        heldHeaders_.reset();
+      } else {
+        mode_ = Mode::PASSTHROUGH;
+        Filter::onRequest(std::move(heldHeaders_));
+        Filter::onEOM(); // GETs carry no body
+      }
+    }
+
+    void unregisterWaiter() {
+      if (mode_ != Mode::WAITER) {
+        return;
+      }
+      auto it = pending_->find(key_);
+      if (it != pending_->end()) {
+        auto& waiters = it->second;
+        waiters.erase(std::remove(waiters.begin(), waiters.end(), this),
+                      waiters.end());
+      }
+    }
+
+    const Options* options_;
+    ResponseCache* cache_;
+    PendingMap* pending_;
+    std::string key_;
+    Mode mode_{Mode::UNDECIDED};
+    bool fetching_{false};
+    EntryPtr fillEntry_;
+    uint64_t fillBytes_{0};
+    std::unique_ptr<HTTPMessage> heldHeaders_;
+  };
+
+  explicit CacheFilterFactory(Options options = Options())
+      : options_(std::move(options)),
+        cache_(options_.maxEntries, std::max<size_t>(options_.shards, 1)) {
+  }
+
+  void onServerStart(folly::EventBase*) noexcept override {
+  }
+
+  void onServerStop() noexcept override {
+  }
+
+  RequestHandler* onRequest(RequestHandler* handler,
+                            HTTPMessage*) noexcept override {
+    return new CacheFilter(handler, &options_, &cache_, &*pending_);
+  }
+
+ private:
+  Options options_;
+  ResponseCache cache_;
+  // per-worker collapsing state
+  folly::ThreadLocal<PendingMap> pending_;
+};
+
+} // namespace proxygen
@@ -15,6 +15,7 @@
 #include <proxygen/lib/http/RFC2616.h>
 #include <proxygen/lib/utils/StreamCompressor.h>
 #include <proxygen/lib/utils/ZlibStreamCompressor.h>
+#include <proxygen/lib/utils/ZstdStreamCompressor.h>
 
 namespace proxygen {
 
@@ -212,6 +213,7 @@ class CompressionFilterFactory : public RequestHandlerFactory {
   enum class CodecType : uint8_t {
     ZLIB = 0,
     NO_COMPRESSION = 1,
+    ZSTD = 2,
   };
 
  public:
@@ -220,11 +222,19 @@ class CompressionFilterFactory : public RequestHandlerFactory {
     uint32_t minimumCompressionSize = 1000;
     std::set<std::string> compressibleContentTypes = {};
     int32_t zlibCompressionLevel = 4;
+    // zstd is used for clients that accept it when enabled; an optional
+    // pre-trained dictionary improves ratios on small responses
+    bool enableZstd = false;
+    int32_t zstdCompressionLevel = ZstdStreamCompressor::kDefaultLevel;
+    std::shared_ptr<folly::IOBuf> zstdDictionary = nullptr;
   };
 
   CompressionFilterFactory(const Options& opts)
       : minimumCompressionSize_(opts.minimumCompressionSize),
         zlibCompressionLevel_(opts.zlibCompressionLevel),
+        enableZstd_(opts.enableZstd),
+        zstdCompressionLevel_(opts.zstdCompressionLevel),
+        zstdDictionary_(opts.zstdDictionary),
         compressibleContentTypes_(std::make_shared<std::set<std::string>>(
             opts.compressibleContentTypes)) {
   }
@@ -241,6 +251,16 @@ class CompressionFilterFactory : public RequestHandlerFactory {
   RequestHandler* onRequest(RequestHandler* h,
                             HTTPMessage* msg) noexcept override {
     switch (determineCompressionType(msg)) {
+      case CodecType::ZSTD:
+        return new CompressionFilter{
+            h,
+            minimumCompressionSize_,
+            [level = zstdCompressionLevel_,
+             dict = zstdDictionary_]() -> std::unique_ptr<StreamCompressor> {
+              return std::make_unique<ZstdStreamCompressor>(level, dict);
+            },
+            "zstd",
+            compressibleContentTypes_};
       case CodecType::ZLIB:
         return new CompressionFilter{
             h,
@@ -272,6 +292,17 @@ class CompressionFilterFactory : public RequestHandlerFactory {
       return CodecType::NO_COMPRESSION;
     }
 
+    // prefer zstd when enabled and the client accepts it
+    if (enableZstd_) {
+      auto zstdIt = std::find_if(
+          output.begin(), output.end(), [](RFC2616::TokenQPair elem) {
+            return elem.first.compare(folly::StringPiece("zstd")) == 0;
+          });
+      if (zstdIt != output.end()) {
+        return CodecType::ZSTD;
+      }
+    }
+
     auto it = std::find_if(
         output.begin(), output.end(), [](RFC2616::TokenQPair elem) {
           return elem.first.compare(folly::StringPiece("gzip")) == 0;
@@ -285,6 +316,9 @@ class CompressionFilterFactory : public RequestHandlerFactory {
 
   const uint32_t minimumCompressionSize_;
   const int32_t zlibCompressionLevel_;
+  const bool enableZstd_;
+  const int32_t zstdCompressionLevel_;
+  const std::shared_ptr<folly::IOBuf> zstdDictionary_;
   const std::shared_ptr<std::set<std::string>> compressibleContentTypes_;
 };
 } // namespace proxygen
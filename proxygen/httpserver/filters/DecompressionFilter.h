@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Conv.h>
+#include <vector>
+
+#include <proxygen/httpserver/Filters.h>
+#include <proxygen/httpserver/RequestHandlerFactory.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/utils/ZlibStreamDecompressor.h>
+#include <proxygen/lib/utils/ZstdStreamDecompressor.h>
+
+namespace proxygen {
+
+/**
+ * A server filter that transparently decompresses request bodies, so
+ * handlers always see identity-encoded ingress and clients can send
+ * compressed uploads.
+ *
+ * Requests carrying Content-Encoding gzip, x-gzip, deflate, or zstd
+ * are decompressed streamingly across onBody calls; the encoding and
+ * content-length headers are stripped before the handler sees the
+ * message.  Other (or stacked) encodings pass through untouched for
+ * the handler to deal with.
+ *
+ * Hardened against zip bombs with two independent guards applied as
+ * bytes stream, not after the fact: an absolute cap on decompressed
+ * size, and an expansion-ratio cap that ignores bodies below a floor
+ * (tiny inputs legitimately expand far above any sane ratio).  A
+ * tripped guard answers 413 and swallows the rest of the stream; a
+ * corrupt stream answers 400.  After rejecting, late egress from the
+ * handler is discarded so the error response stays the only one on
+ * the wire.
+ *
+ * Zlib decompression contexts are pooled per worker thread and reset
+ * between requests, avoiding the per-request inflateInit/inflateEnd
+ * allocation churn; zstd contexts are cheap to build and carry no
+ * reset hook, so they are constructed per request.
+ */
+class DecompressionFilter : public Filter {
+ public:
+  struct Options {
+    /** Absolute cap on decompressed body bytes; 413 beyond it. */
+    uint64_t maxDecompressedBodySize{32 * 1024 * 1024};
+
+    /** Reject once decompressed exceeds this multiple of compressed. */
+    uint64_t maxExpansionRatio{100};
+
+    /**
+     * Decompressed size under which the ratio guard stays quiet; the
+     * absolute cap still applies.
+     */
+    uint64_t expansionRatioFloor{64 * 1024};
+
+    /** Observes (compressedBytes, decompressedBytes) per completed body. */
+    std::function<void(uint64_t, uint64_t)> expansionStatsFn;
+
+    /** Observes each rejected request. */
+    std::function<void()> rejectStatsFn;
+  };
+
+  DecompressionFilter(RequestHandler* upstream,
+                      std::shared_ptr<const Options> options)
+      : Filter(upstream), options_(std::move(options)) {
+  }
+
+  ~DecompressionFilter() override {
+    if (zlibType_ != CompressionType::NONE && decompressor_ &&
+        !decompressor_->hasError()) {
+      auto* zlib = static_cast<ZlibStreamDecompressor*>(decompressor_.get());
+      zlib->reset();
+      auto& pool = zlibPool(zlibType_);
+      if (pool.size() < kMaxPooledPerThread) {
+        decompressor_.release();
+        pool.emplace_back(zlib);
+      }
+    }
+  }
+
+  void onRequest(std::unique_ptr<HTTPMessage> msg) noexcept override {
+    auto encoding =
+        msg->getHeaders().getSingleOrEmpty(HTTP_HEADER_CONTENT_ENCODING);
+    folly::toLowerAscii(encoding);
+    if (encoding == "gzip" || encoding == "x-gzip") {
+      decompressor_ = acquireZlib(CompressionType::GZIP);
+      zlibType_ = CompressionType::GZIP;
+    } else if (encoding == "deflate") {
+      decompressor_ = acquireZlib(CompressionType::DEFLATE);
+      zlibType_ = CompressionType::DEFLATE;
+    } else if (encoding == "zstd") {
+      decompressor_ = std::make_unique<ZstdStreamDecompressor>();
+    }
+    if (decompressor_) {
+      // the handler sees an identity body of unknown length
+      msg->getHeaders().remove(HTTP_HEADER_CONTENT_ENCODING);
+      msg->getHeaders().remove(HTTP_HEADER_CONTENT_LENGTH);
+      msg->setIsChunked(true);
+    }
+    Filter::onRequest(std::move(msg));
+  }
+
+  void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override {
+    if (rejected_) {
+      return;
+    }
+    if (!decompressor_ || !body) {
+      Filter::onBody(std::move(body));
+      return;
+    }
+    compressedBytes_ += body->computeChainDataLength();
+    auto decompressed = decompressor_->decompress(body.get());
+    if (decompressor_->hasError()) {
+      reject(400, "Bad Request");
+      return;
+    }
+    if (!decompressed || decompressed->empty()) {
+      return; // needs more input
+    }
+    decompressedBytes_ += decompressed->computeChainDataLength();
+    if (decompressedBytes_ > options_->maxDecompressedBodySize ||
+        (decompressedBytes_ > options_->expansionRatioFloor &&
+         decompressedBytes_ >
+             options_->maxExpansionRatio * compressedBytes_)) {
+      reject(413, "Payload Too Large");
+      return;
+    }
+    Filter::onBody(std::move(decompressed));
+  }
+
+  void onEOM() noexcept override {
+    if (rejected_) {
+      return;
+    }
+    if (decompressor_) {
+      if (!decompressor_->finished()) {
+        // truncated stream: refuse to hand the handler a silently
+        // incomplete body
+        reject(400, "Bad Request");
+        return;
+      }
+      if (options_->expansionStatsFn) {
+        options_->expansionStatsFn(compressedBytes_, decompressedBytes_);
+      }
+    }
+    Filter::onEOM();
+  }
+
+  // After rejecting, the handler may still egress a late response;
+  // drop it so our error response stays the only one on the wire.
+  void sendHeaders(HTTPMessage& msg) noexcept override {
+    if (!rejected_) {
+      Filter::sendHeaders(msg);
+    }
+  }
+  void sendChunkHeader(size_t len) noexcept override {
+    if (!rejected_) {
+      Filter::sendChunkHeader(len);
+    }
+  }
+  void sendBody(std::unique_ptr<folly::IOBuf> body) noexcept override {
+    if (!rejected_) {
+      Filter::sendBody(std::move(body));
+    }
+  }
+  void sendChunkTerminator() noexcept override {
+    if (!rejected_) {
+      Filter::sendChunkTerminator();
+    }
+  }
+  void sendEOM() noexcept override {
+    if (!rejected_) {
+      Filter::sendEOM();
+    }
+  }
+
+ private:
+  void reject(uint16_t statusCode, const char* statusMessage) {
+    rejected_ = true;
+    if (options_->rejectStatsFn) {
+      options_->rejectStatsFn();
+    }
+    ResponseBuilder(downstream_)
+        .status(statusCode, statusMessage)
+        .closeConnection()
+        .sendWithEOM();
+  }
+
+  static constexpr size_t kMaxPooledPerThread = 8;
+
+  static std::vector<std::unique_ptr<ZlibStreamDecompressor>>& zlibPool(
+      CompressionType type) {
+    static thread_local std::vector<std::unique_ptr<ZlibStreamDecompressor>>
+        gzipPool;
+    static thread_local std::vector<std::unique_ptr<ZlibStreamDecompressor>>
+        deflatePool;
+    return type == CompressionType::GZIP ? gzipPool : deflatePool;
+  }
+
+  static std::unique_ptr<ZlibStreamDecompressor> acquireZlib(
+      CompressionType type) {
+    auto& pool = zlibPool(type);
+    if (!pool.empty()) {
+      auto decompressor = std::move(pool.back());
+      pool.pop_back();
+      return decompressor;
+    }
+    return std::make_unique<ZlibStreamDecompressor>(type);
+  }
+
+  std::shared_ptr<const Options> options_;
+  std::unique_ptr<StreamDecompressor> decompressor_;
+  // which zlib pool decompressor_ returns to; NONE for zstd/identity
+  CompressionType zlibType_{CompressionType::NONE};
+  uint64_t compressedBytes_{0};
+  uint64_t decompressedBytes_{0};
+  bool rejected_{false};
+};
+
+class DecompressionFilterFactory : public RequestHandlerFactory {
+ public:
+  explicit DecompressionFilterFactory(DecompressionFilter::Options options =
+                                          DecompressionFilter::Options())
+      : options_(std::make_shared<const DecompressionFilter::Options>(
+            std::move(options))) {
+  }
+
+  void onServerStart(folly::EventBase* /*evb*/) noexcept override {
+  }
+
+  void onServerStop() noexcept override {
+  }
+
+  RequestHandler* onRequest(RequestHandler* handler,
+                            HTTPMessage* /*msg*/) noexcept override {
+    return new DecompressionFilter(handler, options_);
+  }
+
+ private:
+  std::shared_ptr<const DecompressionFilter::Options> options_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <folly/Function.h>
+#include <folly/hash/Hash.h>
+#include <glog/logging.h>
+#include <proxygen/httpserver/Filters.h>
+#include <proxygen/httpserver/RequestHandlerFactory.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Token-bucket rate limiting keyed by a user callback (client IP by
+ * default), built for the hot path: the admit decision is a hash, one
+ * relaxed load and one fetch_sub on a per-key atomic - no locks, no
+ * allocation.  Buckets live in a preallocated slab of fixed size
+ * (memory bound is set at construction); a key claims its slot with a
+ * single CAS on first sight, and when a probe run finds neither its
+ * key nor a free slot it recycles the least recently refilled slot in
+ * the run - O(1) eviction, at worst briefly generous to a key that
+ * lost its bucket.
+ *
+ * Shared by all workers; contention is per-bucket and buckets are
+ * padded to a cache line, so distinct keys never contend.  Over-limit
+ * requests are swallowed and answered with 429.
+ */
+class RateLimitFilterFactory : public RequestHandlerFactory {
+ public:
+  struct Options {
+    Options() = default;
+    // sustained tokens (requests) per second per key, and burst depth
+    double ratePerSec = 1000;
+    double burst = 2000;
+    // slab size: hard bound on tracked keys
+    size_t maxKeys = 16384;
+    // derive the limit key; nullptr uses the client IP
+    folly::Function<std::string(const HTTPMessage&) const> keyFn;
+  };
+
+  class BucketTable {
+   public:
+    BucketTable(size_t maxKeys, double ratePerSec, double burst)
+        : slots_(nextPow2(maxKeys)),
+          mask_(slots_.size() - 1),
+          // micro-token fixed point keeps refill integral
+          ratePerUs_(ratePerSec * kTokenScale / 1e6),
+          burstTokens_(int64_t(burst * kTokenScale)) {
+    }
+
+    bool allow(uint64_t keyHash, uint64_t nowUs) {
+      // never hash to the empty-slot marker
+      keyHash = keyHash ? keyHash : 1;
+      auto& bucket = findOrClaim(keyHash, nowUs);
+      refill(bucket, nowUs);
+      auto before =
+          bucket.tokens.fetch_sub(kTokenScale, std::memory_order_relaxed);
+      if (before >= kTokenScale) {
+        return true;
+      }
+      // keep the debt bounded so one burst of rejects doesn't starve
+      // the key long after it slows down
+      bucket.tokens.fetch_add(kTokenScale, std::memory_order_relaxed);
+      return false;
+    }
+
+   private:
+    static constexpr int64_t kTokenScale = 1 << 20;
+    static constexpr size_t kProbeRun = 4;
+    // refills more often than this just spin the CAS for nothing
+    static constexpr uint64_t kMinRefillUs = 1000;
+
+    struct Bucket {
+      std::atomic<uint64_t> key{0};
+      std::atomic<int64_t> tokens{0};
+      std::atomic<uint64_t> lastRefillUs{0};
+      // pad to a cache line so neighboring buckets never share one
+      // (explicit padding rather than alignas: C++14 vectors do not
+      // honor over-aligned element types)
+      char padding_[64 - 3 * sizeof(std::atomic<uint64_t>)];
+    };
+
+    static size_t nextPow2(size_t n) {
+      size_t p = 1;
+      while (p < n) {
+        p <<= 1;
+      }
+      return p;
+    }
+
+    Bucket& findOrClaim(uint64_t keyHash, uint64_t nowUs) {
+      size_t index = keyHash & mask_;
+      size_t stalest = index;
+      uint64_t stalestRefill = ~0ULL;
+      for (size_t i = 0; i < kProbeRun; i++) {
+        auto& bucket = slots_[(index + i) & mask_];
+        auto slotKey = bucket.key.load(std::memory_order_acquire);
+        if (slotKey == keyHash) {
+          return bucket;
+        }
+        if (slotKey == 0) {
+          uint64_t expected = 0;
+          if (bucket.key.compare_exchange_strong(
+                  expected, keyHash, std::memory_order_acq_rel)) {
+            bucket.tokens.store(burstTokens_, std::memory_order_relaxed);
+            bucket.lastRefillUs.store(nowUs, std::memory_order_relaxed);
+            return bucket;
+          }
+          if (expected == keyHash) {
+            return bucket; // raced with ourselves on another thread
+          }
+        }
+        auto refillTime = bucket.lastRefillUs.load(std::memory_order_relaxed);
+        if (refillTime < stalestRefill) {
+          stalestRefill = refillTime;
+          stalest = (index + i) & mask_;
+        }
+      }
+      // full probe run: recycle the least recently refilled slot
+      auto& victim = slots_[stalest];
+      victim.key.store(keyHash, std::memory_order_release);
+      victim.tokens.store(burstTokens_, std::memory_order_relaxed);
+      victim.lastRefillUs.store(nowUs, std::memory_order_relaxed);
+      return victim;
+    }
+
+    void refill(Bucket& bucket, uint64_t nowUs) {
+      auto last = bucket.lastRefillUs.load(std::memory_order_relaxed);
+      if (nowUs - last < kMinRefillUs) {
+        return; // common case: no time passed worth accounting
+      }
+      if (!bucket.lastRefillUs.compare_exchange_strong(
+              last, nowUs, std::memory_order_relaxed)) {
+        return; // another thread is refilling
+      }
+      auto add = int64_t((nowUs - last) * ratePerUs_);
+      auto after = bucket.tokens.fetch_add(add, std::memory_order_relaxed) +
+                   add;
+      if (after > burstTokens_) {
+        // benign race: worst case the cap applies a beat late
+        bucket.tokens.store(burstTokens_, std::memory_order_relaxed);
+      }
+    }
+
+    std::vector<Bucket> slots_;
+    const size_t mask_;
+    const double ratePerUs_;
+    const int64_t burstTokens_;
+  };
+
+  explicit RateLimitFilterFactory(Options options)
+      : options_(std::move(options)),
+        table_(options_.maxKeys, options_.ratePerSec, options_.burst) {
+  }
+
+  void onServerStart(folly::EventBase*) noexcept override {
+  }
+
+  void onServerStop() noexcept override {
+  }
+
+  RequestHandler* onRequest(RequestHandler* handler,
+                            HTTPMessage* msg) noexcept override {
+    uint64_t keyHash;
+    if (options_.keyFn) {
+      auto key = options_.keyFn(*msg);
+      keyHash = folly::hash::fnv64(key);
+    } else {
+      const auto& ip = msg->getClientIP();
+      keyHash = folly::hash::fnv64(ip);
+    }
+    auto nowUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count();
+    if (table_.allow(keyHash, nowUs)) {
+      return handler;
+    }
+    // over limit: wrap the already-built chain in a filter that
+    // swallows the request and answers 429, so the inner handler is
+    // still destroyed through the normal lifecycle
+    return new RejectingFilter(handler);
+  }
+
+ private:
+  // swallows ingress and answers 429, while keeping the already
+  // constructed downstream handler on the normal lifecycle so it is
+  // cleaned up with the chain
+  class RejectingFilter : public Filter {
+   public:
+    explicit RejectingFilter(RequestHandler* upstream) : Filter(upstream) {
+    }
+    void onRequest(std::unique_ptr<HTTPMessage>) noexcept override {
+      ResponseBuilder(downstream_)
+          .status(429, "Too Many Requests")
+          .closeConnection()
+          .sendWithEOM();
+    }
+    void onBody(std::unique_ptr<folly::IOBuf>) noexcept override {
+    }
+    void onEOM() noexcept override {
+    }
+  };
+
+  Options options_;
+  BucketTable table_;
+};
+
+} // namespace proxygen
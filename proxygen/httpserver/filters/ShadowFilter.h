@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/ThreadLocal.h>
+#include <glog/logging.h>
+#include <proxygen/httpserver/Filters.h>
+#include <proxygen/httpserver/RequestHandlerFactory.h>
+#include <proxygen/lib/http/session/HTTPTransaction.h>
+
+namespace proxygen {
+
+/**
+ * Request mirroring: tees a sampled fraction of requests to a shadow
+ * destination with fire-and-forget semantics.  Body chunks are shared
+ * via IOBuf::clone() - refcounted buffers, no copy - and the primary
+ * path is never paused or delayed for the shadow: when the shadow is
+ * over budget (too many in flight on this worker, or a single shadow
+ * body past its byte cap) the shadow is dropped or aborted and the
+ * primary proceeds untouched.  Shadow responses are drained and
+ * discarded.
+ *
+ * The deployment supplies the destination through ShadowDispatcher,
+ * typically backed by its per-thread SessionPool/HTTPConnector;
+ * newShadowTransaction runs on the request's event thread.
+ */
+class ShadowDispatcher {
+ public:
+  virtual ~ShadowDispatcher() = default;
+
+  /**
+   * Return a transaction to carry the shadow (with the given handler
+   * installed), or nullptr to drop this shadow.
+   */
+  virtual HTTPTransaction* newShadowTransaction(
+      HTTPTransactionHandler* handler) noexcept = 0;
+};
+
+class ShadowFilterFactory : public RequestHandlerFactory {
+ public:
+  struct Options {
+    Options() = default;
+    // mirror one request in every sampleEvery (0 disables shadowing)
+    uint32_t sampleEvery = 100;
+    // per-worker cap on shadows in flight; over it, new shadows drop
+    uint32_t maxConcurrentShadows = 16;
+    // a shadow whose body exceeds this aborts; the primary continues
+    uint64_t maxShadowBodyBytes = 1 << 20;
+  };
+
+  class ShadowFilter;
+
+  /**
+   * Discards the shadow response and self-destructs on detach.  Also
+   * the feed point the filter writes the teed request through; if the
+   * filter dies first (primary error) with the shadow incomplete, the
+   * shadow aborts.
+   */
+  class ShadowSink : public HTTPTransactionHandler {
+   public:
+    ShadowSink(ShadowFilter* filter, uint32_t* inFlight)
+        : filter_(filter), inFlight_(inFlight) {
+      (*inFlight_)++;
+    }
+
+    ~ShadowSink() override {
+      (*inFlight_)--;
+    }
+
+    // feed-side API, called by the owning filter
+    void feedHeaders(const HTTPMessage& headers) {
+      if (txn_ && !aborted_) {
+        txn_->sendHeaders(headers);
+      }
+    }
+
+    void feedBody(std::unique_ptr<folly::IOBuf> body) {
+      if (txn_ && !aborted_) {
+        txn_->sendBody(std::move(body));
+      }
+    }
+
+    void feedEOM() {
+      complete_ = true;
+      if (txn_ && !aborted_) {
+        txn_->sendEOM();
+      }
+    }
+
+    void abortShadow() {
+      if (txn_ && !aborted_) {
+        aborted_ = true;
+        txn_->sendAbort();
+      }
+    }
+
+    void filterGone() {
+      filter_ = nullptr;
+      if (!complete_) {
+        // half a request is useless to the shadow destination
+        abortShadow();
+      }
+    }
+
+    // HTTPTransactionHandler: drain and discard the shadow response
+    void setTransaction(HTTPTransaction* txn) noexcept override {
+      txn_ = txn;
+    }
+    void detachTransaction() noexcept override;
+    void onHeadersComplete(std::unique_ptr<HTTPMessage>) noexcept override {
+    }
+    void onBody(std::unique_ptr<folly::IOBuf>) noexcept override {
+    }
+    void onChunkHeader(size_t) noexcept override {
+    }
+    void onChunkComplete() noexcept override {
+    }
+    void onTrailers(std::unique_ptr<HTTPHeaders>) noexcept override {
+    }
+    void onEOM() noexcept override {
+    }
+    void onUpgrade(UpgradeProtocol) noexcept override {
+    }
+    void onError(const HTTPException&) noexcept override {
+      // fire and forget: a failed shadow is not an event
+      aborted_ = true;
+    }
+    void onEgressPaused() noexcept override {
+    }
+    void onEgressResumed() noexcept override {
+    }
+
+   private:
+    ShadowFilter* filter_;
+    uint32_t* inFlight_;
+    HTTPTransaction* txn_{nullptr};
+    bool aborted_{false};
+    bool complete_{false};
+  };
+
+  class ShadowFilter : public Filter {
+   public:
+    ShadowFilter(RequestHandler* upstream,
+                 const Options* options,
+                 ShadowDispatcher* dispatcher,
+                 uint32_t* inFlight)
+        : Filter(upstream),
+          options_(options),
+          dispatcher_(dispatcher),
+          inFlight_(inFlight) {
+    }
+
+    ~ShadowFilter() override {
+      if (shadow_) {
+        shadow_->filterGone();
+      }
+    }
+
+    void onRequest(std::unique_ptr<HTTPMessage> headers) noexcept override {
+      if (*inFlight_ < options_->maxConcurrentShadows) {
+        auto sink = std::make_unique<ShadowSink>(this, inFlight_);
+        if (dispatcher_->newShadowTransaction(sink.get())) {
+          shadow_ = sink.release(); // owned by its transaction now
+          shadow_->feedHeaders(*headers);
+        }
+        // a refused dispatch destroys the sink without a transaction
+      }
+      Filter::onRequest(std::move(headers));
+    }
+
+    void onBody(std::unique_ptr<folly::IOBuf> body) noexcept override {
+      if (shadow_) {
+        shadowBodyBytes_ += body->computeChainDataLength();
+        if (shadowBodyBytes_ > options_->maxShadowBodyBytes) {
+          // over budget: the shadow goes, the primary is untouched
+          shadow_->abortShadow();
+          releaseShadow();
+        } else {
+          shadow_->feedBody(body->clone());
+        }
+      }
+      Filter::onBody(std::move(body));
+    }
+
+    void onEOM() noexcept override {
+      if (shadow_) {
+        shadow_->feedEOM();
+        // the sink lives on with its transaction until the shadow
+        // response drains; sever both directions so neither side
+        // touches a dead peer
+        releaseShadow();
+      }
+      Filter::onEOM();
+    }
+
+    // called by the sink when its transaction detaches while the
+    // filter is still feeding
+    void shadowDetachedOrDone() {
+      shadow_ = nullptr;
+    }
+
+   private:
+    void releaseShadow() {
+      shadow_->filterGone();
+      shadow_ = nullptr;
+    }
+
+    const Options* options_;
+    ShadowDispatcher* dispatcher_;
+    uint32_t* inFlight_;
+    ShadowSink* shadow_{nullptr};
+    uint64_t shadowBodyBytes_{0};
+  };
+
+  ShadowFilterFactory(Options options, ShadowDispatcher* dispatcher)
+      : options_(options), dispatcher_(CHECK_NOTNULL(dispatcher)) {
+  }
+
+  void onServerStart(folly::EventBase*) noexcept override {
+  }
+
+  void onServerStop() noexcept override {
+  }
+
+  RequestHandler* onRequest(RequestHandler* handler,
+                            HTTPMessage*) noexcept override {
+    auto& state = *perThread_;
+    if (options_.sampleEvery == 0 ||
+        (++state.sampleCounter % options_.sampleEvery) != 0) {
+      return handler;
+    }
+    return new ShadowFilter(
+        handler, &options_, dispatcher_, &state.shadowsInFlight);
+  }
+
+ private:
+  struct PerThread {
+    uint64_t sampleCounter{0};
+    uint32_t shadowsInFlight{0};
+  };
+
+  Options options_;
+  ShadowDispatcher* dispatcher_;
+  folly::ThreadLocal<PerThread> perThread_;
+};
+
+inline void ShadowFilterFactory::ShadowSink::detachTransaction() noexcept {
+  if (filter_) {
+    // the shadow ended before the primary finished feeding it
+    filter_->shadowDetachedOrDone();
+  }
+  delete this;
+}
+
+} // namespace proxygen
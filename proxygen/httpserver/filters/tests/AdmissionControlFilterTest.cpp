@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/filters/AdmissionControlFilter.h>
+
+using namespace proxygen;
+using namespace testing;
+
+namespace {
+
+struct Client {
+  Client() : requestHandler(new MockRequestHandler()) {
+    responseHandler = std::make_unique<MockResponseHandler>(requestHandler);
+  }
+
+  // requesthandler is the server side, responsehandler the client side
+  MockRequestHandler* requestHandler;
+  std::unique_ptr<MockResponseHandler> responseHandler;
+  RequestHandler* filter{nullptr};
+};
+
+} // namespace
+
+class AdmissionControlFilterTest : public Test {
+ protected:
+  RequestHandler* makeFilter(AdmissionControlFilterFactory& factory,
+                             Client& client) {
+    HTTPMessage msg;
+    auto filter = factory.onRequest(client.requestHandler, &msg);
+    filter->setResponseHandler(client.responseHandler.get());
+    client.filter = filter;
+    return filter;
+  }
+};
+
+TEST_F(AdmissionControlFilterTest, AdmitUnderLimit) {
+  AdmissionControlFilterFactory::Options opts;
+  opts.maxInFlight = 2;
+  AdmissionControlFilterFactory factory(std::move(opts));
+
+  Client client;
+  EXPECT_CALL(*client.requestHandler, onRequest(_)).Times(1);
+  EXPECT_CALL(*client.requestHandler, onEOM()).Times(1);
+  EXPECT_CALL(*client.requestHandler, requestComplete()).Times(1);
+
+  auto filter = makeFilter(factory, client);
+  filter->onRequest(std::make_unique<HTTPMessage>());
+  filter->onEOM();
+  filter->requestComplete();
+}
+
+TEST_F(AdmissionControlFilterTest, QueueAndDispatchOnCompletion) {
+  AdmissionControlFilterFactory::Options opts;
+  opts.maxInFlight = 1;
+  opts.maxQueueDelay = std::chrono::milliseconds(60000);
+  AdmissionControlFilterFactory factory(std::move(opts));
+
+  Client first;
+  EXPECT_CALL(*first.requestHandler, onRequest(_)).Times(1);
+  EXPECT_CALL(*first.requestHandler, requestComplete()).Times(1);
+  auto firstFilter = makeFilter(factory, first);
+  firstFilter->onRequest(std::make_unique<HTTPMessage>());
+
+  // second request exceeds the in-flight cap: parked, ingress paused,
+  // the app handler sees nothing yet
+  Client second;
+  EXPECT_CALL(*second.responseHandler, pauseIngress()).Times(1);
+  EXPECT_CALL(*second.requestHandler, onRequest(_)).Times(0);
+  auto secondFilter = makeFilter(factory, second);
+  secondFilter->onRequest(std::make_unique<HTTPMessage>());
+  Mock::VerifyAndClearExpectations(second.requestHandler);
+
+  // first finishing hands its slot to the parked request
+  EXPECT_CALL(*second.responseHandler, resumeIngress()).Times(1);
+  EXPECT_CALL(*second.requestHandler, onRequest(_)).Times(1);
+  EXPECT_CALL(*second.requestHandler, onEOM()).Times(1);
+  EXPECT_CALL(*second.requestHandler, requestComplete()).Times(1);
+  secondFilter->onEOM(); // buffered while parked
+  firstFilter->requestComplete();
+  secondFilter->requestComplete();
+}
+
+TEST_F(AdmissionControlFilterTest, RejectWhenQueueFull) {
+  AdmissionControlFilterFactory::Options opts;
+  opts.maxInFlight = 1;
+  opts.maxQueued = 0;
+  AdmissionControlFilterFactory factory(std::move(opts));
+
+  Client first;
+  EXPECT_CALL(*first.requestHandler, onRequest(_)).Times(1);
+  EXPECT_CALL(*first.requestHandler, requestComplete()).Times(1);
+  auto firstFilter = makeFilter(factory, first);
+  firstFilter->onRequest(std::make_unique<HTTPMessage>());
+
+  // queue is full: fast 503 without touching the app handler
+  Client second;
+  EXPECT_CALL(*second.requestHandler, onRequest(_)).Times(0);
+  EXPECT_CALL(*second.responseHandler, sendHeaders(_))
+      .WillOnce(Invoke([](HTTPMessage& msg) {
+        EXPECT_EQ(msg.getStatusCode(), 503);
+      }));
+  EXPECT_CALL(*second.responseHandler, sendEOM()).Times(1);
+  EXPECT_CALL(*second.requestHandler, requestComplete()).Times(1);
+  auto secondFilter = makeFilter(factory, second);
+  secondFilter->onRequest(std::make_unique<HTTPMessage>());
+  secondFilter->requestComplete();
+
+  firstFilter->requestComplete();
+}
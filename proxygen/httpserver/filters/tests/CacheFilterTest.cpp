@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/filters/CacheFilter.h>
+
+using namespace proxygen;
+using namespace testing;
+
+namespace {
+
+std::unique_ptr<HTTPMessage> makeGet(const std::string& url) {
+  auto msg = std::make_unique<HTTPMessage>();
+  msg->setMethod(HTTPMethod::GET);
+  msg->setURL(url);
+  return msg;
+}
+
+HTTPMessage cacheableResponse() {
+  HTTPMessage response;
+  response.setStatusCode(200);
+  response.getHeaders().add(HTTP_HEADER_CACHE_CONTROL, "max-age=60");
+  return response;
+}
+
+} // namespace
+
+TEST(CacheFilterTest, MissFillsThenHitServes) {
+  CacheFilterFactory factory;
+
+  // first request: miss, handler runs, response fills the cache
+  {
+    auto handler = new MockRequestHandler();
+    MockResponseHandler client(handler);
+    HTTPMessage msg;
+    auto filter = factory.onRequest(handler, &msg);
+    filter->setResponseHandler(&client);
+
+    EXPECT_CALL(*handler, onRequest(_));
+    EXPECT_CALL(*handler, onEOM());
+    EXPECT_CALL(client, sendHeaders(_));
+    EXPECT_CALL(client, sendBody(_));
+    EXPECT_CALL(client, sendEOM());
+    EXPECT_CALL(*handler, requestComplete());
+
+    filter->onRequest(makeGet("/hot"));
+    filter->onEOM();
+    auto response = cacheableResponse();
+    auto asResponseHandler = static_cast<Filter*>(filter);
+    asResponseHandler->sendHeaders(response);
+    asResponseHandler->sendBody(folly::IOBuf::copyBuffer("payload"));
+    asResponseHandler->sendEOM();
+    filter->requestComplete();
+  }
+
+  // second request: fresh hit served from cache, handler never runs
+  {
+    auto handler = new MockRequestHandler();
+    MockResponseHandler client(handler);
+    HTTPMessage msg;
+    auto filter = factory.onRequest(handler, &msg);
+    filter->setResponseHandler(&client);
+
+    EXPECT_CALL(*handler, onRequest(_)).Times(0);
+    EXPECT_CALL(*handler, onEOM()).Times(0);
+    std::string served;
+    EXPECT_CALL(client, sendHeaders(_))
+        .WillOnce(Invoke([](HTTPMessage& headers) {
+          EXPECT_EQ(headers.getStatusCode(), 200);
+        }));
+    EXPECT_CALL(client, sendBody(_))
+        .WillOnce(Invoke([&](std::shared_ptr<folly::IOBuf> body) {
+          served = body->moveToFbString().toStdString();
+        }));
+    EXPECT_CALL(client, sendEOM());
+    EXPECT_CALL(*handler, requestComplete());
+
+    filter->onRequest(makeGet("/hot"));
+    filter->onEOM();
+    EXPECT_EQ(served, "payload");
+    filter->requestComplete();
+  }
+}
+
+TEST(CacheFilterTest, NoStoreIsNotCached) {
+  CacheFilterFactory factory;
+
+  for (int i = 0; i < 2; i++) {
+    auto handler = new MockRequestHandler();
+    MockResponseHandler client(handler);
+    HTTPMessage msg;
+    auto filter = factory.onRequest(handler, &msg);
+    filter->setResponseHandler(&client);
+
+    // both runs must reach the handler
+    EXPECT_CALL(*handler, onRequest(_));
+    EXPECT_CALL(*handler, onEOM());
+    EXPECT_CALL(client, sendHeaders(_));
+    EXPECT_CALL(client, sendEOM());
+    EXPECT_CALL(*handler, requestComplete());
+
+    filter->onRequest(makeGet("/private"));
+    filter->onEOM();
+    HTTPMessage response;
+    response.setStatusCode(200);
+    response.getHeaders().add(HTTP_HEADER_CACHE_CONTROL, "no-store");
+    auto asResponseHandler = static_cast<Filter*>(filter);
+    asResponseHandler->sendHeaders(response);
+    asResponseHandler->sendEOM();
+    filter->requestComplete();
+  }
+}
+
+TEST(CacheFilterTest, VaryKeyedOnConfiguredHeader) {
+  CacheFilterFactory factory;
+
+  auto runRequest = [&](const std::string& encoding, bool expectHandler) {
+    auto handler = new MockRequestHandler();
+    MockResponseHandler client(handler);
+    HTTPMessage msg;
+    auto filter = factory.onRequest(handler, &msg);
+    filter->setResponseHandler(&client);
+
+    EXPECT_CALL(*handler, onRequest(_)).Times(expectHandler ? 1 : 0);
+    EXPECT_CALL(*handler, onEOM()).Times(expectHandler ? 1 : 0);
+    EXPECT_CALL(client, sendHeaders(_));
+    EXPECT_CALL(client, sendEOM());
+    EXPECT_CALL(*handler, requestComplete());
+
+    auto request = makeGet("/varied");
+    request->getHeaders().add(HTTP_HEADER_ACCEPT_ENCODING, encoding);
+    filter->onRequest(std::move(request));
+    filter->onEOM();
+    if (expectHandler) {
+      auto response = cacheableResponse();
+      auto asResponseHandler = static_cast<Filter*>(filter);
+      asResponseHandler->sendHeaders(response);
+      asResponseHandler->sendEOM();
+    }
+    filter->requestComplete();
+  };
+
+  runRequest("gzip", true);   // miss, fills under the gzip key
+  runRequest("br", true);     // different key: another miss
+  runRequest("gzip", false);  // hit on the gzip entry
+}
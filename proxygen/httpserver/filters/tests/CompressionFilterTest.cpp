@@ -14,6 +14,7 @@
 #include <folly/portability/GTest.h>
 #include <proxygen/httpserver/filters/CompressionFilter.h>
 #include <proxygen/lib/utils/ZlibStreamCompressor.h>
+#include <proxygen/lib/utils/ZstdStreamDecompressor.h>
 #include <proxygen/httpserver/Mocks.h>
 #include <proxygen/httpserver/ResponseBuilder.h>
 
@@ -63,7 +64,11 @@ class CompressionFilterTest : public Test {
                             std::unique_ptr<folly::IOBuf> originalResponseBody,
                             int32_t compressionLevel = 4,
                             uint32_t minimumCompressionSize = 1,
-                            bool sendCompressedResponse = false) {
+                            bool sendCompressedResponse = false,
+                            bool enableZstd = false) {
+    if (expectedEncoding == "zstd") {
+      zd_ = std::make_unique<ZstdStreamDecompressor>();
+    }
 
     // If there is only one IOBuf, then it's not chunked.
     bool isResponseChunked = originalResponseBody->isChained();
@@ -149,6 +154,7 @@ class CompressionFilterTest : public Test {
     opts.zlibCompressionLevel = compressionLevel;
     opts.minimumCompressionSize = minimumCompressionSize;
     opts.compressibleContentTypes = compressibleTypes;
+    opts.enableZstd = enableZstd;
     auto filterFactory = std::make_unique<CompressionFilterFactory>(opts);
 
     auto filter = filterFactory->onRequest(requestHandler_, &msg);
@@ -231,6 +237,34 @@ TEST_F(CompressionFilterTest, NonchunkedCompression) {
   });
 }
 
+TEST_F(CompressionFilterTest, ZstdNonchunkedCompression) {
+  ASSERT_NO_FATAL_FAILURE({
+    exercise_compression(true,
+                         std::string("http://locahost/foo.compressme"),
+                         std::string("zstd, gzip"),
+                         std::string("zstd"),
+                         std::string("Hello World"),
+                         std::string("text/html"),
+                         folly::IOBuf::copyBuffer("Hello World"),
+                         4,
+                         1,
+                         false,
+                         true /* enableZstd */);
+  });
+}
+
+TEST_F(CompressionFilterTest, ZstdDisabledFallsBackToGzip) {
+  ASSERT_NO_FATAL_FAILURE({
+    exercise_compression(true,
+                         std::string("http://locahost/foo.compressme"),
+                         std::string("zstd, gzip"),
+                         std::string("gzip"),
+                         std::string("Hello World"),
+                         std::string("text/html"),
+                         folly::IOBuf::copyBuffer("Hello World"));
+  });
+}
+
 TEST_F(CompressionFilterTest, ChunkedCompression) {
   std::vector<std::string> chunks = {"Hello", " World"};
   ASSERT_NO_FATAL_FAILURE({
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/io/IOBuf.h>
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/filters/DecompressionFilter.h>
+#include <proxygen/lib/utils/ZlibStreamCompressor.h>
+
+using namespace proxygen;
+using namespace testing;
+
+class DecompressionFilterTest : public Test {
+ public:
+  void SetUp() override {
+    requestHandler_ = new MockRequestHandler();
+    responseHandler_ = std::make_unique<MockResponseHandler>(requestHandler_);
+  }
+
+  void TearDown() override {
+    Mock::VerifyAndClear(requestHandler_);
+    Mock::VerifyAndClear(responseHandler_.get());
+    delete requestHandler_;
+  }
+
+ protected:
+  RequestHandler* makeFilter(DecompressionFilter::Options options =
+                                 DecompressionFilter::Options()) {
+    DecompressionFilterFactory factory{std::move(options)};
+    auto filter = factory.onRequest(requestHandler_, nullptr);
+    filter->setResponseHandler(responseHandler_.get());
+    return filter;
+  }
+
+  static std::unique_ptr<HTTPMessage> makeRequest(
+      const std::string& encoding) {
+    auto msg = std::make_unique<HTTPMessage>();
+    msg->setURL("/upload");
+    if (!encoding.empty()) {
+      msg->getHeaders().set(HTTP_HEADER_CONTENT_ENCODING, encoding);
+    }
+    return msg;
+  }
+
+  static std::unique_ptr<folly::IOBuf> gzip(const std::string& plain) {
+    ZlibStreamCompressor compressor(CompressionType::GZIP, 6);
+    auto input = folly::IOBuf::copyBuffer(plain);
+    return compressor.compress(input.get(), true /* trailer */);
+  }
+
+  MockRequestHandler* requestHandler_;
+  std::unique_ptr<MockResponseHandler> responseHandler_;
+};
+
+TEST_F(DecompressionFilterTest, GzipBodyDecompressed) {
+  const std::string plain(2000, 'a');
+
+  EXPECT_CALL(*requestHandler_, setResponseHandler(_));
+  EXPECT_CALL(*requestHandler_, onRequest(_))
+      .WillOnce(Invoke([](std::shared_ptr<HTTPMessage> msg) {
+        EXPECT_FALSE(msg->getHeaders().exists(HTTP_HEADER_CONTENT_ENCODING));
+        EXPECT_FALSE(msg->getHeaders().exists(HTTP_HEADER_CONTENT_LENGTH));
+        EXPECT_TRUE(msg->getIsChunked());
+      }));
+  std::string received;
+  EXPECT_CALL(*requestHandler_, onBody(_))
+      .WillRepeatedly(Invoke([&](std::shared_ptr<folly::IOBuf> body) {
+        auto range = body->coalesce();
+        received.append(reinterpret_cast<const char*>(range.data()),
+                        range.size());
+      }));
+  EXPECT_CALL(*requestHandler_, onEOM());
+  EXPECT_CALL(*requestHandler_, requestComplete());
+
+  auto filter = makeFilter();
+  filter->onRequest(makeRequest("gzip"));
+  filter->onBody(gzip(plain));
+  filter->onEOM();
+  EXPECT_EQ(received, plain);
+  filter->requestComplete();
+}
+
+TEST_F(DecompressionFilterTest, IdentityPassthrough) {
+  EXPECT_CALL(*requestHandler_, setResponseHandler(_));
+  EXPECT_CALL(*requestHandler_, onRequest(_))
+      .WillOnce(Invoke([](std::shared_ptr<HTTPMessage> msg) {
+        EXPECT_FALSE(msg->getIsChunked());
+      }));
+  EXPECT_CALL(*requestHandler_, onBody(_))
+      .WillOnce(Invoke([](std::shared_ptr<folly::IOBuf> body) {
+        EXPECT_EQ(body->computeChainDataLength(), 5);
+      }));
+  EXPECT_CALL(*requestHandler_, onEOM());
+  EXPECT_CALL(*requestHandler_, requestComplete());
+
+  auto filter = makeFilter();
+  filter->onRequest(makeRequest(""));
+  filter->onBody(folly::IOBuf::copyBuffer("hello"));
+  filter->onEOM();
+  filter->requestComplete();
+}
+
+TEST_F(DecompressionFilterTest, AbsoluteSizeGuard) {
+  EXPECT_CALL(*requestHandler_, setResponseHandler(_));
+  EXPECT_CALL(*requestHandler_, onRequest(_));
+  // nothing decompressed reaches the handler once the cap trips
+  EXPECT_CALL(*requestHandler_, onBody(_)).Times(0);
+  EXPECT_CALL(*requestHandler_, onEOM()).Times(0);
+  EXPECT_CALL(*requestHandler_, requestComplete());
+
+  HTTPMessage response;
+  EXPECT_CALL(*responseHandler_, sendHeaders(_))
+      .WillOnce(SaveArg<0>(&response));
+  EXPECT_CALL(*responseHandler_, sendEOM());
+
+  uint64_t rejects = 0;
+  DecompressionFilter::Options options;
+  options.maxDecompressedBodySize = 100;
+  options.rejectStatsFn = [&rejects] { rejects++; };
+
+  auto filter = makeFilter(std::move(options));
+  filter->onRequest(makeRequest("gzip"));
+  filter->onBody(gzip(std::string(2000, 'a')));
+  filter->onEOM();
+  EXPECT_EQ(response.getStatusCode(), 413);
+  EXPECT_EQ(rejects, 1);
+  filter->requestComplete();
+}
+
+TEST_F(DecompressionFilterTest, CorruptStreamRejected) {
+  EXPECT_CALL(*requestHandler_, setResponseHandler(_));
+  EXPECT_CALL(*requestHandler_, onRequest(_));
+  EXPECT_CALL(*requestHandler_, onBody(_)).Times(0);
+  EXPECT_CALL(*requestHandler_, onEOM()).Times(0);
+  EXPECT_CALL(*requestHandler_, requestComplete());
+
+  HTTPMessage response;
+  EXPECT_CALL(*responseHandler_, sendHeaders(_))
+      .WillOnce(SaveArg<0>(&response));
+  EXPECT_CALL(*responseHandler_, sendEOM());
+
+  auto filter = makeFilter();
+  filter->onRequest(makeRequest("gzip"));
+  filter->onBody(folly::IOBuf::copyBuffer("this is not gzip data at all"));
+  filter->onEOM();
+  EXPECT_EQ(response.getStatusCode(), 400);
+  filter->requestComplete();
+}
+
+TEST_F(DecompressionFilterTest, TruncatedStreamRejected) {
+  EXPECT_CALL(*requestHandler_, setResponseHandler(_));
+  EXPECT_CALL(*requestHandler_, onRequest(_));
+  EXPECT_CALL(*requestHandler_, onBody(_)).Times(AtMost(1));
+  EXPECT_CALL(*requestHandler_, onEOM()).Times(0);
+  EXPECT_CALL(*requestHandler_, requestComplete());
+
+  HTTPMessage response;
+  EXPECT_CALL(*responseHandler_, sendHeaders(_))
+      .WillOnce(SaveArg<0>(&response));
+  EXPECT_CALL(*responseHandler_, sendEOM());
+
+  auto filter = makeFilter();
+  filter->onRequest(makeRequest("gzip"));
+  auto compressed = gzip(std::string(2000, 'a'));
+  compressed->coalesce();
+  compressed->trimEnd(10); // drop the gzip trailer
+  filter->onBody(std::move(compressed));
+  filter->onEOM();
+  EXPECT_EQ(response.getStatusCode(), 400);
+  filter->requestComplete();
+}
+
+TEST_F(DecompressionFilterTest, ExpansionStats) {
+  const std::string plain(100000, 'x');
+
+  EXPECT_CALL(*requestHandler_, setResponseHandler(_));
+  EXPECT_CALL(*requestHandler_, onRequest(_));
+  EXPECT_CALL(*requestHandler_, onBody(_)).Times(AtLeast(1));
+  EXPECT_CALL(*requestHandler_, onEOM());
+  EXPECT_CALL(*requestHandler_, requestComplete());
+
+  uint64_t compressed = 0;
+  uint64_t decompressed = 0;
+  DecompressionFilter::Options options;
+  // highly repetitive input expands far beyond any sane default, so
+  // open the guards wide and observe the ratio instead
+  options.maxExpansionRatio = 100000;
+  options.expansionStatsFn = [&](uint64_t c, uint64_t d) {
+    compressed = c;
+    decompressed = d;
+  };
+
+  auto filter = makeFilter(std::move(options));
+  filter->onRequest(makeRequest("gzip"));
+  filter->onBody(gzip(plain));
+  filter->onEOM();
+  EXPECT_EQ(decompressed, plain.size());
+  EXPECT_GT(compressed, 0);
+  EXPECT_LT(compressed, decompressed);
+  filter->requestComplete();
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Conv.h>
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/filters/RateLimitFilter.h>
+
+using namespace proxygen;
+using namespace testing;
+
+namespace {
+
+RateLimitFilterFactory::Options keyedOptions(double rate, double burst) {
+  RateLimitFilterFactory::Options opts;
+  opts.ratePerSec = rate;
+  opts.burst = burst;
+  opts.keyFn = [](const HTTPMessage& msg) {
+    return msg.getHeaders().getSingleOrEmpty("x-tenant");
+  };
+  return opts;
+}
+
+HTTPMessage tenantRequest(const std::string& tenant) {
+  HTTPMessage msg;
+  msg.getHeaders().add("x-tenant", tenant);
+  return msg;
+}
+
+} // namespace
+
+TEST(RateLimitFilterTest, BurstThenLimited) {
+  RateLimitFilterFactory factory(keyedOptions(1, 3));
+
+  MockRequestHandler handler;
+  auto msg = tenantRequest("acme");
+  // the burst passes through untouched...
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(factory.onRequest(&handler, &msg), &handler);
+  }
+  // ...then the key is limited and the chain gets wrapped
+  auto rejected = factory.onRequest(&handler, &msg);
+  ASSERT_NE(rejected, &handler);
+
+  MockResponseHandler client(rejected);
+  rejected->setResponseHandler(&client);
+  HTTPMessage response;
+  EXPECT_CALL(client, sendHeaders(_)).WillOnce(Invoke([](HTTPMessage& sent) {
+    EXPECT_EQ(sent.getStatusCode(), 429);
+  }));
+  EXPECT_CALL(client, sendEOM());
+  EXPECT_CALL(handler, requestComplete());
+  rejected->onRequest(std::make_unique<HTTPMessage>());
+  rejected->onEOM();
+  rejected->requestComplete();
+}
+
+TEST(RateLimitFilterTest, KeysAreIndependent) {
+  RateLimitFilterFactory factory(keyedOptions(1, 1));
+
+  MockRequestHandler handler;
+  auto acme = tenantRequest("acme");
+  auto globex = tenantRequest("globex");
+  EXPECT_EQ(factory.onRequest(&handler, &acme), &handler);
+  // acme exhausted its burst; globex is untouched
+  EXPECT_NE(factory.onRequest(&handler, &acme), &handler);
+  EXPECT_EQ(factory.onRequest(&handler, &globex), &handler);
+}
+
+TEST(RateLimitFilterTest, SlabBoundHolds) {
+  auto opts = keyedOptions(1, 1);
+  opts.maxKeys = 8;
+  RateLimitFilterFactory factory(std::move(opts));
+
+  MockRequestHandler handler;
+  // far more keys than slots: every first-seen key still admits
+  // (recycled slots restart at full burst)
+  for (int i = 0; i < 1000; i++) {
+    auto msg = tenantRequest(folly::to<std::string>("tenant-", i));
+    EXPECT_EQ(factory.onRequest(&handler, &msg), &handler);
+  }
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/filters/ShadowFilter.h>
+
+using namespace proxygen;
+using namespace testing;
+
+namespace {
+
+// counts dispatch attempts; never actually carries a shadow
+class RefusingDispatcher : public ShadowDispatcher {
+ public:
+  HTTPTransaction* newShadowTransaction(
+      HTTPTransactionHandler*) noexcept override {
+    attempts++;
+    return nullptr;
+  }
+  uint32_t attempts{0};
+};
+
+} // namespace
+
+TEST(ShadowFilterTest, SamplesOneInN) {
+  ShadowFilterFactory::Options opts;
+  opts.sampleEvery = 3;
+  RefusingDispatcher dispatcher;
+  ShadowFilterFactory factory(opts, &dispatcher);
+
+  HTTPMessage msg;
+  MockRequestHandler handler;
+  uint32_t wrapped = 0;
+  for (int i = 0; i < 9; i++) {
+    auto result = factory.onRequest(&handler, &msg);
+    if (result != &handler) {
+      wrapped++;
+      // not driven through a request in this test
+      delete result;
+    }
+  }
+  EXPECT_EQ(wrapped, 3);
+}
+
+TEST(ShadowFilterTest, RefusedDispatchLeavesPrimaryUntouched) {
+  ShadowFilterFactory::Options opts;
+  opts.sampleEvery = 1; // shadow every request
+  RefusingDispatcher dispatcher;
+  ShadowFilterFactory factory(opts, &dispatcher);
+
+  auto requestHandler = new MockRequestHandler();
+  MockResponseHandler responseHandler(requestHandler);
+
+  HTTPMessage msg;
+  auto filter = factory.onRequest(requestHandler, &msg);
+  ASSERT_NE(filter, requestHandler);
+  filter->setResponseHandler(&responseHandler);
+
+  EXPECT_CALL(*requestHandler, onRequest(_));
+  EXPECT_CALL(*requestHandler, onBody(_));
+  EXPECT_CALL(*requestHandler, onEOM());
+  EXPECT_CALL(*requestHandler, requestComplete());
+
+  filter->onRequest(std::make_unique<HTTPMessage>());
+  filter->onBody(folly::IOBuf::copyBuffer("hello"));
+  filter->onEOM();
+  filter->requestComplete();
+  EXPECT_EQ(dispatcher.attempts, 1);
+}
+
+TEST(ShadowFilterTest, ZeroSampleRateDisables) {
+  ShadowFilterFactory::Options opts;
+  opts.sampleEvery = 0;
+  RefusingDispatcher dispatcher;
+  ShadowFilterFactory factory(opts, &dispatcher);
+
+  HTTPMessage msg;
+  MockRequestHandler handler;
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(factory.onRequest(&handler, &msg), &handler);
+  }
+  EXPECT_EQ(dispatcher.attempts, 0);
+}
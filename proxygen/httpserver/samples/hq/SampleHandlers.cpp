@@ -31,7 +31,8 @@ void WaitReleaseHandler::onHeadersComplete(
   VLOG(10) << "WaitReleaseHandler::onHeadersComplete";
   msg->dumpMessage(2);
   path_ = msg->getPath();
-  auto idstr = msg->getQueryParam("id");
+  std::string idScratch;
+  auto idstr = msg->getQueryParamDecoded("id", idScratch);
 
   if (msg->getMethod() != proxygen::HTTPMethod::GET ||
       idstr == proxygen::empty_string ||
@@ -10,10 +10,13 @@
 
 #include <proxygen/httpserver/RequestHandler.h>
 #include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/http/connpool/SessionPool.h>
 #include <proxygen/lib/http/session/HTTPUpstreamSession.h>
 #include <proxygen/lib/utils/URL.h>
+#include <folly/SingletonThreadLocal.h>
 #include <folly/portability/GFlags.h>
 #include <folly/io/async/EventBaseManager.h>
+#include <map>
 
 #include "ProxyStats.h"
 
@@ -23,6 +26,10 @@ using std::unique_ptr;
 
 DEFINE_int32(proxy_connect_timeout, 1000,
     "connect timeout in milliseconds");
+DEFINE_int32(proxy_max_idle_sessions_per_origin, 4,
+    "maximum keep-alive upstream sessions pooled per origin per thread");
+DEFINE_int32(proxy_pool_idle_timeout, 30000,
+    "milliseconds an upstream session may sit idle in the pool");
 
 namespace {
 static const uint32_t kMinReadSize = 1460;
@@ -31,6 +38,23 @@ static const uint32_t kMaxReadSize = 4000;
 static const uint8_t READS_SHUTDOWN = 1;
 static const uint8_t WRITES_SHUTDOWN = 2;
 static const uint8_t CLOSED = READS_SHUTDOWN | WRITES_SHUTDOWN;
+
+// Per-thread, per-origin pools of keep-alive upstream sessions.
+// SessionPool is single-threaded, so each worker keeps its own map.
+proxygen::SessionPool& originPool(const std::string& origin,
+                                  ProxyService::ProxyStats* stats) {
+  struct PoolMapTag {};
+  using PoolMap = std::map<std::string, std::unique_ptr<proxygen::SessionPool>>;
+  auto& pools = folly::SingletonThreadLocal<PoolMap, PoolMapTag>::get();
+  auto& pool = pools[origin];
+  if (!pool) {
+    pool = std::make_unique<proxygen::SessionPool>(
+        stats,
+        FLAGS_proxy_max_idle_sessions_per_origin,
+        std::chrono::milliseconds(FLAGS_proxy_pool_idle_timeout));
+  }
+  return *pool;
+}
 }
 
 namespace ProxyService {
@@ -60,7 +84,7 @@ void ProxyHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
     addr.setFromHostPort(url.getHost(), url.getPort());
   } catch (...) {
     ResponseBuilder(downstream_)
-      .status(503, "Bad Gateway")
+      .status(502, "Bad Gateway")
       .body(folly::to<string>("Could not parse server from URL: ",
                               request_->getURL()))
       .sendWithEOM();
@@ -72,10 +96,30 @@ void ProxyHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
   LOG(INFO) << "Trying to connect to " << addr;
   auto evb = folly::EventBaseManager::get()->getEventBase();
   if (request_->getMethod() == HTTPMethod::CONNECT) {
+    /*
+     * Tunnel bytes still traverse codec + transaction + handler on the
+     * downstream side. A spliced fast path (user-space relay with
+     * pooled buffers, or splice(2) when both legs are plain TCP) needs
+     * the session to relinquish its socket after the upgrade -
+     * AsyncSocket::detachNetworkSocket exists, but HTTPSession has no
+     * teardown that hands the fd over with its read buffers intact
+     * while keeping byte accounting. Until the session grows that
+     * handoff, the codec's upgraded passthrough (one IOBuf clone per
+     * read, no parsing) is the floor for relay cost.
+     */
     upstreamSock_ = folly::AsyncSocket::newSocket(evb);
     upstreamSock_->connect(this, addr, FLAGS_proxy_connect_timeout);
   } else {
-    // A more sophisticated proxy would have a connection pool here
+    originKey_ = folly::to<string>(url.getHost(), ':', url.getPort());
+    // reuse a pooled keep-alive session to this origin when available
+    txn_ = originPool(originKey_, stats_).getTransaction(&serverHandler_);
+    if (txn_) {
+      LOG(INFO) << "Reusing pooled session for " << originKey_;
+      propagateDeadline();
+      txn_->sendHeaders(*request_);
+      downstream_->resumeIngress();
+      return;
+    }
     const folly::AsyncSocket::OptionMap opts{
       {{SOL_SOCKET, SO_REUSEADDR}, 1}};
     downstream_->pauseIngress();
@@ -116,10 +160,36 @@ void ProxyHandler::onEOM() noexcept {
   }
 }
 
+void ProxyHandler::propagateDeadline() {
+  // one end-to-end budget: hand the client transaction's deadline to
+  // the upstream leg instead of stacking another timer
+  auto downstreamTxn = downstream_->getTransaction();
+  if (downstreamTxn && downstreamTxn->getDeadline()) {
+    txn_->setDeadline(*downstreamTxn->getDeadline());
+  }
+}
+
 void ProxyHandler::connectSuccess(HTTPUpstreamSession* session) {
   LOG(INFO) << "Established " << *session;
-  session_ = std::make_unique<SessionWrapper>(session);
-  txn_ = session->newTransaction(&serverHandler_);
+  // the pool owns the session; after this response it stays available
+  // for the next request to the same origin
+  auto& pool = originPool(originKey_, stats_);
+  pool.putSession(session);
+  txn_ = pool.getTransaction(&serverHandler_);
+  if (txn_) {
+    propagateDeadline();
+  } else {
+    LOG(ERROR) << "Could not open transaction on fresh session";
+    if (!clientTerminated_) {
+      ResponseBuilder(downstream_)
+        .status(502, "Bad Gateway")
+        .sendWithEOM();
+    } else {
+      abortDownstream();
+      checkForShutdown();
+    }
+    return;
+  }
   LOG(INFO) << "Forwarding client request: " << request_->getURL()
             << " to server";
   txn_->sendHeaders(*request_);
@@ -130,7 +200,7 @@ void ProxyHandler::connectError(const folly::AsyncSocketException& ex) {
   LOG(ERROR) << "Failed to connect: " << folly::exceptionStr(ex);
   if (!clientTerminated_) {
     ResponseBuilder(downstream_)
-      .status(503, "Bad Gateway")
+      .status(502, "Bad Gateway")
       .sendWithEOM();
   } else {
     abortDownstream();
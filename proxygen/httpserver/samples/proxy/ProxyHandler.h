@@ -12,7 +12,6 @@
 #include <folly/io/async/AsyncSocket.h>
 #include <proxygen/httpserver/RequestHandler.h>
 #include <proxygen/lib/http/HTTPConnector.h>
-#include "SessionWrapper.h"
 
 namespace proxygen {
 class ResponseHandler;
@@ -59,6 +58,8 @@ class ProxyHandler : public proxygen::RequestHandler,
   void onServerEgressResumed() noexcept;
 
  private:
+  void propagateDeadline();
+
 
   void connectSuccess(proxygen::HTTPUpstreamSession* session) override;
   void connectError(const folly::AsyncSocketException& ex) override;
@@ -129,7 +130,8 @@ class ProxyHandler : public proxygen::RequestHandler,
   ProxyStats* const stats_{nullptr};
   proxygen::HTTPConnector connector_;
   ServerTransactionHandler serverHandler_;
-  std::unique_ptr<SessionWrapper> session_;
+  // key into the per-thread origin session pools
+  std::string originKey_;
   proxygen::HTTPTransaction* txn_{nullptr};
   bool clientTerminated_{false};
 
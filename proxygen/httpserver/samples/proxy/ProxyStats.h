@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <proxygen/lib/http/connpool/SessionHolder.h>
 #include <stdint.h>
 
 namespace ProxyService {
@@ -17,9 +18,9 @@ namespace ProxyService {
  * one instance of this in each class, there is no need of
  * synchronization
  */
-class ProxyStats {
+class ProxyStats : public proxygen::SessionHolder::Stats {
  public:
-  virtual ~ProxyStats() {
+  ~ProxyStats() override {
   }
 
   // NOTE: We make the following methods `virtual` so that we can
@@ -35,8 +36,40 @@ class ProxyStats {
     return reqCount_;
   }
 
+  // proxygen::SessionHolder::Stats: upstream pool activity
+  void onConnectionCreated() override {
+    ++poolConnectionsCreated_;
+  }
+  void onConnectionClosed() override {
+    ++poolConnectionsClosed_;
+  }
+  void onConnectionActivated() override {
+    ++poolConnectionsActive_;
+  }
+  void onConnectionDeactivated() override {
+    --poolConnectionsActive_;
+  }
+  void onRead(size_t bytesRead) override {
+    poolBytesRead_ += bytesRead;
+  }
+  void onWrite(size_t bytesWritten) override {
+    poolBytesWritten_ += bytesWritten;
+  }
+
+  uint64_t getPoolConnectionsCreated() const {
+    return poolConnectionsCreated_;
+  }
+  uint64_t getPoolConnectionsActive() const {
+    return poolConnectionsActive_;
+  }
+
  private:
   uint64_t reqCount_{0};
+  uint64_t poolConnectionsCreated_{0};
+  uint64_t poolConnectionsClosed_{0};
+  uint64_t poolConnectionsActive_{0};
+  uint64_t poolBytesRead_{0};
+  uint64_t poolBytesWritten_{0};
 };
 
 }
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "StaticFileCache.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <folly/Format.h>
+#include <proxygen/lib/utils/FileRegion.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace StaticService {
+
+std::shared_ptr<const StaticFileCache::Entry> StaticFileCache::get(
+    const std::string& path) {
+  std::lock_guard<std::mutex> guard(lock_);
+  auto it = entries_.find(path);
+  if (it != entries_.end()) {
+    auto& node = it->second;
+    const time_t now = time(nullptr);
+    if (now - node.lastValidated >= kRevalidateSeconds) {
+      struct stat st;
+      if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode) ||
+          st.st_mtime != node.entry->mtime ||
+          uint64_t(st.st_size) != node.entry->size) {
+        // stale or gone: drop and reload below
+        cachedBytes_ -= node.entry->size;
+        lru_.erase(node.lruIt);
+        entries_.erase(it);
+        return loadLocked(path);
+      }
+      node.lastValidated = now;
+    }
+    // move to the front of the LRU
+    lru_.splice(lru_.begin(), lru_, node.lruIt);
+    return node.entry;
+  }
+  return loadLocked(path);
+}
+
+std::shared_ptr<const StaticFileCache::Entry> StaticFileCache::loadLocked(
+    const std::string& path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+      uint64_t(st.st_size) > maxFileBytes_) {
+    close(fd);
+    return nullptr;
+  }
+  auto entry = std::make_shared<Entry>();
+  entry->size = st.st_size;
+  entry->mtime = st.st_mtime;
+  entry->etag = folly::sformat("\"{:x}-{:x}-{:x}\"",
+                               uint64_t(st.st_ino),
+                               uint64_t(st.st_size),
+                               uint64_t(st.st_mtime));
+  if (st.st_size > 0) {
+    entry->body = proxygen::FileRegion::mmapRange(fd, 0, st.st_size);
+    if (!entry->body) {
+      close(fd);
+      return nullptr;
+    }
+  } else {
+    entry->body = folly::IOBuf::create(0);
+  }
+  // the mapping keeps the pages alive; the fd is no longer needed
+  close(fd);
+
+  lru_.push_front(path);
+  CacheNode node;
+  node.entry = entry;
+  node.lruIt = lru_.begin();
+  node.lastValidated = time(nullptr);
+  entries_.emplace(path, std::move(node));
+  cachedBytes_ += entry->size;
+  evictLocked();
+  return entry;
+}
+
+void StaticFileCache::evictLocked() {
+  while (cachedBytes_ > maxBytes_ && lru_.size() > 1) {
+    const auto& victim = lru_.back();
+    auto it = entries_.find(victim);
+    CHECK(it != entries_.end());
+    // outstanding responses keep the body alive through the shared_ptr
+    cachedBytes_ -= it->second.entry->size;
+    entries_.erase(it);
+    lru_.pop_back();
+  }
+}
+
+} // namespace StaticService
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace StaticService {
+
+/**
+ * Process-wide cache of mmap-backed static file bodies with LRU
+ * eviction and a byte bound, so hot assets are served from memory
+ * without per-request open/read/stat work. Entries revalidate against
+ * the file's mtime at most once per kRevalidateSeconds; a changed file
+ * is reloaded on the next lookup.
+ *
+ * All methods are thread-safe.
+ */
+class StaticFileCache {
+ public:
+  struct Entry {
+    std::shared_ptr<folly::IOBuf> body; // mmap-backed chain
+    uint64_t size{0};
+    time_t mtime{0};
+    std::string etag;
+  };
+
+  static constexpr time_t kRevalidateSeconds = 2;
+
+  explicit StaticFileCache(uint64_t maxBytes, uint64_t maxFileBytes)
+      : maxBytes_(maxBytes), maxFileBytes_(maxFileBytes) {
+  }
+
+  /**
+   * Look up (and on miss, load and insert) the file at path.
+   * Returns nullptr if the file can't be opened, isn't regular, or is
+   * larger than the per-file limit - callers fall back to streaming.
+   */
+  std::shared_ptr<const Entry> get(const std::string& path);
+
+  uint64_t cachedBytes() const {
+    std::lock_guard<std::mutex> guard(lock_);
+    return cachedBytes_;
+  }
+
+ private:
+  struct CacheNode {
+    std::shared_ptr<const Entry> entry;
+    std::list<std::string>::iterator lruIt;
+    time_t lastValidated{0};
+  };
+
+  // must hold lock_
+  void evictLocked();
+  std::shared_ptr<const Entry> loadLocked(const std::string& path);
+
+  const uint64_t maxBytes_;
+  const uint64_t maxFileBytes_;
+  mutable std::mutex lock_;
+  uint64_t cachedBytes_{0};
+  std::list<std::string> lru_; // front = most recently used
+  std::unordered_map<std::string, CacheNode> entries_;
+};
+
+} // namespace StaticService
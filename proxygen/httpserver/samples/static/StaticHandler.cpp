@@ -8,20 +8,38 @@
 
 #include "StaticHandler.h"
 
+#include "StaticFileCache.h"
+
 #include <proxygen/httpserver/RequestHandler.h>
 #include <proxygen/httpserver/ResponseBuilder.h>
+#include <proxygen/lib/utils/FileRegion.h>
 #include <folly/io/async/EventBaseManager.h>
 #include <folly/FileUtil.h>
 #include <folly/executors/GlobalExecutor.h>
+#include <sys/stat.h>
 
 using namespace proxygen;
 
 namespace StaticService {
 
+namespace {
+// window of the file mapped and prefaulted per trip to the CPU pool
+constexpr size_t kReadWindow = 4 << 20;
+
+// process-wide cache of hot assets; files over the per-file bound use
+// the streaming path below
+StaticFileCache& fileCache() {
+  static StaticFileCache cache(256ULL << 20 /* total */,
+                               4ULL << 20 /* per file */);
+  return cache;
+}
+}
+
 /**
  * Handles requests by serving the file named in path.  Only supports GET.
- * reads happen in a CPU thread pool since read(2) is blocking.
- * If egress pauses, file reading is also paused.
+ * File windows are mmap'd and prefaulted in a CPU thread pool (page
+ * faults block), then the pinned pages are sent without any user-space
+ * copies. If egress pauses, file mapping is also paused.
  */
 
 void StaticHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
@@ -47,6 +65,16 @@ void StaticHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
       .sendWithEOM();
     return;
   }
+  struct stat st;
+  if (fstat(file_->fd(), &st) != 0 || !S_ISREG(st.st_mode)) {
+    file_.reset();
+    ResponseBuilder(downstream_)
+      .status(404, "Not Found")
+      .body("Not a regular file")
+      .sendWithEOM();
+    return;
+  }
+  fileSize_ = st.st_size;
   ResponseBuilder(downstream_)
     .status(200, "Ok")
     .send();
@@ -58,21 +86,10 @@ void StaticHandler::onRequest(std::unique_ptr<HTTPMessage> headers) noexcept {
 }
 
 void StaticHandler::readFile(folly::EventBase* evb) {
-  folly::IOBufQueue buf;
   while (file_ && !paused_) {
-    // read 4k-ish chunks and foward each one to the client
-    auto data = buf.preallocate(4000, 4000);
-    auto rc = folly::readNoInt(file_->fd(), data.first, data.second);
-    if (rc < 0) {
-      // error
-      VLOG(4) << "Read error=" << rc;
-      file_.reset();
-      evb->runInEventBaseThread([this] {
-          LOG(ERROR) << "Error reading file";
-          downstream_->sendAbort();
-        });
-      break;
-    } else if (rc == 0) {
+    // map and prefault the next window; the event base thread sends the
+    // pinned pages without copying them
+    if (offset_ >= fileSize_) {
       // done
       file_.reset();
       VLOG(4) << "Read EOF";
@@ -81,14 +98,25 @@ void StaticHandler::readFile(folly::EventBase* evb) {
             .sendWithEOM();
         });
       break;
-    } else {
-      buf.postallocate(rc);
-      evb->runInEventBaseThread([this, body=buf.move()] () mutable {
-          ResponseBuilder(downstream_)
-            .body(std::move(body))
-            .send();
+    }
+    auto len = std::min<uint64_t>(kReadWindow, fileSize_ - offset_);
+    auto body = proxygen::FileRegion::mmapRange(
+        file_->fd(), offset_, len, true /* prefault */);
+    if (!body) {
+      // error
+      file_.reset();
+      evb->runInEventBaseThread([this] {
+          LOG(ERROR) << "Error mapping file";
+          downstream_->sendAbort();
         });
+      break;
     }
+    offset_ += len;
+    evb->runInEventBaseThread([this, body=std::move(body)] () mutable {
+        ResponseBuilder(downstream_)
+          .body(std::move(body))
+          .send();
+      });
   }
 
   // Notify the request thread that we terminated the readFile loop
@@ -42,6 +42,8 @@ class StaticHandler : public proxygen::RequestHandler {
   bool checkForCompletion();
 
   std::unique_ptr<folly::File> file_;
+  uint64_t fileSize_{0};
+  uint64_t offset_{0};
   bool readFileScheduled_{false};
   std::atomic<bool> paused_{false};
   bool finished_{false};
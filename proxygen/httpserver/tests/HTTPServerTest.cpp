@@ -719,6 +719,37 @@ class ScopedServerTest : public testing::Test {
         HTTPServer::Protocol::HTTP};
 };
 
+TEST_F(ScopedServerTest, FastLaneRoute) {
+  auto opts = createDefaultOpts();
+  opts.fastLaneRoutes.push_back(
+      [](const HTTPMessage& msg,
+         HTTPServerOptions::PrebuiltResponse& response) {
+        if (msg.getPath() != "/health") {
+          return false;
+        }
+        response.body = folly::IOBuf::copyBuffer("ok");
+        return true;
+      });
+  auto server = ScopedHTTPServer::start(cfg_, std::move(opts));
+  auto port = server->getAddresses().front().address.getPort();
+
+  URL url(folly::to<std::string>("http://localhost:", port, "/health"));
+  HTTPHeaders headers;
+  CurlClient client(&evb_, HTTPMethod::GET, url, nullptr, headers, "");
+  client.setFlowControlSettings(64 * 1024);
+  client.setLogging(false);
+  HTTPConnector connector(&client, timer_.get());
+  folly::SocketAddress address("127.0.0.1", port);
+  connector.connect(&evb_, address, std::chrono::milliseconds(1000));
+  evb_.loop();
+
+  auto resp = client.getResponse();
+  ASSERT_NE(resp, nullptr);
+  EXPECT_EQ(200, resp->getStatusCode());
+  EXPECT_EQ(resp->getHeaders().getSingleOrEmpty(HTTP_HEADER_CONTENT_LENGTH),
+            "2");
+}
+
 TEST_F(ScopedServerTest, Start) {
   auto server = createScopedServer();
   auto client = connectPlainText();
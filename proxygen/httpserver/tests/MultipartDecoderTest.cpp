@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/MultipartDecoder.h>
+
+using namespace proxygen;
+
+namespace {
+
+struct Part {
+  HTTPHeaders headers;
+  std::string data;
+};
+
+class CollectingCallback : public MultipartDecoder::Callback {
+ public:
+  void onPartBegin(HTTPHeaders headers) override {
+    parts.emplace_back();
+    parts.back().headers = std::move(headers);
+  }
+  void onPartData(std::unique_ptr<folly::IOBuf> data) override {
+    parts.back().data += data->moveToFbString().toStdString();
+  }
+  void onPartEnd() override {
+    endedParts++;
+  }
+  void onDone() override {
+    done = true;
+  }
+  void onError(const std::string& what) override {
+    error = what;
+  }
+
+  std::vector<Part> parts;
+  uint32_t endedParts{0};
+  bool done{false};
+  std::string error;
+};
+
+const std::string kBody =
+    "--bnd\r\n"
+    "Content-Disposition: form-data; name=\"title\"\r\n"
+    "\r\n"
+    "hello world\r\n"
+    "--bnd\r\n"
+    "Content-Disposition: form-data; name=\"file\"; filename=\"a.bin\"\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "\r\n"
+    "binary\r\ndata with \r\n\r\n inside\r\n"
+    "--bnd--\r\n";
+
+} // namespace
+
+TEST(MultipartDecoderTest, TwoPartsOneChain) {
+  CollectingCallback callback;
+  MultipartDecoder decoder("bnd", callback);
+  decoder.onIngress(folly::IOBuf::copyBuffer(kBody));
+  decoder.onIngressEOM();
+
+  ASSERT_TRUE(callback.error.empty()) << callback.error;
+  EXPECT_TRUE(callback.done);
+  ASSERT_EQ(callback.parts.size(), 2);
+  EXPECT_EQ(callback.endedParts, 2);
+  EXPECT_EQ(callback.parts[0].data, "hello world");
+  EXPECT_EQ(callback.parts[0].headers.getSingleOrEmpty("content-disposition"),
+            "form-data; name=\"title\"");
+  EXPECT_EQ(callback.parts[1].data,
+            "binary\r\ndata with \r\n\r\n inside");
+  EXPECT_EQ(callback.parts[1].headers.getSingleOrEmpty("content-type"),
+            "application/octet-stream");
+}
+
+TEST(MultipartDecoderTest, ResumableAtEverySplit) {
+  // the decoder must produce identical parts no matter where the body
+  // is split across onIngress calls
+  for (size_t split = 1; split < kBody.size(); split++) {
+    CollectingCallback callback;
+    MultipartDecoder decoder("bnd", callback);
+    decoder.onIngress(folly::IOBuf::copyBuffer(kBody.data(), split));
+    decoder.onIngress(folly::IOBuf::copyBuffer(kBody.data() + split,
+                                               kBody.size() - split));
+    decoder.onIngressEOM();
+    ASSERT_TRUE(callback.error.empty()) << "split=" << split;
+    EXPECT_TRUE(callback.done) << "split=" << split;
+    ASSERT_EQ(callback.parts.size(), 2) << "split=" << split;
+    EXPECT_EQ(callback.parts[0].data, "hello world") << "split=" << split;
+    EXPECT_EQ(callback.parts[1].data,
+              "binary\r\ndata with \r\n\r\n inside")
+        << "split=" << split;
+  }
+}
+
+TEST(MultipartDecoderTest, TruncatedBodyErrors) {
+  CollectingCallback callback;
+  MultipartDecoder decoder("bnd", callback);
+  decoder.onIngress(folly::IOBuf::copyBuffer(kBody.data(), kBody.size() - 8));
+  decoder.onIngressEOM();
+  EXPECT_FALSE(callback.error.empty());
+  EXPECT_FALSE(callback.done);
+}
+
+TEST(MultipartDecoderTest, HeaderlessPart) {
+  CollectingCallback callback;
+  MultipartDecoder decoder("b", callback);
+  decoder.onIngress(folly::IOBuf::copyBuffer(
+      "--b\r\n\r\npayload\r\n--b--\r\n"));
+  decoder.onIngressEOM();
+  ASSERT_TRUE(callback.error.empty()) << callback.error;
+  ASSERT_EQ(callback.parts.size(), 1);
+  EXPECT_EQ(callback.parts[0].data, "payload");
+  EXPECT_EQ(callback.parts[0].headers.size(), 0);
+}
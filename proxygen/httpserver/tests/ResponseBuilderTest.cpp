@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/ResponseBuilder.h>
+
+using namespace proxygen;
+using namespace testing;
+
+TEST(ResponseBuilderTest, EarlyHintsThenFinalResponse) {
+  MockRequestHandler handler;
+  MockResponseHandler responseHandler(&handler);
+
+  std::vector<uint16_t> statuses;
+  EXPECT_CALL(responseHandler, sendHeaders(_))
+      .WillRepeatedly(Invoke([&](HTTPMessage& msg) {
+        statuses.push_back(msg.getStatusCode());
+        if (msg.getStatusCode() == 103) {
+          EXPECT_EQ(msg.getHeaders().getSingleOrEmpty("link"),
+                    "</style.css>; rel=preload; as=style");
+          // interim responses must not carry entity framing
+          EXPECT_FALSE(
+              msg.getHeaders().exists(HTTP_HEADER_CONTENT_LENGTH));
+          EXPECT_FALSE(msg.getIsChunked());
+        }
+      }));
+  EXPECT_CALL(responseHandler, sendBody(_));
+  EXPECT_CALL(responseHandler, sendEOM());
+
+  HTTPHeaders hints;
+  hints.add("link", "</style.css>; rel=preload; as=style");
+  ResponseBuilder(&responseHandler).sendEarlyHints(hints);
+
+  ResponseBuilder(&responseHandler)
+      .status(200, "OK")
+      .body(folly::IOBuf::copyBuffer("hello"))
+      .sendWithEOM();
+
+  ASSERT_EQ(statuses.size(), 2);
+  EXPECT_EQ(statuses[0], 103);
+  EXPECT_EQ(statuses[1], 200);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <fcntl.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/SocketHandover.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace proxygen;
+
+TEST(SocketHandoverTest, PassFds) {
+  folly::test::TemporaryDirectory dir;
+  auto path = (dir.path() / "handover.sock").string();
+
+  // descriptors to hand over: a pipe pair stands in for listen sockets
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  std::vector<int> received;
+  std::thread receiver([&] {
+    received =
+        SocketHandover::receiveFds(path, std::chrono::milliseconds(5000));
+  });
+  // wait out the receiver's bind/listen window with a bounded retry
+  bool sent = false;
+  for (int i = 0; i < 1000 && !sent; i++) {
+    sent = SocketHandover::sendFds(path, {fds[0], fds[1]});
+    if (!sent) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  EXPECT_TRUE(sent);
+  receiver.join();
+
+  ASSERT_EQ(received.size(), 2);
+  // the duplicated descriptors are live: write through the sender's
+  // copy, read through the received one
+  char byte = 'x';
+  ASSERT_EQ(write(fds[1], &byte, 1), 1);
+  char readBack = 0;
+  ASSERT_EQ(read(received[0], &readBack, 1), 1);
+  EXPECT_EQ(readBack, 'x');
+
+  for (int fd : {fds[0], fds[1], received[0], received[1]}) {
+    close(fd);
+  }
+}
+
+TEST(SocketHandoverTest, ReceiveTimeout) {
+  folly::test::TemporaryDirectory dir;
+  auto path = (dir.path() / "handover.sock").string();
+  auto received =
+      SocketHandover::receiveFds(path, std::chrono::milliseconds(10));
+  EXPECT_TRUE(received.empty());
+}
+
+TEST(SocketHandoverTest, SendWithoutReceiver) {
+  folly::test::TemporaryDirectory dir;
+  auto path = (dir.path() / "nobody.sock").string();
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  EXPECT_FALSE(SocketHandover::sendFds(path, {fds[0]}));
+  close(fds[0]);
+  close(fds[1]);
+}
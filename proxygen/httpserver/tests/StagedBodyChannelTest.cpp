@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/Conv.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/GMock.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/httpserver/Mocks.h>
+#include <proxygen/httpserver/StagedBodyChannel.h>
+#include <thread>
+
+using namespace proxygen;
+using namespace testing;
+
+TEST(StagedBodyChannelTest, DrainsInOrderWithEOM) {
+  folly::EventBase evb;
+  MockRequestHandler requestHandler;
+  MockResponseHandler downstream(&requestHandler);
+
+  std::string received;
+  uint32_t bursts = 0;
+  EXPECT_CALL(downstream, sendBody(_))
+      .WillRepeatedly(Invoke([&](std::shared_ptr<folly::IOBuf> body) {
+        bursts++;
+        received += body->moveToFbString().toStdString();
+      }));
+  bool eom = false;
+  EXPECT_CALL(downstream, sendEOM()).WillOnce(Invoke([&] { eom = true; }));
+
+  auto channel = StagedBodyChannel::create(&evb, &downstream);
+
+  std::string expected;
+  std::thread producer([&] {
+    for (int i = 0; i < 50; i++) {
+      auto chunk = folly::IOBuf::copyBuffer(folly::to<std::string>(i, ";"));
+      while (!channel->sendBody(chunk)) {
+        std::this_thread::yield();
+      }
+    }
+    channel->sendEOM();
+  });
+  for (int i = 0; i < 50; i++) {
+    expected += folly::to<std::string>(i, ";");
+  }
+
+  while (!eom) {
+    evb.loopOnce();
+  }
+  producer.join();
+
+  EXPECT_EQ(received, expected);
+  // bursty draining: far fewer wakeups than chunks
+  EXPECT_LE(bursts, 50u);
+  EXPECT_GE(bursts, 1u);
+}
+
+TEST(StagedBodyChannelTest, InvalidateDiscards) {
+  folly::EventBase evb;
+  MockRequestHandler requestHandler;
+  MockResponseHandler downstream(&requestHandler);
+  EXPECT_CALL(downstream, sendBody(_)).Times(0);
+  EXPECT_CALL(downstream, sendEOM()).Times(0);
+
+  auto channel = StagedBodyChannel::create(&evb, &downstream);
+  channel->invalidate();
+
+  auto chunk = folly::IOBuf::copyBuffer("dropped");
+  EXPECT_TRUE(channel->sendBody(chunk));
+  channel->sendEOM();
+  evb.loop();
+}
+
+TEST(StagedBodyChannelTest, FullRingRejectsWithoutConsuming) {
+  folly::EventBase evb;
+  MockRequestHandler requestHandler;
+  MockResponseHandler downstream(&requestHandler);
+  EXPECT_CALL(downstream, sendBody(_)).Times(AnyNumber());
+
+  auto channel = StagedBodyChannel::create(&evb, &downstream, 2);
+  auto first = folly::IOBuf::copyBuffer("a");
+  EXPECT_TRUE(channel->sendBody(first));
+  EXPECT_EQ(first, nullptr);
+  // capacity-1 usable slots in the SPSC ring
+  auto second = folly::IOBuf::copyBuffer("b");
+  EXPECT_FALSE(channel->sendBody(second));
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(second->moveToFbString().toStdString(), "b");
+  evb.loop();
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/CapsuleCodec.h>
+
+#include <folly/io/Cursor.h>
+#include <glog/logging.h>
+
+namespace {
+
+// QUIC variable-length integers (RFC 9000 §16): 2-bit length prefix
+size_t varintSize(uint64_t value) {
+  if (value < 0x40) {
+    return 1;
+  }
+  if (value < 0x4000) {
+    return 2;
+  }
+  if (value < 0x40000000) {
+    return 4;
+  }
+  return 8;
+}
+
+void writeVarint(uint8_t* dst, uint64_t value, size_t size) {
+  for (size_t i = size; i > 0; i--) {
+    dst[i - 1] = uint8_t(value & 0xff);
+    value >>= 8;
+  }
+  dst[0] |= uint8_t((size == 1 ? 0 : size == 2 ? 1 : size == 4 ? 2 : 3) << 6);
+}
+
+// returns false when the cursor doesn't hold a complete varint
+bool readVarint(folly::io::Cursor& cursor, uint64_t& value) {
+  if (!cursor.canAdvance(1)) {
+    return false;
+  }
+  uint8_t first = *cursor.peekBytes().data();
+  size_t size = size_t(1) << (first >> 6);
+  if (!cursor.canAdvance(size)) {
+    return false;
+  }
+  value = first & 0x3f;
+  cursor.skip(1);
+  for (size_t i = 1; i < size; i++) {
+    value = (value << 8) | cursor.read<uint8_t>();
+  }
+  return true;
+}
+
+} // namespace
+
+namespace proxygen {
+
+constexpr uint64_t CapsuleCodec::kDatagramCapsuleType;
+
+void CapsuleCodec::onIngress(std::unique_ptr<folly::IOBuf> data) {
+  if (error_ || !data) {
+    return;
+  }
+  buffer_.append(std::move(data));
+  while (buffer_.front()) {
+    folly::io::Cursor cursor(buffer_.front());
+    uint64_t type = 0;
+    uint64_t length = 0;
+    if (!readVarint(cursor, type) || !readVarint(cursor, length)) {
+      return; // incomplete header; wait for more bytes
+    }
+    size_t headerSize =
+        buffer_.chainLength() - cursor.totalLength();
+    if (buffer_.chainLength() < headerSize + length) {
+      return; // incomplete value
+    }
+    buffer_.trimStart(headerSize);
+    auto value = length > 0 ? buffer_.split(length) : folly::IOBuf::create(0);
+    if (type == kDatagramCapsuleType) {
+      folly::io::Cursor valueCursor(value.get());
+      uint64_t contextId = 0;
+      if (!readVarint(valueCursor, contextId)) {
+        error_ = true;
+        callback_->onCapsuleError();
+        return;
+      }
+      // strip the context id off the front of the payload chain
+      auto contextSize = length - valueCursor.totalLength();
+      folly::IOBufQueue payload{folly::IOBufQueue::cacheChainLength()};
+      payload.append(std::move(value));
+      payload.trimStart(contextSize);
+      auto payloadBuf = payload.move();
+      if (!payloadBuf) {
+        payloadBuf = folly::IOBuf::create(0);
+      }
+      callback_->onDatagramCapsule(contextId, std::move(payloadBuf));
+    } else {
+      callback_->onUnknownCapsule(type, std::move(value));
+    }
+    if (error_) {
+      return;
+    }
+  }
+}
+
+std::unique_ptr<folly::IOBuf> CapsuleCodec::encodeDatagram(
+    uint64_t contextId, std::unique_ptr<folly::IOBuf> payload) {
+  size_t payloadLength =
+      payload ? payload->computeChainDataLength() : 0;
+  size_t contextSize = varintSize(contextId);
+  uint64_t valueLength = contextSize + payloadLength;
+  size_t typeSize = varintSize(kDatagramCapsuleType);
+  size_t lengthSize = varintSize(valueLength);
+  size_t headerSize = typeSize + lengthSize + contextSize;
+
+  uint8_t header[1 + 8 + 8];
+  size_t offset = 0;
+  writeVarint(header + offset, kDatagramCapsuleType, typeSize);
+  offset += typeSize;
+  writeVarint(header + offset, valueLength, lengthSize);
+  offset += lengthSize;
+  writeVarint(header + offset, contextId, contextSize);
+
+  if (payload && payload->headroom() >= headerSize &&
+      !payload->isSharedOne()) {
+    // steady state: the header rides the payload's own headroom
+    payload->prepend(headerSize);
+    memcpy(payload->writableData(), header, headerSize);
+    return payload;
+  }
+  auto capsule = folly::IOBuf::create(headerSize);
+  memcpy(capsule->writableTail(), header, headerSize);
+  capsule->append(headerSize);
+  if (payload) {
+    capsule->prependChain(std::move(payload));
+  }
+  return capsule;
+}
+
+} // namespace proxygen
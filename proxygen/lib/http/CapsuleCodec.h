@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <folly/io/IOBufQueue.h>
+#include <memory>
+
+namespace proxygen {
+
+/**
+ * HTTP capsule protocol framing (RFC 9297) for CONNECT-UDP style
+ * tunnels: the request stream's body is a sequence of capsules, each
+ * a QUIC-varint type, varint length, and value; UDP payloads travel
+ * in DATAGRAM capsules whose value starts with a varint context ID.
+ *
+ * The decoder is streaming and allocation-light: ingress chains are
+ * appended to an internal queue and complete capsules are split out
+ * of it - payload buffers are handed to the callback as chains
+ * referencing the original ingress buffers, never copied.  The
+ * encoder writes the capsule header into the payload's own headroom
+ * when it safely can (sessions allocate ingress/egress buffers with
+ * room to spare), so steady-state relay of a datagram allocates
+ * nothing; a headroom-less or shared payload chains one small header
+ * buffer instead.
+ *
+ * This is the capsule (stream) carriage of HTTP datagrams.  The QUIC
+ * DATAGRAM frame carriage needs transport support that the QuicSocket
+ * API this tree builds against does not expose; when it does, the
+ * same callback surface applies and only the carriage changes.
+ */
+class CapsuleCodec {
+ public:
+  static constexpr uint64_t kDatagramCapsuleType = 0x00;
+
+  class Callback {
+   public:
+    virtual ~Callback() {
+    }
+
+    /** One DATAGRAM capsule; payload references the ingress buffers. */
+    virtual void onDatagramCapsule(uint64_t contextId,
+                                   std::unique_ptr<folly::IOBuf> payload) = 0;
+
+    /** Unknown capsule types are skipped per RFC; observable here. */
+    virtual void onUnknownCapsule(uint64_t /*type*/,
+                                  std::unique_ptr<folly::IOBuf> /*value*/) {
+    }
+
+    /** Malformed framing; the tunnel must be torn down. */
+    virtual void onCapsuleError() = 0;
+  };
+
+  explicit CapsuleCodec(Callback* callback) : callback_(callback) {
+  }
+
+  /** Feed tunnel-stream body bytes; fires callbacks for each capsule. */
+  void onIngress(std::unique_ptr<folly::IOBuf> data);
+
+  /**
+   * Frame a payload as a DATAGRAM capsule, preferring the payload's
+   * own headroom for the header.
+   */
+  static std::unique_ptr<folly::IOBuf> encodeDatagram(
+      uint64_t contextId, std::unique_ptr<folly::IOBuf> payload);
+
+  bool hasError() const {
+    return error_;
+  }
+
+ private:
+  Callback* callback_;
+  folly::IOBufQueue buffer_{folly::IOBufQueue::cacheChainLength()};
+  bool error_{false};
+};
+
+} // namespace proxygen
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/ConnectUdpRelay.h>
+
+#include <glog/logging.h>
+
+namespace proxygen {
+
+constexpr size_t ConnectUdpRelay::kCapsuleHeadroom;
+constexpr size_t ConnectUdpRelay::kMaxDatagramSize;
+
+ConnectUdpRelay::ConnectUdpRelay(folly::EventBase* evb,
+                                 folly::SocketAddress target)
+    : target_(std::move(target)), socket_(evb) {
+}
+
+ConnectUdpRelay::~ConnectUdpRelay() {
+}
+
+bool ConnectUdpRelay::start() {
+  try {
+    socket_.bind(folly::SocketAddress("::", 0));
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "connect-udp relay bind failed: " << ex.what();
+    return false;
+  }
+  socket_.resumeRead(this);
+  return true;
+}
+
+void ConnectUdpRelay::registerContextId(uint64_t contextId) {
+  contextIds_.insert(contextId);
+}
+
+void ConnectUdpRelay::onBody(std::unique_ptr<folly::IOBuf> chain) noexcept {
+  capsuleCodec_.onIngress(std::move(chain));
+}
+
+void ConnectUdpRelay::onDatagramCapsule(
+    uint64_t contextId, std::unique_ptr<folly::IOBuf> payload) {
+  if (contextIds_.count(contextId) == 0) {
+    // unknown context: drop, per RFC 9298
+    droppedUnknownContext_++;
+    return;
+  }
+  datagramsToTarget_++;
+  // payload chains reference session ingress buffers; the kernel copy
+  // in write() is the only copy on this path
+  socket_.write(target_, payload);
+}
+
+void ConnectUdpRelay::onCapsuleError() {
+  VLOG(2) << "malformed capsule stream; closing tunnel";
+  closeTunnel();
+}
+
+void ConnectUdpRelay::getReadBuffer(void** buf, size_t* len) noexcept {
+  if (!readBuffer_) {
+    // pooled slab with capsule headroom reserved up front, so the
+    // header write below needs no second buffer
+    readBuffer_ = ReadBufferPool::obtain(kCapsuleHeadroom + kMaxDatagramSize);
+    readBuffer_->advance(kCapsuleHeadroom);
+  }
+  *buf = readBuffer_->writableTail();
+  *len = std::min<size_t>(readBuffer_->tailroom(), kMaxDatagramSize);
+}
+
+void ConnectUdpRelay::onDataAvailable(const folly::SocketAddress& /*client*/,
+                                      size_t len,
+                                      bool truncated) noexcept {
+  if (truncated || !txn_ || tunnelEgressPaused_) {
+    // oversized or unpushable datagrams are dropped, never queued:
+    // datagram semantics prefer loss to unbounded buffering
+    return;
+  }
+  auto payload = std::move(readBuffer_);
+  payload->append(len);
+  datagramsToTunnel_++;
+  txn_->sendBody(
+      CapsuleCodec::encodeDatagram(0 /* default context */,
+                                   std::move(payload)));
+}
+
+void ConnectUdpRelay::onReadError(
+    const folly::AsyncSocketException& ex) noexcept {
+  LOG(ERROR) << "connect-udp relay socket error: " << ex.what();
+  closeTunnel();
+}
+
+void ConnectUdpRelay::onReadClosed() noexcept {
+}
+
+void ConnectUdpRelay::onEOM() noexcept {
+  closeTunnel();
+}
+
+void ConnectUdpRelay::onError(const HTTPException& /*error*/) noexcept {
+  socket_.pauseRead();
+}
+
+void ConnectUdpRelay::onEgressPaused() noexcept {
+  // tunnel backpressure: drop target->tunnel datagrams instead of
+  // buffering them (see onDataAvailable)
+  tunnelEgressPaused_ = true;
+}
+
+void ConnectUdpRelay::onEgressResumed() noexcept {
+  tunnelEgressPaused_ = false;
+}
+
+void ConnectUdpRelay::closeTunnel() {
+  socket_.pauseRead();
+  if (txn_ && !txn_->isEgressEOMSeen()) {
+    txn_->sendEOM();
+  }
+}
+
+void ConnectUdpRelay::detachTransaction() noexcept {
+  txn_ = nullptr;
+  socket_.pauseRead();
+  delete this;
+}
+
+} // namespace proxygen
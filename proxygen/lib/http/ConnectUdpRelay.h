@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/SocketAddress.h>
+#include <set>
+#include <folly/io/async/AsyncUDPSocket.h>
+#include <proxygen/lib/http/CapsuleCodec.h>
+#include <proxygen/lib/http/session/HTTPTransaction.h>
+#include <proxygen/lib/utils/ReadBufferPool.h>
+
+namespace proxygen {
+
+/**
+ * CONNECT-UDP relay (RFC 9298 over the RFC 9297 capsule protocol):
+ * bridges one tunnel transaction and one UDP socket, both owned by
+ * the same event base.
+ *
+ * Tunnel-to-target: DATAGRAM capsules parsed off the transaction's
+ * body are forwarded to the target address; the payload chain
+ * references the session's ingress buffers, so the socket write is
+ * the only copy (into the kernel).  Target-to-tunnel: received
+ * datagrams land in pooled read buffers (ReadBufferPool) sized with
+ * capsule headroom, the header is written into that headroom, and the
+ * chain goes out through sendBody - steady-state forwarding allocates
+ * nothing per datagram in either direction.
+ *
+ * Context IDs: zero (raw UDP payload) is registered implicitly;
+ * registerContextId admits extension contexts.  Capsules carrying
+ * unknown context IDs are dropped, per RFC.
+ *
+ * Attach as the transaction handler for the CONNECT-UDP stream after
+ * responding 2xx; the relay tears both halves down when either side
+ * closes, and self-deletes on detach like other transaction handlers.
+ */
+class ConnectUdpRelay
+    : public HTTPTransactionHandler
+    , private CapsuleCodec::Callback
+    , private folly::AsyncUDPSocket::ReadCallback {
+ public:
+  /**
+   * @param target  where tunnel payloads are sent (the authority the
+   *                CONNECT-UDP request named, already resolved)
+   */
+  ConnectUdpRelay(folly::EventBase* evb, folly::SocketAddress target);
+  ~ConnectUdpRelay() override;
+
+  /** Bind and start relaying; returns false when the socket fails. */
+  bool start();
+
+  /** Admit datagrams carrying this context ID (0 is always admitted). */
+  void registerContextId(uint64_t contextId);
+
+  uint64_t getDatagramsToTarget() const {
+    return datagramsToTarget_;
+  }
+  uint64_t getDatagramsToTunnel() const {
+    return datagramsToTunnel_;
+  }
+  uint64_t getDroppedUnknownContext() const {
+    return droppedUnknownContext_;
+  }
+
+  // HTTPTransaction::Handler
+  void setTransaction(HTTPTransaction* txn) noexcept override {
+    txn_ = txn;
+  }
+  void detachTransaction() noexcept override;
+  void onHeadersComplete(std::unique_ptr<HTTPMessage>) noexcept override {
+  }
+  void onBody(std::unique_ptr<folly::IOBuf> chain) noexcept override;
+  void onChunkHeader(size_t) noexcept override {
+  }
+  void onChunkComplete() noexcept override {
+  }
+  void onTrailers(std::unique_ptr<HTTPHeaders>) noexcept override {
+  }
+  void onEOM() noexcept override;
+  void onUpgrade(UpgradeProtocol) noexcept override {
+  }
+  void onError(const HTTPException& error) noexcept override;
+  void onEgressPaused() noexcept override;
+  void onEgressResumed() noexcept override;
+
+ private:
+  // CapsuleCodec::Callback
+  void onDatagramCapsule(uint64_t contextId,
+                         std::unique_ptr<folly::IOBuf> payload) override;
+  void onCapsuleError() override;
+
+  // AsyncUDPSocket::ReadCallback
+  void getReadBuffer(void** buf, size_t* len) noexcept override;
+  void onDataAvailable(const folly::SocketAddress& client,
+                       size_t len,
+                       bool truncated) noexcept override;
+  void onReadError(const folly::AsyncSocketException&) noexcept override;
+  void onReadClosed() noexcept override;
+
+  void closeTunnel();
+
+  // room reserved ahead of every read buffer for the capsule header:
+  // max varint type + length + context id
+  static constexpr size_t kCapsuleHeadroom = 1 + 8 + 8;
+  static constexpr size_t kMaxDatagramSize = 65535;
+
+  folly::SocketAddress target_;
+  folly::AsyncUDPSocket socket_;
+  HTTPTransaction* txn_{nullptr};
+  CapsuleCodec capsuleCodec_{this};
+  // the buffer currently lent to the socket for the next datagram
+  std::unique_ptr<folly::IOBuf> readBuffer_;
+  std::set<uint64_t> contextIds_{0};
+  bool tunnelEgressPaused_{false};
+  uint64_t datagramsToTarget_{0};
+  uint64_t datagramsToTunnel_{0};
+  uint64_t droppedUnknownContext_{0};
+};
+
+} // namespace proxygen
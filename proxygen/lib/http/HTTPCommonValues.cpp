@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/HTTPCommonValues.h>
+
+#include <folly/Indestructible.h>
+#include <folly/container/F14Map.h>
+#include <vector>
+
+namespace {
+
+// The high-frequency header values from production traffic samples.
+// Ordering is irrelevant; keep additions alphabetical-ish per group.
+const char* kCommonValues[] = {
+    // connection / transport
+    "keep-alive",
+    "close",
+    "Upgrade",
+    "websocket",
+    "chunked",
+    "trailers",
+
+    // encodings
+    "gzip",
+    "gzip, deflate",
+    "gzip, deflate, br",
+    "gzip, deflate, br, zstd",
+    "br",
+    "deflate",
+    "zstd",
+    "identity",
+
+    // methods / schemes / common paths
+    "GET",
+    "POST",
+    "http",
+    "https",
+    "/",
+
+    // status-ish
+    "200",
+    "204",
+    "206",
+    "301",
+    "302",
+    "304",
+    "400",
+    "403",
+    "404",
+    "500",
+    "503",
+
+    // content types
+    "text/html",
+    "text/html; charset=utf-8",
+    "text/plain",
+    "text/plain; charset=utf-8",
+    "text/css",
+    "text/javascript",
+    "application/json",
+    "application/json; charset=utf-8",
+    "application/javascript",
+    "application/x-www-form-urlencoded",
+    "application/octet-stream",
+    "application/grpc",
+    "image/png",
+    "image/jpeg",
+    "image/gif",
+    "image/webp",
+    "image/svg+xml",
+    "video/mp4",
+    "multipart/form-data",
+
+    // caching
+    "no-cache",
+    "no-store",
+    "no-cache, no-store, must-revalidate",
+    "max-age=0",
+    "public, max-age=31536000",
+    "private",
+    "*",
+
+    // languages / misc
+    "en-US,en;q=0.9",
+    "en-US",
+    "utf-8",
+    "bytes",
+    "nosniff",
+    "SAMEORIGIN",
+    "DENY",
+    "1; mode=block",
+    "OK",
+    "0",
+};
+
+using ValueMap = folly::F14FastMap<folly::StringPiece, const std::string*>;
+
+const ValueMap& valueMap() {
+  static const folly::Indestructible<ValueMap> map([] {
+    static const folly::Indestructible<std::vector<std::string>> storage([] {
+      std::vector<std::string> values;
+      values.reserve(sizeof(kCommonValues) / sizeof(kCommonValues[0]));
+      for (auto value : kCommonValues) {
+        values.emplace_back(value);
+      }
+      return values;
+    }());
+    ValueMap result;
+    result.reserve(storage->size());
+    for (const auto& value : *storage) {
+      result.emplace(folly::StringPiece(value), &value);
+    }
+    return result;
+  }());
+  return *map;
+}
+
+} // anonymous namespace
+
+namespace proxygen {
+
+const std::string* HTTPCommonValues::getPointerToCommonValue(
+    folly::StringPiece value) {
+  const auto& map = valueMap();
+  auto it = map.find(value);
+  if (it == map.end()) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+size_t HTTPCommonValues::numValues() {
+  return valueMap().size();
+}
+
+} // namespace proxygen
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <string>
+
+namespace proxygen {
+
+/**
+ * Interned storage for the header values that dominate real traffic
+ * ("gzip, deflate", "keep-alive", "text/html; charset=utf-8", ...).
+ * Code that keeps values as const std::string* can point at the shared
+ * static instead of allocating a copy per message.
+ *
+ * This is a companion to HTTPCommonHeaders: names are perfect-hashed
+ * into codes there because they need a dense enum; values need no
+ * enum, so a flat hash lookup over the interned set suffices.
+ */
+class HTTPCommonValues {
+ public:
+  /**
+   * Returns a pointer to the process-lifetime interned string equal to
+   * value, or nullptr if the value isn't in the common set. The lookup
+   * is one hash probe; only call it where a hit saves an allocation.
+   */
+  static const std::string* getPointerToCommonValue(folly::StringPiece value);
+
+  /**
+   * Number of interned values, for tests and tooling.
+   */
+  static size_t numValues();
+};
+
+} // namespace proxygen
@@ -39,6 +39,9 @@ HTTPConnector::~HTTPConnector() {
 }
 
 void HTTPConnector::reset() {
+  if (racing_) {
+    cancelRace();
+  }
   if (socket_) {
     auto cb = cb_;
     cb_ = nullptr;
@@ -47,6 +50,113 @@ void HTTPConnector::reset() {
   }
 }
 
+void HTTPConnector::cancelRace() {
+  racing_ = false;
+  staggerTimeout_.reset();
+  primaryAttempt_.socket.reset();
+  fallbackAttempt_.socket.reset();
+  primaryAttempt_ = RaceAttempt();
+  fallbackAttempt_ = RaceAttempt();
+}
+
+void HTTPConnector::RaceAttempt::connectSuccess() noexcept {
+  parent->raceAttemptSuccess(*this);
+}
+
+void HTTPConnector::RaceAttempt::connectErr(
+    const folly::AsyncSocketException& ex) noexcept {
+  parent->raceAttemptError(*this, ex);
+}
+
+void HTTPConnector::connectHappyEyeballs(
+    EventBase* eventBase,
+    const folly::SocketAddress& primaryAddr,
+    const folly::SocketAddress& fallbackAddr,
+    std::chrono::milliseconds timeoutMs,
+    std::chrono::milliseconds staggerDelay,
+    const AsyncSocket::OptionMap& socketOptions,
+    const folly::SocketAddress& bindAddr) {
+
+  DCHECK(!isBusy());
+  transportInfo_ = wangle::TransportInfo();
+  transportInfo_.secure = false;
+  connectStart_ = getCurrentTime();
+  racing_ = true;
+  raceEventBase_ = eventBase;
+  fallbackAddr_ = fallbackAddr;
+  raceTimeout_ = timeoutMs;
+  raceSocketOptions_ = socketOptions;
+  raceBindAddr_ = bindAddr;
+
+  primaryAttempt_.parent = this;
+  primaryAttempt_.primary = true;
+  primaryAttempt_.started = true;
+  fallbackAttempt_.parent = this;
+  fallbackAttempt_.primary = false;
+
+  auto sock = new AsyncSocket(eventBase);
+  primaryAttempt_.socket.reset(sock);
+  sock->connect(&primaryAttempt_, primaryAddr, timeoutMs.count(),
+                socketOptions, bindAddr);
+
+  // the race may already be over (synchronous failure of both legs)
+  if (racing_) {
+    staggerTimeout_ = folly::AsyncTimeout::make(
+        *eventBase, [this]() noexcept { startFallbackAttempt(); });
+    staggerTimeout_->scheduleTimeout(staggerDelay);
+  }
+}
+
+void HTTPConnector::startFallbackAttempt() {
+  if (!racing_ || fallbackAttempt_.started) {
+    return;
+  }
+  fallbackAttempt_.started = true;
+  auto sock = new AsyncSocket(raceEventBase_);
+  fallbackAttempt_.socket.reset(sock);
+  sock->connect(&fallbackAttempt_, fallbackAddr_, raceTimeout_.count(),
+                raceSocketOptions_, raceBindAddr_);
+}
+
+void HTTPConnector::raceAttemptSuccess(RaceAttempt& attempt) {
+  if (!racing_) {
+    return;
+  }
+  racing_ = false;
+  staggerTimeout_.reset();
+  // adopt the winner into the regular codec setup path and cancel the
+  // loser; the loser's error callback is ignored since racing_ is off
+  socket_ = std::move(attempt.socket);
+  auto& loser = attempt.primary ? fallbackAttempt_ : primaryAttempt_;
+  loser.socket.reset();
+  primaryAttempt_ = RaceAttempt();
+  fallbackAttempt_ = RaceAttempt();
+  connectSuccess();
+}
+
+void HTTPConnector::raceAttemptError(RaceAttempt& attempt,
+                                     const folly::AsyncSocketException& ex) {
+  if (!racing_) {
+    return;
+  }
+  attempt.failed = true;
+  if (attempt.primary && !fallbackAttempt_.started) {
+    // don't wait out the stagger once the primary has lost
+    staggerTimeout_.reset();
+    startFallbackAttempt();
+    return;
+  }
+  auto& other = attempt.primary ? fallbackAttempt_ : primaryAttempt_;
+  if (other.started && !other.failed) {
+    // still a live leg; wait for it
+    return;
+  }
+  cancelRace();
+  if (cb_) {
+    cb_->connectError(ex);
+  }
+}
+
 void HTTPConnector::setPlaintextProtocol(const std::string& plaintextProto) {
   plaintextProtocol_ = plaintextProto;
 }
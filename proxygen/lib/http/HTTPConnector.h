@@ -131,6 +131,25 @@ class HTTPConnector:
     folly::AsyncSocket::anyAddress(),
     const std::string& serverName = empty_string);
 
+  /**
+   * Race two addresses RFC 8305 (happy eyeballs) style for a plaintext
+   * connection: the primary attempt (typically v6) starts immediately,
+   * the fallback (typically v4) after staggerDelay or as soon as the
+   * primary fails. The winner is adopted into the normal codec setup
+   * path and the loser is canceled; connectError fires only once both
+   * attempts have failed.
+   */
+  void connectHappyEyeballs(
+    folly::EventBase* eventBase,
+    const folly::SocketAddress& primaryAddr,
+    const folly::SocketAddress& fallbackAddr,
+    std::chrono::milliseconds timeoutMs = std::chrono::milliseconds(0),
+    std::chrono::milliseconds staggerDelay = std::chrono::milliseconds(250),
+    const folly::AsyncSocket::OptionMap& socketOptions =
+      folly::AsyncSocket::emptyOptionMap,
+    const folly::SocketAddress& bindAddr =
+    folly::AsyncSocket::anyAddress());
+
   /**
    * @returns the number of milliseconds since connecting began, or
    * zero if connecting hasn't started yet.
@@ -141,7 +160,7 @@ class HTTPConnector:
    * @returns true iff this connector is busy setting up a connection. If
    * this is false, it is safe to call connect() or connectSSL() on it again.
    */
-  bool isBusy() const { return socket_.get(); }
+  bool isBusy() const { return socket_.get() != nullptr || racing_; }
 
   void setHTTPCodecFactory(std::unique_ptr<DefaultHTTPCodecFactory> factory) {
     httpCodecFactory_ = std::move(factory);
@@ -153,6 +172,26 @@ class HTTPConnector:
     noexcept override;
 
 
+  // One leg of a happy-eyeballs race; forwards its socket callbacks to
+  // the parent connector.
+  class RaceAttempt : public folly::AsyncSocket::ConnectCallback {
+   public:
+    void connectSuccess() noexcept override;
+    void connectErr(const folly::AsyncSocketException& ex) noexcept override;
+
+    HTTPConnector* parent{nullptr};
+    bool primary{false};
+    bool started{false};
+    bool failed{false};
+    folly::AsyncTransportWrapper::UniquePtr socket;
+  };
+
+  void startFallbackAttempt();
+  void raceAttemptSuccess(RaceAttempt& attempt);
+  void raceAttemptError(RaceAttempt& attempt,
+                        const folly::AsyncSocketException& ex);
+  void cancelRace();
+
   Callback* cb_;
   WheelTimerInstance timeout_;
   folly::AsyncTransportWrapper::UniquePtr socket_;
@@ -160,6 +199,17 @@ class HTTPConnector:
   std::string plaintextProtocol_;
   TimePoint connectStart_;
   std::unique_ptr<DefaultHTTPCodecFactory> httpCodecFactory_;
+
+  // happy-eyeballs race state
+  bool racing_{false};
+  RaceAttempt primaryAttempt_;
+  RaceAttempt fallbackAttempt_;
+  std::unique_ptr<folly::AsyncTimeout> staggerTimeout_;
+  folly::EventBase* raceEventBase_{nullptr};
+  folly::SocketAddress fallbackAddr_;
+  std::chrono::milliseconds raceTimeout_{0};
+  folly::AsyncSocket::OptionMap raceSocketOptions_;
+  folly::SocketAddress raceBindAddr_;
 };
 
 }
@@ -31,6 +31,13 @@ void HTTPConnectorWithFizz::connectFizz(
   auto fizzClient = new AsyncFizzClient(eventBase, context);
   socket_.reset(fizzClient);
 
+  if (!pskIdentity && sni) {
+    // key resumption state by origin, so a per-origin PskCache (see
+    // OriginPskCache) resumes on reconnect without callers plumbing an
+    // explicit identity
+    pskIdentity = sni;
+  }
+
   connectStart_ = getCurrentTime();
 
   fizzClient->connect(connectAddr,
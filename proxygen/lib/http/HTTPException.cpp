@@ -21,9 +21,33 @@ HTTPException::HTTPException(Direction dir, const char* msg)
   : Exception(msg),
     dir_(dir) {}
 
+HTTPException::HTTPException(Direction dir,
+                             const HTTPErrorDescriptor& descriptor)
+  : Exception(LazyMessageTag{}),
+    dir_(dir),
+    descriptor_(descriptor) {
+  setProxygenError(descriptor.error);
+  httpStatusCode_ = descriptor.httpStatusCode;
+  if (descriptor.hasCodecStatusCode) {
+    codecStatusCode_ = descriptor.codecStatusCode;
+  }
+}
+
+std::string HTTPException::materializeMessage() const {
+  std::string message = getErrorString(descriptor_.error);
+  if (descriptor_.streamID != 0) {
+    folly::toAppend(" on transaction id: ", descriptor_.streamID, &message);
+  }
+  if (descriptor_.detailLength > 0) {
+    folly::toAppend(". ", descriptor_.getDetail(), &message);
+  }
+  return message;
+}
+
 HTTPException::HTTPException(const HTTPException& ex) :
   Exception(static_cast<const Exception&>(ex)),
   dir_(ex.dir_),
+  descriptor_(ex.descriptor_),
   httpStatusCode_(ex.httpStatusCode_),
   codecStatusCode_(ex.codecStatusCode_),
   errno_(ex.errno_) {
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <folly/Memory.h>
 #include <folly/io/IOBufQueue.h>
 #include <proxygen/lib/http/HTTPMessage.h>
@@ -16,6 +18,36 @@
 
 namespace proxygen {
 
+/**
+ * POD error descriptor for the hot codec/session/transaction error
+ * paths.  Carries everything an error needs - proxygen error, codec
+ * status, stream id, and a fixed inline detail buffer (truncating) -
+ * with no heap allocation; construction and copies are memcpys.  An
+ * HTTPException built from a descriptor materializes its message
+ * string lazily, on the first what(), so a malformed-traffic flood
+ * that errors thousands of streams nobody logs allocates nothing on
+ * the error path.
+ */
+struct HTTPErrorDescriptor {
+  ProxygenError error{kErrorNone};
+  ErrorCode codecStatusCode{ErrorCode::NO_ERROR};
+  bool hasCodecStatusCode{false};
+  uint32_t httpStatusCode{0};
+  uint64_t streamID{0};
+  uint8_t detailLength{0};
+  char detail[64] = {};
+
+  /** Truncating copy into the inline buffer; never allocates. */
+  void setDetail(folly::StringPiece d) {
+    detailLength = uint8_t(std::min(d.size(), sizeof(detail)));
+    memcpy(detail, d.data(), detailLength);
+  }
+
+  folly::StringPiece getDetail() const {
+    return folly::StringPiece(detail, detailLength);
+  }
+};
+
 /**
  * This class encapsulates the various errors that can occur on an
  * http session. Errors can occur at various levels: the connection can
@@ -42,6 +74,14 @@ class HTTPException : public proxygen::Exception {
 
   HTTPException(Direction dir, const char* msg);
 
+  /**
+   * Descriptor-based construction: copies the POD and defers the
+   * message string until something actually logs it (what() or
+   * describe()).  The descriptor's error, codec status and http
+   * status are applied to the usual accessors.
+   */
+  HTTPException(Direction dir, const HTTPErrorDescriptor& descriptor);
+
   HTTPException(const HTTPException& ex);
 
   /**
@@ -117,9 +157,14 @@ class HTTPException : public proxygen::Exception {
     return std::move(partialMsg_);
   }
 
+ protected:
+  std::string materializeMessage() const override;
+
  private:
 
   Direction dir_;
+  // set when constructed from a descriptor; source for the lazy message
+  HTTPErrorDescriptor descriptor_;
   uint32_t httpStatusCode_{0};
   folly::Optional<ErrorCode> codecStatusCode_;
   uint32_t errno_{0};
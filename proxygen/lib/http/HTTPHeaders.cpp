@@ -9,6 +9,8 @@
 #define PROXYGEN_HTTPHEADERS_IMPL
 #include <proxygen/lib/http/HTTPHeaders.h>
 
+#include <proxygen/lib/http/HeaderInternTable.h>
+
 
 #include <glog/logging.h>
 
@@ -49,7 +51,7 @@ void HTTPHeaders::add(folly::StringPiece name, folly::StringPiece value) {
   const HTTPHeaderCode code = HTTPCommonHeaders::hash(name.data(), name.size());
   emplace_back(code,
                ((code == HTTP_HEADER_OTHER)
-                ? new std::string(name.data(), name.size())
+                ? HeaderInternTable::internOrAllocate(name)
                 : (std::string*)HTTPCommonHeaders::getPointerToName(code)),
                value);
 }
@@ -72,7 +74,7 @@ void HTTPHeaders::rawAdd(const std::string& name, const std::string& value) {
 void HTTPHeaders::addFromCodec(const char* str, size_t len, string&& value) {
   const HTTPHeaderCode code = HTTPCommonHeaders::hash(str, len);
   auto namePtr = (code == HTTP_HEADER_OTHER)
-    ? new string(str, len)
+    ? HeaderInternTable::internOrAllocate(folly::StringPiece(str, len))
     : (std::string*)HTTPCommonHeaders::getPointerToName(code);
 
   emplace_back(code, namePtr, std::move(value));
@@ -90,10 +92,14 @@ bool HTTPHeaders::exists(folly::StringPiece name) const {
 }
 
 bool HTTPHeaders::exists(HTTPHeaderCode code) const {
-  return length_ > 0 && memchr((void*)codes(), code, length_) != nullptr;
+  return length_ > 0 && mayContain(code) &&
+      memchr((void*)codes(), code, length_) != nullptr;
 }
 
 size_t HTTPHeaders::getNumberOfValues(HTTPHeaderCode code) const {
+  if (!mayContain(code)) {
+    return 0;
+  }
   size_t count = 0;
   ITERATE_OVER_CODES(code, {
       (void)pos;
@@ -119,8 +125,9 @@ bool HTTPHeaders::remove(folly::StringPiece name) {
   } else {
     bool removed = false;
     ITERATE_OVER_STRINGS(name, {
-      delete names()[pos];
+      HeaderInternTable::releaseName(names()[pos]);
       codes()[pos] = HTTP_HEADER_NONE;
+      ++mutationCount_;
       removed = true;
       ++deletedCount_;
     });
@@ -129,9 +136,13 @@ bool HTTPHeaders::remove(folly::StringPiece name) {
 }
 
 bool HTTPHeaders::remove(HTTPHeaderCode code) {
+  if (!mayContain(code)) {
+    return false;
+  }
   bool removed = false;
   ITERATE_OVER_CODES(code, {
     codes()[pos] = HTTP_HEADER_NONE;
+    ++mutationCount_;
     removed = true;
     ++deletedCount_;
   });
@@ -145,8 +156,9 @@ bool HTTPHeaders::removeAllVersions(HTTPHeaderCode code,
     removed = remove(code);
   }
   ITERATE_OVER_STRINGS_ALL_VERSION(name, {
-    delete names()[pos];
+    HeaderInternTable::releaseName(names()[pos]);
     codes()[pos] = HTTP_HEADER_NONE;
+    ++mutationCount_;
     removed = true;
     ++deletedCount_;
   });
@@ -155,7 +167,7 @@ bool HTTPHeaders::removeAllVersions(HTTPHeaderCode code,
 
 void HTTPHeaders::disposeOfHeaderNames() {
   ITERATE_OVER_CODES(HTTP_HEADER_OTHER, {
-      delete names()[pos];
+      HeaderInternTable::releaseName(names()[pos]);
     });
 }
 
@@ -165,7 +177,7 @@ void HTTPHeaders::destroy() {
   auto v = values();
   for (size_t i = 0; i < length_; ++i) {
     if (c[i] == HTTP_HEADER_OTHER) {
-      delete n[i];
+      HeaderInternTable::releaseName(n[i]);
     }
     auto p = v + i;
     p->~string();
@@ -187,10 +199,12 @@ HTTPHeaders::HTTPHeaders(HTTPHeaders&& hdrs) noexcept :
   memory_(std::move(hdrs.memory_)),
   length_(hdrs.length_),
   capacity_(hdrs.capacity_),
-  deletedCount_(hdrs.deletedCount_) {
+  deletedCount_(hdrs.deletedCount_),
+  codePresence_(hdrs.codePresence_) {
   hdrs.length_ = 0;
   hdrs.capacity_ = 0;
   hdrs.deletedCount_ = 0;
+  hdrs.codePresence_.fill(0);
 }
 
 void HTTPHeaders::copyFrom(const HTTPHeaders& other) {
@@ -198,13 +212,14 @@ void HTTPHeaders::copyFrom(const HTTPHeaders& other) {
   memcpy(codes(), other.codes(), other.length_);
   for (size_t i = 0; i < other.length_; i++) {
     if (codes()[i] == HTTP_HEADER_OTHER) {
-      names()[i] = new std::string(*other.names()[i]);
+      names()[i] = HeaderInternTable::copyName(other.names()[i]);
     } else {
       names()[i] = other.names()[i];
     }
     new (values() + i) std::string(other.values()[i]);
   }
   length_ = other.length_;
+  codePresence_ = other.codePresence_;
 }
 
 HTTPHeaders& HTTPHeaders::operator= (const HTTPHeaders& hdrs) {
@@ -224,15 +239,19 @@ HTTPHeaders& HTTPHeaders::operator= (HTTPHeaders&& hdrs) {
     hdrs.length_ = 0;
     deletedCount_ = hdrs.deletedCount_;
     hdrs.deletedCount_ = 0;
+    codePresence_ = hdrs.codePresence_;
+    hdrs.codePresence_.fill(0);
   }
 
   return *this;
 }
 
 void HTTPHeaders::removeAll() {
+  ++mutationCount_;
   destroy();
   length_ = 0;
   deletedCount_ = 0;
+  codePresence_.fill(0);
 }
 
 size_t HTTPHeaders::size() const {
@@ -251,6 +270,7 @@ HTTPHeaders::transferHeaderIfPresent(folly::StringPiece name,
                                    names()[pos],
                                    std::move(values()[pos]));
       codes()[pos] = HTTP_HEADER_NONE;
+      ++mutationCount_;
       transferred = true;
       ++deletedCount_;
     });
@@ -260,6 +280,7 @@ HTTPHeaders::transferHeaderIfPresent(folly::StringPiece name,
                                    names()[pos],
                                    std::move(values()[pos]));
       codes()[pos] = HTTP_HEADER_NONE;
+      ++mutationCount_;
       transferred = true;
       ++deletedCount_;
     });
@@ -321,6 +342,7 @@ HTTPHeaders::stripPerHopHeaders(HTTPHeaders& strippedHeaders) {
                                    names()[i],
                                    std::move(values()[i]));
       codes()[i] = HTTP_HEADER_NONE;
+      ++mutationCount_;
       ++deletedCount_;
       VLOG(5) << "Stripped hop-by-hop header " << *names()[i];
     }
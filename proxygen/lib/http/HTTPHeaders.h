@@ -12,9 +12,11 @@
 #include <folly/Range.h>
 #include <folly/String.h>
 #include <proxygen/lib/http/HTTPCommonHeaders.h>
+#include <proxygen/lib/http/HeaderInternTable.h>
 #include <proxygen/lib/utils/Export.h>
 #include <proxygen/lib/utils/UtilInl.h>
 
+#include <array>
 #include <bitset>
 #include <cstring>
 #include <string>
@@ -268,6 +270,14 @@ class HTTPHeaders {
    */
   void removeAll();
 
+  /**
+   * Bumped on every mutation; typed-value caches derived from these
+   * headers (see HTTPMessage) revalidate against it.
+   */
+  uint32_t getMutationCount() const {
+    return mutationCount_;
+  }
+
   /**
    * Remove per-hop-headers and headers named in the Connection header
    * and place the value in strippedHeaders
@@ -292,10 +302,29 @@ class HTTPHeaders {
 
  private:
   std::unique_ptr<uint8_t[]> memory_;
+  uint32_t mutationCount_{0};
   size_t length_{0};
   size_t capacity_{0};
   size_t deletedCount_;
 
+  /**
+   * Presence bitmap over header codes, maintained on add. A clear bit
+   * proves the code is absent so code-keyed lookups skip the scan
+   * entirely; removals leave bits set (the scan then confirms absence),
+   * which keeps maintenance to a single OR on the add path.
+   */
+  std::array<uint64_t, 4> codePresence_{{0, 0, 0, 0}};
+
+  bool mayContain(HTTPHeaderCode code) const {
+    const auto c = static_cast<uint8_t>(code);
+    return codePresence_[c >> 6] & (1ULL << (c & 63));
+  }
+
+  void notePresence(HTTPHeaderCode code) {
+    const auto c = static_cast<uint8_t>(code);
+    codePresence_[c >> 6] |= (1ULL << (c & 63));
+  }
+
   void copyFrom(const HTTPHeaders& hdrs);
 
   HTTPHeaderCode* codes() const {
@@ -405,6 +434,8 @@ class HTTPHeaders {
   template <typename T>
   void emplace_back_impl(HTTPHeaderCode code, std::string* name, T&& value) {
     ensure(length_ + 1);
+    notePresence(code);
+    ++mutationCount_;
     codes()[length_] = code;
     names()[length_] = name;
     std::string* p = values() + length_++;
@@ -425,7 +456,7 @@ void HTTPHeaders::add(folly::StringPiece name, T&& value) {
   assert(name.size());
   const HTTPHeaderCode code = HTTPCommonHeaders::hash(name.data(), name.size());
   auto namePtr = ((code == HTTP_HEADER_OTHER)
-                  ? new std::string(name.data(), name.size())
+                  ? HeaderInternTable::internOrAllocate(name)
                   : (std::string*)HTTPCommonHeaders::getPointerToName(code));
   emplace_back(code, namePtr, std::forward<T>(value));
 }
@@ -509,6 +540,9 @@ bool HTTPHeaders::forEachValueOfHeader(folly::StringPiece name,
 template <typename LAMBDA> // const string & -> bool
 bool HTTPHeaders::forEachValueOfHeader(HTTPHeaderCode code,
                                        LAMBDA func) const {
+  if (!mayContain(code)) {
+    return false;
+  }
   ITERATE_OVER_CODES(code, {
     if (func(values()[pos])) {
       return true;
@@ -546,7 +580,7 @@ bool HTTPHeaders::removeByPredicate(LAMBDA func) {
     }
 
     if (c[i] == HTTP_HEADER_OTHER) {
-      delete n[i];
+      HeaderInternTable::releaseName(n[i]);
       n[i] = nullptr;
     }
 
@@ -7,6 +7,8 @@
  */
 
 #include <proxygen/lib/http/HTTPMessage.h>
+#include <proxygen/lib/http/RFC2616.h>
+#include <proxygen/lib/utils/UtilInl.h>
 
 #include <boost/algorithm/string.hpp>
 #include <folly/Format.h>
@@ -65,7 +67,7 @@ HTTPMessage::HTTPMessage() :
     fields_(),
     version_(1,0),
     sslVersion_(0), sslCipher_(nullptr), protoStr_(nullptr), pri_(0),
-    parsedCookies_(false), parsedQueryParams_(false),
+    parsedQueryParams_(false),
     chunked_(false), upgraded_(false), wantsKeepalive_(true),
     trailersAllowed_(false), secure_(false), partiallyReliable_(false),
     upgradeWebsocket_(HTTPMessage::WebSocketUpgrade::NONE) {
@@ -83,7 +85,6 @@ HTTPMessage::HTTPMessage(const HTTPMessage& message) :
     localIP_(message.localIP_),
     versionStr_(message.versionStr_),
     fields_(message.fields_),
-    cookies_(message.cookies_),
     queryParams_(message.queryParams_),
     version_(message.version_),
     headers_(message.headers_),
@@ -92,7 +93,6 @@ HTTPMessage::HTTPMessage(const HTTPMessage& message) :
     protoStr_(message.protoStr_),
     pri_(message.pri_),
     h2Pri_(message.h2Pri_),
-    parsedCookies_(message.parsedCookies_),
     parsedQueryParams_(message.parsedQueryParams_),
     chunked_(message.chunked_),
     upgraded_(message.upgraded_),
@@ -102,7 +102,8 @@ HTTPMessage::HTTPMessage(const HTTPMessage& message) :
     partiallyReliable_(message.partiallyReliable_),
     upgradeWebsocket_(message.upgradeWebsocket_) {
   if (isRequest()) {
-    setURL(request().url_);
+    // re-point path_/query_ into this message's url_ lazily
+    setURLLazy(request().url_);
   }
   if (message.strippedPerHopHeaders_) {
     strippedPerHopHeaders_ = std::make_unique<HTTPHeaders>(
@@ -111,6 +112,105 @@ HTTPMessage::HTTPMessage(const HTTPMessage& message) :
   if (message.trailers_) {
     trailers_ = std::make_unique<HTTPHeaders>(*message.trailers_);
   }
+  if (message.routingDescriptor_) {
+    routingDescriptor_ =
+        std::make_unique<RoutingDescriptor>(*message.routingDescriptor_);
+  }
+}
+
+void HTTPMessage::refreshTypedCache() const {
+  const auto version = headers_.getMutationCount();
+  if (version == typedCacheVersion_) {
+    return;
+  }
+  typedCacheVersion_ = version;
+  cachedContentLength_.clear();
+  cachedAcceptedEncodings_.clear();
+  contentLengthParsed_ = false;
+  acceptEncodingParsed_ = false;
+}
+
+folly::Optional<int64_t> HTTPMessage::getTypedContentLength() const {
+  refreshTypedCache();
+  if (!contentLengthParsed_) {
+    contentLengthParsed_ = true;
+    const auto& value =
+        headers_.getSingleOrEmpty(HTTP_HEADER_CONTENT_LENGTH);
+    if (!value.empty()) {
+      auto parsed = folly::tryTo<int64_t>(value);
+      if (parsed.hasValue() && *parsed >= 0) {
+        cachedContentLength_ = *parsed;
+      }
+    }
+  }
+  return cachedContentLength_;
+}
+
+bool HTTPMessage::acceptsEncoding(folly::StringPiece encoding) const {
+  refreshTypedCache();
+  if (!acceptEncodingParsed_) {
+    acceptEncodingParsed_ = true;
+    const auto& value =
+        headers_.getSingleOrEmpty(HTTP_HEADER_ACCEPT_ENCODING);
+    if (!value.empty()) {
+      std::vector<RFC2616::TokenQPair> tokens;
+      if (RFC2616::parseQvalues(value, tokens)) {
+        for (const auto& token : tokens) {
+          if (token.second > 0) {
+            // store lowercased owned copies; the pieces point into the
+            // header value
+            std::string name(token.first.data(), token.first.size());
+            folly::toLowerAscii(&name[0], name.size());
+            cachedAcceptedEncodings_.push_back(std::move(name));
+          }
+        }
+      }
+    }
+  }
+  for (const auto& accepted : cachedAcceptedEncodings_) {
+    if (encoding.size() == accepted.size() &&
+        folly::StringPiece(accepted)
+            .equals(encoding, folly::AsciiCaseInsensitive())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+HTTPMessage::HTTPMessage(const HTTPMessage& message, ForwardingCopyT) :
+    startTime_(message.startTime_),
+    seqNo_(message.seqNo_),
+    dstAddress_(message.dstAddress_),
+    dstIP_(message.dstIP_),
+    dstPort_(message.dstPort_),
+    localIP_(message.localIP_),
+    versionStr_(message.versionStr_),
+    fields_(message.fields_),
+    version_(message.version_),
+    headers_(message.headers_),
+    sslVersion_(message.sslVersion_),
+    sslCipher_(message.sslCipher_),
+    protoStr_(message.protoStr_),
+    pri_(message.pri_),
+    h2Pri_(message.h2Pri_),
+    parsedQueryParams_(false),
+    chunked_(message.chunked_),
+    upgraded_(message.upgraded_),
+    wantsKeepalive_(message.wantsKeepalive_),
+    trailersAllowed_(message.trailersAllowed_),
+    secure_(message.secure_),
+    partiallyReliable_(message.partiallyReliable_),
+    upgradeWebsocket_(message.upgradeWebsocket_) {
+  // derived caches (queryParams_, the parsed flag,
+  // strippedPerHopHeaders_) intentionally left behind; see
+  // forwardingCopy()
+  if (isRequest()) {
+    // re-point path_/query_ into this message's url_ lazily
+    setURLLazy(request().url_);
+  }
+  if (message.trailers_) {
+    trailers_ = std::make_unique<HTTPHeaders>(*message.trailers_);
+  }
 }
 
 HTTPMessage::HTTPMessage(HTTPMessage&& message) noexcept :
@@ -122,18 +222,17 @@ HTTPMessage::HTTPMessage(HTTPMessage&& message) noexcept :
     localIP_(std::move(message.localIP_)),
     versionStr_(std::move(message.versionStr_)),
     fields_(std::move(message.fields_)),
-    cookies_(std::move(message.cookies_)),
     queryParams_(std::move(message.queryParams_)),
     version_(message.version_),
     headers_(std::move(message.headers_)),
     strippedPerHopHeaders_(std::move(message.strippedPerHopHeaders_)),
     trailers_(std::move(message.trailers_)),
+    routingDescriptor_(std::move(message.routingDescriptor_)),
     sslVersion_(message.sslVersion_),
     sslCipher_(message.sslCipher_),
     protoStr_(message.protoStr_),
     pri_(message.pri_),
     h2Pri_(message.h2Pri_),
-    parsedCookies_(message.parsedCookies_),
     parsedQueryParams_(message.parsedQueryParams_),
     chunked_(message.chunked_),
     upgraded_(message.upgraded_),
@@ -143,7 +242,8 @@ HTTPMessage::HTTPMessage(HTTPMessage&& message) noexcept :
     partiallyReliable_(message.partiallyReliable_),
     upgradeWebsocket_(message.upgradeWebsocket_) {
   if (isRequest()) {
-    setURL(request().url_);
+    // re-point path_/query_ into this message's url_ lazily
+    setURLLazy(request().url_);
   }
 }
 
@@ -160,9 +260,9 @@ HTTPMessage& HTTPMessage::operator=(const HTTPMessage& message) {
   versionStr_ = message.versionStr_;
   fields_ = message.fields_;
   if (isRequest()) {
-    setURL(request().url_);
+    // re-point path_/query_ into this message's url_ lazily
+    setURLLazy(request().url_);
   }
-  cookies_ = message.cookies_;
   queryParams_ = message.queryParams_;
   version_ = message.version_;
   headers_ = message.headers_;
@@ -177,7 +277,6 @@ HTTPMessage& HTTPMessage::operator=(const HTTPMessage& message) {
   protoStr_ = message.protoStr_;
   pri_ = message.pri_;
   h2Pri_ = message.h2Pri_;
-  parsedCookies_ = message.parsedCookies_;
   parsedQueryParams_ = message.parsedQueryParams_;
   chunked_ = message.chunked_;
   upgraded_ = message.upgraded_;
@@ -191,6 +290,12 @@ HTTPMessage& HTTPMessage::operator=(const HTTPMessage& message) {
   } else {
     trailers_.reset();
   }
+  if (message.routingDescriptor_) {
+    routingDescriptor_ =
+        std::make_unique<RoutingDescriptor>(*message.routingDescriptor_);
+  } else {
+    routingDescriptor_.reset();
+  }
   return *this;
 }
 
@@ -207,9 +312,9 @@ HTTPMessage& HTTPMessage::operator=(HTTPMessage&& message) {
   versionStr_ = std::move(message.versionStr_);
   fields_ = std::move(message.fields_);
   if (isRequest()) {
-    setURL(request().url_);
+    // re-point path_/query_ into this message's url_ lazily
+    setURLLazy(request().url_);
   }
-  cookies_ = std::move(message.cookies_);
   queryParams_ = std::move(message.queryParams_);
   version_ = message.version_;
   headers_ = std::move(message.headers_);
@@ -219,7 +324,6 @@ HTTPMessage& HTTPMessage::operator=(HTTPMessage&& message) {
   protoStr_ = message.protoStr_;
   pri_ = message.pri_;
   h2Pri_ = message.h2Pri_;
-  parsedCookies_ = message.parsedCookies_;
   parsedQueryParams_ = message.parsedQueryParams_;
   chunked_ = message.chunked_;
   upgraded_ = message.upgraded_;
@@ -228,6 +332,7 @@ HTTPMessage& HTTPMessage::operator=(HTTPMessage&& message) {
   secure_ = message.secure_;
   upgradeWebsocket_ = message.upgradeWebsocket_;
   trailers_ = std::move(message.trailers_);
+  routingDescriptor_ = std::move(message.routingDescriptor_);
   return *this;
 }
 
@@ -326,7 +431,7 @@ struct FormattedDate {
   time_t lastTime{0};
   string date;
 
-  string formatDate() {
+  const string& formatDate() {
     const auto now = std::chrono::system_clock::to_time_t(
       std::chrono::system_clock::now());
 
@@ -345,6 +450,10 @@ struct FormattedDate {
 }
 
 string HTTPMessage::formatDateHeader() {
+  return getDateHeader();
+}
+
+const string& HTTPMessage::getDateHeader() {
   struct DateTag {};
   auto& obj = folly::SingletonThreadLocal<FormattedDate, DateTag>::get();
   return obj.formatDate();
@@ -403,45 +512,63 @@ HTTPMessage::constructDirectResponse(const pair<uint8_t,uint8_t>& version,
   setIsUpgraded(false);
 }
 
-void HTTPMessage::parseCookies() const {
-  DCHECK(!parsedCookies_);
-  parsedCookies_ = true;
-
+const StringPiece HTTPMessage::getCookie(const string& name) const {
+  // The previous implementation materialized every cookie into a map,
+  // and because the map stored raw pointers into headers_ (which can
+  // move on add()) it had to throw the map away and re-split all the
+  // cookies on every single call. Scanning for just the requested key
+  // does strictly less work per lookup and caches nothing, so there is
+  // no dangling-pointer hazard to defend against.
+  StringPiece result;
   headers_.forEachValueOfHeader(HTTP_HEADER_COOKIE,
                                 [&](const string& headerval) {
+    bool found = false;
     splitNameValuePieces(headerval, ';', '=',
-        [this](StringPiece cookieName, StringPiece cookieValue) {
-          cookies_.emplace(cookieName, cookieValue);
+        [&](StringPiece cookieName, StringPiece cookieValue) {
+          if (!found && cookieName == name) {
+            result = cookieValue;
+            found = true;
+          }
         });
-
-    return false; // continue processing "cookie" headers
+    // stop processing further cookie headers once the key is found
+    return found;
   });
+  return result;
 }
 
-void HTTPMessage::unparseCookies() const {
-  cookies_.clear();
-  parsedCookies_ = false;
+bool HTTPMessage::forEachQueryParam(
+    folly::FunctionRef<bool(StringPiece, StringPiece)> visitor) const {
+  ensureUrlDecomposed();
+  bool stopped = false;
+  splitNameValuePieces(request().query_, '&', '=',
+      [&](StringPiece name, StringPiece value) {
+        if (!stopped && visitor(name, value)) {
+          stopped = true;
+        }
+      });
+  return stopped;
 }
 
-const StringPiece HTTPMessage::getCookie(const string& name) const {
- // clear previous parsed cookies.  They might store raw pointers to a vector
-  // in headers_, which can resize on add()
-  // Parse the cookies if we haven't done so yet
-  unparseCookies();
-  if (!parsedCookies_) {
-    parseCookies();
-  }
+StringPiece HTTPMessage::getQueryParamRaw(StringPiece name) const {
+  StringPiece result;
+  forEachQueryParam([&](StringPiece paramName, StringPiece paramValue) {
+    if (paramName == name) {
+      result = paramValue;
+      return true;
+    }
+    return false;
+  });
+  return result;
+}
 
-  auto it = cookies_.find(name);
-  if (it == cookies_.end()) {
-    return StringPiece();
-  } else {
-    return it->second;
-  }
+StringPiece HTTPMessage::getQueryParamDecoded(StringPiece name,
+                                              std::string& scratch) const {
+  return decodePercent(getQueryParamRaw(name), scratch);
 }
 
 void HTTPMessage::parseQueryParams() const {
   DCHECK(!parsedQueryParams_);
+  ensureUrlDecomposed();
   const Request& req = request();
 
   parsedQueryParams_ = true;
@@ -557,6 +684,7 @@ bool HTTPMessage::removeQueryParam(const std::string& name) {
     return false;
   }
 
+  ensureUrlDecomposed();
   auto query = createQueryString(queryParams_, request().query_.size());
   return setQueryStringImpl(query, false);
 }
@@ -569,6 +697,7 @@ bool HTTPMessage::setQueryParam(const std::string& name,
   }
 
   queryParams_[name] = value;
+  ensureUrlDecomposed();
   auto query = createQueryString(queryParams_, request().query_.size());
   return setQueryStringImpl(query, false);
 }
@@ -723,6 +852,7 @@ void HTTPMessage::describe(std::ostream& os) const {
   std::string pushStatusMessage;
   if (isRequest()) {
     // Request fields.
+    ensureUrlDecomposed();
     const Request& req = request();
     pushStatusMessage = getPushStatusStr();
     fields.insert(fields.end(), {
@@ -904,6 +1034,7 @@ const char* HTTPMessage::getDefaultReason(uint16_t status) {
 
 ParseURL HTTPMessage::setURLImplInternal(bool unparse) {
   auto& req = request();
+  req.needsUrlParse_ = false;
   ParseURL u(req.url_);
   if (u.valid()) {
     VLOG(9) << "set path: " << u.path() << " query:"
@@ -923,4 +1054,18 @@ ParseURL HTTPMessage::setURLImplInternal(bool unparse) {
   return u;
 }
 
+void HTTPMessage::decomposeUrl() const {
+  const auto& req = request();
+  req.needsUrlParse_ = false;
+  ParseURL u(req.url_);
+  if (u.valid()) {
+    req.path_ = u.path();
+    req.query_ = u.query();
+  } else {
+    VLOG(4) << "Error in parsing URL: " << req.url_;
+    req.path_.clear();
+    req.query_.clear();
+  }
+}
+
 } // proxygen
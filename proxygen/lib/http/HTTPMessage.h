@@ -11,6 +11,7 @@
 #include <array>
 #include <boost/variant.hpp>
 #include <folly/Conv.h>
+#include <folly/Function.h>
 #include <folly/Optional.h>
 #include <folly/SocketAddress.h>
 #include <folly/io/IOBufQueue.h>
@@ -20,8 +21,10 @@
 #include <proxygen/lib/http/HTTPHeaderSize.h>
 #include <proxygen/lib/http/HTTPHeaders.h>
 #include <proxygen/lib/http/HTTPMethod.h>
+#include <proxygen/lib/http/RequestPipeline.h>
 #include <proxygen/lib/utils/ParseURL.h>
 #include <proxygen/lib/utils/Time.h>
+#include <limits>
 #include <string>
 
 namespace proxygen {
@@ -51,6 +54,36 @@ class HTTPMessage {
   HTTPMessage& operator=(const HTTPMessage& message);
   HTTPMessage& operator=(HTTPMessage&& message);
 
+  /**
+   * A copy shaped for forwarding to another hop: the header block, URL
+   * state and per-message attributes are copied (URL decomposition
+   * stays lazy), but the derived caches - parsed cookies, parsed query
+   * params, stripped per-hop headers - are left behind.  The next hop
+   * re-derives them lazily if it needs them; more importantly the
+   * cookie/query views in those caches point into THIS message's
+   * storage, so carrying them across a copy risks dangling once the
+   * original goes away.  Cheaper and safer than the copy constructor
+   * for proxy flows.
+   */
+  HTTPMessage forwardingCopy() const {
+    return HTTPMessage(*this, ForwardingCopyT{});
+  }
+
+  /**
+   * Typed header values, parsed once and cached: every filter in the
+   * stack re-asking "what's the content length" or "does the client
+   * accept gzip" after the first costs a version check and a load.
+   * The cache revalidates against the header map's mutation count, so
+   * any header add/remove/set invalidates it.
+   */
+  folly::Optional<int64_t> getTypedContentLength() const;
+
+  /**
+   * True when the Accept-Encoding header lists the encoding with a
+   * nonzero q-value.  Token list parsed once per header state.
+   */
+  bool acceptsEncoding(folly::StringPiece encoding) const;
+
   // upgradeWebsocket_ can have three states, WebSocketUpgrade::NONE by
   // default. WebSocketUpgrade::INGRESS is used by the codec to indicate a
   // websocket upgrade request was received from downstream or a successful
@@ -219,6 +252,24 @@ class HTTPMessage {
   const std::string& getURL() const {
     return request().url_;
   }
+
+  /**
+   * Set the URL without decomposing it; path/query are materialized
+   * from the stored URL on first access. Handlers that route on the
+   * raw URL (or never look at the query) skip the parse entirely.
+   */
+  template <typename T> // T = string
+  void setURLLazy(T&& url) {
+    VLOG(9) << "setURLLazy: " << url;
+    auto& req = request();
+    req.url_ = std::forward<T>(url);
+    req.path_.clear();
+    req.query_.clear();
+    req.pathStr_ = folly::none;
+    req.queryStr_ = folly::none;
+    req.needsUrlParse_ = true;
+    unparseQueryParams();
+  }
   void rawSetURL(const std::string& url) {
     setURL(url);
   }
@@ -230,6 +281,7 @@ class HTTPMessage {
    * more expensive.  Prefer getPathAsStringPiece.
    */
   const std::string& getPath() const {
+    ensureUrlDecomposed();
     auto& req = request();
     if (!req.pathStr_.hasValue()) {
       req.pathStr_.emplace(req.path_.data(), req.path_.size());
@@ -238,6 +290,7 @@ class HTTPMessage {
   }
 
   folly::StringPiece getPathAsStringPiece() const {
+    ensureUrlDecomposed();
     return request().path_;
   }
 
@@ -248,6 +301,7 @@ class HTTPMessage {
    * more expensive.  Prefer getQueryStringAsStringPiece.
    */
   const std::string& getQueryString() const {
+    ensureUrlDecomposed();
     auto& req = request();
     if (!req.queryStr_.hasValue()) {
       req.queryStr_.emplace(req.query_.data(), req.query_.size());
@@ -256,6 +310,7 @@ class HTTPMessage {
   }
 
   folly::StringPiece getQueryStringAsStringPiece() const {
+    ensureUrlDecomposed();
     return request().query_;
   }
 
@@ -326,6 +381,17 @@ class HTTPMessage {
   /**
    * Set the trailers, replacing any that might already be present
    */
+  /**
+   * Routing descriptor attached by RequestPipeline's fused
+   * validate/normalize/extract pass; nullptr when no pipeline ran.
+   */
+  void setRoutingDescriptor(std::unique_ptr<RoutingDescriptor> descriptor) {
+    routingDescriptor_ = std::move(descriptor);
+  }
+  const RoutingDescriptor* getRoutingDescriptor() const {
+    return routingDescriptor_.get();
+  }
+
   void setTrailers(std::unique_ptr<HTTPHeaders>&& trailers) {
     trailers_ = std::move(trailers);
   }
@@ -374,6 +440,14 @@ class HTTPMessage {
    */
   static std::string formatDateHeader();
 
+  /**
+   * As formatDateHeader, but returns a reference to the worker-local
+   * cached string (re-formatted at most once per second) instead of a
+   * copy. The reference is only stable until the next call on this
+   * thread; copy or append it immediately.
+   */
+  static const std::string& getDateHeader();
+
   /**
    * Ensures this HTTPMessage contains a host header, adding a default one
    * with the destination address if necessary.
@@ -534,14 +608,45 @@ class HTTPMessage {
    */
   bool setQueryParam(const std::string& name, const std::string& value);
 
+  /**
+   * Visit the query parameters as StringPieces into the raw query
+   * string, with no map materialization and no allocation. Names and
+   * values are the raw (still percent-encoded) bytes; the visitor
+   * returns true to stop early. Returns whether the visitor stopped.
+   * The pieces are only valid while the message's URL is unchanged.
+   */
+  bool forEachQueryParam(
+      folly::FunctionRef<bool(folly::StringPiece, folly::StringPiece)>
+          visitor) const;
+
+  /**
+   * Single-key lookup over the raw query string: the first matching
+   * parameter's raw (percent-encoded) value, or an empty piece.
+   * Allocates nothing, unlike getQueryParam which materializes the
+   * whole decoded parameter map.
+   */
+  folly::StringPiece getQueryParamRaw(folly::StringPiece name) const;
+
+  /**
+   * Scan-gated decoded single-key lookup: getQueryParamRaw routed
+   * through decodePercent, so the common unencoded value comes back
+   * as a piece into the raw query with no allocation at all (unlike
+   * getDecodedQueryParam, which materializes the whole decoded map
+   * and always copies); values with escapes decode into the caller's
+   * scratch.  Valid while the URL and scratch are unchanged.
+   */
+  folly::StringPiece getQueryParamDecoded(folly::StringPiece name,
+                                          std::string& scratch) const;
+
   /**
    * Get the cookie with the specified name.
    *
    * Returns a StringPiece to the cookie value, or an empty StringPiece if
    * there is no cookie with the specified name.  The returned cookie is
    * only valid as long as the Cookie Header in HTTPMessage object exists.
-   * Applications should make sure they call unparseCookies() when editing
-   * the Cookie Header, so that the StringPiece references are cleared.
+   * Each call scans the cookie headers for just the requested key and
+   * caches nothing, so lookups stay valid across header edits and a
+   * single-cookie probe doesn't pay to materialize all of them.
    */
   const folly::StringPiece getCookie(const std::string& name) const;
 
@@ -676,16 +781,6 @@ class HTTPMessage {
                            char const* token,
                            bool caseSensitive) const;
 
-  /**
-   * Forget about the parsed cookies.
-   *
-   * Ideally HTTPMessage should automatically forget about the current parsed
-   * cookie state whenever a Cookie header is changed.  However, at the moment
-   * callers have to explicitly call unparseCookies() after modifying the
-   * cookie headers.
-   */
-  void unparseCookies() const;
-
   /**
    * Get the default reason string for a status code.
    *
@@ -765,14 +860,15 @@ class HTTPMessage {
   }
 
  protected:
+  struct ForwardingCopyT {};
+  HTTPMessage(const HTTPMessage& message, ForwardingCopyT);
+
   // Message start time, in msec since the epoch.
   TimePoint startTime_;
   int32_t seqNo_;
 
  private:
 
-  void parseCookies() const;
-
   template <typename T> // T = string
   ParseURL setURLImpl(T&& url, bool unparse) {
     VLOG(9) << "setURL: " << url;
@@ -784,6 +880,15 @@ class HTTPMessage {
 
   ParseURL setURLImplInternal(bool unparse);
 
+  // materialize path_/query_ from url_ if setURLLazy deferred it
+  void ensureUrlDecomposed() const {
+    if (request().needsUrlParse_) {
+      decomposeUrl();
+    }
+  }
+
+  void decomposeUrl() const;
+
   bool setQueryStringImpl(const std::string& queryString, bool unparse);
   void parseQueryParams() const;
   void unparseQueryParams();
@@ -808,11 +913,13 @@ class HTTPMessage {
     mutable folly::Optional<std::string> clientIP_;
     mutable folly::Optional<std::string> clientPort_;
     mutable boost::variant<boost::blank, std::string, HTTPMethod> method_;
-    folly::StringPiece path_;
-    folly::StringPiece query_;
+    mutable folly::StringPiece path_;
+    mutable folly::StringPiece query_;
     mutable folly::Optional<std::string> pathStr_;
     mutable folly::Optional<std::string> queryStr_;
     std::string url_;
+    // set by setURLLazy; path_/query_ materialize on first access
+    mutable bool needsUrlParse_{false};
 
     uint16_t pushStatus_;
   };
@@ -950,11 +1057,10 @@ class HTTPMessage {
   }
 
   /*
-   * Cookies and query parameters
-   * These are mutable since we parse them lazily in getCookie() and
-   * getQueryParam()
+   * Query parameters, mutable since we parse them lazily in
+   * getQueryParam().  Cookies have no cache: getCookie() scans for
+   * just the requested key.
    */
-  mutable std::map<folly::StringPiece, folly::StringPiece> cookies_;
   // TODO: use StringPiece for queryParams_ and delete splitNameValue()
   mutable std::map<std::string, std::string> queryParams_;
 
@@ -964,13 +1070,24 @@ class HTTPMessage {
   HTTPHeaderSize size_;
   std::unique_ptr<HTTPHeaders> trailers_;
 
+  // set by RequestPipeline::process; see getRoutingDescriptor
+  std::unique_ptr<RoutingDescriptor> routingDescriptor_;
+
   int sslVersion_;
   const char* sslCipher_;
   const std::string* protoStr_;
   uint8_t pri_;
   folly::Optional<HTTPPriority> h2Pri_;
 
-  mutable bool parsedCookies_:1;
+  // typed header value cache; see getTypedContentLength
+  mutable uint32_t typedCacheVersion_{std::numeric_limits<uint32_t>::max()};
+  mutable folly::Optional<int64_t> cachedContentLength_;
+  mutable std::vector<std::string> cachedAcceptedEncodings_;
+  mutable bool contentLengthParsed_{false};
+  mutable bool acceptEncodingParsed_{false};
+
+  void refreshTypedCache() const;
+
   mutable bool parsedQueryParams_:1;
   bool chunked_:1;
   bool upgraded_:1;
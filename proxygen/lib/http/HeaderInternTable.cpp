@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/HeaderInternTable.h>
+
+#include <folly/hash/Hash.h>
+
+namespace {
+
+struct ThreadCache {
+  uint64_t generation{0};
+  // hash -> interned entry; verified against the bytes on hit
+  std::unordered_map<uint64_t, const std::string*> entries;
+  // hash -> sightings; collisions merely accelerate admission
+  std::unordered_map<uint64_t, uint32_t> counts;
+};
+
+ThreadCache& threadCache() {
+  static thread_local ThreadCache cache;
+  return cache;
+}
+
+uint64_t hashName(folly::StringPiece name) {
+  return folly::hash::fnv64_buf(name.data(), name.size());
+}
+
+} // namespace
+
+namespace proxygen {
+
+constexpr uint32_t HeaderInternTable::kInternThreshold;
+constexpr size_t HeaderInternTable::kMaxEntries;
+constexpr size_t HeaderInternTable::kMaxNameLength;
+
+HeaderInternTable& HeaderInternTable::get() {
+  // deliberately leaked: name destructors call isInterned during
+  // static teardown, after a Meyers singleton would already be gone
+  static HeaderInternTable* table = new HeaderInternTable();
+  return *table;
+}
+
+const std::string* HeaderInternTable::tryIntern(folly::StringPiece name) {
+  if (name.empty() || name.size() > kMaxNameLength) {
+    return nullptr;
+  }
+  auto& cache = threadCache();
+  const auto hash = hashName(name);
+
+  auto generation = generation_.load(std::memory_order_acquire);
+  if (cache.generation != generation) {
+    // resync the thread view; admissions are rare, so this amortizes
+    cache.entries.clear();
+    auto master = master_.rlock();
+    for (const auto& entry : *master) {
+      cache.entries[hashName(entry.first)] = entry.second;
+    }
+    cache.generation = generation;
+  }
+
+  auto hit = cache.entries.find(hash);
+  if (hit != cache.entries.end() && *hit->second == name) {
+    return hit->second;
+  }
+
+  if (count_.load(std::memory_order_relaxed) >= kMaxEntries) {
+    return nullptr; // full: stop counting too
+  }
+  if (cache.counts.size() >= 4096) {
+    // bound the counting map against unique-name spray; restarting
+    // the counts only delays admission
+    cache.counts.clear();
+  }
+  if (++cache.counts[hash] < kInternThreshold) {
+    return nullptr;
+  }
+  cache.counts.erase(hash);
+
+  auto master = master_.wlock();
+  auto key = name.str();
+  auto found = master->find(key);
+  if (found == master->end()) {
+    auto index = count_.load(std::memory_order_relaxed);
+    if (index >= kMaxEntries) {
+      return nullptr;
+    }
+    storage_[index] = std::move(key);
+    found = master->emplace(storage_[index], &storage_[index]).first;
+    count_.store(index + 1, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+  cache.entries[hash] = found->second;
+  return found->second;
+}
+
+} // namespace proxygen
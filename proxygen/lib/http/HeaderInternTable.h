@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <string>
+#include <unordered_map>
+
+namespace proxygen {
+
+/**
+ * Process-wide interning for header names that miss the common-header
+ * table (the x-internal-* fleet), so identical custom names stop
+ * being re-allocated per message and compare by pointer.
+ *
+ * A name is admitted after a thread has seen it kInternThreshold
+ * times; admitted entries live in a fixed, contiguous storage array
+ * and are immortal - no refcounting, and membership (the question
+ * every name destructor asks) is two pointer comparisons against the
+ * storage bounds.  The table is bounded at kMaxEntries and simply
+ * stops admitting when full, so an attacker spraying unique names
+ * can't grow it.
+ *
+ * The hot lookup path goes through a per-thread cache keyed by name
+ * hash (collisions are re-verified against the interned bytes) and
+ * touches no locks; the shared master map is consulted only when a
+ * generation bump says the thread's view is stale, and written only
+ * at admission.
+ */
+class HeaderInternTable {
+ public:
+  static constexpr uint32_t kInternThreshold = 32;
+  static constexpr size_t kMaxEntries = 1024;
+  static constexpr size_t kMaxNameLength = 64;
+
+  static HeaderInternTable& get();
+
+  /**
+   * The interned entry for this exact byte sequence, admitting it
+   * once it has been seen often enough; nullptr while not interned.
+   */
+  const std::string* tryIntern(folly::StringPiece name);
+
+  /** True iff ptr is one of this table's immortal entries. */
+  bool isInterned(const std::string* ptr) const {
+    return ptr >= storage_.data() && ptr < storage_.data() + kMaxEntries;
+  }
+
+  size_t size() const {
+    return count_.load(std::memory_order_acquire);
+  }
+
+  // -- helpers for layers that store std::string* names ------------
+
+  /** Interned entry when admitted, else a fresh heap allocation. */
+  static std::string* internOrAllocate(folly::StringPiece name) {
+    auto interned = get().tryIntern(name);
+    return interned ? const_cast<std::string*>(interned)
+                    : new std::string(name.data(), name.size());
+  }
+
+  /** Free a stored name unless it is an immortal interned entry. */
+  static void releaseName(const std::string* name) {
+    if (!get().isInterned(name)) {
+      delete name;
+    }
+  }
+
+  /** Share an interned name; duplicate an owned one. */
+  static std::string* copyName(const std::string* name) {
+    if (get().isInterned(name)) {
+      return const_cast<std::string*>(name);
+    }
+    return new std::string(*name);
+  }
+
+ private:
+  HeaderInternTable() = default;
+
+  // immortal entries; contiguity is what makes isInterned two compares
+  std::array<std::string, kMaxEntries> storage_;
+  std::atomic<size_t> count_{0};
+  // bumped on every admission; invalidates per-thread caches
+  std::atomic<uint64_t> generation_{1};
+  // name -> interned entry into storage_
+  folly::Synchronized<
+      std::unordered_map<std::string, const std::string*>>
+      master_;
+};
+
+} // namespace proxygen
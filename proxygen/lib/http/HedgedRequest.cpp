@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/HedgedRequest.h>
+
+#include <glog/logging.h>
+
+namespace proxygen {
+
+void HedgedRequest::send(WheelTimerInstance timer,
+                         HTTPMessage request,
+                         TxnSource primary,
+                         TxnSource hedge,
+                         HTTPTransactionHandler* handler,
+                         Options options) {
+  auto hedged = new HedgedRequest(
+      std::move(request), std::move(hedge), handler, options);
+  if (!hedged->primary_.start(primary, hedged->request_)) {
+    // primary refused: go straight to the hedge leg
+    if (!hedged->hedge_.start(hedged->hedgeSource_, hedged->request_)) {
+      HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS,
+                       "no transaction available for hedged request");
+      ex.setProxygenError(kErrorConnect);
+      handler->onError(ex);
+      delete hedged;
+      return;
+    }
+    return; // single leg in flight; no hedge left to schedule
+  }
+  auto delay = options.tracker ? options.tracker->hedgeDelay()
+                               : options.hedgeDelay;
+  timer.scheduleTimeout(hedged, delay);
+}
+
+HedgedRequest::HedgedRequest(HTTPMessage request,
+                             TxnSource hedgeSource,
+                             HTTPTransactionHandler* handler,
+                             Options options)
+    : request_(std::move(request)),
+      hedgeSource_(std::move(hedgeSource)),
+      handler_(handler),
+      options_(options),
+      startTime_(getCurrentTime()) {
+}
+
+bool HedgedRequest::Leg::start(TxnSource& source, const HTTPMessage& request) {
+  auto txn = source(this);
+  if (!txn) {
+    detached_ = true; // never ran; counts as done for cleanup
+    return false;
+  }
+  DCHECK_EQ(txn_, txn) << "source must install the leg as handler";
+  txn_->sendHeadersWithEOM(request);
+  return true;
+}
+
+void HedgedRequest::Leg::abortLeg() {
+  if (txn_ && !aborted_) {
+    aborted_ = true;
+    txn_->sendAbort();
+  }
+}
+
+bool HedgedRequest::Leg::forwarding() const {
+  return parent_->winner_ == this;
+}
+
+void HedgedRequest::Leg::onHeadersComplete(
+    std::unique_ptr<HTTPMessage> msg) noexcept {
+  if (msg->is1xxResponse()) {
+    // informational responses don't decide the race
+    if (forwarding()) {
+      parent_->handler_->onHeadersComplete(std::move(msg));
+    }
+    return;
+  }
+  parent_->onLegHeaders(this, std::move(msg));
+}
+
+void HedgedRequest::Leg::onBody(std::unique_ptr<folly::IOBuf> chain) noexcept {
+  if (forwarding()) {
+    parent_->handler_->onBody(std::move(chain));
+  }
+}
+
+void HedgedRequest::Leg::onChunkHeader(size_t length) noexcept {
+  if (forwarding()) {
+    parent_->handler_->onChunkHeader(length);
+  }
+}
+
+void HedgedRequest::Leg::onChunkComplete() noexcept {
+  if (forwarding()) {
+    parent_->handler_->onChunkComplete();
+  }
+}
+
+void HedgedRequest::Leg::onTrailers(
+    std::unique_ptr<HTTPHeaders> trailers) noexcept {
+  if (forwarding()) {
+    parent_->handler_->onTrailers(std::move(trailers));
+  }
+}
+
+void HedgedRequest::Leg::onEOM() noexcept {
+  if (forwarding()) {
+    parent_->handler_->onEOM();
+  }
+}
+
+void HedgedRequest::Leg::onUpgrade(UpgradeProtocol protocol) noexcept {
+  if (forwarding()) {
+    parent_->handler_->onUpgrade(protocol);
+  }
+}
+
+void HedgedRequest::Leg::onError(const HTTPException& error) noexcept {
+  parent_->onLegError(this, error);
+}
+
+void HedgedRequest::Leg::onEgressPaused() noexcept {
+  if (forwarding()) {
+    parent_->handler_->onEgressPaused();
+  }
+}
+
+void HedgedRequest::Leg::onEgressResumed() noexcept {
+  if (forwarding()) {
+    parent_->handler_->onEgressResumed();
+  }
+}
+
+void HedgedRequest::Leg::detachTransaction() noexcept {
+  detached_ = true;
+  txn_ = nullptr;
+  if (forwarding() && parent_->handlerAttached_ && !parent_->handlerDone_) {
+    parent_->handlerDone_ = true;
+    parent_->handler_->detachTransaction();
+  }
+  parent_->maybeCleanup();
+}
+
+void HedgedRequest::timeoutExpired() noexcept {
+  if (winner_ || !primary_.started()) {
+    return; // decided already, or nothing to hedge against
+  }
+  // tail territory: race a second replica
+  if (!hedge_.start(hedgeSource_, request_)) {
+    VLOG(4) << "hedge leg declined; continuing on the primary alone";
+  }
+  // both legs may already be gone if they failed while we were queued
+  maybeCleanup();
+}
+
+void HedgedRequest::onLegHeaders(Leg* leg, std::unique_ptr<HTTPMessage> msg) {
+  if (winner_) {
+    // lost the race after headers were already delivered elsewhere
+    leg->abortLeg();
+    return;
+  }
+  winner_ = leg;
+  cancelTimeout(); // no point hedging once headers arrived
+  auto& loser = (leg == &primary_) ? hedge_ : primary_;
+  loser.abortLeg();
+  if (options_.tracker) {
+    options_.tracker->record(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            getCurrentTime() - startTime_));
+  }
+  handlerAttached_ = true;
+  handler_->setTransaction(leg->txn_);
+  handler_->onHeadersComplete(std::move(msg));
+}
+
+void HedgedRequest::onLegError(Leg* leg, const HTTPException& error) {
+  if (winner_ == leg) {
+    // the winning leg failed mid-response; the user sees the error
+    if (handlerAttached_ && !handlerDone_) {
+      handler_->onError(error);
+    }
+    return;
+  }
+  if (winner_) {
+    return; // the loser erroring is expected after the abort
+  }
+  auto& other = (leg == &primary_) ? hedge_ : primary_;
+  if (other.started() && !other.detached_) {
+    // the other leg is still in the race; it carries on alone.  If the
+    // primary died before the hedge timer fired, fire the hedge now.
+    return;
+  }
+  if (leg == &primary_ && !hedge_.started() && !winner_) {
+    // primary failed before the hedge launched: launch it immediately
+    if (hedge_.start(hedgeSource_, request_)) {
+      return;
+    }
+  }
+  // no legs left: the failure is the result
+  handlerAttached_ = true;
+  handlerDone_ = true;
+  handler_->setTransaction(leg->txn_);
+  handler_->onError(error);
+  handler_->detachTransaction();
+}
+
+void HedgedRequest::maybeCleanup() {
+  const bool primaryDone = !primary_.started() || primary_.detached_;
+  const bool hedgeDone = !hedge_.started() || hedge_.detached_;
+  if (primaryDone && hedgeDone && !isScheduled()) {
+    delete this;
+  }
+}
+
+} // namespace proxygen
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <folly/Function.h>
+#include <proxygen/lib/http/HTTPMessage.h>
+#include <proxygen/lib/http/session/HTTPTransaction.h>
+#include <proxygen/lib/utils/PercentileHistogram.h>
+#include <proxygen/lib/utils/Time.h>
+#include <proxygen/lib/utils/WheelTimerInstance.h>
+
+namespace proxygen {
+
+/**
+ * Adaptive hedge-delay source: records time-to-first-headers of
+ * completed requests and recommends hedging at the observed p95, so
+ * the hedge fires exactly where the tail starts instead of at a
+ * hand-tuned constant.  Falls back to the configured floor until
+ * enough samples exist.
+ */
+class HedgeLatencyTracker {
+ public:
+  explicit HedgeLatencyTracker(
+      std::chrono::milliseconds floor = std::chrono::milliseconds(50),
+      uint32_t minSamples = 100)
+      : floor_(floor), minSamples_(minSamples) {
+  }
+
+  void record(std::chrono::microseconds timeToFirstHeaders) {
+    latencies_.record(timeToFirstHeaders.count());
+  }
+
+  std::chrono::milliseconds hedgeDelay() const {
+    if (latencies_.count() < minSamples_) {
+      return floor_;
+    }
+    auto p95Us = latencies_.estimatePercentile(95);
+    return std::max(floor_,
+                    std::chrono::milliseconds((p95Us + 999) / 1000));
+  }
+
+ private:
+  std::chrono::milliseconds floor_;
+  uint32_t minSamples_;
+  PercentileHistogram latencies_;
+};
+
+/**
+ * Tail-latency hedging over two transaction sources (typically two
+ * pooled sessions to different replicas; see SessionPool).  The
+ * request goes to the primary immediately and, unless first headers
+ * arrive before the hedge delay, to the secondary as well.  The first
+ * leg to produce response headers wins and its events flow to the
+ * user's handler; the loser is aborted immediately (RST_STREAM /
+ * STOP_SENDING on h3) to reclaim the replica's capacity.  If the only
+ * outstanding leg errors before headers, the other leg (or the error)
+ * takes over.
+ *
+ * Requests are sent headers+EOM (hedging is for idempotent requests);
+ * the object owns itself and cleans up when both legs are done.
+ */
+class HedgedRequest : private folly::HHWheelTimer::Callback {
+ public:
+  struct Options {
+    Options() = default;
+    std::chrono::milliseconds hedgeDelay{50};
+    // when set, overrides hedgeDelay and receives the winner's
+    // time-to-first-headers; caller owns it, one per endpoint group
+    HedgeLatencyTracker* tracker{nullptr};
+  };
+
+  /**
+   * Returns a transaction for the given handler, or nullptr to decline
+   * (e.g. the pool is quarantined or empty).
+   */
+  using TxnSource = folly::Function<HTTPTransaction*(HTTPTransactionHandler*)>;
+
+  /**
+   * Fire and manage a hedged request.  handler receives the winning
+   * leg's callbacks; when the last in-flight leg fails it gets
+   * setTransaction + onError + detachTransaction from that leg, and
+   * when both sources decline synchronously it gets a bare onError
+   * (there was never a transaction to attach).  Self-owning.
+   */
+  static void send(WheelTimerInstance timer,
+                   HTTPMessage request,
+                   TxnSource primary,
+                   TxnSource hedge,
+                   HTTPTransactionHandler* handler,
+                   Options options = Options());
+
+ private:
+  class Leg : public HTTPTransactionHandler {
+   public:
+    explicit Leg(HedgedRequest* parent) : parent_(parent) {
+    }
+
+    bool start(TxnSource& source, const HTTPMessage& request);
+    void abortLeg();
+
+    bool started() const {
+      return txn_ != nullptr;
+    }
+
+    // HTTPTransactionHandler
+    void setTransaction(HTTPTransaction* txn) noexcept override {
+      txn_ = txn;
+    }
+    void detachTransaction() noexcept override;
+    void onHeadersComplete(std::unique_ptr<HTTPMessage> msg) noexcept override;
+    void onBody(std::unique_ptr<folly::IOBuf> chain) noexcept override;
+    void onChunkHeader(size_t length) noexcept override;
+    void onChunkComplete() noexcept override;
+    void onTrailers(std::unique_ptr<HTTPHeaders> trailers) noexcept override;
+    void onEOM() noexcept override;
+    void onUpgrade(UpgradeProtocol protocol) noexcept override;
+    void onError(const HTTPException& error) noexcept override;
+    void onEgressPaused() noexcept override;
+    void onEgressResumed() noexcept override;
+
+   private:
+    bool forwarding() const;
+
+    HedgedRequest* parent_;
+    HTTPTransaction* txn_{nullptr};
+    bool detached_{false};
+    bool aborted_{false};
+
+    friend class HedgedRequest;
+  };
+
+  HedgedRequest(HTTPMessage request,
+                TxnSource hedgeSource,
+                HTTPTransactionHandler* handler,
+                Options options);
+
+  void timeoutExpired() noexcept override; // hedge timer
+  void onLegHeaders(Leg* leg, std::unique_ptr<HTTPMessage> msg);
+  void onLegError(Leg* leg, const HTTPException& error);
+  void maybeCleanup();
+
+  HTTPMessage request_;
+  TxnSource hedgeSource_;
+  HTTPTransactionHandler* handler_;
+  Options options_;
+  TimePoint startTime_;
+  Leg primary_{this};
+  Leg hedge_{this};
+  Leg* winner_{nullptr};
+  bool handlerAttached_{false};
+  bool handlerDone_{false};
+};
+
+} // namespace proxygen
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/OriginPskCache.h>
+
+#include <glog/logging.h>
+
+namespace proxygen {
+
+OriginPskCache::OriginPskCache(Options options)
+    : options_(std::move(options)),
+      l2_(folly::EvictingCacheMap<std::string, fizz::client::CachedPsk>(
+          std::max<size_t>(options_.l2MaxEntries, 1))) {
+}
+
+folly::Optional<fizz::client::CachedPsk> OriginPskCache::getPsk(
+    const std::string& identity) {
+  auto& local = *l1_;
+  auto localIt = local.find(identity);
+  if (localIt != local.end()) {
+    return localIt->second;
+  }
+  {
+    auto l2 = l2_.wlock(); // get() bumps LRU position
+    auto it = l2->find(identity);
+    if (it != l2->end()) {
+      local.emplace(identity, it->second);
+      return it->second;
+    }
+  }
+  if (externalEnabled()) {
+    // prefetch for the next connect; this lookup misses
+    std::weak_ptr<OriginPskCache> self = shared_from_this();
+    options_.externalStore->get(
+        identity, [self, identity](folly::Optional<std::string> serialized) {
+          auto cache = self.lock();
+          if (!cache || !serialized) {
+            return;
+          }
+          auto psk = cache->options_.deserializePsk(*serialized);
+          if (psk) {
+            cache->l2_.wlock()->set(identity, std::move(*psk));
+          }
+        });
+  }
+  return folly::none;
+}
+
+void OriginPskCache::putPsk(const std::string& identity,
+                            fizz::client::CachedPsk psk) {
+  if (externalEnabled()) {
+    options_.externalStore->put(identity, options_.serializePsk(psk));
+  }
+  (*l1_)[identity] = psk;
+  l2_.wlock()->set(identity, std::move(psk));
+}
+
+void OriginPskCache::removePsk(const std::string& identity) {
+  l1_->erase(identity);
+  l2_.wlock()->erase(identity);
+  if (externalEnabled()) {
+    options_.externalStore->remove(identity);
+  }
+}
+
+} // namespace proxygen
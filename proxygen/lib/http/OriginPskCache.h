@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <fizz/client/PskCache.h>
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace proxygen {
+
+/**
+ * Client-side TLS 1.3 PSK cache keyed by origin, for the
+ * HTTPConnectorWithFizz path: install on the FizzClientContext
+ * (setPskCache) and pass the origin as the psk identity (connectFizz
+ * defaults it to the SNI), and upstream reconnects resume instead of
+ * running full handshakes.
+ *
+ * Two in-process levels: a lock-free per-worker L1 so the steady-state
+ * lookup never takes a lock, over a process-shared LRU L2 so a worker
+ * that has not spoken to an origin recently can still resume using a
+ * ticket another worker received.  Optional external storage hooks
+ * (e.g. memcache) extend that across boxes: fizz's PskCache interface
+ * is synchronous, so external reads are prefetch-style - a miss kicks
+ * an async get and the result lands in L2 for the next connect -
+ * while writes are fire-and-forget.  Serialization of CachedPsk for
+ * the external store is supplied by the deployment, keeping this
+ * independent of fizz's serialization utilities.
+ *
+ * Coherence is best effort by design: an L1 copy can outlive an L2
+ * eviction or another worker's removal, and a ticket may be offered
+ * twice across workers.  The server declining a stale or reused
+ * ticket degrades that connect to a full handshake; it never breaks
+ * correctness.  Create via std::make_shared and install with
+ * FizzClientContext::setPskCache; external-store callbacks hold a
+ * weak reference and drop results if the cache is gone.
+ */
+class OriginPskCache
+    : public fizz::client::PskCache,
+      public std::enable_shared_from_this<OriginPskCache> {
+ public:
+  struct ExternalStore {
+    virtual ~ExternalStore() = default;
+    using GetCallback =
+        folly::Function<void(folly::Optional<std::string> serialized)>;
+    // called on the lookup thread; result may arrive on any thread
+    virtual void get(const std::string& identity, GetCallback callback) = 0;
+    virtual void put(const std::string& identity,
+                     const std::string& serialized) = 0;
+    virtual void remove(const std::string& identity) = 0;
+  };
+
+  struct Options {
+    Options() = default;
+    size_t l2MaxEntries = 16384;
+    // both must be set for the external store to be used
+    folly::Function<std::string(const fizz::client::CachedPsk&) const>
+        serializePsk;
+    folly::Function<folly::Optional<fizz::client::CachedPsk>(
+        const std::string&) const>
+        deserializePsk;
+    std::shared_ptr<ExternalStore> externalStore;
+  };
+
+  explicit OriginPskCache(Options options);
+
+  // fizz::client::PskCache
+  folly::Optional<fizz::client::CachedPsk> getPsk(
+      const std::string& identity) override;
+  void putPsk(const std::string& identity,
+              fizz::client::CachedPsk psk) override;
+  void removePsk(const std::string& identity) override;
+
+ private:
+  bool externalEnabled() const {
+    return options_.externalStore && options_.serializePsk &&
+           options_.deserializePsk;
+  }
+
+  Options options_;
+  // per-worker L1, per cache instance
+  folly::ThreadLocal<std::unordered_map<std::string, fizz::client::CachedPsk>>
+      l1_;
+  folly::Synchronized<
+      folly::EvictingCacheMap<std::string, fizz::client::CachedPsk>>
+      l2_;
+};
+
+} // namespace proxygen
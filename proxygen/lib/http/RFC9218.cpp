@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/RFC9218.h>
+
+#include <folly/String.h>
+#include <proxygen/lib/http/HTTPMessage.h>
+
+namespace proxygen {
+namespace RFC9218 {
+
+folly::Optional<Priority> parsePriority(folly::StringPiece value) {
+  Priority priority;
+  bool sawMember = false;
+  std::vector<folly::StringPiece> members;
+  folly::split(',', value, members);
+  for (auto member : members) {
+    member = folly::trimWhitespace(member);
+    if (member.empty()) {
+      continue;
+    }
+    if (member == "i" || member == "i=?1") {
+      priority.incremental = true;
+      sawMember = true;
+    } else if (member == "i=?0") {
+      priority.incremental = false;
+      sawMember = true;
+    } else if (member.startsWith("u=")) {
+      auto urgency = folly::tryTo<int64_t>(member.subpiece(2));
+      if (urgency.hasValue()) {
+        priority.urgency = (uint8_t)std::min<int64_t>(
+            std::max<int64_t>(*urgency, kMinUrgency), kMaxUrgency);
+        sawMember = true;
+      }
+    }
+    // unknown dictionary members are ignored per the RFC
+  }
+  if (!sawMember) {
+    return folly::none;
+  }
+  return priority;
+}
+
+folly::Optional<Priority> getPriority(const HTTPMessage& msg) {
+  const auto& value = msg.getHeaders().getSingleOrEmpty("priority");
+  if (value.empty()) {
+    return folly::none;
+  }
+  return parsePriority(value);
+}
+
+} // namespace RFC9218
+} // namespace proxygen
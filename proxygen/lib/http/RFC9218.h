@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <folly/Optional.h>
+#include <folly/Range.h>
+
+namespace proxygen {
+
+class HTTPMessage;
+
+namespace RFC9218 {
+
+/**
+ * This file contains functions for the extensible priority scheme
+ * (RFC 9218): an urgency level from 0 (highest) to 7 (lowest) plus an
+ * incremental flag, carried in the "priority" request/response header
+ * as a structured-field dictionary, e.g. "u=3, i".
+ */
+
+constexpr uint8_t kMinUrgency = 0;
+constexpr uint8_t kMaxUrgency = 7;
+constexpr uint8_t kDefaultUrgency = 3;
+constexpr uint8_t kNumUrgencies = 8;
+
+struct Priority {
+  uint8_t urgency{kDefaultUrgency};
+  bool incremental{false};
+};
+
+/**
+ * Parse a "priority" header value.  Unknown dictionary keys are
+ * ignored per the RFC; out-of-range urgencies are clamped.  Returns
+ * none for an empty or entirely malformed value.
+ */
+folly::Optional<Priority> parsePriority(folly::StringPiece value);
+
+/**
+ * Convenience: extract the priority from a message's "priority" header,
+ * if present.
+ */
+folly::Optional<Priority> getPriority(const HTTPMessage& msg);
+
+} // namespace RFC9218
+} // namespace proxygen
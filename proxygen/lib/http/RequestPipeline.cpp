@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/RequestPipeline.h>
+
+#include <proxygen/lib/http/HTTPMessage.h>
+
+namespace {
+
+// one byte of the URL scan: the charset rule CodecUtil::validateURL
+// applies, inlined so validation shares the normalization loop
+bool validUrlByte(uint8_t c) {
+  return c > 0x20 && c != 0x7f;
+}
+
+} // namespace
+
+namespace proxygen {
+
+bool RequestPipeline::process(HTTPMessage& msg) const {
+  auto descriptor = std::make_unique<RoutingDescriptor>();
+
+  // ---- single pass over the URL: validate charset and resolve dot
+  // segments (duplicate slashes collapse as a side effect) ----
+  folly::StringPiece url = msg.getURL();
+  auto& path = descriptor->normalizedPath;
+  path.reserve(url.size());
+
+  if (url.empty() || url[0] != '/') {
+    // asterisk-form (OPTIONS *), authority-form (CONNECT) and
+    // absolute URIs skip path normalization but still validate bytes
+    for (uint8_t c : url) {
+      if (!validUrlByte(c)) {
+        descriptor->invalidReason = "invalid byte in request target";
+        msg.setRoutingDescriptor(std::move(descriptor));
+        return false;
+      }
+    }
+    path.assign(url.data(), url.size());
+  } else {
+    size_t segmentStart = 1; // content offset of the open segment
+    auto resolveSegment = [&path, &segmentStart] {
+      folly::StringPiece segment(path.data() + segmentStart,
+                                 path.size() - segmentStart);
+      if (segment == ".") {
+        path.resize(segmentStart);
+      } else if (segment == "..") {
+        // pop the previous segment, never above the root
+        size_t cut = segmentStart;
+        if (cut >= 2) {
+          auto previous = path.rfind('/', cut - 2);
+          cut = (previous == std::string::npos) ? 1 : previous + 1;
+        }
+        path.resize(cut);
+      }
+      segmentStart = path.size();
+    };
+
+    path.push_back('/');
+    bool inQuery = false;
+    for (size_t i = 1; i < url.size(); i++) {
+      const uint8_t c = uint8_t(url[i]);
+      if (!validUrlByte(c)) {
+        descriptor->invalidReason = "invalid byte in request target";
+        msg.setRoutingDescriptor(std::move(descriptor));
+        return false;
+      }
+      if (inQuery) {
+        path.push_back(char(c));
+      } else if (c == '?') {
+        resolveSegment();
+        path.push_back('?');
+        inQuery = true;
+      } else if (c == '/') {
+        resolveSegment();
+        if (path.back() != '/') {
+          path.push_back('/');
+        }
+        segmentStart = path.size();
+      } else {
+        path.push_back(char(c));
+      }
+    }
+    if (!inQuery) {
+      resolveSegment();
+    }
+  }
+
+  // ---- one pass over the host: lowercase, strip the port ----
+  const std::string& rawHost =
+      msg.getHeaders().getSingleOrEmpty(HTTP_HEADER_HOST);
+  descriptor->host.reserve(rawHost.size());
+  for (char c : rawHost) {
+    if (c == ':') {
+      break;
+    }
+    descriptor->host.push_back(
+        (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c);
+  }
+
+  // ---- route key, from the already-normalized fields ----
+  switch (config_.source) {
+    case RouteKeySource::PathPrefix: {
+      // first N segments of the (short, already normalized) path
+      size_t prefixEnd = path.size();
+      size_t slashes = 0;
+      for (size_t i = 0; i < path.size(); i++) {
+        if (path[i] == '?') {
+          prefixEnd = i;
+          break;
+        }
+        if (path[i] == '/' && ++slashes == config_.pathPrefixSegments + 1) {
+          prefixEnd = i;
+          break;
+        }
+      }
+      descriptor->routeKey.assign(path.data(), prefixEnd);
+      break;
+    }
+    case RouteKeySource::Host:
+      descriptor->routeKey = descriptor->host;
+      break;
+    case RouteKeySource::Header:
+      descriptor->routeKey =
+          msg.getHeaders().getSingleOrEmpty(config_.headerName);
+      break;
+  }
+
+  descriptor->valid = true;
+  msg.setRoutingDescriptor(std::move(descriptor));
+  return true;
+}
+
+} // namespace proxygen
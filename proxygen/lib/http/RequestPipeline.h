@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <memory>
+#include <string>
+
+namespace proxygen {
+
+class HTTPMessage;
+
+/**
+ * Compact routing descriptor produced by RequestPipeline's single
+ * pass and attached to the HTTPMessage: the normalized path (dot
+ * segments resolved), the lowercased host, and the configured route
+ * key, all owned here so views stay valid for the message's lifetime.
+ */
+struct RoutingDescriptor {
+  bool valid{false};
+  /** static string naming the validation failure; nullptr when valid */
+  const char* invalidReason{nullptr};
+  /** dot-segments resolved; empty for non-path requests (CONNECT) */
+  std::string normalizedPath;
+  /** authority/Host, lowercased, port stripped */
+  std::string host;
+  /** value extracted per RouteKeySource config */
+  std::string routeKey;
+};
+
+/**
+ * Fused ingress validation/normalization/route-key stage.
+ *
+ * A request used to be scanned once by the codec's verifier, again by
+ * handler-level URL normalization, and a third time by router key
+ * extraction.  process() makes one pass over the URL at
+ * onHeadersComplete time - charset validation, dot-segment resolution
+ * and prefix tracking happen in the same loop - plus one pass over
+ * the host, and leaves the results on the message as a
+ * RoutingDescriptor.  Configure what the route key is (leading path
+ * segments, the host, or a named header); routers then key off a
+ * precomputed string instead of re-parsing.
+ *
+ * Wire it through HTTPServerOptions::requestPipeline (the acceptor
+ * runs it before building the handler chain and answers 400 for
+ * invalid requests without one), or call process() directly from a
+ * custom framework at the same point.  Stateless and shared across
+ * workers.
+ */
+class RequestPipeline {
+ public:
+  enum class RouteKeySource : uint8_t {
+    PathPrefix = 0,
+    Host,
+    Header,
+  };
+
+  struct Config {
+    RouteKeySource source{RouteKeySource::PathPrefix};
+    /** leading segments in the key: 1 maps /api/v2/x to /api */
+    size_t pathPrefixSegments{1};
+    /** header whose value becomes the key (source == Header) */
+    std::string headerName;
+  };
+
+  explicit RequestPipeline(Config config) : config_(std::move(config)) {
+  }
+
+  /**
+   * One pass: validate, normalize and extract, attaching a
+   * RoutingDescriptor to the message.  Returns descriptor.valid.
+   */
+  bool process(HTTPMessage& msg) const;
+
+ private:
+  Config config_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/ResolvingHTTPConnector.h>
+
+#include <folly/executors/GlobalExecutor.h>
+#include <folly/io/async/AsyncSocketException.h>
+#include <glog/logging.h>
+#include <netdb.h>
+
+namespace proxygen {
+
+namespace {
+
+// blocking; runs on the CPU executor, never on a worker loop
+void resolveBlocking(const std::string& host,
+                     std::vector<folly::SocketAddress>& addresses,
+                     std::string& error) {
+  struct addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  struct addrinfo* results = nullptr;
+  auto rc = ::getaddrinfo(host.c_str(), nullptr, &hints, &results);
+  if (rc != 0) {
+    error = ::gai_strerror(rc);
+    return;
+  }
+  for (auto* ai = results; ai != nullptr; ai = ai->ai_next) {
+    folly::SocketAddress address;
+    try {
+      address.setFromSockaddr(ai->ai_addr, ai->ai_addrlen);
+      addresses.push_back(address);
+    } catch (const std::exception&) {
+      // skip unrepresentable families
+    }
+  }
+  ::freeaddrinfo(results);
+  if (addresses.empty()) {
+    error = "no usable addresses";
+  }
+}
+
+} // anonymous namespace
+
+void WorkerDNSCache::resolve(const std::string& host,
+                             uint16_t port,
+                             ResolveCallback cb) {
+  auto& entry = entries_[host];
+  auto now = getCachedNow();
+  const bool fresh = timePointInitialized(entry.expiry) && now < entry.expiry;
+  if (fresh) {
+    // hot path: kick any due background refresh first - the callback
+    // may re-enter and rehash entries_, invalidating the reference
+    if (now >= entry.refreshAt && !entry.resolving) {
+      startResolve(host, entry);
+    }
+    answer(entry, port, cb);
+    return;
+  }
+  entry.waiters.push_back(Entry::Waiter{port, std::move(cb)});
+  if (!entry.resolving) {
+    startResolve(host, entry);
+  }
+}
+
+void WorkerDNSCache::answer(Entry& entry,
+                            uint16_t port,
+                            ResolveCallback& cb) {
+  // finish all entry access before invoking the callback: it may
+  // resolve other names and rehash entries_ under the reference
+  folly::Optional<folly::SocketAddress> address;
+  std::string error;
+  if (entry.addresses.empty()) {
+    error = entry.error;
+  } else {
+    // rotate through the resolved set so load spreads across servers
+    address = entry.addresses[entry.rotation++ % entry.addresses.size()];
+    address->setPort(port);
+  }
+  cb(address, error);
+}
+
+void WorkerDNSCache::startResolve(const std::string& host, Entry& entry) {
+  entry.resolving = true;
+  auto self = shared_from_this();
+  folly::getCPUExecutor()->add([self, host] {
+    std::vector<folly::SocketAddress> addresses;
+    std::string error;
+    resolveBlocking(host, addresses, error);
+    self->evb_->runInEventBaseThread(
+        [self, host, addresses = std::move(addresses),
+         error = std::move(error)]() mutable {
+          self->onResolved(host, std::move(addresses), std::move(error));
+        });
+  });
+}
+
+void WorkerDNSCache::onResolved(const std::string& host,
+                                std::vector<folly::SocketAddress> addresses,
+                                std::string error) {
+  auto it = entries_.find(host);
+  if (it == entries_.end()) {
+    return;
+  }
+  auto& entry = it->second;
+  entry.resolving = false;
+  auto now = getCachedNow();
+  if (!addresses.empty()) {
+    entry.addresses = std::move(addresses);
+    entry.error.clear();
+    entry.expiry = now + options_.positiveTtl;
+    entry.refreshAt =
+        now + std::chrono::milliseconds(int64_t(
+                  std::chrono::milliseconds(options_.positiveTtl).count() *
+                  options_.refreshFraction));
+  } else if (entry.addresses.empty()) {
+    // negative result with nothing cached: cache the failure briefly
+    entry.error = std::move(error);
+    entry.expiry = now + options_.negativeTtl;
+    entry.refreshAt = entry.expiry;
+  } else {
+    // refresh failed but a previous positive result exists: serve it
+    // until its own expiry and try refreshing again next lookup
+    entry.refreshAt = now;
+  }
+  auto waiters = std::move(entry.waiters);
+  entry.waiters.clear();
+  for (auto& waiter : waiters) {
+    // re-find per iteration: a waiter's callback may mutate entries_
+    auto current = entries_.find(host);
+    if (current == entries_.end()) {
+      break;
+    }
+    answer(current->second, waiter.port, waiter.callback);
+  }
+}
+
+void ResolvingHTTPConnector::connect(
+    folly::EventBase* evb,
+    const std::string& host,
+    uint16_t port,
+    std::chrono::milliseconds timeoutMs,
+    const folly::AsyncSocket::OptionMap& socketOptions) {
+  // deleting the connector cancels, matching HTTPConnector's contract;
+  // a pending resolution checks the token before touching us
+  std::weak_ptr<bool> alive = alive_;
+  dnsCache_->resolve(
+      host,
+      port,
+      [this, alive, evb, timeoutMs, socketOptions](
+          folly::Optional<folly::SocketAddress> address,
+          const std::string& error) {
+        if (alive.expired()) {
+          return; // the connector is gone; drop the result
+        }
+        if (!address) {
+          folly::AsyncSocketException ex(
+              folly::AsyncSocketException::NOT_OPEN,
+              "DNS resolution failed: " + error);
+          callback_->connectError(ex);
+          return;
+        }
+        connector_.connect(evb, *address, timeoutMs, socketOptions);
+      });
+}
+
+} // namespace proxygen
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <folly/Function.h>
+#include <folly/SocketAddress.h>
+#include <folly/io/async/EventBase.h>
+#include <memory>
+#include <proxygen/lib/http/HTTPConnector.h>
+#include <proxygen/lib/utils/Time.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Per-worker DNS cache.  resolve() is non-blocking: cache-hot names
+ * answer synchronously (rotating through the resolved addresses),
+ * misses queue the callback while one blocking getaddrinfo runs on
+ * the global CPU executor and posts back to the worker's event base.
+ * Positive and negative results are cached with separate TTLs, and a
+ * fresh entry is refreshed in the background once it passes the
+ * refresh horizon, so steady-state lookups of a hot origin never wait
+ * on the resolver.
+ *
+ * Single-threaded per worker; create via create() and keep in a
+ * shared_ptr so in-flight background resolutions can't outlive it
+ * unsafely.
+ */
+class WorkerDNSCache : public std::enable_shared_from_this<WorkerDNSCache> {
+ public:
+  struct Options {
+    Options() = default;
+    std::chrono::seconds positiveTtl{60};
+    std::chrono::seconds negativeTtl{5};
+    // refresh a hot entry once this fraction of its TTL has elapsed
+    double refreshFraction = 0.75;
+  };
+
+  using ResolveCallback =
+      folly::Function<void(folly::Optional<folly::SocketAddress> address,
+                           const std::string& error)>;
+
+  static std::shared_ptr<WorkerDNSCache> create(folly::EventBase* evb,
+                                                Options options = Options()) {
+    return std::shared_ptr<WorkerDNSCache>(new WorkerDNSCache(evb, options));
+  }
+
+  /**
+   * Resolve host:port.  Cache-hot names invoke the callback before
+   * returning; otherwise it runs later on the event base.  On failure
+   * the address is none and error describes the resolution failure.
+   */
+  void resolve(const std::string& host, uint16_t port, ResolveCallback cb);
+
+  size_t numEntries() const {
+    return entries_.size();
+  }
+
+ private:
+  WorkerDNSCache(folly::EventBase* evb, Options options)
+      : evb_(evb), options_(options) {
+  }
+
+  struct Entry {
+    std::vector<folly::SocketAddress> addresses; // port 0; set per resolve
+    std::string error;
+    TimePoint expiry{};
+    TimePoint refreshAt{};
+    bool resolving{false};
+    uint32_t rotation{0};
+    struct Waiter {
+      uint16_t port;
+      ResolveCallback callback;
+    };
+    std::vector<Waiter> waiters;
+  };
+
+  void answer(Entry& entry, uint16_t port, ResolveCallback& cb);
+  void startResolve(const std::string& host, Entry& entry);
+  void onResolved(const std::string& host,
+                  std::vector<folly::SocketAddress> addresses,
+                  std::string error);
+
+  folly::EventBase* evb_;
+  Options options_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+/**
+ * HTTPConnector layered over the worker's DNS cache: connect() by
+ * hostname without blocking the loop.  Resolution errors surface as
+ * connectError on the callback, like any other connect failure.
+ */
+class ResolvingHTTPConnector {
+ public:
+  ResolvingHTTPConnector(HTTPConnector::Callback* callback,
+                         WheelTimerInstance timeout,
+                         std::shared_ptr<WorkerDNSCache> dnsCache)
+      : connector_(callback, timeout),
+        callback_(callback),
+        dnsCache_(std::move(dnsCache)) {
+  }
+
+  void connect(folly::EventBase* evb,
+               const std::string& host,
+               uint16_t port,
+               std::chrono::milliseconds timeoutMs,
+               const folly::AsyncSocket::OptionMap& socketOptions =
+                   folly::AsyncSocket::emptyOptionMap);
+
+  HTTPConnector& getConnector() {
+    return connector_;
+  }
+
+ private:
+  HTTPConnector connector_;
+  HTTPConnector::Callback* callback_;
+  std::shared_ptr<WorkerDNSCache> dnsCache_;
+  // liveness token for pending resolutions; see connect()
+  std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+};
+
+} // namespace proxygen
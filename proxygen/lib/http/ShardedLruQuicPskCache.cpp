@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/ShardedLruQuicPskCache.h>
+
+#include <algorithm>
+
+namespace proxygen {
+
+ShardedLruQuicPskCache::ShardedLruQuicPskCache(uint64_t mapMax,
+                                               size_t numShards) {
+  numShards = std::max<size_t>(numShards, 1);
+  const uint64_t perShard = std::max<uint64_t>(mapMax / numShards, 1);
+  shards_.reserve(numShards);
+  for (size_t i = 0; i < numShards; i++) {
+    shards_.push_back(
+        std::make_unique<folly::Synchronized<EvictingPskMap>>(
+            EvictingPskMap(perShard)));
+  }
+}
+
+folly::Optional<quic::QuicCachedPsk> ShardedLruQuicPskCache::getPsk(
+    const std::string& identity) {
+  auto cache = shardFor(identity).wlock();
+  auto it = cache->find(identity);
+  if (it != cache->end()) {
+    return it->second;
+  }
+  return folly::none;
+}
+
+void ShardedLruQuicPskCache::putPsk(const std::string& identity,
+                                    quic::QuicCachedPsk psk) {
+  auto cache = shardFor(identity).wlock();
+  cache->set(identity, std::move(psk));
+}
+
+void ShardedLruQuicPskCache::removePsk(const std::string& identity) {
+  auto cache = shardFor(identity).wlock();
+  cache->erase(identity);
+}
+
+} // namespace proxygen
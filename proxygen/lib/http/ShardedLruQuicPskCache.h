@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/container/EvictingCacheMap.h>
+#include <folly/hash/Hash.h>
+#include <quic/client/handshake/QuicPskCache.h>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Drop-in replacement for SynchronizedLruQuicPskCache that shards the
+ * LRU across independently locked maps keyed by identity hash, so
+ * resumption lookups from many threads contend on 1/N of the lock
+ * instead of a single mutex. LRU eviction is per shard, which bounds
+ * the total at mapMax entries with at most shard-sized skew.
+ */
+class ShardedLruQuicPskCache : public quic::QuicPskCache {
+ public:
+  static constexpr size_t kDefaultShards = 16;
+
+  ~ShardedLruQuicPskCache() override = default;
+
+  explicit ShardedLruQuicPskCache(uint64_t mapMax,
+                                  size_t numShards = kDefaultShards);
+
+  folly::Optional<quic::QuicCachedPsk> getPsk(
+      const std::string& identity) override;
+
+  void putPsk(const std::string& identity, quic::QuicCachedPsk psk) override;
+
+  void removePsk(const std::string& identity) override;
+
+ private:
+  using EvictingPskMap =
+      folly::EvictingCacheMap<std::string, quic::QuicCachedPsk>;
+
+  folly::Synchronized<EvictingPskMap>& shardFor(const std::string& identity) {
+    return *shards_[folly::hash::fnv64(identity) % shards_.size()];
+  }
+
+  std::vector<std::unique_ptr<folly::Synchronized<EvictingPskMap>>> shards_;
+};
+
+} // namespace proxygen
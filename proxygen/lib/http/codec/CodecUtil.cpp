@@ -122,7 +122,7 @@ void CodecUtil::prepareMessageForCompression(
       appendHeaders(msg.getHeaders(), allHeaders, HTTP_HEADER_DATE);
 
   if (addDateToResponse && msg.isResponse() && !hasDateHeader) {
-    temps.emplace_back(HTTPMessage::formatDateHeader());
+    temps.emplace_back(HTTPMessage::getDateHeader());
     allHeaders.emplace_back(HTTP_HEADER_DATE, temps.back());
   }
 }
@@ -47,8 +47,33 @@ class CodecUtil {
     if (name.size() == 0) {
       return false;
     }
-    for (auto p: name) {
-      if (p < 0x80 && http_tokens[(uint8_t)p] != p) {
+    const uint8_t* p = name.begin();
+    const uint8_t* end = name.end();
+    // bulk path: classify 32 bytes per branch against the token table;
+    // the fixed-count accumulation loops vectorize on any SIMD width
+    // the compiler has available
+    while (p + 32 <= end) {
+      bool ok = true;
+      for (int i = 0; i < 32; i++) {
+        ok &= (p[i] >= 0x80) || (http_tokens[p[i]] == p[i]);
+      }
+      if (!ok) {
+        return false;
+      }
+      p += 32;
+    }
+    while (p + 8 <= end) {
+      bool ok = true;
+      for (int i = 0; i < 8; i++) {
+        ok &= (p[i] >= 0x80) || (http_tokens[p[i]] == p[i]);
+      }
+      if (!ok) {
+        return false;
+      }
+      p += 8;
+    }
+    for (; p != end; ++p) {
+      if (*p < 0x80 && http_tokens[*p] != *p) {
         return false;
       }
     }
@@ -75,7 +100,36 @@ class CodecUtil {
            lws_expect_ws1,
            lws_expect_ws2 } state = lws_none;
 
-    for (auto p = std::begin(value); p != std::end(value); ++p) {
+    const uint8_t* valueEnd = std::end(value);
+    for (auto p = std::begin(value); p != valueEnd; ++p) {
+      if (!escape && !quote && state == lws_none) {
+        // bulk path: skip runs of plain text; only CTLs, DEL, quotes and
+        // backslashes need the state machine.  32 bytes per branch
+        // first, then word-at-a-time to locate the interesting byte
+        auto classify = [](uint64_t w) {
+          return swar::bytesLessThan(w, 0x20) | swar::bytesEqual(w, 0x7f) |
+                 swar::bytesEqual(w, '\"') | swar::bytesEqual(w, '\\');
+        };
+        while (p + 4 * sizeof(uint64_t) <= valueEnd) {
+          uint64_t mask = classify(folly::loadUnaligned<uint64_t>(p));
+          mask |= classify(folly::loadUnaligned<uint64_t>(p + 8));
+          mask |= classify(folly::loadUnaligned<uint64_t>(p + 16));
+          mask |= classify(folly::loadUnaligned<uint64_t>(p + 24));
+          if (mask != 0) {
+            break;
+          }
+          p += 4 * sizeof(uint64_t);
+        }
+        while (p + sizeof(uint64_t) <= valueEnd) {
+          if (classify(folly::loadUnaligned<uint64_t>(p)) != 0) {
+            break;
+          }
+          p += sizeof(uint64_t);
+        }
+        if (p == valueEnd) {
+          break;
+        }
+      }
       if (escape) {
         escape = false;
         if (mode == COMPLIANT) {
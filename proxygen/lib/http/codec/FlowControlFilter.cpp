@@ -8,6 +8,8 @@
 
 #include <proxygen/lib/http/codec/FlowControlFilter.h>
 
+#include <algorithm>
+
 namespace proxygen {
 
 namespace {
@@ -68,14 +70,37 @@ void FlowControlFilter::setReceiveWindowSize(folly::IOBufQueue& writeBuf,
 bool FlowControlFilter::ingressBytesProcessed(folly::IOBufQueue& writeBuf,
                                               uint32_t delta) {
   toAck_ += delta;
-  bool willAck = (toAck_ > 0 &&
-                  uint32_t(toAck_) > recvWindow_.getCapacity() / 2);
+  uint32_t ackNow = 0;
+  if (toAck_ > 0) {
+    const auto capacity = recvWindow_.getCapacity();
+    switch (strategy_) {
+      case UpdateStrategy::HALF_DRAIN:
+        if (uint32_t(toAck_) > capacity / 2) {
+          ackNow = toAck_;
+        }
+        break;
+      case UpdateStrategy::QUARTER_QUANTIZED: {
+        // acknowledge only whole quarter-capacity quanta; the
+        // remainder waits for the next quantum boundary
+        const uint32_t quantum = std::max<uint32_t>(capacity / 4, 1);
+        if (uint32_t(toAck_) >= quantum) {
+          ackNow = uint32_t(toAck_) - (uint32_t(toAck_) % quantum);
+        }
+        break;
+      }
+      case UpdateStrategy::RECEIVER_PACED:
+        // release window at the receiver's cadence; see
+        // setUpdateStrategy
+        ackNow = std::min<uint32_t>(toAck_, pacedAckLimit_);
+        break;
+    }
+  }
   VLOG(4) << "processed " << delta << " toAck_=" << toAck_
-          << " bytes, will ack=" << willAck;
-  if (willAck) {
-    CHECK(recvWindow_.free(toAck_));
-    call_->generateWindowUpdate(writeBuf, 0, toAck_);
-    toAck_ = 0;
+          << " bytes, will ack=" << ackNow;
+  if (ackNow > 0) {
+    CHECK(recvWindow_.free(ackNow));
+    call_->generateWindowUpdate(writeBuf, 0, ackNow);
+    toAck_ -= ackNow;
     return true;
   }
   return false;
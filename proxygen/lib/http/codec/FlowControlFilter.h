@@ -22,7 +22,7 @@ namespace proxygen {
  * control. Not every codec is interested in per-session flow control, so
  * this filter can only be added in that case or else it is an error.
  */
-class FlowControlFilter:
+class FlowControlFilter final :
       public PassThroughHTTPCodecFilter {
  public:
   class Callback {
@@ -63,6 +63,34 @@ class FlowControlFilter:
    */
   void setReceiveWindowSize(folly::IOBufQueue& writeBuf, uint32_t capacity);
 
+  /**
+   * Connection window update policy.  HALF_DRAIN is the historical
+   * behavior: one update when more than half the capacity has drained.
+   * QUARTER_QUANTIZED acknowledges only in quarter-capacity multiples,
+   * so update frames come in at most four predictable sizes and
+   * sub-quantum drains generate no frame at all.  RECEIVER_PACED
+   * releases at most pacedAckLimit bytes of window per
+   * ingressBytesProcessed call, turning acknowledgment into an upload
+   * pacing valve: the sender's rate follows the receiver's processing
+   * cadence instead of bursting on each large update.
+   *
+   * Stream-level updates already piggyback onto scheduled egress
+   * flushes via the codec's control-frame coalescing.
+   */
+  enum class UpdateStrategy : uint8_t {
+    HALF_DRAIN = 0,
+    QUARTER_QUANTIZED,
+    RECEIVER_PACED,
+  };
+
+  void setUpdateStrategy(UpdateStrategy strategy,
+                         uint32_t pacedAckLimit = 0) {
+    CHECK(strategy != UpdateStrategy::RECEIVER_PACED || pacedAckLimit > 0)
+        << "a zero pace would never reopen the window";
+    strategy_ = strategy;
+    pacedAckLimit_ = pacedAckLimit;
+  }
+
   /**
    * Notify the flow control filter that some ingress bytes were
    * processed. If the number of bytes to acknowledge exceeds half the
@@ -112,6 +140,8 @@ class FlowControlFilter:
   Window recvWindow_;
   Window sendWindow_;
   int32_t toAck_{0};
+  UpdateStrategy strategy_{UpdateStrategy::HALF_DRAIN};
+  uint32_t pacedAckLimit_{0};
   bool error_:1;
   bool sendsBlocked_:1;
 };
@@ -201,10 +201,10 @@ ParseResult HQStreamCodec::parsePushPromise(Cursor& cursor,
 }
 
 void HQStreamCodec::onHeader(const HPACKHeaderName& name,
-                             const folly::fbstring& value) {
+                             folly::StringPiece value) {
   if (decodeInfo_.onHeader(name, value)) {
     if (userAgent_.empty() && name.getHeaderCode() == HTTP_HEADER_USER_AGENT) {
-      userAgent_ = value.toStdString();
+      userAgent_ = value.str();
     }
   } else {
     VLOG(4) << "dir=" << uint32_t(transportDirection_)
@@ -515,8 +515,25 @@ void HQStreamCodec::generateHeaderImpl(folly::IOBufQueue& writeBuf,
   temps.clear();
   allHeaders.clear();
   CodecUtil::prepareMessageForCompression(msg, allHeaders, temps);
-  auto result =
-      headerCodec_.encode(allHeaders, streamId_, maxEncoderStreamData());
+  QPACKEncoder::EncodeResult result{nullptr, nullptr};
+  if (incrementalEncodeBytes_ > 0) {
+    // Compress in bounded chunks, flushing encoder stream instructions
+    // as they are produced; the HEADERS frame itself is still written
+    // in one piece below because HTTP/3 length-prefixes it.
+    headerCodec_.startEncode(allHeaders, streamId_, maxEncoderStreamData());
+    bool done = false;
+    while (!done) {
+      auto chunk = headerCodec_.encodeNext(incrementalEncodeBytes_, &done);
+      if (chunk.control) {
+        qpackEncoderWriteBuf_.append(std::move(chunk.control));
+      }
+      if (done) {
+        result.stream = std::move(chunk.stream);
+      }
+    }
+  } else {
+    result = headerCodec_.encode(allHeaders, streamId_, maxEncoderStreamData());
+  }
   if (size) {
     *size = headerCodec_.getEncodedSize();
   }
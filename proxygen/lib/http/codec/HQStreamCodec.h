@@ -156,7 +156,7 @@ class HQStreamCodec
   CompressionInfo getCompressionInfo() const override;
 
   void onHeader(const HPACKHeaderName& name,
-                const folly::fbstring& value) override;
+                folly::StringPiece value) override;
   void onHeadersComplete(HTTPHeaderSize decodedSize, bool acknowledge) override;
   void onDecodeError(HPACK::DecodeError decodeError) override;
 
@@ -206,6 +206,15 @@ class HQStreamCodec
                           folly::Optional<StreamID> pushId,
                           HTTPHeaderSize* size);
 
+  /**
+   * When non-zero, generateHeader compresses the block incrementally in
+   * chunks of roughly this many bytes instead of one shot, bounding the
+   * encoder's working set for very large header lists.
+   */
+  void setIncrementalEncodeBytes(uint32_t bytes) {
+    incrementalEncodeBytes_ = bytes;
+  }
+
   uint64_t maxEncoderStreamData() {
     auto maxData = qpackEncoderMaxDataFn_();
     if (qpackEncoderWriteBuf_.chainLength() >= maxData) {
@@ -227,6 +236,13 @@ class HQStreamCodec
   std::string userAgent_;
   HeaderDecodeInfo decodeInfo_;
   QPACKCodec& headerCodec_;
+  uint32_t incrementalEncodeBytes_{0};
+
+  // Encoder-stream output is already flush-coalesced: every block's
+  // instructions append here, this queue is the QPACK encoder control
+  // stream's write buffer, and the session drains control streams once
+  // per write loop (writeControlStreams) - one QUIC write per loop
+  // regardless of how many header blocks produced instructions.
   folly::IOBufQueue& qpackEncoderWriteBuf_;
   folly::IOBufQueue& qpackDecoderWriteBuf_;
   folly::Function<uint64_t()> qpackEncoderMaxDataFn_;
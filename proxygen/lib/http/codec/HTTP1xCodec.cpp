@@ -8,6 +8,10 @@
 
 #include <proxygen/lib/http/codec/HTTP1xCodec.h>
 
+#include <proxygen/external/http_parser/http_parser.h>
+
+#include <array>
+#include <folly/Bits.h>
 #include <folly/Memory.h>
 #include <folly/Random.h>
 #include <folly/ssl/OpenSSLHash.h>
@@ -56,6 +60,66 @@ unsigned u64toa(uint64_t value, void* dst) {
   return length;
 }
 
+// Longest chunk size line: 16 hex digits plus CRLF
+constexpr size_t kMaxChunkHeaderLen = 18;
+
+/**
+ * Write a chunk size line ("<hex>\r\n") for the given length.
+ * @note This function does -not- append a trailing null byte.
+ * @param dst     Location to which the line will be written; must have
+ *                kMaxChunkHeaderLen bytes available.
+ * @param length  Chunk length; zero (reachable through
+ *                sendChunkHeader(0), however ill-advised) encodes as
+ *                "0\r\n" like the old snprintf path did.
+ * @return Number of bytes written.
+ *
+ * Power-of-two lengths - the fixed buffer quanta nearly all streaming
+ * handlers emit - hit a table of lines precomputed on first use.
+ * Everything else takes a branch-free encode: the digit count comes
+ * from the top set bit, then each nibble is a fixed shift-and-index
+ * store, with no per-digit leading-zero tests and no snprintf format
+ * machinery.
+ */
+size_t encodeChunkHeader(char* dst, size_t length) {
+  struct ChunkHeader {
+    // +1 leaves snprintf room for its terminating null on the
+    // longest (16-digit) entry
+    char bytes[kMaxChunkHeaderLen + 1];
+    uint8_t len;
+  };
+  static const std::array<ChunkHeader, 64> powerOfTwoHeaders = [] {
+    std::array<ChunkHeader, 64> table{};
+    for (uint32_t i = 0; i < 64; i++) {
+      int rc = snprintf(table[i].bytes,
+                        sizeof(table[i].bytes),
+                        "%zx\r\n",
+                        size_t(1) << i);
+      table[i].len = uint8_t(rc);
+    }
+    return table;
+  }();
+
+  if (length == 0) {
+    // not a real chunk (that's the EOM terminator's job), but don't
+    // let it underflow the table index below
+    memcpy(dst, "0\r\n", 3);
+    return 3;
+  }
+  if ((length & (length - 1)) == 0) {
+    const auto& header = powerOfTwoHeaders[folly::findLastSet(length) - 1];
+    memcpy(dst, header.bytes, header.len);
+    return header.len;
+  }
+  static const char hexDigits[] = "0123456789abcdef";
+  size_t digits = (folly::findLastSet(length) + 3) / 4;
+  for (size_t i = 0; i < digits; i++) {
+    dst[i] = hexDigits[(length >> ((digits - 1 - i) * 4)) & 0xf];
+  }
+  dst[digits] = '\r';
+  dst[digits + 1] = '\n';
+  return digits + 2;
+}
+
 void
 appendUint(IOBufQueue& queue, size_t& len, uint64_t value) {
   char buf[32];
@@ -77,6 +141,188 @@ appendString(IOBufQueue& queue, size_t& len, StringPiece str) {
 
 namespace proxygen {
 
+namespace {
+
+/**
+ * Default parser backend: the vendored callback-per-byte http_parser.
+ * Listener exceptions stop the parse and surface through the codec's
+ * onParserError, as the old codec-embedded trampolines did.
+ */
+class VendoredHTTP1xParser : public HTTP1xParser {
+ public:
+  explicit VendoredHTTP1xParser(HTTP1xParserListener& listener)
+      : listener_(listener) {
+    parser_.data = this;
+  }
+
+  void init(bool parseRequests) override {
+    http_parser_init(&parser_, parseRequests ? HTTP_REQUEST : HTTP_RESPONSE);
+    parser_.data = this;
+  }
+
+  size_t execute(const char* data, size_t len) override {
+    return http_parser_execute(&parser_, getSettings(), data, len);
+  }
+
+  void setPaused(bool paused) override {
+    if (paused) {
+      if (HTTP_PARSER_ERRNO(&parser_) == HPE_OK) {
+        http_parser_pause(&parser_, 1);
+      }
+    } else {
+      http_parser_pause(&parser_, 0);
+    }
+  }
+
+  bool paused() const override {
+    return HTTP_PARSER_ERRNO(&parser_) == HPE_PAUSED;
+  }
+
+  Error error() const override {
+    // see http_parser.h for what these error codes mean
+    auto parserErrno = HTTP_PARSER_ERRNO(&parser_);
+    if (parserErrno == HPE_OK) {
+      return Error::NONE;
+    } else if (parserErrno == HPE_PAUSED) {
+      return Error::PAUSED;
+    } else if (parserErrno == HPE_INVALID_EOF_STATE) {
+      return Error::EOF_STATE;
+    } else if (parserErrno == HPE_HEADER_OVERFLOW ||
+               parserErrno == HPE_INVALID_CONSTANT ||
+               (parserErrno >= HPE_INVALID_VERSION &&
+                parserErrno <= HPE_HUGE_CONTENT_LENGTH)) {
+      return Error::HEADERS;
+    } else if (parserErrno == HPE_INVALID_CHUNK_SIZE ||
+               parserErrno == HPE_HUGE_CHUNK_SIZE) {
+      return Error::CHUNK;
+    }
+    return Error::OTHER;
+  }
+
+  std::string errorDescription() const override {
+    return http_errno_description(HTTP_PARSER_ERRNO(&parser_));
+  }
+
+  uint16_t statusCode() const override {
+    return parser_.status_code;
+  }
+
+  uint8_t httpMajor() const override {
+    return parser_.http_major;
+  }
+
+  uint8_t httpMinor() const override {
+    return parser_.http_minor;
+  }
+
+  const char* methodString() const override {
+    return http_method_str(static_cast<http_method>(parser_.method));
+  }
+
+  bool isChunked() const override {
+    return parser_.flags & F_CHUNKED;
+  }
+
+  bool isUpgrade() const override {
+    return parser_.upgrade || (parser_.flags & F_UPGRADE);
+  }
+
+  void setHttpVersion(uint8_t major, uint8_t minor) override {
+    parser_.http_major = major;
+    parser_.http_minor = minor;
+  }
+
+  void setStatusCode(uint16_t statusCode) override {
+    parser_.status_code = statusCode;
+  }
+
+  void clearUpgrade() override {
+    parser_.upgrade = false;
+    parser_.flags &= ~F_UPGRADE;
+  }
+
+ private:
+  static VendoredHTTP1xParser& self(http_parser* parser) {
+    return *CHECK_NOTNULL(static_cast<VendoredHTTP1xParser*>(parser->data));
+  }
+
+  template <typename F>
+  static int guarded(http_parser* parser, int errorReturn, F&& callback) {
+    auto& backend = self(parser);
+    try {
+      return callback(backend.listener_);
+    } catch (const std::exception& ex) {
+      backend.pendingError_ = ex.what();
+      backend.listener_.onParserError(backend.pendingError_.c_str());
+      return errorReturn;
+    }
+  }
+
+  static const http_parser_settings* getSettings() {
+    static http_parser_settings parserSettings = [] {
+      http_parser_settings st;
+      st.on_message_begin = [](http_parser* p) {
+        return guarded(
+            p, 1, [](HTTP1xParserListener& l) { return l.onMessageBegin(); });
+      };
+      st.on_url = [](http_parser* p, const char* buf, size_t len) {
+        return guarded(p, 1, [&](HTTP1xParserListener& l) {
+          return l.onURL(buf, len);
+        });
+      };
+      st.on_reason = [](http_parser* p, const char* buf, size_t len) {
+        return guarded(p, 1, [&](HTTP1xParserListener& l) {
+          return l.onReason(buf, len);
+        });
+      };
+      st.on_header_field = [](http_parser* p, const char* buf, size_t len) {
+        return guarded(p, 1, [&](HTTP1xParserListener& l) {
+          return l.onHeaderField(buf, len);
+        });
+      };
+      st.on_header_value = [](http_parser* p, const char* buf, size_t len) {
+        return guarded(p, 1, [&](HTTP1xParserListener& l) {
+          return l.onHeaderValue(buf, len);
+        });
+      };
+      st.on_headers_complete = [](http_parser* p, const char*, size_t len) {
+        return guarded(p, 3, [&](HTTP1xParserListener& l) {
+          return l.onHeadersComplete(len);
+        });
+      };
+      st.on_body = [](http_parser* p, const char* buf, size_t len) {
+        // Note: http_parser ignores the return value of on_body; the
+        // codec checks for errors after each execute() instead
+        return guarded(p, 1, [&](HTTP1xParserListener& l) {
+          return l.onBody(buf, len);
+        });
+      };
+      st.on_chunk_header = [](http_parser* p) {
+        return guarded(p, 1, [&](HTTP1xParserListener& l) {
+          return l.onChunkHeader(p->content_length);
+        });
+      };
+      st.on_chunk_complete = [](http_parser* p) {
+        return guarded(
+            p, 1, [](HTTP1xParserListener& l) { return l.onChunkComplete(); });
+      };
+      st.on_message_complete = [](http_parser* p) {
+        return guarded(p, 1, [](HTTP1xParserListener& l) {
+          return l.onMessageComplete();
+        });
+      };
+      return st;
+    }();
+    return &parserSettings;
+  }
+
+  HTTP1xParserListener& listener_;
+  http_parser parser_;
+  std::string pendingError_;
+};
+
+} // anonymous namespace
+
 HTTP1xCodec::HTTP1xCodec(TransportDirection direction, bool forceUpstream1_1)
     : callback_(nullptr),
       ingressTxnID_(0),
@@ -108,17 +354,8 @@ HTTP1xCodec::HTTP1xCodec(TransportDirection direction, bool forceUpstream1_1)
       egressUpgrade_(false),
       nativeUpgrade_(false),
       headersComplete_(false) {
-  switch (direction) {
-  case TransportDirection::DOWNSTREAM:
-    http_parser_init(&parser_, HTTP_REQUEST);
-    break;
-  case TransportDirection::UPSTREAM:
-    http_parser_init(&parser_, HTTP_RESPONSE);
-    break;
-  default:
-    LOG(FATAL) << "Unknown transport direction.";
-  }
-  parser_.data = this;
+  parser_ = std::make_unique<VendoredHTTP1xParser>(*this);
+  parser_->init(direction == TransportDirection::DOWNSTREAM);
 }
 
 HTTP1xCodec::~HTTP1xCodec() {
@@ -127,6 +364,61 @@ HTTP1xCodec::~HTTP1xCodec() {
   // error.
 }
 
+void HTTP1xCodec::reset() {
+  // restore every member the constructor initializes; transportDirection_
+  // and forceUpstream1_1_ are construction parameters and survive
+  callback_ = nullptr;
+  ingressTxnID_ = 0;
+  egressTxnID_ = 0;
+  currentIngressBuf_ = nullptr;
+  msg_.reset();
+  upgradeRequest_.reset();
+  trailers_.reset();
+  currentHeaderName_.clear();
+  currentHeaderNameStringPiece_.clear();
+  currentHeaderValue_.clear();
+  url_.clear();
+  userAgent_.clear();
+  reason_.clear();
+  upgradeHeader_.clear();
+  allowedNativeUpgrades_.clear();
+  websockAcceptKey_.clear();
+  headerSize_ = HTTPHeaderSize();
+  headerParseState_ = HeaderParseState::kParsingHeaderIdle;
+  keepaliveRequested_ = KeepaliveRequested::UNSET;
+  upgradeResult_ = std::pair<CodecProtocol, std::string>();
+  parserActive_ = false;
+  pendingEOF_ = false;
+  parserPaused_ = false;
+  parserError_ = false;
+  requestPending_ = false;
+  responsePending_ = false;
+  egressChunked_ = false;
+  inChunk_ = false;
+  lastChunkWritten_ = false;
+  keepalive_ = true;
+  disableKeepalivePending_ = false;
+  connectRequest_ = false;
+  headRequest_ = false;
+  expectNoResponseBody_ = false;
+  mayChunkEgress_ = false;
+  is1xxResponse_ = false;
+  inRecvLastChunk_ = false;
+  ingressUpgrade_ = false;
+  ingressUpgradeComplete_ = false;
+  egressUpgrade_ = false;
+  nativeUpgrade_ = false;
+  headersComplete_ = false;
+  parser_->init(transportDirection_ == TransportDirection::DOWNSTREAM);
+}
+
+void HTTP1xCodec::setParserBackend(std::unique_ptr<HTTP1xParser> parser) {
+  CHECK(!parserActive_ && ingressTxnID_ == 0)
+      << "Backend must be selected before any ingress";
+  parser_ = std::move(parser);
+  parser_->init(transportDirection_ == TransportDirection::DOWNSTREAM);
+}
+
 HTTPCodec::StreamID
 HTTP1xCodec::createStream() {
   if (transportDirection_ == TransportDirection::DOWNSTREAM) {
@@ -140,38 +432,13 @@ void
 HTTP1xCodec::setParserPaused(bool paused) {
   if ((paused == parserPaused_) || parserError_) {
     // If we're bailing early, we better be paused already
-    DCHECK(parserError_ ||
-           (HTTP_PARSER_ERRNO(&parser_) == HPE_PAUSED) == paused);
+    DCHECK(parserError_ || parser_->paused() == paused);
     return;
   }
-  if (paused) {
-    if (HTTP_PARSER_ERRNO(&parser_) == HPE_OK) {
-      http_parser_pause(&parser_, 1);
-    }
-  } else {
-    http_parser_pause(&parser_, 0);
-  }
+  parser_->setPaused(paused);
   parserPaused_ = paused;
 }
 
-const http_parser_settings* HTTP1xCodec::getParserSettings() {
-  static http_parser_settings parserSettings = [] {
-    http_parser_settings st;
-    st.on_message_begin = HTTP1xCodec::onMessageBeginCB;
-    st.on_url = HTTP1xCodec::onUrlCB;
-    st.on_header_field = HTTP1xCodec::onHeaderFieldCB;
-    st.on_header_value = HTTP1xCodec::onHeaderValueCB;
-    st.on_headers_complete = HTTP1xCodec::onHeadersCompleteCB;
-    st.on_body = HTTP1xCodec::onBodyCB;
-    st.on_message_complete = HTTP1xCodec::onMessageCompleteCB;
-    st.on_reason = HTTP1xCodec::onReasonCB;
-    st.on_chunk_header = HTTP1xCodec::onChunkHeaderCB;
-    st.on_chunk_complete = HTTP1xCodec::onChunkCompleteCB;
-    return st;
-  }();
-  return &parserSettings;
-}
-
 size_t
 HTTP1xCodec::onIngress(const IOBuf& buf) {
   if (parserError_) {
@@ -185,29 +452,27 @@ HTTP1xCodec::onIngress(const IOBuf& buf) {
     parserActive_ = true;
     currentIngressBuf_ = &buf;
     if (transportDirection_ == TransportDirection::UPSTREAM &&
-        parser_.http_major == 0 && parser_.http_minor == 9) {
+        parser_->httpMajor() == 0 && parser_->httpMinor() == 9) {
       // HTTP/0.9 responses have no header block, so create a fake 200 response
       // and put the codec in upgrade mode
       onMessageBegin();
-      parser_.status_code = 200;
+      parser_->setStatusCode(200);
       msg_->setStatusCode(200);
       onHeadersComplete(0);
       parserActive_ = false;
       ingressUpgradeComplete_ = true;
       return onIngress(buf);
     }
-    size_t bytesParsed = http_parser_execute(&parser_,
-                                             getParserSettings(),
-                                             (const char*)buf.data(),
-                                             buf.length());
+    size_t bytesParsed =
+        parser_->execute((const char*)buf.data(), buf.length());
     // in case we parsed a section of the headers but we're not done parsing
     // the headers we need to keep accounting of it for total header size
     if (!headersComplete_) {
       headerSize_.uncompressed += bytesParsed;
     }
     parserActive_ = false;
-    parserError_ = (HTTP_PARSER_ERRNO(&parser_) != HPE_OK) &&
-        (HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED);
+    parserError_ = (parser_->error() != HTTP1xParser::Error::NONE) &&
+        (parser_->error() != HTTP1xParser::Error::PAUSED);
     if (parserError_) {
       onParserError();
     }
@@ -241,11 +506,11 @@ HTTP1xCodec::onIngressEOF() {
     return;
   }
   parserActive_ = true;
-  if (http_parser_execute(&parser_, getParserSettings(), nullptr, 0) != 0) {
+  if (parser_->execute(nullptr, 0) != 0) {
     parserError_ = true;
   } else {
-    parserError_ = (HTTP_PARSER_ERRNO(&parser_) != HPE_OK) &&
-        (HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED);
+    parserError_ = (parser_->error() != HTTP1xParser::Error::NONE) &&
+        (parser_->error() != HTTP1xParser::Error::PAUSED);
   }
   parserActive_ = false;
   if (parserError_) {
@@ -256,11 +521,11 @@ HTTP1xCodec::onIngressEOF() {
 void
 HTTP1xCodec::onParserError(const char* what) {
   inRecvLastChunk_ = false;
-  http_errno parser_errno = HTTP_PARSER_ERRNO(&parser_);
+  auto parserError = parser_->error();
   HTTPException error(HTTPException::Direction::INGRESS,
                       what ? what : folly::to<std::string>(
                         "Error parsing message: ",
-                        http_errno_description(parser_errno)
+                        parser_->errorDescription()
                       ));
   // generate a string of parsed headers so that we can pass it to callback
   if (msg_) {
@@ -274,16 +539,12 @@ HTTP1xCodec::onParserError(const char* what) {
       egressTxnID_ < ingressTxnID_) {
     error.setHttpStatusCode(400);
   } // else we've already egressed a response for this txn, don't attempt a 400
-  // See http_parser.h for what these error codes mean
-  if (parser_errno == HPE_INVALID_EOF_STATE) {
+  // see HTTP1xParser::Error for the classification
+  if (parserError == HTTP1xParser::Error::EOF_STATE) {
     error.setProxygenError(kErrorEOF);
-  } else if (parser_errno == HPE_HEADER_OVERFLOW ||
-             parser_errno == HPE_INVALID_CONSTANT ||
-             (parser_errno >= HPE_INVALID_VERSION &&
-              parser_errno <= HPE_HUGE_CONTENT_LENGTH)) {
+  } else if (parserError == HTTP1xParser::Error::HEADERS) {
     error.setProxygenError(kErrorParseHeader);
-  } else if (parser_errno == HPE_INVALID_CHUNK_SIZE ||
-             parser_errno == HPE_HUGE_CHUNK_SIZE) {
+  } else if (parserError == HTTP1xParser::Error::CHUNK) {
     error.setProxygenError(kErrorParseBody);
   } else {
     error.setProxygenError(kErrorUnknown);
@@ -305,7 +566,7 @@ HTTP1xCodec::isBusy() const {
 void
 HTTP1xCodec::addDateHeader(IOBufQueue& writeBuf, size_t& len) {
   appendLiteral(writeBuf, len, "Date: ");
-  appendString(writeBuf, len, HTTPMessage::formatDateHeader());
+  appendString(writeBuf, len, HTTPMessage::getDateHeader());
   appendLiteral(writeBuf, len, CRLF);
 }
 
@@ -497,8 +758,7 @@ HTTP1xCodec::generateHeader(IOBufQueue& writeBuf,
   }
   egressChunked_ &= mayChunkEgress_;
   if (version == HTTPMessage::kHTTPVersion09) {
-    parser_.http_major = 0;
-    parser_.http_minor = 9;
+    parser_->setHttpVersion(0, 9);
     return;
   }
   const string* deferredContentLength = nullptr;
@@ -656,6 +916,98 @@ HTTP1xCodec::generateHeader(IOBufQueue& writeBuf,
   }
 }
 
+std::unique_ptr<HTTP1xCodec::HeaderTemplate>
+HTTP1xCodec::createHeaderTemplate(const HTTPMessage& msg) const {
+  if (transportDirection_ != TransportDirection::DOWNSTREAM ||
+      msg.is1xxResponse() || msg.isEgressWebsocketUpgrade() ||
+      msg.getIsChunked() || !msg.wantsKeepalive() ||
+      msg.getHTTPVersion() != HTTPMessage::kHTTPVersion11) {
+    return nullptr;
+  }
+  const auto& headers = msg.getHeaders();
+  if (headers.exists(HTTP_HEADER_CONNECTION) ||
+      headers.exists(HTTP_HEADER_CONTENT_LENGTH) ||
+      headers.exists(HTTP_HEADER_DATE) ||
+      headers.exists(HTTP_HEADER_UPGRADE) ||
+      headers.exists(HTTP_HEADER_TRANSFER_ENCODING)) {
+    return nullptr;
+  }
+  auto tmpl = std::make_unique<HeaderTemplate>();
+  tmpl->statusCode = msg.getStatusCode();
+  IOBufQueue queue(IOBufQueue::cacheChainLength());
+  size_t len = 0;
+  appendLiteral(queue, len, "HTTP/1.1 ");
+  appendUint(queue, len, tmpl->statusCode);
+  appendLiteral(queue, len, " ");
+  appendString(queue, len, msg.getStatusMessage());
+  appendLiteral(queue, len, CRLF);
+  headers.forEach([&] (const string& header, const string& value) {
+    appendString(queue, len, header);
+    appendLiteral(queue, len, ": ");
+    appendString(queue, len, value);
+    appendLiteral(queue, len, CRLF);
+  });
+  tmpl->prefixLen = len;
+  tmpl->prefix = queue.move();
+  return tmpl;
+}
+
+void HTTP1xCodec::generateCachedHeader(IOBufQueue& writeBuf,
+                                       StreamID txn,
+                                       const HeaderTemplate& tmpl,
+                                       uint64_t contentLength,
+                                       bool eom,
+                                       HTTPHeaderSize* size) {
+  DCHECK(transportDirection_ == TransportDirection::DOWNSTREAM);
+  CHECK(tmpl.prefix);
+  if (keepalive_ && disableKeepalivePending_) {
+    keepalive_ = false;
+  }
+  // same sequencing rules as generateHeader
+  if ((txn != egressTxnID_ + 1 &&
+       !(txn == egressTxnID_ && is1xxResponse_)) ||
+      (txn > ingressTxnID_)) {
+    LOG(DFATAL) << "Out of order, duplicate or premature HTTP response";
+  }
+  if (!is1xxResponse_) {
+    ++egressTxnID_;
+  }
+  is1xxResponse_ = false;
+  expectNoResponseBody_ = connectRequest_ || headRequest_ ||
+      RFC2616::responseBodyMustBeEmpty(tmpl.statusCode);
+  if (connectRequest_ && (tmpl.statusCode >= 200 && tmpl.statusCode < 300)) {
+    egressUpgrade_ = true;
+  } else if (connectRequest_ && ingressUpgrade_) {
+    ingressUpgrade_ = false;
+    keepalive_ = false;
+  }
+  egressChunked_ = false;
+  lastChunkWritten_ = false;
+
+  size_t len = 0;
+  writeBuf.append(tmpl.prefix->clone());
+  len += tmpl.prefixLen;
+  addDateHeader(writeBuf, len);
+  appendLiteral(writeBuf, len, "Connection: ");
+  if (keepalive_) {
+    appendLiteral(writeBuf, len, "keep-alive");
+  } else {
+    appendLiteral(writeBuf, len, "close");
+  }
+  appendLiteral(writeBuf, len, CRLF);
+  appendLiteral(writeBuf, len, "Content-Length: ");
+  appendUint(writeBuf, len, contentLength);
+  appendLiteral(writeBuf, len, CRLF);
+  appendLiteral(writeBuf, len, CRLF);
+  if (eom) {
+    len += generateEOM(writeBuf, txn);
+  }
+  if (size) {
+    size->compressed = 0;
+    size->uncompressed = len;
+  }
+}
+
 size_t HTTP1xCodec::generateBody(IOBufQueue& writeBuf,
                                  StreamID txn,
                                  unique_ptr<IOBuf> chain,
@@ -675,16 +1027,28 @@ size_t HTTP1xCodec::generateBody(IOBufQueue& writeBuf,
   }
 
   if (egressChunked_ && !inChunk_) {
-    char chunkLenBuf[32];
-    int rc = snprintf(chunkLenBuf, sizeof(chunkLenBuf), "%zx\r\n", buflen);
-    CHECK_GT(rc, 0);
-    CHECK_LT(size_t(rc), sizeof(chunkLenBuf));
-
-    writeBuf.append(chunkLenBuf, rc);
+    char chunkLenBuf[kMaxChunkHeaderLen];
+    size_t rc = encodeChunkHeader(chunkLenBuf, buflen);
     totLen += rc;
-
-    writeBuf.append(std::move(chain));
-    writeBuf.append("\r\n", 2);
+    if (chain->headroom() >= rc && !chain->isSharedOne()) {
+      // Fuse the size line into the body's own headroom: the whole
+      // chunk lands in writeBuf as one append, with no copy of the
+      // header through IOBufQueue's pack path.
+      chain->prepend(rc);
+      memcpy(chain->writableData(), chunkLenBuf, rc);
+    } else {
+      writeBuf.append(chunkLenBuf, rc);
+    }
+    IOBuf* tail = chain->prev();
+    if (tail->tailroom() >= 2 && !tail->isSharedOne()) {
+      // ... and the trailing CRLF rides the last buffer's tailroom
+      memcpy(tail->writableTail(), "\r\n", 2);
+      tail->append(2);
+      writeBuf.append(std::move(chain));
+    } else {
+      writeBuf.append(std::move(chain));
+      writeBuf.append("\r\n", 2);
+    }
     totLen += 2;
   } else {
     writeBuf.append(std::move(chain));
@@ -696,6 +1060,17 @@ size_t HTTP1xCodec::generateBody(IOBufQueue& writeBuf,
   return totLen;
 }
 
+/*
+ * On h1-to-h1 proxy flows the chunk framing parsed off ingress gets
+ * re-generated here byte for byte. A verified-passthrough mode -
+ * validate the framing once, then forward the original framed bytes -
+ * needs the parser to expose the raw byte span of each chunk envelope
+ * (size line through terminal CRLF). The vendored http_parser only
+ * surfaces parsed values in on_chunk_header/on_chunk_complete, not
+ * source offsets, so the codec cannot reconstruct the original
+ * envelope without re-serializing; adding span reporting to the parser
+ * callbacks is the prerequisite for that mode.
+ */
 size_t HTTP1xCodec::generateChunkHeader(IOBufQueue& writeBuf,
                                         StreamID /*txn*/,
                                         size_t length) {
@@ -708,11 +1083,8 @@ size_t HTTP1xCodec::generateChunkHeader(IOBufQueue& writeBuf,
   if (egressChunked_) {
     CHECK(!inChunk_);
     inChunk_ = true;
-    char chunkLenBuf[32];
-    int rc = snprintf(chunkLenBuf, sizeof(chunkLenBuf), "%zx\r\n", length);
-    CHECK_GT(rc, 0);
-    CHECK_LT(size_t(rc), sizeof(chunkLenBuf));
-
+    char chunkLenBuf[kMaxChunkHeaderLen];
+    size_t rc = encodeChunkHeader(chunkLenBuf, length);
     writeBuf.append(chunkLenBuf, rc);
     return rc;
   }
@@ -961,12 +1333,12 @@ HTTP1xCodec::onHeadersComplete(size_t len) {
   }
 
   // Update the HTTPMessage with the values parsed from the header
-  msg_->setHTTPVersion(parser_.http_major, parser_.http_minor);
-  msg_->setIsChunked((parser_.flags & F_CHUNKED));
+  msg_->setHTTPVersion(parser_->httpMajor(), parser_->httpMinor());
+  msg_->setIsChunked(parser_->isChunked());
 
   if (transportDirection_ == TransportDirection::DOWNSTREAM) {
     // Set the method type
-    msg_->setMethod(http_method_str(static_cast<http_method>(parser_.method)));
+    msg_->setMethod(parser_->methodString());
 
     connectRequest_ = (msg_->getMethod() == HTTPMethod::CONNECT);
 
@@ -988,9 +1360,9 @@ HTTP1xCodec::onHeadersComplete(size_t len) {
 
     // If the client sent us an HTTP/1.x with x >= 1, we may send
     // chunked responses.
-    mayChunkEgress_ = ((parser_.http_major == 1) && (parser_.http_minor >= 1));
+    mayChunkEgress_ = ((parser_->httpMajor() == 1) && (parser_->httpMinor() >= 1));
   } else {
-    msg_->setStatusCode(parser_.status_code);
+    msg_->setStatusCode(parser_->statusCode());
     msg_->setStatusMessage(std::move(reason_));
     reason_.clear();
   }
@@ -998,18 +1370,18 @@ HTTP1xCodec::onHeadersComplete(size_t len) {
   auto g = folly::makeGuard([this] {
       // Always clear the outbound upgrade header after we receive a response
       if (transportDirection_ == TransportDirection::UPSTREAM &&
-          parser_.status_code != 100) {
+          parser_->statusCode() != 100) {
         upgradeHeader_.clear();
       }
     });
   headerParseState_ = HeaderParseState::kParsingHeadersComplete;
   if (transportDirection_ == TransportDirection::UPSTREAM) {
     if (connectRequest_ &&
-        (parser_.status_code >= 200 && parser_.status_code < 300)) {
+        (parser_->statusCode() >= 200 && parser_->statusCode() < 300)) {
       // Enable upgrade if this is a 200 response to a CONNECT
       // request we sent earlier
       ingressUpgrade_ = true;
-    } else if (parser_.status_code == 101) {
+    } else if (parser_->statusCode() == 101) {
       // Set the upgrade flags if the server has upgraded.
       const std::string& serverUpgrade =
         msg_->getHeaders().getSingleOrEmpty(HTTP_HEADER_UPGRADE);
@@ -1043,11 +1415,10 @@ HTTP1xCodec::onHeadersComplete(size_t len) {
           "client=" << upgradeHeader_ << " server=" << serverUpgrade;
         return -1;
       }
-    } else if (parser_.upgrade || parser_.flags & F_UPGRADE) {
+    } else if (parser_->isUpgrade()) {
       // Ignore upgrade header for upstream response messages with status code
       // different from 101 in case if it was not a response to CONNECT.
-      parser_.upgrade = false;
-      parser_.flags &= ~F_UPGRADE;
+      parser_->clearUpgrade();
     }
   }
   else {
@@ -1235,150 +1606,6 @@ int HTTP1xCodec::onMessageComplete() {
   return 0;
 }
 
-int
-HTTP1xCodec::onMessageBeginCB(http_parser* parser) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onMessageBegin();
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int
-HTTP1xCodec::onUrlCB(http_parser* parser, const char* buf, size_t len) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onURL(buf, len);
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int
-HTTP1xCodec::onReasonCB(http_parser* parser, const char* buf, size_t len) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onReason(buf, len);
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int
-HTTP1xCodec::onHeaderFieldCB(http_parser* parser, const char* buf, size_t len) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onHeaderField(buf, len);
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int
-HTTP1xCodec::onHeaderValueCB(http_parser* parser, const char* buf, size_t len) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onHeaderValue(buf, len);
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int HTTP1xCodec::onHeadersCompleteCB(http_parser* parser,
-                                     const char* /*buf*/,
-                                     size_t len) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onHeadersComplete(len);
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 3;
-  }
-}
-
-int
-HTTP1xCodec::onBodyCB(http_parser* parser, const char* buf, size_t len) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onBody(buf, len);
-  } catch (const std::exception& ex) {
-    // Note: http_parser appears to completely ignore the return value from the
-    // on_body() callback.  There seems to be no way to abort parsing after an
-    // error in on_body().
-    //
-    // We handle this by checking if error_ is set after each call to
-    // http_parser_execute().
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int HTTP1xCodec::onChunkHeaderCB(http_parser* parser) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onChunkHeader(parser->content_length);
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int HTTP1xCodec::onChunkCompleteCB(http_parser* parser) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onChunkComplete();
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
-
-int
-HTTP1xCodec::onMessageCompleteCB(http_parser* parser) {
-  HTTP1xCodec* codec = static_cast<HTTP1xCodec*>(parser->data);
-  DCHECK(codec != nullptr);
-  DCHECK_EQ(&codec->parser_, parser);
-
-  try {
-    return codec->onMessageComplete();
-  } catch (const std::exception& ex) {
-    codec->onParserError(ex.what());
-    return 1;
-  }
-}
 
 bool HTTP1xCodec::supportsNextProtocol(const std::string& npn) {
   return npn.length() == 8 && (npn == "http/1.0" || npn == "http/1.1");
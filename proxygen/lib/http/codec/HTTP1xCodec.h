@@ -13,11 +13,11 @@
 #include <proxygen/lib/http/codec/TransportDirection.h>
 #include <string>
 
-#include <proxygen/external/http_parser/http_parser.h>
+#include <proxygen/lib/http/codec/HTTP1xParser.h>
 
 namespace proxygen {
 
-class HTTP1xCodec : public HTTPCodec {
+class HTTP1xCodec : public HTTPCodec, private HTTP1xParserListener {
  public:
   explicit HTTP1xCodec(TransportDirection direction,
                        bool forceUpstream1_1 = false);
@@ -85,9 +85,57 @@ class HTTP1xCodec : public HTTPCodec {
     ErrorCode statusCode,
     std::unique_ptr<folly::IOBuf> debugData = nullptr) override;
 
+  /**
+   * An immutable pre-rendered response header block: the status line and
+   * all fixed headers, serialized once. Per-response, only the variable
+   * fields (Date, Connection, Content-Length) get appended.
+   */
+  struct HeaderTemplate {
+    std::unique_ptr<folly::IOBuf> prefix;
+    size_t prefixLen{0};
+    uint16_t statusCode{0};
+  };
+
+  /**
+   * Render the immutable part of a response once for replay via
+   * generateCachedHeader. Returns nullptr when the message needs
+   * per-response handling: upstream codecs, 1xx/websocket/chunked
+   * responses, or messages carrying their own Connection, Content-Length,
+   * Date, Upgrade or Transfer-Encoding headers.
+   */
+  std::unique_ptr<HeaderTemplate> createHeaderTemplate(
+      const HTTPMessage& msg) const;
+
+  /**
+   * Generate a response from a pre-rendered template, patching in only
+   * the Date, Connection and Content-Length fields. Equivalent to
+   * generateHeader for the template's message with the given
+   * content length.
+   */
+  void generateCachedHeader(folly::IOBufQueue& writeBuf,
+                            StreamID txn,
+                            const HeaderTemplate& tmpl,
+                            uint64_t contentLength,
+                            bool eom = false,
+                            HTTPHeaderSize* size = nullptr);
+
   void setAllowedUpgradeProtocols(std::list<std::string> protocols);
   const std::string& getAllowedUpgradeProtocols();
 
+  bool isRecyclable() const override {
+    return true;
+  }
+
+  void reset() override;
+
+  /**
+   * Swap in an alternative parser backend (see HTTP1xParser).  Must be
+   * called before any ingress; typically done by a per-acceptor codec
+   * factory right after constructing the codec, so canary boxes can
+   * A/B a faster parser while the vendored one stays the default.
+   */
+  void setParserBackend(std::unique_ptr<HTTP1xParser> parser);
+
   /**
    * @returns true if the codec supports the given NPN protocol.
    */
@@ -136,7 +184,7 @@ class HTTP1xCodec : public HTTPCodec {
       the callback object to report the error and do any other cleanup
       needed. It optionally takes a message to pass to the generated
       HTTPException passed to callback_. */
-  void onParserError(const char* what = nullptr);
+  void onParserError(const char* what = nullptr) override;
 
   /** Push out header name-value pair to hdrs and clear currentHeader*_ */
   void pushHeaderNameAndValue(HTTPHeaders& hdrs);
@@ -145,22 +193,22 @@ class HTTP1xCodec : public HTTPCodec {
   void serializeWebsocketHeader(folly::IOBufQueue& writeBuf, size_t& len,
       bool upstream);
 
-  // Parser callbacks
-  int onMessageBegin();
-  int onURL(const char* buf, size_t len);
-  int onReason(const char* buf, size_t len);
-  int onHeaderField(const char* buf, size_t len);
-  int onHeaderValue(const char* buf, size_t len);
-  int onHeadersComplete(size_t len);
-  int onBody(const char* buf, size_t len);
-  int onChunkHeader(size_t len);
-  int onChunkComplete();
-  int onMessageComplete();
+  // Parser callbacks (HTTP1xParserListener)
+  int onMessageBegin() override;
+  int onURL(const char* buf, size_t len) override;
+  int onReason(const char* buf, size_t len) override;
+  int onHeaderField(const char* buf, size_t len) override;
+  int onHeaderValue(const char* buf, size_t len) override;
+  int onHeadersComplete(size_t len) override;
+  int onBody(const char* buf, size_t len) override;
+  int onChunkHeader(size_t len) override;
+  int onChunkComplete() override;
+  int onMessageComplete() override;
 
   HTTPCodec::Callback* callback_;
   StreamID ingressTxnID_;
   StreamID egressTxnID_;
-  http_parser parser_;
+  std::unique_ptr<HTTP1xParser> parser_;
   const folly::IOBuf* currentIngressBuf_;
   std::unique_ptr<HTTPMessage> msg_;
   std::unique_ptr<HTTPMessage> upgradeRequest_;
@@ -203,22 +251,6 @@ class HTTP1xCodec : public HTTPCodec {
   bool nativeUpgrade_:1;
   bool headersComplete_:1;
 
-  // C-callable wrappers for the http_parser callbacks
-  static int onMessageBeginCB(http_parser* parser);
-  static int onPathCB(http_parser* parser, const char* buf, size_t len);
-  static int onQueryStringCB(http_parser* parser, const char* buf, size_t len);
-  static int onUrlCB(http_parser* parser, const char* buf, size_t len);
-  static int onReasonCB(http_parser* parser, const char* buf, size_t len);
-  static int onHeaderFieldCB(http_parser* parser, const char* buf, size_t len);
-  static int onHeaderValueCB(http_parser* parser, const char* buf, size_t len);
-  static int onHeadersCompleteCB(http_parser* parser,
-                                 const char* buf, size_t len);
-  static int onBodyCB(http_parser* parser, const char* buf, size_t len);
-  static int onChunkHeaderCB(http_parser* parser);
-  static int onChunkCompleteCB(http_parser* parser);
-  static int onMessageCompleteCB(http_parser* parser);
-
-  static const http_parser_settings* getParserSettings();
 };
 
 } // proxygen
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace proxygen {
+
+/**
+ * Ingress callbacks a parser backend delivers to HTTP1xCodec, in the
+ * vendored http_parser's conventions: buffers point into the bytes
+ * passed to execute(), nonzero returns stop the parse, and returning
+ * nonzero from onHeadersComplete suppresses body delivery (the codec
+ * returns 1 when the message has no body, 3 to also skip trailers).
+ */
+class HTTP1xParserListener {
+ public:
+  virtual ~HTTP1xParserListener() = default;
+  virtual int onMessageBegin() = 0;
+  virtual int onURL(const char* buf, size_t len) = 0;
+  virtual int onReason(const char* buf, size_t len) = 0;
+  virtual int onHeaderField(const char* buf, size_t len) = 0;
+  virtual int onHeaderValue(const char* buf, size_t len) = 0;
+  virtual int onHeadersComplete(size_t len) = 0;
+  virtual int onBody(const char* buf, size_t len) = 0;
+  virtual int onChunkHeader(size_t len) = 0;
+  virtual int onChunkComplete() = 0;
+  virtual int onMessageComplete() = 0;
+
+  /**
+   * A listener callback threw; the backend stops the parse and reports
+   * the failure here before returning from execute().
+   */
+  virtual void onParserError(const char* what) = 0;
+};
+
+/**
+ * Parser backend behind HTTP1xCodec.  The vendored http_parser adapter
+ * is the default; alternative backends (generated llhttp-style, bulk
+ * scanners) slot in per codec instance via
+ * HTTP1xCodec::setParserBackend, letting a faster parser run on canary
+ * boxes without forking the codec.  A backend must reproduce the
+ * vendored parser's observable semantics - the corpus tests in
+ * HTTP1xCodecTest are the compatibility bar.
+ */
+class HTTP1xParser {
+ public:
+  // classification of parse failures the codec acts on differently
+  enum class Error : uint8_t {
+    NONE = 0,
+    // stopped at a callback-requested pause; not an error
+    PAUSED,
+    // bytes after a message that forbids reuse
+    EOF_STATE,
+    // malformed headers (version, constants, sizes)
+    HEADERS,
+    // malformed chunked framing
+    CHUNK,
+    OTHER,
+  };
+
+  virtual ~HTTP1xParser() = default;
+
+  /**
+   * Reset to start-of-connection state, parsing requests or responses.
+   */
+  virtual void init(bool parseRequests) = 0;
+
+  /**
+   * Parse len bytes (len == 0 signals ingress EOF); returns bytes
+   * consumed.  Callbacks fire into the listener during the call.
+   */
+  virtual size_t execute(const char* data, size_t len) = 0;
+
+  virtual void setPaused(bool paused) = 0;
+  virtual bool paused() const = 0;
+
+  virtual Error error() const = 0;
+  virtual std::string errorDescription() const = 0;
+
+  // message properties, valid from onHeadersComplete of the current
+  // message until the next onMessageBegin
+  virtual uint16_t statusCode() const = 0;
+  virtual uint8_t httpMajor() const = 0;
+  virtual uint8_t httpMinor() const = 0;
+  virtual const char* methodString() const = 0;
+  virtual bool isChunked() const = 0;
+  virtual bool isUpgrade() const = 0;
+
+  /**
+   * Shims HTTP1xCodec needs for protocol corner cases: forcing the
+   * version for HTTP/0.9 handling, synthesizing the fake 200 for 0.9
+   * responses, and clearing the upgrade state once consumed.
+   */
+  virtual void setHttpVersion(uint8_t major, uint8_t minor) = 0;
+  virtual void setStatusCode(uint16_t statusCode) = 0;
+  virtual void clearUpgrade() = 0;
+};
+
+} // namespace proxygen
@@ -175,7 +175,9 @@ ErrorCode HTTP2Codec::parseFrame(folly::io::Cursor& cursor) {
     return ErrorCode::PROTOCOL_ERROR;
   }
   if (frameAffectsCompression(curHeader_.type) &&
-      curHeaderBlock_.chainLength() + curHeader_.length >
+      (streamingHeaderDecode_ ? curBlockCompressedBytes_
+                              : curHeaderBlock_.chainLength()) +
+      curHeader_.length >
       egressSettings_.getSetting(SettingsId::MAX_HEADER_LIST_SIZE, 0)) {
     // this may be off by up to the padding length (max 255), but
     // these numbers are already so generous, and we're comparing the
@@ -227,6 +229,8 @@ ErrorCode HTTP2Codec::parseFrame(folly::io::Cursor& cursor) {
     case http2::FrameType::ALTSVC:
       // fall through, unimplemented
       break;
+    case http2::FrameType::METADATA:
+      return parseMetadata(cursor);
     case http2::FrameType::CERTIFICATE_REQUEST:
       return parseCertificateRequest(cursor);
     case http2::FrameType::CERTIFICATE:
@@ -421,7 +425,57 @@ ErrorCode HTTP2Codec::parseHeadersImpl(
     const folly::Optional<http2::PriorityUpdate>& priority,
     const folly::Optional<uint32_t>& promisedStream,
     const folly::Optional<ExAttributes>& exAttributes) {
-  curHeaderBlock_.append(std::move(headerBuf));
+  if (streamingHeaderDecode_) {
+    if (curHeader_.type != http2::FrameType::CONTINUATION) {
+      // block start: set up decodeInfo_ now so headers stream out of the
+      // decoder as their instructions complete
+      curBlockCompressedBytes_ = 0;
+      bool isReq = false;
+      if (promisedStream) {
+        isReq = true;
+      } else if (exAttributes) {
+        isReq = isRequest(curHeader_.stream);
+      } else {
+        isReq = transportDirection_ == TransportDirection::DOWNSTREAM;
+      }
+      if (priority && curHeader_.stream == priority->streamDependency) {
+        streamError(folly::to<string>("Circular dependency for txn=",
+                                      curHeader_.stream),
+                    ErrorCode::PROTOCOL_ERROR,
+                    curHeader_.type == http2::FrameType::HEADERS);
+        return ErrorCode::NO_ERROR;
+      }
+      decodeInfo_.init(isReq, parsingDownstreamTrailers_, validateHeaders_);
+      if (priority) {
+        decodeInfo_.msg->setHTTP2Priority(
+            std::make_tuple(priority->streamDependency,
+                            priority->exclusive,
+                            priority->weight));
+      }
+    }
+    if (decodeInfo_.msg) {
+      uint32_t fragmentLen =
+          headerBuf ? folly::to<uint32_t>(headerBuf->computeChainDataLength())
+                    : 0;
+      curBlockCompressedBytes_ += fragmentLen;
+      Cursor fragmentCursor(headerBuf.get());
+      headerCodec_.decodeStreamingPartial(
+          fragmentCursor,
+          fragmentLen,
+          curHeader_.flags & http2::END_HEADERS,
+          this);
+      if (!(curHeader_.flags & http2::END_HEADERS) &&
+          decodeInfo_.decodeError != HPACK::DecodeError::NONE) {
+        // fail on the fragment that broke, don't wait for END_HEADERS
+        LOG(ERROR) << "Failed decoding header block fragment for stream="
+                   << curHeader_.stream;
+        return ErrorCode::COMPRESSION_ERROR;
+      }
+    } // else the block start was rejected; drop the fragments like the
+      // buffered path does
+  } else {
+    curHeaderBlock_.append(std::move(headerBuf));
+  }
   std::unique_ptr<HTTPMessage> msg;
   if (curHeader_.flags & http2::END_HEADERS) {
     auto errorCode =
@@ -503,36 +557,40 @@ folly::Optional<ErrorCode> HTTP2Codec::parseHeadersDecodeFrames(
     const folly::Optional<uint32_t>& promisedStream,
     const folly::Optional<ExAttributes>& exAttributes,
     std::unique_ptr<HTTPMessage>& msg) {
-  // decompress headers
-  Cursor headerCursor(curHeaderBlock_.front());
-  bool isReq = false;
-  if (promisedStream) {
-    isReq = true;
-  } else if (exAttributes) {
-    isReq = isRequest(curHeader_.stream);
-  } else {
-    isReq = transportDirection_ == TransportDirection::DOWNSTREAM;
-  }
+  if (!streamingHeaderDecode_) {
+    // decompress headers
+    Cursor headerCursor(curHeaderBlock_.front());
+    bool isReq = false;
+    if (promisedStream) {
+      isReq = true;
+    } else if (exAttributes) {
+      isReq = isRequest(curHeader_.stream);
+    } else {
+      isReq = transportDirection_ == TransportDirection::DOWNSTREAM;
+    }
 
-  // Validate circular dependencies.
-  if (priority && (curHeader_.stream == priority->streamDependency)) {
-    streamError(
-        folly::to<string>("Circular dependency for txn=", curHeader_.stream),
-        ErrorCode::PROTOCOL_ERROR,
-        curHeader_.type == http2::FrameType::HEADERS);
-    return ErrorCode::NO_ERROR;
-  }
+    // Validate circular dependencies.
+    if (priority && (curHeader_.stream == priority->streamDependency)) {
+      streamError(
+          folly::to<string>("Circular dependency for txn=", curHeader_.stream),
+          ErrorCode::PROTOCOL_ERROR,
+          curHeader_.type == http2::FrameType::HEADERS);
+      return ErrorCode::NO_ERROR;
+    }
 
-  decodeInfo_.init(isReq, parsingDownstreamTrailers_, validateHeaders_);
-  if (priority) {
-    decodeInfo_.msg->setHTTP2Priority(
-        std::make_tuple(priority->streamDependency,
-                        priority->exclusive,
-                        priority->weight));
-  }
+    decodeInfo_.init(isReq, parsingDownstreamTrailers_, validateHeaders_);
+    if (priority) {
+      decodeInfo_.msg->setHTTP2Priority(
+          std::make_tuple(priority->streamDependency,
+                          priority->exclusive,
+                          priority->weight));
+    }
 
-  headerCodec_.decodeStreaming(
-      headerCursor, curHeaderBlock_.chainLength(), this);
+    headerCodec_.decodeStreaming(
+        headerCursor, curHeaderBlock_.chainLength(), this);
+  }
+  // in streaming decode mode the fragments were already fed to the
+  // decoder by parseHeadersImpl; only the result checks below remain
   msg = std::move(decodeInfo_.msg);
   // Saving this in case we need to log it on error
   auto g = folly::makeGuard([this] { curHeaderBlock_.move(); });
@@ -600,10 +658,10 @@ folly::Optional<ErrorCode> HTTP2Codec::parseHeadersCheckConcurrentStreams(
 }
 
 void HTTP2Codec::onHeader(const HPACKHeaderName& name,
-                          const folly::fbstring& value) {
+                          folly::StringPiece value) {
   if (decodeInfo_.onHeader(name, value)) {
     if (userAgent_.empty() && name.getHeaderCode() == HTTP_HEADER_USER_AGENT) {
-      userAgent_ = value.toStdString();
+      userAgent_ = value.str();
     }
   } else {
     VLOG(4) << "dir=" << uint32_t(transportDirection_) <<
@@ -677,6 +735,24 @@ size_t HTTP2Codec::addPriorityNodes(
   return bytes;
 }
 
+ErrorCode HTTP2Codec::parseMetadata(Cursor& cursor) {
+  VLOG(4) << "parsing METADATA frame for stream=" << curHeader_.stream
+          << " length=" << curHeader_.length;
+  if (curHeader_.stream == 0) {
+    // metadata is per-stream; ignore a connection-level frame like any
+    // other unknown extension misuse
+    cursor.skip(curHeader_.length);
+    return ErrorCode::NO_ERROR;
+  }
+  std::unique_ptr<folly::IOBuf> metadata;
+  cursor.clone(metadata, curHeader_.length);
+  deliverCallbackIfAllowed(&HTTPCodec::Callback::onMetadata,
+                           "onMetadata",
+                           curHeader_.stream,
+                           std::move(metadata));
+  return ErrorCode::NO_ERROR;
+}
+
 ErrorCode HTTP2Codec::parseRstStream(Cursor& cursor) {
   // rst for stream in idle state - protocol error
   VLOG(4) << "parsing RST_STREAM frame for stream=" << curHeader_.stream <<
@@ -710,6 +786,11 @@ ErrorCode HTTP2Codec::parseSettings(Cursor& cursor) {
 }
 
 void HTTP2Codec::handleSettingsAck() {
+  if (settingsResumptionCache_ && sentSettingsPendingAck_) {
+    settingsResumptionCache_->storeSent(settingsResumptionPeer_,
+                                        std::move(*sentSettingsPendingAck_));
+    sentSettingsPendingAck_.clear();
+  }
   if (pendingTableMaxSize_) {
     headerCodec_.setDecoderHeaderTableMaxSize(*pendingTableMaxSize_);
     pendingTableMaxSize_ = folly::none;
@@ -720,8 +801,54 @@ void HTTP2Codec::handleSettingsAck() {
 }
 
 ErrorCode HTTP2Codec::handleSettings(const std::deque<SettingPair>& settings) {
+  std::deque<SettingPair> merged;
+  folly::Optional<uint32_t> resumptionFingerprint;
+  for (auto& setting : settings) {
+    if (setting.first == SettingsId::SETTINGS_RESUMPTION_FINGERPRINT) {
+      resumptionFingerprint = setting.second;
+    } else {
+      merged.push_back(setting);
+    }
+  }
+  if (resumptionFingerprint && settingsResumptionCache_) {
+    // restore elided settings from the last acknowledged exchange,
+    // received deltas taking precedence, then verify the fingerprint
+    // over the merge: any divergence between the peers' caches fails
+    // loudly here instead of silently running a mixed config
+    auto cached =
+        settingsResumptionCache_->getReceived(settingsResumptionPeer_);
+    if (cached) {
+      for (const auto& base : *cached) {
+        bool overridden = false;
+        for (const auto& setting : merged) {
+          if (setting.first == base.first) {
+            overridden = true;
+            break;
+          }
+        }
+        if (!overridden) {
+          merged.push_back(base);
+        }
+      }
+    }
+    if (SettingsResumptionCache::fingerprint(merged) !=
+        *resumptionFingerprint) {
+      goawayErrorMessage_ = folly::to<string>(
+          "GOAWAY error: settings resumption fingerprint mismatch",
+          " for streamID=", curHeader_.stream);
+      VLOG(2) << goawayErrorMessage_;
+      settingsResumptionCache_->invalidate(settingsResumptionPeer_);
+      return ErrorCode::PROTOCOL_ERROR;
+    }
+    settingsResumptionCache_->storeReceived(
+        settingsResumptionPeer_,
+        SettingsResumptionCache::Settings(merged.begin(), merged.end()));
+  }
+  const std::deque<SettingPair>& effectiveSettings =
+      resumptionFingerprint ? merged : settings;
+
   SettingsList settingsList;
-  for (auto& setting: settings) {
+  for (auto& setting: effectiveSettings) {
     switch (setting.first) {
       case SettingsId::HEADER_TABLE_SIZE:
       {
@@ -1233,6 +1360,80 @@ void HTTP2Codec::generateHeaderImpl(
   }
 }
 
+std::shared_ptr<folly::IOBuf> HTTP2Codec::encodeSharedHeaderBlock(
+    const HTTPMessage& msg, HTTPHeaderSize* size) {
+  // detached encoder with a zero-size dynamic table; see header comment
+  HPACKCodec sharedCodec(transportDirection_, 0 /* encoderTableSize */);
+  folly::IOBufQueue out(folly::IOBufQueue::cacheChainLength());
+  sharedCodec.encodeHTTP(msg, out, addDateToResponse_);
+  if (size) {
+    *size = sharedCodec.getEncodedSize();
+  }
+  return std::shared_ptr<folly::IOBuf>(out.move());
+}
+
+void HTTP2Codec::generateSharedHeader(
+    folly::IOBufQueue& writeBuf,
+    StreamID stream,
+    const folly::IOBuf& encodedBlock,
+    bool eom,
+    const folly::Optional<StreamID>& assocStream) {
+  if (assocStream) {
+    DCHECK_EQ(transportDirection_, TransportDirection::DOWNSTREAM);
+    DCHECK(!eom);
+    VLOG(4) << "replaying shared PUSH_PROMISE for stream=" << stream;
+  } else {
+    VLOG(4) << "replaying shared HEADERS for stream=" << stream;
+  }
+  if (!isStreamIngressEgressAllowed(stream)) {
+    VLOG(2) << "Suppressing HEADERS/PROMISE for stream=" << stream
+            << " ingressGoawayAck_=" << ingressGoawayAck_;
+    return;
+  }
+
+  auto headerSize = http2::calculatePreHeaderBlockSize(
+      assocStream.hasValue(), false, false, false);
+  auto maxFrameSize = maxSendFrameSize();
+  uint32_t remainingFrameSize =
+      maxFrameSize - headerSize + http2::kFrameHeaderSize;
+  auto frameHeader = writeBuf.preallocate(headerSize, kDefaultGrowth);
+  writeBuf.postallocate(headerSize);
+  writeBuf.append(encodedBlock.clone());
+
+  IOBufQueue queue(IOBufQueue::cacheChainLength());
+  auto chunkLen = splitCompressed(encodedBlock.computeChainDataLength(),
+                                  remainingFrameSize, writeBuf, queue);
+  bool endHeaders = queue.chainLength() == 0;
+  if (assocStream) {
+    generateHeaderCallbackWrapper(
+        stream, http2::FrameType::PUSH_PROMISE,
+        http2::writePushPromise((uint8_t*)frameHeader.first,
+                                frameHeader.second,
+                                writeBuf,
+                                *assocStream,
+                                stream,
+                                chunkLen,
+                                http2::kNoPadding,
+                                endHeaders));
+  } else {
+    generateHeaderCallbackWrapper(
+        stream, http2::FrameType::HEADERS,
+        http2::writeHeaders((uint8_t*)frameHeader.first,
+                            frameHeader.second,
+                            writeBuf,
+                            chunkLen,
+                            stream,
+                            folly::none,
+                            http2::kNoPadding,
+                            eom,
+                            endHeaders));
+  }
+
+  if (!endHeaders) {
+    generateContinuation(writeBuf, queue, stream, maxFrameSize);
+  }
+}
+
 void HTTP2Codec::generateContinuation(folly::IOBufQueue& writeBuf,
                                       folly::IOBufQueue& queue,
                                       StreamID stream,
@@ -1316,6 +1517,8 @@ size_t HTTP2Codec::generateBody(folly::IOBufQueue& writeBuf,
                                    reuseIOBufHeadroomForData_));
   }
 
+  const bool packSmall = egressPackingThreshold_ > 0 &&
+                         queue.chainLength() <= egressPackingThreshold_;
   return written + generateHeaderCallbackWrapper(
                       stream,
                       http2::FrameType::DATA,
@@ -1324,7 +1527,8 @@ size_t HTTP2Codec::generateBody(folly::IOBufQueue& writeBuf,
                                        stream,
                                        padding,
                                        eom,
-                                       reuseIOBufHeadroomForData_));
+                                       reuseIOBufHeadroomForData_,
+                                       packSmall));
 }
 
 size_t HTTP2Codec::generateChunkHeader(folly::IOBufQueue& /*writeBuf*/,
@@ -1486,6 +1690,8 @@ size_t HTTP2Codec::generatePingRequest(folly::IOBufQueue& writeBuf,
 size_t HTTP2Codec::generatePingReply(folly::IOBufQueue& writeBuf,
                                      uint64_t data) {
   VLOG(4) << "Generating ping reply with data=" << data;
+  // ping acks are never deferred: the session positions them precisely
+  // in the write buffer for byte-event accounting
   return generateHeaderCallbackWrapper(0, http2::FrameType::PING,
                                        http2::writePing(writeBuf, data, true /* ack */));
 }
@@ -1543,12 +1749,68 @@ size_t HTTP2Codec::generateSettings(folly::IOBufQueue& writeBuf) {
 
     settings.push_back(SettingPair(setting.id, setting.value));
   }
+  if (settingsResumptionCache_) {
+    // remember the full set; it becomes the peer's acknowledged
+    // baseline when the ACK arrives
+    sentSettingsPendingAck_.emplace(settings.begin(), settings.end());
+    auto fingerprint = SettingsResumptionCache::fingerprint(settings);
+    auto acked = settingsResumptionCache_->getSent(settingsResumptionPeer_);
+    if (acked) {
+      // elide settings the peer already acknowledged at this value;
+      // the fingerprint covers the full set, so the peer can restore
+      // the elided ones and verify the merge.  A setting that
+      // disappeared entirely can't be expressed as a delta - send the
+      // full set in that case.
+      bool expressible = true;
+      for (const auto& cached : *acked) {
+        bool present = false;
+        for (const auto& setting : settings) {
+          if (setting.first == cached.first) {
+            present = true;
+            break;
+          }
+        }
+        if (!present) {
+          expressible = false;
+          break;
+        }
+      }
+      if (expressible) {
+        std::deque<SettingPair> delta;
+        for (const auto& setting : settings) {
+          bool unchanged = false;
+          for (const auto& cached : *acked) {
+            if (cached.first == setting.first &&
+                cached.second == setting.second) {
+              unchanged = true;
+              break;
+            }
+          }
+          if (!unchanged) {
+            delta.push_back(setting);
+          }
+        }
+        VLOG(4) << "settings resumption: eliding "
+                << (settings.size() - delta.size()) << " of "
+                << settings.size() << " settings";
+        settings = std::move(delta);
+      }
+    }
+    settings.push_back(SettingPair(SettingsId::SETTINGS_RESUMPTION_FINGERPRINT,
+                                   fingerprint));
+  }
   VLOG(4) << getTransportDirectionString(getTransportDirection())
           << " generating " << (unsigned)settings.size() << " settings";
   return generateHeaderCallbackWrapper(0, http2::FrameType::SETTINGS,
                                        http2::writeSettings(writeBuf, settings));
 }
 
+void HTTP2Codec::enableSettingsResumption(
+    std::shared_ptr<SettingsResumptionCache> cache, std::string peerKey) {
+  settingsResumptionCache_ = std::move(cache);
+  settingsResumptionPeer_ = std::move(peerKey);
+}
+
 void HTTP2Codec::requestUpgrade(HTTPMessage& request) {
   static folly::ThreadLocalPtr<HTTP2Codec> defaultCodec;
   if (!defaultCodec.get()) {
@@ -1585,6 +1847,12 @@ void HTTP2Codec::requestUpgrade(HTTPMessage& request) {
 size_t HTTP2Codec::generateSettingsAck(folly::IOBufQueue& writeBuf) {
   VLOG(4) << getTransportDirectionString(getTransportDirection())
           << " generating settings ack";
+  if (coalesceControlFrames_) {
+    // deferred; return the nominal frame size so callers still
+    // schedule the write that flushes it
+    pendingSettingsAcks_++;
+    return http2::kFrameHeaderSize;
+  }
   return generateHeaderCallbackWrapper(0, http2::FrameType::SETTINGS,
                                        http2::writeSettingsAck(writeBuf));
 }
@@ -1599,10 +1867,41 @@ size_t HTTP2Codec::generateWindowUpdate(folly::IOBufQueue& writeBuf,
             << " ingressGoawayAck_=" << ingressGoawayAck_;
     return 0;
   }
+  if (coalesceControlFrames_) {
+    // merged with any other updates for this stream at flush time; the
+    // nominal frame size keeps callers scheduling the flushing write
+    pendingWindowUpdates_[stream] += delta;
+    return http2::kFrameHeaderSize + 4;
+  }
   return generateHeaderCallbackWrapper(stream, http2::FrameType::WINDOW_UPDATE,
                                        http2::writeWindowUpdate(writeBuf, stream, delta));
 }
 
+size_t HTTP2Codec::generateDeferredFrames(folly::IOBufQueue& writeBuf) {
+  size_t bytes = 0;
+  for (const auto& update : pendingWindowUpdates_) {
+    if (!isStreamIngressEgressAllowed(update.first)) {
+      continue;
+    }
+    // deltas merged per stream; a delta can't exceed the window bound
+    // since the individual updates were bounded by bytes processed
+    bytes += generateHeaderCallbackWrapper(
+        update.first,
+        http2::FrameType::WINDOW_UPDATE,
+        http2::writeWindowUpdate(
+            writeBuf, update.first, folly::to<uint32_t>(update.second)));
+  }
+  pendingWindowUpdates_.clear();
+  while (pendingSettingsAcks_ > 0) {
+    pendingSettingsAcks_--;
+    bytes += generateHeaderCallbackWrapper(
+        0,
+        http2::FrameType::SETTINGS,
+        http2::writeSettingsAck(writeBuf));
+  }
+  return bytes;
+}
+
 size_t HTTP2Codec::generatePriority(folly::IOBufQueue& writeBuf,
                                     StreamID stream,
                                     const HTTPMessage::HTTPPriority& pri) {
@@ -1630,6 +1929,13 @@ size_t HTTP2Codec::generateCertificateRequest(
       writeBuf, requestId, std::move(certificateRequestData));
 }
 
+size_t HTTP2Codec::generateMetadata(folly::IOBufQueue& writeBuf,
+                                    StreamID stream,
+                                    std::unique_ptr<folly::IOBuf> metadata) {
+  VLOG(4) << "generating METADATA for stream=" << stream;
+  return http2::writeMetadata(writeBuf, stream, std::move(metadata));
+}
+
 size_t HTTP2Codec::generateCertificate(folly::IOBufQueue& writeBuf,
                                        uint16_t certId,
                                        std::unique_ptr<folly::IOBuf> certData) {
@@ -15,8 +15,10 @@
 #include <proxygen/lib/http/codec/HTTPParallelCodec.h>
 #include <proxygen/lib/http/codec/HTTPSettings.h>
 #include <proxygen/lib/http/codec/compress/HPACKCodec.h>
+#include <proxygen/lib/transport/SettingsResumptionCache.h>
 
 #include <bitset>
+#include <map>
 #include <set>
 
 namespace proxygen {
@@ -28,7 +30,7 @@ namespace proxygen {
 class HTTP2Codec: public HTTPParallelCodec, HPACK::StreamingCallback {
 public:
   void onHeader(const HPACKHeaderName& name,
-                const folly::fbstring& value) override;
+                folly::StringPiece value) override;
   void onHeadersComplete(HTTPHeaderSize decodedSize, bool acknowledge) override;
   void onDecodeError(HPACK::DecodeError decodeError) override;
 
@@ -62,6 +64,28 @@ public:
                            StreamID assocStream,
                            bool eom = false,
                            HTTPHeaderSize* size = nullptr) override;
+
+  /**
+   * Pre-encode a message's header block once for fan-out. The block is
+   * produced by a detached encoder with a zero-size dynamic table, so
+   * it performs no inserts, references no dynamic entries and emits no
+   * table size updates - it can be replayed on any stream for the life
+   * of the connection, at static-table compression ratio.
+   */
+  std::shared_ptr<folly::IOBuf> encodeSharedHeaderBlock(
+      const HTTPMessage& msg, HTTPHeaderSize* size = nullptr);
+
+  /**
+   * Generate HEADERS (or PUSH_PROMISE when assocStream is set) for
+   * stream by replaying a block from encodeSharedHeaderBlock, sharing
+   * one serialization across any number of streams.
+   */
+  void generateSharedHeader(
+      folly::IOBufQueue& writeBuf,
+      StreamID stream,
+      const folly::IOBuf& encodedBlock,
+      bool eom = false,
+      const folly::Optional<StreamID>& assocStream = folly::none);
   void generateExHeader(folly::IOBufQueue& writeBuf,
                         StreamID stream,
                         const HTTPMessage& msg,
@@ -107,6 +131,33 @@ public:
       folly::IOBufQueue& writeBuf,
       uint16_t requestId,
       std::unique_ptr<folly::IOBuf> certificateRequestData) override;
+  /**
+   * Pack DATA payloads at or under this size into the write buffer's
+   * contiguous tail (one block per small response) instead of chaining
+   * them; trades a small copy for fewer gather segments and full TLS
+   * records.  0 (default) keeps zero-copy chaining for all sizes.
+   */
+  void setEgressPackingThreshold(uint32_t bytes) {
+    egressPackingThreshold_ = bytes;
+  }
+
+  /**
+   * Settings resumption for proxygen-to-proxygen meshes: on reconnect
+   * to a peer whose last acknowledged SETTINGS exchange is cached,
+   * generateSettings elides unchanged settings and sends a
+   * fingerprint of the full set (SETTINGS_RESUMPTION_FINGERPRINT);
+   * the receiving codec restores the elided values from its own cache
+   * and verifies the fingerprint over the merged set, so a stale
+   * cache fails the connection instead of silently diverging the
+   * config (the application should then invalidate() and reconnect).
+   * Enable on both ends, before the preface, with a stable peer key.
+   */
+  void enableSettingsResumption(
+      std::shared_ptr<SettingsResumptionCache> cache, std::string peerKey);
+
+  size_t generateMetadata(folly::IOBufQueue& writeBuf,
+                          StreamID stream,
+                          std::unique_ptr<folly::IOBuf> metadata) override;
   size_t generateCertificate(folly::IOBufQueue& writeBuf,
                              uint16_t certId,
                              std::unique_ptr<folly::IOBuf> certData) override;
@@ -120,21 +171,25 @@ public:
   bool supportsPushTransactions() const override {
     return
       (transportDirection_ == TransportDirection::DOWNSTREAM &&
-       ingressSettings_.getSetting(SettingsId::ENABLE_PUSH, 1)) ||
+       ingressSettings_.snapshot().enablePush) ||
       (transportDirection_ == TransportDirection::UPSTREAM &&
-       egressSettings_.getSetting(SettingsId::ENABLE_PUSH, 1));
+       egressSettings_.snapshot().enablePush);
   }
   bool peerHasWebsockets() const {
     return ingressSettings_.getSetting(SettingsId::ENABLE_CONNECT_PROTOCOL);
   }
   bool supportsExTransactions() const override {
-    return ingressSettings_.getSetting(SettingsId::ENABLE_EX_HEADERS, 0) &&
-      egressSettings_.getSetting(SettingsId::ENABLE_EX_HEADERS, 0);
+    return ingressSettings_.snapshot().enableExHeaders &&
+        egressSettings_.snapshot().enableExHeaders;
   }
   void setHeaderCodecStats(HeaderCodec::Stats* hcStats) override {
     headerCodec_.setStats(hcStats);
   }
 
+  void setEgressHeaderTableSize(uint32_t size) override {
+    headerCodec_.setEncoderHeaderTableSize(size);
+  }
+
   bool isRequest(StreamID id) const {
     return ((transportDirection_ == TransportDirection::DOWNSTREAM &&
              (id & 0x1) == 1) ||
@@ -183,6 +238,29 @@ public:
     validateHeaders_ = validate;
   }
 
+  /**
+   * Defer non-urgent control frames (WINDOW_UPDATE, SETTINGS ack) and
+   * emit them merged at the end of the write-loop flush via
+   * generateDeferredFrames: consecutive window updates for the same
+   * stream collapse into one frame. Ping acks stay immediate since the
+   * session positions them for byte-event accounting.
+   */
+  void setControlFrameCoalescing(bool enabled) {
+    coalesceControlFrames_ = enabled;
+  }
+
+  size_t generateDeferredFrames(folly::IOBufQueue& writeBuf) override;
+
+  /**
+   * Decode header blocks fragment-at-a-time as HEADERS/CONTINUATION
+   * frames arrive, instead of assembling the full block in
+   * curHeaderBlock_ first. Bounds memory for jumbo blocks and surfaces
+   * compression errors on the fragment that caused them.
+   */
+  void setStreamingHeaderDecode(bool enabled) {
+    streamingHeaderDecode_ = enabled;
+  }
+
  private:
   size_t splitCompressed(size_t compressed,
                          uint32_t remainingFrameSize,
@@ -213,6 +291,7 @@ public:
   ErrorCode parseHeaders(folly::io::Cursor& cursor);
   ErrorCode parseExHeaders(folly::io::Cursor& cursor);
   ErrorCode parsePriority(folly::io::Cursor& cursor);
+  ErrorCode parseMetadata(folly::io::Cursor& cursor);
   ErrorCode parseRstStream(folly::io::Cursor& cursor);
   ErrorCode parseSettings(folly::io::Cursor& cursor);
   ErrorCode parsePushPromise(folly::io::Cursor& cursor);
@@ -241,13 +320,12 @@ public:
   bool checkConnectionError(ErrorCode, const folly::IOBuf* buf);
   ErrorCode handleSettings(const std::deque<SettingPair>& settings);
   void handleSettingsAck();
+  // per-frame hot paths; direct loads off the sealed settings snapshot
   size_t maxSendFrameSize() const {
-    return (uint32_t)ingressSettings_.getSetting(SettingsId::MAX_FRAME_SIZE,
-                                       http2::kMaxFramePayloadLengthMin);
+    return ingressSettings_.snapshot().maxFrameSize;
   }
   uint32_t maxRecvFrameSize() const {
-    return (uint32_t)egressSettings_.getSetting(SettingsId::MAX_FRAME_SIZE,
-                                      http2::kMaxFramePayloadLengthMin);
+    return egressSettings_.snapshot().maxFrameSize;
   }
   void streamError(const std::string& msg, ErrorCode error, bool newTxn=false);
   bool parsingTrailers() const;
@@ -297,7 +375,14 @@ public:
   HeaderDecodeInfo decodeInfo_;
   std::vector<StreamID> virtualPriorityNodes_;
   folly::Optional<uint32_t> pendingTableMaxSize_;
+  // settings resumption (see enableSettingsResumption)
+  std::shared_ptr<SettingsResumptionCache> settingsResumptionCache_;
+  std::string settingsResumptionPeer_;
+  // what generateSettings last put on the wire (full set, pre-elision);
+  // cached as acknowledged when the peer's ACK arrives
+  folly::Optional<SettingsResumptionCache::Settings> sentSettingsPendingAck_;
   bool reuseIOBufHeadroomForData_{true};
+  uint32_t egressPackingThreshold_{0};
 
   // True if last parsed HEADERS frame was trailers.
   // Reset only when HEADERS frame is parsed, thus
@@ -308,6 +393,14 @@ public:
   bool parsingDownstreamTrailers_{false};
   bool addDateToResponse_{true};
   bool validateHeaders_{true};
+  bool streamingHeaderDecode_{false};
+  // compressed bytes of the in-progress block when streaming decode is on
+  uint32_t curBlockCompressedBytes_{0};
+
+  // control-frame coalescing state
+  bool coalesceControlFrames_{false};
+  std::map<StreamID, uint64_t> pendingWindowUpdates_;
+  uint32_t pendingSettingsAcks_{0};
 
   // CONTINUATION frame can follow either HEADERS or PUSH_PROMISE frames.
   // Keeps frame type of iniating frame of header block.
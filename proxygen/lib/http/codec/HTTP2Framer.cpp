@@ -686,8 +686,14 @@ writeData(IOBufQueue& queue,
     flags |= END_STREAM;
   }
   const uint64_t dataLen = data ? data->computeChainDataLength() : 0;
+  std::unique_ptr<IOBuf> inlinePayload;
+  if (packPayload) {
+    // copy the payload into the queue's contiguous tail right behind
+    // the frame header, instead of chaining it: small responses come
+    // out as one block, sized for a socket write or TLS record
+    inlinePayload = std::move(data);
+  }
   // Caller must not exceed peer setting for MAX_FRAME_SIZE
-  // TODO: look into using headroom from data to hold the frame header
   const auto frameLen = writeFrameHeader(queue,
                                          dataLen,
                                          FrameType::DATA,
@@ -696,7 +702,10 @@ writeData(IOBufQueue& queue,
                                          padding,
                                          folly::none,
                                          std::move(data),
-                                         reuseIOBufHeadroom);
+                                         !packPayload && reuseIOBufHeadroom);
+  if (inlinePayload) {
+    queue.append(std::move(inlinePayload), true /* pack */);
+  }
   writePadding(queue, padding);
   return kFrameHeaderSize + frameLen;
 }
@@ -914,6 +923,23 @@ writePing(IOBufQueue& queue,
   return kFrameHeaderSize + frameLen;
 }
 
+size_t writeMetadata(IOBufQueue& queue,
+                     uint32_t stream,
+                     std::unique_ptr<IOBuf> metadata) noexcept {
+  uint32_t payloadLen = metadata ? metadata->computeChainDataLength() : 0;
+  DCHECK_EQ(0, ~kLengthMask & payloadLen);
+  const auto frameLen = writeFrameHeader(queue,
+                                         payloadLen,
+                                         FrameType::METADATA,
+                                         0,
+                                         stream,
+                                         kNoPadding,
+                                         folly::none,
+                                         nullptr);
+  queue.append(std::move(metadata));
+  return kFrameHeaderSize + frameLen;
+}
+
 size_t
 writeGoaway(IOBufQueue& queue,
             uint32_t lastStreamID,
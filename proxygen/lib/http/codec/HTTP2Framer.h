@@ -47,6 +47,10 @@ enum class FrameType : uint8_t {
   // experimental use
   EX_HEADERS = 0xfb,
 
+  // Opaque per-stream metadata, carried outside header compression.
+  // Type value matches the METADATA extension frame in common use.
+  METADATA = 0x4d,
+
   // For secondary certificate authentication in HTTP/2 as specified in the
   // draft-ietf-httpbis-http2-secondary-certs-02.
   CERTIFICATE_REQUEST = 0xf0,
@@ -394,6 +398,11 @@ parseCertificate(
  * @param endStream True iff this frame ends the stream.
  * @param reuseIOBufHeadroom If HTTP2Framer should reuse headroom in data if
  *                           headroom is enough for frame header
+ * @param packPayload If set, copy the payload into the queue's
+ *                    contiguous tail behind the frame header instead of
+ *                    chaining it; for small frames this produces one
+ *                    block per response at the cost of the copy.
+ *                    Mutually exclusive with headroom reuse.
  * @return The number of bytes written to writeBuf.
  */
 size_t
@@ -402,7 +411,8 @@ writeData(folly::IOBufQueue& writeBuf,
           uint32_t stream,
           folly::Optional<uint8_t> padding,
           bool endStream,
-          bool reuseIOBufHeadroom) noexcept;
+          bool reuseIOBufHeadroom,
+          bool packPayload = false) noexcept;
 
 /**
  * Generate an entire HEADERS frame, including the common frame header. The
@@ -662,6 +672,18 @@ writeCertificateRequest(folly::IOBufQueue& writeBuf,
  * fragment.
  * @return The number of bytes written to writeBuf.
  */
+/**
+ * Generate an entire METADATA frame: opaque per-stream payload that
+ * never touches header compression.
+ *
+ * @param queue the queue to write to
+ * @param stream the stream the metadata applies to
+ * @param metadata the opaque payload
+ */
+size_t writeMetadata(folly::IOBufQueue& queue,
+                     uint32_t stream,
+                     std::unique_ptr<folly::IOBuf> metadata) noexcept;
+
 size_t writeCertificate(folly::IOBufQueue& writeBuf,
                         uint16_t certId,
                         std::unique_ptr<folly::IOBuf> authenticator,
@@ -18,7 +18,7 @@ namespace proxygen {
  * only examines the calls and callbacks that go through it.
  */
 
-class HTTPChecks: public PassThroughHTTPCodecFilter {
+class HTTPChecks final : public PassThroughHTTPCodecFilter {
  public:
   // HTTPCodec::Callback methods
 
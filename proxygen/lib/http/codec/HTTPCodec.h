@@ -238,6 +238,15 @@ class HTTPCodec {
      */
     virtual void onPingRequest(uint64_t /* data */) {}
 
+    /**
+     * Called upon receipt of an opaque per-stream METADATA frame.  The
+     * payload never touches header compression, so a proxy can forward
+     * it byte-identical with generateMetadata on the egress codec.
+     */
+    virtual void onMetadata(StreamID /* stream */,
+                            std::unique_ptr<folly::IOBuf> /* metadata */) {
+    }
+
     /**
      * Called upon receipt of a ping reply
      * @param data data attached to the ping reply
@@ -338,6 +347,15 @@ class HTTPCodec {
     virtual ~Callback() {}
   };
 
+  /**
+   * Body IOBufs handed to sendBody with at least this much headroom let
+   * framed codecs write their frame headers in place (see
+   * http2::writeFrameHeader), making DATA framing allocation-free and
+   * keeping the egress chain unfragmented. Covers the HTTP/2 9-byte
+   * frame header plus padding and HTTP/3 varint frame headers.
+   */
+  static constexpr size_t kMaxFrameHeadroom = 16;
+
   virtual ~HTTPCodec() {}
 
   /**
@@ -349,6 +367,30 @@ class HTTPCodec {
     return defaultCompressionInfo;
   }
 
+  /**
+   * Generate any frames the codec deferred during this loop iteration
+   * (see HTTP2Codec::setControlFrameCoalescing). Returns the number of
+   * bytes written; codecs that never defer return 0.
+   */
+  virtual size_t generateDeferredFrames(folly::IOBufQueue& /*writeBuf*/) {
+    return 0;
+  }
+
+  /**
+   * Whether this codec can be restored to its freshly-constructed state
+   * via reset() and reused for a new connection.
+   */
+  virtual bool isRecyclable() const {
+    return false;
+  }
+
+  /**
+   * Restore the codec to its freshly-constructed state, dropping all
+   * per-connection state. Only valid when isRecyclable() returns true.
+   */
+  virtual void reset() {
+  }
+
   /**
    * Gets the session protocol currently used by the codec. This can be
    * mapped to a string for logging and diagnostic use.
@@ -595,6 +637,17 @@ class HTTPCodec {
       folly::IOBufQueue& /* writeBuf */,
       uint64_t /* data */) { return 0; }
 
+  /**
+   * Generate an opaque per-stream METADATA frame, pass-through safe
+   * (no compression state involved).  Returns 0 on protocols without
+   * metadata support.
+   */
+  virtual size_t generateMetadata(folly::IOBufQueue& /* writeBuf */,
+                                  StreamID /* stream */,
+                                  std::unique_ptr<folly::IOBuf> /* metadata */) {
+    return 0;
+  }
+
   /**
    * Generate a settings message, if supported in the
    * protocol implemented by the codec.
@@ -684,6 +737,16 @@ class HTTPCodec {
    */
   virtual StreamID getLastIncomingStreamID() const { return 0; }
 
+  /**
+   * Shrink or restore the egress header-compression dynamic table.
+   * Size changes are signaled in-band (HPACK emits a table size update
+   * with the next header block), so this is always protocol-safe; 0
+   * releases the encoder table entirely, e.g. for idle-session
+   * hibernation.  No-op for codecs without header compression.
+   */
+  virtual void setEgressHeaderTableSize(uint32_t /*size*/) {
+  }
+
   /**
    * Get the default size of flow control windows for this protocol
    */
@@ -98,6 +98,11 @@ void PassThroughHTTPCodecFilter::onPingRequest(uint64_t data) {
   callback_->onPingRequest(data);
 }
 
+void PassThroughHTTPCodecFilter::onMetadata(
+    StreamID stream, std::unique_ptr<folly::IOBuf> metadata) {
+  callback_->onMetadata(stream, std::move(metadata));
+}
+
 void PassThroughHTTPCodecFilter::onPingReply(uint64_t data) {
   callback_->onPingReply(data);
 }
@@ -372,6 +377,10 @@ void PassThroughHTTPCodecFilter::enableDoubleGoawayDrain() {
   return call_->enableDoubleGoawayDrain();
 }
 
+void PassThroughHTTPCodecFilter::setEgressHeaderTableSize(uint32_t size) {
+  call_->setEgressHeaderTableSize(size);
+}
+
 void PassThroughHTTPCodecFilter::setHeaderCodecStats(
     HeaderCodec::Stats* stats) {
   call_->setHeaderCodecStats(stats);
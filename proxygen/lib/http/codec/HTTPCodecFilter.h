@@ -79,6 +79,9 @@ class PassThroughHTTPCodecFilter: public HTTPCodecFilter {
 
   void onPingRequest(uint64_t data) override;
 
+  void onMetadata(StreamID stream,
+                  std::unique_ptr<folly::IOBuf> metadata) override;
+
   void onPingReply(uint64_t data) override;
 
   void onWindowUpdate(StreamID stream, uint32_t amount) override;
@@ -209,6 +212,8 @@ class PassThroughHTTPCodecFilter: public HTTPCodecFilter {
 
   size_t generateSettingsAck(folly::IOBufQueue& writeBuf) override;
 
+  size_t generateDeferredFrames(folly::IOBufQueue& writeBuf) override;
+
   size_t generateWindowUpdate(folly::IOBufQueue& writeBuf,
                               StreamID stream,
                               uint32_t delta) override;
@@ -233,6 +238,8 @@ class PassThroughHTTPCodecFilter: public HTTPCodecFilter {
 
   void setHeaderCodecStats(HeaderCodec::Stats* stats) override;
 
+  void setEgressHeaderTableSize(uint32_t size) override;
+
   void enableDoubleGoawayDrain() override;
 
   HTTPCodec::StreamID getLastIncomingStreamID() const override;
@@ -54,7 +54,8 @@ class HTTPRequestVerifier {
     }
     hasPath_ = true;
     assert(msg_ != nullptr);
-    msg_->setURL(path.str());
+    // decomposition is deferred until a handler looks at path/query
+    msg_->setURLLazy(path.str());
     return true;
   }
 
@@ -12,6 +12,32 @@
 
 namespace proxygen {
 
+namespace {
+
+// Per-worker intern pool.  A worker sees only a handful of distinct
+// negotiated configurations across its thousands of sessions, so a
+// linear scan over weak entries is cheap; dead entries are swept as
+// they are encountered.
+std::shared_ptr<const SettingsSnapshot> internSnapshot(
+    const SettingsSnapshot& snapshot) {
+  static thread_local std::vector<std::weak_ptr<const SettingsSnapshot>> pool;
+  for (auto it = pool.begin(); it != pool.end();) {
+    if (auto existing = it->lock()) {
+      if (*existing == snapshot) {
+        return existing;
+      }
+      ++it;
+    } else {
+      it = pool.erase(it);
+    }
+  }
+  auto interned = std::make_shared<const SettingsSnapshot>(snapshot);
+  pool.emplace_back(interned);
+  return interned;
+}
+
+} // anonymous namespace
+
 void HTTPSettings::setSetting(SettingsId id, SettingsValue val) {
   auto iter = getSettingIter(id);
   if (iter != settings_.end()) {
@@ -19,6 +45,7 @@ void HTTPSettings::setSetting(SettingsId id, SettingsValue val) {
   } else {
     settings_.emplace_back(id, val);
   }
+  snapshot_.reset();
 }
 
 void HTTPSettings::unsetSetting(SettingsId id) {
@@ -26,7 +53,45 @@ void HTTPSettings::unsetSetting(SettingsId id) {
   if (iter != settings_.end()) {
     *iter = settings_.back();
     settings_.pop_back();
+    snapshot_.reset();
+  }
+}
+
+void HTTPSettings::compileSnapshot() const {
+  SettingsSnapshot snapshot;
+  for (const auto& setting : settings_) {
+    auto value = (uint32_t)setting.value;
+    switch (setting.id) {
+      case SettingsId::HEADER_TABLE_SIZE:
+        snapshot.headerTableSize = value;
+        break;
+      case SettingsId::ENABLE_PUSH:
+        snapshot.enablePush = value;
+        break;
+      case SettingsId::MAX_CONCURRENT_STREAMS:
+        snapshot.maxConcurrentStreams = value;
+        break;
+      case SettingsId::INITIAL_WINDOW_SIZE:
+        snapshot.initialWindowSize = value;
+        break;
+      case SettingsId::MAX_FRAME_SIZE:
+        snapshot.maxFrameSize = value;
+        break;
+      case SettingsId::MAX_HEADER_LIST_SIZE:
+        snapshot.maxHeaderListSize = value;
+        break;
+      case SettingsId::ENABLE_EX_HEADERS:
+        snapshot.enableExHeaders = value;
+        break;
+      case SettingsId::ENABLE_CONNECT_PROTOCOL:
+        snapshot.enableConnectProtocol = value;
+        break;
+      default:
+        // settings outside the snapshot stay on the vector path
+        break;
+    }
   }
+  snapshot_ = internSnapshot(snapshot);
 }
 
 const HTTPSetting* HTTPSettings::getSetting(SettingsId id) const {
@@ -8,7 +8,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <initializer_list>
+#include <limits>
+#include <memory>
 #include <proxygen/lib/http/codec/SettingsId.h>
 #include <vector>
 
@@ -31,6 +34,38 @@ struct HTTPSetting {
   SettingsValue value;
 };
 
+/**
+ * Sealed, flattened view of the well-known settings.  After a SETTINGS
+ * exchange the vector is compiled into this POD so hot-path consumers
+ * (frame size checks, push/ex-headers capability tests) do direct member
+ * loads instead of scanning the vector.  Fields default to the RFC 7540
+ * values; maxHeaderListSize uses 0 for "unlimited" like the existing
+ * call sites.  Identical snapshots are interned per thread, so the
+ * sessions on a worker with the same negotiated configuration share a
+ * single copy.
+ */
+struct SettingsSnapshot {
+  uint32_t headerTableSize{4096};
+  uint32_t enablePush{1};
+  uint32_t maxConcurrentStreams{std::numeric_limits<uint32_t>::max()};
+  uint32_t initialWindowSize{65535};
+  uint32_t maxFrameSize{16384};
+  uint32_t maxHeaderListSize{0};
+  uint32_t enableExHeaders{0};
+  uint32_t enableConnectProtocol{0};
+
+  bool operator==(const SettingsSnapshot& other) const {
+    return headerTableSize == other.headerTableSize &&
+           enablePush == other.enablePush &&
+           maxConcurrentStreams == other.maxConcurrentStreams &&
+           initialWindowSize == other.initialWindowSize &&
+           maxFrameSize == other.maxFrameSize &&
+           maxHeaderListSize == other.maxHeaderListSize &&
+           enableExHeaders == other.enableExHeaders &&
+           enableConnectProtocol == other.enableConnectProtocol;
+  }
+};
+
 class HTTPSettings {
  public:
   // HTTP/2 Defaults
@@ -53,6 +88,27 @@ class HTTPSettings {
   void unsetSetting(SettingsId id);
   const HTTPSetting* getSetting(SettingsId id) const;
   SettingsValue getSetting(SettingsId id, SettingsValue defaultVal) const;
+  /**
+   * The sealed snapshot of the current values; compiled (and interned)
+   * on first use after any mutation.  The reference stays valid until
+   * the next setSetting/unsetSetting/clearSettings.
+   */
+  const SettingsSnapshot& snapshot() const {
+    if (!snapshot_) {
+      compileSnapshot();
+    }
+    return *snapshot_;
+  }
+  /**
+   * Shared handle to the interned snapshot, for holders that outlive
+   * this object or want to compare configurations by pointer.
+   */
+  std::shared_ptr<const SettingsSnapshot> sharedSnapshot() const {
+    if (!snapshot_) {
+      compileSnapshot();
+    }
+    return snapshot_;
+  }
   // Note: this does not count disabled settings
   std::size_t getNumSettings() const {
     return settings_.size();
@@ -62,6 +118,7 @@ class HTTPSettings {
   }
   void clearSettings() {
     settings_.clear();
+    snapshot_.reset();
   }
 
  private:
@@ -71,10 +128,14 @@ class HTTPSettings {
   std::vector<HTTPSetting>::const_iterator getSettingConstIter(
       SettingsId id) const;
 
+  void compileSnapshot() const;
+
   // TODO: evaluate whether using a list or default initializing vector with
   // all settings so that size == capacity (else on push_backs capacity is
   // likely to be > size)
   std::vector<HTTPSetting> settings_;
+  // lazily compiled from settings_; reset by mutators
+  mutable std::shared_ptr<const SettingsSnapshot> snapshot_;
 };
 
 using SettingsList = std::vector<HTTPSetting>;
@@ -13,7 +13,7 @@ using std::string;
 namespace proxygen {
 
 bool HeaderDecodeInfo::onHeader(const HPACKHeaderName& name,
-                                const folly::fbstring& value) {
+                                folly::StringPiece value) {
   // Refuse decoding other headers if an error is already found
   if (decodeError != HPACK::DecodeError::NONE
       || parsingError != "") {
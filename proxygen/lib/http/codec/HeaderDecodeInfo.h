@@ -33,7 +33,7 @@ class HeaderDecodeInfo {
     verifier.reset(msg.get());
   }
 
-  bool onHeader(const HPACKHeaderName& name, const folly::fbstring& value);
+  bool onHeader(const HPACKHeaderName& name, folly::StringPiece value);
 
   void onHeadersComplete(HTTPHeaderSize decodedSize);
 
@@ -574,7 +574,7 @@ unique_ptr<IOBuf> SPDYCodec::serializeResponseHeaders(
   // See comment above regarding status
   string date;
   if (!headers.exists(HTTP_HEADER_DATE)) {
-    date = HTTPMessage::formatDateHeader();
+    date = HTTPMessage::getDateHeader();
     allHeaders.emplace_back(HTTP_HEADER_DATE, date);
   }
 
@@ -34,6 +34,12 @@ enum class SettingsId : uint64_t {
   ENABLE_EX_HEADERS = 0xfbfb,
   THRIFT_CHANNEL_ID = 0xf100,
 
+  // Settings resumption for proxygen-to-proxygen meshes: value is a
+  // fingerprint of the sender's full settings set; unchanged settings
+  // are elided and restored from the receiver's cache (see
+  // SettingsResumptionCache)
+  SETTINGS_RESUMPTION_FINGERPRINT = 0xfbfc,
+
   // For secondary authentication in HTTP/2
   SETTINGS_HTTP_CERT_AUTH = 0xff00,
 
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/codec/compress/AdaptiveIndexingStrategy.h>
+
+#include <algorithm>
+#include <folly/hash/Hash.h>
+#include <limits>
+
+namespace proxygen {
+
+bool AdaptiveIndexingStrategy::indexHeader(const HPACKHeaderName& name,
+                                           folly::StringPiece value) const {
+  // headers the default strategy refuses to index stay unindexed
+  if (!HeaderIndexingStrategy::indexHeader(name, value)) {
+    return false;
+  }
+  const uint64_t nameHash =
+      folly::hash::fnv64_buf(name.get().data(), name.get().size());
+  const uint64_t valueHash = folly::hash::fnv64_buf(value.data(), value.size());
+  return increment(folly::hash::hash_128_to_64(nameHash, valueHash)) >=
+      kIndexThreshold;
+}
+
+uint8_t AdaptiveIndexingStrategy::increment(uint64_t hash) const {
+  uint8_t estimate = std::numeric_limits<uint8_t>::max();
+  for (size_t row = 0; row < kDepth; row++) {
+    // each row consumes a different slice of the 64-bit hash
+    const size_t idx = (hash >> (row * 16)) & (kWidth - 1);
+    uint8_t& counter = sketch_[row][idx];
+    if (counter < std::numeric_limits<uint8_t>::max()) {
+      counter++;
+    }
+    estimate = std::min(estimate, counter);
+  }
+  return estimate;
+}
+
+} // namespace proxygen
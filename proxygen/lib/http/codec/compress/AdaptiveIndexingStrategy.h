@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <proxygen/lib/http/codec/compress/HeaderIndexingStrategy.h>
+
+namespace proxygen {
+
+/**
+ * Indexing strategy that learns per-connection header recurrence: a
+ * header value is only admitted to the dynamic table once it has been
+ * seen kIndexThreshold times on this connection, tracked by a small
+ * count-min sketch. One-shot values (request ids, signatures) stay out
+ * of the table while stable ones (auth tokens, user agents) get
+ * indexed as soon as they repeat.
+ *
+ * Unlike the stateless singleton strategies, an instance of this class
+ * accumulates per-connection state: install a separate instance per
+ * codec via HPACKCodec::setHeaderIndexingStrategy and keep it alive as
+ * long as the codec.
+ */
+class AdaptiveIndexingStrategy : public HeaderIndexingStrategy {
+ public:
+  static constexpr uint8_t kIndexThreshold = 2;
+
+  AdaptiveIndexingStrategy() : HeaderIndexingStrategy() {}
+
+  bool indexHeader(const HPACKHeaderName& name,
+                   folly::StringPiece value) const override;
+
+ private:
+  static constexpr size_t kDepth = 4;
+  static constexpr size_t kWidth = 512; // power of two
+
+  // count-min: increment with saturation, return the min estimate
+  uint8_t increment(uint64_t hash) const;
+
+  mutable std::array<std::array<uint8_t, kWidth>, kDepth> sketch_{};
+};
+
+} // namespace proxygen
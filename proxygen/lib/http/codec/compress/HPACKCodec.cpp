@@ -46,6 +46,11 @@ HPACKCodec::HPACKCodec(TransportDirection /*direction*/)
     : encoder_(true, HPACK::kTableSize),
       decoder_(HPACK::kTableSize, maxUncompressed_) {}
 
+HPACKCodec::HPACKCodec(TransportDirection /*direction*/,
+                       uint32_t encoderTableSize)
+    : encoder_(true, encoderTableSize),
+      decoder_(HPACK::kTableSize, maxUncompressed_) {}
+
 unique_ptr<IOBuf> HPACKCodec::encode(vector<Header>& headers) noexcept {
   folly::ThreadLocal<std::vector<HPACKHeader>> preparedTL;
   auto& prepared = *preparedTL.get();
@@ -152,7 +157,7 @@ void HPACKCodec::encodeHTTP(
 
   if (includeDate && msg.isResponse() && !hasDateHeader) {
     uncompressed += encoder_.encodeHeader(
-      HTTP_HEADER_DATE, HTTPMessage::formatDateHeader());
+      HTTP_HEADER_DATE, HTTPMessage::getDateHeader());
   }
 
   encoder_.completeEncode();
@@ -191,6 +196,15 @@ void HPACKCodec::decodeStreaming(
   decoder_.decodeStreaming(cursor, length, streamingCb);
 }
 
+void HPACKCodec::decodeStreamingPartial(
+    Cursor& cursor,
+    uint32_t length,
+    bool last,
+    HPACK::StreamingCallback* streamingCb) noexcept {
+  streamingCb->stats = stats_;
+  decoder_.decodeStreamingPartial(cursor, length, last, streamingCb);
+}
+
 void HPACKCodec::describe(std::ostream& stream) const {
   stream << "DecoderTable:\n" << decoder_;
   stream << "EncoderTable:\n" << encoder_;
@@ -41,6 +41,16 @@ uint32_t prepareHeaders(
 class HPACKCodec : public HeaderCodec {
  public:
   explicit HPACKCodec(TransportDirection direction);
+
+  /**
+   * Codec whose encoder uses the given dynamic table size. With size 0
+   * the encoder emits blocks that never touch connection compression
+   * state (no inserts, no dynamic references, no table size updates),
+   * which makes them replayable across streams and connections; see
+   * HTTP2Codec::encodeSharedHeaderBlock.
+   */
+  HPACKCodec(TransportDirection direction, uint32_t encoderTableSize);
+
   ~HPACKCodec() override {
   }
 
@@ -61,6 +71,15 @@ class HPACKCodec : public HeaderCodec {
                        uint32_t length,
                        HPACK::StreamingCallback* streamingCb) noexcept;
 
+  /**
+   * Decode a header block fragment-at-a-time; see
+   * HPACKDecoder::decodeStreamingPartial.
+   */
+  void decodeStreamingPartial(folly::io::Cursor& cursor,
+                              uint32_t length,
+                              bool last,
+                              HPACK::StreamingCallback* streamingCb) noexcept;
+
   void setEncoderHeaderTableSize(uint32_t size) {
     encoder_.setHeaderTableSize(size);
   }
@@ -89,6 +108,37 @@ class HPACKCodec : public HeaderCodec {
                            0, 0, decoder_.getStaticRefs());
   }
 
+  /**
+   * Dynamic-table migration for meshes where both ends run this stack:
+   * export a connection's table entries (newest last, i.e. insertion
+   * order) and seed them into the replacement connection's codec
+   * BEFORE any header traffic, on BOTH ends in the same order - the
+   * wire protocol indexes into these tables, so an asymmetric or late
+   * seed corrupts decoding.  The transfer channel and the agreement to
+   * seed are the migration layer's job; a warmed table skips the
+   * minutes of cold-compression bandwidth after reconnects.
+   */
+  std::vector<HPACKHeader> getEncoderTableState() const {
+    return tableState(encoder_.getTable());
+  }
+
+  std::vector<HPACKHeader> getDecoderTableState() const {
+    return tableState(decoder_.getTable());
+  }
+
+  void seedEncoderTable(std::vector<HPACKHeader> entries) {
+    encoder_.seedHeaderTable(entries);
+  }
+
+  void seedDecoderTable(std::vector<HPACKHeader> entries) {
+    decoder_.seedHeaderTable(entries);
+  }
+
+  // see HPACKEncoder::setEncodePlanCacheEnabled
+  void setEncodePlanCacheEnabled(bool enabled) {
+    encoder_.setEncodePlanCacheEnabled(enabled);
+  }
+
   void setHeaderIndexingStrategy(const HeaderIndexingStrategy* indexingStrat) {
     encoder_.setHeaderIndexingStrategy(indexingStrat);
   }
@@ -101,6 +151,17 @@ class HPACKCodec : public HeaderCodec {
   HPACKDecoder decoder_;
 
  private:
+  static std::vector<HPACKHeader> tableState(const HeaderTable& table) {
+    // external index 1 is the newest entry; emit oldest-first so
+    // seeding replays the original insertion order
+    std::vector<HPACKHeader> entries;
+    entries.reserve(table.size());
+    for (uint32_t i = table.size(); i >= 1; i--) {
+      entries.push_back(table.getHeader(i).copy());
+    }
+    return entries;
+  }
+
   void recordCompressedSize(const folly::IOBuf* buf);
   void recordCompressedSize(size_t size);
 
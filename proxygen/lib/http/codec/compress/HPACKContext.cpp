@@ -54,7 +54,12 @@ uint32_t HPACKContext::getIndex(const HPACKHeaderName& name,
 }
 
 uint32_t HPACKContext::nameIndex(const HPACKHeaderName& headerName) const {
-  uint32_t index = getStaticTable().nameIndex(headerName);
+  // every static table name is a common header, so non-common names
+  // can't match and common ones resolve with one array load
+  const auto code = headerName.getHeaderCode();
+  uint32_t index = (code == HTTP_HEADER_OTHER)
+      ? 0
+      : getStaticTable().nameIndexByCode(code);
   if (index) {
     staticRefs_++;
     return staticToGlobalIndex(index);
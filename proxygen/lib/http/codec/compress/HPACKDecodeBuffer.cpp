@@ -8,6 +8,8 @@
 
 #include <proxygen/lib/http/codec/compress/HPACKDecodeBuffer.h>
 
+#include <algorithm>
+
 #include <limits>
 #include <memory>
 #include <proxygen/lib/http/codec/compress/Huffman.h>
@@ -55,6 +57,20 @@ DecodeError HPACKDecodeBuffer::decodeLiteral(folly::fbstring& literal) {
 
 DecodeError HPACKDecodeBuffer::decodeLiteral(uint8_t nbit,
                                              folly::fbstring& literal) {
+  folly::StringPiece borrowed;
+  DecodeError result = decodeLiteral(nbit, literal, borrowed);
+  if (result == DecodeError::NONE && borrowed.data() != literal.data()) {
+    // the literal was left in the ingress buffer, but this caller needs an
+    // owned copy
+    literal.assign(borrowed.data(), borrowed.size());
+  }
+  return result;
+}
+
+DecodeError HPACKDecodeBuffer::decodeLiteral(uint8_t nbit,
+                                             folly::fbstring& storage,
+                                             folly::StringPiece& literal) {
+  storage.clear();
   literal.clear();
   if (remainingBytes_ == 0) {
     EOB_LOG("remainingBytes_ == 0");
@@ -85,6 +101,12 @@ DecodeError HPACKDecodeBuffer::decodeLiteral(uint8_t nbit,
   if (cursor_.length() >= size) {
     data = cursor_.data();
     cursor_.skip(size);
+    if (!huffman) {
+      // borrow directly from the ingress buffer, no copy needed
+      literal.reset(reinterpret_cast<const char*>(data), size);
+      remainingBytes_ -= size;
+      return DecodeError::NONE;
+    }
   } else {
     // temporary buffer to pull the chunks together
     tmpbuf = IOBuf::create(size);
@@ -94,10 +116,11 @@ DecodeError HPACKDecodeBuffer::decodeLiteral(uint8_t nbit,
   }
   if (huffman) {
     static auto& huffmanTree = huffman::huffTree();
-    huffmanTree.decode(data, size, literal);
+    huffmanTree.decode(data, size, storage);
   } else {
-    literal.append((const char *)data, size);
+    storage.append((const char *)data, size);
   }
+  literal = storage;
   remainingBytes_ -= size;
   return DecodeError::NONE;
 }
@@ -120,6 +143,46 @@ DecodeError HPACKDecodeBuffer::decodeInteger(uint8_t nbit, uint64_t& integer) {
     // the value fit in one byte
     return DecodeError::NONE;
   }
+
+  // Fast path: when the continuation bytes sit contiguously in the
+  // current IOBuf, decode them straight off the buffer with a single
+  // bounds decision up front - integer decode brackets every header
+  // field, so the per-byte next()/peek() accounting adds up.  Values
+  // that would need more than 8 continuation bytes exceed 2^56 and are
+  // vanishingly rare in header blocks; they (and buffer-boundary
+  // crossings) take the byte-loop below.
+  {
+    const size_t contiguous =
+        std::min<size_t>(std::min<uint64_t>(cursor_.length(), remainingBytes_),
+                         8);
+    const uint8_t* data = cursor_.data();
+    size_t used = 0;
+    uint64_t value = 0;
+    uint32_t shift = 0;
+    bool more = true;
+    while (used < contiguous && more) {
+      const uint8_t continuation = data[used];
+      value |= uint64_t(continuation & 127) << shift;
+      shift += 7;
+      used++;
+      more = (continuation & 128) != 0;
+    }
+    if (!more) {
+      // 8 groups of 7 bits never overflow the 2^64-1 cap by themselves,
+      // but the prefix addition can
+      if (std::numeric_limits<uint64_t>::max() - integer <= value) {
+        LOG(ERROR) << "overflow integer=" << integer << " add=" << value;
+        return DecodeError::INTEGER_OVERFLOW;
+      }
+      integer += value;
+      cursor_.skip(used);
+      remainingBytes_ -= used;
+      return DecodeError::NONE;
+    }
+    // fall through without consuming; the loop below re-reads from the
+    // cursor and handles underflow, overflow and IOBuf boundaries
+  }
+
   uint64_t f = 1;
   uint32_t fexp = 0;
   do {
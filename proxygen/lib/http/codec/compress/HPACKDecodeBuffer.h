@@ -85,6 +85,17 @@ class HPACKDecodeBuffer {
 
   HPACK::DecodeError decodeLiteral(uint8_t nbit, folly::fbstring& literal);
 
+  /**
+   * decode a literal in borrow mode: when the encoded literal is not
+   * huffman-coded and lies contiguous in the underlying IOBuf, no bytes are
+   * copied and literal is set to reference the ingress buffer directly, so
+   * it is valid only as long as that buffer. Otherwise the literal is
+   * materialized into storage and literal points at it.
+   */
+  HPACK::DecodeError decodeLiteral(uint8_t nbit,
+                                   folly::fbstring& storage,
+                                   folly::StringPiece& literal);
+
 private:
   void EOB_LOG(std::string msg,
                HPACK::DecodeError code=
@@ -8,6 +8,7 @@
 
 #include <proxygen/lib/http/codec/compress/HPACKDecoder.h>
 
+#include <folly/io/IOBufQueue.h>
 #include <proxygen/lib/http/codec/compress/HeaderCodec.h>
 
 using folly::io::Cursor;
@@ -37,6 +38,63 @@ void HPACKDecoder::decodeStreaming(
                  compressedSize, emittedSize);
 }
 
+void HPACKDecoder::decodeStreamingPartial(
+    Cursor& cursor,
+    uint32_t length,
+    bool last,
+    HPACK::StreamingCallback* streamingCb) {
+  std::unique_ptr<folly::IOBuf> chain;
+  if (length > 0) {
+    cursor.clone(chain, length);
+  }
+  partialCompressedSize_ += length;
+  if (pendingFragment_) {
+    if (chain) {
+      pendingFragment_->prependChain(std::move(chain));
+    }
+    chain = std::move(pendingFragment_);
+  }
+  if (!chain) {
+    chain = folly::IOBuf::create(0);
+  }
+  auto totalBytes = folly::to<uint32_t>(chain->computeChainDataLength());
+  Cursor fragmentCursor(chain.get());
+  HPACKDecodeBuffer dbuf(fragmentCursor, totalBytes, maxUncompressed_,
+                         last /* endOfBufferIsError */);
+
+  while (!hasError() && !dbuf.empty()) {
+    auto instructionStart = dbuf.consumedBytes();
+    partialEmittedSize_ += decodeHeader(dbuf, streamingCb, nullptr);
+    if (!last && err_ == HPACK::DecodeError::BUFFER_UNDERFLOW) {
+      // A trailing partial instruction: stash it and resume with the next
+      // fragment. decodeHeader makes no decoder state changes before
+      // running out of bytes, so re-decoding it from the start is safe.
+      err_ = HPACK::DecodeError::NONE;
+      folly::IOBufQueue pending{folly::IOBufQueue::cacheChainLength()};
+      pending.append(std::move(chain));
+      pending.trimStart(instructionStart);
+      pendingFragment_ = pending.move();
+      return;
+    }
+    if (partialEmittedSize_ > maxUncompressed_) {
+      LOG(ERROR) << "exceeded uncompressed size limit of "
+                 << maxUncompressed_ << " bytes";
+      err_ = HPACK::DecodeError::HEADERS_TOO_LARGE;
+      break;
+    }
+    partialEmittedSize_ += 2;
+  }
+
+  if (last || hasError()) {
+    completeDecode(HeaderCodec::Type::HPACK, streamingCb,
+                   partialCompressedSize_, partialCompressedSize_,
+                   partialEmittedSize_);
+    pendingFragment_.reset();
+    partialEmittedSize_ = 0;
+    partialCompressedSize_ = 0;
+  }
+}
+
 uint32_t HPACKDecoder::decodeLiteralHeader(
     HPACKDecodeBuffer& dbuf,
     HPACK::StreamingCallback* streamingCb,
@@ -78,20 +136,28 @@ uint32_t HPACKDecoder::decodeLiteralHeader(
     }
   }
   // value
-  err_ = dbuf.decodeLiteral(header.value);
+  if (indexing) {
+    // the table keeps the entry alive, so the value needs owned storage
+    err_ = dbuf.decodeLiteral(header.value);
+    if (err_ != HPACK::DecodeError::NONE) {
+      LOG(ERROR) << "Error decoding header value name=" << header.name
+                 << " err_=" << err_;
+      return 0;
+    }
+    uint32_t emittedSize = emit(header, streamingCb, emitted);
+    table_.add(std::move(header));
+    return emittedSize;
+  }
+  // non-indexed values are only needed for the duration of the emit
+  // callbacks, so they can be borrowed straight from the ingress buffer
+  folly::StringPiece value;
+  err_ = dbuf.decodeLiteral(7, header.value, value);
   if (err_ != HPACK::DecodeError::NONE) {
     LOG(ERROR) << "Error decoding header value name=" << header.name
                << " err_=" << err_;
     return 0;
   }
-
-  uint32_t emittedSize = emit(header, streamingCb, emitted);
-
-  if (indexing) {
-    table_.add(std::move(header));
-  }
-
-  return emittedSize;
+  return emit(header.name, value, streamingCb, emitted);
 }
 
 uint32_t HPACKDecoder::decodeIndexedHeader(
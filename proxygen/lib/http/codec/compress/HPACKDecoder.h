@@ -35,6 +35,18 @@ class HPACKDecoder : public HPACKDecoderBase,
                        uint32_t totalBytes,
                        HPACK::StreamingCallback* streamingCb);
 
+  /**
+   * Decode one fragment of a header block without waiting for the whole
+   * block to be assembled. Headers are emitted through the callback as
+   * soon as their instructions are complete; a trailing partial
+   * instruction is buffered internally and resumed on the next call.
+   * Pass last=true with the final fragment (END_HEADERS): that call
+   * completes the block and fires onHeadersComplete/onDecodeError.
+   */
+  void decodeStreamingPartial(folly::io::Cursor& cursor,
+                              uint32_t length,
+                              bool last,
+                              HPACK::StreamingCallback* streamingCb);
 
   void setHeaderTableMaxSize(uint32_t maxSize) {
     HPACKDecoderBase::setHeaderTableMaxSize(table_, maxSize);
@@ -54,6 +66,11 @@ class HPACKDecoder : public HPACKDecoderBase,
   uint32_t decodeHeader(HPACKDecodeBuffer& dbuf,
                         HPACK::StreamingCallback* streamingCb,
                         headers_t* emitted);
+
+  // fragment-at-a-time decode state
+  std::unique_ptr<folly::IOBuf> pendingFragment_;
+  uint32_t partialEmittedSize_{0};
+  uint32_t partialCompressedSize_{0};
 };
 
 }
@@ -23,6 +23,19 @@ uint32_t HPACKDecoderBase::emit(const HPACKHeader& header,
   return header.realBytes();
 }
 
+uint32_t HPACKDecoderBase::emit(const HPACKHeaderName& name,
+                                folly::StringPiece value,
+                                HPACK::StreamingCallback* streamingCb,
+                                headers_t* emitted) {
+  if (streamingCb) {
+    streamingCb->onHeader(name, value);
+  } else if (emitted) {
+    // copying the header into owned storage
+    emitted->emplace_back(name, value);
+  }
+  return HPACKHeader::realBytes(name.size(), value.size());
+}
+
 void HPACKDecoderBase::completeDecode(
     HeaderCodec::Type type,
     HPACK::StreamingCallback* streamingCb,
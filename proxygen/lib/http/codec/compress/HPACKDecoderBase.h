@@ -49,6 +49,12 @@ class HPACKDecoderBase {
                 HPACK::StreamingCallback* streamingCb,
                 headers_t* emitted);
 
+  // emit a header whose value is borrowed from the ingress buffer
+  uint32_t emit(const HPACKHeaderName& name,
+                folly::StringPiece value,
+                HPACK::StreamingCallback* streamingCb,
+                headers_t* emitted);
+
   void completeDecode(
       HeaderCodec::Type type,
       HPACK::StreamingCallback* streamingCb,
@@ -38,6 +38,14 @@ class HPACKEncodeBuffer {
     bufQueuePtr_->clear();
   }
 
+  /**
+   * Bytes encoded so far and not yet released.
+   */
+  uint64_t getLength() const {
+    auto head = bufQueuePtr_->front();
+    return head ? head->computeChainDataLength() : 0;
+  }
+
   /**
    * Add headroom at the beginning of the IOBufQueue
    * Meant to be called before encoding anything.
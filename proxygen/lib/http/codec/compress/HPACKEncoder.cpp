@@ -8,6 +8,8 @@
 
 #include <proxygen/lib/http/codec/compress/HPACKEncoder.h>
 
+#include <folly/hash/Hash.h>
+
 using std::vector;
 
 namespace proxygen {
@@ -18,8 +20,12 @@ HPACKEncoder::encode(const vector<HPACKHeader>& headers, uint32_t headroom) {
     streamBuffer_.addHeadroom(headroom);
   }
   handlePendingContextUpdate(streamBuffer_, table_.capacity());
-  for (const auto& header : headers) {
-    encodeHeader(header.name, header.value); // const, string piece
+  if (planCacheEnabled_) {
+    encodeWithPlan(headers);
+  } else {
+    for (const auto& header : headers) {
+      encodeHeader(header.name, header.value); // const, string piece
+    }
   }
   return streamBuffer_.release();
 }
@@ -29,12 +35,118 @@ HPACKEncoder::encode(const vector<HPACKHeader>& headers,
                      folly::IOBufQueue& writeBuf) {
   streamBuffer_.setWriteBuf(&writeBuf);
   handlePendingContextUpdate(streamBuffer_, table_.capacity());
-  for (const auto& header : headers) {
-    encodeHeader(header.name, header.value); // const, string piece
+  if (planCacheEnabled_) {
+    encodeWithPlan(headers);
+  } else {
+    for (const auto& header : headers) {
+      encodeHeader(header.name, header.value); // const, string piece
+    }
   }
   streamBuffer_.setWriteBuf(nullptr);
 }
 
+uint64_t HPACKEncoder::fingerprintHeaders(const vector<HPACKHeader>& headers) {
+  // shape only: the name sequence.  Values are verified (or free to
+  // differ) at replay time.
+  uint64_t fingerprint = headers.size();
+  for (const auto& header : headers) {
+    fingerprint = folly::hash::hash_128_to_64(
+        fingerprint, folly::hash::fnv64(header.name.get()));
+  }
+  return fingerprint;
+}
+
+void HPACKEncoder::encodeWithPlan(const vector<HPACKHeader>& headers) {
+  const auto fingerprint = fingerprintHeaders(headers);
+  if (plan_.valid && plan_.fingerprint == fingerprint &&
+      plan_.entries.size() == headers.size()) {
+    for (size_t i = 0; i < headers.size(); i++) {
+      if (!replayStep(plan_.entries[i], headers[i])) {
+        // verification miss: finish the block on the full path and
+        // rebuild the plan on the next block
+        plan_.valid = false;
+        for (; i < headers.size(); i++) {
+          encodeHeader(headers[i].name, headers[i].value);
+        }
+        return;
+      }
+    }
+    return;
+  }
+  plan_.fingerprint = fingerprint;
+  plan_.entries.clear();
+  plan_.entries.reserve(headers.size());
+  for (const auto& header : headers) {
+    plan_.entries.push_back(encodeHeaderRecording(header));
+  }
+  plan_.valid = true;
+}
+
+bool HPACKEncoder::replayStep(const EncodePlan::Entry& entry,
+                              const HPACKHeader& header) {
+  switch (entry.step) {
+    case EncodePlan::Step::Full:
+      encodeHeader(header.name, header.value);
+      return true;
+    case EncodePlan::Step::StaticIndex: {
+      const auto& staticHeader =
+          getStaticTable().getHeader(globalToStaticIndex(entry.index));
+      if (staticHeader.name == header.name &&
+          staticHeader.value == header.value) {
+        encodeAsIndex(entry.index);
+        return true;
+      }
+      return false;
+    }
+    case EncodePlan::Step::StaticNameLiteral: {
+      if (entry.index != 0) {
+        const auto& staticHeader =
+            getStaticTable().getHeader(globalToStaticIndex(entry.index));
+        if (!(staticHeader.name == header.name)) {
+          return false;
+        }
+      }
+      // the value substitutes freely; a non-indexed literal cannot
+      // invalidate table state
+      encodeLiteral(header.name, header.value, entry.index, HPACK::LITERAL);
+      return true;
+    }
+  }
+  return false;
+}
+
+HPACKEncoder::EncodePlan::Entry HPACKEncoder::encodeHeaderRecording(
+    const HPACKHeader& header) {
+  const auto& name = header.name;
+  folly::StringPiece value(header.value);
+  bool indexable = !indexingStrat_ || indexingStrat_->indexHeader(name, value);
+  uint32_t index = indexable ? getIndex(name, value) : 0;
+  if (index) {
+    encodeAsIndex(index);
+    if (isStatic(index)) {
+      return {EncodePlan::Step::StaticIndex, index};
+    }
+    return {EncodePlan::Step::Full, 0};
+  }
+  bool indexing = indexable;
+  if (HPACKHeader::bytes(name.size(), value.size()) > table_.capacity()) {
+    indexing = false;
+  }
+  auto nameIdx = nameIndex(name);
+  encodeLiteral(name,
+                value,
+                nameIdx,
+                indexing ? HPACK::LITERAL_INC_INDEX : HPACK::LITERAL);
+  if (indexing) {
+    CHECK(table_.add(HPACKHeader(name, value)));
+    return {EncodePlan::Step::Full, 0};
+  }
+  if (nameIdx == 0 || isStatic(nameIdx)) {
+    return {EncodePlan::Step::StaticNameLiteral, nameIdx};
+  }
+  return {EncodePlan::Step::Full, 0};
+}
+
 void
 HPACKEncoder::startEncode(folly::IOBufQueue& writeBuf) {
   streamBuffer_.setWriteBuf(&writeBuf);
@@ -141,9 +253,43 @@ void HPACKEncoder::encodeAsIndex(uint32_t index) {
   streamBuffer_.encodeInteger(index, HPACK::INDEX_REF);
 }
 
+uint32_t HPACKEncoder::staticOnlyIndex(const HPACKHeaderName& name,
+                                       folly::StringPiece value) {
+  // same applicability screen as HPACKContext::getIndex, minus the
+  // dynamic-table fallback
+  bool consultStaticTable = value.empty()
+      ? name.isCommonHeader()
+      : StaticHeaderTable::isHeaderCodeInTableWithNonEmptyValue(
+            name.getHeaderCode());
+  if (!consultStaticTable) {
+    return 0;
+  }
+  auto index = getStaticTable().getIndex(name, value);
+  if (index) {
+    staticRefs_++;
+    return staticToGlobalIndex(index);
+  }
+  return 0;
+}
+
 bool HPACKEncoder::encodeHeaderImpl(const HPACKHeaderName& name,
                                     folly::StringPiece value,
                                     bool& indexable) {
+  if (table_.capacity() == 0) {
+    // Static-only profile (header table size 0, negotiated for
+    // short-lived connections): static hits encode as indexes,
+    // everything else as plain literals.  No dynamic lookups, no
+    // insertions - the lazily-built HeaderTable is never touched, so
+    // the connection skips its allocation entirely.
+    uint32_t staticIndex = staticOnlyIndex(name, value);
+    if (staticIndex) {
+      encodeAsIndex(staticIndex);
+      return true;
+    }
+    indexable = false;
+    return false;
+  }
+
   // First determine whether the header is defined as indexable using the
   // set strategy if applicable, else assume it is indexable
   indexable = !indexingStrat_ || indexingStrat_->indexHeader(name, value);
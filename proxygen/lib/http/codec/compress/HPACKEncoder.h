@@ -49,7 +49,45 @@ class HPACKEncoder : public HPACKEncoderBase, public HPACKContext {
     HPACKEncoderBase::setHeaderTableSize(table_, size);
   }
 
+  /**
+   * Single-slot encode-plan cache: remember the per-position decisions
+   * for the most recent block shape, keyed by a fingerprint of the
+   * header-name sequence, and replay them when the next block repeats
+   * that shape with only value changes (Date, Content-Length).  Static
+   * table decisions replay after a cheap re-verification; positions
+   * whose encoding depended on the dynamic table always run the full
+   * path; any verification miss falls back to a full encode and the
+   * plan rebuilds on the next block.  Replay can only trade a little
+   * compression (a literal where a fresh lookup might have indexed),
+   * never emit invalid HPACK.
+   */
+  void setEncodePlanCacheEnabled(bool enabled) {
+    planCacheEnabled_ = enabled;
+    plan_.valid = false;
+    plan_.entries.clear();
+  }
+
  private:
+  struct EncodePlan {
+    enum class Step : uint8_t {
+      Full,              // dynamic-table dependent; run the full path
+      StaticIndex,       // stable full match in the static table
+      StaticNameLiteral, // non-indexed literal, name index 0 or static
+    };
+    struct Entry {
+      Step step;
+      uint32_t index;
+    };
+    uint64_t fingerprint{0};
+    std::vector<Entry> entries;
+    bool valid{false};
+  };
+
+  static uint64_t fingerprintHeaders(const std::vector<HPACKHeader>& headers);
+  void encodeWithPlan(const std::vector<HPACKHeader>& headers);
+  EncodePlan::Entry encodeHeaderRecording(const HPACKHeader& header);
+  bool replayStep(const EncodePlan::Entry& entry, const HPACKHeader& header);
+
   void encodeAsIndex(uint32_t index);
 
   // movable name and value
@@ -61,6 +99,9 @@ class HPACKEncoder : public HPACKEncoderBase, public HPACKContext {
   // neither movable
   void encodeHeader(const HPACKHeaderName& name, folly::StringPiece value);
 
+  uint32_t staticOnlyIndex(const HPACKHeaderName& name,
+                           folly::StringPiece value);
+
   bool encodeHeaderImpl(const HPACKHeaderName& name,
                         folly::StringPiece value,
                         bool& indexable);
@@ -82,6 +123,9 @@ class HPACKEncoder : public HPACKEncoderBase, public HPACKContext {
                      folly::StringPiece value,
                      uint32_t nameIndex,
                      const HPACK::Instruction& instruction);
+
+  EncodePlan plan_;
+  bool planCacheEnabled_{false};
 };
 
 }
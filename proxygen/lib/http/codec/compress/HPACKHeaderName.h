@@ -15,6 +15,7 @@
 #include <iostream>
 #include <boost/variant.hpp>
 #include <proxygen/lib/http/HTTPCommonHeaders.h>
+#include <proxygen/lib/http/HeaderInternTable.h>
 #include <folly/Range.h>
 #include <glog/logging.h>
 
@@ -81,7 +82,7 @@ class HPACKHeaderName {
     return !(*this == headerName);
   }
   bool operator>(const HPACKHeaderName& headerName) const {
-    if (!isAllocated() && !headerName.isAllocated()) {
+    if (isCommonHeader() && headerName.isCommonHeader()) {
       // Common header tables are aligned alphabetically (unit tested as well
       // to ensure it isn't accidentally changed)
       return address_ > headerName.address_;
@@ -90,7 +91,7 @@ class HPACKHeaderName {
     }
   }
   bool operator<(const HPACKHeaderName& headerName) const {
-    if (!isAllocated() && !headerName.isAllocated()) {
+    if (isCommonHeader() && headerName.isCommonHeader()) {
       // Common header tables are aligned alphabetically (unit tested as well
       // to ensure it isn't accidentally changed)
       return address_ < headerName.address_;
@@ -149,6 +150,15 @@ class HPACKHeaderName {
       name.data(), name.size());
     if (headerCode == HTTPHeaderCode::HTTP_HEADER_NONE ||
         headerCode == HTTPHeaderCode::HTTP_HEADER_OTHER) {
+      if (name.size() <= HeaderInternTable::kMaxNameLength) {
+        // frequent custom names resolve to immortal interned entries
+        // shared with HTTPHeaders; no allocation, pointer equality
+        char lower[HeaderInternTable::kMaxNameLength];
+        std::transform(name.begin(), name.end(), lower, ::tolower);
+        address_ = HeaderInternTable::internOrAllocate(
+            folly::StringPiece(lower, name.size()));
+        return;
+      }
       std::string* newAddress = new std::string(name.size(), 0);
       std::transform(name.begin(), name.end(), newAddress->begin(), ::tolower);
       address_ = newAddress;
@@ -196,7 +206,8 @@ class HPACKHeaderName {
       return false;
     } else {
       return !HTTPCommonHeaders::isNameFromTable(
-        address_, HTTPCommonHeaderTableType::TABLE_LOWERCASE);
+                 address_, HTTPCommonHeaderTableType::TABLE_LOWERCASE) &&
+          !HeaderInternTable::get().isInterned(address_);
     }
   }
 
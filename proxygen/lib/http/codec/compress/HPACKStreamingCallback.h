@@ -17,8 +17,13 @@ namespace proxygen { namespace HPACK {
    public:
     virtual ~StreamingCallback() {}
 
+    /**
+     * The value points either into the ingress buffer being decoded or
+     * into decoder-owned storage; it is valid only for the duration of
+     * the callback and must be copied out if it needs to outlive it.
+     */
     virtual void onHeader(const HPACKHeaderName& name,
-                          const folly::fbstring& value) = 0;
+                          folly::StringPiece value) = 0;
     virtual void onHeadersComplete(HTTPHeaderSize decodedSize,
                                    bool acknowledge) = 0;
     virtual void onDecodeError(HPACK::DecodeError decodeError) = 0;
@@ -13,16 +13,60 @@
 
 namespace proxygen {
 
+namespace {
+
+// Per-worker accounting of table slot storage; entry strings are owned
+// per entry and already proportional to real use.  Signed: a session
+// that migrates threads (attach/detachThreadLocals) retires its tables
+// on a different worker than the one that grew them, which may drive a
+// worker's count transiently negative - harmless for budgeting.
+thread_local int64_t tableStorageBytes = 0;
+
+constexpr uint64_t kBytesPerSlot =
+    sizeof(HPACKHeader) + sizeof(uint64_t) /* valueHashes_ */;
+
+// capacity to fall back to once a worker exceeds its budget; still
+// enough for a handful of hot entries per session
+constexpr uint32_t kBudgetedMinCapacity = 1024;
+
+} // anonymous namespace
+
+// out-of-line definition: std::min odr-uses it and this is C++14
+constexpr uint32_t HeaderTable::kInitialTableLength;
+
+HeaderTable::~HeaderTable() {
+  tableStorageBytes -= table_.size() * kBytesPerSlot;
+}
+
+uint64_t HeaderTable::getThreadTableStorageBytes() {
+  return tableStorageBytes > 0 ? uint64_t(tableStorageBytes) : 0;
+}
+
+uint32_t HeaderTable::budgetedCapacity(uint32_t desired,
+                                       uint64_t threadBudgetBytes) {
+  if (getThreadTableStorageBytes() <= threadBudgetBytes) {
+    return desired;
+  }
+  return std::min(desired, kBudgetedMinCapacity);
+}
+
 void HeaderTable::init(uint32_t capacityVal) {
   bytes_ = 0;
   size_ = 0;
   head_ = 0;
   capacity_ = capacityVal;
-  uint32_t initLength = getMaxTableLength(capacity_) / 2;
+  // Start tiny: most sessions never index enough to need more, and at
+  // high connection counts the up-front getMaxTableLength/2 vectors
+  // are almost entirely cold memory.  add() grows the storage
+  // geometrically as entries actually arrive.
+  uint32_t initLength =
+      std::min(kInitialTableLength, getMaxTableLength(capacity_));
+  tableStorageBytes += initLength * kBytesPerSlot;
   table_.reserve(initLength);
   for (uint32_t i = 0; i < initLength; i++) {
     table_.emplace_back();
   }
+  valueHashes_.assign(initLength, 0);
   names_.clear();
 }
 
@@ -43,13 +87,17 @@ bool HeaderTable::add(HPACKHeader header) {
   }
 
   if (size_ == length()) {
-    increaseTableLengthTo(std::min((uint32_t)ceil(size_ * 1.5),
-                                   getMaxTableLength(capacity_)));
+    // geometric growth from the tiny initial size; always at least one
+    // slot beyond the current occupancy
+    increaseTableLengthTo(
+        std::min(std::max((uint32_t)ceil(size_ * 1.5), size_ + 1),
+                 getMaxTableLength(capacity_)));
   }
   head_ = next(head_);
   // index name
   names_[header.name].push_back(head_);
   bytes_ += header.bytes();
+  valueHashes_[head_] = valueHash(header.value);
   table_[head_] = std::move(header);
 
   ++size_;
@@ -73,10 +121,13 @@ uint32_t HeaderTable::getIndexImpl(const HPACKHeaderName& headerName,
   if (it == names_.end()) {
     return 0;
   }
+  // comparing precomputed hashes rejects non-matching values without
+  // touching the strings
+  const uint64_t hash = nameOnly ? 0 : valueHash(value);
   for (auto indexIt = it->second.rbegin(); indexIt != it->second.rend();
        ++indexIt) {
     auto i = *indexIt;
-    if (nameOnly || table_[i].value == value) {
+    if (nameOnly || (valueHashes_[i] == hash && table_[i].value == value)) {
       return toExternal(i);
     }
   }
@@ -146,13 +197,9 @@ bool HeaderTable::setCapacity(uint32_t newCapacity) {
       return false;
     }
   } else {
-    // NOTE: due to the above lack of resizing, we must determine whether a
-    // resize is actually appropriate (to handle cases where the underlying
-    // vector is still >= to the size related to the new capacity requested)
-    uint32_t newLength = getMaxTableLength(newCapacity) / 2;
-    if (newLength > length()) {
-      increaseTableLengthTo(newLength);
-    }
+    // Growing the capacity no longer pre-grows the storage: add()
+    // expands geometrically on demand, so a capacity bump on a session
+    // that never indexes stays at the tiny initial footprint.
   }
   capacity_ = newCapacity;
   return true;
@@ -186,13 +233,18 @@ void HeaderTable::increaseTableLengthTo(uint32_t newLength) {
 }
 
 void HeaderTable::resizeTable(uint32_t newLength) {
+  tableStorageBytes += (newLength - table_.size()) * kBytesPerSlot;
   table_.resize(newLength);
+  valueHashes_.resize(newLength);
 }
 
 void HeaderTable::updateResizedTable(uint32_t oldTail, uint32_t oldLength,
                                      uint32_t newLength) {
   std::move_backward(table_.begin() + oldTail, table_.begin() + oldLength,
                      table_.begin() + newLength);
+  std::move_backward(valueHashes_.begin() + oldTail,
+                     valueHashes_.begin() + oldLength,
+                     valueHashes_.begin() + newLength);
 }
 
 uint32_t HeaderTable::evict(uint32_t needed, uint32_t desiredCapacity) {
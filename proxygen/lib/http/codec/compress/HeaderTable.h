@@ -13,6 +13,7 @@
 #include <vector>
 
 #include <folly/container/F14Map.h>
+#include <folly/hash/Hash.h>
 #include <proxygen/lib/http/codec/compress/HPACKHeader.h>
 
 namespace proxygen {
@@ -31,7 +32,7 @@ class HeaderTable {
     init(capacityVal);
   }
 
-  virtual ~HeaderTable() {}
+  virtual ~HeaderTable();
   HeaderTable(const HeaderTable&) = delete;
   HeaderTable& operator=(const HeaderTable&) = delete;
 
@@ -109,6 +110,24 @@ class HeaderTable {
   */
   uint32_t getMaxTableLength(uint32_t capacityVal) const;
 
+  /**
+   * Aggregate slot-storage bytes of every HeaderTable on this thread
+   * (the vectors backing the entries, not the entry strings).  With
+   * lazy growth this tracks what sessions actually use, making it the
+   * signal for a per-worker table-memory budget.
+   */
+  static uint64_t getThreadTableStorageBytes();
+
+  /**
+   * The HEADER_TABLE_SIZE a worker should advertise: the desired
+   * capacity while this thread's aggregate table storage is within
+   * budget, clamped down once the budget is exceeded so new sessions
+   * stop growing the footprint.  Call when building egress SETTINGS
+   * (e.g. AcceptorConfiguration::egressSettings).
+   */
+  static uint32_t budgetedCapacity(uint32_t desired,
+                                   uint64_t threadBudgetBytes);
+
   /**
    * Sets the current capacity of the header table, and evicts entries
    * if needed.  Returns false if eviction failed.
@@ -153,6 +172,9 @@ class HeaderTable {
    */
   void init(uint32_t capacityVal);
 
+  // initial backing-store slots; see init()
+  static constexpr uint32_t kInitialTableLength = 8;
+
   /*
    * Increase table length to newLength
    */
@@ -200,9 +222,18 @@ class HeaderTable {
    */
   uint32_t toInternal(uint32_t externalIndex) const;
 
+  /**
+   * Hash of each slot's value, precomputed on insert so encode-side table
+   * lookups can reject candidates without a full string compare.
+   */
+  static uint64_t valueHash(folly::StringPiece value) {
+    return folly::hash::fnv64_buf(value.data(), value.size());
+  }
+
   uint32_t capacity_{0};
   uint32_t bytes_{0};     // size in bytes of the current entries
   std::vector<HPACKHeader> table_;
+  std::vector<uint64_t> valueHashes_;
 
   uint32_t size_{0};    // how many entries we have in the table
   uint32_t head_{0};     // points to the first element of the ring
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <folly/FBString.h>
+#include <memory>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <proxygen/lib/http/codec/compress/HPACKConstants.h>
@@ -93,6 +94,10 @@ class HuffTree {
   /**
    * decode bitstream into a string literal
    *
+   * Long literals are processed through a bulk path that refills a 64-bit
+   * reservoir four bytes at a time, falling back to bit-level processing
+   * only for the trailing bytes and padding.
+   *
    * @param buf start of a huffman-encoded bit stream
    * @param size size of the buffer
    * @param literal where to append decoded characters
@@ -145,6 +150,9 @@ class HuffTree {
   uint32_t nodes_{0};
   const uint32_t* codes_;
   const uint8_t* bits_;
+  // total code bits for every adjacent byte pair, so size estimation
+  // handles two characters per lookup
+  std::unique_ptr<uint8_t[]> pairBits_;
 
  protected:
   explicit HuffTree(const HuffTree& tree);
@@ -55,6 +55,32 @@ QPACKEncoder::EncodeResult QPACKCodec::encode(
   return res;
 }
 
+void QPACKCodec::startEncode(vector<Header>& headers,
+                             uint64_t streamId,
+                             uint32_t maxEncoderStreamBytes) noexcept {
+  std::vector<HPACKHeader> prepared;
+  encodedSize_.uncompressed = compress::prepareHeaders(headers, prepared);
+  encodedSize_.compressed = 0;
+  encodedSize_.compressedBlock = 0;
+  encoder_.startEncode(std::move(prepared), streamId, maxEncoderStreamBytes);
+}
+
+QPACKEncoder::EncodeResult QPACKCodec::encodeNext(uint32_t maxStreamBytes,
+                                                  bool* done) noexcept {
+  auto res = encoder_.encodeNext(maxStreamBytes, done);
+  if (res.control) {
+    encodedSize_.compressed += res.control->computeChainDataLength();
+  }
+  if (res.stream) {
+    encodedSize_.compressedBlock = res.stream->computeChainDataLength();
+    encodedSize_.compressed += encodedSize_.compressedBlock;
+  }
+  if (*done && stats_) {
+    stats_->recordEncode(Type::QPACK, encodedSize_);
+  }
+  return res;
+}
+
 void QPACKCodec::decodeStreaming(
     uint64_t streamID,
     std::unique_ptr<folly::IOBuf> block,
@@ -45,6 +45,41 @@ class QPACKCodec : public HeaderCodec {
       uint32_t maxEncoderStreamBytes =
           std::numeric_limits<uint32_t>::max()) noexcept;
 
+  /**
+   * Dynamic-table migration (see HPACKCodec::getEncoderTableState for
+   * the contract): export entries oldest-first and seed the
+   * replacement connection's codec before any traffic, identically on
+   * both ends.  QPACK adds a stricter requirement - seeding advances
+   * the insert count, which is wire-visible in required-insert-count
+   * prefixes and encoder stream instructions, so both peers MUST seed
+   * the same entries in the same order or every block misdecodes.
+   */
+  std::vector<HPACKHeader> getEncoderTableState() const {
+    return tableState(encoder_.getTable());
+  }
+
+  std::vector<HPACKHeader> getDecoderTableState() const {
+    return tableState(decoder_.getTable());
+  }
+
+  void seedEncoderTable(std::vector<HPACKHeader> entries) {
+    encoder_.seedHeaderTable(entries);
+  }
+
+  void seedDecoderTable(std::vector<HPACKHeader> entries) {
+    decoder_.seedHeaderTable(entries);
+  }
+
+  // Incremental encode: bounds the bytes produced per encodeNext() call
+  // so very large header lists can be compressed without building the
+  // whole block in one shot.  See QPACKEncoder::startEncode.
+  void startEncode(std::vector<compress::Header>& headers,
+                   uint64_t id,
+                   uint32_t maxEncoderStreamBytes =
+                       std::numeric_limits<uint32_t>::max()) noexcept;
+  QPACKEncoder::EncodeResult encodeNext(uint32_t maxStreamBytes,
+                                        bool* done) noexcept;
+
   HPACK::DecodeError decodeEncoderStream(std::unique_ptr<folly::IOBuf> buf) {
     // stats?
     return decoder_.decodeEncoderStream(std::move(buf));
@@ -141,6 +176,19 @@ class QPACKCodec : public HeaderCodec {
     decoder_.setMaxBlocking(maxBlocking);
   }
 
+  void setQueuedStreamPriority(uint64_t streamId, uint8_t priority) {
+    decoder_.setQueuedStreamPriority(streamId, priority);
+  }
+
+  void setUnblockBudget(uint32_t blocksPerDrain,
+                        folly::Function<void()> resumeCb) {
+    decoder_.setUnblockBudget(blocksPerDrain, std::move(resumeCb));
+  }
+
+  void drainPendingBlocks() {
+    decoder_.drainPendingBlocks();
+  }
+
   void setMaxNumOutstandingBlocks(uint32_t value) {
     encoder_.setMaxNumOutstandingBlocks(value);
   }
@@ -150,6 +198,17 @@ class QPACKCodec : public HeaderCodec {
   QPACKDecoder decoder_;
 
  private:
+  static std::vector<HPACKHeader> tableState(const QPACKHeaderTable& table) {
+    // relative index 1 is the newest entry (base 0); emit oldest-first
+    // so seeding replays the original insertion order
+    std::vector<HPACKHeader> entries;
+    entries.reserve(table.size());
+    for (uint32_t i = table.size(); i >= 1; i--) {
+      entries.push_back(table.getHeader(i, 0).copy());
+    }
+    return entries;
+  }
+
   void recordCompressedSize(const QPACKEncoder::EncodeResult& encodeRes);
 
   std::vector<HPACKHeader> decodedHeaders_;
@@ -456,17 +456,47 @@ bool QPACKDecoder::decodeBlock(uint32_t requiredInsertCount,
   return false;
 }
 
+void QPACKDecoder::setQueuedStreamPriority(uint64_t streamId,
+                                           uint8_t priority) {
+  for (auto& entry : queue_) {
+    if (entry.second.streamID == streamId) {
+      entry.second.priority = priority;
+    }
+  }
+}
+
+std::multimap<uint32_t, QPACKDecoder::PendingBlock>::iterator
+QPACKDecoder::pickNextUnblockable() {
+  auto limit = queue_.upper_bound(table_.getInsertCount());
+  auto best = queue_.begin();
+  for (auto it = queue_.begin(); it != limit; ++it) {
+    if (it->second.priority < best->second.priority) {
+      best = it;
+    }
+  }
+  return best;
+}
+
 void QPACKDecoder::drainQueue() {
-  auto it = queue_.begin();
-  while (!queue_.empty() && it->first <= table_.getInsertCount() &&
-         !hasError()) {
+  uint32_t decoded = 0;
+  while (!queue_.empty() &&
+         queue_.begin()->first <= table_.getInsertCount() && !hasError()) {
+    if (unblockBudget_ != 0 && decoded >= unblockBudget_) {
+      // yield: let the owner reschedule so a table-insert burst doesn't
+      // decode hundreds of blocks inline
+      if (resumeDrain_) {
+        resumeDrain_();
+      }
+      return;
+    }
+    auto it = pickNextUnblockable();
     auto id = it->first;
     PendingBlock block = std::move(it->second);
     queue_.erase(it);
     if (decodeBlock(id, block)) {
       return;
     }
-    it = queue_.begin();
+    decoded++;
   }
 }
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <folly/Function.h>
 #include <folly/io/Cursor.h>
 #include <folly/io/IOBuf.h>
 #include <proxygen/lib/http/codec/compress/HeaderCodec.h>
@@ -29,6 +30,36 @@ class QPACKDecoder : public HPACKDecoderBase,
       : HPACKDecoderBase(tableSize, maxUncompressed),
         QPACKContext(tableSize, false /* don't track references */) {}
 
+  static constexpr uint8_t kDefaultUnblockPriority = 3;
+
+  /**
+   * Assign an unblock priority (0 = most urgent) to any header blocks
+   * of the given stream waiting on dynamic table inserts, so an
+   * encoder-stream flush wakes latency-sensitive streams first.
+   */
+  void setQueuedStreamPriority(uint64_t streamId, uint8_t priority);
+
+  /**
+   * Cap how many blocked header blocks one insert-driven drain decodes
+   * before yielding; 0 (the default) drains everything. On yield the
+   * resume callback fires so the owner can schedule
+   * drainPendingBlocks() on the next loop iteration instead of adding
+   * head-of-line latency to live requests.
+   */
+  void setUnblockBudget(uint32_t blocksPerDrain,
+                        folly::Function<void()> resumeCb) {
+    unblockBudget_ = blocksPerDrain;
+    resumeDrain_ = std::move(resumeCb);
+  }
+
+  /**
+   * Continue decoding any still-unblocked header blocks; see
+   * setUnblockBudget.
+   */
+  void drainPendingBlocks() {
+    drainQueue();
+  }
+
   void decodeStreaming(
       uint64_t streamId,
       std::unique_ptr<folly::IOBuf> block,
@@ -117,6 +148,7 @@ class QPACKDecoder : public HPACKDecoderBase,
     uint32_t consumed;
     std::unique_ptr<folly::IOBuf> block;
     HPACK::StreamingCallback* cb;
+    uint8_t priority{kDefaultUnblockPriority};
   };
 
   // Returns true if this object was destroyed by its callback.  Callers
@@ -125,6 +157,10 @@ class QPACKDecoder : public HPACKDecoderBase,
 
   void drainQueue();
 
+  // among the entries whose required insert count is satisfied, pick
+  // the one with the most urgent priority (ties broken by insert count)
+  std::multimap<uint32_t, PendingBlock>::iterator pickNextUnblockable();
+
   uint32_t maxBlocking_{HPACK::kDefaultBlocking};
   uint32_t baseIndex_{0};
   uint32_t lastAcked_{0};
@@ -132,6 +168,8 @@ class QPACKDecoder : public HPACKDecoderBase,
   uint32_t pendingEncoderBytes_{0};
   uint64_t queuedBytes_{0};
   std::multimap<uint32_t, PendingBlock> queue_;
+  uint32_t unblockBudget_{0};
+  folly::Function<void()> resumeDrain_;
 
   // This holds the state of a partially decoded literal insert on the control
   // stream
@@ -36,8 +36,103 @@ QPACKEncoder::EncodeResult QPACKEncoder::encode(
   return encodeQ(headers, streamId);
 }
 
+void QPACKEncoder::startEncode(std::vector<HPACKHeader> headers,
+                               uint64_t streamId,
+                               uint32_t maxEncoderStreamBytes) {
+  CHECK(!chunkedHeaders_) << "Incremental encode already in progress";
+  chunkedHeaders_ =
+      std::make_unique<std::vector<HPACKHeader>>(std::move(headers));
+  chunkedIndex_ = 0;
+  chunkedStreamId_ = streamId;
+  chunkedOutstanding_ = OutstandingBlock();
+  chunkedStreamBlock_.clear();
+  chunkedBaseIndex_ = table_.getInsertCount();
+  chunkedRequiredInsertCount_ = 0;
+  maxEncoderStreamBytes_ = maxEncoderStreamBytes;
+  maxEncoderStreamBytes_ -=
+      handlePendingContextUpdate(controlBuffer_, table_.capacity());
+  chunkedMaxEncoderStreamBytes_ = maxEncoderStreamBytes_;
+}
+
+QPACKEncoder::EncodeResult QPACKEncoder::encodeNext(uint32_t maxStreamBytes,
+                                                    bool* done) {
+  CHECK(chunkedHeaders_);
+  DCHECK(done);
+  // interleaved encode() calls overwrite these; restore the block state
+  curOutstanding_ = &chunkedOutstanding_;
+  maxEncoderStreamBytes_ = chunkedMaxEncoderStreamBytes_;
+  const auto& headers = *chunkedHeaders_;
+  while (chunkedIndex_ < headers.size() &&
+         streamBuffer_.getLength() < maxStreamBytes) {
+    encodeHeaderQ(
+        headers[chunkedIndex_++], chunkedBaseIndex_, &chunkedRequiredInsertCount_);
+  }
+  auto blockChunk = streamBuffer_.release();
+  if (blockChunk) {
+    chunkedStreamBlock_.append(std::move(blockChunk));
+  }
+  chunkedMaxEncoderStreamBytes_ = maxEncoderStreamBytes_;
+  auto controlBuf = controlBuffer_.release();
+  *done = chunkedIndex_ >= headers.size();
+  if (!*done) {
+    curOutstanding_ = nullptr;
+    return {std::move(controlBuf), nullptr};
+  }
+
+  // encode the prefix, then prepend it to the accumulated block
+  if (chunkedRequiredInsertCount_ == 0) {
+    streamBuffer_.encodeInteger(0); // required insert count
+    streamBuffer_.encodeInteger(0); // delta base
+  } else {
+    auto wireRIC =
+        (chunkedRequiredInsertCount_ % (2 * getMaxEntries(maxTableSize_))) + 1;
+    streamBuffer_.encodeInteger(wireRIC);
+    if (chunkedRequiredInsertCount_ > chunkedBaseIndex_) {
+      streamBuffer_.encodeInteger(
+          chunkedRequiredInsertCount_ - chunkedBaseIndex_ - 1,
+          HPACK::Q_DELTA_BASE_NEG,
+          HPACK::Q_DELTA_BASE.prefixLength);
+    } else {
+      streamBuffer_.encodeInteger(
+          chunkedBaseIndex_ - chunkedRequiredInsertCount_,
+          HPACK::Q_DELTA_BASE_POS,
+          HPACK::Q_DELTA_BASE.prefixLength);
+    }
+  }
+  auto streamBuffer = streamBuffer_.release();
+  auto streamBlock = chunkedStreamBlock_.move();
+  if (streamBlock) {
+    streamBuffer->prependChain(std::move(streamBlock));
+  }
+
+  if (!curOutstanding_->references.empty()) {
+    if (curOutstanding_->vulnerable) {
+      DCHECK(allowVulnerable());
+      numVulnerable_++;
+    }
+    numOutstandingBlocks_++;
+    outstanding_[chunkedStreamId_].emplace_back(
+        std::move(chunkedOutstanding_));
+  }
+  curOutstanding_ = nullptr;
+  chunkedHeaders_.reset();
+
+  return {std::move(controlBuf), std::move(streamBuffer)};
+}
+
 QPACKEncoder::EncodeResult QPACKEncoder::encodeQ(
     const vector<HPACKHeader>& headers, uint64_t streamId) {
+  // On insert planning: batching all of a block's table inserts ahead
+  // of its field lines (to contiguize encoder-stream output and let
+  // later duplicates reference earlier inserts) is unsafe as a simple
+  // two-pass: entries inserted in a pre-pass carry no block references
+  // yet, so a later pre-pass insert may evict them before their field
+  // line runs - canEvict only protects entries after trackReference.
+  // A planner must register the block's intended references during the
+  // pre-pass; until then, inserts stay interleaved in field order,
+  // which already gives every later occurrence in the block a table
+  // hit.  Wire-level batching is unaffected: the session coalesces the
+  // encoder stream per write loop.
   OutstandingBlock outstandingBlock;
   // curOutstanding_ points to a local stack variable, it's mostly for
   // convenience so other methods invoked from here can access it.
@@ -204,7 +299,12 @@ std::pair<bool, uint32_t> QPACKEncoder::maybeDuplicate(uint32_t relativeIndex) {
 std::tuple<bool, uint32_t, uint32_t> QPACKEncoder::getNameIndexQ(
     const HPACKHeaderName& headerName) {
   uint32_t absoluteNameIndex = 0;
-  uint32_t nameIndex = getStaticTable().nameIndex(headerName);
+  // non-common names can't be in the static table; common ones resolve
+  // with one array load
+  const auto headerCode = headerName.getHeaderCode();
+  uint32_t nameIndex = (headerCode == HTTP_HEADER_OTHER)
+      ? 0
+      : getStaticTable().nameIndexByCode(headerCode);
   bool isStatic = true;
   if (nameIndex == 0 && dynamicReferenceAllowed()) {
     // check dynamic table
@@ -51,6 +51,24 @@ class QPACKEncoder : public HPACKEncoderBase, public QPACKContext {
     uint64_t streamId,
     uint32_t maxEncoderStreamBytes=std::numeric_limits<uint32_t>::max());
 
+  /**
+   * Incremental encode of a large header list with a bounded working
+   * set.  startEncode() captures the block state; each encodeNext()
+   * call encodes headers until roughly maxStreamBytes more block bytes
+   * exist, returning any encoder stream instructions produced so far -
+   * those may be written to the wire immediately.  The request stream
+   * block is returned only by the completing call (done == true),
+   * since the prefix (Required Insert Count / Delta Base) can only be
+   * computed once every header has been encoded.  Regular encode()
+   * calls for other streams may be interleaved between chunks; only
+   * one incremental encode may be in progress per encoder.
+   */
+  void startEncode(std::vector<HPACKHeader> headers,
+                   uint64_t streamId,
+                   uint32_t maxEncoderStreamBytes =
+                       std::numeric_limits<uint32_t>::max());
+  EncodeResult encodeNext(uint32_t maxStreamBytes, bool* done);
+
   HPACK::DecodeError decodeDecoderStream(
       std::unique_ptr<folly::IOBuf> buf);
 
@@ -169,6 +187,16 @@ class QPACKEncoder : public HPACKEncoderBase, public QPACKContext {
   uint32_t maxTableSize_{0};
   int64_t maxEncoderStreamBytes_{0};
   folly::IOBufQueue decoderIngress_{folly::IOBufQueue::cacheChainLength()};
+  // incremental encode state; chunkedHeaders_ is set while a chunked
+  // encode is in progress
+  std::unique_ptr<std::vector<HPACKHeader>> chunkedHeaders_;
+  size_t chunkedIndex_{0};
+  uint64_t chunkedStreamId_{0};
+  uint32_t chunkedBaseIndex_{0};
+  uint32_t chunkedRequiredInsertCount_{0};
+  int64_t chunkedMaxEncoderStreamBytes_{0};
+  OutstandingBlock chunkedOutstanding_;
+  folly::IOBufQueue chunkedStreamBlock_{folly::IOBufQueue::cacheChainLength()};
   uint32_t numOutstandingBlocks_{0};
   uint32_t maxNumOutstandingBlocks_{kDefaultMaxOutstandingListSize};
 };
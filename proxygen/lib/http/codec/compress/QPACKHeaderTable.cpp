@@ -94,12 +94,15 @@ uint32_t QPACKHeaderTable::getIndexImpl(const HPACKHeaderName& headerName,
     return 0;
   }
   bool encoderHasUnackedEntry = false;
+  // comparing precomputed hashes rejects non-matching values without
+  // touching the strings
+  const uint64_t hash = nameOnly ? 0 : valueHash(value);
   // Searching backwards gives smallest index, but more likely vulnerable
   // Searching forwards least likely vulnerable but could prevent eviction
   for (auto indexIt = it->second.rbegin(); indexIt != it->second.rend();
        ++indexIt) {
     auto i = *indexIt;
-    if (nameOnly || table_[i].value == value) {
+    if (nameOnly || (valueHashes_[i] == hash && table_[i].value == value)) {
       // allow vulnerable or not vulnerable
       if (allowVulnerable || internalToAbsolute(i) <= ackedInsertCount_) {
         // index *may* be draining, caller has to check
@@ -121,6 +121,16 @@ StaticHeaderTable::StaticHeaderTable(
   for (auto& header : hlist) {
     add(std::move(header));
   }
+
+  // code-indexed name lookups; mirrors the candidate nameIndex() picks
+  nameIndexByCode_.fill(0);
+  for (const auto& entry : names()) {
+    const auto code = entry.first.getHeaderCode();
+    if (code != HTTP_HEADER_OTHER) {
+      nameIndexByCode_[static_cast<uint8_t>(code)] =
+          toExternal(*entry.second.rbegin());
+    }
+  }
 }
 
 const StaticHeaderTable& StaticHeaderTable::get() {
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <proxygen/lib/http/codec/compress/HeaderTable.h>
+#include <array>
 #include <proxygen/lib/http/HTTPCommonHeaders.h>
 
 namespace proxygen {
@@ -21,6 +22,18 @@ class StaticHeaderTable : public HeaderTable {
   static const StaticHeaderTable& get();
 
   static bool isHeaderCodeInTableWithNonEmptyValue(HTTPHeaderCode headerCode);
+
+  /**
+   * Name lookup as one array load: every static table name is a common
+   * header, so its code indexes straight to the same answer
+   * nameIndex() would produce (0 when the name isn't in the table).
+   */
+  uint32_t nameIndexByCode(HTTPHeaderCode code) const {
+    return nameIndexByCode_[static_cast<uint8_t>(code)];
+  }
+
+ private:
+  std::array<uint32_t, 256> nameIndexByCode_{};
 };
 
 }
@@ -219,7 +219,7 @@ class QIFCallback : public HPACK::StreamingCallback {
     of(of_) {}
 
   void onHeader(const HPACKHeaderName& name,
-                const folly::fbstring& value) override {
+                folly::StringPiece value) override {
     if (first) {
       of << "# stream " << id << std::endl;
       first = false;
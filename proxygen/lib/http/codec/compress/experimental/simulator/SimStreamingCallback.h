@@ -32,7 +32,7 @@ class SimStreamingCallback : public HPACK::StreamingCallback {
   }
 
   void onHeader(const HPACKHeaderName& hname,
-                const folly::fbstring& value) override {
+                folly::StringPiece value) override {
     std::string name = hname.get();
     if (name[0] == ':' && !isPublic) {
       if (name == headers::kMethod) {
@@ -42,16 +42,16 @@ class SimStreamingCallback : public HPACK::StreamingCallback {
           msg.setSecure(true);
         }
       } else if (name == headers::kAuthority) {
-        msg.getHeaders().add(HTTP_HEADER_HOST, value.toStdString());
+        msg.getHeaders().add(HTTP_HEADER_HOST, value.str());
       } else if (name == headers::kPath) {
-        msg.setURL(value.toStdString());
+        msg.setURL(value.str());
       } else if (name == headers::kStatus) {
-        msg.setStatusCode(folly::to<uint16_t>(value.toStdString()));
+        msg.setStatusCode(folly::to<uint16_t>(value.str()));
       } else {
         DCHECK(false) << "Bad header name=" << name << " value=" << value;
       }
     } else {
-      msg.getHeaders().add(name, value.toStdString());
+      msg.getHeaders().add(name, value.str());
     }
   }
 
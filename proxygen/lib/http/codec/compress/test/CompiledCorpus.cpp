@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/codec/compress/test/CompiledCorpus.h>
+
+#include <cstring>
+#include <fcntl.h>
+#include <folly/File.h>
+#include <fstream>
+#include <glog/logging.h>
+
+namespace {
+
+constexpr char kMagic[4] = {'P', 'X', 'C', 'C'};
+constexpr uint32_t kVersion = 1;
+
+// Bounds-checked cursor over the mapping; any overrun latches fail()
+class Cursor {
+ public:
+  explicit Cursor(folly::StringPiece data) : data_(data) {
+  }
+
+  template <typename T>
+  bool read(T& out) {
+    if (offset_ + sizeof(T) > data_.size()) {
+      failed_ = true;
+      return false;
+    }
+    memcpy(&out, data_.data() + offset_, sizeof(T));
+    offset_ += sizeof(T);
+    return true;
+  }
+
+  bool readBytes(folly::StringPiece& out, size_t len) {
+    if (offset_ + len > data_.size()) {
+      failed_ = true;
+      return false;
+    }
+    out = folly::StringPiece(data_.data() + offset_, len);
+    offset_ += len;
+    return true;
+  }
+
+  void seek(uint64_t offset) {
+    if (offset > data_.size()) {
+      failed_ = true;
+      return;
+    }
+    offset_ = offset;
+  }
+
+  bool failed() const {
+    return failed_;
+  }
+
+ private:
+  folly::StringPiece data_;
+  size_t offset_{0};
+  bool failed_{false};
+};
+
+template <typename T>
+void writeRaw(std::ofstream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+namespace proxygen {
+
+std::unique_ptr<CompiledCorpus> CompiledCorpus::open(
+    const std::string& path) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    PLOG(ERROR) << "cannot open corpus " << path;
+    return nullptr;
+  }
+  folly::MemoryMapping mapping(folly::File(fd, true /* ownsFd */));
+  auto corpus =
+      std::unique_ptr<CompiledCorpus>(new CompiledCorpus(std::move(mapping)));
+  corpus->data_ = corpus->mapping_.data();
+
+  Cursor cursor(corpus->data_);
+  folly::StringPiece magic;
+  uint32_t version = 0;
+  uint64_t blockCount = 0;
+  if (!cursor.readBytes(magic, sizeof(kMagic)) ||
+      memcmp(magic.data(), kMagic, sizeof(kMagic)) != 0 ||
+      !cursor.read(version) || version != kVersion ||
+      !cursor.read(blockCount) ||
+      blockCount > corpus->data_.size() / sizeof(uint64_t)) {
+    LOG(ERROR) << "not a compiled corpus: " << path;
+    return nullptr;
+  }
+  corpus->blockOffsets_.reserve(blockCount);
+  for (uint64_t i = 0; i < blockCount; i++) {
+    uint64_t offset = 0;
+    if (!cursor.read(offset) || offset > corpus->data_.size()) {
+      LOG(ERROR) << "truncated corpus index: " << path;
+      return nullptr;
+    }
+    corpus->blockOffsets_.push_back(offset);
+  }
+  return corpus;
+}
+
+CompiledCorpus::Block CompiledCorpus::getBlock(size_t index) const {
+  CHECK_LT(index, blockOffsets_.size());
+  Block block;
+  Cursor cursor(data_);
+  cursor.seek(blockOffsets_[index]);
+  uint32_t headerCount = 0;
+  if (!cursor.read(headerCount)) {
+    return block;
+  }
+  block.reserve(headerCount);
+  for (uint32_t i = 0; i < headerCount; i++) {
+    uint32_t nameLen = 0;
+    uint32_t valueLen = 0;
+    HeaderView header;
+    if (!cursor.read(nameLen) || !cursor.read(valueLen) ||
+        !cursor.readBytes(header.name, nameLen) ||
+        !cursor.readBytes(header.value, valueLen)) {
+      LOG(ERROR) << "truncated corpus block " << index;
+      block.clear();
+      return block;
+    }
+    block.push_back(header);
+  }
+  return block;
+}
+
+bool CompiledCorpus::write(
+    const std::vector<std::vector<HPACKHeader>>& blocks,
+    const std::string& path) {
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    LOG(ERROR) << "cannot open " << path << " for writing";
+    return false;
+  }
+  out.write(kMagic, sizeof(kMagic));
+  writeRaw(out, kVersion);
+  writeRaw(out, uint64_t(blocks.size()));
+
+  // records start after the offset table
+  uint64_t offset = sizeof(kMagic) + sizeof(uint32_t) + sizeof(uint64_t) +
+                    blocks.size() * sizeof(uint64_t);
+  for (const auto& block : blocks) {
+    writeRaw(out, offset);
+    offset += sizeof(uint32_t);
+    for (const auto& header : block) {
+      offset += 2 * sizeof(uint32_t) + header.name.size() +
+                header.value.size();
+    }
+  }
+  for (const auto& block : blocks) {
+    writeRaw(out, uint32_t(block.size()));
+    for (const auto& header : block) {
+      const std::string& name = header.name.get();
+      writeRaw(out, uint32_t(name.size()));
+      writeRaw(out, uint32_t(header.value.size()));
+      out.write(name.data(), name.size());
+      out.write(header.value.data(), header.value.size());
+    }
+  }
+  out.flush();
+  return bool(out);
+}
+
+} // namespace proxygen
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Range.h>
+#include <folly/system/MemoryMapping.h>
+#include <memory>
+#include <proxygen/lib/http/codec/compress/HPACKHeader.h>
+#include <string>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Compiled header corpus: HAR-derived header blocks in a flat,
+ * memory-mappable binary so benchmark runs skip the JSON parse.
+ *
+ * A HAR corpus big enough to be representative spends nearly all of
+ * its load time in folly::parseJson; compiling it once with write()
+ * (or the corpus compiler tool) turns every subsequent load into an
+ * mmap plus pointer fixups.  Blocks are read back as StringPiece
+ * views into the mapping - no string copies - so iterating 10GB of
+ * recorded traffic is bounded by page-in, not parsing.
+ *
+ * Layout (native endian; this is a local cache format, not an
+ * interchange format):
+ *
+ *   "PXCC" | u32 version | u64 blockCount | u64 blockOffset[blockCount]
+ *   per block, at its offset:
+ *     u32 headerCount | headerCount x { u32 nameLen | u32 valueLen |
+ *                                       name bytes | value bytes }
+ */
+class CompiledCorpus {
+ public:
+  struct HeaderView {
+    folly::StringPiece name;
+    folly::StringPiece value;
+  };
+  using Block = std::vector<HeaderView>;
+
+  /** Maps the file; returns nullptr (with a logged error) on any
+      malformed or truncated input. */
+  static std::unique_ptr<CompiledCorpus> open(const std::string& path);
+
+  /** Writes blocks in the compiled format; returns false on I/O error. */
+  static bool write(const std::vector<std::vector<HPACKHeader>>& blocks,
+                    const std::string& path);
+
+  size_t size() const {
+    return blockOffsets_.size();
+  }
+
+  /** Views into the mapping; valid while this corpus is alive. */
+  Block getBlock(size_t index) const;
+
+ private:
+  explicit CompiledCorpus(folly::MemoryMapping mapping)
+      : mapping_(std::move(mapping)) {
+  }
+
+  folly::MemoryMapping mapping_;
+  folly::StringPiece data_;
+  std::vector<uint64_t> blockOffsets_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/codec/compress/test/CompiledCorpus.h>
+
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/GTest.h>
+#include <fstream>
+
+using namespace proxygen;
+
+TEST(CompiledCorpus, WriteOpenRoundtrip) {
+  std::vector<std::vector<HPACKHeader>> blocks;
+  {
+    std::vector<HPACKHeader> block;
+    block.emplace_back(":method", "GET");
+    block.emplace_back(":path", "/index.html");
+    block.emplace_back("accept-encoding", "gzip");
+    blocks.push_back(std::move(block));
+  }
+  {
+    std::vector<HPACKHeader> block;
+    block.emplace_back(":status", "200");
+    block.emplace_back("content-type", "text/html");
+    blocks.push_back(std::move(block));
+  }
+
+  folly::test::TemporaryFile file("compiled_corpus");
+  ASSERT_TRUE(CompiledCorpus::write(blocks, file.path().string()));
+
+  auto corpus = CompiledCorpus::open(file.path().string());
+  ASSERT_NE(corpus, nullptr);
+  ASSERT_EQ(corpus->size(), 2);
+
+  auto first = corpus->getBlock(0);
+  ASSERT_EQ(first.size(), 3);
+  EXPECT_EQ(first[0].name, ":method");
+  EXPECT_EQ(first[0].value, "GET");
+  EXPECT_EQ(first[1].value, "/index.html");
+  EXPECT_EQ(first[2].name, "accept-encoding");
+
+  auto second = corpus->getBlock(1);
+  ASSERT_EQ(second.size(), 2);
+  EXPECT_EQ(second[0].name, ":status");
+  EXPECT_EQ(second[1].value, "text/html");
+}
+
+TEST(CompiledCorpus, RejectsMalformedInput) {
+  EXPECT_EQ(CompiledCorpus::open("/nonexistent/corpus.pxcc"), nullptr);
+
+  folly::test::TemporaryFile file("compiled_corpus_bad");
+  {
+    std::ofstream out(file.path().string(), std::ios::binary);
+    out << "this is not a compiled corpus";
+  }
+  EXPECT_EQ(CompiledCorpus::open(file.path().string()), nullptr);
+
+  // valid magic but a block count pointing past the end of the file
+  {
+    std::ofstream out(file.path().string(),
+                      std::ios::binary | std::ios::trunc);
+    out.write("PXCC", 4);
+    uint32_t version = 1;
+    uint64_t blockCount = 1000;
+    out.write(reinterpret_cast<char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<char*>(&blockCount), sizeof(blockCount));
+  }
+  EXPECT_EQ(CompiledCorpus::open(file.path().string()), nullptr);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Compile header corpora into the memory-mappable format read by
+ * CompiledCorpus, so benchmark iteration stops paying the HAR JSON
+ * parse on every run:
+ *
+ *   corpus_compiler --har prod.har --out prod.pxcc
+ *   corpus_compiler --har prod.har --responses --out responses.pxcc
+ *
+ * Can also distill a fuzzer corpus directory into a representative
+ * benchmark set: each input is parsed as HTTP/1.x, and the resulting
+ * header blocks are deduped by structure (header names plus value
+ * size buckets), keeping one exemplar per shape:
+ *
+ *   corpus_compiler --fuzz_corpus proxygen/fuzzers/corpus --out fuzz.pxcc
+ *
+ * --dedupe applies the same distillation to HAR input.
+ */
+
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include <folly/portability/GFlags.h>
+#include <glog/logging.h>
+
+#include <proxygen/lib/http/codec/HTTP1xCodec.h>
+#include <proxygen/lib/http/codec/compress/test/CompiledCorpus.h>
+#include <proxygen/lib/http/codec/compress/test/HTTPArchive.h>
+#include <proxygen/lib/http/codec/test/TestUtils.h>
+
+DEFINE_string(har, "", "HAR file to compile");
+DEFINE_bool(responses, false, "compile response headers instead of requests");
+DEFINE_string(fuzz_corpus, "", "directory of fuzzer inputs to distill");
+DEFINE_string(out, "corpus.pxcc", "output file");
+DEFINE_bool(dedupe, false, "also dedupe HAR blocks by header structure");
+
+using namespace proxygen;
+
+namespace {
+
+/**
+ * Structural fingerprint of a header block: the ordered header names
+ * plus a log2 bucket of each value length.  Blocks that differ only
+ * in concrete values exercise the same codec paths, so one exemplar
+ * per fingerprint is representative for benchmarking.
+ */
+size_t fingerprint(const std::vector<HPACKHeader>& block) {
+  std::ostringstream key;
+  for (const auto& header : block) {
+    key << header.name.get() << '\x01';
+    size_t bucket = 0;
+    for (size_t len = header.value.size(); len > 0; len >>= 1) {
+      bucket++;
+    }
+    key << bucket << '\x02';
+  }
+  return std::hash<std::string>()(key.str());
+}
+
+std::vector<std::vector<HPACKHeader>> dedupe(
+    std::vector<std::vector<HPACKHeader>> blocks) {
+  std::unordered_set<size_t> seen;
+  std::vector<std::vector<HPACKHeader>> unique;
+  for (auto& block : blocks) {
+    if (seen.insert(fingerprint(block)).second) {
+      unique.push_back(std::move(block));
+    }
+  }
+  return unique;
+}
+
+// Collects every parsed message, not just the last one
+struct CollectingCallback : FakeHTTPCodecCallback {
+  std::vector<HTTPMessage> messages;
+  void onHeadersComplete(HTTPCodec::StreamID /*stream*/,
+                         std::unique_ptr<HTTPMessage> inMsg) override {
+    messages.push_back(*inMsg);
+  }
+};
+
+std::vector<std::vector<HPACKHeader>> distillFuzzCorpus(
+    const std::string& dir) {
+  std::vector<HTTPMessage> messages;
+  DIR* corpus = opendir(dir.c_str());
+  if (!corpus) {
+    LOG(ERROR) << "cannot open corpus directory " << dir;
+    return {};
+  }
+  size_t files = 0;
+  while (auto* entry = readdir(corpus)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    std::ifstream in(dir + "/" + name, std::ios::binary);
+    if (!in) {
+      continue;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    files++;
+
+    // Each input is a candidate HTTP/1.x byte stream; parse failures
+    // just yield fewer (or zero) messages
+    HTTP1xCodec codec(TransportDirection::DOWNSTREAM);
+    CollectingCallback callback;
+    codec.setCallback(&callback);
+    auto buf = folly::IOBuf::copyBuffer(buffer.str());
+    codec.onIngress(*buf);
+    for (auto& msg : callback.messages) {
+      messages.push_back(std::move(msg));
+    }
+  }
+  closedir(corpus);
+  LOG(INFO) << "parsed " << messages.size() << " messages from " << files
+            << " fuzzer inputs";
+  return HTTPArchive::convertToHPACK(messages);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  google::InstallFailureSignalHandler();
+
+  std::vector<std::vector<HPACKHeader>> blocks;
+  if (!FLAGS_har.empty()) {
+    auto har = HTTPArchive::fromFile(FLAGS_har);
+    if (!har) {
+      LOG(ERROR) << "cannot load " << FLAGS_har;
+      return 1;
+    }
+    blocks = HTTPArchive::convertToHPACK(FLAGS_responses ? har->responses
+                                                         : har->requests);
+    if (FLAGS_dedupe) {
+      auto before = blocks.size();
+      blocks = dedupe(std::move(blocks));
+      LOG(INFO) << "deduped " << before << " blocks to " << blocks.size();
+    }
+  } else if (!FLAGS_fuzz_corpus.empty()) {
+    blocks = dedupe(distillFuzzCorpus(FLAGS_fuzz_corpus));
+  } else {
+    LOG(ERROR) << "one of --har or --fuzz_corpus is required";
+    return 1;
+  }
+
+  if (blocks.empty()) {
+    LOG(ERROR) << "no header blocks to write";
+    return 1;
+  }
+  if (!CompiledCorpus::write(blocks, FLAGS_out)) {
+    return 1;
+  }
+  LOG(INFO) << "wrote " << blocks.size() << " blocks to " << FLAGS_out;
+  return 0;
+}
@@ -101,6 +101,41 @@ BENCHMARK(EncodeDecode2, iters) {
   encodeDecodeBench(2, iters);
 }
 
+vector<HPACKHeader> getLongLiteralHeaders() {
+  vector<HPACKHeader> longHeaders = getHeaders();
+  string cookie;
+  for (int i = 0; i < 40; i++) {
+    cookie += "c68e48f9b1ac2f=wPthbCfMrWeGJEcLotzN19iBXOQ5sU7D;";
+  }
+  longHeaders.emplace_back("cookie", cookie);
+  return longHeaders;
+}
+
+void decodeBench(vector<HPACKHeader>& decodeHeaders, int iters) {
+  unique_ptr<IOBuf> encoded;
+  BENCHMARK_SUSPEND {
+    HPACKEncoder encoder(true);
+    encoded = encode(decodeHeaders, encoder);
+    CHECK(encoded);
+  }
+  for (int i = 0; i < iters; i++) {
+    HPACKDecoder decoder;
+    TestStreamingCallback cb;
+    folly::io::Cursor c(encoded.get());
+    decoder.decodeStreaming(c, c.totalLength(), &cb);
+    CHECK(!cb.hasError());
+  }
+}
+
+BENCHMARK(Decode, iters) {
+  decodeBench(headers, iters);
+}
+
+BENCHMARK(DecodeLongLiterals, iters) {
+  auto longHeaders = getLongLiteralHeaders();
+  decodeBench(longHeaders, iters);
+}
+
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   folly::runBenchmarks();
@@ -341,6 +341,39 @@ TEST_F(HPACKBufferTests, DecodePlainLiteral) {
 }
 
 
+TEST_F(HPACKBufferTests, DecodePlainLiteralBorrow) {
+  buf_ = IOBuf::create(512);
+  std::string gzip("gzip");
+  folly::fbstring storage;
+  folly::StringPiece literal;
+  uint8_t* wdata = buf_->writableData();
+
+  buf_->append(1 + gzip.size());
+  wdata[0] = gzip.size();
+  memcpy(wdata + 1, gzip.c_str(), gzip.size());
+
+  resetDecoder();
+  CHECK_EQ(decoder_.decodeLiteral(7, storage, literal), DecodeError::NONE);
+  CHECK_EQ(literal, gzip);
+  // the literal points into the ingress buffer, nothing was copied out
+  EXPECT_EQ(reinterpret_cast<const uint8_t*>(literal.data()), wdata + 1);
+  EXPECT_TRUE(storage.empty());
+}
+
+TEST_F(HPACKBufferTests, DecodeHuffmanLiteralBorrow) {
+  // huffman-coded literals cannot be borrowed, they materialize in storage
+  std::string accept("accept-encoding");
+  HPACKEncodeBuffer encoder(512, true);
+  encoder.encodeLiteral(accept);
+  releaseData(encoder);
+  resetDecoder();
+  folly::fbstring storage;
+  folly::StringPiece literal;
+  CHECK_EQ(decoder_.decodeLiteral(7, storage, literal), DecodeError::NONE);
+  CHECK_EQ(literal, accept);
+  EXPECT_EQ(literal.data(), storage.data());
+}
+
 TEST_F(HPACKBufferTests, DecodePlainLiteralN) {
   buf_ = IOBuf::create(512);
   std::string gzip("gzip");
@@ -379,6 +412,47 @@ TEST_F(HPACKBufferTests, IntegerEncodeDecode) {
   EXPECT_EQ(integer, value);
 }
 
+TEST_F(HPACKBufferTests, IntegerDecodeAcrossBuffers) {
+  // the bulk path only runs on contiguous bytes; every split of the
+  // encoding must still decode identically via the boundary loop
+  HPACKEncodeBuffer encoder(512);
+  uint32_t value = 145333; // 4-byte encoding with a 5-bit prefix
+  encoder.encodeInteger(value, 128, 5);
+  auto encoded = encoder.release();
+  encoded->coalesce();
+  for (size_t split = 1; split < encoded->length(); split++) {
+    auto chain = IOBuf::copyBuffer(encoded->data(), split);
+    chain->appendChain(IOBuf::copyBuffer(encoded->data() + split,
+                                         encoded->length() - split));
+    Cursor cursor(chain.get());
+    HPACKDecodeBuffer decoder(
+        cursor, uint32_t(encoded->length()), kMaxLiteralSize);
+    uint64_t integer = 0;
+    EXPECT_EQ(decoder.decodeInteger(5, integer), DecodeError::NONE);
+    EXPECT_EQ(integer, value) << "split=" << split;
+  }
+}
+
+TEST_F(HPACKBufferTests, IntegerDecodeBulkBoundary) {
+  // values needing exactly 8 continuation bytes stay on the bulk path;
+  // 9 continuation bytes fall back to the loop - both must agree with
+  // the encoder
+  HPACKEncodeBuffer encoder(512);
+  for (uint64_t value :
+       {uint64_t(127), (uint64_t(1) << 56) - 2 + 127, (uint64_t(1) << 60)}) {
+    encoder.encodeInteger(value, 0, 7);
+    auto encoded = encoder.release();
+    Cursor cursor(encoded.get());
+    HPACKDecodeBuffer decoder(
+        cursor,
+        uint32_t(encoded->computeChainDataLength()),
+        kMaxLiteralSize);
+    uint64_t integer = 0;
+    EXPECT_EQ(decoder.decodeInteger(7, integer), DecodeError::NONE);
+    EXPECT_EQ(integer, value);
+  }
+}
+
 /**
  * really large integers
  */
@@ -77,6 +77,19 @@ TEST_F(HeaderTableTests, Add) {
   EXPECT_EQ(table.nameIndex(header.name), 1);
 }
 
+TEST_F(HeaderTableTests, GetIndexManyValuesPerName) {
+  // one name, many values: exact-match lookup must find the right entry
+  // via the precomputed value hashes
+  HeaderTable table(8192);
+  for (int i = 0; i < 50; i++) {
+    table.add(HPACKHeader("cookie", "session=" + std::to_string(i)));
+  }
+  EXPECT_EQ(table.getIndex(HPACKHeader("cookie", "session=49")), 1);
+  EXPECT_EQ(table.getIndex(HPACKHeader("cookie", "session=0")), 50);
+  EXPECT_EQ(table.getIndex(HPACKHeader("cookie", "session=50")), 0);
+  EXPECT_EQ(table.getIndex(HPACKHeader("set-cookie", "session=0")), 0);
+}
+
 TEST_F(HeaderTableTests, Evict) {
   HPACKHeaderName name("accept-encoding");
   HPACKHeader accept("accept-encoding", "gzip");
@@ -293,32 +306,47 @@ TEST_F(HeaderTableTests, AddLargerThanTable) {
 }
 
 TEST_F(HeaderTableTests, IncreaseLengthOfFullTable) {
-  HPACKHeader largeHeader("Access-Control-Allow-Credentials", "true");
-  HPACKHeader smallHeader("Accept", "All-Content");
+  HPACKHeader largeHeader("Access-Control-Allow-Credentials", "true"); // 68B
+  HPACKHeader smallHeader("Accept", "All-Content");                    // 49B
 
   HeaderTable table(448);
-  CHECK_EQ(table.length(), 7);
+  CHECK_EQ(table.length(), 8); // lazy initial allocation
 
-  for (uint8_t count = 0; count < 3; count++) {
+  // large headers fill the byte budget so the small adds that follow
+  // evict them one by one, advancing the ring's tail past the head
+  for (uint8_t count = 0; count < 6; count++) {
     table.add(largeHeader.copy());
+  }
+  for (uint8_t count = 0; count < 8; count++) {
     table.add(smallHeader.copy());
-  } // tail is at index 0
-  CHECK_EQ(table.length(), 7);
+  }
+  CHECK_EQ(table.length(), 8);
+  CHECK_EQ(table.size(), 8);
 
+  // this add finds the table full with a wrapped ring; the resize has
+  // to unwrap tail..length to the end of the larger table
   table.add(smallHeader.copy());
-  table.add(smallHeader.copy()); // tail is at index 1
-  table.add(smallHeader.copy()); // resize on this add
-  EXPECT_EQ(table.length(), 11);
-
-  // Check table is correct after resize
-  CHECK_EQ(table.getHeader(1), smallHeader);
-  CHECK_EQ(table.getHeader(2), smallHeader);
-  CHECK_EQ(table.getHeader(3), smallHeader);
-  CHECK_EQ(table.getHeader(4), smallHeader);
-  CHECK_EQ(table.getHeader(5), largeHeader);
-  CHECK_EQ(table.getHeader(6), smallHeader);
-  CHECK_EQ(table.getHeader(7), largeHeader);
-  CHECK_EQ(table.getHeader(8), smallHeader);
+  EXPECT_EQ(table.length(), 12);
+  EXPECT_EQ(table.size(), 9);
+  for (uint8_t i = 1; i <= 9; i++) {
+    CHECK_EQ(table.getHeader(i), smallHeader);
+  }
+}
+
+TEST_F(HeaderTableTests, LazyInitAndThreadAccounting) {
+  auto before = HeaderTable::getThreadTableStorageBytes();
+  {
+    HeaderTable table(4096);
+    // tiny initial allocation regardless of the 4KB capacity
+    EXPECT_EQ(table.length(), 8);
+    EXPECT_GT(HeaderTable::getThreadTableStorageBytes(), before);
+    // within budget: the desired capacity is advertised
+    EXPECT_EQ(HeaderTable::budgetedCapacity(4096, uint64_t(1) << 30), 4096);
+    // over budget (anything at or below the pre-existing level): clamp
+    EXPECT_EQ(HeaderTable::budgetedCapacity(4096, before), 1024);
+  }
+  // destruction returns the worker's accounting to its prior level
+  EXPECT_EQ(HeaderTable::getThreadTableStorageBytes(), before);
 }
 
 TEST_F(HeaderTableTests, SmallTable) {
@@ -163,6 +163,29 @@ TEST_F(HuffmanTests, UserAgent) {
   CHECK_EQ(user_agent, decoded);
 }
 
+/*
+ * exercise the bulk decode path with literals of every length around the
+ * 4-byte reservoir refill boundary, including multi-byte codes
+ */
+TEST_F(HuffmanTests, BulkDecodeBoundaries) {
+  folly::fbstring literal(
+    "x-fb-long-literal: {\"q\"=0.53, #frag, |&^%$}; \xa0\xff\x01");
+  for (size_t len = 1; len <= literal.size(); len++) {
+    IOBufQueue bufQueue;
+    QueueAppender appender(&bufQueue, 512);
+    appender.ensure(512);
+
+    folly::fbstring prefix = literal.substr(0, len);
+    uint32_t size = tree_.getEncodeSize(prefix);
+    uint32_t encodedSize = tree_.encode(prefix, appender);
+    EXPECT_EQ(size, encodedSize);
+
+    folly::fbstring decoded;
+    tree_.decode(bufQueue.front()->data(), size, decoded);
+    CHECK_EQ(prefix, decoded);
+  }
+}
+
 /*
  * this test is verifying the CHECK for length at the end of huffman::encode()
  */
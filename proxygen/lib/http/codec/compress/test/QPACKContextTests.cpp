@@ -190,6 +190,158 @@ TEST(QPACKContextTests, PostBaseNameIndexedLiteral) {
   verifyDecode(decoder, std::move(result), req);
 }
 
+TEST(QPACKContextTests, TestIncrementalEncode) {
+  QPACKEncoder encoder(true, 4096);
+  QPACKDecoder decoder(4096);
+
+  auto makeHeaders = [] {
+    std::vector<HPACKHeader> headers;
+    for (uint32_t i = 0; i < 100; i++) {
+      headers.emplace_back(folly::to<std::string>("x-header-", i),
+                           toFixedLengthString(i));
+    }
+    return headers;
+  };
+  auto req = makeHeaders();
+  // HPACKHeader is move-only; hand the encoder its own copy
+  encoder.startEncode(makeHeaders(), 1);
+  QPACKEncoder::EncodeResult result{nullptr, nullptr};
+  folly::IOBufQueue control{folly::IOBufQueue::cacheChainLength()};
+  bool done = false;
+  uint32_t chunks = 0;
+  while (!done) {
+    auto chunk = encoder.encodeNext(64, &done);
+    if (chunk.control) {
+      control.append(std::move(chunk.control));
+    }
+    if (done) {
+      result.stream = std::move(chunk.stream);
+    } else {
+      // only the completing call may return the block
+      EXPECT_EQ(chunk.stream, nullptr);
+    }
+    chunks++;
+  }
+  EXPECT_GT(chunks, 1);
+  result.control = control.move();
+  verifyDecode(decoder, std::move(result), req);
+}
+
+TEST(QPACKContextTests, TestIncrementalEncodeInterleaved) {
+  QPACKEncoder encoder(true, 4096);
+  QPACKDecoder decoder(4096);
+
+  auto makeHeaders = [] {
+    std::vector<HPACKHeader> headers;
+    for (uint32_t i = 0; i < 50; i++) {
+      headers.emplace_back(folly::to<std::string>("x-large-", i),
+                           toFixedLengthString(i));
+    }
+    return headers;
+  };
+  auto big = makeHeaders();
+  std::vector<HPACKHeader> small;
+  small.emplace_back(":method", "GET");
+
+  encoder.startEncode(makeHeaders(), 1);
+  bool done = false;
+  auto chunk = encoder.encodeNext(64, &done);
+  EXPECT_FALSE(done);
+  // feed encoder stream instructions to the decoder as they are emitted
+  if (chunk.control) {
+    EXPECT_EQ(decoder.decodeEncoderStream(std::move(chunk.control)),
+              HPACK::DecodeError::NONE);
+  }
+
+  // a regular encode for another stream between chunks must not disturb
+  // the in-progress block
+  auto smallResult = encoder.encode(small, 0, 2);
+  verifyDecode(decoder, std::move(smallResult), small);
+
+  QPACKEncoder::EncodeResult result{nullptr, nullptr};
+  while (!done) {
+    chunk = encoder.encodeNext(64, &done);
+    if (chunk.control) {
+      EXPECT_EQ(decoder.decodeEncoderStream(std::move(chunk.control)),
+                HPACK::DecodeError::NONE);
+    }
+    if (done) {
+      result.stream = std::move(chunk.stream);
+    }
+  }
+  verifyDecode(decoder, std::move(result), big);
+}
+
+TEST(QPACKContextTests, TestPrioritizedUnblock) {
+  QPACKEncoder encoder(false, 4096);
+  QPACKDecoder decoder(4096);
+  decoder.setMaxBlocking(10);
+  encoder.setMaxVulnerable(10);
+
+  vector<HPACKHeader> req1;
+  req1.emplace_back("monkey1", "banana");
+  vector<HPACKHeader> req2;
+  req2.emplace_back("monkey2", "banana");
+  auto res1 = encoder.encode(req1, 0, 1);
+  auto res2 = encoder.encode(req2, 0, 2);
+
+  // decode the request streams before the encoder stream: both block
+  vector<uint64_t> order;
+  TestStreamingCallback cb1;
+  TestStreamingCallback cb2;
+  cb1.headersCompleteCb = [&order] { order.push_back(1); };
+  cb2.headersCompleteCb = [&order] { order.push_back(2); };
+  auto len1 = res1.stream->computeChainDataLength();
+  auto len2 = res2.stream->computeChainDataLength();
+  decoder.decodeStreaming(1, std::move(res1.stream), len1, &cb1);
+  decoder.decodeStreaming(2, std::move(res2.stream), len2, &cb2);
+  EXPECT_TRUE(order.empty());
+
+  // stream 2 is more urgent; one insert flush wakes both but 2 decodes
+  // first
+  decoder.setQueuedStreamPriority(2, 0);
+  res1.control->prependChain(std::move(res2.control));
+  EXPECT_EQ(decoder.decodeEncoderStream(std::move(res1.control)),
+            HPACK::DecodeError::NONE);
+  EXPECT_EQ(order, (vector<uint64_t>{2, 1}));
+}
+
+TEST(QPACKContextTests, TestUnblockBudget) {
+  QPACKEncoder encoder(false, 4096);
+  QPACKDecoder decoder(4096);
+  decoder.setMaxBlocking(10);
+  encoder.setMaxVulnerable(10);
+  uint32_t resumes = 0;
+  decoder.setUnblockBudget(1, [&resumes] { resumes++; });
+
+  vector<HPACKHeader> req1;
+  req1.emplace_back("monkey1", "banana");
+  vector<HPACKHeader> req2;
+  req2.emplace_back("monkey2", "banana");
+  auto res1 = encoder.encode(req1, 0, 1);
+  auto res2 = encoder.encode(req2, 0, 2);
+
+  vector<uint64_t> order;
+  TestStreamingCallback cb1;
+  TestStreamingCallback cb2;
+  cb1.headersCompleteCb = [&order] { order.push_back(1); };
+  cb2.headersCompleteCb = [&order] { order.push_back(2); };
+  auto len1 = res1.stream->computeChainDataLength();
+  auto len2 = res2.stream->computeChainDataLength();
+  decoder.decodeStreaming(1, std::move(res1.stream), len1, &cb1);
+  decoder.decodeStreaming(2, std::move(res2.stream), len2, &cb2);
+
+  res1.control->prependChain(std::move(res2.control));
+  EXPECT_EQ(decoder.decodeEncoderStream(std::move(res1.control)),
+            HPACK::DecodeError::NONE);
+  // only one block decoded, the drain yielded and asked to be resumed
+  EXPECT_EQ(order, (vector<uint64_t>{1}));
+  EXPECT_EQ(resumes, 1);
+  decoder.drainPendingBlocks();
+  EXPECT_EQ(order, (vector<uint64_t>{1, 2}));
+  EXPECT_EQ(resumes, 1);
+}
+
 TEST(QPACKContextTests, TestOutstandingListTooLong) {
   QPACKEncoder encoder(false, 4096);
   encoder.setMaxNumOutstandingBlocks(3);
@@ -19,8 +19,8 @@ namespace proxygen {
 class TestStreamingCallback : public HPACK::StreamingCallback {
  public:
   void onHeader(const HPACKHeaderName& hname,
-                const folly::fbstring& value) override {
-    auto name = hname.get();
+                folly::StringPiece value) override {
+    folly::StringPiece name = hname.get();
     headers.emplace_back(duplicate(name), name.size(), true, false);
     headers.emplace_back(duplicate(value), value.size(), true, false);
   }
@@ -65,9 +65,10 @@ class TestStreamingCallback : public HPACK::StreamingCallback {
 
   compress::HeaderPieceList headers;
   HPACK::DecodeError error{HPACK::DecodeError::NONE};
-  char* duplicate(const folly::fbstring& str) {
-    char* res = CHECK_NOTNULL(new char[str.length() + 1]);
-    memcpy(res, str.data(), str.length() + 1);
+  char* duplicate(folly::StringPiece str) {
+    char* res = CHECK_NOTNULL(new char[str.size() + 1]);
+    memcpy(res, str.data(), str.size());
+    res[str.size()] = '\0';
     return res;
   }
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/codec/CodecUtil.h>
+
+using namespace proxygen;
+
+namespace {
+
+folly::ByteRange toRange(const std::string& s) {
+  return folly::ByteRange(folly::StringPiece(s));
+}
+
+// pad a probe string so the interesting byte lands both inside the 8-byte
+// bulk path and in the scalar tail
+std::string padded(const std::string& probe, size_t padLen) {
+  return std::string(padLen, 'a') + probe;
+}
+
+} // namespace
+
+TEST(CodecUtilTest, ValidateURL) {
+  for (size_t pad = 0; pad < 10; pad++) {
+    EXPECT_TRUE(CodecUtil::validateURL(toRange(padded("/foo?bar=1", pad))));
+    EXPECT_FALSE(CodecUtil::validateURL(toRange(padded("/foo bar", pad))));
+    EXPECT_FALSE(CodecUtil::validateURL(toRange(padded("/foo\x01", pad))));
+    EXPECT_FALSE(CodecUtil::validateURL(toRange(padded("/foo\x7f", pad))));
+    // bytes >= 0x80 are allowed, as before
+    EXPECT_TRUE(CodecUtil::validateURL(toRange(padded("/foo\xc3\xa9", pad))));
+  }
+}
+
+TEST(CodecUtilTest, ValidateHeaderName) {
+  EXPECT_FALSE(CodecUtil::validateHeaderName(toRange("")));
+  for (size_t pad = 0; pad < 10; pad++) {
+    EXPECT_TRUE(CodecUtil::validateHeaderName(
+        toRange(padded("x-fb-header-name", pad))));
+    EXPECT_FALSE(CodecUtil::validateHeaderName(
+        toRange(padded("bad:name", pad))));
+    EXPECT_FALSE(CodecUtil::validateHeaderName(
+        toRange(padded("bad name", pad))));
+    EXPECT_FALSE(CodecUtil::validateHeaderName(
+        toRange(padded("bad\x01name", pad))));
+  }
+}
+
+TEST(CodecUtilTest, ValidateLongRunsAtEveryOffset) {
+  // exercise the 32-byte and word-wide kernels: a bad byte at every
+  // position of a long run must be caught, and clean runs must pass
+  std::string cleanName(100, 'a');
+  EXPECT_TRUE(CodecUtil::validateHeaderName(toRange(cleanName)));
+  std::string cleanValue(100, 'v');
+  EXPECT_TRUE(
+      CodecUtil::validateHeaderValue(toRange(cleanValue), CodecUtil::STRICT));
+  for (size_t i = 0; i < 100; i++) {
+    std::string name = cleanName;
+    name[i] = ' ';
+    EXPECT_FALSE(CodecUtil::validateHeaderName(toRange(name))) << i;
+    std::string value = cleanValue;
+    value[i] = '\x01';
+    EXPECT_FALSE(
+        CodecUtil::validateHeaderValue(toRange(value), CodecUtil::STRICT))
+        << i;
+  }
+}
+
+TEST(CodecUtilTest, ValidateHeaderValue) {
+  for (size_t pad = 0; pad < 10; pad++) {
+    EXPECT_TRUE(CodecUtil::validateHeaderValue(
+        toRange(padded("plain text value; q=0.5", pad)),
+        CodecUtil::STRICT));
+    EXPECT_TRUE(CodecUtil::validateHeaderValue(
+        toRange(padded("tab\tis ok", pad)), CodecUtil::STRICT));
+    EXPECT_FALSE(CodecUtil::validateHeaderValue(
+        toRange(padded("ctl\x01", pad)), CodecUtil::STRICT));
+    EXPECT_FALSE(CodecUtil::validateHeaderValue(
+        toRange(padded("del\x7f", pad)), CodecUtil::STRICT));
+    // LWS continuation is fine, dangling CR is not
+    EXPECT_TRUE(CodecUtil::validateHeaderValue(
+        toRange(padded("line1\r\n continuation", pad)),
+        CodecUtil::STRICT));
+    EXPECT_FALSE(CodecUtil::validateHeaderValue(
+        toRange(padded("dangling\r", pad)), CodecUtil::STRICT));
+    // escaped CTL inside quotes: COMPLIANT only
+    EXPECT_TRUE(CodecUtil::validateHeaderValue(
+        toRange(padded("\"quoted \\\x01 value\"", pad)),
+        CodecUtil::COMPLIANT));
+  }
+}
@@ -150,6 +150,43 @@ TEST_F(DefaultFlowControl, SendUpdate) {
   filter_->ingressBytesProcessed(writeBuf_, 1);
 }
 
+TEST_F(DefaultFlowControl, QuantizedUpdates) {
+  InSequence enforceSequence;
+  EXPECT_CALL(callback_, onBody(_, _, _)).WillRepeatedly(Return());
+  filter_->setUpdateStrategy(
+      FlowControlFilter::UpdateStrategy::QUARTER_QUANTIZED);
+  const uint32_t quantum = kInitialCapacity / 4;
+
+  // below one quantum: no update
+  callbackStart_->onBody(1, makeBuf(quantum - 1), 0);
+  filter_->ingressBytesProcessed(writeBuf_, quantum - 1);
+
+  // crossing the quantum acks exactly one quantum; the remainder waits
+  EXPECT_CALL(*codec_, generateWindowUpdate(_, 0, quantum));
+  callbackStart_->onBody(1, makeBuf(2), 0);
+  filter_->ingressBytesProcessed(writeBuf_, 2);
+
+  // two more quanta drain in one batch: one update of two quanta
+  EXPECT_CALL(*codec_, generateWindowUpdate(_, 0, 2 * quantum));
+  callbackStart_->onBody(1, makeBuf(2 * quantum), 0);
+  filter_->ingressBytesProcessed(writeBuf_, 2 * quantum);
+}
+
+TEST_F(DefaultFlowControl, ReceiverPacedUpdates) {
+  InSequence enforceSequence;
+  EXPECT_CALL(callback_, onBody(_, _, _)).WillRepeatedly(Return());
+  filter_->setUpdateStrategy(
+      FlowControlFilter::UpdateStrategy::RECEIVER_PACED, 1000);
+
+  // each processing step releases at most the paced limit
+  callbackStart_->onBody(1, makeBuf(5000), 0);
+  EXPECT_CALL(*codec_, generateWindowUpdate(_, 0, 1000));
+  filter_->ingressBytesProcessed(writeBuf_, 5000);
+  // backlog drains one paced ack per call
+  EXPECT_CALL(*codec_, generateWindowUpdate(_, 0, 1000));
+  filter_->ingressBytesProcessed(writeBuf_, 0);
+}
+
 TEST_F(BigWindow, RecvTooMuch) {
   // Constructing the filter with a large capacity causes a WINDOW_UPDATE
   // for stream zero to be generated
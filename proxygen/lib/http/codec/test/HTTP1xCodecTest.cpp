@@ -230,6 +230,112 @@ TEST(HTTP1xCodecTest, TestGetRequestChunkedResponse) {
   ASSERT_EQ("0\r\n\r\n", bodyFromBuf->moveToFbString());
 }
 
+TEST(HTTP1xCodecTest, TestReset) {
+  HTTP1xCodec codec(TransportDirection::DOWNSTREAM);
+  EXPECT_TRUE(codec.isRecyclable());
+
+  // run a full request/response, then reset and do it again; the codec
+  // must behave exactly like a freshly constructed one
+  for (int i = 0; i < 2; i++) {
+    HTTP1xCodecCallback callbacks;
+    codec.setCallback(&callbacks);
+    auto reqBuf = folly::IOBuf::copyBuffer(
+        "GET /foo HTTP/1.1\nHost: www.facebook.com\nConnection: close\n\n");
+    codec.onIngress(*reqBuf);
+    EXPECT_EQ(callbacks.headersComplete, 1);
+    EXPECT_EQ(callbacks.errors, 0);
+
+    HTTPMessage resp;
+    resp.setHTTPVersion(1, 1);
+    resp.setStatusCode(200);
+    resp.getHeaders().set(HTTP_HEADER_CONTENT_LENGTH, "0");
+    folly::IOBufQueue respBuf(folly::IOBufQueue::cacheChainLength());
+    codec.generateHeader(respBuf, 1, resp, true);
+    EXPECT_FALSE(codec.isReusable());
+
+    codec.reset();
+    EXPECT_TRUE(codec.isReusable());
+  }
+}
+
+TEST(HTTP1xCodecTest, TestCachedHeaderTemplate) {
+  HTTP1xCodec codec(TransportDirection::DOWNSTREAM);
+  HTTP1xCodecCallback callbacks;
+  codec.setCallback(&callbacks);
+
+  HTTPMessage resp;
+  resp.setHTTPVersion(1, 1);
+  resp.setStatusCode(200);
+  resp.setStatusMessage("OK");
+  resp.getHeaders().set(HTTP_HEADER_CONTENT_TYPE, "text/html");
+  resp.getHeaders().set(HTTP_HEADER_SERVER, "proxygen");
+  auto tmpl = codec.createHeaderTemplate(resp);
+  ASSERT_NE(tmpl, nullptr);
+
+  // Serve two pipelined requests off the same template
+  for (uint32_t i = 1; i <= 2; i++) {
+    auto reqBuf = folly::IOBuf::copyBuffer(
+        "GET / HTTP/1.1\nHost: www.facebook.com\n\n");
+    codec.onIngress(*reqBuf);
+    EXPECT_EQ(callbacks.headersComplete, i);
+    HTTPCodec::StreamID txnID = i;
+
+    folly::IOBufQueue respBuf(folly::IOBufQueue::cacheChainLength());
+    HTTPHeaderSize size;
+    codec.generateCachedHeader(respBuf, txnID, *tmpl, 5, false, &size);
+    EXPECT_EQ(size.uncompressed, respBuf.chainLength());
+
+    // the generated bytes parse back to the original message plus the
+    // patched variable fields
+    HTTP1xCodec upstream(TransportDirection::UPSTREAM);
+    HTTP1xCodecCallback upstreamCallbacks;
+    upstream.setCallback(&upstreamCallbacks);
+    HTTPMessage req;
+    req.setHTTPVersion(1, 1);
+    req.setMethod(HTTPMethod::GET);
+    req.setURL("/");
+    folly::IOBufQueue reqQueue(folly::IOBufQueue::cacheChainLength());
+    upstream.generateHeader(reqQueue, upstream.createStream(), req, true);
+    auto headerBuf = respBuf.move();
+    upstream.onIngress(*headerBuf);
+    EXPECT_EQ(upstreamCallbacks.headersComplete, 1);
+    EXPECT_EQ(upstreamCallbacks.errors, 0);
+    auto& msg = *upstreamCallbacks.msg_;
+    EXPECT_EQ(msg.getStatusCode(), 200);
+    const auto& headers = msg.getHeaders();
+    EXPECT_EQ(headers.getSingleOrEmpty(HTTP_HEADER_CONTENT_TYPE),
+              "text/html");
+    EXPECT_EQ(headers.getSingleOrEmpty(HTTP_HEADER_SERVER), "proxygen");
+    EXPECT_EQ(headers.getSingleOrEmpty(HTTP_HEADER_CONTENT_LENGTH), "5");
+    EXPECT_EQ(headers.getSingleOrEmpty(HTTP_HEADER_CONNECTION),
+              "keep-alive");
+    EXPECT_FALSE(headers.getSingleOrEmpty(HTTP_HEADER_DATE).empty());
+  }
+}
+
+TEST(HTTP1xCodecTest, TestCachedHeaderTemplateRejects) {
+  HTTP1xCodec codec(TransportDirection::DOWNSTREAM);
+
+  HTTPMessage chunked;
+  chunked.setHTTPVersion(1, 1);
+  chunked.setStatusCode(200);
+  chunked.setIsChunked(true);
+  chunked.getHeaders().set(HTTP_HEADER_TRANSFER_ENCODING, "chunked");
+  EXPECT_EQ(codec.createHeaderTemplate(chunked), nullptr);
+
+  HTTPMessage withLength;
+  withLength.setHTTPVersion(1, 1);
+  withLength.setStatusCode(200);
+  withLength.getHeaders().set(HTTP_HEADER_CONTENT_LENGTH, "10");
+  EXPECT_EQ(codec.createHeaderTemplate(withLength), nullptr);
+
+  HTTP1xCodec upstream(TransportDirection::UPSTREAM);
+  HTTPMessage plain;
+  plain.setHTTPVersion(1, 1);
+  plain.setStatusCode(200);
+  EXPECT_EQ(upstream.createHeaderTemplate(plain), nullptr);
+}
+
 unique_ptr<folly::IOBuf> getChunkedRequest1st() {
   string req("GET /aha HTTP/1.1\n");
   return folly::IOBuf::copyBuffer(req);
@@ -297,6 +403,57 @@ TEST(HTTP1xCodecTest, TestChunkedUpstream) {
   ASSERT_EQ("5\r\nWorld\r\n0\r\n\r\n", eomFromBuf->moveToFbString());
 }
 
+TEST(HTTP1xCodecTest, TestChunkHeaderFastPath) {
+  HTTP1xCodec codec(TransportDirection::UPSTREAM);
+  auto txnID = codec.createStream();
+
+  HTTPMessage msg;
+  msg.setHTTPVersion(1, 1);
+  msg.setURL("https://www.facebook.com/");
+  msg.getHeaders().set(HTTP_HEADER_HOST, "www.facebook.com");
+  msg.getHeaders().set(HTTP_HEADER_TRANSFER_ENCODING, "chunked");
+  msg.setIsChunked(true);
+
+  folly::IOBufQueue buf(folly::IOBufQueue::cacheChainLength());
+  codec.generateHeader(buf, txnID, msg, false, nullptr);
+  buf.move();
+
+  // power-of-two size hits the precomputed table
+  auto body = folly::IOBuf::create(4096);
+  memset(body->writableTail(), 'a', 4096);
+  body->append(4096);
+  codec.generateBody(buf, txnID, std::move(body), HTTPCodec::NoPadding,
+                     false);
+  auto out = buf.move()->moveToFbString();
+  EXPECT_EQ(out.substr(0, 6), "1000\r\n");
+  EXPECT_EQ(out.substr(out.size() - 2), "\r\n");
+  EXPECT_EQ(out.size(), 4096 + 6 + 2);
+
+  // odd size takes the branch-free encoder; the body buffer has
+  // headroom and tailroom, so the whole chunk is fused in place
+  body = folly::IOBuf::create(64);
+  body->advance(16);
+  memset(body->writableTail(), 'b', 42);
+  body->append(42);
+  codec.generateBody(buf, txnID, std::move(body), HTTPCodec::NoPadding,
+                     false);
+  auto chunk = buf.move();
+  EXPECT_FALSE(chunk->isChained());
+  EXPECT_EQ(chunk->moveToFbString(), "2a\r\n" + string(42, 'b') + "\r\n");
+
+  // a shared buffer must not be scribbled on: framing goes around it
+  auto owner = folly::IOBuf::create(64);
+  owner->advance(16);
+  memset(owner->writableTail(), 'c', 17);
+  owner->append(17);
+  auto shared = owner->clone();
+  codec.generateBody(buf, txnID, std::move(shared), HTTPCodec::NoPadding,
+                     false);
+  EXPECT_EQ(buf.move()->moveToFbString(),
+            "11\r\n" + string(17, 'c') + "\r\n");
+  EXPECT_EQ(owner->moveToFbString(), string(17, 'c'));
+}
+
 TEST(HTTP1xCodecTest, TestBadPost100) {
   HTTP1xCodec codec(TransportDirection::DOWNSTREAM);
   MockHTTPCodecCallback callbacks;
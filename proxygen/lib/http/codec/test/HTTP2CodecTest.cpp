@@ -726,6 +726,89 @@ TEST_F(HTTP2CodecTest, BasicContinuationEndStream) {
   EXPECT_EQ(callbacks_.sessionErrors, 0);
 }
 
+TEST_F(HTTP2CodecTest, ControlFrameCoalescing) {
+  // deferred window updates merge per stream; acks flush at the end
+  upstreamCodec_.setControlFrameCoalescing(true);
+  auto outputAtStart = output_.chainLength();
+  // deferred calls report nominal sizes but write nothing yet
+  EXPECT_GT(upstreamCodec_.generateWindowUpdate(output_, 1, 100), 0);
+  EXPECT_GT(upstreamCodec_.generateWindowUpdate(output_, 1, 200), 0);
+  EXPECT_GT(upstreamCodec_.generateWindowUpdate(output_, 3, 50), 0);
+  EXPECT_GT(upstreamCodec_.generateSettingsAck(output_), 0);
+  EXPECT_EQ(output_.chainLength(), outputAtStart);
+  auto bytes = upstreamCodec_.generateDeferredFrames(output_);
+  EXPECT_GT(bytes, 0);
+
+  parse();
+  EXPECT_EQ(callbacks_.windowUpdateCalls, 2);
+  EXPECT_EQ(callbacks_.windowUpdates[1],
+            std::vector<uint32_t>({300}));
+  EXPECT_EQ(callbacks_.windowUpdates[3],
+            std::vector<uint32_t>({50}));
+  EXPECT_EQ(callbacks_.settingsAcks, 1);
+  EXPECT_EQ(callbacks_.sessionErrors, 0);
+
+  // nothing left pending
+  EXPECT_EQ(upstreamCodec_.generateDeferredFrames(output_), 0);
+}
+
+TEST_F(HTTP2CodecTest, SharedHeaderBlockFanout) {
+  // encode once, replay on several streams; each stream decodes the
+  // same message and connection compression state is never touched
+  HTTPMessage req = getGetRequest("/fanout");
+  req.getHeaders().add(HTTP_HEADER_USER_AGENT, "coolio");
+  HTTPHeaderSize size;
+  auto block = upstreamCodec_.encodeSharedHeaderBlock(req, &size);
+  ASSERT_NE(block, nullptr);
+  EXPECT_GT(size.compressed, 0);
+
+  for (auto stream : {1, 3, 5}) {
+    upstreamCodec_.generateSharedHeader(output_, stream, *block);
+  }
+  parse();
+  EXPECT_EQ(callbacks_.messageBegin, 3);
+  EXPECT_EQ(callbacks_.headersComplete, 3);
+  EXPECT_EQ(callbacks_.streamErrors, 0);
+  EXPECT_EQ(callbacks_.sessionErrors, 0);
+  EXPECT_EQ(callbacks_.msg->getPathAsStringPiece(), "/fanout");
+  EXPECT_EQ(callbacks_.msg->getHeaders().getSingleOrEmpty(
+                HTTP_HEADER_USER_AGENT),
+            "coolio");
+}
+
+TEST_F(HTTP2CodecTest, StreamingDecodeContinuation) {
+  // decode-as-you-go across CONTINUATION frames: same observable results
+  // as the buffered path, without assembling the block
+  downstreamCodec_.setStreamingHeaderDecode(true);
+  HTTPMessage req = getBigGetRequest();
+  upstreamCodec_.generateHeader(output_, 1, req);
+
+  parse();
+  callbacks_.expectMessage(false, -1, "/");
+#ifndef NDEBUG
+  EXPECT_GT(downstreamCodec_.getReceivedFrameCount(), 1);
+#endif
+  const auto& headers = callbacks_.msg->getHeaders();
+  EXPECT_EQ("coolio", headers.getSingleOrEmpty(HTTP_HEADER_USER_AGENT));
+  EXPECT_EQ(callbacks_.messageBegin, 1);
+  EXPECT_EQ(callbacks_.headersComplete, 1);
+  EXPECT_EQ(callbacks_.messageComplete, 0);
+  EXPECT_EQ(callbacks_.streamErrors, 0);
+  EXPECT_EQ(callbacks_.sessionErrors, 0);
+}
+
+TEST_F(HTTP2CodecTest, StreamingDecodeSingleFrame) {
+  downstreamCodec_.setStreamingHeaderDecode(true);
+  HTTPMessage req = getGetRequest("/guacamole");
+  req.getHeaders().add(HTTP_HEADER_USER_AGENT, "coolio");
+  upstreamCodec_.generateHeader(output_, 1, req, true /* eom */);
+
+  parse();
+  callbacks_.expectMessage(true, 2, "/guacamole");
+  EXPECT_EQ(callbacks_.streamErrors, 0);
+  EXPECT_EQ(callbacks_.sessionErrors, 0);
+}
+
 TEST_F(HTTP2CodecTest, BadContinuation) {
   // CONTINUATION with no preceding HEADERS
   auto fakeHeaders = makeBuf(5);
@@ -1011,6 +1094,26 @@ TEST_F(HTTP2CodecTest, BasicRstInvalidCode) {
   EXPECT_EQ(callbacks_.sessionErrors, 0);
 }
 
+TEST_F(HTTP2CodecTest, Metadata) {
+  auto payload = folly::IOBuf::copyBuffer("trace-id=abc123;span=7");
+  upstreamCodec_.generateMetadata(output_, 1, payload->clone());
+
+  parse();
+  EXPECT_EQ(callbacks_.metadataStream, 1);
+  auto received = callbacks_.metadata.move();
+  ASSERT_NE(received, nullptr);
+  folly::IOBufEqualTo eq;
+  EXPECT_TRUE(eq(payload, received));
+
+  // pass-through: re-emitting the received payload is byte-identical
+  // and touches no compression state
+  folly::IOBufQueue forwarded{folly::IOBufQueue::cacheChainLength()};
+  downstreamCodec_.generateMetadata(forwarded, 1, received->clone());
+  folly::IOBufQueue regenerated{folly::IOBufQueue::cacheChainLength()};
+  upstreamCodec_.generateMetadata(regenerated, 1, payload->clone());
+  EXPECT_TRUE(eq(forwarded.front()->clone(), regenerated.front()->clone()));
+}
+
 TEST_F(HTTP2CodecTest, BasicPing) {
   upstreamCodec_.generatePingRequest(output_);
   upstreamCodec_.generatePingReply(output_, 17);
@@ -1255,6 +1358,48 @@ TEST_F(HTTP2CodecTest, SettingsAck) {
   EXPECT_EQ(callbacks_.sessionErrors, 0);
 }
 
+TEST_F(HTTP2CodecTest, SettingsResumption) {
+  auto clientCache = std::make_shared<SettingsResumptionCache>();
+  auto serverCache = std::make_shared<SettingsResumptionCache>();
+  upstreamCodec_.enableSettingsResumption(clientCache, "server");
+  downstreamCodec_.enableSettingsResumption(serverCache, "client");
+
+  // first connection: full settings, plus the fingerprint
+  auto fullSize = upstreamCodec_.generateSettings(output_);
+  parse();
+  EXPECT_EQ(callbacks_.settings, 1);
+  EXPECT_EQ(callbacks_.sessionErrors, 0);
+  const auto numSettings = callbacks_.numSettings;
+  const auto maxFrameSize =
+      downstreamCodec_.getIngressSettings()
+          ->getSetting(SettingsId::MAX_FRAME_SIZE)->value;
+
+  // the peer's ACK makes the sent set the resumption baseline
+  downstreamCodec_.generateSettingsAck(output_);
+  parseUpstream();
+
+  // "reconnect": the unchanged set goes out as fingerprint-only
+  callbacks_.reset();
+  auto resumedSize = upstreamCodec_.generateSettings(output_);
+  EXPECT_LT(resumedSize, fullSize);
+  parse();
+  EXPECT_EQ(callbacks_.settings, 1);
+  EXPECT_EQ(callbacks_.sessionErrors, 0);
+  // the receiver restored the elided settings from its cache
+  EXPECT_EQ(callbacks_.numSettings, numSettings);
+  EXPECT_EQ(downstreamCodec_.getIngressSettings()
+                ->getSetting(SettingsId::MAX_FRAME_SIZE)->value,
+            maxFrameSize);
+
+  // a receiver that lost its cache fails the fingerprint loudly
+  // instead of running a silently diverged config
+  serverCache->invalidate("client");
+  callbacks_.reset();
+  upstreamCodec_.generateSettings(output_);
+  parse();
+  EXPECT_EQ(callbacks_.sessionErrors, 1);
+}
+
 TEST_F(HTTP2CodecTest, BadSettings) {
   auto settings = upstreamCodec_.getEgressSettings();
   settings->setSetting(SettingsId::INITIAL_WINDOW_SIZE, 0xffffffff);
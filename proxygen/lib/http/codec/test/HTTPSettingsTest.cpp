@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/codec/HTTPSettings.h>
+
+using namespace proxygen;
+
+TEST(HTTPSettingsTest, SnapshotDefaults) {
+  HTTPSettings settings({});
+  const auto& snapshot = settings.snapshot();
+  EXPECT_EQ(snapshot.headerTableSize, 4096);
+  EXPECT_EQ(snapshot.enablePush, 1);
+  EXPECT_EQ(snapshot.maxFrameSize, 16384);
+  EXPECT_EQ(snapshot.initialWindowSize, 65535);
+  EXPECT_EQ(snapshot.maxHeaderListSize, 0);
+  EXPECT_EQ(snapshot.enableExHeaders, 0);
+}
+
+TEST(HTTPSettingsTest, SnapshotTracksMutations) {
+  HTTPSettings settings;
+  EXPECT_EQ(settings.snapshot().maxFrameSize, 16384);
+  settings.setSetting(SettingsId::MAX_FRAME_SIZE, 65536);
+  EXPECT_EQ(settings.snapshot().maxFrameSize, 65536);
+  settings.setSetting(SettingsId::ENABLE_EX_HEADERS, 1);
+  EXPECT_EQ(settings.snapshot().enableExHeaders, 1);
+  settings.unsetSetting(SettingsId::MAX_FRAME_SIZE);
+  EXPECT_EQ(settings.snapshot().maxFrameSize, 16384);
+  settings.clearSettings();
+  EXPECT_EQ(settings.snapshot().enableExHeaders, 0);
+}
+
+TEST(HTTPSettingsTest, SnapshotInterned) {
+  HTTPSettings a;
+  HTTPSettings b;
+  a.setSetting(SettingsId::MAX_FRAME_SIZE, 32768);
+  b.setSetting(SettingsId::MAX_FRAME_SIZE, 32768);
+  // identical configurations share one interned snapshot
+  EXPECT_EQ(a.sharedSnapshot().get(), b.sharedSnapshot().get());
+  b.setSetting(SettingsId::ENABLE_PUSH, 0);
+  EXPECT_NE(a.sharedSnapshot().get(), b.sharedSnapshot().get());
+}
@@ -190,6 +190,13 @@ class FakeHTTPCodecCallback : public HTTPCodec::Callback {
     data_.append(std::move(debugData));
   }
 
+  void onMetadata(HTTPCodec::StreamID stream,
+                  std::unique_ptr<folly::IOBuf> metadata) override {
+    metadataStream = stream;
+    if (metadata) {
+      this->metadata.append(std::move(metadata));
+    }
+  }
   void onPingRequest(uint64_t data) override {
     recvPingRequest = data;
   }
@@ -391,6 +398,9 @@ class FakeHTTPCodecCallback : public HTTPCodec::Callback {
   uint32_t sessionErrors{0};
   uint32_t streamErrors{0};
   uint64_t recvPingRequest{0};
+  HTTPCodec::StreamID metadataStream{0};
+  folly::IOBufQueue metadata{folly::IOBufQueue::cacheChainLength()};
+
   uint64_t recvPingReply{0};
   uint32_t windowUpdateCalls{0};
   uint32_t settings{0};
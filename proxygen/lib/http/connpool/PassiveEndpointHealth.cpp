@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/connpool/PassiveEndpointHealth.h>
+
+namespace proxygen {
+
+void PassiveEndpointHealth::recordResult(bool success,
+                                         std::chrono::microseconds latency) {
+  auto now = getCachedNow();
+  maybeCloseWindow(now);
+  windowSamples_++;
+  if (success) {
+    windowLatencies_.record(latency.count());
+  } else {
+    windowErrors_++;
+  }
+}
+
+bool PassiveEndpointHealth::isHealthy() {
+  auto now = getCachedNow();
+  maybeCloseWindow(now);
+  return !timePointInitialized(quarantineUntil_) || now >= quarantineUntil_;
+}
+
+void PassiveEndpointHealth::maybeCloseWindow(TimePoint now) {
+  if (now - windowStart_ < config_.windowDuration) {
+    return;
+  }
+  if (windowSamples_ >= config_.minSamplesPerWindow) {
+    const double successRate =
+        double(windowSamples_ - windowErrors_) / double(windowSamples_);
+    const double p99 = windowLatencies_.count() > 0
+                           ? double(windowLatencies_.estimatePercentile(99))
+                           : 0;
+    const bool latencyDegraded = baselineP99Us_ > 0 &&
+                                 p99 > baselineP99Us_ * config_.p99DegradeFactor;
+    if (successRate < config_.minSuccessRate || latencyDegraded) {
+      quarantineUntil_ = now + config_.quarantineDuration;
+    } else {
+      // healthy window: fold its p99 into the baseline
+      if (baselineP99Us_ == 0) {
+        baselineP99Us_ = p99;
+      } else {
+        baselineP99Us_ = baselineP99Us_ * (1 - config_.baselineDecay) +
+                         p99 * config_.baselineDecay;
+      }
+    }
+  }
+  windowLatencies_.clear();
+  windowSamples_ = 0;
+  windowErrors_ = 0;
+  windowStart_ = now;
+}
+
+} // namespace proxygen
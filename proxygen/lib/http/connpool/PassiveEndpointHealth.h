@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <proxygen/lib/utils/PercentileHistogram.h>
+#include <proxygen/lib/utils/Time.h>
+
+namespace proxygen {
+
+/**
+ * Passive health signal for one upstream endpoint, fed from the
+ * transaction completions the pool already observes - no probe
+ * traffic.  Results accumulate into a rolling window; when a window
+ * closes with enough samples, its p99 latency and success rate are
+ * judged against an EWMA baseline built from healthy windows.  A
+ * window whose p99 degrades past the configured factor, or whose
+ * success rate drops below the floor, quarantines the endpoint for a
+ * fixed duration so a brown origin sheds load in seconds instead of
+ * waiting for an external LB to notice.
+ *
+ * Single-threaded, like the pool that owns it.
+ */
+class PassiveEndpointHealth {
+ public:
+  struct Config {
+    // rolling window length and the samples required to judge one
+    std::chrono::milliseconds windowDuration{std::chrono::seconds(10)};
+    uint32_t minSamplesPerWindow{20};
+    // quarantine when window p99 exceeds baseline by this factor...
+    double p99DegradeFactor{3.0};
+    // ...or the window success rate falls below this floor
+    double minSuccessRate{0.5};
+    std::chrono::milliseconds quarantineDuration{std::chrono::seconds(30)};
+    // EWMA weight of a new healthy window in the baseline
+    double baselineDecay{0.3};
+  };
+
+  explicit PassiveEndpointHealth(Config config = Config()) : config_(config) {
+    windowStart_ = getCachedNow();
+  }
+
+  void recordResult(bool success, std::chrono::microseconds latency);
+
+  /**
+   * False while quarantined.  Advances the window lazily.
+   */
+  bool isHealthy();
+
+  /**
+   * EWMA of healthy-window p99 latencies, in microseconds; 0 until the
+   * first judged window.  Callers choosing among endpoints can prefer
+   * the lowest.
+   */
+  double getBaselineP99Us() const {
+    return baselineP99Us_;
+  }
+
+ private:
+  void maybeCloseWindow(TimePoint now);
+
+  Config config_;
+  PercentileHistogram windowLatencies_;
+  uint64_t windowSamples_{0};
+  uint64_t windowErrors_{0};
+  TimePoint windowStart_;
+  double baselineP99Us_{0};
+  TimePoint quarantineUntil_{};
+};
+
+} // namespace proxygen
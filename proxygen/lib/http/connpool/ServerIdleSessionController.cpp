@@ -11,6 +11,17 @@
 namespace proxygen {
 
 folly::Future<HTTPSessionBase*> ServerIdleSessionController::getIdleSession() {
+  // Fast path: claim an already-detached parked session without any
+  // cross-thread hop.
+  HTTPSessionBase* parked = nullptr;
+  if (detachedSessions_.read(parked)) {
+    if (!isMarkedForDeath()) {
+      return folly::makeFuture<HTTPSessionBase*>(parked);
+    }
+    parked->drain();
+    return folly::makeFuture<HTTPSessionBase*>(nullptr);
+  }
+
   folly::Promise<HTTPSessionBase*> promise;
   folly::Future<HTTPSessionBase*> future = promise.getFuture();
   SessionPool* maxPool = nullptr;
@@ -36,6 +47,27 @@ folly::Future<HTTPSessionBase*> ServerIdleSessionController::getIdleSession() {
             isMarkedForDeath() ? nullptr : maxPool->removeOldestIdleSession();
         if (session) {
           session->detachThreadLocals(true);
+          // While we're here, pre-detach extras into the lock-free lane so
+          // the next steals (e.g. during a connect storm) skip the hop.
+          uint32_t extras = stealBatchSize_.load(std::memory_order_relaxed);
+          for (uint32_t i = 0; i < extras && !detachedSessions_.isFull();
+               i++) {
+            auto extra = maxPool->removeOldestIdleSession();
+            if (!extra) {
+              break;
+            }
+            extra->detachThreadLocals(true);
+            if (!detachedSessions_.write(extra)) {
+              // raced with other steals filling the lane; close it out
+              extra->drain();
+              break;
+            }
+          }
+          if (isMarkedForDeath()) {
+            // markForDeath may have drained the lane while we were
+            // parking; make sure nothing we parked outlives it
+            drainDetachedSessions();
+          }
         }
         promise.setValue(session);
       });
@@ -68,10 +100,22 @@ void ServerIdleSessionController::removeIdleSession(
 }
 
 void ServerIdleSessionController::markForDeath() {
-  std::lock_guard<std::mutex> lock(lock_);
-  markedForDeath_ = true;
-  sessionMap_.clear();
-  sessionsByIdleAge_.clear();
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    markedForDeath_ = true;
+    sessionMap_.clear();
+    sessionsByIdleAge_.clear();
+  }
+  drainDetachedSessions();
+}
+
+// Parked sessions belong to no pool; drain them so they don't leak.
+// They are detached, so draining from any thread is safe.
+void ServerIdleSessionController::drainDetachedSessions() {
+  HTTPSessionBase* parked = nullptr;
+  while (detachedSessions_.read(parked)) {
+    parked->drain();
+  }
 }
 
 // must be called under lock_
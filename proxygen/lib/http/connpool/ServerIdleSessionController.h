@@ -10,6 +10,7 @@
 
 #include "proxygen/lib/http/connpool/SessionPool.h"
 
+#include <folly/MPMCQueue.h>
 #include <folly/futures/Future.h>
 
 namespace proxygen {
@@ -26,6 +27,10 @@ class ServerIdleSessionController {
   explicit ServerIdleSessionController() {
   }
 
+  ~ServerIdleSessionController() {
+    drainDetachedSessions();
+  }
+
   /**
    * Transfer idle session from another thread, if available.
    * Returns nullptr if nothing is available.
@@ -51,6 +56,17 @@ class ServerIdleSessionController {
     maxIdleCount_ = maxIdleCount;
   }
 
+  /**
+   * When a steal takes the cross-thread hop, pre-detach up to this many
+   * extra idle sessions from the same pool and park them in a lock-free
+   * queue; subsequent getIdleSession() calls from any thread then claim a
+   * parked session in O(1) without the hop. 0 (the default) disables
+   * parking.
+   */
+  void setStealBatchSize(uint32_t extraSessions) {
+    stealBatchSize_.store(extraSessions, std::memory_order_relaxed);
+  }
+
  protected:
   struct IdleSessionInfo {
     const HTTPSessionBase* session;
@@ -66,6 +82,8 @@ class ServerIdleSessionController {
    */
   SessionPool* FOLLY_NULLABLE popBestIdlePool();
 
+  void drainDetachedSessions();
+
   bool isMarkedForDeath() {
     std::lock_guard<std::mutex> lock(lock_);
     return markedForDeath_;
@@ -87,6 +105,18 @@ class ServerIdleSessionController {
 
   // Default idle pool size to 2.
   unsigned int maxIdleCount_{2};
+
+  // Upper bound on sessions parked in the lock-free lane.
+  static constexpr size_t kMaxDetachedSessions = 64;
+
+  /*
+   * Idle sessions that have already been detached from their owning thread
+   * and can be claimed by any thread without a cross-thread hop. Sessions
+   * in here belong to no pool; the claimer (or markForDeath) takes over.
+   */
+  folly::MPMCQueue<HTTPSessionBase*> detachedSessions_{kMaxDetachedSessions};
+
+  std::atomic<uint32_t> stealBatchSize_{0};
 };
 
 } // namespace proxygen
@@ -8,6 +8,8 @@
 
 #include "proxygen/lib/http/connpool/SessionHolder.h"
 
+#include <proxygen/lib/utils/Time.h>
+
 #include <folly/Random.h>
 #include <folly/io/async/AsyncSocket.h>
 #include <glog/logging.h>
@@ -35,6 +37,9 @@ SessionHolder::SessionHolder(HTTPSessionBase* sess,
 }
 
 SessionHolder::~SessionHolder() {
+  if (parent_) {
+    parent_->holderDestroyed(this);
+  }
   CHECK(state_ == ListState::DETACHED);
   CHECK(!listHook.is_linked());
   CHECK(!secondaryListHook.is_linked());
@@ -158,6 +163,13 @@ void SessionHolder::onCreate(const HTTPSessionBase&) {
 
 void SessionHolder::onIngressError(const HTTPSessionBase& session,
                                    ProxygenError error) {
+  if (stats_ && timePointInitialized(requestBeginTime_)) {
+    stats_->onRequestResult(
+        false,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - requestBeginTime_));
+    requestBeginTime_ = {};
+  }
   if (originalSessionInfoCb_) {
     originalSessionInfoCb_->onIngressError(session, error);
   }
@@ -183,6 +195,7 @@ void SessionHolder::onWrite(const HTTPSessionBase& session,
 }
 
 void SessionHolder::onRequestBegin(const HTTPSessionBase& session) {
+  requestBeginTime_ = std::chrono::steady_clock::now();
   if (originalSessionInfoCb_) {
     originalSessionInfoCb_->onRequestBegin(session);
   }
@@ -190,6 +203,13 @@ void SessionHolder::onRequestBegin(const HTTPSessionBase& session) {
 
 void SessionHolder::onRequestEnd(const HTTPSessionBase& session,
                                  uint32_t maxIngressQueueSize) {
+  if (stats_ && timePointInitialized(requestBeginTime_)) {
+    stats_->onRequestResult(
+        true,
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - requestBeginTime_));
+    requestBeginTime_ = {};
+  }
   if (originalSessionInfoCb_) {
     originalSessionInfoCb_->onRequestEnd(session, maxIngressQueueSize);
   }
@@ -261,6 +281,7 @@ void SessionHolder::onPingReplySent(int64_t latency) {
 };
 
 void SessionHolder::onPingReplyReceived() {
+  probeOutstanding_ = false;
   if (originalSessionInfoCb_) {
     originalSessionInfoCb_->onPingReplyReceived();
   }
@@ -319,6 +340,21 @@ void SessionHolder::onSettingsAck(const HTTPSessionBase& sess) {
   }
 }
 
+void SessionHolder::onDrainStarted(const HTTPSessionBase& sess) {
+  VLOG(4) << "peer drain started on holder=" << *this;
+  if (originalSessionInfoCb_) {
+    originalSessionInfoCb_->onDrainStarted(sess);
+  }
+  // The peer will finish what's in flight but accepts nothing new:
+  // tell the pool (so it can dial a replacement and notify routers)
+  // while this holder is still inspectable, then retire from rotation.
+  // drain() hands the session to the parent's draining list and
+  // deletes this holder; the session survives under its own
+  // DestructorGuard for the duration of the GOAWAY callback.
+  parent_->sessionDraining(this);
+  drain();
+}
+
 void SessionHolder::describe(std::ostream& os) const {
   const AsyncSocket* sock =
       session_->getTransport()->getUnderlyingTransport<AsyncSocket>();
@@ -35,6 +35,14 @@ class SessionHolder : private HTTPSessionBase::InfoCallback {
     virtual void attachPartiallyFilled(SessionHolder*) = 0;
     virtual void attachFilled(SessionHolder*) = 0;
     virtual void addDrainingSession(HTTPSessionBase*) = 0;
+    // fired when the session's peer starts draining it (GOAWAY), just
+    // before the holder retires itself from rotation; default no-op
+    virtual void sessionDraining(SessionHolder*) {
+    }
+    // fired from the holder's destructor so owners can drop raw
+    // references (e.g. affinity cache entries); default no-op
+    virtual void holderDestroyed(SessionHolder*) {
+    }
   };
 
   class Stats {
@@ -47,6 +55,14 @@ class SessionHolder : private HTTPSessionBase::InfoCallback {
     virtual void onConnectionDeactivated() = 0;
     virtual void onRead(size_t bytesRead) = 0;
     virtual void onWrite(size_t bytesWritten) = 0;
+    /**
+     * Passive health signal: one completed (or errored) request with
+     * its observed latency.  Default no-op so existing implementations
+     * are unaffected.
+     */
+    virtual void onRequestResult(bool /*success*/,
+                                 std::chrono::microseconds /*latency*/) {
+    }
   };
 
   explicit SessionHolder(HTTPSessionBase*,
@@ -101,6 +117,34 @@ class SessionHolder : private HTTPSessionBase::InfoCallback {
   void link();
 
   bool shouldAgeOut(std::chrono::milliseconds maxAge) const;
+
+  /**
+   * Liveness probing state, driven by SessionPool's shared probe
+   * timer: sendProbe() issues a protocol ping; the reply (observed via
+   * this holder's InfoCallback) clears the outstanding flag.  A probe
+   * still outstanding past its deadline marks the session dead.
+   * Codecs without ping support (h1) write nothing and can never
+   * reply, so they are left unprobed instead of being marked dead.
+   */
+  void sendProbe() {
+    if (session_->sendPing() == 0) {
+      // no ping went out (h1 and friends); don't arm a deadline no
+      // reply can ever clear
+      probeOutstanding_ = false;
+      return;
+    }
+    probeOutstanding_ = true;
+    probeSentTime_ = std::chrono::steady_clock::now();
+  }
+
+  bool probeOutstanding() const {
+    return probeOutstanding_;
+  }
+
+  bool probeExpired(std::chrono::milliseconds deadline) const {
+    return probeOutstanding_ &&
+           std::chrono::steady_clock::now() - probeSentTime_ > deadline;
+  }
   void describe(std::ostream& os) const;
 
   Endpoint getEndpoint() {
@@ -138,6 +182,7 @@ class SessionHolder : private HTTPSessionBase::InfoCallback {
   void onEgressBufferCleared(const HTTPSessionBase&) override;
   void onSettings(const HTTPSessionBase&, const SettingsList&) override;
   void onSettingsAck(const HTTPSessionBase&) override;
+  void onDrainStarted(const HTTPSessionBase&) override;
 
   // Hook in the first session pool list.
   folly::SafeIntrusiveListHook listHook;
@@ -159,6 +204,13 @@ class SessionHolder : private HTTPSessionBase::InfoCallback {
   Callback* parent_;
   Stats* stats_;
   std::chrono::steady_clock::time_point lastUseTime_; // init'd in link()
+  // start of the most recent request, for passive latency scoring;
+  // h1 pools run one request at a time, and for multiplexed sessions
+  // this approximates per-request latency with last-begin-to-end
+  std::chrono::steady_clock::time_point requestBeginTime_{};
+  // liveness probe bookkeeping; see sendProbe
+  bool probeOutstanding_{false};
+  std::chrono::steady_clock::time_point probeSentTime_{};
   double jitter_;
   ListState state_{ListState::DETACHED};
   Endpoint endpoint_;
@@ -7,10 +7,13 @@
  */
 
 #include "proxygen/lib/http/connpool/SessionPool.h"
+
+#include <folly/hash/Hash.h>
 #include "proxygen/lib/http/connpool/ServerIdleSessionController.h"
 #include "proxygen/lib/http/connpool/ThreadIdleSessionController.h"
 
 #include <chrono>
+#include <folly/Random.h>
 #include <folly/io/async/EventBaseManager.h>
 
 namespace proxygen {
@@ -33,6 +36,10 @@ SessionPool::SessionPool(
 }
 
 SessionPool::~SessionPool() {
+  // draining the lists below funnels through addDrainingSession; a
+  // dying pool must not dial replacements for the sessions it retires
+  warmupConnector_ = nullptr;
+  minIdleSessions_ = 0;
   drainSessionList(idleSessionList_);
   drainSessionList(unfilledSessionList_);
   drainSessionList(fullSessionList_);
@@ -86,7 +93,8 @@ void SessionPool::putSession(HTTPSessionBase* session) {
   if (SessionHolder::isPoolable(session)) {
     // Constructing the session holder automatically puts it on the
     // correct list (one of [idle, unfilled, full])
-    auto holder = new SessionHolder(session, this, stats_);
+    auto holder = new SessionHolder(
+        session, this, healthStats_ ? healthStats_.get() : stats_);
     holder->link();
   } else {
     // this is equivalent to what happens in SessionHolder::link which is
@@ -96,18 +104,182 @@ void SessionPool::putSession(HTTPSessionBase* session) {
     session->drain();
   }
   purgeExcessIdleSessions();
+  if (pendingWarmupConnects_ > 0) {
+    // an arriving session satisfies one outstanding warmup connect
+    pendingWarmupConnects_--;
+  }
+  maybeReplenish();
+}
+
+void SessionPool::enablePassiveHealth(PassiveEndpointHealth::Config config) {
+  health_ = std::make_unique<PassiveEndpointHealth>(config);
+  healthStats_ = std::make_unique<HealthStats>(this);
+}
+
+HTTPTransaction* SessionPool::getTransactionWithAffinity(
+    HTTPTransaction::Handler* upstreamHandler, uint64_t affinityKey) {
+  if (!isHealthy()) {
+    return nullptr;
+  }
+  auto hit = affinityByKey_.find(affinityKey);
+  if (hit != affinityByKey_.end()) {
+    auto holder = hit->second;
+    auto txn = holder->newTransaction(upstreamHandler);
+    holder->unlink();
+    holder->link();
+    if (txn) {
+      return txn;
+    }
+    // saturated: spill without remapping so the key snaps back later
+    return getTransaction(upstreamHandler);
+  }
+  // miss: rendezvous over live sessions so the mapping is stable under
+  // membership churn - each key prefers the surviving session it
+  // scored highest
+  SessionHolder* best = nullptr;
+  uint64_t bestScore = 0;
+  auto score = [&](SessionHolder& holder) {
+    auto sessionScore = folly::hash::hash_128_to_64(
+        affinityKey, reinterpret_cast<uint64_t>(&holder));
+    if (!best || sessionScore > bestScore) {
+      best = &holder;
+      bestScore = sessionScore;
+    }
+  };
+  for (auto& holder : unfilledSessionList_) {
+    score(holder);
+  }
+  for (auto& holder : idleSessionList_) {
+    score(holder);
+  }
+  if (!best) {
+    return getTransaction(upstreamHandler);
+  }
+  auto txn = best->newTransaction(upstreamHandler);
+  // re-home the holder on the list matching its new occupancy, as
+  // attemptOpenTransaction does
+  best->unlink();
+  best->link();
+  if (!txn) {
+    return getTransaction(upstreamHandler);
+  }
+  affinityByKey_[affinityKey] = best;
+  affinityKeysByHolder_[best].push_back(affinityKey);
+  maybeReplenish();
+  return txn;
+}
+
+void SessionPool::holderDestroyed(SessionHolder* holder) {
+  auto it = affinityKeysByHolder_.find(holder);
+  if (it == affinityKeysByHolder_.end()) {
+    return;
+  }
+  for (auto key : it->second) {
+    auto keyIt = affinityByKey_.find(key);
+    if (keyIt != affinityByKey_.end() && keyIt->second == holder) {
+      affinityByKey_.erase(keyIt);
+    }
+  }
+  affinityKeysByHolder_.erase(it);
 }
 
 HTTPTransaction* SessionPool::getTransaction(
     HTTPTransaction::Handler* upstreamHandler) {
+  if (!isHealthy()) {
+    // quarantined endpoint: make the caller route around it
+    return nullptr;
+  }
   auto txn = attemptOpenTransaction(upstreamHandler, unfilledSessionList_);
   if (!txn) {
     purgeExcessIdleSessions();
     txn = attemptOpenTransaction(upstreamHandler, idleSessionList_);
   }
+  maybeReplenish();
   return txn;
 }
 
+void SessionPool::setWarmupTarget(uint32_t minIdleSessions,
+                                  folly::Function<void()> connector) {
+  minIdleSessions_ = minIdleSessions;
+  warmupConnector_ = std::move(connector);
+  maybeReplenish();
+}
+
+void SessionPool::warmupConnectFailed() {
+  if (pendingWarmupConnects_ > 0) {
+    pendingWarmupConnects_--;
+  }
+}
+
+void SessionPool::maybeReplenish() {
+  if (!warmupConnector_ || minIdleSessions_ == 0 || inReplenish_) {
+    return;
+  }
+  inReplenish_ = true;
+  while (idleSessionList_.size() + pendingWarmupConnects_ <
+         minIdleSessions_) {
+    pendingWarmupConnects_++;
+    warmupConnector_();
+  }
+  inReplenish_ = false;
+}
+
+void SessionPool::enableLivenessProbing(LivenessOptions options) {
+  liveness_ = options;
+  probeInterval_ = options.baseProbeInterval;
+  lastProbeRound_ = std::chrono::steady_clock::now();
+}
+
+void SessionPool::probeIdleSessions() {
+  auto now = std::chrono::steady_clock::now();
+  if (now - lastProbeRound_ < probeInterval_) {
+    return;
+  }
+  lastProbeRound_ = now;
+  bool evicted = false;
+  auto it = idleSessionList_.begin();
+  while (it != idleSessionList_.end()) {
+    SessionHolder* holder = &*it;
+    ++it; // eviction unlinks the holder; advance first
+    if (holder->probeExpired(liveness_->probeDeadline)) {
+      VLOG(3) << "Evicting dead pooled session " << *holder;
+      evicted = true;
+      holder->closeWithReset();
+    } else if (!holder->probeOutstanding()) {
+      holder->sendProbe();
+    }
+  }
+  if (evicted) {
+    // instability: probe aggressively until the pool looks healthy
+    probeInterval_ = liveness_->baseProbeInterval;
+  } else {
+    probeInterval_ =
+        std::min(probeInterval_ * 2, liveness_->maxProbeInterval);
+  }
+}
+
+void SessionPool::performMaintenance() {
+  if (liveness_) {
+    probeIdleSessions();
+  }
+  if (warmupConnector_ && timeout_.count() > 0) {
+    // retire idle sessions approaching the idle timeout before the
+    // server does it for us; jitter the threshold so refreshes across
+    // workers don't synchronize into a reconnect herd
+    const auto jitteredPct = 70 + folly::Random::rand32(20);
+    const auto threshold = std::chrono::steady_clock::now() -
+        timeout_ * jitteredPct / 100;
+    while (!idleSessionList_.empty()) {
+      SessionHolder* holder = &idleSessionList_.front();
+      if (holder->getLastUseTime() > threshold) {
+        break;
+      }
+      holder->drain();
+    }
+  }
+  maybeReplenish();
+}
+
 void SessionPool::purgeExcessIdleSessions() {
   auto thresh = std::chrono::steady_clock::now() - getTimeout();
 
@@ -232,6 +404,15 @@ void SessionPool::attachFilled(SessionHolder* sess) {
 }
 
 void SessionPool::addDrainingSession(HTTPSessionBase* /*session*/) {
+  // a session just left rotation; if warming is configured, dial its
+  // replacement now instead of waiting for the maintenance timer
+  maybeReplenish();
+}
+
+void SessionPool::sessionDraining(SessionHolder* holder) {
+  if (drainCallback_) {
+    drainCallback_(holder->getSession());
+  }
 }
 
 std::ostream& operator<<(std::ostream& os, const SessionPool& pool) {
@@ -8,8 +8,11 @@
 
 #pragma once
 
+#include <folly/Function.h>
+#include <unordered_map>
 #include <folly/io/async/EventBase.h>
 
+#include "proxygen/lib/http/connpool/PassiveEndpointHealth.h"
 #include "proxygen/lib/http/connpool/SessionHolder.h"
 
 namespace proxygen {
@@ -70,6 +73,26 @@ class SessionPool : private SessionHolder::Callback {
    */
   ~SessionPool() override;
 
+  /**
+   * Passive endpoint health: score this pool's endpoint from the
+   * request completions it already observes and quarantine it when a
+   * window's p99 degrades or its success rate collapses (see
+   * PassiveEndpointHealth).  While quarantined, getTransaction()
+   * returns nullptr so the caller routes around the endpoint; callers
+   * choosing among pools can also rank by getHealthBaselineP99Us() to
+   * prefer the fastest healthy endpoint.
+   */
+  void enablePassiveHealth(
+      PassiveEndpointHealth::Config config = PassiveEndpointHealth::Config());
+
+  bool isHealthy() {
+    return !health_ || health_->isHealthy();
+  }
+
+  double getHealthBaselineP99Us() const {
+    return health_ ? health_->getBaselineP99Us() : 0;
+  }
+
   /**
    * Set/get the maximum number of idle sessions that can be
    * pooled. Lowering the maximum number of sessions purges excess idle
@@ -85,6 +108,77 @@ class SessionPool : private SessionHolder::Callback {
   void setTimeout(std::chrono::milliseconds);
   std::chrono::milliseconds getTimeout() const;
 
+  /**
+   * Enable warm-pool maintenance: the pool tries to keep at least
+   * minIdleSessions idle sessions available, invoking the connector
+   * callback once per missing session. The callback must (possibly
+   * asynchronously) either putSession() a fresh session into this pool
+   * or call warmupConnectFailed(). Pass minIdleSessions = 0 to disable.
+   */
+  void setWarmupTarget(uint32_t minIdleSessions,
+                       folly::Function<void()> connector);
+
+  /**
+   * Tell the pool a warmup connect attempt failed, so it can account
+   * for it; replenishment retries on the next maintenance pass.
+   */
+  void warmupConnectFailed();
+
+  /**
+   * Invoked when a pooled session's peer starts draining it (GOAWAY):
+   * the session finishes in-flight work but takes nothing new, and
+   * has already been retired from rotation.  Routers hook this to
+   * shift traffic to other endpoints ahead of the restart instead of
+   * discovering it through errored requests.
+   */
+  void setDrainCallback(folly::Function<void(const HTTPSessionBase&)> cb) {
+    drainCallback_ = std::move(cb);
+  }
+
+  /**
+   * Drive warming from a periodic timer (e.g. once per second):
+   * proactively retires idle sessions that are close to the pool's
+   * idle timeout - with jitter, so refreshes across workers don't
+   * synchronize - and replenishes toward the warmup target.
+   */
+  void performMaintenance();
+
+  /**
+   * Probe idle sessions for liveness from the same maintenance pass -
+   * no timer per session, the caller's one per-worker maintenance
+   * timer drives every pool.  Each round sends a protocol ping (h2
+   * PING; HQ sessions map sendPing to a QUIC keepalive) on idle
+   * sessions and evicts any whose previous probe went unanswered past
+   * the deadline, so a dead upstream is discovered before a request
+   * lands on it.  The round interval adapts to observed stability:
+   * it doubles after quiet rounds up to the max and snaps back to the
+   * base when an eviction happens.
+   */
+  struct LivenessOptions {
+    LivenessOptions() = default;
+    std::chrono::milliseconds baseProbeInterval{15000};
+    std::chrono::milliseconds maxProbeInterval{120000};
+    // an unanswered probe older than this marks the session dead
+    std::chrono::milliseconds probeDeadline{3000};
+  };
+
+  void enableLivenessProbing(LivenessOptions options = LivenessOptions());
+
+  /**
+   * Affinity-preserving acquisition for stateful upstreams: the same
+   * key routes to the same pooled session while it lives.  Hits are
+   * O(1) through the key cache; a miss runs rendezvous scoring over
+   * the pool's live sessions (so every worker maps a key the same way
+   * relative to its own sessions) and caches the choice.  A saturated
+   * affinity session spills this request to the regular acquisition
+   * path WITHOUT remapping, so the key snaps back once its session has
+   * capacity.  Session death drops its cache entries; the next request
+   * for the key re-scores.  Returns nullptr like getTransaction when
+   * nothing is available.
+   */
+  HTTPTransaction* getTransactionWithAffinity(
+      HTTPTransaction::Handler* upstreamHandler, uint64_t affinityKey);
+
   /**
    * Returns the number of idle sessions. That is, sessions with no open
    * outgoing transactions.
@@ -205,13 +299,82 @@ class SessionPool : private SessionHolder::Callback {
   void attachPartiallyFilled(SessionHolder*) override;
   void attachFilled(SessionHolder*) override;
   void addDrainingSession(HTTPSessionBase*) override;
+  void sessionDraining(SessionHolder*) override;
 
   SessionHolder::Stats* stats_{nullptr};
+
+  // interposes on the holder stats to feed passive health, forwarding
+  // everything to the user's stats object
+  class HealthStats : public SessionHolder::Stats {
+   public:
+    explicit HealthStats(SessionPool* pool) : pool_(pool) {
+    }
+    void onConnectionCreated() override {
+      forward([](SessionHolder::Stats* s) { s->onConnectionCreated(); });
+    }
+    void onConnectionClosed() override {
+      forward([](SessionHolder::Stats* s) { s->onConnectionClosed(); });
+    }
+    void onConnectionActivated() override {
+      forward([](SessionHolder::Stats* s) { s->onConnectionActivated(); });
+    }
+    void onConnectionDeactivated() override {
+      forward([](SessionHolder::Stats* s) { s->onConnectionDeactivated(); });
+    }
+    void onRead(size_t bytesRead) override {
+      forward([&](SessionHolder::Stats* s) { s->onRead(bytesRead); });
+    }
+    void onWrite(size_t bytesWritten) override {
+      forward([&](SessionHolder::Stats* s) { s->onWrite(bytesWritten); });
+    }
+    void onRequestResult(bool success,
+                         std::chrono::microseconds latency) override {
+      pool_->health_->recordResult(success, latency);
+      forward([&](SessionHolder::Stats* s) {
+        s->onRequestResult(success, latency);
+      });
+    }
+
+   private:
+    template <typename F>
+    void forward(F&& f) {
+      if (pool_->stats_) {
+        f(pool_->stats_);
+      }
+    }
+    SessionPool* pool_;
+  };
+
+  std::unique_ptr<PassiveEndpointHealth> health_;
+  std::unique_ptr<HealthStats> healthStats_;
+
+  // affinity state; see getTransactionWithAffinity
+  void holderDestroyed(SessionHolder* holder) override;
+  std::unordered_map<uint64_t, SessionHolder*> affinityByKey_;
+  std::unordered_map<SessionHolder*, std::vector<uint64_t>>
+      affinityKeysByHolder_;
+
+  // liveness probing state; see enableLivenessProbing
+  folly::Optional<LivenessOptions> liveness_;
+  std::chrono::milliseconds probeInterval_{0};
+  std::chrono::steady_clock::time_point lastProbeRound_{};
+
+  void probeIdleSessions();
   // Max number of connections stored in the pool.
   uint32_t maxConns_;
   std::chrono::milliseconds timeout_;
   std::chrono::milliseconds maxAge_;
 
+  // replenish toward the warmup target; no-op while disabled
+  void maybeReplenish();
+
+  // warm-pool maintenance state
+  uint32_t minIdleSessions_{0};
+  folly::Function<void()> warmupConnector_;
+  folly::Function<void(const HTTPSessionBase&)> drainCallback_;
+  uint32_t pendingWarmupConnects_{0};
+  bool inReplenish_{false};
+
   // List of all idle sessions in this SessionPool. Sessions
   // are sorted in descending order of lastUseTime in the list.
   SessionList idleSessionList_;
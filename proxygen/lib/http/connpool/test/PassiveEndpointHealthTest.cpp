@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/connpool/PassiveEndpointHealth.h>
+
+using namespace proxygen;
+using namespace std::chrono;
+
+namespace {
+
+PassiveEndpointHealth::Config perSampleWindows() {
+  // zero-length windows judged one sample at a time, so the tests need
+  // no clock control
+  PassiveEndpointHealth::Config config;
+  config.windowDuration = milliseconds(0);
+  config.minSamplesPerWindow = 1;
+  config.quarantineDuration = hours(1);
+  return config;
+}
+
+} // namespace
+
+TEST(PassiveEndpointHealthTest, QuarantinesOnErrors) {
+  PassiveEndpointHealth health(perSampleWindows());
+  for (int i = 0; i < 10; i++) {
+    health.recordResult(true, microseconds(1000));
+  }
+  EXPECT_TRUE(health.isHealthy());
+  EXPECT_GT(health.getBaselineP99Us(), 0);
+
+  health.recordResult(false, microseconds(1000));
+  health.recordResult(false, microseconds(1000));
+  EXPECT_FALSE(health.isHealthy());
+}
+
+TEST(PassiveEndpointHealthTest, QuarantinesOnLatencyDegrade) {
+  PassiveEndpointHealth health(perSampleWindows());
+  for (int i = 0; i < 10; i++) {
+    health.recordResult(true, microseconds(1000));
+  }
+  EXPECT_TRUE(health.isHealthy());
+  auto baseline = health.getBaselineP99Us();
+
+  // two records: the first closes the last healthy window, the second
+  // closes the degraded one and trips the p99 factor
+  health.recordResult(true, microseconds(100000));
+  health.recordResult(true, microseconds(100000));
+  EXPECT_FALSE(health.isHealthy());
+  // the degraded window never folded into the baseline
+  EXPECT_LE(health.getBaselineP99Us(), baseline * 2);
+}
+
+TEST(PassiveEndpointHealthTest, SmallWindowsNotJudged) {
+  PassiveEndpointHealth::Config config = perSampleWindows();
+  config.minSamplesPerWindow = 100;
+  PassiveEndpointHealth health(config);
+  for (int i = 0; i < 10; i++) {
+    health.recordResult(false, microseconds(1000));
+  }
+  // too few samples per window to judge; stays healthy
+  EXPECT_TRUE(health.isHealthy());
+}
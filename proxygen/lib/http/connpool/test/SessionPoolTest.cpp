@@ -552,6 +552,137 @@ TEST_F(SessionPoolFixture, MoveIdleSessionBetweenThreadsTest) {
   t2.join();
 }
 
+TEST_F(SessionPoolFixture, WarmupTarget) {
+  SessionPool p(this, 10);
+  uint32_t connects = 0;
+  p.setWarmupTarget(2, [&connects] { connects++; });
+  // immediately dials toward the target, once per missing session
+  EXPECT_EQ(connects, 2);
+
+  // a failed dial is re-attempted on the next maintenance pass
+  p.warmupConnectFailed();
+  p.performMaintenance();
+  EXPECT_EQ(connects, 3);
+
+  // both sessions arrive; the target is met, no further dialing
+  p.putSession(makeParallelSession());
+  p.putSession(makeParallelSession());
+  p.performMaintenance();
+  EXPECT_EQ(connects, 3);
+  EXPECT_EQ(p.getNumIdleSessions(), 2);
+}
+
+TEST_F(SessionPoolFixture, LivenessProbeSkipsPinglessSessions) {
+  SessionPool p(this, 10);
+  SessionPool::LivenessOptions liveness;
+  liveness.baseProbeInterval = std::chrono::milliseconds(0);
+  liveness.probeDeadline = std::chrono::milliseconds(0);
+  p.enableLivenessProbing(liveness);
+
+  // h1 codecs can't ping: a probe writes nothing and no reply can
+  // ever clear it, so probing must leave the session alone instead of
+  // evicting it on the (unanswerable) deadline
+  p.putSession(makeSerialSession());
+  EXPECT_EQ(p.getNumIdleSessions(), 1);
+  p.performMaintenance(); // would arm a probe
+  p.performMaintenance(); // would evict it as expired
+  p.performMaintenance();
+  EXPECT_EQ(p.getNumIdleSessions(), 1);
+  evb_.loop();
+}
+
+TEST_F(SessionPoolFixture, GoawayPreDrain) {
+  HTTPCodec::Callback* codecCb = nullptr;
+  auto codec = makeParallelCodec();
+  EXPECT_CALL(*codec, setCallback(testing::_))
+      .WillRepeatedly(testing::SaveArg<0>(&codecCb));
+  auto* session = makeSession(std::move(codec));
+
+  SessionPool p(this, 10);
+  uint32_t connects = 0;
+  p.setWarmupTarget(1, [&connects] { connects++; });
+  EXPECT_EQ(connects, 1); // empty pool dials toward the target
+  p.putSession(session);
+  EXPECT_EQ(p.getNumIdleSessions(), 1);
+
+  uint32_t drainNotifications = 0;
+  p.setDrainCallback(
+      [&drainNotifications](const HTTPSessionBase&) { drainNotifications++; });
+
+  // peer announces graceful shutdown: the session leaves rotation at
+  // once, the router hook fires, and a replacement is dialed before
+  // the old session runs dry
+  ASSERT_NE(codecCb, nullptr);
+  codecCb->onGoaway(0, ErrorCode::NO_ERROR);
+  EXPECT_EQ(drainNotifications, 1);
+  EXPECT_EQ(p.getNumIdleSessions(), 0);
+  EXPECT_EQ(connects, 2);
+  evb_.loop();
+}
+
+TEST_F(SessionPoolFixture, StealBatchParksDetachedSessionsTest) {
+  TestIdleController ctrl;
+  ctrl.setStealBatchSize(1);
+  HTTPUpstreamSession* s1 = nullptr;
+  HTTPUpstreamSession* s2 = nullptr;
+
+  folly::Baton<> t1InitBaton, t2InitBaton, transferBaton;
+  std::thread t1([&] {
+    folly::EventBaseManager::get()->setEventBase(&evb_, false);
+    SessionPool p1(this,
+                   10,
+                   std::chrono::seconds(30),
+                   std::chrono::milliseconds(0),
+                   nullptr,
+                   &ctrl);
+    // Two idle sessions on p1; a batched steal should take both.
+    s1 = makeParallelSession();
+    s2 = makeParallelSession();
+    p1.putSession(s1);
+    p1.putSession(s2);
+    t1InitBaton.post();
+    evb_.loopForever();
+  });
+
+  folly::EventBase evb2;
+  std::thread t2([&] {
+    folly::EventBaseManager::get()->setEventBase(&evb2, false);
+    SessionPool p2(this,
+                   10,
+                   std::chrono::seconds(30),
+                   std::chrono::milliseconds(0),
+                   nullptr,
+                   &ctrl);
+    t2InitBaton.post();
+    evb2.loopForever();
+  });
+
+  t1InitBaton.wait();
+  t2InitBaton.wait();
+  HTTPSessionBase* stolen = nullptr;
+  evb2.runInEventBaseThread([&] {
+    ctrl.getIdleSession().via(&evb2).thenValue([&](
+        HTTPSessionBase* idleSession) {
+      stolen = idleSession;
+      transferBaton.post();
+    });
+  });
+  transferBaton.wait();
+  ASSERT_EQ(stolen, s1);
+
+  // The second session was pre-detached and parked in the lock-free lane,
+  // so this steal completes inline without a cross-thread hop.
+  EXPECT_EQ(ctrl.getIdleSession().get(), s2);
+  EXPECT_EQ(ctrl.popBestIdlePool(), nullptr);
+
+  s1->drain();
+  s2->drain();
+  evb_.terminateLoopSoon();
+  evb2.terminateLoopSoon();
+  t1.join();
+  t2.join();
+}
+
 TEST_F(SessionPoolFixture, PurgeAddedSessionTest) {
   TestIdleController ctrl;
   HTTPUpstreamSession* session = makeParallelSession();
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/BroadcastFanout.h>
+
+#include <glog/logging.h>
+#include <proxygen/lib/http/session/HTTPTransaction.h>
+#include <vector>
+
+namespace proxygen {
+
+void BroadcastFanout::subscribe(HTTPTransaction* txn, folly::EventBase* evb) {
+  DCHECK(evb->isInEventBaseThread());
+  auto groups = groups_.wlock();
+  auto& group = (*groups)[evb];
+  if (!group) {
+    group = std::make_shared<WorkerGroup>();
+    group->evb = evb;
+  }
+  group->txns.insert(txn);
+}
+
+void BroadcastFanout::unsubscribe(HTTPTransaction* txn,
+                                  folly::EventBase* evb) {
+  DCHECK(evb->isInEventBaseThread());
+  auto groups = groups_.wlock();
+  auto it = groups->find(evb);
+  if (it == groups->end()) {
+    return;
+  }
+  it->second->txns.erase(txn);
+  if (it->second->txns.empty()) {
+    groups->erase(it);
+  }
+}
+
+size_t BroadcastFanout::publish(std::unique_ptr<folly::IOBuf> event) {
+  // one shared immutable copy of the bytes for the whole fleet
+  std::shared_ptr<folly::IOBuf> shared(std::move(event));
+  std::vector<std::shared_ptr<WorkerGroup>> groups;
+  {
+    auto locked = groups_.rlock();
+    groups.reserve(locked->size());
+    for (const auto& entry : *locked) {
+      groups.push_back(entry.second);
+    }
+  }
+  for (const auto& group : groups) {
+    // one wakeup per worker; the lambda walks that worker's set on
+    // its own loop, where the transactions are safe to touch
+    group->evb->runInEventBaseThread([group, shared] {
+      for (auto it = group->txns.begin(); it != group->txns.end();) {
+        HTTPTransaction* txn = *it;
+        if (txn->isEgressComplete()) {
+          // egress finished without unsubscribing; drop it
+          it = group->txns.erase(it);
+          continue;
+        }
+        // clone: a new chain referencing the same underlying buffer
+        txn->sendBody(shared->clone());
+        ++it;
+      }
+    });
+  }
+  return groups.size();
+}
+
+size_t BroadcastFanout::numSubscribers() const {
+  size_t count = 0;
+  auto groups = groups_.rlock();
+  for (const auto& entry : *groups) {
+    count += entry.second->txns.size();
+  }
+  return count;
+}
+
+} // namespace proxygen
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/async/EventBase.h>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+namespace proxygen {
+
+class HTTPTransaction;
+
+/**
+ * Fan-out of one event's bytes to many subscribed transactions
+ * (broadcast / SSE tiers) without duplicating the payload.
+ *
+ * publish() wraps the event in a shared immutable IOBuf and delivers
+ * it with one event-loop wakeup per worker; each subscribed
+ * transaction's egress gets a clone() - a chain that references the
+ * same underlying buffer - so memory bandwidth scales with event
+ * size, not subscriber count.  Per-stream framing (DATA frame
+ * headers, chunk envelopes) is generated separately by the codec
+ * into the session's write buffer; the shared payload itself is
+ * never written into, which is what keeps sharing safe.  Keep any
+ * egress packing threshold (HTTP2Codec::setEgressPackingThreshold)
+ * below the event size, or the packing copy defeats the sharing.
+ *
+ * Threading contract: subscribe() and unsubscribe() must run on the
+ * transaction's event base (the handler's own callbacks qualify),
+ * and a subscriber MUST unsubscribe in detachTransaction/onError -
+ * the fanout holds raw transaction pointers that it only ever
+ * dereferences on their owning loop.  publish() is safe from any
+ * thread.  Transactions whose egress has already completed are
+ * skipped and dropped from the set.
+ */
+class BroadcastFanout {
+ public:
+  /** Register a transaction; must run on evb, the transaction's loop. */
+  void subscribe(HTTPTransaction* txn, folly::EventBase* evb);
+
+  /** Remove a transaction; must run on the evb that subscribed it. */
+  void unsubscribe(HTTPTransaction* txn, folly::EventBase* evb);
+
+  /**
+   * Deliver the event to every subscriber, one wakeup per worker.
+   * Returns the number of workers notified.  Safe from any thread.
+   */
+  size_t publish(std::unique_ptr<folly::IOBuf> event);
+
+  size_t numSubscribers() const;
+
+ private:
+  // per-worker subscriber set; only its owning event base touches txns
+  struct WorkerGroup {
+    folly::EventBase* evb{nullptr};
+    std::set<HTTPTransaction*> txns;
+  };
+
+  folly::Synchronized<
+      std::unordered_map<folly::EventBase*, std::shared_ptr<WorkerGroup>>>
+      groups_;
+};
+
+} // namespace proxygen
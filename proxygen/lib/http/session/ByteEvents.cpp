@@ -7,12 +7,58 @@
  */
 
 #include <folly/Conv.h>
+#include <vector>
 #include <proxygen/lib/http/session/ByteEvents.h>
 
 #include <proxygen/lib/utils/Time.h>
 
+namespace {
+
+// free-listed slots are all one size; cap the retained memory
+constexpr size_t kMaxPooledByteEvents = 256;
+
+std::vector<void*>& byteEventPool() {
+  struct PoolTag {};
+  struct Pool {
+    std::vector<void*> slots;
+    ~Pool() {
+      for (auto slot : slots) {
+        ::operator delete(slot);
+      }
+    }
+  };
+  static thread_local Pool pool;
+  return pool.slots;
+}
+
+} // anonymous namespace
+
 namespace proxygen {
 
+namespace detail {
+
+void* allocateByteEvent(std::size_t size) {
+  auto& pool = byteEventPool();
+  if (!pool.empty()) {
+    auto slot = pool.back();
+    pool.pop_back();
+    return slot;
+  }
+  return ::operator new(size);
+}
+
+void recycleByteEvent(void* ptr, std::size_t /*size*/) {
+  auto& pool = byteEventPool();
+  if (pool.size() < kMaxPooledByteEvents) {
+    pool.push_back(ptr);
+  } else {
+    ::operator delete(ptr);
+  }
+}
+
+} // namespace detail
+
+
 const char* const kTypeStrings[] = {
     "FIRST_BYTE",
     "LAST_BYTE",
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <folly/IntrusiveList.h>
 #include <folly/Portability.h>
 #include <proxygen/lib/utils/AsyncTimeoutSet.h>
@@ -15,6 +16,15 @@
 
 namespace proxygen {
 
+namespace detail {
+/**
+ * Per-thread free list backing TransactionByteEvent allocation; these
+ * events churn at two per response when ack tracking is on.
+ */
+void* allocateByteEvent(std::size_t size);
+void recycleByteEvent(void* ptr, std::size_t size);
+} // namespace detail
+
 class HTTPTransaction;
 class ByteEvent {
  public:
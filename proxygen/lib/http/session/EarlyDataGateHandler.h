@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Function.h>
+#include <folly/io/IOBufQueue.h>
+#include <proxygen/lib/http/session/HTTPTransaction.h>
+
+namespace proxygen {
+
+/**
+ * Idempotency gate for requests arriving in TLS/QUIC early data.
+ *
+ * Wraps the real transaction handler; on transports that are not yet
+ * replay safe it consults a policy per request and either processes it
+ * immediately (replay-tolerant methods), parks it - ingress paused,
+ * early events buffered - until the handshake confirms replay safety,
+ * or answers 425 Too Early without touching the application. On
+ * already-safe transports it is a straight passthrough after one
+ * synchronous replay-safety check.
+ */
+class EarlyDataGateHandler
+    : public HTTPTransactionHandler
+    , private folly::AsyncTransport::ReplaySafetyCallback {
+ public:
+  enum class Action : uint8_t {
+    PROCESS, // replay risk acceptable for this request
+    BUFFER,  // hold until the transport is replay safe
+    REJECT,  // 425 Too Early
+  };
+
+  using Policy = folly::Function<Action(const HTTPMessage&) const>;
+
+  /**
+   * The default policy: idempotent, body-less methods process
+   * immediately; everything else waits for replay safety.
+   */
+  static Action defaultPolicy(const HTTPMessage& msg) {
+    const auto method = msg.getMethod();
+    if (method == HTTPMethod::GET || method == HTTPMethod::HEAD) {
+      return Action::PROCESS;
+    }
+    return Action::BUFFER;
+  }
+
+  EarlyDataGateHandler(HTTPTransactionHandler* inner, const Policy* policy)
+      : inner_(inner), policy_(policy) {
+  }
+
+  void setTransaction(HTTPTransaction* txn) noexcept override {
+    txn_ = txn;
+    inner_->setTransaction(txn);
+    // synchronous callback when the transport is already replay safe
+    txn_->addWaitingForReplaySafety(this);
+    waiting_ = !replaySafe_;
+  }
+
+  void detachTransaction() noexcept override {
+    if (waiting_) {
+      txn_->removeWaitingForReplaySafety(this);
+      waiting_ = false;
+    }
+    inner_->detachTransaction();
+    delete this;
+  }
+
+  void onHeadersComplete(std::unique_ptr<HTTPMessage> msg) noexcept override {
+    if (replaySafe_ || rejected_) {
+      forwardHeaders(std::move(msg));
+      return;
+    }
+    const auto action =
+        policy_ ? (*policy_)(*msg) : defaultPolicy(*msg);
+    switch (action) {
+      case Action::PROCESS:
+        inner_->onHeadersComplete(std::move(msg));
+        break;
+      case Action::BUFFER:
+        bufferedHeaders_ = std::move(msg);
+        txn_->pauseIngress();
+        break;
+      case Action::REJECT:
+        reject();
+        break;
+    }
+  }
+
+  void onBody(std::unique_ptr<folly::IOBuf> chain) noexcept override {
+    if (bufferedHeaders_) {
+      bufferedBody_.append(std::move(chain));
+      return;
+    }
+    if (rejected_) {
+      return;
+    }
+    inner_->onBody(std::move(chain));
+  }
+
+  void onChunkHeader(size_t length) noexcept override {
+    if (!bufferedHeaders_ && !rejected_) {
+      inner_->onChunkHeader(length);
+    }
+  }
+
+  void onChunkComplete() noexcept override {
+    if (!bufferedHeaders_ && !rejected_) {
+      inner_->onChunkComplete();
+    }
+  }
+
+  void onTrailers(std::unique_ptr<HTTPHeaders> trailers) noexcept override {
+    if (!bufferedHeaders_ && !rejected_) {
+      inner_->onTrailers(std::move(trailers));
+    }
+  }
+
+  void onEOM() noexcept override {
+    if (bufferedHeaders_) {
+      bufferedEOM_ = true;
+      return;
+    }
+    if (rejected_) {
+      return;
+    }
+    inner_->onEOM();
+  }
+
+  void onUpgrade(UpgradeProtocol protocol) noexcept override {
+    inner_->onUpgrade(protocol);
+  }
+
+  void onError(const HTTPException& error) noexcept override {
+    inner_->onError(error);
+  }
+
+  void onEgressPaused() noexcept override {
+    inner_->onEgressPaused();
+  }
+
+  void onEgressResumed() noexcept override {
+    inner_->onEgressResumed();
+  }
+
+ private:
+  // folly::AsyncTransport::ReplaySafetyCallback
+  void onReplaySafe() noexcept override {
+    replaySafe_ = true;
+    waiting_ = false;
+    if (bufferedHeaders_) {
+      forwardHeaders(std::move(bufferedHeaders_));
+      txn_->resumeIngress();
+    }
+  }
+
+  void forwardHeaders(std::unique_ptr<HTTPMessage> msg) noexcept {
+    if (rejected_) {
+      return;
+    }
+    inner_->onHeadersComplete(std::move(msg));
+    if (!bufferedBody_.empty()) {
+      inner_->onBody(bufferedBody_.move());
+    }
+    if (bufferedEOM_) {
+      bufferedEOM_ = false;
+      inner_->onEOM();
+    }
+  }
+
+  void reject() noexcept {
+    rejected_ = true;
+    bufferedHeaders_.reset();
+    bufferedBody_.move();
+    HTTPMessage response;
+    response.setHTTPVersion(1, 1);
+    response.setStatusCode(425);
+    response.setStatusMessage("Too Early");
+    response.getHeaders().add(HTTP_HEADER_CONTENT_LENGTH, "0");
+    txn_->sendHeaders(response);
+    txn_->sendEOM();
+  }
+
+  HTTPTransactionHandler* inner_;
+  const Policy* policy_;
+  HTTPTransaction* txn_{nullptr};
+  std::unique_ptr<HTTPMessage> bufferedHeaders_;
+  folly::IOBufQueue bufferedBody_{folly::IOBufQueue::cacheChainLength()};
+  bool bufferedEOM_{false};
+  bool replaySafe_{false};
+  bool waiting_{false};
+  bool rejected_{false};
+};
+
+} // namespace proxygen
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <folly/hash/Hash.h>
+#include <glog/logging.h>
+#include <limits>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Flat open-addressed index from a stream id to a stream object,
+ * designed for the per-callback lookups on the QUIC read/write path:
+ * linear probing over a power-of-two slot array, a one-entry
+ * last-lookup cache (read callbacks hit the same stream repeatedly),
+ * inline storage for the small-session common case, and backward-shift
+ * deletion so probes never traverse tombstones.
+ *
+ * Values are non-owning pointers; the owner must erase an id before
+ * the pointed-to object dies.
+ */
+template <typename T>
+class FlatStreamIndex {
+ public:
+  static constexpr size_t kInlineCapacity = 16;
+  static constexpr uint64_t kEmptyKey =
+      std::numeric_limits<uint64_t>::max();
+
+  FlatStreamIndex() {
+    inlineSlots_.fill(Slot{});
+    slots_ = inlineSlots_.data();
+    capacity_ = kInlineCapacity;
+  }
+
+  T* find(uint64_t id) const {
+    if (id == lastId_) {
+      return lastStream_;
+    }
+    const size_t mask = capacity_ - 1;
+    size_t idx = home(id, mask);
+    while (slots_[idx].key != kEmptyKey) {
+      if (slots_[idx].key == id) {
+        lastId_ = id;
+        lastStream_ = slots_[idx].value;
+        return lastStream_;
+      }
+      idx = (idx + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  void insert(uint64_t id, T* value) {
+    DCHECK_NE(id, kEmptyKey);
+    if ((size_ + 1) * 4 > capacity_ * 3) {
+      grow();
+    }
+    const size_t mask = capacity_ - 1;
+    size_t idx = home(id, mask);
+    while (slots_[idx].key != kEmptyKey) {
+      if (slots_[idx].key == id) {
+        slots_[idx].value = value;
+        lastId_ = kEmptyKey;
+        return;
+      }
+      idx = (idx + 1) & mask;
+    }
+    slots_[idx] = Slot{id, value};
+    size_++;
+  }
+
+  void erase(uint64_t id) {
+    const size_t mask = capacity_ - 1;
+    size_t idx = home(id, mask);
+    while (slots_[idx].key != id) {
+      if (slots_[idx].key == kEmptyKey) {
+        return;
+      }
+      idx = (idx + 1) & mask;
+    }
+    // backward-shift deletion: pull displaced entries into the hole
+    size_t hole = idx;
+    size_t probe = idx;
+    while (true) {
+      probe = (probe + 1) & mask;
+      if (slots_[probe].key == kEmptyKey) {
+        break;
+      }
+      const size_t h = home(slots_[probe].key, mask);
+      if (((probe - h) & mask) >= ((probe - hole) & mask)) {
+        slots_[hole] = slots_[probe];
+        hole = probe;
+      }
+    }
+    slots_[hole] = Slot{};
+    size_--;
+    if (lastId_ == id) {
+      lastId_ = kEmptyKey;
+      lastStream_ = nullptr;
+    }
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  struct Slot {
+    uint64_t key{kEmptyKey};
+    T* value{nullptr};
+  };
+
+  static size_t home(uint64_t id, size_t mask) {
+    return folly::hash::twang_mix64(id) & mask;
+  }
+
+  void grow() {
+    const size_t newCapacity = capacity_ * 2;
+    std::vector<Slot> newSlots(newCapacity);
+    const size_t newMask = newCapacity - 1;
+    for (size_t i = 0; i < capacity_; i++) {
+      if (slots_[i].key == kEmptyKey) {
+        continue;
+      }
+      size_t idx = home(slots_[i].key, newMask);
+      while (newSlots[idx].key != kEmptyKey) {
+        idx = (idx + 1) & newMask;
+      }
+      newSlots[idx] = slots_[i];
+    }
+    heapSlots_ = std::move(newSlots);
+    slots_ = heapSlots_.data();
+    capacity_ = newCapacity;
+  }
+
+  std::array<Slot, kInlineCapacity> inlineSlots_;
+  std::vector<Slot> heapSlots_;
+  Slot* slots_;
+  size_t capacity_;
+  size_t size_{0};
+  // one-entry lookup cache
+  mutable uint64_t lastId_{kEmptyKey};
+  mutable T* lastStream_{nullptr};
+};
+
+} // namespace proxygen
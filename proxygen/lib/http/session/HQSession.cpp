@@ -813,11 +813,8 @@ HQSession::findStreamImpl(quic::StreamId streamId,
                           bool includeEgress,
                           bool includeIngress,
                           bool includeDetached) {
-  HQStreamTransportBase* pstream{nullptr};
-  auto it = streams_.find(streamId);
-  if (it != streams_.end()) {
-    pstream = &it->second;
-  }
+  // flat index fast path; falls back to the push stream maps
+  HQStreamTransportBase* pstream = streamLookup_.find(streamId);
   if (!pstream && (includeIngress || includeEgress)) {
     pstream = findPushStream(streamId);
   }
@@ -863,6 +860,7 @@ bool HQSession::eraseStream(quic::StreamId streamId) {
   // stream
   bool erased = false;
   if (streams_.erase(streamId)) {
+    streamLookup_.erase(streamId);
     erased = true;
   }
 
@@ -1850,22 +1848,80 @@ void HQSession::handleSessionError(HQStreamBase* stream,
                            proxygenError);
 }
 
+void HQSession::enableExtensiblePriorities() {
+  if (!urgencyNodes_.empty()) {
+    return;
+  }
+  // Chain of virtual nodes, one per urgency level, mirroring
+  // HTTP2Codec::addPriorityNodes: streams parented at level u get the
+  // lion's share of that node's bandwidth and each lower level only the
+  // virtual child's weight, approximating strict urgency order.  The
+  // node ids are client-initiated unidirectional QUIC ids (2 mod 4),
+  // which never appear in the transaction egress queue, so they cannot
+  // collide with request streams.
+  urgencyNodes_.reserve(RFC9218::kNumUrgencies);
+  HTTPCodec::StreamID parent = kSessionStreamId;
+  for (uint8_t urgency = 0; urgency < RFC9218::kNumUrgencies; urgency++) {
+    HTTPCodec::StreamID id = 2 + 4 * urgency;
+    txnEgressQueue_.addPriorityNode(id, parent);
+    urgencyNodes_.push_back(id);
+    parent = id;
+  }
+}
+
+bool HQSession::updateStreamUrgency(HTTPCodec::StreamID id,
+                                    RFC9218::Priority priority) {
+  if (urgencyNodes_.empty()) {
+    return false;
+  }
+  auto stream = findStream(id);
+  if (!stream) {
+    return false;
+  }
+  // The tree round-robins among the enqueued children of the urgency
+  // node, which matches the incremental behavior; non-incremental
+  // streams are scheduled the same way, as the tree cannot express
+  // run-to-completion.
+  auto urgency = std::min(priority.urgency, RFC9218::kMaxUrgency);
+  stream->txn_.onPriorityUpdate(
+      http2::PriorityUpdate{urgencyNodes_[urgency], false, 15});
+  return true;
+}
+
 uint64_t HQSession::writeRequestStreams(uint64_t maxEgress) noexcept {
   // requestStreamWriteImpl may call txn->onWriteReady
   txnEgressQueue_.nextEgress(nextEgressResults_);
+  uint64_t batchedBytes = 0;
   for (auto it = nextEgressResults_.begin(); it != nextEgressResults_.end();
        ++it) {
     auto& ratio = it->second;
     auto hqStream =
         static_cast<HQStreamTransportBase*>(&it->first->getTransport());
+    // Cork all but the turn's last stream write so the transport can
+    // pack multiple streams' egress into GSO bursts; the batch cap
+    // forces an intermediate flush.
+    corkCurrentWrite_ = egressBatchBytes_ != 0 &&
+        std::next(it) != nextEgressResults_.end() &&
+        batchedBytes < egressBatchBytes_;
     // TODO: scale maxToSend by ratio?
     auto sent = requestStreamWriteImpl(hqStream, maxEgress, ratio);
+    corkCurrentWrite_ = false;
+    batchedBytes += sent;
     DCHECK_LE(sent, maxEgress);
     maxEgress -= sent;
 
     if (maxEgress == 0 && std::next(it) != nextEgressResults_.end()) {
       VLOG(3) << __func__ << " sess=" << *this
               << " got more to send than the transport could take";
+      if (egressBatchBytes_ != 0) {
+        // the write we just issued was corked; uncork with an empty
+        // write so the batch doesn't sit in the transport
+        sock_->writeChain(hqStream->getEgressStreamId(),
+                          folly::IOBuf::create(0),
+                          false /* eof */,
+                          false /* cork */,
+                          nullptr);
+      }
       break;
     }
   }
@@ -1921,7 +1977,7 @@ folly::Expected<size_t, quic::LocalErrorCode> HQSession::writeBase(
   auto writeRes = sock_->writeChain(id,
                                     std::move(data),
                                     sendEof,
-                                    false, // cork
+                                    corkCurrentWrite_,
                                     deliveryCallback);
   if (writeRes.hasError()) {
     LOG(ERROR) << " Got error=" << writeRes.error() << " streamID=" << id;
@@ -2032,6 +2088,15 @@ uint64_t HQSession::requestStreamWriteImpl(HQStreamTransportBase* hqStream,
   auto sendLen = std::min(canSend, hqStream->writeBuf_.chainLength());
   auto tryWriteBuf = hqStream->writeBuf_.splitAtMost(canSend);
   bool sendEof = (hqStream->pendingEOM_ && !hqStream->hasPendingBody());
+  // Final-flush combining: when body, trailers and EOM were staged by
+  // the time this stream is serviced (sendEOM serializes trailers into
+  // writeBuf_ before setting pendingEOM_), the single writeChain below
+  // carries last-DATA + trailer HEADERS + FIN, so the FIN rides the
+  // same packet as the last bytes.  A trailing FIN-only packet occurs
+  // only when the EOM is staged after the stream's last service - a
+  // handler-timing artifact; handlers that finish a response in one
+  // shot avoid it by using HTTPTransaction::sendBodyAndTrailers, which
+  // stages everything under a single egress wakeup.
 
   CHECK(sendLen > 0 || sendEof);
   VLOG(4) << __func__ << " before write sess=" << *this
@@ -2193,6 +2258,7 @@ HQSession::createStreamTransport(quic::StreamId streamId) {
 
   CHECK(matchPair.second) << "Emplacement failed, despite earlier "
                              "existence check.";
+  streamLookup_.insert(streamId, &matchPair.first->second);
 
   if (versionUtils_ && drainState_ != DrainState::NONE) {
     versionUtils_->sendGoawayOnRequestStream(matchPair.first->second);
@@ -2444,6 +2510,43 @@ void HQSession::detachStreamTransport(HQStreamTransportBase* hqStream) {
 
 void HQSession::HQControlStream::processReadData() {
   auto g = folly::makeGuard(setActiveCodec(__func__));
+  // Flat dispatch for the QPACK streams, resolved from the preface
+  // type: their bytes feed the session's QPACKCodec directly instead
+  // of going through the HQUnidirectionalCodec adapter's virtual hop.
+  // Error semantics mirror QPACKEncoderCodec/QPACKDecoderCodec; note
+  // the local decoder consumes the peer ENCODER stream and vice versa.
+  CHECK(type_.hasValue());
+  if (*type_ == hq::UnidirectionalStreamType::QPACK_ENCODER ||
+      *type_ == hq::UnidirectionalStreamType::QPACK_DECODER) {
+    const bool encoderStream =
+        *type_ == hq::UnidirectionalStreamType::QPACK_ENCODER;
+    if (readBuf_.chainLength() > 0) {
+      auto err = encoderStream
+                     ? session_.qpackCodec_.decodeEncoderStream(readBuf_.move())
+                     : session_.qpackCodec_.decodeDecoderStream(readBuf_.move());
+      if (err != HPACK::DecodeError::NONE) {
+        LOG(ERROR) << "QPACK " << (encoderStream ? "encoder" : "decoder")
+                   << " stream decode error err=" << err;
+        HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS,
+                         encoderStream
+                             ? "Compression error on encoder stream"
+                             : "Compression error on decoder stream");
+        ex.setErrno(uint32_t(
+            encoderStream ? HTTP3::ErrorCode::HTTP_QPACK_ENCODER_STREAM_ERROR
+                          : HTTP3::ErrorCode::HTTP_QPACK_DECODER_STREAM_ERROR));
+        onError(kSessionStreamId, ex, false);
+        return;
+      }
+    }
+    if (readEOF_) {
+      HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS,
+                       encoderStream ? "Encoder stream EOF"
+                                     : "Decoder stream EOF");
+      ex.setErrno(uint32_t(HTTP3::ErrorCode::HTTP_CLOSED_CRITICAL_STREAM));
+      onError(kSessionStreamId, ex, false);
+    }
+    return;
+  }
   CHECK(ingressCodec_->isIngress());
   auto initialLength = readBuf_.chainLength();
   if (initialLength > 0) {
@@ -2569,6 +2672,14 @@ void HQSession::HQStreamTransportBase::onHeadersComplete(
   DCHECK(session_.versionUtils_);
   session_.versionUtils_->headersComplete(msg.get());
 
+  if (session_.extensiblePrioritiesEnabled() &&
+      session_.direction_ == TransportDirection::DOWNSTREAM) {
+    auto priority = RFC9218::getPriority(*msg);
+    if (priority) {
+      session_.updateStreamUrgency(getStreamId(), *priority);
+    }
+  }
+
   // onHeadersComplete can be triggered by data from a different stream ID
   // - specifically, the QPACK encoder stream.  If that's true, then there may
   // be unparsed data in HQStreamTransport.  Add this stream's id to the
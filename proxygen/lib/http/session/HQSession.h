@@ -13,6 +13,7 @@
 #include <folly/io/async/DelayedDestructionBase.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/lang/Assume.h>
+#include <proxygen/lib/http/RFC9218.h>
 #include <proxygen/lib/http/codec/HQControlCodec.h>
 #include <proxygen/lib/http/codec/HQStreamCodec.h>
 #include <proxygen/lib/http/codec/HQUnidirectionalCodec.h>
@@ -25,6 +26,7 @@
 #include <proxygen/lib/http/codec/QPACKDecoderCodec.h>
 #include <proxygen/lib/http/codec/QPACKEncoderCodec.h>
 #include <proxygen/lib/http/session/ByteEventTracker.h>
+#include <proxygen/lib/http/session/FlatStreamIndex.h>
 #include <proxygen/lib/http/session/HQStreamBase.h>
 #include <proxygen/lib/http/session/HQUnidirectionalCallbacks.h>
 #include <proxygen/lib/http/session/HTTPSessionBase.h>
@@ -327,6 +329,16 @@ class HQSession
     HTTPSessionBase::setReadBufferLimit((uint32_t)receiveSessionWindowSize);
   }
 
+  /**
+   * Cork per-stream writes within a single loop turn so the transport
+   * can pack multiple streams' egress into GSO bursts, uncorking once
+   * the accumulated batch reaches maxBatchBytes or the turn's last
+   * stream is written. 0 (the default) keeps per-stream flushing.
+   */
+  void setEgressBatchBytes(uint64_t maxBatchBytes) {
+    egressBatchBytes_ = maxBatchBytes;
+  }
+
   /**
    * Set outgoing settings for this session
    */
@@ -380,6 +392,26 @@ class HQSession
     return 0;
   }
 
+  /**
+   * Enable extensible priority (RFC 9218) scheduling for this session's
+   * egress.  Installs a chain of virtual urgency nodes in the egress
+   * queue; request streams are re-parented under their urgency level
+   * when the "priority" header arrives, and can be moved later via
+   * updateStreamUrgency().  Call before streams are created.
+   */
+  void enableExtensiblePriorities();
+
+  bool extensiblePrioritiesEnabled() const {
+    return !urgencyNodes_.empty();
+  }
+
+  /**
+   * Re-parent an existing stream under the given urgency level, e.g. on
+   * a priority update from the peer or the application.  Returns false
+   * if extensible priorities are not enabled or the stream is unknown.
+   */
+  bool updateStreamUrgency(HTTPCodec::StreamID id, RFC9218::Priority priority);
+
   /**
    * Get session-level transport info.
    * NOTE: The protocolInfo will be set to connection-level pointer.
@@ -2024,6 +2056,15 @@ class HQSession
   uint64_t maxToSend_{0};
   bool scheduledWrite_{false};
 
+  // virtual urgency nodes (RFC 9218), highest urgency first; empty when
+  // extensible priorities are disabled
+  std::vector<HTTPCodec::StreamID> urgencyNodes_;
+
+  // GSO-aware write batching: cap on corked bytes per loop turn, and
+  // whether the write currently being issued should be corked
+  uint64_t egressBatchBytes_{0};
+  bool corkCurrentWrite_{false};
+
   bool forceUpstream1_1_{true};
   bool writesPaused_{false};
 
@@ -2056,6 +2097,10 @@ class HQSession
   // Bidirectional transport streams
   std::unordered_map<quic::StreamId, HQStreamTransport> streams_;
 
+  // flat open-addressed index over streams_ for the per-callback
+  // lookups; values are pointers into streams_ (node-stable)
+  FlatStreamIndex<HQStreamTransportBase> streamLookup_;
+
 }; // HQSession
 
 std::ostream& operator<<(std::ostream& os, HQSession::DrainState drainState);
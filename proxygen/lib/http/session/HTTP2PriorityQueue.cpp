@@ -8,6 +8,8 @@
 
 #include <proxygen/lib/http/session/HTTP2PriorityQueue.h>
 
+#include <vector>
+
 using std::list;
 using std::unique_ptr;
 
@@ -27,6 +29,46 @@ uint32_t HTTP2PriorityQueue::kMaxRebuilds_ = 3;
 std::chrono::milliseconds HTTP2PriorityQueue::kNodeLifetime_ =
     std::chrono::seconds(30);
 
+namespace {
+
+// Free list for Node storage, capped so an h2 burst doesn't pin its
+// high-water mark forever.  Thread-local: a worker's sessions share it.
+constexpr size_t kNodePoolLimit = 512;
+
+std::vector<void*>& nodePool() {
+  struct Pool {
+    std::vector<void*> free;
+    ~Pool() {
+      for (auto ptr : free) {
+        ::operator delete(ptr);
+      }
+    }
+  };
+  static thread_local Pool pool;
+  return pool.free;
+}
+
+} // anonymous namespace
+
+void* HTTP2PriorityQueue::Node::operator new(size_t size) {
+  auto& pool = nodePool();
+  if (size == sizeof(Node) && !pool.empty()) {
+    auto ptr = pool.back();
+    pool.pop_back();
+    return ptr;
+  }
+  return ::operator new(size);
+}
+
+void HTTP2PriorityQueue::Node::operator delete(void* ptr, size_t size) {
+  auto& pool = nodePool();
+  if (size == sizeof(Node) && pool.size() < kNodePoolLimit) {
+    pool.push_back(ptr);
+    return;
+  }
+  ::operator delete(ptr);
+}
+
 HTTP2PriorityQueue::Node::Node(HTTP2PriorityQueue& queue,
                                HTTP2PriorityQueue::Node* inParent,
                                HTTPCodec::StreamID id,
@@ -575,11 +617,18 @@ HTTP2PriorityQueue::Handle HTTP2PriorityQueue::updatePriority(
 
 void HTTP2PriorityQueue::removeTransaction(HTTP2PriorityQueue::Handle handle) {
   Node* node = nodeFromBaseNode(handle);
-  pendingWeightChange_ = true;
   // TODO: or require the node to do it?
   if (node->isEnqueued()) {
     clearPendingEgress(handle);
   }
+  // Removing a leaf reweights nothing: removeFromTree's child reweight
+  // loop is vacuous and the parent's totalChildWeight_ is maintained
+  // incrementally by detachChild, so the enqueued-weight recompute can
+  // be skipped.  (clearPendingEgress above already flagged it if the
+  // node was enqueued.)
+  if (!node->isLeaf()) {
+    pendingWeightChange_ = true;
+  }
   if (allowDanglingNodes() && numVirtualNodes_ < maxVirtualNodes_) {
     node->clearTransaction();
     numVirtualNodes_++;
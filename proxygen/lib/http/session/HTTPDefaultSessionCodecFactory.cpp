@@ -12,6 +12,7 @@
 #include <proxygen/lib/http/codec/HTTP2Codec.h>
 #include <proxygen/lib/http/codec/HTTP2Constants.h>
 #include <proxygen/lib/http/codec/SPDYCodec.h>
+#include <proxygen/lib/services/RequestWorkerThread.h>
 
 namespace proxygen {
 
@@ -37,12 +38,21 @@ std::unique_ptr<HTTPCodec> HTTPDefaultSessionCodecFactory::getCodec(
     return std::make_unique<HTTP2Codec>(direction);
   } else if (nextProtocol.empty() ||
              HTTP1xCodec::supportsNextProtocol(nextProtocol)) {
-    auto codec = std::make_unique<HTTP1xCodec>(direction);
+    // reuse a recycled codec from this worker's pool when there is one
+    auto worker = dynamic_cast<RequestWorkerThread*>(
+        WorkerThread::getCurrentWorkerThread());
+    std::unique_ptr<HTTPCodec> codec;
+    if (worker) {
+      codec = worker->obtainRecycledCodec(CodecProtocol::HTTP_1_1, direction);
+    }
+    if (!codec) {
+      codec = std::make_unique<HTTP1xCodec>(direction);
+    }
     if (!isTLS) {
-      codec->setAllowedUpgradeProtocols(
+      static_cast<HTTP1xCodec*>(codec.get())->setAllowedUpgradeProtocols(
           accConfig_.allowedPlaintextUpgradeProtocols);
     }
-    return std::move(codec);
+    return codec;
   } else if (auto version = SPDYCodec::getVersion(nextProtocol)) {
     return std::make_unique<SPDYCodec>(
         direction, *version, accConfig_.spdyCompressionLevel);
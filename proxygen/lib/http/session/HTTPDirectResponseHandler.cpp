@@ -9,12 +9,72 @@
 #include <proxygen/lib/http/session/HTTPDirectResponseHandler.h>
 
 #include <folly/Conv.h>
+#include <folly/SingletonThreadLocal.h>
+#include <map>
 #include <proxygen/lib/http/session/HTTPErrorPage.h>
+#include <tuple>
 
 using folly::IOBuf;
 using std::string;
 using std::unique_ptr;
 
+namespace {
+
+struct CachedErrorResponse {
+  proxygen::HTTPMessage msg;
+  std::unique_ptr<folly::IOBuf> body;
+};
+
+/**
+ * Error responses repeat endlessly under attack traffic; build the
+ * immutable message and body blob once per thread per distinct
+ * (status, reason, page, close) combination instead of per
+ * occurrence. Error pages are config objects that live for the
+ * process, which keys by pointer relies on.
+ */
+const CachedErrorResponse& getCachedErrorResponse(
+    unsigned statusCode,
+    const string& statusMessage,
+    const proxygen::HTTPErrorPage* errorPage,
+    bool forceConnectionClose) {
+  using namespace proxygen;
+  struct CacheTag {};
+  using Key = std::tuple<unsigned, string, const HTTPErrorPage*, bool>;
+  using Cache = std::map<Key, CachedErrorResponse>;
+  auto& cache = folly::SingletonThreadLocal<Cache, CacheTag>::get();
+  Key key{statusCode, statusMessage, errorPage, forceConnectionClose};
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  auto& entry = cache[key];
+  auto& response = entry.msg;
+  response.setHTTPVersion(1, 1);
+  response.setStatusCode(statusCode);
+  if (!statusMessage.empty()) {
+    response.setStatusMessage(statusMessage);
+  } else {
+    response.setStatusMessage(HTTPMessage::getDefaultReason(statusCode));
+  }
+  if (forceConnectionClose) {
+    response.getHeaders().add(HTTP_HEADER_CONNECTION, "close");
+  }
+  if (errorPage) {
+    HTTPErrorPage::Page page = errorPage->generate(
+        0, statusCode, statusMessage, nullptr, empty_string);
+    response.getHeaders().add(HTTP_HEADER_CONTENT_TYPE, page.contentType);
+    entry.body = std::move(page.content);
+  }
+  response.getHeaders().add(
+      HTTP_HEADER_CONTENT_LENGTH,
+      folly::to<string>(entry.body ? entry.body->computeChainDataLength()
+                                   : 0));
+  return entry;
+}
+
+} // anonymous namespace
+
 namespace proxygen {
 
 HTTPDirectResponseHandler::HTTPDirectResponseHandler(
@@ -45,32 +105,12 @@ void HTTPDirectResponseHandler::onHeadersComplete(
     std::unique_ptr<HTTPMessage> /*msg*/) noexcept {
   VLOG(4) << "processing request";
   headersSent_ = true;
-  HTTPMessage response;
-  std::unique_ptr<folly::IOBuf> responseBody;
-  response.setHTTPVersion(1, 1);
-  response.setStatusCode(statusCode_);
-  if (!statusMessage_.empty()) {
-    response.setStatusMessage(statusMessage_);
-  } else {
-    response.setStatusMessage(HTTPMessage::getDefaultReason(statusCode_));
-  }
-  if (forceConnectionClose_) {
-    response.getHeaders().add(HTTP_HEADER_CONNECTION, "close");
-  }
-  if (errorPage_) {
-    HTTPErrorPage::Page page = errorPage_->generate(
-        0, statusCode_, statusMessage_, nullptr, empty_string);
-    VLOG(4) << "sending error page with type " << page.contentType;
-    response.getHeaders().add(HTTP_HEADER_CONTENT_TYPE, page.contentType);
-    responseBody = std::move(page.content);
-  }
-  response.getHeaders().add(
-      HTTP_HEADER_CONTENT_LENGTH,
-      folly::to<string>(responseBody ? responseBody->computeChainDataLength()
-                                     : 0));
-  txn_->sendHeaders(response);
-  if (responseBody) {
-    txn_->sendBody(std::move(responseBody));
+  const auto& cached = getCachedErrorResponse(
+      statusCode_, statusMessage_, errorPage_, forceConnectionClose_);
+  txn_->sendHeaders(cached.msg);
+  if (cached.body) {
+    // the clone shares the prebuilt blob, no copy
+    txn_->sendBody(cached.body->clone());
   }
 }
 
@@ -111,6 +111,20 @@ class HTTPEvent {
     return std::move(headers_);
   }
 
+  /**
+   * Concatenate more body onto a BODY event at enqueue time, so a
+   * paused transaction accumulates one chained event per body run
+   * instead of one event per frame.
+   */
+  void appendBody(std::unique_ptr<folly::IOBuf> chain) {
+    CHECK(event_ == Type::BODY);
+    if (body_) {
+      body_->prependChain(std::move(chain));
+    } else {
+      body_ = std::move(chain);
+    }
+  }
+
   std::unique_ptr<folly::IOBuf> getBody() {
     return std::move(body_);
   }
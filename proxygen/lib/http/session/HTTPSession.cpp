@@ -8,6 +8,9 @@
 
 #include <proxygen/lib/http/session/HTTPSession.h>
 
+#include <proxygen/lib/services/RequestWorkerThread.h>
+#include <proxygen/lib/utils/ReadBufferPool.h>
+
 #include <chrono>
 #include <fizz/protocol/AsyncFizzBase.h>
 #include <folly/Conv.h>
@@ -20,6 +23,9 @@
 #include <proxygen/lib/http/codec/HTTP2Codec.h>
 #include <proxygen/lib/http/codec/HTTPChecks.h>
 #include <proxygen/lib/http/session/HTTPSessionController.h>
+#include <proxygen/lib/http/session/WorkerEgressScheduler.h>
+
+#include <array>
 #include <proxygen/lib/http/session/HTTPSessionStats.h>
 #include <wangle/acceptor/ConnectionManager.h>
 #include <wangle/acceptor/SocketOptions.h>
@@ -147,7 +153,8 @@ HTTPSession::HTTPSession(const WheelTimerInstance& timeout,
       inLoopCallback_(false),
       inResume_(false),
       pendingPause_(false),
-      writeBufSplit_(false) {
+      writeBufSplit_(false),
+      inInlineFlush_(false) {
   byteEventTracker_ = std::make_shared<ByteEventTracker>(this);
   initialReceiveWindow_ = receiveStreamWindowSize_ = receiveSessionWindowSize_ =
       codec_->getDefaultWindowSize();
@@ -270,6 +277,9 @@ void HTTPSession::setupCodec() {
 }
 
 HTTPSession::~HTTPSession() {
+  if (fairEgressScheduled_) {
+    WorkerEgressScheduler::getThreadScheduler().remove(this);
+  }
   VLOG(4) << *this << " closing";
 
   CHECK(transactions_.empty());
@@ -285,6 +295,16 @@ HTTPSession::~HTTPSession() {
     flowControlTimeout_.cancelTimeout();
   }
 
+  if (codec_->isRecyclable()) {
+    // hand the codec back to this worker's recycling pool instead of
+    // destroying it with the filter chain
+    auto worker = dynamic_cast<RequestWorkerThread*>(
+        WorkerThread::getCurrentWorkerThread());
+    if (worker) {
+      worker->recycleCodec(codec_.releaseDestination());
+    }
+  }
+
   runDestroyCallbacks();
 }
 
@@ -319,6 +339,62 @@ void HTTPSession::setByteEventTracker(
   }
 }
 
+void HTTPSession::maybeAutotuneFlowControl(size_t readSize) {
+  if (autotuneMaxRecvWindow_ == 0 || !connFlowControl_) {
+    return;
+  }
+  autotuneEpochBytes_ += readSize;
+  const auto now = getCurrentTime();
+  if (!timePointInitialized(autotuneEpochStart_)) {
+    autotuneEpochStart_ = now;
+    return;
+  }
+  if (now - autotuneEpochStart_ < autotuneRtt_) {
+    return;
+  }
+  // One RTT-sized epoch has elapsed: if the peer filled more than half
+  // the current window within it, the window (not the path) is the
+  // bottleneck, so double it toward the cap.
+  const auto capacity =
+      folly::to<uint64_t>(std::max(receiveSessionWindowSize_,
+                                   size_t(codec_->getDefaultWindowSize())));
+  if (autotuneEpochBytes_ * 2 >= capacity &&
+      capacity < autotuneMaxRecvWindow_) {
+    const auto newCapacity = folly::to<uint32_t>(
+        std::min<uint64_t>(capacity * 2, autotuneMaxRecvWindow_));
+    VLOG(4) << *this << " autotuning session recv window from " << capacity
+            << " to " << newCapacity
+            << " (epoch bytes=" << autotuneEpochBytes_
+            << " rtt=" << autotuneRtt_.count() << "us)";
+    receiveSessionWindowSize_ = newCapacity;
+    connFlowControl_->setReceiveWindowSize(writeBuf_, newCapacity);
+    // new streams get a proportionally larger window too
+    receiveStreamWindowSize_ =
+        std::min<size_t>(newCapacity, receiveStreamWindowSize_ * 2);
+    scheduleWrite();
+  }
+  // refresh the RTT estimate from the transport once per epoch
+  wangle::TransportInfo tinfo;
+  if (getCurrentTransportInfo(&tinfo) && tinfo.rtt.count() > 0) {
+    autotuneRtt_ = std::max(
+        std::chrono::microseconds(1000),
+        std::chrono::microseconds(tinfo.rtt));
+  }
+  autotuneEpochStart_ = now;
+  autotuneEpochBytes_ = 0;
+}
+
+void HTTPSession::setZeroCopyThreshold(uint64_t threshold) {
+  auto sock = sock_->getUnderlyingTransport<folly::AsyncSocket>();
+  if (threshold != 0 && (!sock || !sock->setZeroCopy(true))) {
+    // transport can't do zero-copy (TLS, mocks, unsupported kernel)
+    VLOG(4) << *this << " zero-copy egress not supported by transport";
+    zeroCopyThreshold_ = 0;
+    return;
+  }
+  zeroCopyThreshold_ = threshold;
+}
+
 void HTTPSession::setSessionStats(HTTPSessionStats* stats) {
   HTTPSessionBase::setSessionStats(stats);
   if (byteEventTracker_) {
@@ -437,10 +513,56 @@ bool HTTPSession::isBusy() const {
   return !transactions_.empty() || codec_->isBusy();
 }
 
+void HTTPSession::useStaticOnlyCompression() {
+  auto* egressSettings = codec_->getEgressSettings();
+  if (!egressSettings) {
+    return; // h1: no header table to negotiate away
+  }
+  // zero-size table on both halves: the SETTINGS advertisement stops
+  // the peer's encoder from indexing, and shrinking our own encoder
+  // emits a table-size-update in the first header block
+  egressSettings->setSetting(SettingsId::HEADER_TABLE_SIZE, 0);
+  codec_->setEgressHeaderTableSize(0);
+}
+
 void HTTPSession::notifyPendingEgress() noexcept {
   scheduleWrite();
 }
 
+void HTTPSession::notifyEgressUrgent() noexcept {
+  // A low-latency transaction finished generating its response; run
+  // the write batch now instead of at the end of the loop iteration,
+  // saving up to one iteration of queueing.  Bail to the scheduled
+  // write (already queued by notifyPendingEgress) whenever the fast
+  // path's assumptions don't hold:
+  //  - already inside the write machinery (reentrancy),
+  //  - a socket write is in flight or writes are paused (the flush
+  //    would buffer anyway),
+  //  - the pending bytes exceed the session's write budget (that's a
+  //    batch, not a latency-critical blip),
+  //  - too many consecutive inline flushes without a scheduled write
+  //    (starvation protection: other sessions on this loop deserve
+  //    their iteration).
+  constexpr uint8_t kMaxConsecutiveInlineFlushes = 16;
+  if (inLoopCallback_ || inInlineFlush_ || !writesUnpaused() ||
+      numActiveWrites_ > 0 ||
+      writeBuf_.chainLength() > writeBufLimit_ ||
+      consecutiveInlineFlushes_ >= kMaxConsecutiveInlineFlushes) {
+    return;
+  }
+  // keep the session alive across the flush: runLoopCallback's own
+  // guard releases on return, which could otherwise complete a
+  // delayed destruction before the flag write below
+  DestructorGuard g(this);
+  consecutiveInlineFlushes_++;
+  if (isLoopCallbackScheduled()) {
+    cancelLoopCallback();
+  }
+  inInlineFlush_ = true;
+  runLoopCallback();
+  inInlineFlush_ = false;
+}
+
 void HTTPSession::notifyPendingShutdown() {
   VLOG(4) << *this << " notified pending shutdown";
   drain();
@@ -508,6 +630,16 @@ bool HTTPSession::isDownstream() const {
 
 void HTTPSession::getReadBuffer(void** buf, size_t* bufSize) {
   FOLLY_SCOPED_TRACE_SECTION("HTTPSession - getReadBuffer");
+  const IOBuf* readBufTail =
+      readBuf_.front() ? readBuf_.front()->prev() : nullptr;
+  if (HTTPSessionBase::readBufferPoolingEnabled_ &&
+      (!readBufTail || readBufTail->tailroom() < kMinReadSize)) {
+    // draw a recycled buffer from the worker's pool, sized by this
+    // session's recent reads; preallocate below then hands out its
+    // tailroom without allocating
+    readBuf_.append(ReadBufferPool::obtain(
+        std::min(nextReadBufferSize_, HTTPSessionBase::maxReadBufferSize_)));
+  }
   pair<void*, uint32_t> readSpace =
       readBuf_.preallocate(kMinReadSize, HTTPSessionBase::maxReadBufferSize_);
   *buf = readSpace.first;
@@ -523,11 +655,28 @@ void HTTPSession::readDataAvailable(size_t readSize) noexcept {
   resetTimeout();
   readBuf_.postallocate(readSize);
 
+  maybeAutotuneFlowControl(readSize);
+
+  if (HTTPSessionBase::readBufferPoolingEnabled_) {
+    // adapt the next pooled buffer to this session's read sizes: grow
+    // when reads fill the buffer, shrink when they use under a quarter
+    if (readSize >= nextReadBufferSize_) {
+      nextReadBufferSize_ = std::min(nextReadBufferSize_ * 2,
+                                     HTTPSessionBase::maxReadBufferSize_);
+    } else if (readSize < nextReadBufferSize_ / 4 &&
+               nextReadBufferSize_ / 2 >= kMinReadSize) {
+      nextReadBufferSize_ /= 2;
+    }
+  }
+
   if (infoCallback_) {
     infoCallback_->onRead(*this, readSize);
   }
 
-  processReadData();
+  if (hibernated_) {
+    wakeFromHibernation();
+  }
+  scheduleProcessReadData();
 }
 
 bool HTTPSession::isBufferMovable() noexcept {
@@ -543,17 +692,45 @@ void HTTPSession::readBufferAvailable(std::unique_ptr<IOBuf> readBuf) noexcept {
   DestructorGuard dg(this);
   resetTimeout();
   readBuf_.append(std::move(readBuf));
+  maybeAutotuneFlowControl(readSize);
 
   if (infoCallback_) {
     infoCallback_->onRead(*this, readSize);
   }
 
+  if (hibernated_) {
+    wakeFromHibernation();
+  }
+  scheduleProcessReadData();
+}
+
+void HTTPSession::scheduleProcessReadData() {
+  if (!deferredIngressParsing_) {
+    processReadData();
+    return;
+  }
+  // parse in the loop-callback phase of this same iteration, after the
+  // loop has drained its ready reads
+  if (!deferredParseCallback_.isLoopCallbackScheduled()) {
+    sock_->getEventBase()->runInLoop(&deferredParseCallback_,
+                                     true /* thisIteration */);
+  }
+}
+
+void HTTPSession::runDeferredReadData() {
+  DestructorGuard dg(this);
   processReadData();
 }
 
 void HTTPSession::processReadData() {
   FOLLY_SCOPED_TRACE_SECTION("HTTPSession - processReadData");
 
+  if (codecSniffing_ && !sniffDecided_ && !readBuf_.empty()) {
+    if (!maybeSniffPlaintextProtocol()) {
+      return; // a matching preface prefix; wait for the rest
+    }
+  }
+
   // Pass the ingress data through the codec to parse it. The codec
   // will invoke various methods of the HTTPSession as callbacks.
   while (!ingressError_ && readsUnpaused() && !readBuf_.empty()) {
@@ -575,9 +752,105 @@ void HTTPSession::processReadData() {
   }
 }
 
+void HTTPSession::hibernate() {
+  if (hibernated_ || getNumStreams() > 0) {
+    return;
+  }
+  hibernated_ = true;
+  VLOG(4) << "hibernating idle " << *this;
+  // drop the encoder table; the size update rides the next header block
+  codec_->setEgressHeaderTableSize(0);
+  // tell the peer to stop indexing into our decoder table
+  HTTPSettings* settings = codec_->getEgressSettings();
+  if (settings) {
+    preHibernationDecoderTableSize_ = uint32_t(
+        settings->getSetting(SettingsId::HEADER_TABLE_SIZE, 4096));
+    settings->setSetting(SettingsId::HEADER_TABLE_SIZE, 0);
+    sendSettings();
+    scheduleWrite();
+  }
+}
+
+void HTTPSession::wakeFromHibernation() {
+  hibernated_ = false;
+  VLOG(4) << "waking " << *this;
+  // restore the encoder table to what the peer advertised, and our
+  // decoder advertisement to its pre-hibernation size; both tables
+  // re-grow lazily from here
+  codec_->setEgressHeaderTableSize(uint32_t(
+      codec_->getIngressSettings()
+          ? codec_->getIngressSettings()->getSetting(
+                SettingsId::HEADER_TABLE_SIZE, 4096)
+          : 4096));
+  HTTPSettings* settings = codec_->getEgressSettings();
+  if (settings) {
+    settings->setSetting(SettingsId::HEADER_TABLE_SIZE,
+                         preHibernationDecoderTableSize_);
+    sendSettings();
+    scheduleWrite();
+  }
+}
+
+bool HTTPSession::maybeSniffPlaintextProtocol() {
+  const auto& preface = http2::kConnectionPreface;
+  const size_t have =
+      std::min<size_t>(readBuf_.chainLength(), preface.size());
+  std::array<char, 32> head;
+  folly::io::Cursor cursor(readBuf_.front());
+  cursor.pull(head.data(), have);
+  if (memcmp(head.data(), preface.data(), have) != 0) {
+    // not the h2 preface: the h1 codec this session started with
+    // parses the buffered bytes as a request line
+    sniffDecided_ = true;
+    return true;
+  }
+  if (have < preface.size()) {
+    return false; // an h2 preface prefix so far; need more bytes
+  }
+  // full h2 connection preface: switch codecs and let the new codec
+  // consume the buffered bytes, preface included
+  sniffDecided_ = true;
+  VLOG(4) << "Sniffed h2 connection preface on " << *this;
+  auto h2Codec =
+      std::make_unique<HTTP2Codec>(TransportDirection::DOWNSTREAM);
+  // delay old codec deletion until the end of the event loop, as in
+  // the native-upgrade codec swap
+  auto oldCodec = codec_.setDestination(std::move(h2Codec));
+  sock_->getEventBase()->runInLoop([oldCodec = std::move(oldCodec)]() {});
+  onCodecChanged();
+  // undo the serial-codec stream limits the h1 setup applied
+  maxConcurrentIncomingStreams_ = kDefaultMaxConcurrentIncomingStreams;
+  maxConcurrentOutgoingStreamsRemote_ =
+      kDefaultMaxConcurrentOutgoingStreamsRemote;
+  setupCodec();
+  if (initialReceiveWindow_ == 0 || receiveStreamWindowSize_ == 0 ||
+      receiveSessionWindowSize_ == 0) {
+    initialReceiveWindow_ = receiveStreamWindowSize_ =
+        receiveSessionWindowSize_ = codec_->getDefaultWindowSize();
+  }
+  HTTPSettings* settings = codec_->getEgressSettings();
+  if (settings) {
+    settings->setSetting(SettingsId::INITIAL_WINDOW_SIZE,
+                         initialReceiveWindow_);
+  }
+  sendSettings();
+  if (connFlowControl_) {
+    connFlowControl_->setReceiveWindowSize(writeBuf_,
+                                           receiveSessionWindowSize_);
+  }
+  scheduleWrite();
+  return true;
+}
+
 void HTTPSession::readEOF() noexcept {
   DestructorGuard guard(this);
   VLOG(4) << "EOF on " << *this;
+  if (deferredIngressParsing_ &&
+      deferredParseCallback_.isLoopCallbackScheduled()) {
+    // parse what arrived before the EOF now, before ingress shuts down
+    deferredParseCallback_.cancelLoopCallback();
+    processReadData();
+  }
   // for SSL only: error without any bytes from the client might happen
   // due to client-side issues with the SSL cert. Note that it can also
   // happen if the client sends a SPDY frame header but no body.
@@ -597,6 +870,13 @@ void HTTPSession::readEOF() noexcept {
 void HTTPSession::readErr(const AsyncSocketException& ex) noexcept {
   DestructorGuard guard(this);
   VLOG(4) << "read error on " << *this << ": " << ex.what();
+  if (deferredIngressParsing_ &&
+      deferredParseCallback_.isLoopCallbackScheduled()) {
+    // parity with the immediate-parse path: bytes read before the
+    // error were parsed before the error was observed
+    deferredParseCallback_.cancelLoopCallback();
+    processReadData();
+  }
 
   auto sslEx = dynamic_cast<const folly::SSLException*>(&ex);
   if (infoCallback_ && sslEx) {
@@ -650,6 +930,11 @@ HTTPTransaction* HTTPSession::newPushedTransaction(
   }
   DestructorGuard dg(this);
   txn->setHandler(handler);
+  // a push shares its initiator's end-to-end budget
+  auto assocTxn = findTransaction(assocStreamId);
+  if (assocTxn && assocTxn->getDeadline()) {
+    txn->setDeadline(*assocTxn->getDeadline());
+  }
   setNewTransactionPauseState(txn);
   return txn;
 }
@@ -756,6 +1041,19 @@ void HTTPSession::onMessageBegin(HTTPCodec::StreamID streamID,
   if (!codec_->supportsParallelRequests() && getPipelineStreamCount() > 1) {
     // The previous transaction hasn't completed yet. Pause reads until
     // it completes; this requires pausing both transactions.
+    //
+    // This is also where out-of-order handler execution for pipelined
+    // requests would hook in: instead of pausing, later transactions
+    // would get handlers immediately and their egress would park until
+    // every predecessor finishes its EOM.  That needs more than a gate
+    // here - sendHeaders serializes into the shared write buffer the
+    // moment a handler responds, and queued body flows whenever the
+    // egress queue services the transaction, so ordered release
+    // requires either per-transaction staging of serialized egress or
+    // deferring serialization until the transaction becomes the head
+    // of line, plus a buffer budget to bound parked responses.  Until
+    // the egress path grows that seam, read-pausing is the ordering
+    // mechanism.
 
     // HTTP/1.1 pipeline is detected, and which is incompactible with
     // ByteEventTracker. Drain all the ByteEvents
@@ -1163,6 +1461,9 @@ void HTTPSession::onAbort(HTTPCodec::StreamID streamID, ErrorCode code) {
   ex.setProxygenError(kErrorStreamAbort);
   ex.setCodecStatusCode(code);
   DestructorGuard dg(this);
+  if (isDownstream() && txn->isPushed() && code == ErrorCode::CANCEL) {
+    recordPushCancelled(txn);
+  }
   if (isDownstream() && !txn->getAssocTxnId() && code == ErrorCode::CANCEL) {
     // Cancelling the assoc txn cancels all push txns
     for (auto it = txn->getPushedTransactions().begin();
@@ -1170,6 +1471,7 @@ void HTTPSession::onAbort(HTTPCodec::StreamID streamID, ErrorCode code) {
       auto pushTxn = findTransaction(*it);
       ++it;
       DCHECK(pushTxn != nullptr);
+      recordPushCancelled(pushTxn);
       pushTxn->onError(ex);
     }
   }
@@ -1183,6 +1485,33 @@ void HTTPSession::onAbort(HTTPCodec::StreamID streamID, ErrorCode code) {
   txn->onError(ex);
 }
 
+double HTTPSession::getEgressStallScore() const {
+  auto blockedUs = egressBlockedUs_;
+  if (timePointInitialized(egressBlockedSince_)) {
+    // include the stall in progress, the one that matters most
+    blockedUs += std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - egressBlockedSince_)
+                     .count();
+  }
+  if (blockedUs == 0) {
+    return 0;
+  }
+  // microseconds of blocked egress per delivered kilobyte
+  return double(blockedUs) / (double(bytesWritten_) / 1024 + 1);
+}
+
+void HTTPSession::recordPushCancelled(HTTPTransaction* pushTxn) {
+  if (!sessionStats_) {
+    return;
+  }
+  // bytes already committed to the transport bought nothing
+  sessionStats_->recordPushBytesWasted(
+      pushTxn->getEgressBodyBytesCommitted());
+  sessionStats_->recordPushCancelLatency(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          getCurrentTime() - pushTxn->getCreationTime()));
+}
+
 void HTTPSession::onGoaway(uint64_t lastGoodStreamID,
                            ErrorCode code,
                            std::unique_ptr<folly::IOBuf> debugData) {
@@ -1194,6 +1523,12 @@ void HTTPSession::onGoaway(uint64_t lastGoodStreamID,
   // Drain active transactions and prevent new transactions
   drain();
 
+  // surface the peer-initiated drain so pools can line up a
+  // replacement before the in-flight streams finish
+  if (infoCallback_) {
+    infoCallback_->onDrainStarted(*this);
+  }
+
   // We give the less-forceful onGoaway() first so that transactions have
   // a chance to do stat tracking before potentially getting a forceful
   // onError().
@@ -1227,18 +1562,24 @@ void HTTPSession::onGoaway(uint64_t lastGoodStreamID,
     // If we get a codec error, we will attempt to blame the first stream
     // by delivering a specific error to it and let the rest of the streams
     // get a normal unacknowledged stream error.
-    ProxygenError err = kErrorStreamUnacknowledged;
-    string debugInfo = (debugData) ? folly::to<string>(" with debug info: ",
-                                                       (char*)debugData->data())
-                                   : "";
+    HTTPErrorDescriptor descriptor;
+    descriptor.error = kErrorStreamUnacknowledged;
+    descriptor.streamID = *firstStream;
+    descriptor.hasCodecStatusCode = false; // blame only; no RST needed
+    std::array<char, sizeof(descriptor.detail)> detail;
+    auto detailLength = snprintf(detail.data(),
+                                 detail.size(),
+                                 "codec error: %s%s%.*s",
+                                 getErrorCodeString(code),
+                                 debugData ? ", debug: " : "",
+                                 debugData ? int(debugData->length()) : 0,
+                                 debugData ? (const char*)debugData->data()
+                                           : "");
+    descriptor.setDetail(folly::StringPiece(
+        detail.data(),
+        std::min(size_t(detailLength), detail.size() - 1)));
     HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS,
-                     folly::to<std::string>(getErrorString(err),
-                                            " on transaction id: ",
-                                            *firstStream,
-                                            " with codec error: ",
-                                            getErrorCodeString(code),
-                                            debugInfo));
-    ex.setProxygenError(err);
+                     descriptor);
     errorOnTransactionId(*firstStream, std::move(ex));
   } else if (firstStream != HTTPCodec::NoStream) {
     ids.push_back(*firstStream);
@@ -1928,6 +2269,11 @@ void HTTPSession::detach(HTTPTransaction* txn) noexcept {
   liveTransactions_--;
 
   if (txn->isPushed()) {
+    if (sessionStats_ && isDownstream() && !txn->isAborted()) {
+      // the push ran to completion: its bytes were (presumably) useful
+      sessionStats_->recordPushBytesConsumed(
+          txn->getEgressBodyBytesCommitted());
+    }
     auto assocTxn = findTransaction(*txn->getAssocTxnId());
     if (assocTxn) {
       assocTxn->removePushedTransaction(streamID);
@@ -1945,6 +2291,7 @@ void HTTPSession::detach(HTTPTransaction* txn) noexcept {
   if (lastTxn_ == txn) {
     lastTxn_ = nullptr;
   }
+  recycleTxnArena(txn->reclaimArena());
   transactions_.erase(it);
 
   if (transactions_.empty()) {
@@ -2080,7 +2427,9 @@ unique_ptr<IOBuf> HTTPSession::getNextToSend(
 
   // We always tack on at least one body packet to the current write buf
   // This ensures that a short HTTPS response will go out in a single SSL record
+  uint64_t bytesBeforeEgress = 0;
   while (!txnEgressQueue_.empty()) {
+    bytesBeforeEgress = writeBuf_.chainLength();
     uint32_t toSend = kWriteReadyMax;
     if (connFlowControl_) {
       if (connFlowControl_->getAvailableSend() == 0) {
@@ -2131,9 +2480,23 @@ unique_ptr<IOBuf> HTTPSession::getNextToSend(
     // it can be empty because of HTTPTransaction rate limiting.  We should
     // change rate limiting to clearPendingEgress while waiting.
     if (!writeBuf_.empty()) {
-      break;
+      if (!isEgressCoalescingEnabled()) {
+        break;
+      }
+      // Coalescing mode: keep aggregating egress from the queue into this
+      // single write until the flush threshold is reached, or an iteration
+      // makes no progress (e.g. every remaining transaction is rate
+      // limited), so the loop issues one write with one completion
+      // callback per loop iteration.
+      if (writeBuf_.chainLength() >= getWriteBufferLimit() ||
+          writeBuf_.chainLength() == bytesBeforeEgress) {
+        break;
+      }
     }
   }
+  // flush control frames the codec deferred during this loop
+  codec_->generateDeferredFrames(writeBuf_);
+
   *timestampTx = false;
   *timestampAck = false;
   if (byteEventTracker_) {
@@ -2165,12 +2528,78 @@ unique_ptr<IOBuf> HTTPSession::getNextToSend(
   return writeBuf_.move();
 }
 
+void HTTPSession::enableEgressPacing(uint64_t burstBytes) {
+  egressPacingEnabled_ = true;
+  pacingBurstBytes_ = std::max<uint64_t>(burstBytes, 1);
+  pacingTokens_ = double(pacingBurstBytes_);
+  pacingLastRefill_ = std::chrono::steady_clock::now();
+  pacingLastRateRefresh_ = pacingLastRefill_ -
+                           std::chrono::milliseconds(1000);
+}
+
+bool HTTPSession::pacingAllowsWrite() {
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed =
+      std::chrono::duration<double>(now - pacingLastRefill_).count();
+  pacingLastRefill_ = now;
+#if defined(__linux__) || defined(__FreeBSD__)
+  // the rate estimate moves on RTT timescales; refresh the TCP_INFO
+  // snapshot at most every 100ms to keep the syscall off hot batches
+  if (now - pacingLastRateRefresh_ >= std::chrono::milliseconds(100)) {
+    pacingLastRateRefresh_ = now;
+    wangle::TransportInfo tinfo;
+    if (getCurrentTransportInfo(&tinfo) && tinfo.tcpinfo.tcpi_rtt > 0 &&
+        tinfo.tcpinfo.tcpi_snd_cwnd > 0) {
+      double mss =
+          tinfo.tcpinfo.tcpi_snd_mss > 0 ? tinfo.tcpinfo.tcpi_snd_mss : 1460;
+      pacingRateBytesPerSec_ = double(tinfo.tcpinfo.tcpi_snd_cwnd) * mss *
+                               1e6 / double(tinfo.tcpinfo.tcpi_rtt);
+    }
+  }
+#endif
+  if (pacingRateBytesPerSec_ <= 0) {
+    // no estimate yet (or not a TCP transport): don't clock writes
+    return true;
+  }
+  pacingTokens_ = std::min(pacingTokens_ + elapsed * pacingRateBytesPerSec_,
+                           double(pacingBurstBytes_));
+  // writes proceed on a non-negative bucket and may drive it into debt,
+  // so small control writes pass immediately and bulk egress is clocked
+  return pacingTokens_ >= 0;
+}
+
+void HTTPSession::schedulePacingResume() {
+  if (pacingTimeout_.isScheduled()) {
+    return;
+  }
+  DCHECK_GT(pacingRateBytesPerSec_, 0);
+  auto delayMs = std::max<int64_t>(
+      1, int64_t((-pacingTokens_) * 1000 / pacingRateBytesPerSec_));
+  timeout_.scheduleTimeout(&pacingTimeout_,
+                           std::chrono::milliseconds(delayMs));
+}
+
 void HTTPSession::runLoopCallback() noexcept {
   // We schedule this callback to run at the end of an event
   // loop iteration if either of two conditions has happened:
   //   * The session has generated some egress data (see scheduleWrite())
   //   * Reads have become unpaused (see resumeReads())
+  //
+  // On write interest: every writeChain below lands in
+  // folly::AsyncSocket, which arms EV_WRITE when a write queues behind
+  // a full socket and disarms it once drained - the epoll_ctl pair per
+  // response burst kernel profiles show on small-response tiers.  A
+  // persistent edge-triggered registration (track readiness in user
+  // space, re-arm only after a real EAGAIN) has to live in AsyncSocket
+  // and its EventHandler, not here: the session never touches event
+  // registration, and the WriteSegment completion flow would carry the
+  // user-space readiness bit once folly exposes an edge-triggered
+  // write mode.  Until then the session layer has no lever on this.
   DestructorGuard dg(this);
+  if (!inInlineFlush_) {
+    // a scheduled batch ran; low-latency flushes may go inline again
+    consecutiveInlineFlushes_ = 0;
+  }
   inLoopCallback_ = true;
   auto scopeg = folly::makeGuard([this] {
     inLoopCallback_ = false;
@@ -2186,6 +2615,22 @@ void HTTPSession::runLoopCallback() noexcept {
   VLOG(5) << *this << " in loop callback";
 
   for (uint32_t i = 0; i < kMaxWritesPerLoop; ++i) {
+    if (iterationEgressBudget_ > 0 &&
+        bytesScheduled_ - iterationEgressStart_ >= iterationEgressBudget_) {
+      // this round's fair-share allowance is spent; the worker
+      // scheduler revisits us with fresh budget
+      break;
+    }
+    if (egressPrealloc_ > 0) {
+      // one contiguous block for this generation batch; appenders and
+      // packed payloads fill it instead of allocating per frame
+      writeBuf_.preallocate(egressPrealloc_, egressPrealloc_);
+    }
+    if (egressPacingEnabled_ && !pacingAllowsWrite()) {
+      VLOG(4) << *this << " egress paced, tokens=" << pacingTokens_;
+      schedulePacingResume();
+      break;
+    }
     bodyBytesPerWriteBuf_ = 0;
     if (isPrioritySampled()) {
       invokeOnAllTransactions([this] (HTTPTransaction* txn) {
@@ -2222,6 +2667,9 @@ void HTTPSession::runLoopCallback() noexcept {
     segment->setCork(cork);
     segment->setTimestampTX(timestampTx);
     segment->setEOR(timestampAck);
+    if (zeroCopyThreshold_ != 0 && len >= zeroCopyThreshold_) {
+      segment->setZeroCopy(true);
+    }
 
     pendingWrites_.push_back(*segment);
     if (!writeTimeout_.isScheduled()) {
@@ -2235,6 +2683,14 @@ void HTTPSession::runLoopCallback() noexcept {
             << " timestampTx:" << timestampTx
             << " timestampAck:" << timestampAck;
     bytesScheduled_ += len;
+    if (egressPacingEnabled_) {
+      pacingTokens_ -= double(len);
+    }
+    if (numActiveWrites_ == 1) {
+      // first outstanding write of this stretch: stall time accrues
+      // until the transport reports completion
+      egressBlockedSince_ = std::chrono::steady_clock::now();
+    }
     sock_->writeChain(segment, std::move(writeBuf), segment->getFlags());
     if (numActiveWrites_ > 0) {
       updateWriteCount();
@@ -2265,6 +2721,17 @@ void HTTPSession::scheduleWrite() {
   // the end of the current event loop iteration.  Writing in a
   // batch helps us packetize the network traffic more efficiently,
   // as well as saving a few system calls.
+  if (fairEgressWeight_ > 0) {
+    // fairness-managed: the worker scheduler hands out the iteration's
+    // write budget; register once and let it clock the flushes
+    if (!fairEgressScheduled_ &&
+        (writeBuf_.front() || !txnEgressQueue_.empty())) {
+      fairEgressScheduled_ = true;
+      WorkerEgressScheduler::getThreadScheduler().enqueue(
+          this, fairEgressWeight_, sock_->getEventBase());
+    }
+    return;
+  }
   if (!isLoopCallbackScheduled() &&
       (writeBuf_.front() || !txnEgressQueue_.empty())) {
     VLOG(5) << *this << " scheduling write callback";
@@ -2272,6 +2739,24 @@ void HTTPSession::scheduleWrite() {
   }
 }
 
+void HTTPSession::enableWorkerFairEgress(uint8_t weight) {
+  fairEgressWeight_ = weight;
+}
+
+uint64_t HTTPSession::flushBudgeted(uint64_t maxBytes,
+                                    bool& morePending) noexcept {
+  DestructorGuard g(this);
+  iterationEgressBudget_ = std::max<uint64_t>(maxBytes, 1);
+  iterationEgressStart_ = bytesScheduled_;
+  runLoopCallback();
+  uint64_t written = bytesScheduled_ - iterationEgressStart_;
+  iterationEgressBudget_ = 0;
+  morePending = !getDestroyPending() &&
+                (writeBuf_.front() != nullptr || !txnEgressQueue_.empty());
+  fairEgressScheduled_ = morePending;
+  return written;
+}
+
 void HTTPSession::updateWriteCount() {
   if (numActiveWrites_ > 0 && writesUnpaused()) {
     // Exceeded limit. Pause reading on the incoming stream.
@@ -2620,6 +3105,14 @@ HTTPTransaction* HTTPSession::createTransaction(
 
   HTTPTransaction* txn = &matchPair.first->second;
 
+  if (auto arena = obtainTxnArena()) {
+    txn->setArena(std::move(arena));
+  }
+
+  if (txnTimeoutBatcher_) {
+    txn->setTimeoutBatcher(txnTimeoutBatcher_.get());
+  }
+
   if (isPrioritySampled()) {
     txn->setPrioritySampled(true /* sampled */);
   }
@@ -2731,6 +3224,13 @@ void HTTPSession::scheduleResetDirectErrorHandling() {
 
 void HTTPSession::onWriteSuccess(uint64_t bytesWritten) {
   DestructorGuard dg(this);
+  if (timePointInitialized(egressBlockedSince_)) {
+    egressBlockedUs_ += std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() -
+                            egressBlockedSince_)
+                            .count();
+    egressBlockedSince_ = {};
+  }
   bytesWritten_ += bytesWritten;
   transportInfo_.totalBytes += bytesWritten;
   CHECK(writeTimeout_.isScheduled());
@@ -2919,17 +3419,15 @@ void HTTPSession::errorOnTransactionIds(
     const std::vector<HTTPCodec::StreamID>& ids,
     ProxygenError err,
     const std::string& errorMsg) {
-  std::string extraErrorMsg;
-  if (!errorMsg.empty()) {
-    extraErrorMsg = folly::to<std::string>(". ", errorMsg);
-  }
-
+  // flood path: one POD descriptor per stream, with the message
+  // string materialized only if a handler actually logs it
+  HTTPErrorDescriptor descriptor;
+  descriptor.error = err;
+  descriptor.setDetail(errorMsg);
   for (auto id : ids) {
-    HTTPException ex(
-        HTTPException::Direction::INGRESS_AND_EGRESS,
-        folly::to<std::string>(
-            getErrorString(err), " on transaction id: ", id, extraErrorMsg));
-    ex.setProxygenError(err);
+    descriptor.streamID = id;
+    HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS,
+                     descriptor);
     errorOnTransactionId(id, std::move(ex));
   }
 }
@@ -27,6 +27,7 @@
 #include <proxygen/lib/http/session/HTTPSessionBase.h>
 #include <proxygen/lib/http/session/HTTPTransaction.h>
 #include <proxygen/lib/http/session/SecondaryAuthManagerBase.h>
+#include <proxygen/lib/utils/ThreadLocalPoolAllocator.h>
 #include <proxygen/lib/utils/WheelTimerInstance.h>
 #include <queue>
 #include <set>
@@ -124,6 +125,8 @@ class HTTPSession
    */
   void setEgressSettings(const SettingsList& inSettings) override;
 
+  void useStaticOnlyCompression() override;
+
   bool getHTTP2PrioritiesEnabled() const override {
     return HTTPSessionBase::getHTTP2PrioritiesEnabled();
   }
@@ -132,6 +135,154 @@ class HTTPSession
     HTTPSessionBase::setHTTP2PrioritiesEnabled(enabled);
   }
 
+  void setIngressMemoryBackpressure(bool paused) override {
+    // bypass the flow-control guards in pauseReads/resumeReads: memory
+    // backpressure must stick for parallel codecs even when the ingress
+    // limit hasn't been hit
+    if (paused) {
+      codec_->setParserPaused(true);
+      if (readsUnpaused()) {
+        pauseReadsImpl();
+      }
+    } else if (readsPaused() &&
+               !(codec_->supportsParallelRequests() &&
+                 ingressLimitExceeded())) {
+      resumeReadsImpl();
+    }
+  }
+
+  /**
+   * Autotune the session (and new streams') receive windows from the
+   * measured bandwidth-delay product: when the peer delivers more than
+   * half the current window within one RTT, the window doubles, up to
+   * maxSessionRecvWindow. Call after setFlowControl; requires
+   * session-level flow control (h2/h3-style codecs).
+   */
+  void enableFlowControlAutotuning(uint32_t maxSessionRecvWindow) {
+    autotuneMaxRecvWindow_ = maxSessionRecvWindow;
+  }
+
+  /**
+   * Send writes of at least threshold bytes with MSG_ZEROCOPY, pinning
+   * the egress IOBufs instead of copying them into the kernel. 0 (the
+   * default) disables it. Since the transport defers writeSuccess until
+   * the kernel's zerocopy completion notification, ByteEventTracker
+   * delivery events automatically track actual completions for these
+   * writes. No-op when the underlying transport does not support
+   * zero-copy (e.g. TLS).
+   */
+  void setZeroCopyThreshold(uint64_t threshold);
+
+  /**
+   * Clock egress out at the transport's estimated delivery rate
+   * (cwnd/RTT from TCP_INFO) instead of bursting as fast as flow
+   * control and the socket buffer allow, keeping bufferbloat-prone
+   * last-mile queues shallow.  A token bucket with the given burst
+   * budget gates the write loop: writes proceed while the bucket is
+   * non-negative, so control frames and small responses go out
+   * immediately and only sustained bulk egress is paced.  No-op until
+   * a rate estimate is available (and thus for non-TCP transports).
+   */
+  void enableEgressPacing(uint64_t burstBytes = 65536);
+
+  /**
+   * Register this session with the worker's deficit-round-robin
+   * egress scheduler (WorkerEgressScheduler): instead of flushing
+   * independently at end of loop, the session receives a per-round
+   * byte allowance scaled by weight, bounding its share of the
+   * iteration's socket writes so one heavy session can't starve its
+   * neighbors.  Weight is the priority class (1 = baseline).
+   */
+  void enableWorkerFairEgress(uint8_t weight);
+
+  /**
+   * Scheduler entry point: generate and write up to maxBytes now.
+   * Returns bytes handed to the socket layer; morePending reports
+   * leftover egress (false when the session is being torn down).
+   */
+  uint64_t flushBudgeted(uint64_t maxBytes, bool& morePending) noexcept;
+
+  /**
+   * Scheduler-side: a pass made no progress on this session (flow
+   * control, pacing, socket busy), so it leaves the ready queue; the
+   * egress event that unblocks it re-enqueues via scheduleWrite.
+   */
+  void parkFairEgress() noexcept {
+    fairEgressScheduled_ = false;
+  }
+
+  double getEgressStallScore() const override;
+
+  /**
+   * Two-phase ingress for high session interleave: socket reads only
+   * append to the session's ingress buffer, and codec parsing runs
+   * once per loop iteration from a loop callback after the loop's
+   * reads have been drained.  Back-to-back reads for one session parse
+   * in a single codec pass, and parsing across sessions clusters into
+   * one phase instead of interleaving with read events - friendlier to
+   * the parser's i-cache and branch predictors.  Off by default;
+   * ordering and flow control semantics are unchanged (parsing still
+   * happens within the same loop iteration as the read).
+   */
+  void setDeferredIngressParsing(bool enabled) {
+    deferredIngressParsing_ = enabled;
+  }
+
+  /**
+   * Reserve this much contiguous tailroom in the egress buffer before
+   * each codec generation batch, sized to the socket/TLS record
+   * budget: the codecs' appenders then fill one block instead of
+   * allocating per frame, and with the codec's small-payload packing
+   * a median response serializes into a single contiguous buffer.
+   * 0 (default) keeps demand-driven growth.
+   */
+  void setEgressBufferPreallocation(uint32_t bytes) {
+    egressPrealloc_ = bytes;
+  }
+
+  /**
+   * Serve h1 and h2c on one plaintext port without the upgrade dance:
+   * the first bytes of the connection are inspected in the session's
+   * existing read buffer (no extra syscall, no copy) and the codec is
+   * switched to HTTP2Codec when they are the h2 connection preface -
+   * any mismatching byte settles on the h1 codec immediately, so h1
+   * first-byte latency is untouched.  The buffered bytes then feed the
+   * selected codec unmodified.  Enable right after constructing a
+   * downstream session whose initial codec is HTTP/1.x.
+   */
+  void enablePlaintextProtocolSniffing() {
+    CHECK(isDownstream());
+    codecSniffing_ = true;
+  }
+
+  /**
+   * Idle-session hibernation: release the per-connection state that
+   * dominates an idle keep-alive session's footprint.  The egress
+   * compression table is dropped (in-band HPACK size update, so always
+   * protocol-safe) and a zero decoder table is advertised via SETTINGS
+   * so the peer stops indexing into ours; both re-grow lazily after
+   * wake, which happens automatically on the next read event and
+   * restores the advertised sizes.  Call from idle-timeout policy
+   * (e.g. a ConnectionManager callback) on sessions with no streams;
+   * a session with active streams ignores the call.  Compression
+   * re-warms on the first requests after wake - the price of tens of
+   * kilobytes back per idle connection.
+   */
+  void hibernate();
+
+  /**
+   * Share a single coarse idle timer among all of this session's
+   * transactions: refreshes become hash-map updates and per-transaction
+   * deadlines are checked lazily when the coarse timer fires, at the cost
+   * of expiring up to one default-timeout tick late.
+   */
+  void enableTransactionTimeoutBatching() {
+    if (!txnTimeoutBatcher_) {
+      txnTimeoutBatcher_ = std::make_unique<TransactionTimeoutBatcher>(
+          timeout_.getWheelTimer(), timeout_.getDefaultTimeout());
+    }
+  }
+
   const folly::SocketAddress& getLocalAddress() const noexcept override {
     return HTTPSessionBase::getLocalAddress();
   }
@@ -469,8 +620,12 @@ class HTTPSession
   size_t sendWindowUpdate(HTTPTransaction* txn,
                           uint32_t bytes) noexcept override;
   void notifyPendingEgress() noexcept override;
+  void notifyEgressUrgent() noexcept override;
   void notifyIngressBodyProcessed(uint32_t bytes) noexcept override;
   void notifyEgressBodyBuffered(int64_t bytes) noexcept override;
+  uint64_t getSessionBufferedEgressBytes() const noexcept override {
+    return pendingWriteSize_;
+  }
   HTTPTransaction* newPushedTransaction(
       HTTPCodec::StreamID assocStreamId,
       HTTPTransaction::PushHandler* handler,
@@ -725,7 +880,24 @@ class HTTPSession
   /** Chain of ingress IOBufs */
   folly::IOBufQueue readBuf_{folly::IOBufQueue::cacheChainLength()};
 
-  std::unordered_map<HTTPCodec::StreamID, HTTPTransaction> transactions_;
+  /**
+   * Shared coarse idle timer for all transactions; must be declared before
+   * transactions_ so detaching transactions can still deregister.
+   */
+  std::unique_ptr<TransactionTimeoutBatcher> txnTimeoutBatcher_;
+
+  // node allocations recycle through a per-worker pool: serial
+  // request/response cycles on pooled upstream sessions stop paying a
+  // malloc/free per transaction (the egress queue node and byte events
+  // are pooled likewise)
+  std::unordered_map<
+      HTTPCodec::StreamID,
+      HTTPTransaction,
+      std::hash<HTTPCodec::StreamID>,
+      std::equal_to<HTTPCodec::StreamID>,
+      ThreadLocalPoolAllocator<
+          std::pair<const HTTPCodec::StreamID, HTTPTransaction>>>
+      transactions_;
 
   /** Count of transactions awaiting input */
   uint32_t liveTransactions_{0};
@@ -734,6 +906,16 @@ class HTTPSession
 
   WheelTimerInstance timeout_;
 
+  /**
+   * Writes at least this large go out with MSG_ZEROCOPY; 0 disables.
+   */
+  uint64_t zeroCopyThreshold_{0};
+
+  /**
+   * Adaptive size for the next pooled ingress read buffer.
+   */
+  uint32_t nextReadBufferSize_{4000};
+
   /**
    * Number of writes submitted to the transport for which we haven't yet
    * received completion or failure callbacks.
@@ -923,6 +1105,14 @@ class HTTPSession
       }
     }
 
+    void setZeroCopy(bool zeroCopy) {
+      if (zeroCopy) {
+        flags_ = flags_ | folly::WriteFlags::WRITE_MSG_ZEROCOPY;
+      } else {
+        unSet(flags_, folly::WriteFlags::WRITE_MSG_ZEROCOPY);
+      }
+    }
+
     /**
      * Clear the session. This is used if the session
      * does not want to receive future notification about this segment.
@@ -1044,11 +1234,107 @@ class HTTPSession
    */
   uint64_t egressBytesLimit_{0};
 
+  /**
+   * Inline flushes performed since the last scheduled (loop-batched)
+   * write; bounds how long low-latency transactions can keep the
+   * session writing from caller context before the batched path runs
+   * again.  See notifyEgressUrgent.
+   */
+  uint8_t consecutiveInlineFlushes_{0};
+
+  // worker-fair egress scheduling (see enableWorkerFairEgress);
+  // weight 0 = disabled, scheduled flag = queued at the scheduler
+  uint8_t fairEgressWeight_{0};
+  bool fairEgressScheduled_{false};
+  uint64_t iterationEgressBudget_{0};
+  uint64_t iterationEgressStart_{0};
+
   // Flow control settings
   size_t initialReceiveWindow_{0};
   size_t receiveStreamWindowSize_{0};
   size_t receiveSessionWindowSize_{0};
 
+  // flow-control autotuning state (0 == disabled)
+  uint32_t autotuneMaxRecvWindow_{0};
+  uint64_t autotuneEpochBytes_{0};
+  TimePoint autotuneEpochStart_{};
+  std::chrono::microseconds autotuneRtt_{std::chrono::milliseconds(50)};
+
+  void maybeAutotuneFlowControl(size_t readSize);
+
+  // egress pacing state; see enableEgressPacing
+  bool egressPacingEnabled_{false};
+  uint64_t pacingBurstBytes_{0};
+  double pacingTokens_{0};
+  double pacingRateBytesPerSec_{0};
+  std::chrono::steady_clock::time_point pacingLastRefill_;
+  std::chrono::steady_clock::time_point pacingLastRateRefresh_;
+
+  bool pacingAllowsWrite();
+  void schedulePacingResume();
+
+  // push usefulness accounting on a client CANCEL
+  void recordPushCancelled(HTTPTransaction* pushTxn);
+
+  // egress stall scoring: time writes sat in the transport without
+  // completing, accumulated from the write-loop timestamps
+  std::chrono::steady_clock::time_point egressBlockedSince_{};
+  uint64_t egressBlockedUs_{0};
+
+  // deferred ingress parsing; see setDeferredIngressParsing
+  bool deferredIngressParsing_{false};
+
+  // egress buffer preallocation; see setEgressBufferPreallocation
+  uint32_t egressPrealloc_{0};
+
+  // plaintext protocol sniffing; see enablePlaintextProtocolSniffing
+  bool codecSniffing_{false};
+  bool sniffDecided_{false};
+
+  // idle hibernation; see hibernate()
+  bool hibernated_{false};
+  uint32_t preHibernationDecoderTableSize_{4096};
+
+  void wakeFromHibernation();
+
+  // returns false while more bytes are needed to decide
+  bool maybeSniffPlaintextProtocol();
+
+  class DeferredParseCallback : public folly::EventBase::LoopCallback {
+   public:
+    explicit DeferredParseCallback(HTTPSession* session) : session_(session) {
+    }
+
+    void runLoopCallback() noexcept override {
+      session_->runDeferredReadData();
+    }
+
+   private:
+    HTTPSession* session_;
+  };
+  DeferredParseCallback deferredParseCallback_{this};
+
+  void scheduleProcessReadData();
+  void runDeferredReadData();
+
+  void pacingTimeoutExpired() noexcept {
+    scheduleWrite();
+  }
+
+  class PacingTimeout : public folly::HHWheelTimer::Callback {
+   public:
+    explicit PacingTimeout(HTTPSession* session) : session_(session) {
+    }
+
+    void timeoutExpired() noexcept override {
+      session_->pacingTimeoutExpired();
+    }
+
+   private:
+    HTTPSession* session_;
+  };
+  PacingTimeout pacingTimeout_{this};
+
   class ShutdownTransportCallback : public folly::EventBase::LoopCallback {
    public:
     explicit ShutdownTransportCallback(HTTPSession* session)
@@ -1135,6 +1421,8 @@ class HTTPSession
   bool inResume_ : 1;
   bool pendingPause_ : 1;
   bool writeBufSplit_ : 1;
+  // an inline (EOM-triggered) flush is running runLoopCallback
+  bool inInlineFlush_ : 1;
 };
 
 } // namespace proxygen
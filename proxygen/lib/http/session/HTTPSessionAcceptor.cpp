@@ -109,6 +109,19 @@ void HTTPSessionAcceptor::onNewConnection(
   }
   session->setEgressSettings(accConfig_.egressSettings);
 
+  if (staticCompressionPolicy_) {
+    static const std::string kNoSni;
+    const std::string& sni =
+        tinfo.sslServerName ? *tinfo.sslServerName : kNoSni;
+    if (staticCompressionPolicy_(sni, *peerAddress)) {
+      // static-only compression profile: advertise a zero-size header
+      // table (the peer's encoder must not index) and shrink our own
+      // encoder table to zero, so neither side builds a dynamic table
+      // this 1-2 request connection would never amortize
+      session->useStaticOnlyCompression();
+    }
+  }
+
   // set HTTP2 priorities flag on session object
   auto HTTP2PrioritiesEnabled = getHttp2PrioritiesEnabled();
   session->setHTTP2PrioritiesEnabled(HTTP2PrioritiesEnabled);
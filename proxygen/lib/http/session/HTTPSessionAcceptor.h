@@ -12,6 +12,7 @@
 #include <proxygen/lib/http/codec/HTTPCodecFactory.h>
 #include <proxygen/lib/http/codec/SPDYCodec.h>
 #include <proxygen/lib/http/session/HTTPDownstreamSession.h>
+#include <proxygen/lib/http/session/EarlyDataGateHandler.h>
 #include <proxygen/lib/http/session/HTTPErrorPage.h>
 #include <proxygen/lib/http/session/SimpleController.h>
 #include <proxygen/lib/services/HTTPAcceptor.h>
@@ -47,6 +48,36 @@ class HTTPSessionAcceptor
     return defaultErrorPage_.get();
   }
 
+  /**
+   * Gate requests that arrive in TLS/QUIC early data: when set, every
+   * request on a not-yet-replay-safe transport is classified by the
+   * policy (process now, buffer until the handshake completes, or
+   * answer 425 Too Early); see EarlyDataGateHandler. Pass
+   * EarlyDataGateHandler::defaultPolicy for GET/HEAD-only processing.
+   */
+  void setEarlyDataPolicy(EarlyDataGateHandler::Policy policy) {
+    earlyDataPolicy_ = std::move(policy);
+  }
+
+  const EarlyDataGateHandler::Policy* getEarlyDataPolicy() const {
+    return earlyDataPolicy_ ? &earlyDataPolicy_ : nullptr;
+  }
+
+  /**
+   * Per-connection static-only compression profile: when the policy
+   * returns true (judged by SNI and peer address - e.g. mobile VIPs
+   * whose clients make one or two requests per connection), the
+   * session advertises SETTINGS_HEADER_TABLE_SIZE=0 and shrinks its
+   * own HPACK encoder table to zero, so neither side allocates or
+   * maintains a dynamic table (the encoder takes its static-only fast
+   * path).  Connections the policy declines negotiate as before.
+   */
+  using StaticCompressionPolicy = folly::Function<bool(
+      const std::string& sni, const folly::SocketAddress& peer) const>;
+  void setStaticCompressionPolicy(StaticCompressionPolicy policy) {
+    staticCompressionPolicy_ = std::move(policy);
+  }
+
   /**
    * Set an alternate error page generator to use for internal clients.
    */
@@ -150,6 +181,12 @@ class HTTPSessionAcceptor
   /** General-case error page generator */
   std::unique_ptr<HTTPErrorPage> defaultErrorPage_;
 
+  // optional early-data gating policy; empty means no gating
+  EarlyDataGateHandler::Policy earlyDataPolicy_;
+
+  // optional static-only compression policy; empty means never
+  StaticCompressionPolicy staticCompressionPolicy_;
+
   /** Generator of more detailed error pages for internal clients */
   std::unique_ptr<HTTPErrorPage> diagnosticErrorPage_;
 
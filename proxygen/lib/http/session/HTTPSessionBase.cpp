@@ -7,6 +7,7 @@
  */
 
 #include <proxygen/lib/http/session/HTTPSessionBase.h>
+#include <proxygen/lib/http/session/WorkerSessionRegistry.h>
 
 #include <proxygen/lib/http/codec/HTTP2Codec.h>
 #include <proxygen/lib/http/session/ByteEventTracker.h>
@@ -19,6 +20,7 @@ using wangle::TransportInfo;
 namespace proxygen {
 uint32_t HTTPSessionBase::kDefaultReadBufLimit = 65536;
 uint32_t HTTPSessionBase::maxReadBufferSize_ = 4000;
+bool HTTPSessionBase::readBufferPoolingEnabled_ = false;
 uint32_t HTTPSessionBase::egressBodySizeLimit_ = 4096;
 uint32_t HTTPSessionBase::kDefaultWriteBufLimit = 65536;
 
@@ -48,6 +50,11 @@ HTTPSessionBase::HTTPSessionBase(const SocketAddress& localAddr,
   peerAddr_.tryConvertToIPv4();
 
   setController(controller);
+  WorkerSessionRegistry::getThreadRegistry().add(this);
+}
+
+HTTPSessionBase::~HTTPSessionBase() {
+  WorkerSessionRegistry::getThreadRegistry().remove(this);
 }
 
 void HTTPSessionBase::runDestroyCallbacks() {
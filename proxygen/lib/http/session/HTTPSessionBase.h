@@ -99,6 +99,14 @@ class HTTPSessionBase : public wangle::ManagedConnection {
     }
     virtual void onSettingsAck(const HTTPSessionBase&) {
     }
+    /**
+     * The peer signalled graceful shutdown (GOAWAY or equivalent):
+     * in-flight transactions finish but no new ones may be issued.
+     * Pools and routers use this to start replacements and shift
+     * traffic before the session runs dry.
+     */
+    virtual void onDrainStarted(const HTTPSessionBase&) {
+    }
   };
 
   HTTPSessionBase(const folly::SocketAddress& localAddr,
@@ -110,8 +118,7 @@ class HTTPSessionBase : public wangle::ManagedConnection {
                   const WheelTimerInstance& timeout,
                   HTTPCodec::StreamID rootNodeId);
 
-  virtual ~HTTPSessionBase() {
-  }
+  virtual ~HTTPSessionBase();
 
   /**
    * Set the read buffer limit to be used for all new HTTPSessionBase objects.
@@ -125,6 +132,15 @@ class HTTPSessionBase : public wangle::ManagedConnection {
     maxReadBufferSize_ = bytes;
   }
 
+  /**
+   * Draw socket read buffers from a per-worker recycled pool, sized
+   * adaptively from each session's recent read sizes, instead of
+   * allocating fresh IOBufs per read.
+   */
+  static void setReadBufferPoolingEnabled(bool enabled) {
+    readBufferPoolingEnabled_ = enabled;
+  }
+
   /**
    * Set the maximum egress body size for any outbound body bytes per loop,
    * when there are > 1 transactions.
@@ -282,6 +298,68 @@ class HTTPSessionBase : public wangle::ManagedConnection {
     readBufLimit_ = limit;
   }
 
+  /**
+   * Cheap accounting of the buffered bytes a session currently holds.
+   */
+  struct MemoryFootprint {
+    uint64_t egressBufferedBytes{0};
+    uint64_t ingressBufferedBytes{0};
+    uint64_t headerTableBytes{0};
+
+    uint64_t total() const {
+      return egressBufferedBytes + ingressBufferedBytes + headerTableBytes;
+    }
+  };
+
+  /**
+   * Snapshot this session's buffered egress, pending ingress and header
+   * table footprint from counters the session already maintains; no
+   * traversal of buffers is performed.
+   */
+  MemoryFootprint getMemoryFootprint() const {
+    MemoryFootprint footprint;
+    footprint.egressBufferedBytes = pendingWriteSize_;
+    footprint.ingressBufferedBytes = pendingReadSize_;
+    auto compression = codec_->getCompressionInfo();
+    footprint.headerTableBytes = compression.egress.bytesStored_ +
+        compression.ingress.bytesStored_;
+    return footprint;
+  }
+
+  /**
+   * Pause or resume socket reads in response to worker-level memory
+   * pressure (see SessionMemoryGovernor). Default is a no-op; session
+   * types that can shed ingress map it onto their read-pause machinery.
+   */
+  virtual void setIngressMemoryBackpressure(bool /*paused*/) {
+  }
+
+  /**
+   * Enable coalescing egress mode: the write loop keeps aggregating all
+   * transactions' egress for the loop iteration into a single write (with
+   * one completion callback) until the flush threshold configured via
+   * setWriteBufferLimit is reached, instead of flushing after the first
+   * round of egress. Cuts syscalls and callback overhead when many
+   * streams produce small frames.
+   */
+  void setEgressCoalescing(bool enabled) {
+    egressCoalescing_ = enabled;
+  }
+
+  bool isEgressCoalescingEnabled() const {
+    return egressCoalescing_;
+  }
+
+  /**
+   * Enable recycling of per-transaction arenas: up to maxFreeArenas arenas
+   * are kept by the session and handed to new transactions instead of
+   * letting each transaction allocate its own. 0 (the default) disables
+   * pooling.
+   */
+  void setTxnArenaPoolSize(size_t maxFreeArenas) {
+    txnArenaPoolSize_ = maxFreeArenas;
+  }
+
   /**
    * Start reading from the transport and send any introductory messages
    * to the remote side. This function must be called once per session to
@@ -359,6 +437,17 @@ class HTTPSessionBase : public wangle::ManagedConnection {
   virtual bool getCurrentTransportInfoWithoutUpdate(
       wangle::TransportInfo* tinfo) const = 0;
 
+  /**
+   * Slow-client signal: microseconds this session has spent with
+   * egress blocked in the transport, per delivered kilobyte.  A slow
+   * but steadily consuming mobile link scores low (blocked time is
+   * amortized over bytes); a slow-loris that accepts almost nothing
+   * scores high.  0 when the transport keeps up or nothing was sent.
+   */
+  virtual double getEgressStallScore() const {
+    return 0;
+  }
+
   virtual void setHeaderCodecStats(HeaderCodec::Stats* stats) = 0;
 
   virtual void enableDoubleGoawayDrain() = 0;
@@ -466,6 +555,16 @@ class HTTPSessionBase : public wangle::ManagedConnection {
    */
   virtual void drain() = 0;
 
+  /**
+   * Switch this connection to the static-only compression profile:
+   * advertise a zero-size header table and shrink the egress encoder
+   * table to zero, so neither side allocates or maintains dynamic
+   * state.  Call before the preface is generated.  Default no-op for
+   * transports without a negotiable header table.
+   */
+  virtual void useStaticOnlyCompression() {
+  }
+
   virtual folly::Optional<const HTTPMessage::HTTPPriority> getHTTPPriority(
       uint8_t level) = 0;
 
@@ -505,7 +604,8 @@ class HTTPSessionBase : public wangle::ManagedConnection {
   bool notifyBodyProcessed(uint32_t bytes);
 
   void setLatestActive() {
-    latestActive_ = getCurrentTime();
+    // iteration granularity is plenty for activity tracking
+    latestActive_ = getCachedNow();
   }
 
   bool ingressLimitExceeded() const {
@@ -518,6 +618,35 @@ class HTTPSessionBase : public wangle::ManagedConnection {
     }
   }
 
+  /**
+   * Take an arena from the pool for a new transaction; returns nullptr
+   * when pooling is disabled or the pool is empty (the transaction will
+   * then create its own arena on demand).
+   */
+  std::unique_ptr<RecyclableArena> obtainTxnArena() {
+    if (freeTxnArenas_.empty()) {
+      if (txnArenaPoolSize_ > 0) {
+        return std::make_unique<RecyclableArena>();
+      }
+      return nullptr;
+    }
+    auto arena = std::move(freeTxnArenas_.back());
+    freeTxnArenas_.pop_back();
+    return arena;
+  }
+
+  /**
+   * Return a detached transaction's arena to the pool, releasing all of
+   * its allocations wholesale.
+   */
+  void recycleTxnArena(std::unique_ptr<RecyclableArena> arena) {
+    if (!arena || freeTxnArenas_.size() >= txnArenaPoolSize_) {
+      return;
+    }
+    arena->reset();
+    freeTxnArenas_.push_back(std::move(arena));
+  }
+
   void incrementSeqNo() {
     ++transactionSeqNo_;
   }
@@ -586,6 +715,11 @@ class HTTPSessionBase : public wangle::ManagedConnection {
    */
   static uint32_t maxReadBufferSize_;
 
+  /**
+   * Whether socket reads draw recycled buffers from the worker's pool.
+   */
+  static bool readBufferPoolingEnabled_;
+
   /**
    * Maximum number of bytes that can be buffered across all transactions before
    * this session will start applying backpressure to its transactions.
@@ -631,6 +765,13 @@ class HTTPSessionBase : public wangle::ManagedConnection {
   /** Transaction sequence number */
   uint32_t transactionSeqNo_{0};
 
+  /** Recycled per-transaction arenas, bounded by txnArenaPoolSize_ */
+  std::vector<std::unique_ptr<RecyclableArena>> freeTxnArenas_;
+  size_t txnArenaPoolSize_{0};
+
+  /** Whether the write loop coalesces egress up to the write buffer limit */
+  bool egressCoalescing_{false};
+
   /**
    * The root cause reason this connection was closed.
    */
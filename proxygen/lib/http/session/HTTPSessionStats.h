@@ -28,6 +28,27 @@ class HTTPSessionStats : public TTLBAStats {
   }
   virtual void recordTransactionStalled() noexcept = 0;
   virtual void recordSessionStalled() noexcept = 0;
+
+  /**
+   * Latency intervals the session layer observes directly; default
+   * no-ops so implementations opt in per metric.
+   */
+  virtual void recordHeaderLatency(std::chrono::microseconds) noexcept {
+  }
+  virtual void recordTransactionLifetime(std::chrono::microseconds) noexcept {
+  }
+
+  /**
+   * Push usefulness accounting: bytes a pushed stream delivered before
+   * completing (consumed) or before the client cancelled it (wasted),
+   * and how long a cancelled push lived before the CANCEL arrived.
+   */
+  virtual void recordPushBytesConsumed(uint64_t) noexcept {
+  }
+  virtual void recordPushBytesWasted(uint64_t) noexcept {
+  }
+  virtual void recordPushCancelLatency(std::chrono::microseconds) noexcept {
+  }
 };
 
 } // namespace proxygen
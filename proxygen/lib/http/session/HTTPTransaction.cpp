@@ -72,6 +72,7 @@ HTTPTransaction::HTTPTransaction(
       headRequest_(false),
       enableLastByteFlushedTracking_(false),
       enableBodyLastByteDeliveryTracking_(false),
+      egressLowLatency_(false),
       transactionTimeout_(defaultTimeout),
       timer_(timer) {
 
@@ -116,6 +117,9 @@ void HTTPTransaction::onDelayedDestroy(bool delayed) {
   }
   VLOG(4) << "destroying transaction " << *this;
   deleting_ = true;
+  if (summaryCallback_) {
+    deliverSummary();
+  }
   if (handler_) {
     handler_->detachTransaction();
     handler_ = nullptr;
@@ -129,14 +133,49 @@ void HTTPTransaction::onDelayedDestroy(bool delayed) {
   (void)delayed; // prevent unused variable warnings
 }
 
+void HTTPTransaction::deliverSummary() noexcept {
+  HTTPTransactionSummary summary;
+  summary.streamId = id_;
+  summary.creationTimeUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          creationTime_.time_since_epoch())
+          .count();
+  auto now = getCurrentTime();
+  summary.lifetimeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                           now - creationTime_)
+                           .count();
+  if (timePointInitialized(ingressHeadersCompleteTime_)) {
+    summary.headerLatencyUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            ingressHeadersCompleteTime_ - creationTime_)
+            .count();
+  }
+  summary.egressBodyBytes = egressBodyBytesCommittedToTransport_;
+  if (resourceUsage_) {
+    summary.ingressBodyBytes = resourceUsage_->ingressBodyBytes;
+  }
+  // the session's cached snapshot: no per-record TCP_INFO syscall
+  const auto& tinfo = transport_.getSetupTransportInfo();
+  summary.rttUs = uint32_t(tinfo.rtt.count());
+  summary.statusCode =
+      summaryStatusCode_ ? summaryStatusCode_ : lastResponseStatus_;
+  summary.codecProtocol = uint8_t(transport_.getCodec().getProtocol());
+  summary.proxygenError = terminalError_;
+  summary.method = summaryMethod_;
+  summary.aborted = aborted_ ? 1 : 0;
+  summary.isPushed = isPushed() ? 1 : 0;
+  summaryCallback_(summary);
+}
+
 HTTPTransaction::~HTTPTransaction() {
-  // Cancel transaction timeout if still scheduled.
-  if (isScheduled()) {
-    cancelTimeout();
-  }
+  // Cancel transaction timeout if still scheduled or batched.
+  cancelIdleTimeout();
 
   if (stats_) {
     stats_->recordTransactionClosed();
+    stats_->recordTransactionLifetime(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            getCurrentTime() - creationTime_));
   }
   if (isEnqueued()) {
     dequeue();
@@ -163,6 +202,13 @@ void HTTPTransaction::onIngressHeadersComplete(
   if (isUpstream() && !isPushed() && msg->isResponse()) {
     lastResponseStatus_ = msg->getStatusCode();
   }
+  ingressHeadersCompleteTime_ = getCachedNow();
+  if (msg->isRequest()) {
+    auto method = msg->getMethod();
+    summaryMethod_ = method ? uint8_t(*method) + 1 : 0;
+  } else {
+    summaryStatusCode_ = msg->getStatusCode();
+  }
   if (!validateIngressStateTransition(
           HTTPTransactionIngressSM::Event::onHeaders)) {
     return;
@@ -213,7 +259,13 @@ void HTTPTransaction::processIngressHeadersComplete(
     return;
   }
   refreshTimeout();
+  if (stats_) {
+    stats_->recordHeaderLatency(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            getCurrentTime() - creationTime_));
+  }
   if (handler_ && !isIngressComplete()) {
+    HandlerTimeScope scope(resourceUsage_.get());
     handler_->onHeadersComplete(std::move(msg));
   }
 }
@@ -263,6 +315,9 @@ void HTTPTransaction::onIngressBody(unique_ptr<IOBuf> chain, uint16_t padding) {
   if (transportCallback_) {
     transportCallback_->bodyBytesReceived(len);
   }
+  if (resourceUsage_) {
+    resourceUsage_->ingressBodyBytes += len;
+  }
   // register the bytes in the receive window
   if (!recvWindow_.reserve(len + padding, useFlowControl_)) {
     LOG(ERROR)
@@ -277,7 +332,15 @@ void HTTPTransaction::onIngressBody(unique_ptr<IOBuf> chain, uint16_t padding) {
   }
   if (mustQueueIngress()) {
     checkCreateDeferredIngress();
-    deferredIngress_->emplace(id_, HTTPEvent::Type::BODY, std::move(chain));
+    if (!deferredIngress_->empty() &&
+        deferredIngress_->back().getEvent() == HTTPEvent::Type::BODY) {
+      // coalesce adjacent body frames: a pause/resume storm then
+      // replays one chained event per run instead of one per frame,
+      // and the window frees in one step at replay
+      deferredIngress_->back().appendBody(std::move(chain));
+    } else {
+      deferredIngress_->emplace(id_, HTTPEvent::Type::BODY, std::move(chain));
+    }
     VLOG(4) << "Queued ingress event of type " << HTTPEvent::Type::BODY
             << " size=" << len << " " << *this;
   } else {
@@ -297,7 +360,22 @@ void HTTPTransaction::processIngressBody(unique_ptr<IOBuf> chain, size_t len) {
   auto chainLen = chain->computeChainDataLength();
   if (handler_) {
     if (!isIngressComplete()) {
-      handler_->onBodyWithOffset(ingressBodyOffset_, std::move(chain));
+      if (ingressBodyCoalesceThreshold_ > 0) {
+        // coalescing mode: accumulate frames and deliver one chain per
+        // threshold's worth, amortizing handler dispatch
+        if (coalescedIngressBody_.empty()) {
+          coalescedIngressOffset_ = ingressBodyOffset_;
+        }
+        coalescedIngressBody_.append(std::move(chain));
+        if (coalescedIngressBody_.chainLength() >=
+            ingressBodyCoalesceThreshold_) {
+          deliverCoalescedIngressBody();
+        }
+      } else {
+        HandlerTimeScope scope(resourceUsage_.get());
+        handler_->onBodyWithOffset(ingressBodyOffset_, std::move(chain));
+      }
+      notePullDelivery(chainLen);
     }
 
     if (useFlowControl_ && !isIngressEOMSeen()) {
@@ -333,6 +411,16 @@ void HTTPTransaction::onIngressChunkHeader(size_t length) {
   }
 }
 
+void HTTPTransaction::deliverCoalescedIngressBody() {
+  if (coalescedIngressBody_.empty() || !handler_) {
+    coalescedIngressBody_.move();
+    return;
+  }
+  HandlerTimeScope scope(resourceUsage_.get());
+  handler_->onBodyWithOffset(coalescedIngressOffset_,
+                             coalescedIngressBody_.move());
+}
+
 void HTTPTransaction::processIngressChunkHeader(size_t length) {
   DestructorGuard g(this);
   if (aborted_) {
@@ -340,6 +428,7 @@ void HTTPTransaction::processIngressChunkHeader(size_t length) {
   }
   refreshTimeout();
   if (handler_ && !isIngressComplete()) {
+    deliverCoalescedIngressBody();
     handler_->onChunkHeader(length);
   }
 }
@@ -366,6 +455,7 @@ void HTTPTransaction::processIngressChunkComplete() {
   }
   refreshTimeout();
   if (handler_ && !isIngressComplete()) {
+    deliverCoalescedIngressBody();
     handler_->onChunkComplete();
   }
 }
@@ -393,6 +483,8 @@ void HTTPTransaction::processIngressTrailers(unique_ptr<HTTPHeaders> trailers) {
   }
   refreshTimeout();
   if (handler_ && !isIngressComplete()) {
+    // body precedes trailers
+    deliverCoalescedIngressBody();
     handler_->onTrailers(std::move(trailers));
   }
 }
@@ -418,6 +510,7 @@ void HTTPTransaction::processIngressUpgrade(UpgradeProtocol protocol) {
     return;
   }
   if (handler_ && !isIngressComplete()) {
+    deliverCoalescedIngressBody();
     handler_->onUpgrade(protocol);
   }
 }
@@ -478,6 +571,9 @@ void HTTPTransaction::processIngressEOM() {
   }
   if (handler_) {
     if (!wasComplete) {
+      // flush any coalesced body ahead of the EOM
+      deliverCoalescedIngressBody();
+      HandlerTimeScope scope(resourceUsage_.get());
       handler_->onEOM();
     }
   } else {
@@ -499,7 +595,7 @@ void HTTPTransaction::updateReadTimeout() {
   if (isExpectingIngress()) {
     refreshTimeout();
   } else {
-    cancelTimeout();
+    cancelIdleTimeout();
   }
 }
 
@@ -507,17 +603,17 @@ void HTTPTransaction::markIngressComplete() {
   VLOG(4) << "Marking ingress complete on " << *this;
   ingressState_ = HTTPTransactionIngressSM::State::ReceivingDone;
   deferredIngress_.reset();
-  cancelTimeout();
+  cancelIdleTimeout();
 }
 
 void HTTPTransaction::markEgressComplete() {
   VLOG(4) << "Marking egress complete on " << *this;
-  if (deferredEgressBody_.chainLength() && isEnqueued()) {
-    int64_t deferredEgressBodyBytes =
-        folly::to<int64_t>(deferredEgressBody_.chainLength());
-    transport_.notifyEgressBodyBuffered(-deferredEgressBodyBytes);
+  if (deferredEgressBodyBytes() && isEnqueued()) {
+    int64_t bufferedBytes = folly::to<int64_t>(deferredEgressBodyBytes());
+    transport_.notifyEgressBodyBuffered(-bufferedBytes);
   }
   deferredEgressBody_.move();
+  egressSpill_.reset();
   if (isEnqueued()) {
     dequeue();
   }
@@ -564,6 +660,7 @@ void HTTPTransaction::onError(const HTTPException& error) {
     sendAbort(ErrorCode::FLOW_CONTROL_ERROR);
   }
 
+  terminalError_ = uint8_t(error.getProxygenError());
   if (error.getProxygenError() == kErrorStreamAbort) {
     DCHECK(error.getDirection() ==
            HTTPException::Direction::INGRESS_AND_EGRESS);
@@ -633,6 +730,33 @@ void HTTPTransaction::onGoaway(ErrorCode code) {
   }
 }
 
+void HTTPTransaction::setDeadline(TimePoint deadline) {
+  deadline_ = deadline;
+  if (!timer_) {
+    return;
+  }
+  auto now = getCurrentTime();
+  auto remaining =
+      deadline > now
+          ? std::chrono::duration_cast<std::chrono::milliseconds>(deadline -
+                                                                  now)
+          : std::chrono::milliseconds(0);
+  timer_->scheduleTimeout(&deadlineTimeout_, remaining);
+}
+
+void HTTPTransaction::onDeadlineExpired() noexcept {
+  DestructorGuard g(this);
+  VLOG(4) << "deadline expired on " << *this;
+  HTTPException ex(
+      HTTPException::Direction::INGRESS_AND_EGRESS,
+      folly::to<std::string>("transaction deadline exceeded, streamID=", id_));
+  ex.setProxygenError(kErrorTimeout);
+  ex.setCodecStatusCode(ErrorCode::CANCEL);
+  // sendAbort via the error path: handler sees one terminal error and
+  // the abort cascades to the peer immediately
+  onError(ex);
+}
+
 void HTTPTransaction::onIngressTimeout() {
   DestructorGuard g(this);
   VLOG(4) << "ingress timeout on " << *this;
@@ -793,6 +917,8 @@ void HTTPTransaction::onIngressBodyPeek(uint64_t bodyOffset,
 void HTTPTransaction::onIngressBodySkipped(uint64_t nextBodyOffset) {
   FOLLY_SCOPED_TRACE_SECTION("HTTPTransaction - onIngressBodySkipped");
   CHECK_LE(ingressBodyOffset_, nextBodyOffset);
+  // deliver pending coalesced body before the offset jumps
+  deliverCoalescedIngressBody();
 
   uint64_t skipLen = nextBodyOffset - ingressBodyOffset_;
   if (!updateContentLengthRemaining(skipLen)) {
@@ -829,6 +955,8 @@ void HTTPTransaction::sendHeadersWithOptionalEOM(const HTTPMessage& headers,
   }
   if (headers.isRequest()) {
     headRequest_ = (headers.getMethod() == HTTPMethod::HEAD);
+    auto method = headers.getMethod();
+    summaryMethod_ = method ? uint8_t(*method) + 1 : 0;
   }
 
   if (headers.isResponse() && !headRequest_) {
@@ -885,6 +1013,9 @@ void HTTPTransaction::sendBody(std::unique_ptr<folly::IOBuf> body) {
   if (body) {
     size_t bodyLen = body->computeChainDataLength();
     actualResponseLength_ = actualResponseLength_.value() + bodyLen;
+    if (resourceUsage_) {
+      resourceUsage_->egressBodyBytes += bodyLen;
+    }
 
     if (chunking) {
       // Note, this check doesn't account for cases where sendBody is called
@@ -894,7 +1025,12 @@ void HTTPTransaction::sendBody(std::unique_ptr<folly::IOBuf> body) {
       DCHECK_LE(bodyLen, chunkHeaders_.back().length)
           << "Sent body longer than chunk header ";
     }
-    deferredEgressBody_.append(std::move(body));
+    appendDeferredEgress(std::move(body), bodyLen);
+    if (resourceUsage_) {
+      resourceUsage_->maxBufferedEgressBytes =
+          std::max<uint64_t>(resourceUsage_->maxBufferedEgressBytes,
+                             deferredEgressBody_.chainLength());
+    }
     if (*actualResponseLength_ && enableBodyLastByteDeliveryTracking_) {
       transport_.trackEgressBodyDelivery(*actualResponseLength_);
     }
@@ -905,6 +1041,82 @@ void HTTPTransaction::sendBody(std::unique_ptr<folly::IOBuf> body) {
   notifyTransportPendingEgress();
 }
 
+void HTTPTransaction::sendBodyAndTrailers(std::unique_ptr<folly::IOBuf> body,
+                                          const HTTPHeaders& trailers) {
+  DestructorGuard guard(this);
+  // Same bookkeeping as sendBody(), minus the egress wakeup - sendEOM()
+  // below schedules the single one, and the deferred egress path picks
+  // the trailers up when it flushes (see sendBodyNow/sendEOMNow).
+  if (body) {
+    CHECK(HTTPTransactionEgressSM::transit(
+        egressState_, HTTPTransactionEgressSM::Event::sendBody));
+    size_t bodyLen = body->computeChainDataLength();
+    actualResponseLength_ = actualResponseLength_.value() + bodyLen;
+    if (resourceUsage_) {
+      resourceUsage_->egressBodyBytes += bodyLen;
+    }
+    appendDeferredEgress(std::move(body), bodyLen);
+    if (resourceUsage_) {
+      resourceUsage_->maxBufferedEgressBytes =
+          std::max<uint64_t>(resourceUsage_->maxBufferedEgressBytes,
+                             deferredEgressBody_.chainLength());
+    }
+    if (*actualResponseLength_ && enableBodyLastByteDeliveryTracking_) {
+      transport_.trackEgressBodyDelivery(*actualResponseLength_);
+    }
+    if (isEnqueued()) {
+      transport_.notifyEgressBodyBuffered(bodyLen);
+    }
+  }
+  CHECK(HTTPTransactionEgressSM::transit(
+      egressState_, HTTPTransactionEgressSM::Event::sendTrailers));
+  CHECK(!partiallyReliable_)
+      << __func__ << ": trailers are not supported in partially reliable mode.";
+  trailers_.reset(new HTTPHeaders(trailers));
+  sendEOM();
+}
+
+void HTTPTransaction::setEgressSpill(uint64_t memoryThreshold,
+                                     uint64_t maxSpillBytes,
+                                     std::string dir) {
+  CHECK(!partiallyReliable_)
+      << __func__ << ": spill not supported in partially reliable mode.";
+  spillMemoryThreshold_ = memoryThreshold;
+  maxSpillBytes_ = maxSpillBytes;
+  egressSpill_ = std::make_unique<SpillBuffer>(std::move(dir));
+}
+
+void HTTPTransaction::appendDeferredEgress(std::unique_ptr<folly::IOBuf> body,
+                                           size_t bodyLen) {
+  if (egressSpill_ && !egressSpill_->hasError() &&
+      (!egressSpill_->empty() ||
+       deferredEgressBody_.chainLength() + bodyLen > spillMemoryThreshold_)) {
+    if (egressSpill_->append(*body)) {
+      return;
+    }
+    // I/O error: latched by the spill buffer; fall back to memory.
+    // Order holds because append() failed without consuming anything
+    // and the file is only unreadable once hasError() is set, in which
+    // case refillFromSpill stopped pulling from it already.
+    LOG(ERROR) << "egress spill failed, buffering in memory " << *this;
+  }
+  deferredEgressBody_.append(std::move(body));
+}
+
+void HTTPTransaction::refillFromSpill(uint32_t maxEgress) {
+  if (!egressSpill_ || egressSpill_->empty() || egressSpill_->hasError()) {
+    return;
+  }
+  auto memoryBytes = deferredEgressBody_.chainLength();
+  if (memoryBytes >= maxEgress) {
+    return;
+  }
+  auto refill = egressSpill_->splitAtMost(maxEgress - memoryBytes);
+  if (refill) {
+    deferredEgressBody_.append(std::move(refill));
+  }
+}
+
 bool HTTPTransaction::onWriteReady(const uint32_t maxEgress, double ratio) {
   DestructorGuard g(this);
   DCHECK(isEnqueued());
@@ -928,13 +1140,23 @@ size_t HTTPTransaction::sendDeferredBody(const uint32_t maxEgress) {
 
   // We shouldn't be called if we have no pending body/EOM, egress is paused, or
   // the send window is closed
-  CHECK((deferredEgressBody_.chainLength() > 0 || isEgressEOMQueued()) &&
+  CHECK((deferredEgressBodyBytes() > 0 || isEgressEOMQueued()) &&
         sendWindow > 0);
 
-  const size_t bytesLeft = deferredEgressBody_.chainLength();
+  // pull enough spilled bytes back into memory to cover this batch;
+  // canSend below never exceeds maxEgress, so splits stay in memory
+  refillFromSpill(maxEgress);
+  const size_t bytesLeft = deferredEgressBodyBytes();
 
   size_t canSend = std::min<size_t>(sendWindow, bytesLeft);
 
+  if (egressChunkQuantum_ > 0 && chunkHeaders_.empty() &&
+      canSend > egressChunkQuantum_ && canSend < bytesLeft) {
+    // intermediate batch: round down to the quantum so the codec cuts
+    // full frames/records; the remainder rides with the next batch
+    canSend -= canSend % egressChunkQuantum_;
+  }
+
   if (maybeDelayForRateLimit()) {
     // Timeout will call notifyTransportPendingEgress again
     return 0;
@@ -946,9 +1168,52 @@ size_t HTTPTransaction::sendDeferredBody(const uint32_t maxEgress) {
 
   if (chunkHeaders_.empty()) {
     curLen = canSend;
+    if (egressCompressor_ && !bodyAlreadyEncoded_ && useFlowControl_) {
+      // leave window headroom for the worst-case deflate expansion of
+      // an incompressible batch (stored-block overhead), so the
+      // compressed chunk always fits the reservation
+      const size_t margin = 16 + curLen / 1024;
+      curLen = curLen > margin ? curLen - margin : 0;
+    }
     std::unique_ptr<IOBuf> body = deferredEgressBody_.split(curLen);
     willSendEOM = hasPendingEOM();
-    DCHECK(curLen > 0 || willSendEOM);
+    // curLen may be zero after the compression margin; the pre-margin
+    // canSend carries the caller's invariant
+    DCHECK(canSend > 0 || willSendEOM);
+    if (egressCompressor_ && !bodyAlreadyEncoded_ &&
+        (curLen > 0 || willSendEOM)) {
+      // compress at generation time; the EOM batch flushes the stream
+      // trailer.  Buffered-byte accounting runs on plaintext lengths,
+      // so notify the compression delta here and let sendBodyNow
+      // account the compressed remainder.
+      const auto plainLen = curLen;
+      folly::IOBuf emptyInput;
+      body = egressCompressor_->compress(body ? body.get() : &emptyInput,
+                                         willSendEOM);
+      if (egressCompressor_->hasError()) {
+        LOG(ERROR) << "egress compression error " << *this;
+        HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS,
+                         "egress compression failure");
+        ex.setProxygenError(kErrorUnknown);
+        onError(ex);
+        return 0;
+      }
+      curLen = body ? body->computeChainDataLength() : 0;
+      // buffered accounting nets out to the plaintext consumed:
+      // sendBodyNow subtracts the compressed length, we adjust by the
+      // difference (either direction)
+      if (curLen != plainLen) {
+        transport_.notifyEgressBodyBuffered(folly::to<int64_t>(curLen) -
+                                            folly::to<int64_t>(plainLen));
+      }
+      if (curLen == 0 && !willSendEOM) {
+        // the compressor buffered everything; nothing on the wire yet.
+        // Re-evaluate pending egress so an empty queue dequeues rather
+        // than spinning the write loop
+        notifyTransportPendingEgress();
+        return 0;
+      }
+    }
     if (curLen > 0) {
       if (willSendEOM) {
         // we have to dequeue BEFORE sending the EOM =(
@@ -1127,7 +1392,7 @@ void HTTPTransaction::sendEOM() {
     LOG(ERROR) << errorMsg << " " << *this;
   }
 
-  if (deferredEgressBody_.chainLength() == 0 && chunkHeaders_.empty()) {
+  if (deferredEgressBodyBytes() == 0 && chunkHeaders_.empty()) {
     // there is nothing left to send, egress the EOM directly.  For SPDY
     // this will jump the txn queue
     if (!isEnqueued()) {
@@ -1154,6 +1419,11 @@ void HTTPTransaction::sendEOM() {
     VLOG(4) << "Queued egress EOM on " << *this;
     notifyTransportPendingEgress();
   }
+  if (egressLowLatency_) {
+    // the whole response is now pending; ask the transport to flush
+    // it ahead of the loop-batched write
+    transport_.notifyEgressUrgent();
+  }
 }
 
 void HTTPTransaction::sendAbort() {
@@ -1274,6 +1544,8 @@ HTTPTransaction::rejectBodyTo(uint64_t nextBodyOffset) {
                << "; provided reject offset = " << nextBodyOffset;
     return folly::makeUnexpected(ErrorCode::PROTOCOL_ERROR);
   }
+  // deliver pending coalesced body before the offset jumps
+  deliverCoalescedIngressBody();
   ingressBodyOffset_ = nextBodyOffset;
 
   return transport_.rejectBodyTo(this, nextBodyOffset);
@@ -1287,7 +1559,7 @@ void HTTPTransaction::pauseIngress() {
     return;
   }
   ingressPaused_ = true;
-  cancelTimeout();
+  cancelIdleTimeout();
   transport_.pauseIngress(this);
 }
 
@@ -1391,7 +1663,7 @@ void HTTPTransaction::setEgressRateLimit(uint64_t bitsPerSecond) {
 void HTTPTransaction::notifyTransportPendingEgress() {
   DestructorGuard guard(this);
   if (!egressRateLimited_ &&
-      (deferredEgressBody_.chainLength() > 0 || isEgressEOMQueued()) &&
+      (deferredEgressBodyBytes() > 0 || isEgressEOMQueued()) &&
       (!useFlowControl_ || sendWindow_.getSize() > 0)) {
     // Egress isn't paused, we have something to send, and flow
     // control isn't blocking us.
@@ -1399,26 +1671,70 @@ void HTTPTransaction::notifyTransportPendingEgress() {
       // Insert into the queue and let the session know we've got something
       egressQueue_.signalPendingEgress(queueHandle_);
       transport_.notifyPendingEgress();
-      transport_.notifyEgressBodyBuffered(deferredEgressBody_.chainLength());
+      transport_.notifyEgressBodyBuffered(deferredEgressBodyBytes());
     }
   } else if (isEnqueued()) {
     // Nothing to send, or not allowed to send right now.
-    int64_t deferredEgressBodyBytes =
-        folly::to<int64_t>(deferredEgressBody_.chainLength());
-    transport_.notifyEgressBodyBuffered(-deferredEgressBodyBytes);
+    int64_t bufferedBytes = folly::to<int64_t>(deferredEgressBodyBytes());
+    transport_.notifyEgressBodyBuffered(-bufferedBytes);
     egressQueue_.clearPendingEgress(queueHandle_);
   }
   updateHandlerPauseState();
 }
 
+double HTTPTransaction::getSessionEgressBufferShare() const {
+  auto total = transport_.getSessionBufferedEgressBytes();
+  if (total == 0) {
+    return 0.0;
+  }
+  return std::min(1.0, double(deferredEgressBodyBytes()) / double(total));
+}
+
+void HTTPTransaction::setEgressWatermarks(
+    uint64_t highBytes,
+    uint64_t lowBytes,
+    folly::Function<void(bool aboveHigh)> callback) {
+  CHECK_LT(lowBytes, highBytes) << "hysteresis requires low < high";
+  egressHighWatermark_ = highBytes;
+  egressLowWatermark_ = lowBytes;
+  egressWatermarkCallback_ = std::move(callback);
+  aboveEgressHighWatermark_ = false;
+  checkEgressWatermarks();
+}
+
+void HTTPTransaction::checkEgressWatermarks() {
+  if (!egressWatermarkCallback_ || inEgressWatermarkCallback_) {
+    return;
+  }
+  uint64_t buffered = deferredEgressBodyBytes();
+  bool fire = false;
+  bool aboveHigh = false;
+  if (!aboveEgressHighWatermark_ && buffered >= egressHighWatermark_) {
+    aboveEgressHighWatermark_ = true;
+    fire = true;
+    aboveHigh = true;
+  } else if (aboveEgressHighWatermark_ && buffered <= egressLowWatermark_) {
+    aboveEgressHighWatermark_ = false;
+    fire = true;
+  }
+  if (fire) {
+    // the callback may send more data; suppress recursive checks so a
+    // send from inside it can't re-enter
+    inEgressWatermarkCallback_ = true;
+    egressWatermarkCallback_(aboveHigh);
+    inEgressWatermarkCallback_ = false;
+  }
+}
+
 void HTTPTransaction::updateHandlerPauseState() {
+  checkEgressWatermarks();
   if (isEgressEOMSeen()) {
     VLOG(4) << "transaction already egress complete, not updating pause state "
             << *this;
     return;
   }
   int64_t availWindow =
-      sendWindow_.getSize() - deferredEgressBody_.chainLength();
+      sendWindow_.getSize() - deferredEgressBodyBytes();
   // do not count transaction stalled if no more bytes to send,
   // i.e. when availWindow == 0
   if (useFlowControl_ && availWindow < 0 && !flowControlPaused_) {
@@ -1428,7 +1744,11 @@ void HTTPTransaction::updateHandlerPauseState() {
     }
   }
   flowControlPaused_ = useFlowControl_ && availWindow <= 0;
-  bool bufferFull = deferredEgressBody_.chainLength() > kMaxBufferPerTxn;
+  // with spill enabled, memory stays bounded near the spill threshold
+  // and backpressure triggers on the spilled byte budget instead
+  bool bufferFull = egressSpill_
+                        ? egressSpill_->bytes() > maxSpillBytes_
+                        : deferredEgressBody_.chainLength() > kMaxBufferPerTxn;
   bool handlerShouldBePaused =
       egressPaused_ || flowControlPaused_ || egressRateLimited_ || bufferFull;
 
@@ -1469,7 +1789,12 @@ bool HTTPTransaction::mustQueueIngress() const {
 
 void HTTPTransaction::checkCreateDeferredIngress() {
   if (!deferredIngress_) {
-    deferredIngress_ = std::make_unique<std::queue<HTTPEvent>>();
+    if (!arena_) {
+      // no session-provided arena, fall back to a self-owned one
+      arena_ = std::make_unique<RecyclableArena>();
+    }
+    deferredIngress_ = std::make_unique<HTTPEventQueue>(
+        RecyclableArena::Allocator<HTTPEvent>(*arena_));
   }
 }
 
@@ -1746,7 +2071,7 @@ void HTTPTransaction::updateTransactionBytesSent(uint64_t bytes) {
 }
 
 void HTTPTransaction::checkIfEgressRateLimitedByUpstream() {
-  if (deferredEgressBody_.empty() && !hasPendingEOM() && transportCallback_) {
+  if (deferredEgressBodyBytes() == 0 && !hasPendingEOM() && transportCallback_) {
     transportCallback_->egressBufferEmpty();
   }
 }
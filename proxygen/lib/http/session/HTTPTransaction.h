@@ -9,6 +9,8 @@
 #pragma once
 
 #include <climits>
+#include <deque>
+#include <queue>
 #include <folly/Optional.h>
 #include <folly/SocketAddress.h>
 #include <folly/io/async/AsyncTransport.h>
@@ -27,6 +29,11 @@
 #include <proxygen/lib/http/session/HTTPEvent.h>
 #include <proxygen/lib/http/session/HTTPTransactionEgressSM.h>
 #include <proxygen/lib/http/session/HTTPTransactionIngressSM.h>
+#include <proxygen/lib/http/session/HTTPTransactionSummary.h>
+#include <proxygen/lib/http/session/TransactionTimeoutBatcher.h>
+#include <proxygen/lib/utils/RecyclableArena.h>
+#include <proxygen/lib/utils/SpillBuffer.h>
+#include <proxygen/lib/utils/ZlibStreamCompressor.h>
 #include <proxygen/lib/utils/Time.h>
 #include <proxygen/lib/utils/WheelTimerInstance.h>
 #include <set>
@@ -446,12 +453,29 @@ class HTTPTransaction
 
     virtual void notifyPendingEgress() noexcept = 0;
 
+    /**
+     * Hint that the transaction's pending egress is latency-critical;
+     * the transport may flush it inline instead of waiting for the
+     * loop-batched write.  Default is to do nothing (stay batched).
+     */
+    virtual void notifyEgressUrgent() noexcept {
+    }
+
     virtual void detach(HTTPTransaction* txn) noexcept = 0;
 
     virtual void notifyIngressBodyProcessed(uint32_t bytes) noexcept = 0;
 
     virtual void notifyEgressBodyBuffered(int64_t bytes) noexcept = 0;
 
+    /**
+     * Total egress bytes the session currently has buffered (write
+     * buffer plus deferred transaction bodies); 0 when the transport
+     * doesn't track it.
+     */
+    virtual uint64_t getSessionBufferedEgressBytes() const noexcept {
+      return 0;
+    }
+
     virtual const folly::SocketAddress& getLocalAddress() const noexcept = 0;
 
     virtual const folly::SocketAddress& getPeerAddress() const noexcept = 0;
@@ -710,6 +734,69 @@ class HTTPTransaction
     return maxDeferredIngress_;
   }
 
+  /**
+   * Opt-in per-transaction resource accounting for tenant billing and
+   * cost attribution; see getResourceUsage.
+   */
+  struct ResourceUsage {
+    uint64_t ingressBodyBytes{0};
+    uint64_t egressBodyBytes{0};
+    // peak bytes buffered awaiting egress
+    uint64_t maxBufferedEgressBytes{0};
+    /**
+     * Wall time spent inside handler callbacks on the event thread;
+     * equals on-CPU time for handlers that don't block (which event
+     * loop handlers must not do anyway).
+     */
+    std::chrono::microseconds handlerTime{std::chrono::microseconds(0)};
+  };
+
+  void enableResourceAccounting() {
+    if (!resourceUsage_) {
+      resourceUsage_ = std::make_unique<ResourceUsage>();
+    }
+  }
+
+  /**
+   * nullptr unless enableResourceAccounting was called; stable for the
+   * transaction's lifetime, final totals available at detach/EOM.
+   */
+  const ResourceUsage* getResourceUsage() const {
+    return resourceUsage_.get();
+  }
+
+  /**
+   * Coalesce ingress body delivery: parsed DATA frames accumulate and
+   * the handler receives one chain per thresholdBytes of body (flushed
+   * early at EOM, trailers, chunk boundaries and upgrades), amortizing
+   * per-frame handler dispatch on upload-heavy streams. 0 (the
+   * default) delivers every frame individually. Flow-control window
+   * accounting is unchanged.
+   */
+  void setIngressBodyCoalescing(uint32_t thresholdBytes) {
+    ingressBodyCoalesceThreshold_ = thresholdBytes;
+  }
+
+  /**
+   * Hand this transaction a (possibly recycled) arena to draw its
+   * per-transaction allocations from. Must be called right after
+   * construction, before any ingress is delivered. Without one, the
+   * transaction lazily creates its own.
+   */
+  void setArena(std::unique_ptr<RecyclableArena> arena) {
+    CHECK(!deferredIngress_);
+    arena_ = std::move(arena);
+  }
+
+  /**
+   * Reclaim the arena for recycling; drops any still-deferred ingress
+   * events. Only sensible when the transaction is being torn down.
+   */
+  std::unique_ptr<RecyclableArena> reclaimArena() {
+    deferredIngress_.reset();
+    return std::move(arena_);
+  }
+
   /**
    * Invoked by the session when the ingress headers are complete
    */
@@ -1004,7 +1091,10 @@ class HTTPTransaction
    *
    * @param body Message body data; the Transport will take care of
    *             applying any necessary protocol framing, such as
-   *             chunk headers.
+   *             chunk headers. Buffers created with at least
+   *             HTTPCodec::kMaxFrameHeadroom of headroom let framed
+   *             codecs write their frame headers in place instead of
+   *             allocating a buffer per DATA frame.
    */
   virtual void sendBody(std::unique_ptr<folly::IOBuf> body);
 
@@ -1056,6 +1146,147 @@ class HTTPTransaction
     trailers_.reset(new HTTPHeaders(trailers));
   }
 
+  /**
+   * Send body, trailers and end-of-message in a single call. Equivalent
+   * to sendBody() + sendTrailers() + sendEOM() but schedules only one
+   * egress wakeup, so the body, trailers and EOM are serialized in the
+   * same write loop pass instead of across several. The body may be
+   * null when there is only a trailer block to send.
+   *
+   * Note: This method may be called at most once per message, in place
+   *       of sendTrailers()/sendEOM(), and not while chunking.
+   *
+   * @param body      Message body data; may be null.
+   * @param trailers  Message trailers.
+   */
+  virtual void sendBodyAndTrailers(std::unique_ptr<folly::IOBuf> body,
+                                   const HTTPHeaders& trailers);
+
+  /**
+   * Spill deferred egress body beyond memoryThreshold bytes to an
+   * unlinked per-transaction temp file instead of growing the
+   * in-memory queue, transparently re-read as the transport drains.
+   * Handler backpressure (buffer-full pause) then triggers on
+   * maxSpillBytes of spilled data rather than on the in-memory limit,
+   * so a slow consumer costs disk instead of memory.  On spill I/O
+   * errors the transaction falls back to memory buffering.  Not
+   * compatible with partially reliable transport or egress body
+   * trimming.  Call before sending body.
+   */
+  virtual void setEgressSpill(uint64_t memoryThreshold,
+                              uint64_t maxSpillBytes,
+                              std::string dir = "/tmp");
+
+  /**
+   * Shape deferred body batches to multiples of this quantum before
+   * codec generation, so frames and TLS records come out full instead
+   * of ending in runts: set it to the negotiated max frame size, or to
+   * the 16KB TLS record size to avoid per-record padding waste on
+   * large transfers.  Only intermediate batches are rounded down - the
+   * final batch (and anything smaller than one quantum) flushes as is,
+   * so latency and EOM timing are unchanged.  0 disables shaping.
+   */
+  void setEgressChunkQuantum(uint32_t bytes) {
+    egressChunkQuantum_ = bytes;
+  }
+
+  /**
+   * Trade write batching for latency on this transaction: sendEOM
+   * hints the transport to flush the response inline instead of
+   * waiting for the end of the loop iteration, which saves up to one
+   * loop iteration of queueing per response.  Meant for
+   * sub-millisecond internal RPC; the transport applies its own
+   * budget and starvation limits, falling back to the batched write
+   * when they do not hold.
+   */
+  void setLowLatencyEgress(bool enabled) {
+    egressLowLatency_ = enabled;
+  }
+
+  bool isLowLatencyEgress() const {
+    return egressLowLatency_;
+  }
+
+  /**
+   * Egress-buffer visibility for streaming producers.  Handlers
+   * generating data (long polls, exports) only heard about
+   * backpressure through onEgressPaused, after buffers were already
+   * full; these let them see occupancy and modulate generation rate
+   * before the pause cliff.
+   */
+  uint64_t getEgressBufferedBytes() const {
+    return deferredEgressBodyBytes();
+  }
+
+  /** This transaction's share (0-1.0) of the session's buffered egress. */
+  double getSessionEgressBufferShare() const;
+
+  /**
+   * Register high/low watermark callbacks on the egress buffer: the
+   * callback fires with true when buffered bytes first reach
+   * highBytes and with false once they drain back to lowBytes - the
+   * gap is the hysteresis, so an oscillating producer gets one
+   * notification per excursion, not one per send.  Requires
+   * lowBytes < highBytes.  Fires from within sendBody/drain paths;
+   * the callback may send more data but should expect reentrancy
+   * into neither itself nor the watermark check (suppressed).
+   */
+  void setEgressWatermarks(uint64_t highBytes,
+                           uint64_t lowBytes,
+                           folly::Function<void(bool aboveHigh)> callback);
+
+  /**
+   * Transport-integrated egress compression: body batches compress at
+   * generation time in the egress path, so bytes buffer exactly once
+   * (no double buffering through a handler filter) and spilled bytes
+   * are compressed before they ever reach the deferred queue's
+   * consumers.  Deflate contexts come from the per-worker pool.
+   * Enable after negotiating (e.g. via
+   * HTTPMessage::acceptsEncoding) and before sending headers; the
+   * caller sets Content-Encoding and drops Content-Length on the
+   * response it sends, since compressed length is unknown.  Not
+   * compatible with explicit chunk framing or partial reliability.
+   * setBodyAlreadyEncoded marks subsequent sendBody payloads as
+   * pre-compressed, bypassing the stage.
+   */
+  void enableEgressCompression(CompressionType type, int level) {
+    CHECK(!partiallyReliable_);
+    egressCompressor_ =
+        std::make_unique<ZlibStreamCompressor>(type, level);
+  }
+
+  void setBodyAlreadyEncoded(bool alreadyEncoded) {
+    bodyAlreadyEncoded_ = alreadyEncoded;
+  }
+
+  /**
+   * Pull-mode ingress: the handler states how many body bytes it is
+   * ready for and the transaction translates that demand into the
+   * pause/window machinery - delivery pauses when the grant runs out
+   * and resumes when more is requested, so a slow sink (blob storage,
+   * disk) backpressures the peer through flow control instead of the
+   * handler growing its own buffer.  Delivery granularity is the
+   * arriving chunk: one chunk may overshoot the remaining grant, and
+   * the grant is consumed by what was actually delivered.  Enable
+   * before body arrives (e.g. in onHeadersComplete); EOM waits behind
+   * undelivered body like any other deferred ingress.
+   */
+  void enablePullIngress() {
+    CHECK_EQ(ingressBodyCoalesceThreshold_, 0)
+        << "pull mode and ingress coalescing don't compose";
+    pullIngress_ = true;
+    pauseIngress(); // nothing granted yet
+  }
+
+  void requestIngressBody(uint64_t bytes) {
+    CHECK(pullIngress_);
+    if (bytes == 0) {
+      return;
+    }
+    pullDemand_ += bytes;
+    resumeIngress();
+  }
+
   /**
    * Finalize the egress message; depending on the protocol used
    * by the Transport, this may involve sending an explicit "end
@@ -1222,6 +1453,22 @@ class HTTPTransaction
   /**
    * True if this transaction is a server push transaction
    */
+  bool isAborted() const {
+    return aborted_;
+  }
+
+  /**
+   * Egress body bytes handed to the transport so far; e.g. push
+   * usefulness accounting reads this at cancel/completion.
+   */
+  uint64_t getEgressBodyBytesCommitted() const {
+    return egressBodyBytesCommittedToTransport_;
+  }
+
+  TimePoint getCreationTime() const {
+    return creationTime_;
+  }
+
   bool isPushed() const {
     return assocStreamId_.has_value();
   }
@@ -1330,11 +1577,44 @@ class HTTPTransaction
    * Schedule or refresh the timeout for this transaction
    */
   void refreshTimeout() {
-    if (timer_ && hasIdleTimeout()) {
+    if (!hasIdleTimeout()) {
+      return;
+    }
+    if (timeoutBatcher_) {
+      // deadline tracked by the session's shared coarse timer
+      timeoutBatcher_->refresh(this, transactionTimeout_.value());
+    } else if (timer_) {
       timer_->scheduleTimeout(this, transactionTimeout_.value());
     }
   }
 
+  /**
+   * Cancel any pending idle timeout, whether individually scheduled or
+   * tracked by the session's timeout batcher
+   */
+  void cancelIdleTimeout() {
+    if (timeoutBatcher_) {
+      timeoutBatcher_->remove(this);
+    }
+    if (isScheduled()) {
+      cancelTimeout();
+    }
+  }
+
+  /**
+   * Opt this transaction into the session's shared coarse idle timer.
+   * Must be called right after construction, before ingress is delivered;
+   * the batcher must outlive the transaction.
+   */
+  void setTimeoutBatcher(TransactionTimeoutBatcher* batcher) {
+    timeoutBatcher_ = batcher;
+    if (isScheduled()) {
+      // migrate the timeout the constructor scheduled individually
+      cancelTimeout();
+      refreshTimeout();
+    }
+  }
+
   /**
    * Tests if the first byte has already been sent, and if it
    * hasn't yet then it marks it as sent.
@@ -1389,6 +1669,35 @@ class HTTPTransaction
     transport_.transactionTimeout(this);
   }
 
+  /**
+   * Absolute deadline for the whole transaction, settable at ingress
+   * (e.g. from a request header via policy).  One timer on the
+   * session's shared wheel enforces it; expiry aborts the transaction
+   * with kErrorTimeout.  Proxies propagate it by copying getDeadline()
+   * onto their upstream transactions, and pushed transactions inherit
+   * the associated transaction's deadline, so one end-to-end budget
+   * replaces stacked per-hop timers.  A deadline already in the past
+   * aborts on the next timer tick.
+   */
+  void setDeadline(TimePoint deadline);
+
+  folly::Optional<TimePoint> getDeadline() const {
+    return deadline_;
+  }
+
+  /**
+   * Deliver a one-record rollup of this transaction (see
+   * HTTPTransactionSummary) right before it detaches from the
+   * transport - one cache-friendly record per request instead of
+   * correlating handler, access and stats logs.  The callback runs on
+   * the transaction's event thread; hand the POD off to a logger
+   * thread from there.
+   */
+  void setSummaryCallback(
+      folly::Function<void(const HTTPTransactionSummary&)> callback) {
+    summaryCallback_ = std::move(callback);
+  }
+
   /**
    * Write a description of the transaction to a stream
    */
@@ -1455,11 +1764,11 @@ class HTTPTransaction
   const CompressionInfo& getCompressionInfo() const;
 
   bool hasPendingBody() const {
-    return deferredEgressBody_.chainLength() > 0;
+    return deferredEgressBodyBytes() > 0;
   }
 
   size_t getOutstandingEgressBodyBytes() const {
-    return deferredEgressBody_.chainLength();
+    return deferredEgressBodyBytes();
   }
 
   void setLastByteFlushedTrackingEnabled(bool enabled) {
@@ -1568,6 +1877,31 @@ peek(PeekCallback peekCallback);
   // that work whether the ingress events are immediate or deferred.
   void processIngressHeadersComplete(std::unique_ptr<HTTPMessage> msg);
   void processIngressBody(std::unique_ptr<folly::IOBuf> chain, size_t len);
+
+  // deliver any coalesced ingress body to the handler (no-op when empty)
+  void deliverCoalescedIngressBody();
+
+  // accumulates wall time into the usage record while in scope
+  class HandlerTimeScope {
+   public:
+    explicit HandlerTimeScope(ResourceUsage* usage) : usage_(usage) {
+      if (usage_) {
+        start_ = getCurrentTime();
+      }
+    }
+
+    ~HandlerTimeScope() {
+      if (usage_) {
+        usage_->handlerTime +=
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                getCurrentTime() - start_);
+      }
+    }
+
+   private:
+    ResourceUsage* usage_;
+    TimePoint start_;
+  };
   void processIngressChunkHeader(size_t length);
   void processIngressChunkComplete();
   void processIngressTrailers(std::unique_ptr<HTTPHeaders> trailers);
@@ -1597,7 +1931,7 @@ peek(PeekCallback peekCallback);
   }
 
   bool hasPendingEOM() const {
-    return deferredEgressBody_.chainLength() == 0 && isEgressEOMQueued();
+    return deferredEgressBodyBytes() == 0 && isEgressEOMQueued();
   }
 
   bool isExpectingIngress() const;
@@ -1655,11 +1989,22 @@ peek(PeekCallback peekCallback);
 
   RateLimitCallback rateLimitCallback_{*this};
 
+  /**
+   * Arena backing the deferred ingress event nodes. Either handed to us by
+   * the session (recycled across transactions) or lazily self-owned. Must
+   * be declared before deferredIngress_ so the queue is destroyed first.
+   */
+  std::unique_ptr<RecyclableArena> arena_;
+
+  using HTTPEventQueue = std::queue<
+      HTTPEvent,
+      std::deque<HTTPEvent, RecyclableArena::Allocator<HTTPEvent>>>;
+
   /**
    * Queue to hold any events that we receive from the Transaction
    * while the ingress is supposed to be paused.
    */
-  std::unique_ptr<std::queue<HTTPEvent>> deferredIngress_;
+  std::unique_ptr<HTTPEventQueue> deferredIngress_;
 
   uint32_t maxDeferredIngress_{0};
 
@@ -1669,6 +2014,68 @@ peek(PeekCallback peekCallback);
    */
   folly::IOBufQueue deferredEgressBody_{folly::IOBufQueue::cacheChainLength()};
 
+  // egress batch shaping; see setEgressChunkQuantum
+  uint32_t egressChunkQuantum_{0};
+
+  // egress watermark state; see setEgressWatermarks
+  void checkEgressWatermarks();
+  uint64_t egressHighWatermark_{0};
+  uint64_t egressLowWatermark_{0};
+  folly::Function<void(bool)> egressWatermarkCallback_;
+  bool aboveEgressHighWatermark_{false};
+  bool inEgressWatermarkCallback_{false};
+
+  // egress compression; see enableEgressCompression
+  std::unique_ptr<ZlibStreamCompressor> egressCompressor_;
+  bool bodyAlreadyEncoded_{false};
+
+  // pull-mode ingress; see enablePullIngress
+  bool pullIngress_{false};
+  uint64_t pullDemand_{0};
+
+  // consume grant for delivered bytes; pause when it runs out
+  void notePullDelivery(size_t len) {
+    if (!pullIngress_) {
+      return;
+    }
+    pullDemand_ -= std::min<uint64_t>(pullDemand_, len);
+    if (pullDemand_ == 0) {
+      pauseIngress();
+    }
+  }
+
+  // disk overflow for deferredEgressBody_; see setEgressSpill
+  std::unique_ptr<SpillBuffer> egressSpill_;
+  uint64_t spillMemoryThreshold_{0};
+  uint64_t maxSpillBytes_{0};
+
+  // total deferred egress, in memory plus spilled
+  size_t deferredEgressBodyBytes() const {
+    return deferredEgressBody_.chainLength() +
+           (egressSpill_ ? egressSpill_->bytes() : 0);
+  }
+
+  // route an egress body chunk to memory or the spill file, keeping
+  // FIFO order (once anything is spilled, everything spills until the
+  // file drains)
+  void appendDeferredEgress(std::unique_ptr<folly::IOBuf> body,
+                            size_t bodyLen);
+
+  // pull spilled bytes back into memory ahead of a write batch
+  void refillFromSpill(uint32_t maxEgress);
+
+  // per-transaction resource accounting; null unless enabled
+  std::unique_ptr<ResourceUsage> resourceUsage_;
+
+  /**
+   * Ingress body accumulated for batched delivery; see
+   * setIngressBodyCoalescing.
+   */
+  folly::IOBufQueue coalescedIngressBody_{
+      folly::IOBufQueue::cacheChainLength()};
+  uint64_t coalescedIngressOffset_{0};
+  uint32_t ingressBodyCoalesceThreshold_{0};
+
   const TransportDirection direction_;
   HTTPCodec::StreamID id_;
   uint32_t seqNo_;
@@ -1800,11 +2207,16 @@ peek(PeekCallback peekCallback);
   bool headRequest_ : 1;
   bool enableLastByteFlushedTracking_ : 1;
   bool enableBodyLastByteDeliveryTracking_ : 1;
+  bool egressLowLatency_ : 1;
 
   static uint64_t egressBufferLimit_;
 
   uint64_t egressLimitBytesPerMs_{0};
   proxygen::TimePoint startRateLimit_;
+
+  // when this transaction was constructed, for session-layer latency
+  // instrumentation; loop-cached granularity suffices
+  const TimePoint creationTime_{getCachedNow()};
   uint64_t numLimitedBytesEgressed_{0};
 
   /**
@@ -1814,6 +2226,34 @@ peek(PeekCallback peekCallback);
 
   folly::HHWheelTimer* timer_;
 
+  class DeadlineTimeout : public folly::HHWheelTimer::Callback {
+   public:
+    explicit DeadlineTimeout(HTTPTransaction* txn) : txn_(txn) {
+    }
+    void timeoutExpired() noexcept override {
+      txn_->onDeadlineExpired();
+    }
+
+   private:
+    HTTPTransaction* txn_;
+  };
+  folly::Optional<TimePoint> deadline_;
+  DeadlineTimeout deadlineTimeout_{this};
+
+  void onDeadlineExpired() noexcept;
+
+  // summary rollup state; see setSummaryCallback
+  folly::Function<void(const HTTPTransactionSummary&)> summaryCallback_;
+  TimePoint ingressHeadersCompleteTime_{};
+  uint16_t summaryStatusCode_{0};
+  uint8_t summaryMethod_{0};
+  uint8_t terminalError_{0};
+
+  void deliverSummary() noexcept;
+
+  // non-owning; shared coarse idle timer provided by the session
+  TransactionTimeoutBatcher* timeoutBatcher_{nullptr};
+
   class PrioritySample;
   std::unique_ptr<PrioritySample> prioritySample_;
 
@@ -8,10 +8,17 @@
 
 #include <proxygen/lib/http/session/HTTPTransactionIngressSM.h>
 
-#include <folly/Indestructible.h>
-
 namespace proxygen {
 
+namespace {
+
+using State = HTTPTransactionIngressSMData::State;
+using Event = HTTPTransactionIngressSMData::Event;
+using Table = ConstexprTransitionTable<State,
+                                       Event,
+                                       static_cast<size_t>(State::NumStates),
+                                       static_cast<size_t>(Event::NumEvents)>;
+
 //             +--> ChunkHeaderReceived -> ChunkBodyReceived
 //             |        ^                     v
 //             |        |          ChunkCompleted -> TrailersReceived
@@ -23,57 +30,63 @@ namespace proxygen {
 //             |                                   |
 //             +---------> UpgradeComplete --------+
 
-std::pair<HTTPTransactionIngressSMData::State, bool>
-HTTPTransactionIngressSMData::find(HTTPTransactionIngressSMData::State s,
-                                   HTTPTransactionIngressSMData::Event e) {
-  using State = HTTPTransactionIngressSMData::State;
-  using Event = HTTPTransactionIngressSMData::Event;
-
-  static const folly::Indestructible<TransitionTable<State, Event>> transitions{
-    TransitionTable<State, Event>{
-      static_cast<uint64_t>(State::NumStates),
-      static_cast<uint64_t>(Event::NumEvents),
-    {{{State::Start, Event::onHeaders}, State::HeadersReceived},
+constexpr Table::Transition kTransitions[] = {
+    {State::Start, Event::onHeaders, State::HeadersReceived},
 
     // For HTTP receiving 100 response, then a regular response
-    {{State::HeadersReceived, Event::onHeaders}, State::HeadersReceived},
+    {State::HeadersReceived, Event::onHeaders, State::HeadersReceived},
 
-    {{State::HeadersReceived, Event::onBody}, State::RegularBodyReceived},
-    {{State::HeadersReceived, Event::onChunkHeader},
+    {State::HeadersReceived, Event::onBody, State::RegularBodyReceived},
+    {State::HeadersReceived, Event::onChunkHeader,
      State::ChunkHeaderReceived},
     // special case - 0 byte body with trailers
-    {{State::HeadersReceived, Event::onTrailers}, State::TrailersReceived},
-    {{State::HeadersReceived, Event::onUpgrade}, State::UpgradeComplete},
-    {{State::HeadersReceived, Event::onEOM}, State::EOMQueued},
+    {State::HeadersReceived, Event::onTrailers, State::TrailersReceived},
+    {State::HeadersReceived, Event::onUpgrade, State::UpgradeComplete},
+    {State::HeadersReceived, Event::onEOM, State::EOMQueued},
 
-    {{State::RegularBodyReceived, Event::onBody}, State::RegularBodyReceived},
+    {State::RegularBodyReceived, Event::onBody, State::RegularBodyReceived},
     // HTTP2 supports trailers and doesn't handle body as chunked events
-    {{State::RegularBodyReceived, Event::onTrailers}, State::TrailersReceived},
-    {{State::RegularBodyReceived, Event::onEOM}, State::EOMQueued},
+    {State::RegularBodyReceived, Event::onTrailers, State::TrailersReceived},
+    {State::RegularBodyReceived, Event::onEOM, State::EOMQueued},
 
-    {{State::ChunkHeaderReceived, Event::onBody}, State::ChunkBodyReceived},
+    {State::ChunkHeaderReceived, Event::onBody, State::ChunkBodyReceived},
 
-    {{State::ChunkBodyReceived, Event::onBody}, State::ChunkBodyReceived},
-    {{State::ChunkBodyReceived, Event::onChunkComplete}, State::ChunkCompleted},
+    {State::ChunkBodyReceived, Event::onBody, State::ChunkBodyReceived},
+    {State::ChunkBodyReceived, Event::onChunkComplete, State::ChunkCompleted},
 
-    {{State::ChunkCompleted, Event::onChunkHeader}, State::ChunkHeaderReceived},
+    {State::ChunkCompleted, Event::onChunkHeader, State::ChunkHeaderReceived},
     // TODO: "trailers" may be received at any time due to the SPDY HEADERS
     // frame coming at any time. We might want to have a
     // TransactionStateMachineFactory that takes a codec and generates the
     // appropriate transaction state machine from that.
-    {{State::ChunkCompleted, Event::onTrailers}, State::TrailersReceived},
-    {{State::ChunkCompleted, Event::onEOM}, State::EOMQueued},
+    {State::ChunkCompleted, Event::onTrailers, State::TrailersReceived},
+    {State::ChunkCompleted, Event::onEOM, State::EOMQueued},
 
-    {{State::TrailersReceived, Event::onEOM}, State::EOMQueued},
+    {State::TrailersReceived, Event::onEOM, State::EOMQueued},
 
-    {{State::UpgradeComplete, Event::onBody}, State::UpgradeComplete},
-    {{State::UpgradeComplete, Event::onEOM}, State::EOMQueued},
+    {State::UpgradeComplete, Event::onBody, State::UpgradeComplete},
+    {State::UpgradeComplete, Event::onEOM, State::EOMQueued},
 
-    {{State::EOMQueued, Event::eomFlushed}, State::ReceivingDone}
-    }}
-  };
+    {State::EOMQueued, Event::eomFlushed, State::ReceivingDone}};
 
-  return transitions->find(s, e);
+constexpr Table kTransitionTable{kTransitions};
+
+// compile-time sanity checks on the table
+static_assert(kTransitionTable.find(State::Start, Event::onHeaders).second,
+              "ingress SM must accept onHeaders from Start");
+static_assert(!kTransitionTable.find(State::Start, Event::onBody).second,
+              "ingress SM must reject onBody from Start");
+static_assert(
+    kTransitionTable.find(State::EOMQueued, Event::eomFlushed).first ==
+        State::ReceivingDone,
+    "ingress SM must finish via eomFlushed");
+
+} // anonymous namespace
+
+std::pair<HTTPTransactionIngressSMData::State, bool>
+HTTPTransactionIngressSMData::find(HTTPTransactionIngressSMData::State s,
+                                   HTTPTransactionIngressSMData::Event e) {
+  return kTransitionTable.find(s, e);
 }
 
 std::ostream& operator<<(std::ostream& os,
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+namespace proxygen {
+
+/**
+ * One-record rollup of a transaction, assembled incrementally from the
+ * timestamps and counters the transaction already keeps and delivered
+ * through a single callback right before detach.  Plain trivially
+ * copyable layout so a logger can memcpy records through a lock-free
+ * queue to its own thread instead of formatting N log lines inline.
+ *
+ * Fields are best effort: ingressBodyBytes requires resource
+ * accounting to be enabled on the transaction, statusCode/method come
+ * from whichever message directions the transaction saw, and rttUs is
+ * the transport's last snapshot.
+ */
+struct HTTPTransactionSummary {
+  uint64_t streamId{0};
+  // transaction creation, microseconds since the steady-clock epoch
+  uint64_t creationTimeUs{0};
+  uint64_t lifetimeUs{0};
+  // creation to ingress-headers-complete; 0 if headers never completed
+  uint64_t headerLatencyUs{0};
+  // body bytes committed to the transport
+  uint64_t egressBodyBytes{0};
+  // body bytes received; 0 unless resource accounting was enabled
+  uint64_t ingressBodyBytes{0};
+  uint32_t rttUs{0};
+  uint16_t statusCode{0};
+  uint8_t codecProtocol{0};  // static_cast<uint8_t>(CodecProtocol)
+  uint8_t proxygenError{0};  // terminal error, if any (ProxygenError)
+  uint8_t method{0};         // HTTPMethod + 1; 0 when unknown
+  uint8_t aborted{0};
+  uint8_t isPushed{0};
+  uint8_t unused{0};
+};
+
+static_assert(std::is_trivially_copyable<HTTPTransactionSummary>::value,
+              "summary records must memcpy through lock-free queues");
+
+} // namespace proxygen
@@ -7,6 +7,8 @@
  */
 
 #include <proxygen/lib/http/session/HTTPUpstreamSession.h>
+
+#include <proxygen/lib/http/session/WorkerSessionRegistry.h>
 #include <proxygen/lib/http/session/HTTPSessionController.h>
 
 #include <folly/io/async/AsyncSSLSocket.h>
@@ -158,6 +160,8 @@ void HTTPUpstreamSession::attachThreadLocals(
     HTTPSessionController* controller) {
   txnEgressQueue_.attachThreadLocals(timeout);
   timeout_ = timeout;
+  // this session now belongs to this worker's connection table
+  WorkerSessionRegistry::getThreadRegistry().add(this);
   setController(controller);
   setSessionStats(stats);
   if (sock_) {
@@ -182,6 +186,8 @@ void HTTPUpstreamSession::maybeAttachSSLContext(
 
 void HTTPUpstreamSession::detachThreadLocals(bool detachSSLContext) {
   CHECK(transactions_.empty());
+  // leaving this worker; its connection table must not keep a pointer
+  WorkerSessionRegistry::getThreadRegistry().remove(this);
   cancelLoopCallbacks();
   pauseReadsImpl();
   if (sock_) {
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/InProcessTransport.h>
+
+#include <folly/SocketAddress.h>
+#include <glog/logging.h>
+
+namespace proxygen {
+
+std::pair<InProcessTransport::UniquePtr, InProcessTransport::UniquePtr>
+InProcessTransport::makePair(folly::EventBase* evb) {
+  UniquePtr a(new InProcessTransport(evb));
+  UniquePtr b(new InProcessTransport(evb));
+  a->peer_ = b.get();
+  b->peer_ = a.get();
+  return {std::move(a), std::move(b)};
+}
+
+InProcessTransport::~InProcessTransport() {
+  if (peer_) {
+    peer_->peer_ = nullptr;
+  }
+  cancelLoopCallback();
+}
+
+void InProcessTransport::setReadCB(
+    AsyncTransportWrapper::ReadCallback* callback) {
+  readCallback_ = callback;
+  if (readCallback_ &&
+      (!pendingIngress_.empty() || (ingressEOF_ && !eofDelivered_))) {
+    scheduleDelivery();
+  }
+}
+
+InProcessTransport::ReadCallback* InProcessTransport::getReadCallback() const {
+  return readCallback_;
+}
+
+void InProcessTransport::write(AsyncTransportWrapper::WriteCallback* callback,
+                               const void* buf,
+                               size_t bytes,
+                               folly::WriteFlags flags) {
+  writeChain(callback, folly::IOBuf::copyBuffer(buf, bytes), flags);
+}
+
+void InProcessTransport::writev(AsyncTransportWrapper::WriteCallback* callback,
+                                const struct iovec* vec,
+                                size_t count,
+                                folly::WriteFlags flags) {
+  folly::IOBufQueue chain{folly::IOBufQueue::cacheChainLength()};
+  for (size_t i = 0; i < count; i++) {
+    chain.append(folly::IOBuf::copyBuffer(vec[i].iov_base, vec[i].iov_len));
+  }
+  writeChain(callback, chain.move(), flags);
+}
+
+void InProcessTransport::writeChain(
+    AsyncTransportWrapper::WriteCallback* callback,
+    std::unique_ptr<folly::IOBuf>&& iob,
+    folly::WriteFlags /*flags*/) {
+  if (closed_ || writesShutdown_ || !peer_ || peer_->closed_) {
+    if (callback) {
+      folly::AsyncSocketException ex(folly::AsyncSocketException::NOT_OPEN,
+                                     "in-process peer closed");
+      callback->writeErr(0, ex);
+    }
+    return;
+  }
+  const auto bytes = iob ? iob->computeChainDataLength() : 0;
+  bytesWritten_ += bytes;
+  peer_->enqueueFromPeer(std::move(iob));
+  if (callback) {
+    // the "wire" is the peer's ingress queue; arrival there is success
+    callback->writeSuccess();
+  }
+}
+
+void InProcessTransport::enqueueFromPeer(std::unique_ptr<folly::IOBuf> chain) {
+  if (closed_) {
+    return;
+  }
+  if (chain) {
+    bytesReceived_ += chain->computeChainDataLength();
+    pendingIngress_.append(std::move(chain));
+  }
+  scheduleDelivery();
+}
+
+void InProcessTransport::peerShutdownWrite() {
+  ingressEOF_ = true;
+  scheduleDelivery();
+}
+
+void InProcessTransport::peerClosed() {
+  ingressEOF_ = true;
+  scheduleDelivery();
+}
+
+void InProcessTransport::scheduleDelivery() {
+  // always via loop callback: a hop must not re-enter the writer's
+  // stack the way a function call would
+  if (!isLoopCallbackScheduled() && readCallback_ && evb_) {
+    evb_->runInLoop(this);
+  }
+}
+
+void InProcessTransport::runLoopCallback() noexcept {
+  deliver();
+}
+
+void InProcessTransport::deliver() {
+  DestructorGuard dg(this);
+  while (readCallback_ && !pendingIngress_.empty()) {
+    if (readCallback_->isBufferMovable()) {
+      readCallback_->readBufferAvailable(pendingIngress_.move());
+      break;
+    }
+    // non-movable consumer: copy into its buffer
+    void* buf = nullptr;
+    size_t bufLen = 0;
+    readCallback_->getReadBuffer(&buf, &bufLen);
+    if (!buf || bufLen == 0) {
+      folly::AsyncSocketException ex(folly::AsyncSocketException::BAD_ARGS,
+                                     "no read buffer");
+      auto callback = readCallback_;
+      readCallback_ = nullptr;
+      callback->readErr(ex);
+      return;
+    }
+    auto copied = pendingIngress_.splitAtMost(bufLen);
+    size_t length = 0;
+    for (auto range : *copied) {
+      memcpy(static_cast<uint8_t*>(buf) + length, range.data(), range.size());
+      length += range.size();
+    }
+    readCallback_->readDataAvailable(length);
+  }
+  if (ingressEOF_ && !eofDelivered_ && readCallback_ &&
+      pendingIngress_.empty()) {
+    eofDelivered_ = true;
+    readCallback_->readEOF();
+  }
+}
+
+void InProcessTransport::close() {
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  writesShutdown_ = true;
+  if (peer_) {
+    peer_->peerClosed();
+  }
+  if (readCallback_) {
+    auto callback = readCallback_;
+    readCallback_ = nullptr;
+    if (!eofDelivered_) {
+      eofDelivered_ = true;
+      callback->readEOF();
+    }
+  }
+}
+
+void InProcessTransport::closeNow() {
+  close();
+}
+
+void InProcessTransport::shutdownWrite() {
+  writesShutdown_ = true;
+  if (peer_) {
+    peer_->peerShutdownWrite();
+  }
+}
+
+void InProcessTransport::shutdownWriteNow() {
+  shutdownWrite();
+}
+
+void InProcessTransport::getPeerAddress(folly::SocketAddress* addr) const {
+  addr->setFromIpPort("127.0.0.1", 0);
+}
+
+void InProcessTransport::getLocalAddress(folly::SocketAddress* addr) const {
+  addr->setFromIpPort("127.0.0.1", 0);
+}
+
+bool InProcessTransport::good() const {
+  return !closed_ && peer_ && !peer_->closed_;
+}
+
+bool InProcessTransport::readable() const {
+  return !pendingIngress_.empty();
+}
+
+bool InProcessTransport::connecting() const {
+  return false;
+}
+
+bool InProcessTransport::error() const {
+  return false;
+}
+
+void InProcessTransport::attachEventBase(folly::EventBase* eventBase) {
+  evb_ = eventBase;
+}
+
+void InProcessTransport::detachEventBase() {
+  cancelLoopCallback();
+  evb_ = nullptr;
+}
+
+bool InProcessTransport::isDetachable() const {
+  return !isLoopCallbackScheduled();
+}
+
+folly::EventBase* InProcessTransport::getEventBase() const {
+  return evb_;
+}
+
+void InProcessTransport::setSendTimeout(uint32_t /*milliseconds*/) {
+}
+
+uint32_t InProcessTransport::getSendTimeout() const {
+  return 0;
+}
+
+} // namespace proxygen
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBufQueue.h>
+#include <folly/io/async/AsyncTransport.h>
+#include <folly/io/async/EventBase.h>
+
+namespace proxygen {
+
+/**
+ * In-memory AsyncTransport pair for proxygen-to-proxygen hops inside
+ * one process.  writeChain on one end moves the IOBuf chain straight
+ * into the peer's ingress (no kernel, no copies: HTTPSession's read
+ * callback accepts movable buffers, so the bytes the egress codec
+ * serialized are the bytes the ingress codec parses); delivery is
+ * deferred to a loop callback so a hop behaves like a transport, not
+ * reentrant function calls.  Both ends must live on the same event
+ * base - cross-thread pairs would need an SPSC handoff and a wakeup,
+ * which this deliberately does not attempt, matching the co-located
+ * routing-tier/agent layout it is built for.
+ *
+ * Codec cost remains by design: a codec-bypass handing HTTPMessage
+ * objects across would not be an AsyncTransport and needs a session
+ * that speaks objects instead of bytes.
+ *
+ * Create with makePair(); each end is owned by its session via the
+ * usual UniquePtr (destroy-on-close DelayedDestruction semantics).
+ */
+class InProcessTransport : public folly::AsyncTransportWrapper,
+                           private folly::EventBase::LoopCallback {
+ public:
+  using UniquePtr =
+      std::unique_ptr<InProcessTransport, folly::DelayedDestruction::Destructor>;
+
+  static std::pair<UniquePtr, UniquePtr> makePair(folly::EventBase* evb);
+
+  // AsyncTransport
+  void setReadCB(AsyncTransportWrapper::ReadCallback* callback) override;
+  ReadCallback* getReadCallback() const override;
+  void write(AsyncTransportWrapper::WriteCallback* callback,
+             const void* buf,
+             size_t bytes,
+             folly::WriteFlags flags = folly::WriteFlags::NONE) override;
+  void writev(AsyncTransportWrapper::WriteCallback* callback,
+              const struct iovec* vec,
+              size_t count,
+              folly::WriteFlags flags = folly::WriteFlags::NONE) override;
+  void writeChain(AsyncTransportWrapper::WriteCallback* callback,
+                  std::unique_ptr<folly::IOBuf>&& iob,
+                  folly::WriteFlags flags = folly::WriteFlags::NONE) override;
+  void close() override;
+  void closeNow() override;
+  void shutdownWrite() override;
+  void shutdownWriteNow() override;
+  void getPeerAddress(folly::SocketAddress* addr) const override;
+  void getLocalAddress(folly::SocketAddress* addr) const override;
+  bool good() const override;
+  bool readable() const override;
+  bool connecting() const override;
+  bool error() const override;
+  void attachEventBase(folly::EventBase* eventBase) override;
+  void detachEventBase() override;
+  bool isDetachable() const override;
+  folly::EventBase* getEventBase() const override;
+  void setSendTimeout(uint32_t milliseconds) override;
+  uint32_t getSendTimeout() const override;
+  size_t getAppBytesWritten() const override {
+    return bytesWritten_;
+  }
+  size_t getRawBytesWritten() const override {
+    return bytesWritten_;
+  }
+  size_t getAppBytesReceived() const override {
+    return bytesReceived_;
+  }
+  size_t getRawBytesReceived() const override {
+    return bytesReceived_;
+  }
+
+ private:
+  explicit InProcessTransport(folly::EventBase* evb) : evb_(evb) {
+  }
+
+  ~InProcessTransport() override;
+
+  // peer-side entry points
+  void enqueueFromPeer(std::unique_ptr<folly::IOBuf> chain);
+  void peerShutdownWrite();
+  void peerClosed();
+
+  void runLoopCallback() noexcept override;
+  void scheduleDelivery();
+  void deliver();
+
+  folly::EventBase* evb_;
+  InProcessTransport* peer_{nullptr};
+  ReadCallback* readCallback_{nullptr};
+  folly::IOBufQueue pendingIngress_{folly::IOBufQueue::cacheChainLength()};
+  size_t bytesWritten_{0};
+  size_t bytesReceived_{0};
+  bool ingressEOF_{false};
+  bool eofDelivered_{false};
+  bool writesShutdown_{false};
+  bool closed_{false};
+};
+
+} // namespace proxygen
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/KernelTimestampResolver.h>
+
+#include <glog/logging.h>
+
+#ifdef __linux__
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <netinet/in.h>
+#endif
+
+namespace proxygen {
+
+bool KernelTimestampResolver::enableTimestamping(folly::AsyncSocket* sock) {
+#ifdef __linux__
+  const uint32_t flags = SOF_TIMESTAMPING_SOFTWARE |
+      SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_TX_ACK |
+      SOF_TIMESTAMPING_OPT_ID;
+  const auto rc =
+      sock->setSockOpt(SOL_SOCKET, SO_TIMESTAMPING, &flags);
+  return rc == 0;
+#else
+  (void)sock;
+  return false;
+#endif
+}
+
+void KernelTimestampResolver::errMessage(const cmsghdr& cmsg) noexcept {
+#ifdef __linux__
+  if (cmsg.cmsg_level == SOL_SOCKET && cmsg.cmsg_type == SCM_TIMESTAMPING) {
+    auto ts = reinterpret_cast<const struct scm_timestamping*>(CMSG_DATA(&cmsg));
+    // ts[0] holds the software timestamp
+    timestamp_ = TimePoint(std::chrono::duration_cast<TimePoint::duration>(
+        std::chrono::seconds(ts->ts[0].tv_sec) +
+        std::chrono::nanoseconds(ts->ts[0].tv_nsec)));
+    haveTimestamp_ = true;
+    maybeDeliver();
+  } else if ((cmsg.cmsg_level == SOL_IP && cmsg.cmsg_type == IP_RECVERR) ||
+             (cmsg.cmsg_level == SOL_IPV6 && cmsg.cmsg_type == IPV6_RECVERR)) {
+    auto serr =
+        reinterpret_cast<const struct sock_extended_err*>(CMSG_DATA(&cmsg));
+    if (serr->ee_errno != ENOMSG ||
+        serr->ee_origin != SO_EE_ORIGIN_TIMESTAMPING) {
+      return;
+    }
+    errType_ = serr->ee_info;
+    byteOffset_ = serr->ee_data;
+    haveError_ = true;
+    maybeDeliver();
+  }
+#else
+  (void)cmsg;
+#endif
+}
+
+void KernelTimestampResolver::maybeDeliver() noexcept {
+#ifdef __linux__
+  if (!haveTimestamp_ || !haveError_) {
+    return;
+  }
+  haveTimestamp_ = false;
+  haveError_ = false;
+  if (!callback_) {
+    return;
+  }
+  switch (errType_) {
+    case SCM_TSTAMP_SND:
+      callback_->onTxTimestamp(byteOffset_, timestamp_);
+      break;
+    case SCM_TSTAMP_ACK:
+      callback_->onAckTimestamp(byteOffset_, timestamp_);
+      break;
+    default:
+      VLOG(5) << "ignoring timestamp record type=" << errType_;
+      break;
+  }
+#endif
+}
+
+void KernelTimestampResolver::errMessageError(
+    const folly::AsyncSocketException& ex) noexcept {
+  VLOG(4) << "error reading socket error queue: " << folly::exceptionStr(ex);
+}
+
+} // namespace proxygen
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/async/AsyncSocket.h>
+#include <proxygen/lib/utils/Time.h>
+
+namespace proxygen {
+
+/**
+ * Batched kernel TX/ACK timestamping: install as the AsyncSocket's
+ * ErrMessageCallback after enableTimestamping(), and the socket error
+ * queue is drained once per loop by the transport instead of polling
+ * per write. SO_TIMESTAMPING with OPT_ID tags each record with the
+ * egress byte offset at send time, so records resolve directly against
+ * tracked byte events; SND and ACK records are delivered to the
+ * callback with the kernel's software timestamps.
+ *
+ * The kernel delivers a timestamp as two control messages
+ * (SCM_TIMESTAMPING plus the extended error carrying type and byte
+ * offset, in either order); this class pairs them up.
+ */
+class KernelTimestampResolver : public folly::AsyncSocket::ErrMessageCallback {
+ public:
+  class Callback {
+   public:
+    virtual ~Callback() {
+    }
+    /**
+     * byteOffset is the last egress byte covered by the record, as
+     * counted by the kernel from the point timestamping was enabled.
+     * Timestamps carry the kernel clock in a TimePoint; compare them
+     * against each other, not against getCurrentTime().
+     */
+    virtual void onTxTimestamp(uint32_t byteOffset, TimePoint ts) noexcept = 0;
+    virtual void onAckTimestamp(uint32_t byteOffset,
+                                TimePoint ts) noexcept = 0;
+  };
+
+  explicit KernelTimestampResolver(Callback* callback)
+      : callback_(callback) {
+  }
+
+  /**
+   * Request software TX and ACK timestamps with byte-offset ids on the
+   * socket. Returns false if the kernel refuses (the caller falls back
+   * to write-callback timing).
+   */
+  static bool enableTimestamping(folly::AsyncSocket* sock);
+
+  // folly::AsyncSocket::ErrMessageCallback
+  void errMessage(const cmsghdr& cmsg) noexcept override;
+  void errMessageError(const folly::AsyncSocketException& ex) noexcept override;
+
+ private:
+  void maybeDeliver() noexcept;
+
+  Callback* callback_;
+
+  // halves of the in-flight record, paired in maybeDeliver()
+  bool haveTimestamp_{false};
+  TimePoint timestamp_;
+  bool haveError_{false};
+  uint32_t errType_{0};
+  uint32_t byteOffset_{0};
+};
+
+} // namespace proxygen
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/SessionMemoryGovernor.h>
+
+#include <algorithm>
+#include <functional>
+#include <glog/logging.h>
+#include <vector>
+
+namespace proxygen {
+
+SessionMemoryGovernor::~SessionMemoryGovernor() {
+  // release any backpressure we still hold so sessions outliving the
+  // governor aren't wedged
+  for (auto session : paused_) {
+    session->setIngressMemoryBackpressure(false);
+  }
+}
+
+void SessionMemoryGovernor::addSession(HTTPSessionBase* session) {
+  sessions_.insert(session);
+}
+
+void SessionMemoryGovernor::removeSession(HTTPSessionBase* session) {
+  sessions_.erase(session);
+  paused_.erase(session);
+}
+
+uint64_t SessionMemoryGovernor::evaluate() {
+  uint64_t total = 0;
+  std::vector<std::pair<uint64_t, HTTPSessionBase*>> bySize;
+  bySize.reserve(sessions_.size());
+  for (auto session : sessions_) {
+    auto bytes = session->getMemoryFootprint().total();
+    total += bytes;
+    bySize.emplace_back(bytes, session);
+  }
+
+  if (total > highWatermark_) {
+    if (stallPolicy_) {
+      // pressure plus a stalled egress path marks a slow client; give
+      // the worst offender to the policy before squeezing everyone
+      HTTPSessionBase* worst = nullptr;
+      double worstScore = stallMinScore_;
+      for (auto session : sessions_) {
+        auto score = session->getEgressStallScore();
+        if (score >= worstScore) {
+          worstScore = score;
+          worst = session;
+        }
+      }
+      if (worst) {
+        stallPolicy_(worst);
+      }
+    }
+    // pause heaviest-first until what's left unpaused fits under the
+    // low watermark
+    std::sort(bySize.begin(), bySize.end(), std::greater<>());
+    uint64_t unpausedBytes = total;
+    for (const auto& entry : bySize) {
+      if (!sessions_.count(entry.second)) {
+        // the stall policy dropped it; the snapshot pointer is dead
+        unpausedBytes -= entry.first;
+        continue;
+      }
+      if (paused_.count(entry.second)) {
+        unpausedBytes -= entry.first;
+        continue;
+      }
+      if (unpausedBytes <= lowWatermark_) {
+        break;
+      }
+      VLOG(4) << "Memory governor pausing session holding " << entry.first
+              << " bytes, total=" << total;
+      entry.second->setIngressMemoryBackpressure(true);
+      paused_.insert(entry.second);
+      unpausedBytes -= entry.first;
+    }
+  } else if (total <= lowWatermark_ && !paused_.empty()) {
+    for (auto session : paused_) {
+      session->setIngressMemoryBackpressure(false);
+    }
+    paused_.clear();
+  }
+  return total;
+}
+
+} // namespace proxygen
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Function.h>
+#include <folly/container/F14Set.h>
+#include <proxygen/lib/http/session/HTTPSessionBase.h>
+
+namespace proxygen {
+
+/**
+ * Per-worker watermark enforcement over the buffered memory of a set of
+ * sessions. The owner registers sessions on accept and must deregister
+ * them before destruction, then calls evaluate() periodically (e.g.
+ * from a worker timer). When the summed footprint crosses the high
+ * watermark, the heaviest sessions get their ingress paused via
+ * HTTPSessionBase::setIngressMemoryBackpressure until the unpaused
+ * remainder fits under the low watermark; once the total drains below
+ * the low watermark everything is resumed.
+ *
+ * Not thread-safe: one instance per worker thread.
+ */
+class SessionMemoryGovernor {
+ public:
+  explicit SessionMemoryGovernor(uint64_t highWatermarkBytes,
+                                 double lowWatermarkFraction = 0.8)
+      : highWatermark_(highWatermarkBytes),
+        lowWatermark_(uint64_t(highWatermarkBytes * lowWatermarkFraction)) {
+  }
+
+  ~SessionMemoryGovernor();
+
+  void addSession(HTTPSessionBase* session);
+
+  void removeSession(HTTPSessionBase* session);
+
+  /**
+   * Re-sum the footprints and apply/release backpressure as needed.
+   * Returns the total buffered bytes observed.
+   */
+  uint64_t evaluate();
+
+  /**
+   * Slow-client action under pressure: while the total footprint is
+   * over the high watermark, each evaluate() also hands the session
+   * with the highest egress stall score (if it meets minScore; see
+   * HTTPSessionBase::getEgressStallScore) to the policy, which may
+   * deprioritize or drop it.  A policy that destroys the session must
+   * do so through a path that calls removeSession.
+   */
+  void setStallPolicy(double minScore,
+                      folly::Function<void(HTTPSessionBase*)> policy) {
+    stallMinScore_ = minScore;
+    stallPolicy_ = std::move(policy);
+  }
+
+  size_t numPausedSessions() const {
+    return paused_.size();
+  }
+
+  size_t numSessions() const {
+    return sessions_.size();
+  }
+
+ private:
+  uint64_t highWatermark_;
+  uint64_t lowWatermark_;
+  double stallMinScore_{0};
+  folly::Function<void(HTTPSessionBase*)> stallPolicy_;
+  folly::F14FastSet<HTTPSessionBase*> sessions_;
+  folly::F14FastSet<HTTPSessionBase*> paused_;
+};
+
+} // namespace proxygen
@@ -10,7 +10,9 @@
 
 #include <proxygen/lib/http/session/CodecErrorResponseHandler.h>
 #include <proxygen/lib/http/session/HTTPDirectResponseHandler.h>
+#include <proxygen/lib/http/session/EarlyDataGateHandler.h>
 #include <proxygen/lib/http/session/HTTPSessionAcceptor.h>
+#include <proxygen/lib/services/RequestWorkerThread.h>
 
 namespace proxygen {
 
@@ -21,7 +23,25 @@ SimpleController::SimpleController(HTTPSessionAcceptor* acceptor)
 HTTPTransactionHandler* SimpleController::getRequestHandler(
     HTTPTransaction& txn, HTTPMessage* msg) {
   CHECK(acceptor_) << "Requires an acceptor, or override this method";
-  return acceptor_->newHandler(txn, msg);
+  // When this worker's event loop has fallen behind, shed the request
+  // with a fast 503 before any handler work runs
+  auto worker = dynamic_cast<RequestWorkerThread*>(
+      WorkerThread::getCurrentWorkerThread());
+  if (worker && worker->shouldShedLoad()) {
+    VLOG(3) << "Shedding request, loop lag=" << worker->getLoopLag().count()
+            << "us";
+    folly::SocketAddress localAddress;
+    txn.getLocalAddress(localAddress);
+    return createErrorHandler(
+        503, "Service Unavailable", acceptor_->getErrorPage(localAddress));
+  }
+  auto handler = acceptor_->newHandler(txn, msg);
+  auto earlyDataPolicy = acceptor_->getEarlyDataPolicy();
+  if (handler && earlyDataPolicy) {
+    // requests on not-yet-replay-safe transports get policy-gated
+    handler = new EarlyDataGateHandler(handler, earlyDataPolicy);
+  }
+  return handler;
 }
 
 HTTPTransactionHandler* SimpleController::getParseErrorHandler(
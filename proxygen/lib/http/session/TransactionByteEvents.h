@@ -30,6 +30,27 @@ class TransactionByteEvent : public ByteEvent {
     return txn_;
   }
 
+  /**
+   * These events are created and destroyed at up to two per response;
+   * same-size instances recycle through a per-thread free list.
+   * Subclasses of a different size fall through to the global heap
+   * (the virtual deleting destructor reports the dynamic size).
+   */
+  static void* operator new(std::size_t size) {
+    if (size == sizeof(TransactionByteEvent)) {
+      return detail::allocateByteEvent(size);
+    }
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* ptr, std::size_t size) {
+    if (size == sizeof(TransactionByteEvent)) {
+      detail::recycleByteEvent(ptr, size);
+      return;
+    }
+    ::operator delete(ptr);
+  }
+
   HTTPTransaction* txn_;
 };
 
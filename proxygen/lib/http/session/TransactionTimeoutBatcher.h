@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <folly/io/async/HHWheelTimer.h>
+#include <proxygen/lib/utils/Time.h>
+#include <unordered_map>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Shares one coarse wheel timer among all the transactions of a session.
+ *
+ * Individual transactions refresh their deadline with a hash-map update
+ * instead of rescheduling a wheel timer callback, so at 10k+ refreshes per
+ * second the timer is touched at most once per tick rather than once per
+ * ingress event. Deadlines are checked lazily when the coarse timer fires;
+ * the cost is that a transaction can expire up to one tick late, which is
+ * fine for idle timeouts.
+ */
+class TransactionTimeoutBatcher : private folly::HHWheelTimer::Callback {
+ public:
+  TransactionTimeoutBatcher(folly::HHWheelTimer* timer,
+                            std::chrono::milliseconds tickInterval)
+      : timer_(timer), tickInterval_(tickInterval) {
+  }
+
+  ~TransactionTimeoutBatcher() override {
+    cancelTimeout();
+  }
+
+  /**
+   * Push out the deadline for the given member to timeout from now.
+   * Schedules the shared timer only if it isn't already pending.
+   */
+  void refresh(folly::HHWheelTimer::Callback* member,
+               std::chrono::milliseconds timeout) {
+    deadlines_[member] = getCurrentTime() + timeout;
+    if (timer_ && !isScheduled()) {
+      timer_->scheduleTimeout(this, tickInterval_);
+    }
+  }
+
+  /**
+   * Forget a member; the shared timer keeps running for the others and
+   * lapses on its own once nobody is registered.
+   */
+  void remove(folly::HHWheelTimer::Callback* member) {
+    deadlines_.erase(member);
+  }
+
+  size_t numMembers() const {
+    return deadlines_.size();
+  }
+
+ private:
+  void timeoutExpired() noexcept override {
+    auto now = getCurrentTime();
+    // collect first: firing a member's timeoutExpired may add/remove
+    // entries (including itself) from under the iteration
+    std::vector<folly::HHWheelTimer::Callback*> expired;
+    for (const auto& entry : deadlines_) {
+      if (entry.second <= now) {
+        expired.push_back(entry.first);
+      }
+    }
+    for (auto member : expired) {
+      if (deadlines_.erase(member)) {
+        member->timeoutExpired();
+      }
+    }
+    if (timer_ && !deadlines_.empty()) {
+      timer_->scheduleTimeout(this, tickInterval_);
+    }
+  }
+
+  folly::HHWheelTimer* timer_;
+  std::chrono::milliseconds tickInterval_;
+  std::unordered_map<folly::HHWheelTimer::Callback*, TimePoint> deadlines_;
+};
+
+} // namespace proxygen
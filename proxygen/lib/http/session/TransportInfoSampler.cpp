@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/TransportInfoSampler.h>
+
+#include <algorithm>
+#include <proxygen/lib/http/session/HTTPSessionBase.h>
+#include <wangle/acceptor/TransportInfo.h>
+
+namespace proxygen {
+
+TransportInfoSampler::TransportInfoSampler(folly::EventBase* evb,
+                                           std::chrono::milliseconds interval,
+                                           size_t sessionsPerTick)
+    : folly::AsyncTimeout(evb),
+      interval_(interval),
+      sessionsPerTick_(std::max<size_t>(sessionsPerTick, 1)),
+      cursor_(sessions_.end()) {
+}
+
+void TransportInfoSampler::addSession(HTTPSessionBase* session) {
+  if (index_.count(session)) {
+    return;
+  }
+  index_[session] = sessions_.insert(sessions_.end(), session);
+  if (!isScheduled()) {
+    scheduleNextTick();
+  }
+}
+
+void TransportInfoSampler::removeSession(HTTPSessionBase* session) {
+  auto indexIt = index_.find(session);
+  if (indexIt == index_.end()) {
+    return;
+  }
+  auto it = indexIt->second;
+  if (cursor_ == it) {
+    ++cursor_;
+  }
+  sessions_.erase(it);
+  index_.erase(indexIt);
+}
+
+void TransportInfoSampler::scheduleNextTick() {
+  // spread one full pass over the interval: with n sessions and a
+  // slice of sessionsPerTick_, ceil(n / slice) ticks make up a round
+  const auto ticksPerRound = std::max<size_t>(
+      (sessions_.size() + sessionsPerTick_ - 1) / sessionsPerTick_, 1);
+  auto tickInterval = interval_ / ticksPerRound;
+  if (tickInterval < std::chrono::milliseconds(1)) {
+    tickInterval = std::chrono::milliseconds(1);
+  }
+  scheduleTimeout(tickInterval);
+}
+
+void TransportInfoSampler::timeoutExpired() noexcept {
+  wangle::TransportInfo scratch;
+  for (size_t i = 0; i < sessionsPerTick_ && !sessions_.empty(); i++) {
+    if (cursor_ == sessions_.end()) {
+      cursor_ = sessions_.begin();
+    }
+    // refreshes the session's cached snapshot; observers read it via
+    // getCurrentTransportInfoWithoutUpdate()
+    (*cursor_)->getCurrentTransportInfo(&scratch);
+    ++cursor_;
+  }
+  if (!sessions_.empty()) {
+    scheduleNextTick();
+  }
+}
+
+} // namespace proxygen
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <list>
+#include <unordered_map>
+
+namespace proxygen {
+
+class HTTPSessionBase;
+
+/**
+ * Worker-level transport-info sampling.  Observability code that polls
+ * getCurrentTransportInfo() pays a getsockopt(TCP_INFO) per call; with
+ * many observers per session, or many sessions per worker, that either
+ * gets expensive or forces undersampling.
+ *
+ * Sessions register here instead; the sampler walks the worker's
+ * registered sessions once per interval, in slices spread across timer
+ * ticks so a worker with tens of thousands of sessions never stalls
+ * its loop on one bulk collection.  Each visit refreshes the session's
+ * cached snapshot (one syscall), and observers read the cache via
+ * getCurrentTransportInfoWithoutUpdate() - one syscall per session per
+ * interval, amortized, regardless of how many observers query.
+ *
+ * Single-threaded: construct, register and destroy on the worker's
+ * event base.  Sessions must unregister before they are destroyed.
+ */
+class TransportInfoSampler : private folly::AsyncTimeout {
+ public:
+  TransportInfoSampler(folly::EventBase* evb,
+                       std::chrono::milliseconds interval,
+                       size_t sessionsPerTick = 64);
+
+  ~TransportInfoSampler() override = default;
+
+  void addSession(HTTPSessionBase* session);
+  void removeSession(HTTPSessionBase* session);
+
+  size_t numSessions() const {
+    return sessions_.size();
+  }
+
+ private:
+  void timeoutExpired() noexcept override;
+
+  void scheduleNextTick();
+
+  std::chrono::milliseconds interval_;
+  size_t sessionsPerTick_;
+  std::list<HTTPSessionBase*> sessions_;
+  // O(1) removal under churn; a linear scan would go quadratic at the
+  // session counts this is built for
+  std::unordered_map<HTTPSessionBase*, std::list<HTTPSessionBase*>::iterator>
+      index_;
+  // round-robin cursor into sessions_; kept valid by removeSession
+  std::list<HTTPSessionBase*>::iterator cursor_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/UrgencyPriorityQueue.h>
+
+#include <folly/lang/Bits.h>
+
+namespace proxygen {
+
+UrgencyPriorityQueue::~UrgencyPriorityQueue() {
+  for (auto& ring : rings_) {
+    while (!ring.empty()) {
+      ring.pop_front();
+    }
+  }
+}
+
+UrgencyPriorityQueue::Handle UrgencyPriorityQueue::addTransaction(
+    HTTPCodec::StreamID id,
+    uint8_t urgency,
+    bool incremental,
+    HTTPTransaction* txn) {
+  DCHECK(nodes_.find(id) == nodes_.end()) << "Duplicate stream id=" << id;
+  auto node = std::make_unique<Node>(
+      id, txn, std::min(urgency, uint8_t(kNumUrgencies - 1)), incremental);
+  auto handle = node.get();
+  nodes_[id] = std::move(node);
+  return handle;
+}
+
+UrgencyPriorityQueue::Handle UrgencyPriorityQueue::addTransaction(
+    HTTPCodec::StreamID id,
+    http2::PriorityUpdate pri,
+    HTTPTransaction* txn,
+    bool /*permanent*/,
+    uint64_t* depth) {
+  if (depth) {
+    *depth = 1;
+  }
+  return addTransaction(
+      id, urgencyFromWeight(pri.weight), true /* incremental */, txn);
+}
+
+UrgencyPriorityQueue::Handle UrgencyPriorityQueue::updatePriority(
+    Handle handle, http2::PriorityUpdate pri, uint64_t* depth) {
+  if (depth) {
+    *depth = 1;
+  }
+  auto node = static_cast<Node*>(handle);
+  return updatePriority(handle, urgencyFromWeight(pri.weight),
+                        node->incremental_);
+}
+
+UrgencyPriorityQueue::Handle UrgencyPriorityQueue::updatePriority(
+    Handle handle, uint8_t urgency, bool incremental) {
+  auto node = static_cast<Node*>(handle);
+  urgency = std::min(urgency, uint8_t(kNumUrgencies - 1));
+  node->incremental_ = incremental;
+  if (node->urgency_ == urgency) {
+    return handle;
+  }
+  const bool enqueued = node->isEnqueued();
+  if (enqueued) {
+    clearPendingEgress(handle);
+  }
+  node->urgency_ = urgency;
+  if (enqueued) {
+    signalPendingEgress(handle);
+  }
+  return handle;
+}
+
+void UrgencyPriorityQueue::removeTransaction(Handle handle) {
+  auto node = static_cast<Node*>(handle);
+  if (node->isEnqueued()) {
+    clearPendingEgress(handle);
+  }
+  nodes_.erase(node->id_);
+}
+
+void UrgencyPriorityQueue::signalPendingEgress(Handle h) {
+  auto node = static_cast<Node*>(h);
+  if (node->isEnqueued()) {
+    return;
+  }
+  rings_[node->urgency_].push_back(*node);
+  occupancy_ |= (1 << node->urgency_);
+  numEnqueued_++;
+}
+
+void UrgencyPriorityQueue::clearPendingEgress(Handle h) {
+  auto node = static_cast<Node*>(h);
+  if (!node->isEnqueued()) {
+    return;
+  }
+  node->listHook_.unlink();
+  numEnqueued_--;
+  if (rings_[node->urgency_].empty()) {
+    occupancy_ &= ~(1 << node->urgency_);
+  }
+}
+
+void UrgencyPriorityQueue::nextEgress(NextEgressResult& result) {
+  result.clear();
+  if (occupancy_ == 0) {
+    return;
+  }
+  // highest urgency == lowest set bit
+  const uint8_t urgency = folly::findFirstSet(occupancy_) - 1;
+  auto& ring = rings_[urgency];
+  DCHECK(!ring.empty());
+  if (!ring.front().incremental_) {
+    // non-incremental streams get the whole quantum, in FIFO order
+    result.emplace_back(ring.front().txn_, 1.0);
+    return;
+  }
+  // the head run of incremental streams shares the quantum equally;
+  // rotate them to the back for round-robin across loops
+  std::vector<Node*> run;
+  for (auto& node : ring) {
+    if (!node.incremental_) {
+      break;
+    }
+    run.push_back(&node);
+  }
+  const double share = 1.0 / run.size();
+  for (auto node : run) {
+    result.emplace_back(node->txn_, share);
+    node->listHook_.unlink();
+  }
+  for (auto node : run) {
+    ring.push_back(*node);
+  }
+}
+
+} // namespace proxygen
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <folly/IntrusiveList.h>
+#include <folly/container/F14Map.h>
+#include <proxygen/lib/http/session/HTTP2PriorityQueue.h>
+
+namespace proxygen {
+
+/**
+ * Flat egress scheduler implementing RFC 9218 urgency/incremental
+ * semantics: eight intrusive FIFO rings (urgency 0 is highest) plus an
+ * occupancy bitmap, so next-egress selection is a find-first-set over
+ * the bitmap instead of a dependency-tree walk.
+ *
+ * Implements the HTTP2PriorityQueueBase handle interface so
+ * transactions signal/clear pending egress exactly as with the tree
+ * queue. HTTP/2 PRIORITY weights map coarsely onto urgencies (weight
+ * 255..0 -> urgency 0..7); dependencies and exclusivity are ignored.
+ *
+ * Non-incremental streams are served to completion in FIFO order
+ * within their urgency; incremental streams at the head of a ring
+ * share the write quantum equally and round-robin.
+ */
+class UrgencyPriorityQueue : public HTTP2PriorityQueueBase {
+ public:
+  static constexpr uint8_t kNumUrgencies = 8;
+  // RFC 9218 default urgency
+  static constexpr uint8_t kDefaultUrgency = 3;
+
+  using NextEgressResult = HTTP2PriorityQueue::NextEgressResult;
+
+  explicit UrgencyPriorityQueue(HTTPCodec::StreamID rootNodeId = 0)
+      : HTTP2PriorityQueueBase(rootNodeId) {
+  }
+
+  ~UrgencyPriorityQueue() override;
+
+  /**
+   * Add a transaction with explicit RFC 9218 parameters.
+   */
+  Handle addTransaction(HTTPCodec::StreamID id,
+                        uint8_t urgency,
+                        bool incremental,
+                        HTTPTransaction* txn);
+
+  /**
+   * HTTP2PriorityQueueBase interface; the h2 weight is mapped onto an
+   * urgency and streams are treated as incremental.
+   */
+  Handle addTransaction(HTTPCodec::StreamID id,
+                        http2::PriorityUpdate pri,
+                        HTTPTransaction* txn,
+                        bool permanent = false,
+                        uint64_t* depth = nullptr) override;
+
+  Handle updatePriority(Handle handle,
+                        http2::PriorityUpdate pri,
+                        uint64_t* depth = nullptr) override;
+
+  Handle updatePriority(Handle handle, uint8_t urgency, bool incremental);
+
+  void removeTransaction(Handle handle) override;
+
+  void signalPendingEgress(Handle h) override;
+
+  void clearPendingEgress(Handle h) override;
+
+  // priority nodes are meaningless without a dependency tree
+  void addPriorityNode(HTTPCodec::StreamID /*id*/,
+                       HTTPCodec::StreamID /*parent*/) override {
+  }
+
+  /**
+   * Select the transactions to egress next: the FIFO head of the
+   * highest-urgency non-empty ring, or, for incremental streams, the
+   * head run of the ring with equal shares, rotated for round-robin.
+   */
+  void nextEgress(NextEgressResult& result);
+
+  bool empty() const {
+    return occupancy_ == 0;
+  }
+
+  uint64_t numPendingEgress() const {
+    return numEnqueued_;
+  }
+
+  size_t numStreams() const {
+    return nodes_.size();
+  }
+
+ private:
+  class Node : public BaseNode {
+   public:
+    Node(HTTPCodec::StreamID id,
+         HTTPTransaction* txn,
+         uint8_t urgency,
+         bool incremental)
+        : id_(id), txn_(txn), urgency_(urgency), incremental_(incremental) {
+    }
+
+    bool isEnqueued() const override {
+      return listHook_.is_linked();
+    }
+
+    uint64_t calculateDepth(bool /*includeVirtual*/ = true) const override {
+      // flat scheduler: every stream hangs off the root
+      return 1;
+    }
+
+    folly::IntrusiveListHook listHook_;
+    HTTPCodec::StreamID id_;
+    HTTPTransaction* txn_;
+    uint8_t urgency_;
+    bool incremental_;
+  };
+
+  static uint8_t urgencyFromWeight(uint8_t weight) {
+    // h2 weight 255..0 -> urgency 0..7
+    return kNumUrgencies - 1 - (weight / 32);
+  }
+
+  using NodeList = folly::IntrusiveList<Node, &Node::listHook_>;
+
+  std::array<NodeList, kNumUrgencies> rings_;
+  uint8_t occupancy_{0};
+  uint64_t numEnqueued_{0};
+  folly::F14FastMap<HTTPCodec::StreamID, std::unique_ptr<Node>> nodes_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/WorkerEgressScheduler.h>
+
+#include <algorithm>
+#include <glog/logging.h>
+#include <proxygen/lib/http/session/HTTPSession.h>
+
+namespace proxygen {
+
+WorkerEgressScheduler& WorkerEgressScheduler::getThreadScheduler() {
+  static thread_local WorkerEgressScheduler scheduler;
+  return scheduler;
+}
+
+void WorkerEgressScheduler::enqueue(HTTPSession* session,
+                                    uint8_t weight,
+                                    folly::EventBase* evb) {
+  DCHECK(evb->isInEventBaseThread());
+  evb_ = evb;
+  queue_.push_back(Entry{session, 0, std::max<uint8_t>(weight, 1)});
+  if (!isLoopCallbackScheduled()) {
+    evb_->runInLoop(this);
+  }
+}
+
+void WorkerEgressScheduler::remove(HTTPSession* session) {
+  for (auto it = queue_.begin(); it != queue_.end();) {
+    if (it->session == session) {
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void WorkerEgressScheduler::runLoopCallback() noexcept {
+  uint64_t budget = iterationBudget_;
+  // bounded by the entries present at pass start: every round either
+  // writes, parks a blocked session, or retires a finished one
+  size_t rounds = queue_.size();
+  while (budget > 0 && rounds-- > 0 && !queue_.empty()) {
+    Entry entry = queue_.front();
+    queue_.pop_front();
+    const uint64_t quantum = baseQuantum_ * entry.weight;
+    entry.deficit = std::min(entry.deficit + quantum, quantum * 4);
+    bool morePending = false;
+    uint64_t written = entry.session->flushBudgeted(
+        std::min(entry.deficit, budget), morePending);
+    budget -= std::min(written, budget);
+    entry.deficit -= std::min(written, entry.deficit);
+    if (!morePending) {
+      continue; // drained; flushBudgeted cleared its scheduled flag
+    }
+    if (written == 0) {
+      // blocked (flow control, pacing, socket write in flight): park
+      // it off the ready queue.  The egress event that unblocks it -
+      // WINDOW_UPDATE, write completion, pacing timer - re-enters
+      // scheduleWrite, which re-enqueues; polling it every loop
+      // iteration would spin the worker until that event arrives.
+      entry.session->parkFairEgress();
+      continue;
+    }
+    queue_.push_back(entry);
+  }
+  if (!queue_.empty()) {
+    // sessions that wrote this pass and still have egress get the
+    // next iteration's budget; blocked ones were parked above, so
+    // re-arming here never spins without progress
+    evb_->runInLoop(this);
+  }
+}
+
+} // namespace proxygen
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <folly/io/async/EventBase.h>
+
+namespace proxygen {
+
+class HTTPSession;
+
+/**
+ * Per-worker deficit-round-robin egress scheduler.
+ *
+ * Left to themselves, sessions flush independently at the end of the
+ * loop iteration, so one session with megabytes of egress can
+ * monopolize the iteration's socket writes while hundreds of small
+ * responses on other sessions wait - inter-session fairness is
+ * otherwise unmanaged.  Sessions opted in via
+ * HTTPSession::enableWorkerFairEgress register here instead of
+ * scheduling their own loop callback; one scheduler pass per
+ * iteration walks the ready queue DRR-style, granting each session a
+ * quantum scaled by its weight (the priority class) plus any deficit
+ * carried from short flushes, within an overall per-iteration byte
+ * budget.  Sessions with leftover egress re-queue for the next
+ * iteration, so no session's share exceeds its weighted fraction for
+ * long.
+ *
+ * One instance per worker thread (getThreadScheduler), touched only
+ * from that thread; sessions with weight 0 bypass it entirely and
+ * keep today's behavior.
+ */
+class WorkerEgressScheduler : private folly::EventBase::LoopCallback {
+ public:
+  static WorkerEgressScheduler& getThreadScheduler();
+
+  /** Queue a session with pending egress; called from scheduleWrite. */
+  void enqueue(HTTPSession* session, uint8_t weight, folly::EventBase* evb);
+
+  /** Drop a session (destruction with egress still queued). */
+  void remove(HTTPSession* session);
+
+  /** Total bytes one scheduler pass may hand to the socket layer. */
+  void setIterationBudget(uint64_t bytes) {
+    iterationBudget_ = bytes;
+  }
+
+  /** Per-round allowance for weight 1; scaled by each session's weight. */
+  void setBaseQuantum(uint64_t bytes) {
+    baseQuantum_ = bytes;
+  }
+
+  size_t numQueuedSessions() const {
+    return queue_.size();
+  }
+
+ private:
+  void runLoopCallback() noexcept override;
+
+  struct Entry {
+    HTTPSession* session;
+    uint64_t deficit;
+    uint8_t weight;
+  };
+
+  std::deque<Entry> queue_;
+  folly::EventBase* evb_{nullptr};
+  uint64_t iterationBudget_{1024 * 1024};
+  uint64_t baseQuantum_{16 * 1024};
+};
+
+} // namespace proxygen
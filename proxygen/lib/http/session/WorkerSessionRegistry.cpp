@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/session/WorkerSessionRegistry.h>
+
+#include <fcntl.h>
+#include <folly/portability/Unistd.h>
+#include <glog/logging.h>
+#include <proxygen/lib/http/session/HTTPSessionBase.h>
+#include <vector>
+
+namespace proxygen {
+
+WorkerSessionRegistry& WorkerSessionRegistry::getThreadRegistry() {
+  static thread_local WorkerSessionRegistry registry;
+  return registry;
+}
+
+void WorkerSessionRegistry::add(HTTPSessionBase* session) {
+  if (index_.count(session)) {
+    return;
+  }
+  index_[session] = sessions_.insert(sessions_.end(), session);
+}
+
+void WorkerSessionRegistry::remove(HTTPSessionBase* session) {
+  auto it = index_.find(session);
+  if (it == index_.end()) {
+    return;
+  }
+  if (snapshotFd_ >= 0 && snapshotCursor_ == it->second) {
+    ++snapshotCursor_;
+  }
+  if (drainActive_ && drainCursor_ == it->second) {
+    ++drainCursor_;
+  }
+  sessions_.erase(it->second);
+  index_.erase(it);
+}
+
+void WorkerSessionRegistry::drainAll(folly::EventBase* evb,
+                                     size_t sessionsPerSlice) {
+  if (drainActive_) {
+    return; // a drain is already walking the table
+  }
+  drainActive_ = true;
+  drainEvb_ = evb;
+  drainPerSlice_ = std::max<size_t>(sessionsPerSlice, 1);
+  drainStartCount_ = sessions_.size();
+  drainCursor_ = sessions_.begin();
+  evb->runInLoop([this] { drainSlice(); });
+}
+
+void WorkerSessionRegistry::drainSlice() {
+  size_t processed = 0;
+  while (drainCursor_ != sessions_.end() && processed < drainPerSlice_) {
+    auto session = *drainCursor_;
+    ++drainCursor_;
+    processed++;
+    // GOAWAY (or equivalent) now; the session destroys itself when its
+    // streams quiesce, spreading teardown cost naturally
+    session->notifyPendingShutdown();
+    session->closeWhenIdle();
+  }
+  if (drainCursor_ != sessions_.end()) {
+    drainEvb_->runInLoop([this] { drainSlice(); });
+    return;
+  }
+  drainActive_ = false;
+  drainEvb_ = nullptr;
+}
+
+bool WorkerSessionRegistry::snapshot(folly::EventBase* evb,
+                                     const std::string& path,
+                                     size_t sessionsPerSlice) {
+  if (snapshotFd_ >= 0) {
+    return false; // capture already in progress
+  }
+  snapshotFd_ =
+      ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  if (snapshotFd_ < 0) {
+    PLOG(ERROR) << "Failed to open session snapshot file " << path;
+    return false;
+  }
+  snapshotEvb_ = evb;
+  sessionsPerSlice_ = std::max<size_t>(sessionsPerSlice, 1);
+  snapshotCursor_ = sessions_.begin();
+  evb->runInLoop([this] { writeSlice(); });
+  return true;
+}
+
+void WorkerSessionRegistry::writeSlice() {
+  std::vector<Record> records;
+  records.reserve(std::min(sessionsPerSlice_, sessions_.size()));
+  size_t processed = 0;
+  while (snapshotCursor_ != sessions_.end() &&
+         processed < sessionsPerSlice_) {
+    auto session = *snapshotCursor_;
+    ++snapshotCursor_;
+    processed++;
+
+    Record record;
+    record.sessionId = reinterpret_cast<uintptr_t>(session);
+    auto footprint = session->getMemoryFootprint();
+    record.bufferedEgressBytes = footprint.egressBufferedBytes;
+    record.bufferedIngressBytes = footprint.ingressBufferedBytes;
+    record.idleMs =
+        static_cast<wangle::ManagedConnection*>(session)->getIdleTime().count();
+    record.numStreams = session->getNumStreams();
+    const auto& peer = session->getPeerAddress();
+    if (peer.isInitialized() && peer.getFamily() == AF_INET) {
+      record.peerIPv4 = peer.getIPAddress().asV4().toLong();
+      record.peerPort = peer.getPort();
+    }
+    record.codecProtocol = uint8_t(session->getCodecProtocol());
+    record.flags = session->getNumStreams() > 0 ? 1 : 0;
+    records.push_back(record);
+  }
+
+  if (!records.empty()) {
+    auto rc = ::write(snapshotFd_,
+                      records.data(),
+                      records.size() * sizeof(Record));
+    PLOG_IF(ERROR, rc < 0) << "session snapshot write failed";
+  }
+
+  if (snapshotCursor_ == sessions_.end()) {
+    ::close(snapshotFd_);
+    snapshotFd_ = -1;
+    snapshotEvb_ = nullptr;
+    return;
+  }
+  snapshotEvb_->runInLoop([this] { writeSlice(); });
+}
+
+} // namespace proxygen
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <folly/io/async/EventBase.h>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+namespace proxygen {
+
+class HTTPSessionBase;
+
+/**
+ * Per-worker connection table for O(1) incident snapshots.  Sessions
+ * register on construction and deregister on destruction (and
+ * re-register on thread migration), so the thread that owns them can
+ * enumerate them without gdb.
+ *
+ * snapshot() serializes one compact binary record per session -
+ * protocol, stream count, buffered bytes, idle time, peer address -
+ * to the given file, walking the table in bounded slices scheduled as
+ * loop callbacks so a worker with a hundred thousand sessions never
+ * stalls its loop for more than one slice.  The target file is
+ * truncated per capture; keep captures apart or rotate paths for a
+ * ring.
+ *
+ * Single-threaded; access only from the owning worker.
+ */
+class WorkerSessionRegistry {
+ public:
+  struct Record {
+    uint64_t sessionId{0};   // address-derived, stable within a capture
+    uint64_t bufferedEgressBytes{0};
+    uint64_t bufferedIngressBytes{0};
+    uint64_t idleMs{0};
+    uint32_t numStreams{0};
+    uint32_t peerIPv4{0};    // network order; 0 for non-IPv4 peers
+    uint16_t peerPort{0};
+    uint8_t codecProtocol{0};
+    uint8_t flags{0};        // bit 0: has transactions
+    // explicit, zeroed: the records are written raw to disk and must
+    // not leak uninitialized padding
+    uint8_t padding[4]{};
+  };
+
+  static WorkerSessionRegistry& getThreadRegistry();
+
+  void add(HTTPSessionBase* session);
+  void remove(HTTPSessionBase* session);
+
+  size_t numSessions() const {
+    return sessions_.size();
+  }
+
+  /**
+   * Capture the table to path, sessionsPerSlice records per loop
+   * callback.  Returns false if the file could not be opened.  At most
+   * one capture at a time per worker; sessions that disappear between
+   * slices are skipped.
+   */
+  bool snapshot(folly::EventBase* evb,
+                const std::string& path,
+                size_t sessionsPerSlice = 4096);
+
+  /**
+   * Bulk drain: walk the table in slices of sessionsPerSlice per loop
+   * callback, asking each session to shut down gracefully (GOAWAY and
+   * close-when-idle via notifyPendingShutdown/closeWhenIdle), instead
+   * of notifying every session inline in one pass.  A worker with tens
+   * of thousands of sessions spreads its GOAWAY burst over loop
+   * iterations and keeps serving in-flight requests; sessions tear
+   * themselves down as they quiesce through their normal paths.
+   * Progress is observable via getDrainProgress (sessions remaining vs
+   * at drain start) for deploy tooling.
+   */
+  void drainAll(folly::EventBase* evb, size_t sessionsPerSlice = 512);
+
+  struct DrainProgress {
+    size_t sessionsAtStart{0};
+    size_t sessionsRemaining{0};
+    bool draining{false};
+  };
+
+  DrainProgress getDrainProgress() const {
+    return DrainProgress{drainStartCount_, numSessions(), drainActive_};
+  }
+
+ private:
+  void writeSlice();
+
+  std::list<HTTPSessionBase*> sessions_;
+  std::unordered_map<HTTPSessionBase*, std::list<HTTPSessionBase*>::iterator>
+      index_;
+
+  // in-progress capture state
+  folly::EventBase* snapshotEvb_{nullptr};
+  int snapshotFd_{-1};
+  size_t sessionsPerSlice_{0};
+  std::list<HTTPSessionBase*>::iterator snapshotCursor_;
+
+  // in-progress bulk drain state
+  void drainSlice();
+  folly::EventBase* drainEvb_{nullptr};
+  size_t drainPerSlice_{0};
+  size_t drainStartCount_{0};
+  bool drainActive_{false};
+  std::list<HTTPSessionBase*>::iterator drainCursor_;
+};
+
+} // namespace proxygen
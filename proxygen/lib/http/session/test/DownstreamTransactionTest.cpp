@@ -11,6 +11,7 @@
 #include <proxygen/lib/http/codec/SPDYConstants.h>
 #include <proxygen/lib/http/codec/test/MockHTTPCodec.h>
 #include <proxygen/lib/http/codec/test/TestUtils.h>
+#include <proxygen/lib/http/session/BroadcastFanout.h>
 #include <proxygen/lib/http/session/test/HTTPSessionMocks.h>
 #include <proxygen/lib/http/session/test/HTTPTransactionMocks.h>
 #include <proxygen/lib/test/TestAsyncTransport.h>
@@ -118,9 +119,368 @@ TEST_F(DownstreamTransactionTest, SimpleCallbackForwarding) {
   eventBase_.loop();
 }
 
+TEST_F(DownstreamTransactionTest, CoalescedIngressBody) {
+  // flow control is disabled
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+  txn.setIngressBodyCoalescing(100);
+  EXPECT_CALL(handler_, setTransaction(&txn));
+  EXPECT_CALL(handler_, detachTransaction());
+  EXPECT_CALL(transport_, detach(&txn));
+
+  uint64_t received = 0;
+  uint32_t deliveries = 0;
+  EXPECT_CALL(handler_, onHeadersComplete(_))
+      .WillOnce(Invoke([&](std::shared_ptr<HTTPMessage> /*msg*/) {
+        auto response = makeResponse(200);
+        txn.sendHeaders(*response.get());
+        txn.sendEOM();
+      }));
+  EXPECT_CALL(transport_, sendHeaders(&txn, _, _, _));
+  EXPECT_CALL(transport_, notifyPendingEgress()).Times(AtLeast(0));
+  EXPECT_CALL(transport_, sendEOM(&txn, _))
+      .WillOnce(InvokeWithoutArgs([&]() {
+        txn.onIngressBody(makeBuf(30), 0);
+        txn.onIngressBody(makeBuf(30), 0);
+        EXPECT_EQ(deliveries, 0); // still below the threshold
+        txn.onIngressBody(makeBuf(50), 0);
+        EXPECT_EQ(deliveries, 1); // one chain for the first 110 bytes
+        txn.onIngressBody(makeBuf(20), 0);
+        txn.onIngressEOM();
+        return 5;
+      }));
+  EXPECT_CALL(handler_, onBodyWithOffset(_, _))
+      .WillRepeatedly(
+          Invoke([&](uint64_t offset, std::shared_ptr<folly::IOBuf> body) {
+            // offsets line up with the coalesced stream position
+            EXPECT_EQ(offset, received);
+            received += body->computeChainDataLength();
+            deliveries++;
+          }));
+  EXPECT_CALL(handler_, onEOM()).WillOnce(InvokeWithoutArgs([&] {
+    // 30 + 30 stayed below threshold; +50 crossed it; the 20-byte tail
+    // flushed with the EOM
+    CHECK_EQ(received, 130);
+    CHECK_EQ(deliveries, 2);
+  }));
+
+  txn.onIngressHeadersComplete(makeGetRequest());
+  eventBase_.loop();
+}
+
+TEST_F(DownstreamTransactionTest, EgressWatermarks) {
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+
+  EXPECT_CALL(transport_, sendHeaders(&txn, _, _, _));
+  EXPECT_CALL(transport_, notifyPendingEgress()).Times(AtLeast(1));
+  EXPECT_CALL(transport_, notifyEgressBodyBuffered(_)).Times(AtLeast(1));
+  EXPECT_CALL(transport_, sendBody(&txn, _, false, false))
+      .WillRepeatedly(Invoke(
+          [](Unused, std::shared_ptr<folly::IOBuf> body, Unused, Unused) {
+            return body->computeChainDataLength();
+          }));
+
+  std::vector<bool> events;
+  txn.setEgressWatermarks(
+      150, 50, [&events](bool aboveHigh) { events.push_back(aboveHigh); });
+
+  auto response = makeResponse(200);
+  txn.sendHeaders(*response);
+  txn.sendBody(makeBuf(100)); // 100 < 150: quiet
+  EXPECT_TRUE(events.empty());
+  txn.sendBody(makeBuf(100)); // 200 >= 150: one high notification
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_TRUE(events[0]);
+  txn.sendBody(makeBuf(50)); // still above: hysteresis, no repeat
+  EXPECT_EQ(events.size(), 1);
+  EXPECT_EQ(txn.getEgressBufferedBytes(), 250);
+
+  // drain below the low watermark: one low notification
+  txn.onWriteReady(4096, 1);
+  ASSERT_EQ(events.size(), 2);
+  EXPECT_FALSE(events[1]);
+  EXPECT_EQ(txn.getEgressBufferedBytes(), 0);
+
+  EXPECT_CALL(transport_, sendAbort(_, _));
+  EXPECT_CALL(transport_, detach(_));
+  txn.sendAbort();
+}
+
+TEST_F(DownstreamTransactionTest, BroadcastFanoutSharedPayload) {
+  HTTPTransaction txn1(TransportDirection::DOWNSTREAM,
+                       HTTPCodec::StreamID(1),
+                       1,
+                       transport_,
+                       txnEgressQueue_,
+                       transactionTimeouts_.get(),
+                       std::chrono::milliseconds(500));
+  HTTPTransaction txn2(TransportDirection::DOWNSTREAM,
+                       HTTPCodec::StreamID(3),
+                       2,
+                       transport_,
+                       txnEgressQueue_,
+                       transactionTimeouts_.get(),
+                       std::chrono::milliseconds(500));
+
+  EXPECT_CALL(transport_, sendHeaders(_, _, _, _)).Times(2);
+  EXPECT_CALL(transport_, notifyPendingEgress()).Times(AtLeast(1));
+  auto response1 = makeResponse(200);
+  auto response2 = makeResponse(200);
+  txn1.sendHeaders(*response1);
+  txn2.sendHeaders(*response2);
+
+  BroadcastFanout fanout;
+  fanout.subscribe(&txn1, &eventBase_);
+  fanout.subscribe(&txn2, &eventBase_);
+  EXPECT_EQ(fanout.numSubscribers(), 2);
+
+  std::vector<const uint8_t*> delivered;
+  EXPECT_CALL(transport_, sendBody(_, _, false, false))
+      .Times(2)
+      .WillRepeatedly(Invoke(
+          [&](Unused, std::shared_ptr<folly::IOBuf> body, Unused, Unused) {
+            delivered.push_back(body->data());
+            return body->computeChainDataLength();
+          }));
+
+  auto event = folly::IOBuf::copyBuffer(std::string(2048, 'e'));
+  const uint8_t* eventData = event->data();
+  EXPECT_EQ(fanout.publish(std::move(event)), 1); // one worker, one wakeup
+  eventBase_.loopOnce(EVLOOP_NONBLOCK);
+
+  // both transactions queued chains referencing the same bytes
+  txn1.onWriteReady(4096, 1);
+  txn2.onWriteReady(4096, 1);
+  ASSERT_EQ(delivered.size(), 2);
+  EXPECT_EQ(delivered[0], eventData);
+  EXPECT_EQ(delivered[1], eventData);
+
+  fanout.unsubscribe(&txn1, &eventBase_);
+  fanout.unsubscribe(&txn2, &eventBase_);
+  EXPECT_EQ(fanout.numSubscribers(), 0);
+
+  EXPECT_CALL(transport_, sendAbort(_, _)).Times(2);
+  EXPECT_CALL(transport_, detach(_)).Times(2);
+  txn1.sendAbort();
+  txn2.sendAbort();
+}
+
+TEST_F(DownstreamTransactionTest, LowLatencyEgressUrgentHint) {
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+  txn.setLowLatencyEgress(true);
+
+  EXPECT_CALL(handler_, setTransaction(&txn));
+  EXPECT_CALL(handler_, onHeadersComplete(_)).WillOnce(InvokeWithoutArgs([&] {
+    auto response = makeResponse(200);
+    txn.sendHeaders(*response.get());
+    txn.sendEOM();
+  }));
+  EXPECT_CALL(transport_, sendHeaders(&txn, _, _, _));
+  EXPECT_CALL(transport_, sendEOM(&txn, _)).WillOnce(Return(5));
+  EXPECT_CALL(transport_, notifyPendingEgress());
+  // the EOM of a low-latency transaction hints the transport to flush
+  // inline rather than wait for the loop-batched write
+  EXPECT_CALL(transport_, notifyEgressUrgent());
+  EXPECT_CALL(handler_, onEOM());
+  EXPECT_CALL(handler_, detachTransaction());
+  EXPECT_CALL(transport_, detach(&txn));
+
+  txn.setHandler(&handler_);
+  txn.onIngressHeadersComplete(makeGetRequest());
+  txn.onIngressEOM();
+  eventBase_.loop();
+}
+
+TEST_F(DownstreamTransactionTest, SendBodyAndTrailers) {
+  // flow control is disabled
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+  HTTPHeaders trailers;
+  trailers.add("x-checksum", "abc123");
+
+  EXPECT_CALL(handler_, setTransaction(&txn));
+  EXPECT_CALL(handler_, onHeadersComplete(_)).WillOnce(InvokeWithoutArgs([&] {
+    auto response = makeResponse(200);
+    txn.sendHeaders(*response.get());
+    txn.sendBodyAndTrailers(makeBuf(100), trailers);
+  }));
+  EXPECT_CALL(transport_, sendHeaders(&txn, _, _, _));
+  // a single wakeup carries body, trailers and EOM
+  EXPECT_CALL(transport_, notifyPendingEgress())
+      .WillOnce(InvokeWithoutArgs([&] { txn.onWriteReady(1000, 1); }));
+  EXPECT_CALL(transport_, sendBody(&txn, _, false, false))
+      .WillOnce(Invoke(
+          [](Unused, std::shared_ptr<folly::IOBuf> body, Unused, Unused) {
+            EXPECT_EQ(body->computeChainDataLength(), 100);
+            return 100;
+          }));
+  EXPECT_CALL(transport_, sendEOM(&txn, _))
+      .WillOnce(Invoke([](Unused, const HTTPHeaders* trailerHeaders) {
+        CHECK(trailerHeaders != nullptr);
+        EXPECT_EQ(trailerHeaders->getSingleOrEmpty("x-checksum"), "abc123");
+        return 5;
+      }));
+  EXPECT_CALL(handler_, onEOM());
+  EXPECT_CALL(handler_, detachTransaction());
+  EXPECT_CALL(transport_, detach(&txn));
+
+  txn.setHandler(&handler_);
+  txn.onIngressHeadersComplete(makeGetRequest());
+  txn.onIngressEOM();
+  eventBase_.loop();
+}
+
 /**
  * Testing that we're sending a window update for simple requests
  */
+TEST_F(DownstreamTransactionTest, DeadlineExpiry) {
+  // flow control is disabled
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+
+  EXPECT_CALL(handler_, setTransaction(&txn));
+  EXPECT_CALL(handler_, onHeadersComplete(_));
+  EXPECT_CALL(handler_, onError(_))
+      .WillOnce(Invoke([](const HTTPException& ex) {
+        EXPECT_EQ(ex.getProxygenError(), kErrorTimeout);
+      }));
+  EXPECT_CALL(transport_, sendAbort(&txn, _));
+  EXPECT_CALL(handler_, detachTransaction());
+  EXPECT_CALL(transport_, detach(&txn));
+
+  txn.setHandler(&handler_);
+  txn.onIngressHeadersComplete(makeGetRequest());
+  txn.setDeadline(getCurrentTime() + std::chrono::milliseconds(10));
+  eventBase_.loop(); // the shared wheel fires the deadline
+}
+
+TEST_F(DownstreamTransactionTest, EgressChunkQuantum) {
+  // flow control is disabled
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+  txn.setEgressChunkQuantum(100);
+
+  EXPECT_CALL(handler_, setTransaction(&txn));
+  EXPECT_CALL(handler_, onHeadersComplete(_)).WillOnce(InvokeWithoutArgs([&] {
+    auto response = makeResponse(200);
+    txn.sendHeaders(*response.get());
+    txn.sendBody(makeBuf(250));
+    txn.sendEOM();
+  }));
+  EXPECT_CALL(transport_, sendHeaders(&txn, _, _, _));
+  std::vector<size_t> batches;
+  EXPECT_CALL(transport_, sendBody(&txn, _, _, false))
+      .WillRepeatedly(Invoke(
+          [&](Unused, std::shared_ptr<folly::IOBuf> body, Unused, Unused) {
+            batches.push_back(body->computeChainDataLength());
+            return batches.back();
+          }));
+  // the final batch carries the EOM on the sendBody call itself
+  EXPECT_CALL(transport_, notifyPendingEgress())
+      .WillRepeatedly(InvokeWithoutArgs([] {}));
+  EXPECT_CALL(handler_, onEOM());
+  EXPECT_CALL(handler_, detachTransaction());
+  EXPECT_CALL(transport_, detach(&txn));
+
+  txn.setHandler(&handler_);
+  txn.onIngressHeadersComplete(makeGetRequest());
+  txn.onIngressEOM();
+  // a window-limited intermediate batch rounds down to the quantum...
+  txn.onWriteReady(120, 1);
+  ASSERT_EQ(batches.size(), 1);
+  EXPECT_EQ(batches[0], 100);
+  // ...and the final batch flushes everything, unshaped
+  txn.onWriteReady(1000, 1);
+  ASSERT_EQ(batches.size(), 2);
+  EXPECT_EQ(batches[1], 150);
+  eventBase_.loop();
+}
+
+TEST_F(DownstreamTransactionTest, PullIngress) {
+  // flow control is disabled
+  HTTPTransaction txn(TransportDirection::DOWNSTREAM,
+                      HTTPCodec::StreamID(1),
+                      1,
+                      transport_,
+                      txnEgressQueue_,
+                      transactionTimeouts_.get(),
+                      std::chrono::milliseconds(500));
+
+  EXPECT_CALL(transport_, pauseIngress(&txn)).Times(AtLeast(1));
+  EXPECT_CALL(transport_, resumeIngress(&txn)).Times(AtLeast(1));
+  EXPECT_CALL(transport_, notifyIngressBodyProcessed(_)).Times(AnyNumber());
+  EXPECT_CALL(handler_, setTransaction(&txn));
+  EXPECT_CALL(handler_, onHeadersComplete(_)).WillOnce(InvokeWithoutArgs([&] {
+    txn.enablePullIngress();
+  }));
+  uint64_t received = 0;
+  EXPECT_CALL(handler_, onBodyWithOffset(_, _))
+      .WillRepeatedly(
+          Invoke([&](uint64_t, std::shared_ptr<folly::IOBuf> body) {
+            received += body->computeChainDataLength();
+          }));
+  EXPECT_CALL(handler_, onEOM()).WillOnce(InvokeWithoutArgs([&] {
+    auto response = makeResponse(200);
+    txn.sendHeaders(*response.get());
+    txn.sendEOM();
+  }));
+  EXPECT_CALL(transport_, sendHeaders(&txn, _, _, _));
+  EXPECT_CALL(transport_, sendEOM(&txn, _)).WillOnce(Return(5));
+  EXPECT_CALL(transport_, notifyPendingEgress())
+      .WillRepeatedly(InvokeWithoutArgs([] {}));
+  EXPECT_CALL(handler_, detachTransaction());
+  EXPECT_CALL(transport_, detach(&txn));
+
+  txn.setHandler(&handler_);
+  txn.onIngressHeadersComplete(makeGetRequest());
+  // body arrives before any demand: nothing is delivered
+  txn.onIngressBody(makeBuf(100), 0);
+  EXPECT_EQ(received, 0);
+  // a grant smaller than the chunk still delivers the whole chunk
+  // (chunk granularity), then pauses again
+  txn.requestIngressBody(60);
+  EXPECT_EQ(received, 100);
+  txn.onIngressBody(makeBuf(50), 0);
+  EXPECT_EQ(received, 100);
+  // a fresh grant delivers the parked chunk
+  txn.requestIngressBody(1000);
+  EXPECT_EQ(received, 150);
+  txn.onIngressEOM();
+  eventBase_.loop();
+}
+
 TEST_F(DownstreamTransactionTest, RegularWindowUpdate) {
   HTTPTransaction txn(TransportDirection::DOWNSTREAM,
                       HTTPCodec::StreamID(1),
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/session/FlatStreamIndex.h>
+
+#include <unordered_map>
+#include <vector>
+
+using namespace proxygen;
+
+TEST(FlatStreamIndexTest, BasicInsertFindErase) {
+  FlatStreamIndex<int> index;
+  int a = 1, b = 2;
+  EXPECT_EQ(index.find(0), nullptr);
+  index.insert(0, &a);
+  index.insert(4, &b);
+  EXPECT_EQ(index.size(), 2);
+  EXPECT_EQ(index.find(0), &a);
+  EXPECT_EQ(index.find(4), &b);
+  // cache hit path
+  EXPECT_EQ(index.find(4), &b);
+  index.erase(0);
+  EXPECT_EQ(index.find(0), nullptr);
+  EXPECT_EQ(index.find(4), &b);
+  EXPECT_EQ(index.size(), 1);
+}
+
+TEST(FlatStreamIndexTest, OverwriteAndEraseMissing) {
+  FlatStreamIndex<int> index;
+  int a = 1, b = 2;
+  index.insert(8, &a);
+  index.insert(8, &b);
+  EXPECT_EQ(index.size(), 1);
+  EXPECT_EQ(index.find(8), &b);
+  index.erase(12); // not present
+  EXPECT_EQ(index.size(), 1);
+}
+
+TEST(FlatStreamIndexTest, GrowthBeyondInline) {
+  FlatStreamIndex<int> index;
+  std::vector<int> values(1000);
+  // QUIC-style ids: sequential, stride 4
+  for (uint64_t i = 0; i < 1000; i++) {
+    index.insert(i * 4, &values[i]);
+  }
+  EXPECT_EQ(index.size(), 1000);
+  for (uint64_t i = 0; i < 1000; i++) {
+    EXPECT_EQ(index.find(i * 4), &values[i]);
+  }
+  EXPECT_EQ(index.find(4001), nullptr);
+}
+
+TEST(FlatStreamIndexTest, ChurnMatchesReference) {
+  FlatStreamIndex<int> index;
+  std::unordered_map<uint64_t, int*> reference;
+  std::vector<int> values(512);
+  uint64_t nextId = 0;
+  // interleave inserts and erases to exercise backward-shift deletion
+  for (int round = 0; round < 4; round++) {
+    for (int i = 0; i < 128; i++) {
+      uint64_t id = nextId;
+      nextId += 4;
+      index.insert(id, &values[id % 512]);
+      reference[id] = &values[id % 512];
+    }
+    uint64_t eraseFrom = round * 128ULL * 4;
+    for (uint64_t id = eraseFrom; id < eraseFrom + 256; id += 8) {
+      index.erase(id);
+      reference.erase(id);
+    }
+    for (const auto& entry : reference) {
+      EXPECT_EQ(index.find(entry.first), entry.second);
+    }
+    EXPECT_EQ(index.size(), reference.size());
+  }
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * HTTP/3 session-layer benchmarks: QPACK encode/decode throughput at
+ * configurable dynamic-table sizes and blocked-stream ratios, and
+ * next-egress selection cost for both schedulers at 100/1k/10k
+ * concurrent streams. These are the session-layer costs that showed up
+ * as cliffs in rollout; driving full HQSession stream setup through
+ * MockQuicSocketDriver is deliberately not benchmarked here - the mock
+ * driver is built on gmock expectations whose interception overhead
+ * would dominate and mismeasure the session.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/portability/GFlags.h>
+
+#include <proxygen/lib/http/codec/compress/QPACKCodec.h>
+#include <proxygen/lib/http/codec/compress/test/TestStreamingCallback.h>
+#include <proxygen/lib/http/codec/compress/test/TestUtil.h>
+#include <proxygen/lib/http/session/HTTP2PriorityQueue.h>
+#include <proxygen/lib/http/session/UrgencyPriorityQueue.h>
+
+using namespace proxygen;
+
+namespace {
+
+std::vector<compress::Header> makeHeaders(
+    std::vector<std::vector<std::string>>& storage) {
+  storage = {
+      {":authority", "www.facebook.com"},
+      {":method", "GET"},
+      {":path", "/graphql"},
+      {":scheme", "https"},
+      {"user-agent", "proxygen_hq_bench/1.0 (linux; x86_64)"},
+      {"accept-encoding", "gzip, deflate, br"},
+      {"accept-language", "en-US,en;q=0.8"},
+      {"cookie", "c68e48f9b1ac2f=wPthbCfMrWeGJEcLotzN19iBXOQ5sU7D"},
+  };
+  return hpack::headersFromArray(storage);
+}
+
+/**
+ * Encode + decode numBlocks header blocks. blockedDivisor > 0
+ * withholds the encoder-stream bytes for the trailing
+ * numBlocks/blockedDivisor blocks until the end, so that fraction of
+ * blocks takes the blocked-stream queueing path. The withheld chunks
+ * are a contiguous tail because the encoder stream is a single
+ * ordered stream and its chunks cannot be replayed out of order.
+ */
+void qpackEncodeDecode(uint32_t tableSize,
+                       uint32_t numBlocks,
+                       uint32_t blockedDivisor) {
+  QPACKCodec encoder;
+  QPACKCodec decoder;
+  encoder.setEncoderHeaderTableSize(tableSize);
+  decoder.setDecoderHeaderTableMaxSize(tableSize);
+  encoder.setMaxVulnerable(blockedDivisor > 0 ? 100 : 0);
+  decoder.setMaxBlocking(blockedDivisor > 0 ? 100 : 0);
+
+  std::vector<std::vector<std::string>> storage;
+  auto headers = makeHeaders(storage);
+  std::vector<std::unique_ptr<folly::IOBuf>> withheldControl;
+  std::vector<TestStreamingCallback> callbacks(numBlocks);
+  const uint32_t firstWithheld = blockedDivisor > 0
+      ? numBlocks - numBlocks / blockedDivisor
+      : numBlocks;
+
+  for (uint32_t i = 0; i < numBlocks; i++) {
+    auto result = encoder.encode(headers, i);
+    if (result.control) {
+      if (i >= firstWithheld) {
+        withheldControl.push_back(std::move(result.control));
+      } else {
+        CHECK_EQ(decoder.decodeEncoderStream(std::move(result.control)),
+                 HPACK::DecodeError::NONE);
+      }
+    }
+    auto length = result.stream->computeChainDataLength();
+    decoder.decodeStreaming(i, std::move(result.stream), length,
+                            &callbacks[i]);
+  }
+  // release the withheld inserts; blocked blocks decode now
+  for (auto& control : withheldControl) {
+    CHECK_EQ(decoder.decodeEncoderStream(std::move(control)),
+             HPACK::DecodeError::NONE);
+  }
+  for (auto& cb : callbacks) {
+    CHECK(!cb.hasError());
+  }
+}
+
+constexpr HTTPCodec::StreamID kRootNodeId =
+    std::numeric_limits<uint64_t>::max();
+
+HTTPTransaction* fakeTxn(uint64_t id) {
+  return reinterpret_cast<HTTPTransaction*>(0xface0000 + id * 8);
+}
+
+void benchTreeNextEgress(uint32_t numStreams, size_t iters) {
+  HTTP2PriorityQueue queue(kRootNodeId);
+  std::vector<HTTP2PriorityQueue::Handle> handles;
+  folly::BenchmarkSuspender suspender;
+  for (uint64_t i = 0; i < numStreams; i++) {
+    auto handle = queue.addTransaction(
+        i * 4, http2::DefaultPriority, fakeTxn(i), false, nullptr);
+    handles.push_back(handle);
+    queue.signalPendingEgress(handle);
+  }
+  HTTP2PriorityQueue::NextEgressResult result;
+  suspender.dismiss();
+
+  for (size_t i = 0; i < iters; i++) {
+    queue.nextEgress(result);
+    folly::doNotOptimizeAway(result.size());
+  }
+
+  suspender.rehire();
+  for (auto handle : handles) {
+    queue.removeTransaction(handle);
+  }
+}
+
+void benchFlatNextEgress(uint32_t numStreams, size_t iters) {
+  UrgencyPriorityQueue queue;
+  std::vector<UrgencyPriorityQueue::Handle> handles;
+  folly::BenchmarkSuspender suspender;
+  for (uint64_t i = 0; i < numStreams; i++) {
+    auto handle =
+        queue.addTransaction(i * 4, i % 8, true /* incremental */, fakeTxn(i));
+    handles.push_back(handle);
+    queue.signalPendingEgress(handle);
+  }
+  UrgencyPriorityQueue::NextEgressResult result;
+  suspender.dismiss();
+
+  for (size_t i = 0; i < iters; i++) {
+    queue.nextEgress(result);
+    folly::doNotOptimizeAway(result.size());
+  }
+
+  suspender.rehire();
+  for (auto handle : handles) {
+    queue.removeTransaction(handle);
+  }
+}
+
+} // namespace
+
+BENCHMARK(QpackEncodeDecode4k, iters) {
+  for (size_t i = 0; i < iters; i++) {
+    qpackEncodeDecode(4096, 50, 0);
+  }
+}
+
+BENCHMARK(QpackEncodeDecode64k, iters) {
+  for (size_t i = 0; i < iters; i++) {
+    qpackEncodeDecode(64 * 1024, 50, 0);
+  }
+}
+
+BENCHMARK(QpackEncodeDecodeStaticOnly, iters) {
+  for (size_t i = 0; i < iters; i++) {
+    qpackEncodeDecode(0, 50, 0);
+  }
+}
+
+BENCHMARK(QpackEncodeDecodeBlocked10Pct, iters) {
+  for (size_t i = 0; i < iters; i++) {
+    qpackEncodeDecode(4096, 50, 10);
+  }
+}
+
+BENCHMARK(QpackEncodeDecodeBlocked50Pct, iters) {
+  for (size_t i = 0; i < iters; i++) {
+    qpackEncodeDecode(4096, 50, 2);
+  }
+}
+
+BENCHMARK(TreeNextEgress100, iters) {
+  benchTreeNextEgress(100, iters);
+}
+
+BENCHMARK(TreeNextEgress1k, iters) {
+  benchTreeNextEgress(1000, iters);
+}
+
+BENCHMARK(TreeNextEgress10k, iters) {
+  benchTreeNextEgress(10000, iters);
+}
+
+BENCHMARK(FlatNextEgress100, iters) {
+  benchFlatNextEgress(100, iters);
+}
+
+BENCHMARK(FlatNextEgress1k, iters) {
+  benchFlatNextEgress(1000, iters);
+}
+
+BENCHMARK(FlatNextEgress10k, iters) {
+  benchFlatNextEgress(10000, iters);
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
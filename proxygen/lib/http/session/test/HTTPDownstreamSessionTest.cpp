@@ -23,6 +23,7 @@
 #include <proxygen/lib/http/session/HTTPDirectResponseHandler.h>
 #include <proxygen/lib/http/session/HTTPDownstreamSession.h>
 #include <proxygen/lib/http/session/HTTPSession.h>
+#include <proxygen/lib/http/session/WorkerEgressScheduler.h>
 #include <proxygen/lib/http/session/test/HTTPSessionMocks.h>
 #include <proxygen/lib/http/session/test/HTTPSessionTest.h>
 #include <proxygen/lib/http/session/test/HTTPTransactionMocks.h>
@@ -523,6 +524,49 @@ TEST_F(HTTPDownstreamSessionTest, ImmediateEof) {
   flushRequestsAndLoop(true, milliseconds(0));
 }
 
+TEST_F(HTTPDownstreamSessionTest, WorkerFairEgressDelivery) {
+  // route this session's egress through the worker DRR scheduler
+  httpSession_->enableWorkerFairEgress(1);
+
+  auto handler = addSimpleNiceHandler();
+  handler->expectHeaders();
+  // larger than one 16KB base quantum, so the session takes the
+  // made-progress-requeue path across scheduler rounds
+  handler->expectEOM(
+      [&handler] { handler->sendReplyWithBody(200, 20 * 1024); });
+  handler->expectDetachTransaction();
+  expectDetachSession();
+
+  sendRequest();
+  flushRequestsAndLoop(true, milliseconds(0));
+  // the queue drained and the scheduler disarmed - it must not stay
+  // self-armed once nothing is writable
+  EXPECT_EQ(WorkerEgressScheduler::getThreadScheduler().numQueuedSessions(),
+            0);
+  expectResponse();
+}
+
+TEST_F(HTTPDownstreamSessionTest, WorkerFairEgressPipelined) {
+  httpSession_->enableWorkerFairEgress(1);
+
+  auto handler1 = addSimpleNiceHandler();
+  handler1->expectHeaders();
+  handler1->expectEOM([&handler1] { handler1->sendReplyWithBody(200, 100); });
+  handler1->expectDetachTransaction();
+  auto handler2 = addSimpleNiceHandler();
+  handler2->expectHeaders();
+  handler2->expectEOM([&handler2] { handler2->sendReplyWithBody(200, 100); });
+  handler2->expectDetachTransaction();
+  expectDetachSession();
+
+  sendRequest();
+  sendRequest();
+  flushRequestsAndLoop(true, milliseconds(0));
+  EXPECT_EQ(WorkerEgressScheduler::getThreadScheduler().numQueuedSessions(),
+            0);
+  expectResponses(2);
+}
+
 TEST_F(HTTPDownstreamSessionTest, Http10NoHeaders) {
   InSequence enforceOrder;
 
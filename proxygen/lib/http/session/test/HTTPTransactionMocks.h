@@ -63,6 +63,7 @@ class MockHTTPTransactionTransport : public HTTPTransaction::Transport {
                  sendPriority,
                  size_t(HTTPTransaction*, const http2::PriorityUpdate&));
   GMOCK_METHOD0_(, noexcept, , notifyPendingEgress, void());
+  GMOCK_METHOD0_(, noexcept, , notifyEgressUrgent, void());
   GMOCK_METHOD1_(, noexcept, , detach, void(HTTPTransaction*));
   GMOCK_METHOD2_(
       , noexcept, , sendWindowUpdate, size_t(HTTPTransaction*, uint32_t));
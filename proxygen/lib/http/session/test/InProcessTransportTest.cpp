@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/session/InProcessTransport.h>
+
+using namespace proxygen;
+
+namespace {
+
+class MovableReader : public folly::AsyncTransportWrapper::ReadCallback {
+ public:
+  void getReadBuffer(void**, size_t*) override {
+    FAIL() << "movable reader should not be asked for a buffer";
+  }
+  void readDataAvailable(size_t) noexcept override {
+  }
+  bool isBufferMovable() noexcept override {
+    return true;
+  }
+  void readBufferAvailable(
+      std::unique_ptr<folly::IOBuf> buf) noexcept override {
+    received.append(std::move(buf));
+  }
+  void readEOF() noexcept override {
+    eof = true;
+  }
+  void readErr(const folly::AsyncSocketException&) noexcept override {
+    errored = true;
+  }
+
+  folly::IOBufQueue received{folly::IOBufQueue::cacheChainLength()};
+  bool eof{false};
+  bool errored{false};
+};
+
+} // namespace
+
+TEST(InProcessTransportTest, MovesBytesBetweenEnds) {
+  folly::EventBase evb;
+  auto pair = InProcessTransport::makePair(&evb);
+  MovableReader reader;
+  pair.second->setReadCB(&reader);
+
+  pair.first->writeChain(nullptr, folly::IOBuf::copyBuffer("hello "));
+  pair.first->writeChain(nullptr, folly::IOBuf::copyBuffer("world"));
+  evb.loop();
+
+  EXPECT_EQ(reader.received.move()->moveToFbString().toStdString(),
+            "hello world");
+  EXPECT_FALSE(reader.eof);
+  EXPECT_EQ(pair.first->getAppBytesWritten(), 11);
+  EXPECT_EQ(pair.second->getAppBytesReceived(), 11);
+
+  // half close propagates as EOF after pending bytes drain
+  pair.first->writeChain(nullptr, folly::IOBuf::copyBuffer("tail"));
+  pair.first->shutdownWrite();
+  evb.loop();
+  EXPECT_EQ(reader.received.move()->moveToFbString().toStdString(), "tail");
+  EXPECT_TRUE(reader.eof);
+}
+
+TEST(InProcessTransportTest, WriteAfterPeerCloseErrors) {
+  folly::EventBase evb;
+  auto pair = InProcessTransport::makePair(&evb);
+  pair.second->close();
+
+  class FailingWriteCallback
+      : public folly::AsyncTransportWrapper::WriteCallback {
+   public:
+    void writeSuccess() noexcept override {
+      succeeded = true;
+    }
+    void writeErr(size_t,
+                  const folly::AsyncSocketException&) noexcept override {
+      failed = true;
+    }
+    bool succeeded{false};
+    bool failed{false};
+  } writeCallback;
+
+  pair.first->writeChain(&writeCallback, folly::IOBuf::copyBuffer("x"));
+  EXPECT_TRUE(writeCallback.failed);
+  EXPECT_FALSE(writeCallback.succeeded);
+  EXPECT_FALSE(pair.first->good());
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/session/TransactionTimeoutBatcher.h>
+
+using namespace proxygen;
+using namespace testing;
+
+namespace {
+
+class TestMember : public folly::HHWheelTimer::Callback {
+ public:
+  void timeoutExpired() noexcept override {
+    expired++;
+  }
+  uint32_t expired{0};
+};
+
+} // namespace
+
+class TransactionTimeoutBatcherTest : public Test {
+ protected:
+  folly::EventBase eventBase_;
+  folly::HHWheelTimer::UniquePtr timer_{folly::HHWheelTimer::newTimer(
+      &eventBase_, std::chrono::milliseconds(1))};
+};
+
+TEST_F(TransactionTimeoutBatcherTest, ExpireLazily) {
+  TransactionTimeoutBatcher batcher(timer_.get(),
+                                    std::chrono::milliseconds(10));
+  TestMember member;
+  batcher.refresh(&member, std::chrono::milliseconds(5));
+  EXPECT_EQ(batcher.numMembers(), 1);
+  eventBase_.loop();
+  // the coarse timer fired after the member's deadline passed
+  EXPECT_EQ(member.expired, 1);
+  EXPECT_EQ(batcher.numMembers(), 0);
+}
+
+TEST_F(TransactionTimeoutBatcherTest, RefreshPushesDeadlineOut) {
+  TransactionTimeoutBatcher batcher(timer_.get(),
+                                    std::chrono::milliseconds(10));
+  TestMember early;
+  TestMember late;
+  batcher.refresh(&early, std::chrono::milliseconds(5));
+  batcher.refresh(&late, std::chrono::milliseconds(500));
+  eventBase_.loopOnce();
+  while (early.expired == 0 && batcher.numMembers() == 2) {
+    eventBase_.loopOnce();
+  }
+  // only the member whose deadline passed has fired; the timer stays
+  // armed for the remaining member
+  EXPECT_EQ(early.expired, 1);
+  EXPECT_EQ(late.expired, 0);
+  EXPECT_EQ(batcher.numMembers(), 1);
+  batcher.remove(&late);
+  EXPECT_EQ(batcher.numMembers(), 0);
+}
+
+TEST_F(TransactionTimeoutBatcherTest, RemovedMemberDoesNotFire) {
+  TransactionTimeoutBatcher batcher(timer_.get(),
+                                    std::chrono::milliseconds(10));
+  TestMember member;
+  batcher.refresh(&member, std::chrono::milliseconds(5));
+  batcher.remove(&member);
+  eventBase_.loop();
+  EXPECT_EQ(member.expired, 0);
+}
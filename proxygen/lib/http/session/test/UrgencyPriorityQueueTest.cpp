@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/session/UrgencyPriorityQueue.h>
+
+using namespace testing;
+
+namespace {
+static char* fakeTxn = (char*)0xface0000;
+
+proxygen::HTTPTransaction* makeFakeTxn(proxygen::HTTPCodec::StreamID id) {
+  return (proxygen::HTTPTransaction*)(fakeTxn + id);
+}
+} // namespace
+
+namespace proxygen {
+
+class UrgencyQueueTest : public testing::Test {
+ protected:
+  UrgencyPriorityQueue::Handle add(HTTPCodec::StreamID id,
+                                   uint8_t urgency,
+                                   bool incremental) {
+    auto h = q_.addTransaction(id, urgency, incremental, makeFakeTxn(id));
+    q_.signalPendingEgress(h);
+    return h;
+  }
+
+  UrgencyPriorityQueue q_;
+  UrgencyPriorityQueue::NextEgressResult result_;
+};
+
+TEST_F(UrgencyQueueTest, Empty) {
+  EXPECT_TRUE(q_.empty());
+  q_.nextEgress(result_);
+  EXPECT_TRUE(result_.empty());
+}
+
+TEST_F(UrgencyQueueTest, UrgencyOrder) {
+  add(1, 5, false);
+  add(3, 2, false);
+  add(5, 7, false);
+  EXPECT_EQ(q_.numPendingEgress(), 3);
+
+  // urgency 2 wins, non-incremental gets the whole quantum
+  q_.nextEgress(result_);
+  ASSERT_EQ(result_.size(), 1);
+  EXPECT_EQ(result_[0].first, makeFakeTxn(3));
+  EXPECT_EQ(result_[0].second, 1.0);
+
+  // still at the head until it clears
+  q_.nextEgress(result_);
+  ASSERT_EQ(result_.size(), 1);
+  EXPECT_EQ(result_[0].first, makeFakeTxn(3));
+}
+
+TEST_F(UrgencyQueueTest, IncrementalRoundRobin) {
+  add(1, 3, true);
+  add(3, 3, true);
+  add(5, 3, true);
+
+  q_.nextEgress(result_);
+  ASSERT_EQ(result_.size(), 3);
+  for (const auto& pair : result_) {
+    EXPECT_DOUBLE_EQ(pair.second, 1.0 / 3);
+  }
+}
+
+TEST_F(UrgencyQueueTest, ClearAndRemove) {
+  auto h1 = add(1, 3, false);
+  auto h3 = add(3, 3, false);
+  q_.clearPendingEgress(h1);
+  EXPECT_EQ(q_.numPendingEgress(), 1);
+
+  q_.nextEgress(result_);
+  ASSERT_EQ(result_.size(), 1);
+  EXPECT_EQ(result_[0].first, makeFakeTxn(3));
+
+  q_.removeTransaction(h3);
+  q_.removeTransaction(h1);
+  EXPECT_TRUE(q_.empty());
+  EXPECT_EQ(q_.numStreams(), 0);
+}
+
+TEST_F(UrgencyQueueTest, UpdatePriority) {
+  auto h1 = add(1, 5, false);
+  add(3, 3, false);
+
+  q_.nextEgress(result_);
+  EXPECT_EQ(result_[0].first, makeFakeTxn(3));
+
+  q_.updatePriority(h1, 0, false);
+  q_.nextEgress(result_);
+  EXPECT_EQ(result_[0].first, makeFakeTxn(1));
+}
+
+TEST_F(UrgencyQueueTest, H2WeightMapping) {
+  // higher h2 weight -> more urgent
+  auto heavy = q_.addTransaction(
+      1, http2::PriorityUpdate{0, false, 255}, makeFakeTxn(1));
+  auto light = q_.addTransaction(
+      3, http2::PriorityUpdate{0, false, 0}, makeFakeTxn(3));
+  q_.signalPendingEgress(light);
+  q_.signalPendingEgress(heavy);
+
+  q_.nextEgress(result_);
+  ASSERT_EQ(result_.size(), 1);
+  EXPECT_EQ(result_[0].first, makeFakeTxn(1));
+}
+
+} // namespace proxygen
@@ -75,7 +75,60 @@ TLHTTPSessionStats::TLHTTPSessionStats(const std::string& prefix)
                       50,
                       75,
                       95,
-                      99) {
+                      99),
+      txnHeaderLatency(prefix + "_txn_header_latency_us",
+                       1000,
+                       0,
+                       1000000,
+                       facebook::fb303::AVG,
+                       50,
+                       95,
+                       99),
+      txnLifetime(prefix + "_txn_lifetime_us",
+                  10000,
+                  0,
+                  10000000,
+                  facebook::fb303::AVG,
+                  50,
+                  95,
+                  99),
+      pushBytesConsumed(prefix + "_push_bytes_consumed",
+                        facebook::fb303::SUM,
+                        facebook::fb303::RATE),
+      pushBytesWasted(prefix + "_push_bytes_wasted",
+                      facebook::fb303::SUM,
+                      facebook::fb303::RATE),
+      pushCancelLatency(prefix + "_push_cancel_latency_us",
+                        1000,
+                        0,
+                        1000000,
+                        facebook::fb303::AVG,
+                        50,
+                        95,
+                        99) {
+}
+
+void TLHTTPSessionStats::recordHeaderLatency(
+    std::chrono::microseconds latency) noexcept {
+  txnHeaderLatency.add(latency.count());
+}
+
+void TLHTTPSessionStats::recordTransactionLifetime(
+    std::chrono::microseconds lifetime) noexcept {
+  txnLifetime.add(lifetime.count());
+}
+
+void TLHTTPSessionStats::recordPushBytesConsumed(uint64_t bytes) noexcept {
+  pushBytesConsumed.add(bytes);
+}
+
+void TLHTTPSessionStats::recordPushBytesWasted(uint64_t bytes) noexcept {
+  pushBytesWasted.add(bytes);
+}
+
+void TLHTTPSessionStats::recordPushCancelLatency(
+    std::chrono::microseconds latency) noexcept {
+  pushCancelLatency.add(latency.count());
 }
 
 void TLHTTPSessionStats::recordTransactionOpened() noexcept {
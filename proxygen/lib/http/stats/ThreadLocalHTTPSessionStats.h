@@ -37,6 +37,11 @@ class TLHTTPSessionStats : public HTTPSessionStats {
   void recordSessionIdleTime(std::chrono::seconds) noexcept override;
   void recordTransactionStalled() noexcept override;
   void recordSessionStalled() noexcept override;
+  void recordHeaderLatency(std::chrono::microseconds) noexcept override;
+  void recordTransactionLifetime(std::chrono::microseconds) noexcept override;
+  void recordPushBytesConsumed(uint64_t) noexcept override;
+  void recordPushBytesWasted(uint64_t) noexcept override;
+  void recordPushCancelLatency(std::chrono::microseconds) noexcept override;
 
   BaseStats::TLCounter txnsOpen;
   BaseStats::TLTimeseries txnsOpened;
@@ -58,6 +63,13 @@ class TLHTTPSessionStats : public HTTPSessionStats {
   BaseStats::TLTimeseries ttbtxExceedLimit;
   BaseStats::TLHistogram txnsPerSession;
   BaseStats::TLHistogram sessionIdleTime;
+  // microsecond latency intervals observed by the session layer
+  BaseStats::TLHistogram txnHeaderLatency;
+  BaseStats::TLHistogram txnLifetime;
+  // push usefulness
+  BaseStats::TLTimeseries pushBytesConsumed;
+  BaseStats::TLTimeseries pushBytesWasted;
+  BaseStats::TLHistogram pushCancelLatency;
 };
 
 } // namespace proxygen
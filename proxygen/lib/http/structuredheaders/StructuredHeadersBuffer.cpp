@@ -9,6 +9,8 @@
 #include "StructuredHeadersBuffer.h"
 
 #include <boost/lexical_cast.hpp>
+#include <folly/Conv.h>
+#include <limits>
 #include <glog/logging.h>
 
 #include "StructuredHeadersUtilities.h"// @manual=:utils
@@ -137,6 +139,209 @@ DecodeError StructuredHeadersBuffer::parseBinaryContent(
   return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
 }
 
+DecodeError StructuredHeadersBuffer::parseItemView(
+  StructuredHeaderItemView& result) {
+
+  removeOptionalWhitespace();
+
+  if (isEmpty()) {
+    return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+  } else {
+    char firstCharacter = peek();
+    if (firstCharacter == '"') {
+      return parseStringView(result);
+    } else if (firstCharacter == '*') {
+      return parseBinaryContentView(result);
+    } else if (std::isdigit(firstCharacter) || firstCharacter == '-') {
+      return parseNumberView(result);
+    } else {
+      return handleDecodeError(DecodeError::INVALID_CHARACTER);
+    }
+  }
+}
+
+DecodeError StructuredHeadersBuffer::parseNumberView(
+  StructuredHeaderItemView& result) {
+
+  auto type = StructuredHeaderItem::Type::INT64;
+
+  bool positive = true;
+  auto start = content_;
+  int64_t value = 0;
+  int numDigits = 0;
+
+  if (isEmpty()) {
+    return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+  }
+
+  if (peek() == '-') {
+    advanceCursor();
+    positive = false;
+  }
+
+  if (isEmpty()) {
+    return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+  }
+
+  if (!std::isdigit(peek())) {
+    return handleDecodeError(DecodeError::INVALID_CHARACTER);
+  }
+
+  while (!isEmpty()) {
+    char current = peek();
+    if (std::isdigit(current)) {
+      int digit = current - '0';
+      if (value > (std::numeric_limits<int64_t>::max() - digit) / 10) {
+        return handleDecodeError(DecodeError::UNPARSEABLE_NUMERIC_TYPE);
+      }
+      value = value * 10 + digit;
+      numDigits++;
+      advanceCursor();
+    } else if (type == StructuredHeaderItem::Type::INT64 && current == '.') {
+      type = StructuredHeaderItem::Type::DOUBLE;
+      // the dot counts against the float length limit, as in parseNumber
+      numDigits++;
+      advanceCursor();
+    } else {
+      break;
+    }
+
+    if (type == StructuredHeaderItem::Type::INT64 &&
+       numDigits > StructuredHeaders::kMaxValidIntegerLength) {
+      return handleDecodeError(DecodeError::VALUE_TOO_LONG);
+    } else if (type == StructuredHeaderItem::Type::DOUBLE &&
+       numDigits > StructuredHeaders::kMaxValidFloatLength) {
+      return handleDecodeError(DecodeError::VALUE_TOO_LONG);
+    }
+  }
+
+  auto parsed = start.subpiece(0, start.size() - content_.size());
+  if (type == StructuredHeaderItem::Type::INT64) {
+    result.tag = type;
+    result.intValue = positive ? value : -value;
+  } else if (parsed.back() == '.') {
+    return handleDecodeError(DecodeError::INVALID_CHARACTER);
+  } else {
+    auto doubleValue = folly::tryTo<double>(parsed);
+    if (!doubleValue.hasValue()) {
+      return handleDecodeError(DecodeError::UNPARSEABLE_NUMERIC_TYPE);
+    }
+    result.tag = type;
+    result.doubleValue = *doubleValue;
+  }
+  result.stringValue = parsed;
+
+  return DecodeError::OK;
+}
+
+DecodeError StructuredHeadersBuffer::parseStringView(
+  StructuredHeaderItemView& result) {
+
+  if (isEmpty()) {
+    return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+  }
+
+  if (peek() != '"') {
+    return handleDecodeError(DecodeError::INVALID_CHARACTER);
+  }
+
+  advanceCursor();
+  auto start = content_;
+  bool escaped = false;
+
+  while (!isEmpty()) {
+    char current = peek();
+    if (current == '\\') {
+      escaped = true;
+      advanceCursor();
+      if (isEmpty()) {
+        return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+      }
+      char nextChar = peek();
+      advanceCursor();
+      if (nextChar != '"' && nextChar != '\\') {
+        return handleDecodeError(DecodeError::INVALID_CHARACTER);
+      }
+    } else if (current == '"') {
+      // raw bytes between the quotes; escape sequences, if any, are
+      // still encoded - see StructuredHeaderItemView::escaped
+      result.stringValue =
+        start.subpiece(0, start.size() - content_.size());
+      advanceCursor();
+      result.tag = StructuredHeaderItem::Type::STRING;
+      result.escaped = escaped;
+      return DecodeError::OK;
+    } else if (!isValidStringChar(current)) {
+      return handleDecodeError(DecodeError::INVALID_CHARACTER);
+    } else {
+      advanceCursor();
+    }
+  }
+
+  return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+}
+
+DecodeError StructuredHeadersBuffer::parseBinaryContentView(
+  StructuredHeaderItemView& result) {
+
+  if (isEmpty()) {
+    return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+  }
+
+  if (peek() != '*') {
+    return handleDecodeError(DecodeError::INVALID_CHARACTER);
+  }
+
+  advanceCursor();
+  auto start = content_;
+  bool equalSeen = false;
+
+  while (!isEmpty()) {
+    char current = peek();
+    if (current == '*') {
+      auto encoded = start.subpiece(0, start.size() - content_.size());
+      advanceCursor();
+      if (encoded.size() % 4 != 0) {
+        return handleDecodeError(DecodeError::UNDECODEABLE_BINARY_CONTENT);
+      }
+      // still base64: the view hands out the encoded bytes
+      result.stringValue = encoded;
+      result.tag = StructuredHeaderItem::Type::BINARYCONTENT;
+      return DecodeError::OK;
+    }
+    // padding may only appear at the end, like
+    // isValidEncodedBinaryContent enforces for the owning parse
+    if (current == '=') {
+      equalSeen = true;
+    } else if (equalSeen || !isValidEncodedBinaryContentChar(current)) {
+      return handleDecodeError(DecodeError::UNDECODEABLE_BINARY_CONTENT);
+    }
+    advanceCursor();
+  }
+
+  return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+}
+
+DecodeError StructuredHeadersBuffer::parseIdentifierView(
+  folly::StringPiece& result) {
+
+  if (isEmpty()) {
+    return handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+  }
+
+  if (!isLcAlpha(peek())) {
+    return handleDecodeError(DecodeError::INVALID_CHARACTER);
+  }
+
+  auto start = content_;
+  while (!isEmpty() && isValidIdentifierChar(peek())) {
+    advanceCursor();
+  }
+  result = start.subpiece(0, start.size() - content_.size());
+
+  return DecodeError::OK;
+}
+
 DecodeError StructuredHeadersBuffer::parseIdentifier(
   StructuredHeaderItem& result) {
 
@@ -23,6 +23,10 @@ public:
     content_(s),
     originalContent_(s) {}
 
+  explicit StructuredHeadersBuffer(folly::StringPiece s) :
+    content_(s),
+    originalContent_(s) {}
+
   /*
    * helper functions used to extract various lower-level items from a sequence
    * of bytes. These will be called from higher level functions which parse
@@ -35,6 +39,17 @@ public:
 
   StructuredHeaders::DecodeError parseItem(StructuredHeaderItem& result);
 
+  /*
+   * Non-owning variants: results reference the parsed buffer (see
+   * StructuredHeaderItemView).  Numbers are scanned in place without
+   * intermediate strings, so these never allocate.
+   */
+  StructuredHeaders::DecodeError parseItemView(
+    StructuredHeaderItemView& result);
+
+  StructuredHeaders::DecodeError parseIdentifierView(
+    folly::StringPiece& result);
+
   DecodeError removeSymbol(const std::string& symbol, bool strict);
 
   DecodeError removeOptionalWhitespace();
@@ -51,6 +66,12 @@ private:
 
   DecodeError parseString(StructuredHeaderItem& result);
 
+  DecodeError parseNumberView(StructuredHeaderItemView& result);
+
+  DecodeError parseStringView(StructuredHeaderItemView& result);
+
+  DecodeError parseBinaryContentView(StructuredHeaderItemView& result);
+
   DecodeError parseInteger(const std::string& input,
     StructuredHeaderItem& result);
 
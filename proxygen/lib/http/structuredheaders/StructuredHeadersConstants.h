@@ -12,6 +12,8 @@
 #include <map>
 #include <vector>
 #include <boost/variant.hpp>
+#include <folly/Range.h>
+#include <folly/small_vector.h>
 #include <vector>
 
 namespace proxygen {
@@ -56,6 +58,36 @@ struct ParameterisedIdentifier {
   std::unordered_map<std::string, StructuredHeaderItem> parameterMap;
 };
 
+/*
+ * Non-owning view of an item: string-typed values point into the
+ * buffer being parsed and stay valid only as long as it does.  For
+ * STRING items, escaped == true means the raw bytes contain backslash
+ * escape sequences and an owning parse is needed for the decoded form;
+ * identifiers and numbers never escape, so parsing them allocates
+ * nothing.
+ */
+struct StructuredHeaderItemView {
+  StructuredHeaderItem::Type tag{StructuredHeaderItem::Type::NONE};
+  int64_t intValue{0};
+  double doubleValue{0.0};
+  folly::StringPiece stringValue;
+  bool escaped{false};
+};
+
+/*
+ * View-mode parameterised list: identifiers and parameter keys are
+ * pieces of the parsed buffer, and the typical short parameter lists
+ * ("u=3, i") stay in the inline small_vector storage.
+ */
+struct ParameterisedIdentifierView {
+  folly::StringPiece identifier;
+  folly::small_vector<std::pair<folly::StringPiece, StructuredHeaderItemView>,
+                      2>
+      parameters;
+};
+
+using ParameterisedListView = folly::small_vector<ParameterisedIdentifierView, 4>;
+
 using ParameterisedList =
   std::vector<StructuredHeaders::ParameterisedIdentifier>;
 
@@ -99,6 +99,66 @@ DecodeError StructuredHeadersDecoder::decodeParameterisedList(
   return buf_.handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
 }
 
+DecodeError StructuredHeadersDecoder::decodeParameterisedListView(
+  ParameterisedListView& result) {
+
+  while (!buf_.isEmpty()) {
+
+    result.emplace_back();
+    auto& primaryIdentifier = result.back();
+
+    auto err = buf_.parseIdentifierView(primaryIdentifier.identifier);
+    if (err != DecodeError::OK) {
+      return err;
+    }
+
+    buf_.removeOptionalWhitespace();
+
+    // parameter map, view flavor of decodeMap's PARAMETERISED_MAP mode
+    while (buf_.removeSymbol(";", false) == DecodeError::OK) {
+      buf_.removeOptionalWhitespace();
+
+      folly::StringPiece key;
+      err = buf_.parseIdentifierView(key);
+      if (err != DecodeError::OK) {
+        return err;
+      }
+
+      for (const auto& parameter : primaryIdentifier.parameters) {
+        if (parameter.first == key) {
+          return buf_.handleDecodeError(DecodeError::DUPLICATE_KEY);
+        }
+      }
+
+      StructuredHeaderItemView value;
+      if (buf_.removeSymbol("=", false) == DecodeError::OK) {
+        err = buf_.parseItemView(value);
+        if (err != DecodeError::OK) {
+          return err;
+        }
+      }
+      primaryIdentifier.parameters.emplace_back(key, value);
+
+      buf_.removeOptionalWhitespace();
+    }
+
+    buf_.removeOptionalWhitespace();
+
+    if (buf_.isEmpty()) {
+      return DecodeError::OK;
+    }
+
+    err = buf_.removeSymbol(",", true);
+    if (err != DecodeError::OK) {
+      return err;
+    }
+
+    buf_.removeOptionalWhitespace();
+  }
+
+  return buf_.handleDecodeError(DecodeError::UNEXPECTED_END_OF_BUFFER);
+}
+
 DecodeError StructuredHeadersDecoder::decodeMap(
   std::unordered_map<std::string, StructuredHeaderItem>& result,
   MapType mapType) {
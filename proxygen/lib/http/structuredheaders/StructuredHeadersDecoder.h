@@ -19,6 +19,8 @@ public:
 
   explicit StructuredHeadersDecoder(const std::string& s): buf_(s) {}
 
+  explicit StructuredHeadersDecoder(folly::StringPiece s): buf_(s) {}
+
   StructuredHeaders::DecodeError decodeItem(StructuredHeaderItem& result);
 
   StructuredHeaders::DecodeError
@@ -29,6 +31,15 @@ public:
   StructuredHeaders::DecodeError
     decodeParameterisedList(ParameterisedList& result);
 
+  /*
+   * Non-owning variant: identifiers, parameter keys and string values
+   * reference the decoded buffer, and short lists stay in the inline
+   * small_vector storage, so e.g. "u=3, i" decodes with no
+   * allocations.
+   */
+  StructuredHeaders::DecodeError
+    decodeParameterisedListView(ParameterisedListView& result);
+
 private:
   enum class MapType {
     DICTIONARY = 0,
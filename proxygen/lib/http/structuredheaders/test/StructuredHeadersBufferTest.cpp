@@ -324,4 +324,66 @@ TEST_F(StructuredHeadersBufferTest, TestInequalityOperator) {
   EXPECT_NE(stringItem, std::string("bye"));
 }
 
+
+TEST_F(StructuredHeadersBufferTest, TestItemViewInteger) {
+  folly::StringPiece input("88037");
+  StructuredHeadersBuffer shd(input);
+  StructuredHeaderItemView output;
+  EXPECT_EQ(shd.parseItemView(output), StructuredHeaders::DecodeError::OK);
+  EXPECT_EQ(output.tag, StructuredHeaderItem::Type::INT64);
+  EXPECT_EQ(output.intValue, 88037);
+
+  folly::StringPiece negative("-273");
+  StructuredHeadersBuffer shd2(negative);
+  EXPECT_EQ(shd2.parseItemView(output), StructuredHeaders::DecodeError::OK);
+  EXPECT_EQ(output.intValue, -273);
+}
+
+TEST_F(StructuredHeadersBufferTest, TestItemViewDouble) {
+  folly::StringPiece input("3.1415");
+  StructuredHeadersBuffer shd(input);
+  StructuredHeaderItemView output;
+  EXPECT_EQ(shd.parseItemView(output), StructuredHeaders::DecodeError::OK);
+  EXPECT_EQ(output.tag, StructuredHeaderItem::Type::DOUBLE);
+  EXPECT_DOUBLE_EQ(output.doubleValue, 3.1415);
+}
+
+TEST_F(StructuredHeadersBufferTest, TestItemViewIntegerOverflow) {
+  folly::StringPiece input("9999999999999999999");
+  StructuredHeadersBuffer shd(input);
+  StructuredHeaderItemView output;
+  EXPECT_NE(shd.parseItemView(output), StructuredHeaders::DecodeError::OK);
+}
+
+TEST_F(StructuredHeadersBufferTest, TestItemViewString) {
+  std::string input = "\"plain text\"";
+  StructuredHeadersBuffer shd(folly::StringPiece(input));
+  StructuredHeaderItemView output;
+  EXPECT_EQ(shd.parseItemView(output), StructuredHeaders::DecodeError::OK);
+  EXPECT_EQ(output.tag, StructuredHeaderItem::Type::STRING);
+  EXPECT_EQ(output.stringValue, "plain text");
+  EXPECT_FALSE(output.escaped);
+  // the view points into the parsed buffer
+  EXPECT_EQ(output.stringValue.begin(), input.data() + 1);
+}
+
+TEST_F(StructuredHeadersBufferTest, TestItemViewEscapedString) {
+  std::string input = "\"say \\\"hi\\\"\"";
+  StructuredHeadersBuffer shd(folly::StringPiece(input));
+  StructuredHeaderItemView output;
+  EXPECT_EQ(shd.parseItemView(output), StructuredHeaders::DecodeError::OK);
+  EXPECT_EQ(output.tag, StructuredHeaderItem::Type::STRING);
+  // raw bytes, still escaped; callers needing the decoded form re-parse
+  EXPECT_TRUE(output.escaped);
+  EXPECT_EQ(output.stringValue, "say \\\"hi\\\"");
+}
+
+TEST_F(StructuredHeadersBufferTest, TestIdentifierView) {
+  folly::StringPiece input("a_b-c*/d rest");
+  StructuredHeadersBuffer shd(input);
+  folly::StringPiece output;
+  EXPECT_EQ(shd.parseIdentifierView(output), StructuredHeaders::DecodeError::OK);
+  EXPECT_EQ(output, "a_b-c*/d");
+}
+
 }
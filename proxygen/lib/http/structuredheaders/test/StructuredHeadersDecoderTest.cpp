@@ -221,4 +221,45 @@ TEST_F(StructuredHeadersDecoderTest, TestParamListNullValues) {
   EXPECT_EQ(pl[1].parameterMap["burger"].tag, StructuredHeaderItem::Type::NONE);
 }
 
+
+TEST_F(StructuredHeadersDecoderTest, TestParameterisedListView) {
+  std::string input = "ftp;scheme=\"far\";fast=9.73, http;q=2";
+  StructuredHeadersDecoder decoder(folly::StringPiece(input));
+  ParameterisedListView result;
+  EXPECT_EQ(decoder.decodeParameterisedListView(result),
+            StructuredHeaders::DecodeError::OK);
+  ASSERT_EQ(result.size(), 2);
+
+  EXPECT_EQ(result[0].identifier, "ftp");
+  ASSERT_EQ(result[0].parameters.size(), 2);
+  EXPECT_EQ(result[0].parameters[0].first, "scheme");
+  EXPECT_EQ(result[0].parameters[0].second.tag,
+            StructuredHeaderItem::Type::STRING);
+  EXPECT_EQ(result[0].parameters[0].second.stringValue, "far");
+  EXPECT_EQ(result[0].parameters[1].first, "fast");
+  EXPECT_EQ(result[0].parameters[1].second.tag,
+            StructuredHeaderItem::Type::DOUBLE);
+  EXPECT_DOUBLE_EQ(result[0].parameters[1].second.doubleValue, 9.73);
+
+  EXPECT_EQ(result[1].identifier, "http");
+  ASSERT_EQ(result[1].parameters.size(), 1);
+  EXPECT_EQ(result[1].parameters[0].second.intValue, 2);
+}
+
+TEST_F(StructuredHeadersDecoderTest, TestParameterisedListViewShort) {
+  // the short priority-style shape this mode exists for; stays within
+  // the inline small_vector storage
+  std::string input = "u;q=3, i";
+  StructuredHeadersDecoder decoder(folly::StringPiece(input));
+  ParameterisedListView result;
+  EXPECT_EQ(decoder.decodeParameterisedListView(result),
+            StructuredHeaders::DecodeError::OK);
+  ASSERT_EQ(result.size(), 2);
+  EXPECT_EQ(result[0].identifier, "u");
+  ASSERT_EQ(result[0].parameters.size(), 1);
+  EXPECT_EQ(result[0].parameters[0].first, "q");
+  EXPECT_EQ(result[0].parameters[0].second.intValue, 3);
+  EXPECT_EQ(result[1].identifier, "i");
+  EXPECT_EQ(result[1].parameters.size(), 0);
+}
 }
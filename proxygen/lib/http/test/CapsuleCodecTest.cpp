@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/CapsuleCodec.h>
+
+#include <folly/portability/GTest.h>
+#include <vector>
+
+using namespace proxygen;
+
+namespace {
+
+struct RecordingCallback : CapsuleCodec::Callback {
+  struct Datagram {
+    uint64_t contextId;
+    std::string payload;
+  };
+  std::vector<Datagram> datagrams;
+  std::vector<uint64_t> unknownTypes;
+  bool error{false};
+
+  void onDatagramCapsule(uint64_t contextId,
+                         std::unique_ptr<folly::IOBuf> payload) override {
+    auto range = payload->coalesce();
+    datagrams.push_back(
+        {contextId,
+         std::string(reinterpret_cast<const char*>(range.data()),
+                     range.size())});
+  }
+  void onUnknownCapsule(uint64_t type,
+                        std::unique_ptr<folly::IOBuf>) override {
+    unknownTypes.push_back(type);
+  }
+  void onCapsuleError() override {
+    error = true;
+  }
+};
+
+} // namespace
+
+TEST(CapsuleCodecTest, EncodeDecodeRoundtrip) {
+  RecordingCallback callback;
+  CapsuleCodec codec(&callback);
+
+  codec.onIngress(
+      CapsuleCodec::encodeDatagram(0, folly::IOBuf::copyBuffer("ping")));
+  codec.onIngress(CapsuleCodec::encodeDatagram(
+      777, folly::IOBuf::copyBuffer(std::string(2000, 'd'))));
+
+  ASSERT_EQ(callback.datagrams.size(), 2);
+  EXPECT_EQ(callback.datagrams[0].contextId, 0);
+  EXPECT_EQ(callback.datagrams[0].payload, "ping");
+  EXPECT_EQ(callback.datagrams[1].contextId, 777);
+  EXPECT_EQ(callback.datagrams[1].payload.size(), 2000);
+  EXPECT_FALSE(callback.error);
+}
+
+TEST(CapsuleCodecTest, SplitAtEveryByte) {
+  auto one = CapsuleCodec::encodeDatagram(0, folly::IOBuf::copyBuffer("abc"));
+  auto two =
+      CapsuleCodec::encodeDatagram(65, folly::IOBuf::copyBuffer("defgh"));
+  one->prependChain(std::move(two));
+  auto range = one->coalesce();
+  std::string wire(reinterpret_cast<const char*>(range.data()), range.size());
+
+  for (size_t split = 1; split < wire.size(); split++) {
+    RecordingCallback callback;
+    CapsuleCodec codec(&callback);
+    codec.onIngress(folly::IOBuf::copyBuffer(wire.substr(0, split)));
+    codec.onIngress(folly::IOBuf::copyBuffer(wire.substr(split)));
+    ASSERT_EQ(callback.datagrams.size(), 2) << "split=" << split;
+    EXPECT_EQ(callback.datagrams[0].payload, "abc");
+    EXPECT_EQ(callback.datagrams[1].contextId, 65);
+    EXPECT_EQ(callback.datagrams[1].payload, "defgh");
+    EXPECT_FALSE(callback.error);
+  }
+}
+
+TEST(CapsuleCodecTest, HeaderRidesPayloadHeadroom) {
+  auto payload = folly::IOBuf::create(64);
+  payload->advance(16);
+  memcpy(payload->writableTail(), "data", 4);
+  payload->append(4);
+  const uint8_t* payloadData = payload->data();
+
+  auto capsule = CapsuleCodec::encodeDatagram(0, std::move(payload));
+  // fused: single buffer, header written into the original headroom
+  EXPECT_FALSE(capsule->isChained());
+  EXPECT_LT(capsule->data(), payloadData);
+
+  // a headroom-less payload gets a chained header buffer instead
+  auto bare = folly::IOBuf::copyBuffer("data");
+  auto chained = CapsuleCodec::encodeDatagram(0, std::move(bare));
+  EXPECT_TRUE(chained->isChained());
+}
+
+TEST(CapsuleCodecTest, UnknownCapsuleSkipped) {
+  RecordingCallback callback;
+  CapsuleCodec codec(&callback);
+  // type 0x17, length 3, three bytes of value, then a real datagram
+  auto unknown = folly::IOBuf::copyBuffer(std::string("\x17\x03xyz", 5));
+  codec.onIngress(std::move(unknown));
+  codec.onIngress(
+      CapsuleCodec::encodeDatagram(0, folly::IOBuf::copyBuffer("after")));
+  ASSERT_EQ(callback.unknownTypes.size(), 1);
+  EXPECT_EQ(callback.unknownTypes[0], 0x17);
+  ASSERT_EQ(callback.datagrams.size(), 1);
+  EXPECT_EQ(callback.datagrams[0].payload, "after");
+}
+
+TEST(CapsuleCodecTest, TruncatedContextIdErrors) {
+  RecordingCallback callback;
+  CapsuleCodec codec(&callback);
+  // DATAGRAM capsule claiming a 1-byte value that is only the first
+  // byte of a multi-byte context id varint
+  codec.onIngress(
+      folly::IOBuf::copyBuffer(std::string("\x00\x01\x40", 3)));
+  EXPECT_TRUE(callback.error);
+  EXPECT_TRUE(codec.hasError());
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/HTTPCommonValues.h>
+
+using namespace proxygen;
+
+TEST(HTTPCommonValues, Lookup) {
+  auto interned = HTTPCommonValues::getPointerToCommonValue("keep-alive");
+  ASSERT_NE(interned, nullptr);
+  EXPECT_EQ(*interned, "keep-alive");
+  // same pointer on every lookup: safe to hold for the process lifetime
+  EXPECT_EQ(HTTPCommonValues::getPointerToCommonValue("keep-alive"), interned);
+}
+
+TEST(HTTPCommonValues, Miss) {
+  EXPECT_EQ(HTTPCommonValues::getPointerToCommonValue("not-a-common-value"),
+            nullptr);
+  EXPECT_EQ(HTTPCommonValues::getPointerToCommonValue(""), nullptr);
+  // lookups are exact and case-sensitive
+  EXPECT_EQ(HTTPCommonValues::getPointerToCommonValue("Keep-Alive"), nullptr);
+}
+
+TEST(HTTPCommonValues, TableSanity) {
+  EXPECT_GT(HTTPCommonValues::numValues(), 50);
+}
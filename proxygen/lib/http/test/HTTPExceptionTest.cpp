@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/HTTPException.h>
+
+#include <folly/portability/GTest.h>
+
+using namespace proxygen;
+
+TEST(HTTPExceptionTest, DescriptorLazyMessage) {
+  HTTPErrorDescriptor descriptor;
+  descriptor.error = kErrorStreamUnacknowledged;
+  descriptor.streamID = 7;
+  descriptor.setDetail("peer went away");
+  descriptor.hasCodecStatusCode = true;
+  descriptor.codecStatusCode = ErrorCode::REFUSED_STREAM;
+  descriptor.httpStatusCode = 503;
+
+  HTTPException ex(HTTPException::Direction::INGRESS_AND_EGRESS, descriptor);
+  // the POD state is available without materializing anything
+  EXPECT_EQ(ex.getProxygenError(), kErrorStreamUnacknowledged);
+  EXPECT_TRUE(ex.hasCodecStatusCode());
+  EXPECT_EQ(ex.getCodecStatusCode(), ErrorCode::REFUSED_STREAM);
+  EXPECT_EQ(ex.getHttpStatusCode(), 503);
+
+  // copies carry the descriptor; the message materializes on what()
+  HTTPException copy(ex);
+  std::string message = copy.what();
+  EXPECT_EQ(message,
+            std::string(getErrorString(kErrorStreamUnacknowledged)) +
+                " on transaction id: 7. peer went away");
+  // repeated calls are stable
+  EXPECT_EQ(message, copy.what());
+}
+
+TEST(HTTPExceptionTest, DetailTruncates) {
+  HTTPErrorDescriptor descriptor;
+  std::string longDetail(300, 'x');
+  descriptor.setDetail(longDetail);
+  EXPECT_EQ(descriptor.getDetail().size(), sizeof(descriptor.detail));
+  EXPECT_EQ(descriptor.getDetail(),
+            longDetail.substr(0, sizeof(descriptor.detail)));
+}
@@ -10,6 +10,7 @@
 #include <folly/Benchmark.h>
 #include <proxygen/lib/http/HTTPCommonHeaders.h>
 #include <proxygen/lib/http/HTTPHeaders.h>
+#include <proxygen/lib/utils/PerfectIndexMap.h>
 
 using namespace proxygen;
 
@@ -150,6 +151,103 @@ BENCHMARK(addCode24_headers_32_length, iters) {
   addCodeBench(24, 32, iters);
 }
 
+namespace {
+
+// candidate backing store for HTTPHeaders; benchmarked head to head
+// against the parallel-vector scheme on realistic request workloads
+typedef PerfectIndexMap<HTTPHeaderCode,
+                        HTTP_HEADER_OTHER,
+                        HTTP_HEADER_NONE,
+                        HTTPCommonHeaders::hash,
+                        false,
+                        false>
+    HeadersPerfectIndexMap;
+
+// a typical request: mostly common names, a couple of x- customs
+const std::vector<std::pair<std::string, std::string>>& requestWorkload() {
+  static const std::vector<std::pair<std::string, std::string>> workload = {
+      {":authority", "www.example.com"},
+      {":method", "GET"},
+      {":path", "/index.php?q=abc"},
+      {":scheme", "https"},
+      {"accept", "text/html,application/xml;q=0.9"},
+      {"accept-encoding", "gzip, deflate, br"},
+      {"accept-language", "en-US,en;q=0.5"},
+      {"cookie", "session=deadbeef; tracking=0"},
+      {"user-agent", "Mozilla/5.0 benchmark"},
+      {"x-custom-tag", "42"},
+      {"x-request-id", "00000000-0000-4000-8000-000000000000"},
+  };
+  return workload;
+}
+
+} // namespace
+
+BENCHMARK(HTTPHeadersAddByName, iters) {
+  for (unsigned i = 0; i < iters; ++i) {
+    HTTPHeaders headers;
+    for (const auto& header : requestWorkload()) {
+      headers.add(header.first, header.second);
+    }
+    folly::doNotOptimizeAway(headers.size());
+  }
+}
+
+BENCHMARK_RELATIVE(PerfectIndexMapAddByName, iters) {
+  for (unsigned i = 0; i < iters; ++i) {
+    HeadersPerfectIndexMap headers;
+    for (const auto& header : requestWorkload()) {
+      headers.add(header.first, header.second);
+    }
+    folly::doNotOptimizeAway(&headers);
+  }
+}
+
+BENCHMARK(HTTPHeadersGetCommon, iters) {
+  HTTPHeaders headers;
+  for (const auto& header : requestWorkload()) {
+    headers.add(header.first, header.second);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    const auto& userAgent = headers.getSingleOrEmpty(HTTP_HEADER_USER_AGENT);
+    folly::doNotOptimizeAway(userAgent.data());
+    const auto& cookie = headers.getSingleOrEmpty(HTTP_HEADER_COOKIE);
+    folly::doNotOptimizeAway(cookie.data());
+  }
+}
+
+BENCHMARK_RELATIVE(PerfectIndexMapGetCommon, iters) {
+  HeadersPerfectIndexMap headers;
+  for (const auto& header : requestWorkload()) {
+    headers.add(header.first, header.second);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(headers.getSingleOrNone(HTTP_HEADER_USER_AGENT));
+    folly::doNotOptimizeAway(headers.getSingleOrNone(HTTP_HEADER_COOKIE));
+  }
+}
+
+BENCHMARK(HTTPHeadersGetUncommon, iters) {
+  HTTPHeaders headers;
+  for (const auto& header : requestWorkload()) {
+    headers.add(header.first, header.second);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    const auto& requestId = headers.getSingleOrEmpty("x-request-id");
+    folly::doNotOptimizeAway(requestId.data());
+  }
+}
+
+BENCHMARK_RELATIVE(PerfectIndexMapGetUncommon, iters) {
+  HeadersPerfectIndexMap headers;
+  for (const auto& header : requestWorkload()) {
+    headers.add(header.first, header.second);
+  }
+  for (unsigned i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(headers.getSingleOrNone("x-request-id"));
+  }
+}
+
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   folly::runBenchmarks();
@@ -17,6 +17,52 @@
 using namespace proxygen;
 using namespace std;
 
+TEST(HTTPMessage, TestTypedHeaderCache) {
+  HTTPMessage msg;
+  msg.getHeaders().add(HTTP_HEADER_CONTENT_LENGTH, "12345");
+  msg.getHeaders().add(HTTP_HEADER_ACCEPT_ENCODING, "gzip, br;q=0.8, x;q=0");
+
+  ASSERT_TRUE(msg.getTypedContentLength().hasValue());
+  EXPECT_EQ(*msg.getTypedContentLength(), 12345);
+  EXPECT_TRUE(msg.acceptsEncoding("gzip"));
+  EXPECT_TRUE(msg.acceptsEncoding("GZIP")); // case-insensitive
+  EXPECT_TRUE(msg.acceptsEncoding("br"));
+  EXPECT_FALSE(msg.acceptsEncoding("x")); // q=0 means rejected
+  EXPECT_FALSE(msg.acceptsEncoding("zstd"));
+
+  // mutation invalidates: the cache must re-derive
+  msg.getHeaders().set(HTTP_HEADER_CONTENT_LENGTH, "99");
+  EXPECT_EQ(*msg.getTypedContentLength(), 99);
+  msg.getHeaders().remove(HTTP_HEADER_ACCEPT_ENCODING);
+  EXPECT_FALSE(msg.acceptsEncoding("gzip"));
+
+  // malformed values parse to none
+  msg.getHeaders().set(HTTP_HEADER_CONTENT_LENGTH, "banana");
+  EXPECT_FALSE(msg.getTypedContentLength().hasValue());
+}
+
+TEST(HTTPMessage, TestForwardingCopy) {
+  HTTPMessage msg;
+  msg.setMethod(HTTPMethod::GET);
+  msg.setURL("/search?q=abc&n=10");
+  msg.getHeaders().add(HTTP_HEADER_COOKIE, "id=1; theme=dark");
+  msg.getHeaders().add(HTTP_HEADER_HOST, "www.example.com");
+  // populate the derived caches on the original
+  EXPECT_EQ(msg.getCookie("theme"), "dark");
+  EXPECT_EQ(msg.getQueryParam("q"), "abc");
+
+  HTTPMessage forwarded = msg.forwardingCopy();
+  EXPECT_EQ(forwarded.getMethodString(), "GET");
+  EXPECT_EQ(forwarded.getURL(), "/search?q=abc&n=10");
+  EXPECT_EQ(forwarded.getPath(), "/search");
+  EXPECT_EQ(forwarded.getHeaders().getSingleOrEmpty(HTTP_HEADER_HOST),
+            "www.example.com");
+  // the caches were left behind and re-derive lazily - and point into
+  // the forwarded copy's own storage
+  EXPECT_EQ(forwarded.getCookie("theme"), "dark");
+  EXPECT_EQ(forwarded.getQueryParam("n"), "10");
+}
+
 TEST(HTTPMessage, TestParseCookiesSimple) {
   HTTPMessage msg;
 
@@ -465,6 +511,104 @@ TEST(HTTPHeaders, AddStringPiece) {
   EXPECT_EQ("value", headers.getSingleOrEmpty("name"));
 }
 
+TEST(HTTPMessage, TestForEachQueryParam) {
+  HTTPMessage msg;
+  msg.setMethod(HTTPMethod::GET);
+  msg.setURL(std::string("/foo?a=1&b=two%20words&flag&c=3"));
+
+  std::vector<std::pair<std::string, std::string>> seen;
+  bool stopped = msg.forEachQueryParam(
+      [&](folly::StringPiece name, folly::StringPiece value) {
+        seen.emplace_back(name.str(), value.str());
+        return false;
+      });
+  EXPECT_FALSE(stopped);
+  ASSERT_EQ(seen.size(), 4);
+  EXPECT_EQ(seen[0], std::make_pair(std::string("a"), std::string("1")));
+  // raw view: no percent decoding
+  EXPECT_EQ(seen[1],
+            std::make_pair(std::string("b"), std::string("two%20words")));
+  EXPECT_EQ(seen[2], std::make_pair(std::string("flag"), std::string("")));
+
+  EXPECT_EQ(msg.getQueryParamRaw("b"), "two%20words");
+  EXPECT_EQ(msg.getQueryParamRaw("missing"), "");
+  // scan-gated decode: unencoded values come back as a piece into the
+  // raw query (no scratch use), encoded ones decode into scratch
+  std::string scratch;
+  auto decodedA = msg.getQueryParamDecoded("a", scratch);
+  EXPECT_EQ(decodedA, "1");
+  EXPECT_EQ(decodedA.data(), msg.getQueryParamRaw("a").data());
+  EXPECT_EQ(msg.getQueryParamDecoded("b", scratch), "two words");
+  EXPECT_EQ(msg.getQueryParamDecoded("missing", scratch), "");
+  // early stop reported
+  EXPECT_TRUE(msg.forEachQueryParam(
+      [](folly::StringPiece name, folly::StringPiece) {
+        return name == "b";
+      }));
+}
+
+TEST(HTTPMessage, TestLazyUrlDecomposition) {
+  HTTPMessage msg;
+  msg.setMethod(HTTPMethod::GET);
+  msg.setURLLazy(std::string("/foo/bar?baz=1&qux=2"));
+  EXPECT_EQ(msg.getURL(), "/foo/bar?baz=1&qux=2");
+  // decomposition happens on first access
+  EXPECT_EQ(msg.getPathAsStringPiece(), "/foo/bar");
+  EXPECT_EQ(msg.getQueryStringAsStringPiece(), "baz=1&qux=2");
+  EXPECT_EQ(msg.getQueryParam("baz"), "1");
+
+  // copies re-point the pieces into their own url storage
+  HTTPMessage copy(msg);
+  EXPECT_EQ(copy.getPathAsStringPiece(), "/foo/bar");
+  EXPECT_EQ(copy.getPathAsStringPiece().data() >= copy.getURL().data() &&
+                copy.getPathAsStringPiece().data() <
+                    copy.getURL().data() + copy.getURL().size(),
+            true);
+
+  // mutation still works on a lazily-set URL
+  HTTPMessage msg2;
+  msg2.setMethod(HTTPMethod::GET);
+  msg2.setURLLazy(std::string("/p?a=1"));
+  EXPECT_TRUE(msg2.setQueryParam("b", "2"));
+  EXPECT_EQ(msg2.getQueryParam("a"), "1");
+  EXPECT_EQ(msg2.getQueryParam("b"), "2");
+
+  // invalid URLs decompose to empty path/query, as with setURL
+  HTTPMessage bad;
+  bad.setMethod(HTTPMethod::GET);
+  bad.setURLLazy(std::string("/foo\x01"));
+  EXPECT_EQ(bad.getPathAsStringPiece(), "");
+  EXPECT_EQ(bad.getQueryStringAsStringPiece(), "");
+}
+
+TEST(HTTPHeaders, CodePresenceFastPath) {
+  HTTPHeaders headers;
+  EXPECT_FALSE(headers.exists(HTTP_HEADER_HOST));
+  headers.add(HTTP_HEADER_HOST, "www.facebook.com");
+  headers.add(HTTP_HEADER_ACCEPT, "text/html");
+  EXPECT_TRUE(headers.exists(HTTP_HEADER_HOST));
+  EXPECT_FALSE(headers.exists(HTTP_HEADER_COOKIE));
+  EXPECT_EQ(headers.getNumberOfValues(HTTP_HEADER_COOKIE), 0);
+  EXPECT_EQ(headers.getSingleOrEmpty(HTTP_HEADER_COOKIE), "");
+
+  // removal leaves the presence bit set; the scan must still be correct
+  EXPECT_TRUE(headers.remove(HTTP_HEADER_HOST));
+  EXPECT_FALSE(headers.exists(HTTP_HEADER_HOST));
+  EXPECT_FALSE(headers.remove(HTTP_HEADER_HOST));
+
+  // copies and moves carry the bitmap along
+  HTTPHeaders copied(headers);
+  EXPECT_TRUE(copied.exists(HTTP_HEADER_ACCEPT));
+  EXPECT_FALSE(copied.exists(HTTP_HEADER_COOKIE));
+  HTTPHeaders moved(std::move(copied));
+  EXPECT_TRUE(moved.exists(HTTP_HEADER_ACCEPT));
+
+  moved.removeAll();
+  EXPECT_FALSE(moved.exists(HTTP_HEADER_ACCEPT));
+  moved.add(HTTP_HEADER_ACCEPT, "text/plain");
+  EXPECT_TRUE(moved.exists(HTTP_HEADER_ACCEPT));
+}
+
 TEST(HTTPHeaders, InitializerList) {
   HTTPHeaders hdrs;
 
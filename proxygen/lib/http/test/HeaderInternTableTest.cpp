@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/HeaderInternTable.h>
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/HTTPHeaders.h>
+#include <proxygen/lib/http/codec/compress/HPACKHeaderName.h>
+
+using namespace proxygen;
+
+TEST(HeaderInternTableTest, AdmissionAfterThreshold) {
+  auto& table = HeaderInternTable::get();
+  const std::string name = "x-internal-test-admission";
+
+  // below the threshold: allocated fresh each time
+  const std::string* last = nullptr;
+  for (uint32_t i = 0; i + 1 < HeaderInternTable::kInternThreshold; i++) {
+    auto* ptr = HeaderInternTable::internOrAllocate(name);
+    EXPECT_FALSE(table.isInterned(ptr));
+    HeaderInternTable::releaseName(ptr);
+  }
+  // crossing the threshold admits it; from then on the same immortal
+  // entry comes back every time
+  auto* first = HeaderInternTable::internOrAllocate(name);
+  ASSERT_TRUE(table.isInterned(first));
+  EXPECT_EQ(*first, name);
+  last = HeaderInternTable::internOrAllocate(name);
+  EXPECT_EQ(first, last);
+  HeaderInternTable::releaseName(first); // no-op on interned entries
+  HeaderInternTable::releaseName(last);
+  EXPECT_EQ(*first, name);
+}
+
+TEST(HeaderInternTableTest, SharedAcrossMessageAndCodecLayers) {
+  const std::string name = "x-internal-shared-layer";
+  const std::string* interned = nullptr;
+  for (uint32_t i = 0; i <= HeaderInternTable::kInternThreshold; i++) {
+    auto* ptr = HeaderInternTable::internOrAllocate(name);
+    if (HeaderInternTable::get().isInterned(ptr)) {
+      interned = ptr;
+      break;
+    }
+    HeaderInternTable::releaseName(ptr);
+  }
+  ASSERT_NE(interned, nullptr);
+
+  // both layers resolve to the same immortal entry
+  HPACKHeaderName codecName{folly::StringPiece(name)};
+  EXPECT_EQ(&codecName.get(), interned);
+
+  HTTPHeaders headers;
+  headers.add(name, "v");
+  headers.forEachWithCode([&](HTTPHeaderCode code,
+                              const std::string& storedName,
+                              const std::string&) {
+    if (code == HTTP_HEADER_OTHER) {
+      EXPECT_EQ(&storedName, interned);
+    }
+  });
+  // copies share the entry rather than duplicating it
+  HTTPHeaders copy(headers);
+  copy.forEachWithCode([&](HTTPHeaderCode code,
+                           const std::string& storedName,
+                           const std::string&) {
+    if (code == HTTP_HEADER_OTHER) {
+      EXPECT_EQ(&storedName, interned);
+    }
+  });
+}
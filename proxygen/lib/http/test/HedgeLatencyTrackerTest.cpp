@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/HedgedRequest.h>
+
+using namespace proxygen;
+using namespace std::chrono;
+
+TEST(HedgeLatencyTrackerTest, FloorUntilEnoughSamples) {
+  HedgeLatencyTracker tracker(milliseconds(40), 10);
+  EXPECT_EQ(tracker.hedgeDelay(), milliseconds(40));
+  for (int i = 0; i < 9; i++) {
+    tracker.record(microseconds(200000));
+  }
+  EXPECT_EQ(tracker.hedgeDelay(), milliseconds(40));
+  tracker.record(microseconds(200000));
+  // enough samples: the delay tracks the observed p95
+  EXPECT_GE(tracker.hedgeDelay(), milliseconds(190));
+}
+
+TEST(HedgeLatencyTrackerTest, TracksTail) {
+  HedgeLatencyTracker tracker(milliseconds(1), 10);
+  // 95% fast, 5% slow: the hedge delay should sit near the fast edge
+  for (int i = 0; i < 95; i++) {
+    tracker.record(microseconds(5000));
+  }
+  for (int i = 0; i < 5; i++) {
+    tracker.record(microseconds(500000));
+  }
+  auto delay = tracker.hedgeDelay();
+  EXPECT_GE(delay, milliseconds(5));
+  EXPECT_LT(delay, milliseconds(500));
+}
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/HTTPMessage.h>
+#include <proxygen/lib/http/RFC9218.h>
+
+using namespace proxygen;
+
+TEST(RFC9218Test, ParseUrgencyAndIncremental) {
+  auto priority = RFC9218::parsePriority("u=3, i");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, 3);
+  EXPECT_TRUE(priority->incremental);
+
+  priority = RFC9218::parsePriority("u=0");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, 0);
+  EXPECT_FALSE(priority->incremental);
+
+  priority = RFC9218::parsePriority("i");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, RFC9218::kDefaultUrgency);
+  EXPECT_TRUE(priority->incremental);
+
+  priority = RFC9218::parsePriority("i=?0, u=7");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, 7);
+  EXPECT_FALSE(priority->incremental);
+}
+
+TEST(RFC9218Test, ParseClampsAndIgnoresUnknown) {
+  // out-of-range urgencies clamp to the valid range
+  auto priority = RFC9218::parsePriority("u=200");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, RFC9218::kMaxUrgency);
+
+  priority = RFC9218::parsePriority("u=-5");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, RFC9218::kMinUrgency);
+
+  // unknown dictionary members are ignored
+  priority = RFC9218::parsePriority("foo=bar, u=2");
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, 2);
+
+  // nothing recognizable
+  EXPECT_FALSE(RFC9218::parsePriority("foo=bar").hasValue());
+  EXPECT_FALSE(RFC9218::parsePriority("").hasValue());
+  EXPECT_FALSE(RFC9218::parsePriority("u=junk").hasValue());
+}
+
+TEST(RFC9218Test, GetPriorityFromMessage) {
+  HTTPMessage msg;
+  EXPECT_FALSE(RFC9218::getPriority(msg).hasValue());
+  msg.getHeaders().add("priority", "u=1, i");
+  auto priority = RFC9218::getPriority(msg);
+  ASSERT_TRUE(priority.hasValue());
+  EXPECT_EQ(priority->urgency, 1);
+  EXPECT_TRUE(priority->incremental);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/http/RequestPipeline.h>
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/HTTPMessage.h>
+
+using namespace proxygen;
+
+namespace {
+
+HTTPMessage makeRequest(const std::string& url,
+                        const std::string& host = "API.Example.com:8080") {
+  HTTPMessage msg;
+  msg.setMethod(HTTPMethod::GET);
+  msg.setURL(url);
+  msg.getHeaders().set(HTTP_HEADER_HOST, host);
+  return msg;
+}
+
+} // namespace
+
+TEST(RequestPipelineTest, NormalizeAndPrefixKey) {
+  RequestPipeline::Config config;
+  config.source = RequestPipeline::RouteKeySource::PathPrefix;
+  config.pathPrefixSegments = 1;
+  RequestPipeline pipeline(config);
+
+  struct Case {
+    std::string url;
+    std::string normalized;
+    std::string key;
+  };
+  std::vector<Case> cases = {
+      {"/api/v2/lookup", "/api/v2/lookup", "/api"},
+      {"/api/./v2/../lookup?q=1", "/api/lookup?q=1", "/api"},
+      {"/a//b", "/a/b", "/a"},
+      {"/..", "/", "/"},
+      {"/api/../admin/panel", "/admin/panel", "/admin"},
+      {"/", "/", "/"},
+  };
+  for (const auto& testCase : cases) {
+    auto msg = makeRequest(testCase.url);
+    ASSERT_TRUE(pipeline.process(msg)) << testCase.url;
+    const auto* descriptor = msg.getRoutingDescriptor();
+    ASSERT_NE(descriptor, nullptr);
+    EXPECT_TRUE(descriptor->valid);
+    EXPECT_EQ(descriptor->normalizedPath, testCase.normalized)
+        << testCase.url;
+    EXPECT_EQ(descriptor->routeKey, testCase.key) << testCase.url;
+    EXPECT_EQ(descriptor->host, "api.example.com");
+  }
+}
+
+TEST(RequestPipelineTest, HostAndHeaderKeys) {
+  RequestPipeline::Config config;
+  config.source = RequestPipeline::RouteKeySource::Host;
+  RequestPipeline hostPipeline(config);
+  auto msg = makeRequest("/x");
+  ASSERT_TRUE(hostPipeline.process(msg));
+  EXPECT_EQ(msg.getRoutingDescriptor()->routeKey, "api.example.com");
+
+  config.source = RequestPipeline::RouteKeySource::Header;
+  config.headerName = "x-tenant";
+  RequestPipeline headerPipeline(config);
+  auto msg2 = makeRequest("/x");
+  msg2.getHeaders().set("x-tenant", "blue");
+  ASSERT_TRUE(headerPipeline.process(msg2));
+  EXPECT_EQ(msg2.getRoutingDescriptor()->routeKey, "blue");
+}
+
+TEST(RequestPipelineTest, InvalidBytesRejected) {
+  RequestPipeline pipeline(RequestPipeline::Config{});
+  auto msg = makeRequest(std::string("/bad\x01path", 10));
+  EXPECT_FALSE(pipeline.process(msg));
+  const auto* descriptor = msg.getRoutingDescriptor();
+  ASSERT_NE(descriptor, nullptr);
+  EXPECT_FALSE(descriptor->valid);
+  EXPECT_NE(descriptor->invalidReason, nullptr);
+}
+
+TEST(RequestPipelineTest, DescriptorSurvivesCopies) {
+  RequestPipeline pipeline(RequestPipeline::Config{});
+  auto msg = makeRequest("/api/x");
+  ASSERT_TRUE(pipeline.process(msg));
+  HTTPMessage copy(msg);
+  ASSERT_NE(copy.getRoutingDescriptor(), nullptr);
+  EXPECT_EQ(copy.getRoutingDescriptor()->normalizedPath, "/api/x");
+  HTTPMessage moved(std::move(copy));
+  ASSERT_NE(moved.getRoutingDescriptor(), nullptr);
+  EXPECT_EQ(moved.getRoutingDescriptor()->routeKey, "/api");
+}
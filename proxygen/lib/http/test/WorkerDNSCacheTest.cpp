@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/http/ResolvingHTTPConnector.h>
+
+using namespace proxygen;
+
+TEST(WorkerDNSCacheTest, ResolveAndCacheHit) {
+  folly::EventBase evb;
+  auto cache = WorkerDNSCache::create(&evb);
+
+  folly::Optional<folly::SocketAddress> first;
+  cache->resolve("localhost", 8080, [&](auto address, const std::string&) {
+    first = address;
+    evb.terminateLoopSoon();
+  });
+  evb.loopForever();
+  ASSERT_TRUE(first.hasValue());
+  EXPECT_EQ(first->getPort(), 8080);
+  EXPECT_EQ(cache->numEntries(), 1);
+
+  // hot entry: the answer arrives synchronously, before any loop turn
+  bool sync = false;
+  cache->resolve("localhost", 9090, [&](auto address, const std::string&) {
+    ASSERT_TRUE(address.hasValue());
+    EXPECT_EQ(address->getPort(), 9090);
+    sync = true;
+  });
+  EXPECT_TRUE(sync);
+}
+
+TEST(WorkerDNSCacheTest, NegativeCaching) {
+  folly::EventBase evb;
+  auto cache = WorkerDNSCache::create(&evb);
+
+  std::string firstError;
+  cache->resolve("invalid.domain.that.does.not.exist.example",
+                 80,
+                 [&](auto address, const std::string& error) {
+                   EXPECT_FALSE(address.hasValue());
+                   firstError = error;
+                   evb.terminateLoopSoon();
+                 });
+  evb.loopForever();
+  EXPECT_FALSE(firstError.empty());
+
+  // the failure is cached: the second lookup answers synchronously
+  bool sync = false;
+  cache->resolve("invalid.domain.that.does.not.exist.example",
+                 80,
+                 [&](auto address, const std::string& error) {
+                   EXPECT_FALSE(address.hasValue());
+                   EXPECT_FALSE(error.empty());
+                   sync = true;
+                 });
+  EXPECT_TRUE(sync);
+}
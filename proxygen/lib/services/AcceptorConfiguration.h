@@ -74,6 +74,30 @@ struct AcceptorConfiguration : public wangle::ServerSocketConfig {
    */
   uint32_t maxConcurrentIncomingStreams{0};
 
+  /**
+   * How many connections to drain per accept wakeup on this acceptor's
+   * listen sockets; 0 keeps folly's default.
+   */
+  uint32_t maxAcceptsPerWakeup{0};
+
+  /**
+   * How often to sample the listen socket's accept-queue depth via
+   * TCP_INFO; 0 disables sampling.
+   */
+  std::chrono::milliseconds listenBacklogSampleInterval{0};
+
+  /**
+   * Accept budget to apply while the sampled backlog is deep; 0
+   * disables burst mode (sampling stays telemetry-only).
+   */
+  uint32_t burstAcceptsPerWakeup{0};
+
+  /**
+   * When non-empty, session stats for this acceptor are recorded under
+   * this prefix, isolating each VIP's counters.
+   */
+  std::string statsNamespace;
+
   /**
    * Flow control parameters.
    *
@@ -11,6 +11,7 @@
 #include <folly/io/async/AsyncServerSocket.h>
 #include <memory>
 #include <proxygen/lib/services/AcceptorConfiguration.h>
+#include <proxygen/lib/services/ListenBacklogSampler.h>
 #include <proxygen/lib/utils/AsyncTimeoutSet.h>
 #include <proxygen/lib/utils/WheelTimerInstance.h>
 #include <wangle/acceptor/Acceptor.h>
@@ -43,6 +44,24 @@ class HTTPAcceptor : public wangle::Acceptor {
     timer_ = std::make_unique<WheelTimerInstance>(
         accConfig_.transactionIdleTimeout, eventBase);
     Acceptor::init(serverSocket, eventBase);
+    if (serverSocket &&
+        accConfig_.listenBacklogSampleInterval.count() > 0) {
+      ListenBacklogSampler::Options samplerOptions;
+      samplerOptions.sampleInterval = accConfig_.listenBacklogSampleInterval;
+      samplerOptions.burstAcceptsPerWakeup = accConfig_.burstAcceptsPerWakeup;
+      samplerOptions.normalAcceptsPerWakeup = accConfig_.maxAcceptsPerWakeup;
+      backlogSampler_ =
+          std::make_unique<ListenBacklogSampler>(serverSocket, samplerOptions);
+      backlogSampler_->start(eventBase);
+    }
+  }
+
+  void acceptStopped() noexcept override {
+    // the listen socket is going away; stop touching it
+    if (backlogSampler_) {
+      backlogSampler_->stop();
+    }
+    Acceptor::acceptStopped();
   }
 
   const AcceptorConfiguration& getConfig() const {
@@ -52,12 +71,21 @@ class HTTPAcceptor : public wangle::Acceptor {
     return Acceptor::getConfig();
   }
 
+  /**
+   * Accept-backlog telemetry for this acceptor's listen socket, when
+   * listenBacklogSampleInterval is configured; nullptr otherwise.
+   */
+  const ListenBacklogSampler* getListenBacklogSampler() const {
+    return backlogSampler_.get();
+  }
+
  protected:
   AcceptorConfiguration accConfig_;
 
  private:
   AsyncTimeoutSet::UniquePtr tcpEventsTimeouts_;
   std::unique_ptr<WheelTimerInstance> timer_;
+  std::unique_ptr<ListenBacklogSampler> backlogSampler_;
 };
 
 } // namespace proxygen
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/services/ListenBacklogSampler.h>
+
+#include <folly/Synchronized.h>
+#include <fstream>
+#include <glog/logging.h>
+#include <sstream>
+#include <unordered_set>
+
+#if defined(__linux__)
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#endif
+
+namespace {
+
+// Every running sampler, so getProcessStats() can aggregate without
+// the samplers knowing about each other.  Samplers register in start()
+// and unregister in stop(); the stats reads under the lock are plain
+// atomic loads.
+folly::Synchronized<std::unordered_set<proxygen::ListenBacklogSampler*>>&
+getRegistry() {
+  static folly::Synchronized<
+      std::unordered_set<proxygen::ListenBacklogSampler*>>
+      registry;
+  return registry;
+}
+
+// System-wide TcpExt ListenOverflows from /proc/net/netstat: the
+// kernel's count of connections dropped because an accept queue was
+// full.  Monotonic and host-wide, but it is the ground truth that an
+// overflow actually happened.
+uint64_t readListenOverflows() {
+#if defined(__linux__)
+  std::ifstream netstat("/proc/net/netstat");
+  std::string headerLine;
+  std::string valueLine;
+  while (std::getline(netstat, headerLine) &&
+         std::getline(netstat, valueLine)) {
+    if (headerLine.compare(0, 7, "TcpExt:") != 0) {
+      continue;
+    }
+    std::istringstream headers(headerLine);
+    std::istringstream values(valueLine);
+    std::string name;
+    uint64_t value = 0;
+    while (headers >> name && values >> value) {
+      if (name == "ListenOverflows") {
+        return value;
+      }
+    }
+    break;
+  }
+#endif
+  return 0;
+}
+
+} // namespace
+
+namespace proxygen {
+
+ListenBacklogSampler::ListenBacklogSampler(folly::AsyncServerSocket* socket,
+                                           Options options)
+    : socket_(socket), options_(options) {
+  CHECK(socket_);
+}
+
+ListenBacklogSampler::~ListenBacklogSampler() {
+  stop();
+}
+
+void ListenBacklogSampler::start(folly::EventBase* eventBase) {
+  if (running_) {
+    return;
+  }
+  {
+    auto registry = getRegistry().wlock();
+    for (auto existing : *registry) {
+      if (existing->socket_ == socket_) {
+        // Outside SO_REUSEPORT sharding every worker's acceptor shares
+        // one listen socket; one sampler per socket keeps the
+        // telemetry single-counted and the budget writes unracing.
+        return;
+      }
+    }
+    registry->insert(this);
+  }
+  running_ = true;
+  attachEventBase(eventBase);
+  sampleNow();
+  scheduleTimeout(options_.sampleInterval);
+}
+
+void ListenBacklogSampler::stop() {
+  if (!running_) {
+    return;
+  }
+  cancelTimeout();
+  getRegistry().wlock()->erase(this);
+  running_ = false;
+}
+
+void ListenBacklogSampler::timeoutExpired() noexcept {
+  sampleNow();
+  scheduleTimeout(options_.sampleInterval);
+}
+
+void ListenBacklogSampler::sampleNow() {
+  uint32_t depth = 0;
+  uint32_t limit = 0;
+#if defined(__linux__)
+  // On a listening socket Linux repurposes tcp_info: tcpi_unacked is
+  // the current accept-queue occupancy and tcpi_sacked the backlog
+  // limit.  A socket may carry several fds (v4 + v6); report the
+  // deepest.
+  for (auto networkSocket : socket_->getNetworkSockets()) {
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(networkSocket.toFd(),
+                   IPPROTO_TCP,
+                   TCP_INFO,
+                   &info,
+                   &len) != 0) {
+      continue;
+    }
+    if (info.tcpi_unacked >= depth) {
+      depth = info.tcpi_unacked;
+      limit = info.tcpi_sacked;
+    }
+  }
+#endif
+  backlogDepth_.store(depth, std::memory_order_relaxed);
+  backlogLimit_.store(limit, std::memory_order_relaxed);
+
+  if (options_.burstAcceptsPerWakeup == 0 || limit == 0) {
+    return;
+  }
+  double ratio = double(depth) / double(limit);
+  bool bursting = bursting_.load(std::memory_order_relaxed);
+  if (!bursting && ratio >= options_.burstThresholdRatio) {
+    // Drain storms in big per-wakeup batches until the queue recedes
+    socket_->setMaxAcceptAtOnce(options_.burstAcceptsPerWakeup);
+    bursting_.store(true, std::memory_order_relaxed);
+    VLOG(2) << "accept backlog at " << depth << "/" << limit
+            << ", raising accept budget to "
+            << options_.burstAcceptsPerWakeup;
+  } else if (bursting && ratio < options_.burstThresholdRatio / 2) {
+    socket_->setMaxAcceptAtOnce(options_.normalAcceptsPerWakeup > 0
+                                    ? options_.normalAcceptsPerWakeup
+                                    : folly::AsyncServerSocket::
+                                          kDefaultMaxAcceptAtOnce);
+    bursting_.store(false, std::memory_order_relaxed);
+  }
+}
+
+ListenBacklogSampler::ProcessStats ListenBacklogSampler::getProcessStats() {
+  ProcessStats stats;
+  {
+    auto registry = getRegistry().rlock();
+    for (auto sampler : *registry) {
+      stats.backlogDepth += sampler->getBacklogDepth();
+      stats.backlogLimit += sampler->getBacklogLimit();
+    }
+  }
+  stats.listenOverflows = readListenOverflows();
+  return stats;
+}
+
+} // namespace proxygen
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <folly/io/async/AsyncServerSocket.h>
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+
+namespace proxygen {
+
+/**
+ * Periodic accept-backlog telemetry for one listen socket, with an
+ * optional burst mode that widens the accept budget while the backlog
+ * is deep.
+ *
+ * The kernel's accept queue overflows silently: clients see SYN
+ * retransmits and tail connect latency while every worker looks idle.
+ * This sampler polls TCP_INFO on the listen socket's fds - on Linux a
+ * listening socket reports its current accept-queue occupancy in
+ * tcpi_unacked and the configured backlog limit in tcpi_sacked - and
+ * keeps the deepest fd's reading in atomics any thread may read.  It
+ * also tracks the system-wide ListenOverflows counter from
+ * /proc/net/netstat, which is the after-the-fact proof that the queue
+ * actually overflowed.
+ *
+ * When burst accepts are configured and occupancy crosses
+ * burstThresholdRatio of the limit, the sampler raises the socket's
+ * per-wakeup accept budget (AsyncServerSocket::setMaxAcceptAtOnce) so
+ * each wakeup drains a storm instead of trickling it, and restores the
+ * normal budget once occupancy falls below half the threshold.  The
+ * hysteresis keeps a backlog hovering at the threshold from toggling
+ * the budget every sample.
+ *
+ * Process-wide aggregates over every running sampler are available via
+ * getProcessStats(); a Resources implementation folds them into
+ * ResourceData::setListenBacklogStats so the backlog shows up next to
+ * CPU and memory in ResourceStats consumers.
+ *
+ * The sampler runs on the EventBase passed to start() and must be
+ * started, stopped, and destroyed on that thread; the stats getters
+ * are safe from any thread.
+ */
+class ListenBacklogSampler : private folly::AsyncTimeout {
+ public:
+  struct Options {
+    /** How often to poll TCP_INFO. */
+    std::chrono::milliseconds sampleInterval{500};
+
+    /** Occupancy/limit ratio at which burst mode engages. */
+    double burstThresholdRatio{0.25};
+
+    /**
+     * Accept budget while bursting; 0 disables burst mode and the
+     * sampler is telemetry-only.
+     */
+    uint32_t burstAcceptsPerWakeup{0};
+
+    /**
+     * Budget to restore when the burst ends; 0 restores folly's
+     * default.
+     */
+    uint32_t normalAcceptsPerWakeup{0};
+  };
+
+  ListenBacklogSampler(folly::AsyncServerSocket* socket, Options options);
+  ~ListenBacklogSampler() override;
+
+  void start(folly::EventBase* eventBase);
+  void stop();
+
+  /** Deepest accept-queue occupancy seen on the last sample. */
+  uint32_t getBacklogDepth() const {
+    return backlogDepth_.load(std::memory_order_relaxed);
+  }
+
+  /** Configured backlog limit reported by the kernel; 0 until sampled. */
+  uint32_t getBacklogLimit() const {
+    return backlogLimit_.load(std::memory_order_relaxed);
+  }
+
+  bool inBurstMode() const {
+    return bursting_.load(std::memory_order_relaxed);
+  }
+
+  struct ProcessStats {
+    /** Sum of occupancy across every running sampler's socket. */
+    uint64_t backlogDepth{0};
+    /** Sum of the corresponding backlog limits. */
+    uint64_t backlogLimit{0};
+    /**
+     * System-wide TcpExt ListenOverflows counter (monotonic, all
+     * sockets on the host, not just ours); 0 when unavailable.
+     */
+    uint64_t listenOverflows{0};
+  };
+
+  /** Aggregate over all running samplers in this process. */
+  static ProcessStats getProcessStats();
+
+  /**
+   * One TCP_INFO poll plus burst evaluation, exposed so tests can
+   * sample deterministically without waiting out the timer.
+   */
+  void sampleNow();
+
+ private:
+  void timeoutExpired() noexcept override;
+
+  folly::AsyncServerSocket* socket_;
+  const Options options_;
+  // true once this sampler won the per-socket claim in start()
+  bool running_{false};
+  std::atomic<uint32_t> backlogDepth_{0};
+  std::atomic<uint32_t> backlogLimit_{0};
+  std::atomic<bool> bursting_{false};
+};
+
+} // namespace proxygen
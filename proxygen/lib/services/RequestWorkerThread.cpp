@@ -41,6 +41,34 @@ void RequestWorkerThread::flushStats() {
   }
 }
 
+std::unique_ptr<HTTPCodec> RequestWorkerThread::obtainRecycledCodec(
+    CodecProtocol protocol, TransportDirection direction) {
+  DCHECK(getEventBase()->isInEventBaseThread());
+  auto it = recycledCodecs_.find(std::make_pair(protocol, direction));
+  if (it == recycledCodecs_.end() || it->second.empty()) {
+    return nullptr;
+  }
+  auto codec = std::move(it->second.back());
+  it->second.pop_back();
+  return codec;
+}
+
+void RequestWorkerThread::recycleCodec(std::unique_ptr<HTTPCodec> codec) {
+  DCHECK(getEventBase()->isInEventBaseThread());
+  if (!codec || !codec->isRecyclable()) {
+    return;
+  }
+  // reset first: the key must reflect the fresh state, not whatever
+  // protocol version the last connection parsed
+  codec->reset();
+  auto& pool = recycledCodecs_[std::make_pair(codec->getProtocol(),
+                                              codec->getTransportDirection())];
+  if (pool.size() >= kMaxRecycledCodecsPerKey) {
+    return;
+  }
+  pool.push_back(std::move(codec));
+}
+
 void RequestWorkerThread::setup() {
   WorkerThread::setup();
   callback_.workerStarted(this);
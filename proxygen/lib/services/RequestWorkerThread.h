@@ -10,7 +10,10 @@
 
 #include <cstdint>
 #include <map>
+#include <proxygen/lib/http/codec/HTTPCodec.h>
+#include <proxygen/lib/http/session/WorkerSessionRegistry.h>
 #include <proxygen/lib/services/WorkerThread.h>
+#include <vector>
 #include <wangle/acceptor/LoadShedConfiguration.h>
 
 namespace proxygen {
@@ -53,6 +56,34 @@ class RequestWorkerThread : public WorkerThread {
    */
   uint8_t getWorkerId() const;
 
+  /**
+   * Capture this worker's connection table to a compact binary file
+   * (see WorkerSessionRegistry) from any thread; serialization happens
+   * on the worker loop in bounded slices.
+   */
+  void requestSessionSnapshot(std::string path) {
+    auto evb = getEventBase();
+    evb->runInEventBaseThread([evb, path = std::move(path)] {
+      WorkerSessionRegistry::getThreadRegistry().snapshot(evb, path);
+    });
+  }
+
+  /**
+   * Gracefully drain this worker's sessions for deploys: GOAWAY
+   * emission is spread across loop iterations (see
+   * WorkerSessionRegistry::drainAll) so a full worker never spikes the
+   * loop, and sessions tear down through their normal quiesce paths.
+   * Callable from any thread; track progress on the worker via
+   * WorkerSessionRegistry::getDrainProgress.
+   */
+  void requestGradualDrain(size_t sessionsPerSlice = 512) {
+    auto evb = getEventBase();
+    evb->runInEventBaseThread([evb, sessionsPerSlice] {
+      WorkerSessionRegistry::getThreadRegistry().drainAll(evb,
+                                                          sessionsPerSlice);
+    });
+  }
+
   static RequestWorkerThread* getRequestWorkerThread() {
     RequestWorkerThread* self = dynamic_cast<RequestWorkerThread*>(
         WorkerThread::getCurrentWorkerThread());
@@ -100,6 +131,48 @@ class RequestWorkerThread : public WorkerThread {
    */
   void flushStats();
 
+  /**
+   * Smoothed event-loop latency for this worker, from the event base's
+   * exponentially-decaying average loop time.
+   */
+  std::chrono::microseconds getLoopLag() {
+    return std::chrono::microseconds(
+        static_cast<int64_t>(getEventBase()->getAvgLoopTime()));
+  }
+
+  /**
+   * When set (> 0), shouldShedLoad() reports true while the loop lag
+   * exceeds the threshold. Session controllers consult it to turn new
+   * requests into fast 503s before any handler work runs.
+   */
+  void setLoopLagShedThreshold(std::chrono::microseconds threshold) {
+    loopLagShedThreshold_ = threshold;
+  }
+
+  std::chrono::microseconds getLoopLagShedThreshold() const {
+    return loopLagShedThreshold_;
+  }
+
+  bool shouldShedLoad() {
+    return loopLagShedThreshold_.count() > 0 &&
+        getLoopLag() > loopLagShedThreshold_;
+  }
+
+  /**
+   * Take a previously recycled codec for the given protocol/direction,
+   * or nullptr if the pool is empty. Must be invoked from within the
+   * worker's thread.
+   */
+  std::unique_ptr<HTTPCodec> obtainRecycledCodec(CodecProtocol protocol,
+                                                 TransportDirection direction);
+
+  /**
+   * Return a codec to the pool when its connection closes. Codecs that
+   * don't support recycling (isRecyclable() == false) are destroyed.
+   * Must be invoked from within the worker's thread.
+   */
+  void recycleCodec(std::unique_ptr<HTTPCodec> codec);
+
  private:
   void setup() override;
   void cleanup() override;
@@ -111,6 +184,15 @@ class RequestWorkerThread : public WorkerThread {
   // The ServiceWorkers executing in this worker
   std::map<Service*, ServiceWorker*> serviceWorkers_;
 
+  // Loop lag above which new requests are shed; 0 disables.
+  std::chrono::microseconds loopLagShedThreshold_{0};
+
+  // Recycled codecs keyed by (protocol, direction); bounded per key.
+  static constexpr size_t kMaxRecycledCodecsPerKey = 64;
+  std::map<std::pair<CodecProtocol, TransportDirection>,
+           std::vector<std::unique_ptr<HTTPCodec>>>
+      recycledCodecs_;
+
   // Every worker instance has their own version of load shed config.
   // This enables every request worker thread, and derivative there of,
   // to both access and update this field in a thread-safe way.
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <proxygen/lib/services/AcceptorConfiguration.h>
 
 namespace proxygen {
@@ -48,10 +49,26 @@ class ServiceConfiguration {
   void setTakeoverEnabled(bool enabled) { takeoverEnabled_ = enabled; }
   bool takeoverEnabled() const { return takeoverEnabled_; }
 
+  /**
+   * Set/get the hybrid poll/interrupt spin budget for this service's
+   * workers (see WorkerThread::enableHybridPolling).  After each
+   * epoll wakeup the worker busy-polls for this long before going
+   * back to sleep, trading cores for wakeup latency while traffic is
+   * flowing and sleeping normally under sustained idleness.  Zero
+   * (the default) keeps the plain blocking loop.
+   */
+  void setHybridPollSpinBudget(std::chrono::microseconds budget) {
+    hybridPollSpinBudget_ = budget;
+  }
+  std::chrono::microseconds getHybridPollSpinBudget() const {
+    return hybridPollSpinBudget_;
+  }
+
  private:
   std::list<AcceptorConfiguration> acceptors_;
   uint64_t writeBufferLimit_;
   bool takeoverEnabled_;
+  std::chrono::microseconds hybridPollSpinBudget_{0};
 };
 
 }
@@ -12,8 +12,17 @@
 #include <folly/String.h>
 #include <folly/io/async/EventBaseManager.h>
 #include <glog/logging.h>
+#include <proxygen/lib/utils/Time.h>
 #include <signal.h>
 
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace proxygen {
 
 FOLLY_TLS WorkerThread* WorkerThread::currentWorker_ = nullptr;
@@ -33,6 +42,17 @@ WorkerThread::~WorkerThread() {
   CHECK(state_ == State::IDLE);
 }
 
+void WorkerThread::setCpuAffinity(std::vector<int> cpus) {
+  CHECK(state_ == State::IDLE) << "Set affinity before start()";
+  cpuAffinity_ = std::move(cpus);
+}
+
+void WorkerThread::setNumaNode(int node) {
+  CHECK(state_ == State::IDLE) << "Set NUMA node before start()";
+  CHECK_LT(node, 64) << "Single-word node mask";
+  numaNode_ = node;
+}
+
 void WorkerThread::start() {
   CHECK(state_ == State::IDLE);
   state_ = State::STARTING;
@@ -95,6 +115,32 @@ void WorkerThread::wait() {
 }
 
 void WorkerThread::setup() {
+#ifdef __linux__
+  // Apply placement first: the affinity and memory policy must be in
+  // force before the loop allocates, so first-touch lands the worker's
+  // session and buffer memory on its own node.
+  if (!cpuAffinity_.empty()) {
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (auto cpu : cpuAffinity_) {
+      CPU_SET(cpu, &cpuSet);
+    }
+    auto rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+    if (rc != 0) {
+      LOG(ERROR) << "Failed to set worker CPU affinity: " << folly::errnoStr(rc);
+    }
+  }
+  if (numaNode_ >= 0) {
+    // mempolicy is per-thread; glibc has no wrapper, so use the raw
+    // syscall.  The mask length is in bits.
+    unsigned long nodeMask = 1UL << numaNode_;
+    auto rc = syscall(
+        SYS_set_mempolicy, MPOL_BIND, &nodeMask, sizeof(nodeMask) * 8);
+    if (rc != 0) {
+      PLOG(ERROR) << "Failed to bind worker memory to node " << numaNode_;
+    }
+  }
+#endif
 #ifndef _MSC_VER
   sigset_t ss;
 
@@ -130,16 +176,47 @@ void WorkerThread::cleanup() {
   }
 }
 
+void WorkerThread::CachedNowRefresher::runLoopCallback() noexcept {
+  refreshCachedNow();
+  // before-loop callbacks are one-shot; re-arm for the next iteration
+  evb_->runBeforeLoop(this);
+}
+
 void WorkerThread::runLoop() {
   // Update state_
   CHECK(state_ == State::STARTING);
   state_ = State::RUNNING;
 
+  if (cachedNowEnabled_) {
+    refreshCachedNow();
+    eventBase_.runBeforeLoop(&cachedNowRefresher_);
+  }
+
   VLOG(1) << "WorkerThread " << this << " starting";
 
-  // Call loopForever().  This will only return after stopWhenIdle() or
-  // forceStop() has been called.
-  eventBase_.loopForever();
+  if (hybridPollSpinBudget_.count() > 0) {
+    // Hybrid poll/interrupt: one blocking iteration (the epoll sleep),
+    // then busy-poll with non-blocking iterations for the spin budget
+    // before sleeping again.  While traffic flows, events are picked
+    // up inside the spin window at poll latency; a full budget of
+    // idleness drops the worker back into the blocking wait.  The
+    // stop paths run terminateLoopSoon() through the notification
+    // queue, which both loop flavors process, so state_ transitions
+    // are observed either way.
+    while (state_ == State::RUNNING) {
+      eventBase_.loopOnce();
+      auto spinDeadline =
+          std::chrono::steady_clock::now() + hybridPollSpinBudget_;
+      while (state_ == State::RUNNING &&
+             std::chrono::steady_clock::now() < spinDeadline) {
+        eventBase_.loopOnce(EVLOOP_NONBLOCK);
+      }
+    }
+  } else {
+    // Call loopForever().  This will only return after stopWhenIdle() or
+    // forceStop() has been called.
+    eventBase_.loopForever();
+  }
 
   if (state_ == State::STOP_WHEN_IDLE) {
     // We have been asked to stop when there are no more events left.
@@ -9,11 +9,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <folly/Portability.h>
 #include <folly/io/async/EventBase.h>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 namespace folly {
 class EventBaseManager;
@@ -38,6 +40,45 @@ class WorkerThread {
    */
   void start();
 
+  /**
+   * Restrict the worker thread to the given set of CPUs.  Must be
+   * called before start(); the affinity is applied inside the worker
+   * thread before the event loop allocates anything, so first-touch
+   * places the worker's memory on the local node.  No-op on platforms
+   * without thread affinity support.
+   */
+  void setCpuAffinity(std::vector<int> cpus);
+
+  /**
+   * Bind the worker thread's page allocations to the given NUMA node
+   * (Linux only; nodes 0-63).  Must be called before start().  Pass -1
+   * (the default) to leave the system policy in place.
+   */
+  void setNumaNode(int node);
+
+  /**
+   * Refresh the loop-cached clock (see getCachedNow in utils/Time.h)
+   * at the top of every loop iteration of this worker.  Must be called
+   * before start().
+   */
+  /**
+   * Hybrid poll/interrupt loop: after every blocking wakeup the loop
+   * busy-polls (non-blocking event-base iterations) for spinBudget
+   * before sleeping in epoll again.  While events keep arriving the
+   * worker therefore serves them at poll latency - no epoll wakeup on
+   * the path - and a worker that stays idle for one full budget falls
+   * back to the normal blocking loop, so cores are only burned while
+   * recent activity suggests more is coming.  Call before start();
+   * zero disables (the default blocking loop).
+   */
+  void enableHybridPolling(std::chrono::microseconds spinBudget) {
+    hybridPollSpinBudget_ = spinBudget;
+  }
+
+  void enableCachedNow() {
+    cachedNowEnabled_ = true;
+  }
+
   /**
    * Request that the worker thread stop when there are no more events to
    * process.
@@ -138,6 +179,22 @@ class WorkerThread {
   std::thread thread_;
   std::mutex joinLock_;
   folly::EventBaseManager* eventBaseManager_{nullptr};
+  std::vector<int> cpuAffinity_;
+  int numaNode_{-1};
+  bool cachedNowEnabled_{false};
+  std::chrono::microseconds hybridPollSpinBudget_{0};
+
+  class CachedNowRefresher : public folly::EventBase::LoopCallback {
+   public:
+    explicit CachedNowRefresher(folly::EventBase* evb) : evb_(evb) {
+    }
+
+    void runLoopCallback() noexcept override;
+
+   private:
+    folly::EventBase* evb_;
+  };
+  CachedNowRefresher cachedNowRefresher_{&eventBase_};
 
   // A thread-local pointer to the current WorkerThread for this thread
   static FOLLY_TLS WorkerThread* currentWorker_;
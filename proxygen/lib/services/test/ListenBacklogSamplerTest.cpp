@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/services/ListenBacklogSampler.h>
+
+#include <folly/io/async/EventBase.h>
+#include <folly/portability/GTest.h>
+#include <folly/portability/Sockets.h>
+#include <glog/logging.h>
+#include <vector>
+
+using namespace folly;
+using namespace proxygen;
+
+namespace {
+
+// Connects a plain blocking TCP socket; on loopback the connect
+// completes as soon as the connection lands in the accept queue, so
+// never accepting on the server side leaves it queued.
+int connectClient(const SocketAddress& address) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  CHECK_GE(fd, 0);
+  sockaddr_storage storage;
+  auto len = address.getAddress(&storage);
+  CHECK_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&storage), len), 0);
+  return fd;
+}
+
+} // namespace
+
+TEST(ListenBacklogSamplerTest, DepthAndBurst) {
+#if defined(__linux__)
+  EventBase base;
+  auto socket = AsyncServerSocket::newSocket(&base);
+  socket->bind(SocketAddress("127.0.0.1", 0));
+  socket->listen(8);
+
+  SocketAddress address;
+  socket->getAddress(&address);
+
+  ListenBacklogSampler::Options options;
+  options.burstThresholdRatio = 0.25;
+  options.burstAcceptsPerWakeup = 128;
+  ListenBacklogSampler sampler(socket.get(), options);
+  sampler.start(&base);
+
+  sampler.sampleNow();
+  EXPECT_EQ(sampler.getBacklogDepth(), 0);
+  EXPECT_GT(sampler.getBacklogLimit(), 0);
+  EXPECT_FALSE(sampler.inBurstMode());
+
+  // Fill the queue past the burst threshold without accepting
+  std::vector<int> clients;
+  for (int i = 0; i < 4; i++) {
+    clients.push_back(connectClient(address));
+  }
+  sampler.sampleNow();
+  EXPECT_GE(sampler.getBacklogDepth(), 4);
+  EXPECT_TRUE(sampler.inBurstMode());
+
+  auto processStats = ListenBacklogSampler::getProcessStats();
+  EXPECT_GE(processStats.backlogDepth, 4);
+  EXPECT_GT(processStats.backlogLimit, 0);
+
+  // Drain the queue; the burst ends with hysteresis once occupancy
+  // falls below half the threshold
+  int listenFd = socket->getNetworkSockets()[0].toFd();
+  for (size_t i = 0; i < clients.size(); i++) {
+    int accepted = ::accept(listenFd, nullptr, nullptr);
+    ASSERT_GE(accepted, 0);
+    ::close(accepted);
+  }
+  sampler.sampleNow();
+  EXPECT_EQ(sampler.getBacklogDepth(), 0);
+  EXPECT_FALSE(sampler.inBurstMode());
+
+  for (int fd : clients) {
+    ::close(fd);
+  }
+  sampler.stop();
+#endif
+}
+
+TEST(ListenBacklogSamplerTest, OneSamplerPerSocket) {
+#if defined(__linux__)
+  EventBase base;
+  auto socket = AsyncServerSocket::newSocket(&base);
+  socket->bind(SocketAddress("127.0.0.1", 0));
+  socket->listen(8);
+
+  ListenBacklogSampler first(socket.get(), ListenBacklogSampler::Options());
+  ListenBacklogSampler second(socket.get(), ListenBacklogSampler::Options());
+  first.start(&base);
+  // loses the per-socket claim: workers outside SO_REUSEPORT sharding
+  // share one listen socket and must not double-count it
+  second.start(&base);
+
+  SocketAddress address;
+  socket->getAddress(&address);
+  int client = connectClient(address);
+  first.sampleNow();
+  second.sampleNow();
+
+  auto processStats = ListenBacklogSampler::getProcessStats();
+  EXPECT_EQ(processStats.backlogDepth, first.getBacklogDepth());
+
+  ::close(client);
+  second.stop();
+  first.stop();
+#endif
+}
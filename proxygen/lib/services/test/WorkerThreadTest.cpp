@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/services/WorkerThread.h>
+
+#include <folly/io/async/EventBaseManager.h>
+#include <folly/portability/GTest.h>
+#include <folly/synchronization/Baton.h>
+
+using namespace proxygen;
+
+TEST(WorkerThreadTest, HybridPollingServesWorkAndStops) {
+  folly::EventBaseManager ebm;
+  WorkerThread worker(&ebm);
+  worker.enableHybridPolling(std::chrono::microseconds(200));
+  worker.start();
+
+  // work posted before, during and after spin windows all runs
+  for (int i = 0; i < 3; i++) {
+    folly::Baton<> ran;
+    worker.getEventBase()->runInEventBaseThread([&ran] { ran.post(); });
+    ASSERT_TRUE(ran.try_wait_for(std::chrono::seconds(5)));
+    /* sleep past the spin budget so the next post wakes a blocked loop */
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  // both stop paths terminate the hybrid loop
+  worker.stopWhenIdle();
+  worker.wait();
+}
+
+TEST(WorkerThreadTest, HybridPollingForceStop) {
+  folly::EventBaseManager ebm;
+  WorkerThread worker(&ebm);
+  worker.enableHybridPolling(std::chrono::microseconds(200));
+  worker.start();
+
+  folly::Baton<> ran;
+  worker.getEventBase()->runInEventBaseThread([&ran] { ran.post(); });
+  ASSERT_TRUE(ran.try_wait_for(std::chrono::seconds(5)));
+
+  worker.forceStop();
+  worker.wait();
+}
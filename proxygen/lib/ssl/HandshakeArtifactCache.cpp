@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/ssl/HandshakeArtifactCache.h>
+
+namespace proxygen {
+
+std::shared_ptr<const HandshakeArtifactCache::Artifacts>
+HandshakeArtifactCache::get(const std::string& certId) noexcept {
+  auto& slot = *slot_;
+  auto generation = generation_.load(std::memory_order_acquire);
+  bool zeroAlloc = slot.generation == generation && slot.certId == certId;
+  if (!zeroAlloc) {
+    auto entries = entries_.rlock();
+    auto it = entries->find(certId);
+    if (it == entries->end()) {
+      // leave the slot usable for whatever certificate it last held
+      if (stats_) {
+        stats_->recordHandshakeArtifactLookup(false);
+      }
+      return nullptr;
+    }
+    slot.generation = generation;
+    slot.certId = certId;
+    slot.artifacts = it->second;
+  }
+  if (stats_) {
+    stats_->recordHandshakeArtifactLookup(zeroAlloc);
+    if (slot.artifacts->ocspStaple) {
+      auto age = std::chrono::duration_cast<std::chrono::seconds>(
+          std::chrono::system_clock::now() - slot.artifacts->stapleProducedAt);
+      stats_->recordOcspStapleAge(
+          age.count() > 0 ? uint64_t(age.count()) : 0);
+    }
+  }
+  return slot.artifacts;
+}
+
+void HandshakeArtifactCache::update(const std::string& certId,
+                                    Artifacts artifacts) {
+  auto published =
+      std::make_shared<const Artifacts>(std::move(artifacts));
+  {
+    auto entries = entries_.wlock();
+    (*entries)[certId] = std::move(published);
+  }
+  // invalidate every thread's slot; in-flight holders keep their
+  // generation alive through the shared_ptr they already took
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+void HandshakeArtifactCache::remove(const std::string& certId) {
+  {
+    auto entries = entries_.wlock();
+    entries->erase(certId);
+  }
+  generation_.fetch_add(1, std::memory_order_release);
+}
+
+} // namespace proxygen
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
+#include <folly/io/IOBuf.h>
+#include <memory>
+#include <proxygen/lib/ssl/ThreadLocalSSLStats.h>
+#include <string>
+#include <unordered_map>
+
+namespace proxygen {
+
+/**
+ * Acceptor-level cache of per-certificate handshake artifacts: the
+ * OCSP staple and the wire-format certificate chain, published as
+ * refcounted immutable blobs shared by every handshake that serves
+ * that certificate.
+ *
+ * The accept path used to copy these bytes out of per-context buffers
+ * on each handshake.  Here a handshake calls get(), which on the hot
+ * path (same certificate as this thread's previous handshake and no
+ * intervening refresh) costs one generation check and a shared_ptr
+ * refcount bump - no locks and no heap allocations in proxygen-owned
+ * code.  A certificate change or refresh falls back to the shared
+ * map under a read lock and re-primes the thread's slot.
+ *
+ * Refreshes are out-of-band: an OCSP fetcher or cert rotation calls
+ * update() with a fresh Artifacts blob; in-flight handshakes keep the
+ * generation they already hold alive through their shared_ptr, and
+ * later lookups see the replacement (RCU, same shape as
+ * HotCredentialStore).
+ *
+ * When stats are attached, every lookup reports the served staple's
+ * age and whether the lookup was allocation-free, so stale staples
+ * and cache-defeating certificate mixes both show up in the ssl
+ * stats layer.
+ */
+class HandshakeArtifactCache {
+ public:
+  struct Artifacts {
+    /** DER-encoded OCSP response; may be null when stapling is off. */
+    std::unique_ptr<folly::IOBuf> ocspStaple;
+    /** Wire-format certificate chain bytes. */
+    std::unique_ptr<folly::IOBuf> certChain;
+    /** When the staple was produced, for age reporting. */
+    std::chrono::system_clock::time_point stapleProducedAt;
+  };
+
+  explicit HandshakeArtifactCache(ProxygenSSLStats* stats = nullptr)
+      : stats_(stats) {
+  }
+
+  /**
+   * Artifacts for a certificate (keyed however the acceptor names
+   * them - SNI or fingerprint); nullptr when unknown.  Safe from any
+   * thread; allocation-free when this thread served the same
+   * certificate since the last update().
+   */
+  std::shared_ptr<const Artifacts> get(const std::string& certId) noexcept;
+
+  /** Publish a fresh blob for a certificate.  Safe from any thread. */
+  void update(const std::string& certId, Artifacts artifacts);
+
+  /** Drop a certificate's artifacts (rotation removed it). */
+  void remove(const std::string& certId);
+
+  size_t size() const {
+    return entries_.rlock()->size();
+  }
+
+ private:
+  struct ThreadSlot {
+    uint64_t generation{0};
+    std::string certId;
+    std::shared_ptr<const Artifacts> artifacts;
+  };
+
+  using Map =
+      std::unordered_map<std::string, std::shared_ptr<const Artifacts>>;
+
+  ProxygenSSLStats* stats_;
+  folly::Synchronized<Map> entries_;
+  // bumped by update()/remove(); invalidates every thread's slot
+  std::atomic<uint64_t> generation_{1};
+  folly::ThreadLocal<ThreadSlot> slot_;
+};
+
+} // namespace proxygen
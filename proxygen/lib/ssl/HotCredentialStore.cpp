@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/ssl/HotCredentialStore.h>
+
+#include <glog/logging.h>
+
+namespace proxygen {
+
+std::shared_ptr<const HotCredentialStore::Generation>
+HotCredentialStore::currentGeneration() const {
+  return *generation_.rlock();
+}
+
+void HotCredentialStore::update(std::vector<Credential> credentials) {
+  // exclusive across concurrent updates so neither generation is lost;
+  // cheap, since no contexts are built here.  Readers keep taking the
+  // previous generation until the swap at the end.
+  auto locked = generation_.wlock();
+  auto& previous = *locked;
+  auto next = std::make_shared<Generation>();
+  next->reserve(credentials.size());
+  for (auto& credential : credentials) {
+    auto existing = previous->find(credential.sni);
+    if (existing != previous->end() &&
+        existing->second->credential.versionTag == credential.versionTag) {
+      // unchanged: the entry (and any built context) carries over
+      next->emplace(credential.sni, existing->second);
+      continue;
+    }
+    auto entry = std::make_shared<Entry>();
+    entry->credential = std::move(credential);
+    next->emplace(entry->credential.sni, std::move(entry));
+  }
+  // RCU swap: in-flight lookups keep the old generation alive
+  *locked = std::move(next);
+}
+
+std::shared_ptr<folly::SSLContext> HotCredentialStore::buildContext(
+    const Credential& credential) {
+  try {
+    auto context = std::make_shared<folly::SSLContext>();
+    context->loadCertificate(credential.certPath.c_str());
+    context->loadPrivateKey(credential.keyPath.c_str());
+    return context;
+  } catch (const std::exception& ex) {
+    LOG(ERROR) << "Failed building SSL context for " << credential.sni << ": "
+               << ex.what();
+    return nullptr;
+  }
+}
+
+std::shared_ptr<folly::SSLContext> HotCredentialStore::getContext(
+    const std::string& sni) {
+  auto generation = currentGeneration();
+  auto it = generation->find(sni);
+  if (it == generation->end()) {
+    return nullptr;
+  }
+  auto& entry = *it->second;
+  {
+    auto built = entry.context.rlock();
+    if (*built) {
+      return *built;
+    }
+  }
+  // first use: build outside any lock; a concurrent double build is
+  // benign and the first stored wins
+  auto context = buildContext(entry.credential);
+  if (!context) {
+    return nullptr;
+  }
+  auto built = entry.context.wlock();
+  if (!*built) {
+    *built = std::move(context);
+  }
+  return *built;
+}
+
+void HotCredentialStore::prebuild(std::vector<std::string> snis,
+                                  folly::Executor* executor) {
+  auto generation = currentGeneration();
+  for (auto& sni : snis) {
+    auto it = generation->find(sni);
+    if (it == generation->end()) {
+      continue;
+    }
+    std::shared_ptr<Entry> entry = it->second;
+    executor->add([entry] {
+      if (*entry->context.rlock()) {
+        return; // already built
+      }
+      auto context = buildContext(entry->credential);
+      if (context) {
+        auto built = entry->context.wlock();
+        if (!*built) {
+          *built = std::move(context);
+        }
+      }
+    });
+  }
+}
+
+size_t HotCredentialStore::numCredentials() const {
+  return currentGeneration()->size();
+}
+
+} // namespace proxygen
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/Synchronized.h>
+#include <folly/io/async/SSLContext.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Hot-reloadable TLS credential store for SNI-heavy acceptors.
+ *
+ * The store maps exact SNI names to credentials; SSL contexts are
+ * built lazily on the first lookup of each name, so loading (or
+ * rotating) thousands of certificates costs one map build, not
+ * thousands of synchronous OpenSSL context constructions.  update()
+ * swaps the whole generation RCU-style - lookups in flight keep the
+ * old generation alive through shared_ptr, no locks on the read path
+ * beyond one atomic load plus a per-entry context handoff - and
+ * entries whose versionTag is unchanged carry their already-built
+ * context across the swap, so rotation rebuilds only what actually
+ * changed, lazily.  prebuild() warms selected names (the top-N by
+ * traffic) on a background executor so even their first post-rotation
+ * hit is ready.
+ *
+ * Lookup misses return nullptr; the caller falls back to its default
+ * context.  Wire into the acceptor's SNI callback or a
+ * ThreadLocalSSLContext implementation.
+ */
+class HotCredentialStore {
+ public:
+  struct Credential {
+    std::string sni;      // exact-match name
+    std::string certPath;
+    std::string keyPath;
+    // changes whenever the underlying files change; unchanged tags
+    // keep their built context across update()
+    std::string versionTag;
+  };
+
+  /**
+   * Install a new generation of credentials.  Cheap: no contexts are
+   * built here.  Safe to call from any thread.
+   */
+  void update(std::vector<Credential> credentials);
+
+  /**
+   * Context for an SNI name, building it on first use; nullptr when
+   * the name is unknown or the build fails (callers use their default
+   * context).  Safe from any thread.
+   */
+  std::shared_ptr<folly::SSLContext> getContext(const std::string& sni);
+
+  /**
+   * Build the given names' contexts on the executor so their first
+   * lookup is already warm.  Names unknown to the current generation
+   * are skipped.
+   */
+  void prebuild(std::vector<std::string> snis, folly::Executor* executor);
+
+  size_t numCredentials() const;
+
+ private:
+  struct Entry {
+    Credential credential;
+    // built lazily; shared across generations while the tag matches
+    folly::Synchronized<std::shared_ptr<folly::SSLContext>> context;
+  };
+  using Generation =
+      std::unordered_map<std::string, std::shared_ptr<Entry>>;
+
+  static std::shared_ptr<folly::SSLContext> buildContext(
+      const Credential& credential);
+  std::shared_ptr<const Generation> currentGeneration() const;
+
+  folly::Synchronized<std::shared_ptr<const Generation>> generation_{
+      std::make_shared<const Generation>()};
+};
+
+} // namespace proxygen
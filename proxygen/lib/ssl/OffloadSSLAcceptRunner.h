@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/Executor.h>
+#include <folly/io/async/EventBaseManager.h>
+#include <folly/io/async/SSLContext.h>
+#include <memory>
+
+namespace proxygen {
+
+/**
+ * SSLAcceptRunner that moves the CPU-heavy part of the TLS handshake -
+ * the SSL_accept cycle, including the private key operation - off the
+ * worker event loop onto a bounded crypto executor, so a reconnect
+ * storm doesn't starve established sessions. The completion always
+ * hops back to the connection's event base.
+ *
+ * Install on each server context (e.g. the contexts a
+ * ThreadLocalSSLContext implementation builds, or via the acceptor's
+ * SSLContextManager):
+ *
+ *   ctx->sslAcceptRunner() // replaced with:
+ *   ctx->setSSLAcceptRunner(
+ *       std::make_unique<OffloadSSLAcceptRunner>(cryptoPool));
+ *
+ * HSM or async-engine deployments substitute their own executor; the
+ * runner only requires Executor::add.
+ */
+class OffloadSSLAcceptRunner : public folly::SSLAcceptRunner {
+ public:
+  explicit OffloadSSLAcceptRunner(std::shared_ptr<folly::Executor> executor)
+      : executor_(std::move(executor)) {
+  }
+
+  void run(folly::Function<int()> acceptFunc,
+           folly::Function<void(int)> finallyFunc) const override {
+    // captured on the IO thread initiating the handshake step
+    auto evb = folly::EventBaseManager::get()->getEventBase();
+    executor_->add([acceptFunc = std::move(acceptFunc),
+                    finallyFunc = std::move(finallyFunc),
+                    evb]() mutable {
+      const int ret = acceptFunc();
+      evb->runInEventBaseThread(
+          [finallyFunc = std::move(finallyFunc), ret]() mutable {
+            finallyFunc(ret);
+          });
+    });
+  }
+
+ private:
+  std::shared_ptr<folly::Executor> executor_;
+};
+
+} // namespace proxygen
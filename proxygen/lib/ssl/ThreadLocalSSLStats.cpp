@@ -68,6 +68,14 @@ TLSSLStats::TLSSLStats(const std::string& prefix)
                                    SUM),
       fizzHandshakeSuccesses_(prefix + "_fizz_handshake_successes", SUM),
       tfoSuccess_(prefix + "_tfo_success", SUM),
+      earlyDataAccepted_(prefix + "_early_data_accepted", SUM),
+      earlyDataRejected_(prefix + "_early_data_rejected", SUM, PERCENT),
+      ocspStapleAge_(
+          prefix + "_ocsp_staple_age", 3600, 0, 864000, AVG, 50, 95, 99),
+      artifactZeroAllocLookups_(
+          prefix + "_handshake_artifact_zero_alloc_lookups", SUM),
+      artifactAllocLookups_(
+          prefix + "_handshake_artifact_alloc_lookups", SUM, PERCENT),
       fizzPskTypeNotSupported_(prefix + "_fizz_psktype_not_supported", SUM),
       fizzPskTypeNotAttempted_(prefix + "_fizz_psktype_not_attempted", SUM),
       fizzPskTypeRejected_(prefix + "_fizz_psktype_rejected", SUM),
@@ -75,6 +83,26 @@ TLSSLStats::TLSSLStats(const std::string& prefix)
       fizzPskTypeResumption_(prefix + "_fizz_psktype_resumption", SUM) {
 }
 
+void TLSSLStats::recordEarlyDataOutcome(bool accepted) noexcept {
+  if (accepted) {
+    earlyDataAccepted_.add(1);
+  } else {
+    earlyDataRejected_.add(1);
+  }
+}
+
+void TLSSLStats::recordOcspStapleAge(uint64_t ageSeconds) noexcept {
+  ocspStapleAge_.add(ageSeconds);
+}
+
+void TLSSLStats::recordHandshakeArtifactLookup(bool zeroAlloc) noexcept {
+  if (zeroAlloc) {
+    artifactZeroAllocLookups_.add(1);
+  } else {
+    artifactAllocLookups_.add(1);
+  }
+}
+
 void TLSSLStats::recordSSLAcceptLatency(int64_t latency) noexcept {
   if (latency >= 0) {
     sslAcceptLatency_.add(latency);
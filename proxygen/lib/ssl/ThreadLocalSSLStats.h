@@ -45,6 +45,26 @@ class ProxygenSSLStats : public wangle::SSLStats {
   virtual void recordZeroConfigUpdateSuccess() = 0;
 
   virtual void recordZeroConfigUpdateError() = 0;
+
+  /**
+   * Outcome of a 0-RTT early data attempt on an accepted connection;
+   * together with recordPskType this makes the resumption/0-RTT funnel
+   * (full handshake vs resumed vs early data accepted) observable.
+   */
+  virtual void recordEarlyDataOutcome(bool accepted) noexcept = 0;
+
+  /**
+   * Age of the OCSP staple served on a handshake, in seconds; watched
+   * to catch out-of-band refresh falling behind.
+   */
+  virtual void recordOcspStapleAge(uint64_t ageSeconds) noexcept = 0;
+
+  /**
+   * One handshake artifact lookup; zeroAlloc is true when it was
+   * served from the thread's primed slot with no heap allocation
+   * (see HandshakeArtifactCache).
+   */
+  virtual void recordHandshakeArtifactLookup(bool zeroAlloc) noexcept = 0;
 };
 
 class TLSSLStats : public ProxygenSSLStats {
@@ -96,6 +116,12 @@ class TLSSLStats : public ProxygenSSLStats {
 
   void recordZeroConfigUpdateError() override;
 
+  void recordEarlyDataOutcome(bool accepted) noexcept override;
+
+  void recordOcspStapleAge(uint64_t ageSeconds) noexcept override;
+
+  void recordHandshakeArtifactLookup(bool zeroAlloc) noexcept override;
+
  private:
   // Forbidden copy constructor and assignment operator
   TLSSLStats(TLSSLStats const&) = delete;
@@ -143,6 +169,15 @@ class TLSSLStats : public ProxygenSSLStats {
   BaseStats::TLTimeseries fizzHandshakeSuccesses_;
   BaseStats::TLTimeseries tfoSuccess_;
 
+  // 0-RTT early data outcomes
+  BaseStats::TLTimeseries earlyDataAccepted_;
+  BaseStats::TLTimeseries earlyDataRejected_;
+
+  // handshake artifact cache (staple/chain blobs)
+  BaseStats::TLHistogram ocspStapleAge_;
+  BaseStats::TLTimeseries artifactZeroAllocLookups_;
+  BaseStats::TLTimeseries artifactAllocLookups_;
+
   // PskTypes counters
   BaseStats::TLTimeseries fizzPskTypeNotSupported_;
   BaseStats::TLTimeseries fizzPskTypeNotAttempted_;
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/ssl/HandshakeArtifactCache.h>
+
+#include <folly/portability/GTest.h>
+
+using namespace proxygen;
+
+namespace {
+
+HandshakeArtifactCache::Artifacts makeArtifacts(const std::string& staple,
+                                                const std::string& chain) {
+  HandshakeArtifactCache::Artifacts artifacts;
+  if (!staple.empty()) {
+    artifacts.ocspStaple = folly::IOBuf::copyBuffer(staple);
+  }
+  artifacts.certChain = folly::IOBuf::copyBuffer(chain);
+  artifacts.stapleProducedAt = std::chrono::system_clock::now();
+  return artifacts;
+}
+
+} // namespace
+
+TEST(HandshakeArtifactCache, UpdateGetRoundtrip) {
+  HandshakeArtifactCache cache;
+  EXPECT_EQ(cache.get("www.example.com"), nullptr);
+
+  cache.update("www.example.com", makeArtifacts("staple-bytes", "chain"));
+  auto artifacts = cache.get("www.example.com");
+  ASSERT_NE(artifacts, nullptr);
+  EXPECT_EQ(artifacts->ocspStaple->clone()->moveToFbString(), "staple-bytes");
+
+  // every handshake shares the same published blob
+  auto again = cache.get("www.example.com");
+  EXPECT_EQ(artifacts.get(), again.get());
+}
+
+TEST(HandshakeArtifactCache, RefreshSupersedesWhileHoldersSurvive) {
+  HandshakeArtifactCache cache;
+  cache.update("cert", makeArtifacts("old-staple", "chain"));
+  auto held = cache.get("cert");
+  ASSERT_NE(held, nullptr);
+
+  cache.update("cert", makeArtifacts("new-staple", "chain"));
+  auto fresh = cache.get("cert");
+  ASSERT_NE(fresh, nullptr);
+  EXPECT_NE(held.get(), fresh.get());
+  // an in-flight handshake keeps serving the blob it already took
+  EXPECT_EQ(held->ocspStaple->clone()->moveToFbString(), "old-staple");
+  EXPECT_EQ(fresh->ocspStaple->clone()->moveToFbString(), "new-staple");
+
+  cache.remove("cert");
+  EXPECT_EQ(cache.get("cert"), nullptr);
+  EXPECT_EQ(cache.size(), 0);
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/ssl/HotCredentialStore.h>
+
+using namespace proxygen;
+
+TEST(HotCredentialStoreTest, UpdateAndLookupBookkeeping) {
+  HotCredentialStore store;
+  EXPECT_EQ(store.numCredentials(), 0);
+  EXPECT_EQ(store.getContext("a.example.com"), nullptr);
+
+  store.update({{"a.example.com", "/no/such/cert", "/no/such/key", "v1"},
+                {"b.example.com", "/no/such/cert", "/no/such/key", "v1"}});
+  EXPECT_EQ(store.numCredentials(), 2);
+  // a failed build (missing files) degrades to the default context
+  EXPECT_EQ(store.getContext("a.example.com"), nullptr);
+  EXPECT_EQ(store.getContext("unknown.example.com"), nullptr);
+
+  // rotation drops b and keeps a at the same version
+  store.update({{"a.example.com", "/no/such/cert", "/no/such/key", "v1"}});
+  EXPECT_EQ(store.numCredentials(), 1);
+  EXPECT_EQ(store.getContext("b.example.com"), nullptr);
+}
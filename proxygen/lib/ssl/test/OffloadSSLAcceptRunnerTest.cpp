@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/io/async/EventBase.h>
+#include <folly/io/async/EventBaseManager.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/ssl/OffloadSSLAcceptRunner.h>
+#include <thread>
+
+using namespace proxygen;
+
+TEST(OffloadSSLAcceptRunnerTest, RunsOffLoopCompletesOnLoop) {
+  folly::EventBase evb;
+  folly::EventBaseManager::get()->setEventBase(&evb, false);
+  auto pool = std::make_shared<folly::CPUThreadPoolExecutor>(1);
+  OffloadSSLAcceptRunner runner(pool);
+
+  const auto loopThreadId = std::this_thread::get_id();
+  std::thread::id acceptThreadId;
+  bool finallyRan = false;
+  int finallyResult = 0;
+
+  runner.run(
+      [&]() -> int {
+        acceptThreadId = std::this_thread::get_id();
+        return 42;
+      },
+      [&](int ret) {
+        // the completion must land back on the event base thread
+        EXPECT_EQ(std::this_thread::get_id(), loopThreadId);
+        finallyResult = ret;
+        finallyRan = true;
+        evb.terminateLoopSoon();
+      });
+
+  evb.loopForever();
+  EXPECT_TRUE(finallyRan);
+  EXPECT_EQ(finallyResult, 42);
+  // the accept function ran on the crypto pool, not the loop
+  EXPECT_NE(acceptThreadId, loopThreadId);
+  pool->join();
+  folly::EventBaseManager::get()->clearEventBase();
+}
@@ -228,6 +228,33 @@ struct ResourceData {
            pressureUdpMemLimit_ != 0 && minUdpMemLimit_ != 0;
   }
 
+  // Returns current accept-queue occupancy summed over the process's
+  // sampled listen sockets
+  uint64_t getListenBacklogDepth() const {
+    return listenBacklogDepth_;
+  }
+
+  // Returns the corresponding sum of kernel backlog limits
+  uint64_t getListenBacklogLimit() const {
+    return listenBacklogLimit_;
+  }
+
+  // Gets the accept-queue occupancy (0-1.0) as a ratio to the backlog limit
+  double getListenBacklogRatio() const {
+    return calculateRatio(listenBacklogDepth_, listenBacklogLimit_);
+  }
+
+  // Returns the system-wide ListenOverflows counter (monotonic)
+  uint64_t getListenOverflows() const {
+    return listenOverflows_;
+  }
+
+  // Returns True if listen backlog fields were initialized successfully,
+  // returns False otherwise
+  bool listenBacklogStatsCollected() const {
+    return listenBacklogLimit_ != 0;
+  }
+
   /**
    * Gets the time (from epoch) when this record was created (so for
    * which the utilization metrics are valid).
@@ -275,6 +302,19 @@ struct ResourceData {
     maxUdpMemLimit_ = maxThreshold;
   }
 
+  /**
+   * Sets the structure fields describing listen-socket accept backlog
+   * state; typically populated from
+   * ListenBacklogSampler::getProcessStats().
+   */
+  void setListenBacklogStats(uint64_t depth,
+                             uint64_t limit,
+                             uint64_t overflows) {
+    listenBacklogDepth_ = depth;
+    listenBacklogLimit_ = limit;
+    listenOverflows_ = overflows;
+  }
+
   /**
    * Refreshes the time (from epoch) when this record was created (so for
    * which the utilization metrics are valid).
@@ -315,6 +355,9 @@ struct ResourceData {
   uint64_t maxUdpMemLimit_{0};
   uint64_t pressureUdpMemLimit_{0};
   uint64_t minUdpMemLimit_{0};
+  uint64_t listenBacklogDepth_{0};
+  uint64_t listenBacklogLimit_{0};
+  uint64_t listenOverflows_{0};
 
   // Refresh management fields
   std::chrono::milliseconds time_{0};
@@ -85,4 +85,23 @@ void ResourceStats::modifyData(ResourceData* newData) {
   folly::rcu_retire(oldData);
 }
 
+SlidingWindowSeries& ResourceStats::getBurstSeries(
+    const std::string& name,
+    std::chrono::milliseconds bucketWidth,
+    size_t numBuckets) {
+  {
+    auto series = burstSeries_.rlock();
+    auto it = series->find(name);
+    if (it != series->end()) {
+      return *it->second;
+    }
+  }
+  auto series = burstSeries_.wlock();
+  auto& entry = (*series)[name];
+  if (!entry) {
+    entry = std::make_unique<SlidingWindowSeries>(bucketWidth, numBuckets);
+  }
+  return *entry;
+}
+
 } // namespace proxygen
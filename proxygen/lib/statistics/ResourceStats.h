@@ -9,9 +9,12 @@
 #pragma once
 
 #include "proxygen/lib/statistics/ResourceData.h"
+#include "proxygen/lib/statistics/SlidingWindowSeries.h"
 #include <atomic>
 #include <chrono>
+#include <folly/Synchronized.h>
 #include <folly/ThreadLocal.h>
+#include <unordered_map>
 #include <folly/experimental/FunctionScheduler.h>
 
 namespace proxygen {
@@ -90,6 +93,20 @@ class ResourceStats {
   // data is available.
   virtual const ResourceData& getPreviousLoadData() const;
 
+  /**
+   * Burst-visible companion to the polled gauges: a named
+   * sliding-window series (SlidingWindowSeries) created on first use.
+   * Callers cache the returned reference and record() on it lock-free
+   * from any worker; readers merge the trailing window for
+   * max/p99-over-window, so sub-interval bursts are visible at bucket
+   * granularity instead of a polling interval late.  The reference
+   * stays valid for the lifetime of this ResourceStats.
+   */
+  SlidingWindowSeries& getBurstSeries(
+      const std::string& name,
+      std::chrono::milliseconds bucketWidth = std::chrono::milliseconds(100),
+      size_t numBuckets = 50);
+
  protected:
   void updateCachedData();
 
@@ -128,6 +145,11 @@ class ResourceStats {
  private:
   // Wrapper for updating and retiring old cached data_ via RCU.
   void modifyData(ResourceData* newData);
+
+  // named burst series; pointers are stable once created
+  folly::Synchronized<
+      std::unordered_map<std::string, std::unique_ptr<SlidingWindowSeries>>>
+      burstSeries_;
 };
 
 } // namespace proxygen
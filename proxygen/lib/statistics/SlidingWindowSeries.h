@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Burst-tolerant sliding-window series: a ring of sub-second buckets
+ * maintained lock-free on the update path, merged on read into
+ * max/p99/avg over the trailing window.
+ *
+ * ResourceStats' polled gauges hide anything shorter than the polling
+ * interval - a one-second burst that queues millions of requests is
+ * invisible until the next refresh.  Here every record() lands in the
+ * current time bucket (relaxed atomics, no locks; concurrent writers
+ * from any worker are fine), and a reader merges however many buckets
+ * cover its window, so overload detection sees the burst at bucket
+ * granularity instead of a polling interval late.
+ *
+ * Per-bucket state is a count/sum/max plus a 64-slot log2 histogram,
+ * so the merged p99 is a power-of-two upper bound - coarse, but
+ * monotone and cheap enough to keep on the hot path.  Buckets recycle
+ * by epoch: a writer that finds a stale bucket resets it first, and
+ * readers skip buckets whose epoch falls outside the window, so no
+ * sweeper thread is needed.  Writers racing a recycle at a bucket
+ * boundary can lose a handful of samples (never inflate), and a
+ * reader overlapping a recycle can see a partially cleared bucket -
+ * bounded imprecision traded for a lock-free hot path.
+ */
+class SlidingWindowSeries {
+ public:
+  explicit SlidingWindowSeries(
+      std::chrono::milliseconds bucketWidth = std::chrono::milliseconds(100),
+      size_t numBuckets = 50)
+      : bucketWidthMs_(uint64_t(bucketWidth.count())),
+        buckets_(numBuckets) {
+  }
+
+  /** Record one sample; lock-free, callable from any thread. */
+  void record(uint64_t value) {
+    auto epoch = currentEpoch();
+    auto& bucket = buckets_[epoch % buckets_.size()];
+    auto bucketEpoch = bucket.epoch.load(std::memory_order_acquire);
+    if (bucketEpoch != epoch) {
+      // recycle: one writer wins the reset; losers just record into
+      // the freshly cleared bucket
+      if (bucket.epoch.compare_exchange_strong(
+              bucketEpoch, epoch, std::memory_order_acq_rel)) {
+        bucket.clear();
+      } else if (bucket.epoch.load(std::memory_order_acquire) != epoch) {
+        return; // raced with an even newer epoch; drop the sample
+      }
+    }
+    bucket.count.fetch_add(1, std::memory_order_relaxed);
+    bucket.sum.fetch_add(value, std::memory_order_relaxed);
+    atomicMax(bucket.max, value);
+    bucket.histogram[log2Slot(value)].fetch_add(1,
+                                                std::memory_order_relaxed);
+  }
+
+  struct WindowSnapshot {
+    uint64_t count{0};
+    uint64_t max{0};
+    /** power-of-two upper bound of the window's 99th percentile */
+    uint64_t p99{0};
+    double avg{0};
+  };
+
+  /** Merge the buckets covering the trailing window. */
+  WindowSnapshot read(std::chrono::milliseconds window) const {
+    WindowSnapshot snapshot;
+    std::array<uint64_t, kHistogramSlots> merged{};
+    uint64_t sum = 0;
+    const auto nowEpoch = currentEpoch();
+    const uint64_t windowBuckets = std::min<uint64_t>(
+        (uint64_t(window.count()) + bucketWidthMs_ - 1) / bucketWidthMs_,
+        buckets_.size());
+    for (const auto& bucket : buckets_) {
+      auto epoch = bucket.epoch.load(std::memory_order_acquire);
+      if (epoch == 0 || epoch + windowBuckets <= nowEpoch) {
+        continue; // outside the window (or never used)
+      }
+      snapshot.count += bucket.count.load(std::memory_order_relaxed);
+      sum += bucket.sum.load(std::memory_order_relaxed);
+      snapshot.max = std::max(
+          snapshot.max, bucket.max.load(std::memory_order_relaxed));
+      for (size_t i = 0; i < kHistogramSlots; i++) {
+        merged[i] += bucket.histogram[i].load(std::memory_order_relaxed);
+      }
+    }
+    if (snapshot.count > 0) {
+      snapshot.avg = double(sum) / double(snapshot.count);
+      uint64_t target = uint64_t(0.99 * double(snapshot.count) + 0.5);
+      uint64_t seen = 0;
+      for (size_t i = 0; i < kHistogramSlots; i++) {
+        seen += merged[i];
+        if (seen >= target) {
+          snapshot.p99 = slotUpperEdge(i);
+          break;
+        }
+      }
+    }
+    return snapshot;
+  }
+
+  std::chrono::milliseconds windowCapacity() const {
+    return std::chrono::milliseconds(bucketWidthMs_ * buckets_.size());
+  }
+
+ private:
+  static constexpr size_t kHistogramSlots = 64;
+
+  struct Bucket {
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+    std::array<std::atomic<uint64_t>, kHistogramSlots> histogram{};
+
+    void clear() {
+      count.store(0, std::memory_order_relaxed);
+      sum.store(0, std::memory_order_relaxed);
+      max.store(0, std::memory_order_relaxed);
+      for (auto& slot : histogram) {
+        slot.store(0, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  uint64_t currentEpoch() const {
+    auto nowMs = uint64_t(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+    // +1 keeps epoch 0 meaning "never used"
+    return nowMs / bucketWidthMs_ + 1;
+  }
+
+  static size_t log2Slot(uint64_t value) {
+    if (value == 0) {
+      return 0;
+    }
+    // top slot absorbs everything with the high bit set
+    return std::min<size_t>(64 - size_t(__builtin_clzll(value)),
+                            kHistogramSlots - 1);
+  }
+
+  static uint64_t slotUpperEdge(size_t slot) {
+    if (slot >= kHistogramSlots - 1) {
+      return UINT64_MAX;
+    }
+    return slot == 0 ? 0 : ((uint64_t(1) << slot) - 1);
+  }
+
+  static void atomicMax(std::atomic<uint64_t>& target, uint64_t value) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (current < value &&
+           !target.compare_exchange_weak(
+               current, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  const uint64_t bucketWidthMs_;
+  std::vector<Bucket> buckets_;
+};
+
+} // namespace proxygen
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/statistics/SlidingWindowSeries.h>
+
+#include <folly/portability/GTest.h>
+#include <thread>
+
+using namespace proxygen;
+
+TEST(SlidingWindowSeriesTest, WindowMerge) {
+  SlidingWindowSeries series(std::chrono::milliseconds(10), 100);
+  for (uint64_t i = 0; i < 100; i++) {
+    series.record(10);
+  }
+  series.record(5000); // the burst sample
+
+  auto snapshot = series.read(std::chrono::milliseconds(1000));
+  EXPECT_EQ(snapshot.count, 101);
+  EXPECT_EQ(snapshot.max, 5000);
+  // p99 upper bound must cover the burst once it crosses the rank
+  EXPECT_GE(snapshot.p99, 10);
+  EXPECT_GT(snapshot.avg, 10.0);
+}
+
+TEST(SlidingWindowSeriesTest, OldBucketsAgeOut) {
+  SlidingWindowSeries series(std::chrono::milliseconds(10), 8);
+  series.record(1000);
+  auto now = series.read(std::chrono::milliseconds(1000));
+  EXPECT_EQ(now.count, 1);
+
+  // sleep past the ring capacity; the sample's bucket leaves every
+  // window even before being recycled by a writer
+  std::this_thread::sleep_for(series.windowCapacity() +
+                              std::chrono::milliseconds(20));
+  auto later = series.read(std::chrono::milliseconds(50));
+  EXPECT_EQ(later.count, 0);
+  EXPECT_EQ(later.max, 0);
+}
+
+TEST(SlidingWindowSeriesTest, ConcurrentRecorders) {
+  SlidingWindowSeries series(std::chrono::milliseconds(100), 50);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&series] {
+      for (int i = 0; i < 10000; i++) {
+        series.record(uint64_t(i % 1000));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto snapshot = series.read(std::chrono::milliseconds(5000));
+  // epoch races may drop a handful at bucket boundaries, never inflate
+  EXPECT_LE(snapshot.count, 40000);
+  EXPECT_GE(snapshot.count, 39000);
+  EXPECT_EQ(snapshot.max, 999);
+}
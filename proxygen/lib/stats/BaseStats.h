@@ -9,6 +9,7 @@
 #pragma once
 
 #include "fb303/ThreadCachedServiceData.h"
+#include <proxygen/lib/stats/ShardedCounter.h>
 
 namespace proxygen {
 
@@ -34,6 +35,12 @@ class BaseStats {
   using TLTimeseriesMinute = facebook::fb303::MinuteOnlyTimeseriesWrapper;
   using TLTimeseriesMinuteAndAllTime = facebook::fb303::MinuteTimeseriesWrapper;
   using TLHistogram = facebook::fb303::HistogramWrapper;
+
+  // For hot counters outside the fb303 export path: increments land on
+  // the calling thread's own cache line, reads aggregate periodically.
+  // The fb303 TL wrappers above are already thread-cached; use this
+  // where a raw shared atomic would otherwise be reached for.
+  using TLShardedCounter = proxygen::ShardedCounter;
 };
 
 } // namespace proxygen
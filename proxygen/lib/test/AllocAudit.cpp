@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/*
+ * Allocation-per-request regression gate.
+ *
+ * Runs a fixed set of request-shaped scenarios (header compression,
+ * header map workloads, message copies, chunked framing) under a
+ * counting global operator new, and compares allocations/request and
+ * bytes/request against the checked-in baseline
+ * (lib/test/alloc_audit_baseline.txt).  A scenario that allocates
+ * more than tolerance over its baseline fails the run, which is what
+ * the proxygen_alloc_audit build target executes pre-merge and
+ * per-release.
+ *
+ *   alloc_audit --baseline .../alloc_audit_baseline.txt
+ *   alloc_audit --baseline ... --update_baseline   # re-record
+ *
+ * Numbers are per build environment (allocator, stdlib, folly
+ * version), so the baseline is re-recorded with --update_baseline
+ * whenever the toolchain moves; the gate exists to catch *code*
+ * regressions between recordings.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <new>
+#include <sstream>
+
+#include <folly/Benchmark.h>
+#include <folly/portability/GFlags.h>
+#include <glog/logging.h>
+
+#include <proxygen/lib/http/HTTPMessage.h>
+#include <proxygen/lib/http/codec/HTTP1xCodec.h>
+#include <proxygen/lib/http/codec/compress/HPACKCodec.h>
+#include <proxygen/lib/http/codec/compress/test/TestStreamingCallback.h>
+
+DEFINE_string(baseline, "", "baseline file to check against");
+DEFINE_bool(update_baseline, false, "re-record the baseline instead");
+DEFINE_int32(iterations, 1000, "iterations per scenario");
+DEFINE_double(tolerance, 0.10, "relative growth allowed over baseline");
+DEFINE_int32(slack, 2, "absolute allocations/request allowed over baseline");
+
+// ---- counting global allocator hook ------------------------------------
+
+namespace {
+// plain (not atomic): scenarios are single-threaded, and the hook
+// must not allocate or synchronize
+thread_local bool g_counting = false;
+thread_local uint64_t g_allocs = 0;
+thread_local uint64_t g_bytes = 0;
+} // namespace
+
+void* operator new(size_t size) {
+  if (g_counting) {
+    g_allocs++;
+    g_bytes += size;
+  }
+  void* p = malloc(size);
+  if (!p) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  free(p);
+}
+
+// ---- scenarios ---------------------------------------------------------
+
+namespace {
+
+using namespace proxygen;
+
+struct Measurement {
+  double allocsPerRequest{0};
+  double bytesPerRequest{0};
+};
+
+std::vector<std::vector<std::string>> requestHeaderSet() {
+  return {
+      {":method", "GET"},
+      {":path", "/api/v2/lookup?id=12345"},
+      {":scheme", "https"},
+      {":authority", "api.example.com"},
+      {"user-agent", "alloc-audit/1.0"},
+      {"accept", "application/json"},
+      {"accept-encoding", "gzip, deflate"},
+      {"cookie", "session=0123456789abcdef0123456789abcdef"},
+      {"x-request-id", "a9b8c7d6-e5f4-4321-8765-fedcba987654"},
+  };
+}
+
+template <typename Fn>
+Measurement measure(Fn&& fn, int iterations) {
+  // warmup primes lazy statics (static tables, thread-local pools)
+  // outside the counted region
+  fn();
+  fn();
+  g_allocs = 0;
+  g_bytes = 0;
+  g_counting = true;
+  for (int i = 0; i < iterations; i++) {
+    fn();
+  }
+  g_counting = false;
+  Measurement m;
+  m.allocsPerRequest = double(g_allocs) / iterations;
+  m.bytesPerRequest = double(g_bytes) / iterations;
+  return m;
+}
+
+std::map<std::string, Measurement> runScenarios(int iterations) {
+  std::map<std::string, Measurement> results;
+
+  {
+    HPACKCodec encoder{TransportDirection::UPSTREAM};
+    auto names = requestHeaderSet();
+    results["hpack_encode_request"] = measure(
+        [&] {
+          std::vector<compress::Header> block;
+          for (auto& header : names) {
+            block.push_back(
+                compress::Header::makeHeaderForTest(header[0], header[1]));
+          }
+          auto encoded = encoder.encode(block);
+          folly::doNotOptimizeAway(encoded.get());
+        },
+        iterations);
+  }
+
+  {
+    HPACKCodec encoder{TransportDirection::UPSTREAM};
+    HPACKCodec decoder{TransportDirection::DOWNSTREAM};
+    auto names = requestHeaderSet();
+    results["hpack_roundtrip"] = measure(
+        [&] {
+          std::vector<compress::Header> block;
+          for (auto& header : names) {
+            block.push_back(
+                compress::Header::makeHeaderForTest(header[0], header[1]));
+          }
+          auto encoded = encoder.encode(block);
+          TestStreamingCallback cb;
+          folly::io::Cursor cursor(encoded.get());
+          decoder.decodeStreaming(cursor, cursor.totalLength(), &cb);
+          CHECK(!cb.hasError());
+        },
+        iterations);
+  }
+
+  results["http_headers_workload"] = measure(
+      [] {
+        HTTPHeaders headers;
+        headers.add(HTTP_HEADER_HOST, "api.example.com");
+        headers.add(HTTP_HEADER_CONTENT_TYPE, "application/json");
+        headers.add(HTTP_HEADER_CONTENT_LENGTH, "512");
+        headers.add(HTTP_HEADER_USER_AGENT, "alloc-audit/1.0");
+        headers.add("x-request-id", "a9b8c7d6-e5f4-4321");
+        headers.add("x-forwarded-for", "192.0.2.1");
+        auto exists = headers.exists(HTTP_HEADER_CONTENT_TYPE);
+        folly::doNotOptimizeAway(exists);
+        auto single = headers.getSingleOrEmpty(HTTP_HEADER_HOST);
+        folly::doNotOptimizeAway(single.data());
+        headers.remove(HTTP_HEADER_USER_AGENT);
+        HTTPHeaders copy(headers);
+        folly::doNotOptimizeAway(copy.size());
+      },
+      iterations);
+
+  results["http_message_forwarding_copy"] = measure(
+      [] {
+        HTTPMessage msg;
+        msg.setHTTPVersion(1, 1);
+        msg.setURL("/api/v2/lookup?id=12345");
+        msg.getHeaders().add(HTTP_HEADER_HOST, "api.example.com");
+        msg.getHeaders().add(HTTP_HEADER_COOKIE, "session=0123456789abcdef");
+        auto forwarded = msg.forwardingCopy();
+        folly::doNotOptimizeAway(forwarded.getHeaders().size());
+      },
+      iterations);
+
+  {
+    HTTP1xCodec codec{TransportDirection::UPSTREAM};
+    auto streamId = codec.createStream();
+    // enter chunked egress once; the counted region is the per-chunk
+    // framing, the steady state of a streaming body
+    HTTPMessage msg;
+    msg.setHTTPVersion(1, 1);
+    msg.setURL("/stream");
+    msg.getHeaders().set(HTTP_HEADER_HOST, "api.example.com");
+    msg.getHeaders().set(HTTP_HEADER_TRANSFER_ENCODING, "chunked");
+    msg.setIsChunked(true);
+    folly::IOBufQueue writeBuf{folly::IOBufQueue::cacheChainLength()};
+    codec.generateHeader(writeBuf, streamId, msg, false, nullptr);
+    writeBuf.move();
+    results["h1_chunk_framing"] = measure(
+        [&] {
+          auto body = folly::IOBuf::create(4096);
+          memset(body->writableTail(), 'b', 4096);
+          body->append(4096);
+          codec.generateChunkHeader(writeBuf, streamId, 4096);
+          codec.generateBody(
+              writeBuf, streamId, std::move(body), HTTPCodec::NoPadding,
+              false);
+          codec.generateChunkTerminator(writeBuf, streamId);
+          writeBuf.move();
+        },
+        iterations);
+  }
+
+  return results;
+}
+
+// ---- baseline handling -------------------------------------------------
+
+std::map<std::string, Measurement> loadBaseline(const std::string& path) {
+  std::map<std::string, Measurement> baseline;
+  std::ifstream in(path);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::string name;
+    Measurement m;
+    if (fields >> name >> m.allocsPerRequest >> m.bytesPerRequest) {
+      baseline[name] = m;
+    }
+  }
+  return baseline;
+}
+
+bool writeBaseline(const std::string& path,
+                   const std::map<std::string, Measurement>& results) {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out) {
+    LOG(ERROR) << "cannot write baseline " << path;
+    return false;
+  }
+  out << "# alloc_audit baseline: scenario allocs/request bytes/request\n"
+      << "# re-record with: alloc_audit --baseline <this file>"
+      << " --update_baseline\n";
+  for (const auto& entry : results) {
+    out << entry.first << " " << entry.second.allocsPerRequest << " "
+        << entry.second.bytesPerRequest << "\n";
+  }
+  return bool(out);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  google::InitGoogleLogging(argv[0]);
+  google::SetStderrLogging(google::INFO);
+
+  if (FLAGS_baseline.empty()) {
+    LOG(ERROR) << "--baseline is required";
+    return 2;
+  }
+
+  auto results = runScenarios(FLAGS_iterations);
+  for (const auto& entry : results) {
+    LOG(INFO) << entry.first << ": " << entry.second.allocsPerRequest
+              << " allocs/req, " << entry.second.bytesPerRequest
+              << " bytes/req";
+  }
+
+  if (FLAGS_update_baseline) {
+    if (!writeBaseline(FLAGS_baseline, results)) {
+      return 2;
+    }
+    LOG(INFO) << "baseline updated: " << FLAGS_baseline;
+    return 0;
+  }
+
+  auto baseline = loadBaseline(FLAGS_baseline);
+  int failures = 0;
+  for (const auto& entry : results) {
+    auto it = baseline.find(entry.first);
+    if (it == baseline.end()) {
+      LOG(ERROR) << entry.first << ": no baseline recorded; run with"
+                 << " --update_baseline to record it";
+      failures++;
+      continue;
+    }
+    double allocLimit =
+        it->second.allocsPerRequest * (1 + FLAGS_tolerance) + FLAGS_slack;
+    double byteLimit = it->second.bytesPerRequest * (1 + FLAGS_tolerance) +
+                       FLAGS_slack * 64;
+    if (entry.second.allocsPerRequest > allocLimit) {
+      LOG(ERROR) << entry.first << ": allocations/request regressed: "
+                 << entry.second.allocsPerRequest << " > baseline "
+                 << it->second.allocsPerRequest << " (+tolerance)";
+      failures++;
+    }
+    if (entry.second.bytesPerRequest > byteLimit) {
+      LOG(ERROR) << entry.first << ": bytes/request regressed: "
+                 << entry.second.bytesPerRequest << " > baseline "
+                 << it->second.bytesPerRequest << " (+tolerance)";
+      failures++;
+    }
+    if (entry.second.allocsPerRequest <
+        it->second.allocsPerRequest * (1 - FLAGS_tolerance)) {
+      LOG(INFO) << entry.first << ": improved well under baseline;"
+                << " consider re-recording with --update_baseline";
+    }
+  }
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/transport/SettingsResumptionCache.h>
+
+#include <folly/hash/Hash.h>
+
+namespace {
+
+template <typename Container>
+uint32_t fingerprintImpl(const Container& settings) {
+  // commutative accumulation so ordering differences between the
+  // generate and parse paths don't change the fingerprint; ids are
+  // unique within a SETTINGS frame
+  uint64_t acc = 0x531ab5c0de5e55edULL;
+  for (const auto& setting : settings) {
+    acc += folly::hash::twang_mix64(
+        (uint64_t(setting.first) << 32) | setting.second);
+  }
+  return uint32_t(acc ^ (acc >> 32));
+}
+
+} // namespace
+
+namespace proxygen {
+
+uint32_t SettingsResumptionCache::fingerprint(const Settings& settings) {
+  return fingerprintImpl(settings);
+}
+
+uint32_t SettingsResumptionCache::fingerprint(
+    const std::deque<SettingPair>& settings) {
+  return fingerprintImpl(settings);
+}
+
+void SettingsResumptionCache::storeSent(const std::string& peer,
+                                        Settings settings) {
+  (*entries_.wlock())[peer].sent = std::move(settings);
+}
+
+void SettingsResumptionCache::storeReceived(const std::string& peer,
+                                            Settings settings) {
+  (*entries_.wlock())[peer].received = std::move(settings);
+}
+
+folly::Optional<SettingsResumptionCache::Settings>
+SettingsResumptionCache::getSent(const std::string& peer) const {
+  auto entries = entries_.rlock();
+  auto it = entries->find(peer);
+  if (it == entries->end()) {
+    return folly::none;
+  }
+  return it->second.sent;
+}
+
+folly::Optional<SettingsResumptionCache::Settings>
+SettingsResumptionCache::getReceived(const std::string& peer) const {
+  auto entries = entries_.rlock();
+  auto it = entries->find(peer);
+  if (it == entries->end()) {
+    return folly::none;
+  }
+  return it->second.received;
+}
+
+void SettingsResumptionCache::invalidate(const std::string& peer) {
+  entries_.wlock()->erase(peer);
+}
+
+} // namespace proxygen
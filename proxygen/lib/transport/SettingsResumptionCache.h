@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <deque>
+#include <folly/Optional.h>
+#include <folly/Synchronized.h>
+#include <proxygen/lib/http/codec/SettingsId.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Per-peer cache of the last acknowledged SETTINGS exchange, for the
+ * settings-resumption extension (SETTINGS_RESUMPTION_FINGERPRINT) on
+ * proxygen-to-proxygen connections.  Keyed by a peer identity string,
+ * like the PSK caches next door.
+ *
+ * Each direction is cached independently: storeSent records what this
+ * process sent once the peer acknowledged it, storeReceived what this
+ * process received and acknowledged.  On reconnect the codec elides
+ * settings whose cached value is unchanged and sends the fingerprint
+ * of the full set instead; the receiving codec restores the elided
+ * values from its own cache and verifies the fingerprint over the
+ * merged result, so a stale cache on either side surfaces as an
+ * explicit protocol error rather than a silent config divergence
+ * (invalidate() lets the application clear the entry before
+ * reconnecting).
+ *
+ * In-memory and shared across threads; size it for the mesh fan-out
+ * (entries are a handful of id/value pairs each).
+ */
+class SettingsResumptionCache {
+ public:
+  using Settings = std::vector<SettingPair>;
+
+  /** Order-independent fingerprint of a settings set. */
+  static uint32_t fingerprint(const Settings& settings);
+  static uint32_t fingerprint(const std::deque<SettingPair>& settings);
+
+  void storeSent(const std::string& peer, Settings settings);
+  void storeReceived(const std::string& peer, Settings settings);
+
+  folly::Optional<Settings> getSent(const std::string& peer) const;
+  folly::Optional<Settings> getReceived(const std::string& peer) const;
+
+  /** Drop both directions for a peer (e.g. after a resumption error). */
+  void invalidate(const std::string& peer);
+
+  size_t size() const {
+    return entries_.rlock()->size();
+  }
+
+ private:
+  struct Entry {
+    folly::Optional<Settings> sent;
+    folly::Optional<Settings> received;
+  };
+
+  folly::Synchronized<std::unordered_map<std::string, Entry>> entries_;
+};
+
+} // namespace proxygen
@@ -11,22 +11,51 @@
 #include <glog/logging.h>
 
 #include <folly/Range.h>
-#include <folly/portability/OpenSSL.h>
-#include <openssl/buffer.h>
 
 namespace {
-struct BIODeleter {
- public:
-  void operator()(BIO* bio) const { BIO_free_all(bio); };
+
+constexpr char kEncodeTable[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// any set bit in the top byte marks an invalid input character
+constexpr uint32_t kBad = 0xff000000;
+
+/**
+ * One table per input position: d0[c0] | d1[c1] | d2[c2] | d3[c3]
+ * reconstructs the 24-bit group directly, so decoding processes a whole
+ * quantum per iteration with a single validity branch.
+ */
+struct DecodeTables {
+  uint32_t d0[256];
+  uint32_t d1[256];
+  uint32_t d2[256];
+  uint32_t d3[256];
 };
 
+const DecodeTables& decodeTables() {
+  static const DecodeTables tables = [] {
+    DecodeTables t;
+    for (uint32_t c = 0; c < 256; c++) {
+      t.d0[c] = t.d1[c] = t.d2[c] = t.d3[c] = kBad;
+    }
+    for (uint32_t i = 0; i < 64; i++) {
+      const auto c = static_cast<uint8_t>(kEncodeTable[i]);
+      t.d0[c] = i << 18;
+      t.d1[c] = i << 12;
+      t.d2[c] = i << 6;
+      t.d3[c] = i;
+    }
+    return t;
+  }();
+  return tables;
 }
 
+} // namespace
+
 namespace proxygen {
 
 // Decodes a base64url encoded string
 std::string Base64::urlDecode(const std::string& urlB64message) {
-  std::unique_ptr<BIO, BIODeleter> bio, b64;
   uint8_t padding = (4 - urlB64message.length() % 4) % 4;
   if (padding == 3) {
     return std::string();
@@ -51,55 +80,78 @@ std::string Base64::urlDecode(const std::string& urlB64message) {
 }
 
 std::string Base64::decode(const std::string& b64message, int padding) {
-  if (b64message.length() % 4 != 0 || padding >= 3) {
-    return std::string();
-  }
-
-  std::unique_ptr<BIO, BIODeleter> bio, b64;
-  size_t decodeLen = b64message.length() * 3/4 - padding;
-  std::string result(decodeLen, '\0');
-
-  bio.reset(BIO_new_mem_buf((void*)b64message.data(), -1));
-  if (!bio) {
+  const size_t length = b64message.length();
+  if (length % 4 != 0 || padding >= 3 ||
+      (length == 0 && padding > 0)) {
     return std::string();
   }
-  b64.reset(BIO_new(BIO_f_base64()));
-  if (!b64) {
+  if (length == 0) {
     return std::string();
   }
-  bio.reset(BIO_push(b64.release(), bio.release()));
 
-  // Do not use newlines to flush buffer
-  BIO_set_flags(bio.get(), BIO_FLAGS_BASE64_NO_NL);
-  BIO_read(bio.get(), (char*)result.data(), b64message.length());
-  DCHECK_LE(result.length(), decodeLen);
-  if (result.length() < decodeLen) {
-    return std::string();
+  const size_t decodeLen = length * 3 / 4 - padding;
+  std::string result(decodeLen, '\0');
+  const auto& t = decodeTables();
+  auto in = reinterpret_cast<const uint8_t*>(b64message.data());
+  auto out = &result[0];
+
+  const size_t groups = length / 4;
+  const size_t fullGroups = (padding > 0) ? groups - 1 : groups;
+  for (size_t i = 0; i < fullGroups; i++) {
+    const uint32_t v =
+        t.d0[in[0]] | t.d1[in[1]] | t.d2[in[2]] | t.d3[in[3]];
+    if (v & kBad) {
+      return std::string();
+    }
+    out[0] = char(v >> 16);
+    out[1] = char(v >> 8);
+    out[2] = char(v);
+    in += 4;
+    out += 3;
+  }
+  if (padding > 0) {
+    // final quantum carries one or two '=' characters
+    if (in[3] != '=' || (padding == 2 && in[2] != '=')) {
+      return std::string();
+    }
+    const uint32_t v = t.d0[in[0]] | t.d1[in[1]] |
+        ((padding == 1) ? t.d2[in[2]] : 0);
+    if (v & kBad) {
+      return std::string();
+    }
+    out[0] = char(v >> 16);
+    if (padding == 1) {
+      out[1] = char(v >> 8);
+    }
   }
   return result;
 }
 
 std::string Base64::encode(folly::ByteRange buffer) {
-  std::unique_ptr<BIO, BIODeleter> bio, b64;
-  BUF_MEM* bufferPtr;
-
-  b64.reset(BIO_new(BIO_f_base64()));
-  if (!b64) {
-    throw std::bad_alloc();
+  std::string result((buffer.size() + 2) / 3 * 4, '=');
+  auto out = &result[0];
+  auto in = buffer.data();
+  size_t remaining = buffer.size();
+  while (remaining >= 3) {
+    const uint32_t v = uint32_t(in[0]) << 16 | uint32_t(in[1]) << 8 | in[2];
+    out[0] = kEncodeTable[v >> 18];
+    out[1] = kEncodeTable[(v >> 12) & 0x3f];
+    out[2] = kEncodeTable[(v >> 6) & 0x3f];
+    out[3] = kEncodeTable[v & 0x3f];
+    in += 3;
+    out += 4;
+    remaining -= 3;
   }
-  bio.reset(BIO_new(BIO_s_mem()));
-  if (!bio) {
-    throw std::bad_alloc();
+  if (remaining == 1) {
+    const uint32_t v = uint32_t(in[0]) << 16;
+    out[0] = kEncodeTable[v >> 18];
+    out[1] = kEncodeTable[(v >> 12) & 0x3f];
+  } else if (remaining == 2) {
+    const uint32_t v = uint32_t(in[0]) << 16 | uint32_t(in[1]) << 8;
+    out[0] = kEncodeTable[v >> 18];
+    out[1] = kEncodeTable[(v >> 12) & 0x3f];
+    out[2] = kEncodeTable[(v >> 6) & 0x3f];
   }
-  bio.reset(BIO_push(b64.release(), bio.release()));
-
-  // Ignore newlines - write everything in one line
-  BIO_set_flags(bio.get(), BIO_FLAGS_BASE64_NO_NL);
-  BIO_write(bio.get(), buffer.data(), buffer.size());
-  (void)BIO_flush(bio.get());
-  BIO_get_mem_ptr(bio.get(), &bufferPtr);
-
-  std::string result(bufferPtr->data, bufferPtr->length);
   return result;
 }
 
@@ -13,8 +13,10 @@
 
 namespace proxygen {
 
-// This is a wrapper around openssl base64 encoding.  It is a temporary wrapper
-// around openssl, until a more optimized version lands in folly
+// Table-driven base64: decode reconstructs a 24-bit quantum per
+// iteration from four position-specific lookup tables with a single
+// validity branch; encode emits four characters per three input bytes.
+// Invalid input decodes to an empty string.
 
 class Base64 {
   public:
@@ -17,13 +17,26 @@ Exception::Exception(const char* msg) : msg_(msg), code_(0) {}
 Exception::Exception(const Exception& other)
     : msg_(other.msg_),
       code_(other.code_),
+      lazyMessage_(other.lazyMessage_),
       proxygenError_(other.proxygenError_) {}
 
 Exception::Exception(Exception&& other) noexcept
     : msg_(other.msg_),
       code_(other.code_),
+      lazyMessage_(other.lazyMessage_),
       proxygenError_(other.proxygenError_) {}
 
-const char* Exception::what(void) const throw() { return msg_.c_str(); }
+const char* Exception::what(void) const throw() {
+  if (lazyMessage_) {
+    lazyMessage_ = false;
+    try {
+      msg_ = materializeMessage();
+    } catch (...) {
+      // what() must not throw; the POD state is still intact
+      msg_ = "proxygen::Exception (message materialization failed)";
+    }
+  }
+  return msg_.c_str();
+}
 
 }
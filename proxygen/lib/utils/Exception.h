@@ -39,6 +39,23 @@ class Exception : public std::exception {
   // std::exception methods
   const char* what(void) const noexcept override;
 
+ protected:
+  /**
+   * Deferred-message construction: subclasses that can describe
+   * themselves from POD state use this tag and override
+   * materializeMessage(); the string is only built on the first
+   * what(), so error objects that nothing ever logs never allocate
+   * their message.
+   */
+  struct LazyMessageTag {};
+  explicit Exception(LazyMessageTag) : code_(0), lazyMessage_(true) {}
+
+  virtual std::string materializeMessage() const {
+    return msg_;
+  }
+
+ public:
+
   // Accessors for code
   void setCode(int code) { code_ = code; }
 
@@ -54,8 +71,10 @@ class Exception : public std::exception {
   ProxygenError getProxygenError() const { return proxygenError_; }
 
  private:
-  const std::string msg_;
+  // mutable: lazily materialized by what() (see LazyMessageTag)
+  mutable std::string msg_;
   int code_;
+  mutable bool lazyMessage_{false};
   ProxygenError proxygenError_{kErrorNone};
 };
 #ifdef _MSC_VER
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/utils/FileRegion.h>
+
+#include <algorithm>
+#include <folly/portability/SysMman.h>
+#include <folly/portability/Unistd.h>
+
+namespace {
+
+// cap single buffers well below IOBuf's capacity limits
+const size_t kMaxSegment = 1ULL << 30;
+
+struct Mapping {
+  void* addr;
+  size_t length;
+};
+
+void unmapRegion(void* /*data*/, void* userData) {
+  auto mapping = static_cast<Mapping*>(userData);
+  ::munmap(mapping->addr, mapping->length);
+  delete mapping;
+}
+
+} // anonymous namespace
+
+namespace proxygen {
+
+std::unique_ptr<folly::IOBuf> FileRegion::mmapRange(int fd,
+                                                    off_t offset,
+                                                    size_t length,
+                                                    bool prefault) {
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  std::unique_ptr<folly::IOBuf> head;
+  while (length > 0) {
+    const size_t segLen = std::min(length, kMaxSegment);
+    const off_t alignedOffset = offset & ~static_cast<off_t>(pageSize - 1);
+    const size_t delta = offset - alignedOffset;
+    const size_t mapLen = segLen + delta;
+    void* addr =
+        ::mmap(nullptr, mapLen, PROT_READ, MAP_SHARED, fd, alignedOffset);
+    if (addr == MAP_FAILED) {
+      // partial mappings unwind through the IOBufs already chained
+      return nullptr;
+    }
+    if (prefault) {
+      ::madvise(addr, mapLen, MADV_WILLNEED);
+      auto p = static_cast<const volatile uint8_t*>(addr);
+      for (size_t i = 0; i < mapLen; i += pageSize) {
+        (void)p[i];
+      }
+    }
+    auto buf = folly::IOBuf::takeOwnership(
+        static_cast<uint8_t*>(addr) + delta,
+        segLen,
+        segLen,
+        unmapRegion,
+        new Mapping{addr, mapLen});
+    if (head) {
+      head->prependChain(std::move(buf));
+    } else {
+      head = std::move(buf);
+    }
+    offset += segLen;
+    length -= segLen;
+  }
+  return head;
+}
+
+} // namespace proxygen
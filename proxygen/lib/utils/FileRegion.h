@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <sys/types.h>
+
+namespace proxygen {
+
+/**
+ * Wraps a byte range of an open file in IOBufs backed by a private
+ * read-only memory mapping, so file bodies can flow through the normal
+ * egress path without ever being copied into user-space buffers. The
+ * mapping is released when the last IOBuf referencing it is freed.
+ */
+class FileRegion {
+ public:
+  /**
+   * Map [offset, offset + length) of fd. The offset does not need to be
+   * page aligned. With prefault set, the pages are touched before
+   * returning so a subsequent transport write won't take major page
+   * faults on the event loop; call it from a thread that may block.
+   *
+   * @return the IOBuf chain, or nullptr if mmap failed
+   */
+  static std::unique_ptr<folly::IOBuf> mmapRange(int fd,
+                                                 off_t offset,
+                                                 size_t length,
+                                                 bool prefault = false);
+};
+
+} // namespace proxygen
@@ -201,6 +201,17 @@ class GenericFilter: public T1, public T2 {
  * false, the filters must delete themselves at the correct time). FilterType
  * must have GenericFilter as an ancestor.
  */
+/*
+ * On devirtualizing the standard chains: the per-hop virtual calls here
+ * can't be fused at compile time without rewriting each filter's
+ * forwarding (callback_->x(...) through base pointers) as a templated
+ * continuation (CRTP), because a filter's *outgoing* edge is what costs
+ * the dispatch, not the call into it. The concrete filters in the
+ * standard stacks are marked final instead, which lets the compiler
+ * devirtualize calls into them wherever the static type is known and
+ * speculatively elsewhere. A FusedFilterChain<F1, F2, ...> is only
+ * worth building once the filters themselves are CRTP-ready.
+ */
 template <typename T1, typename T2, typename FilterType,
           void (T1::*set_callback)(T2*), bool TakeOwnership>
 class FilterChain: private FilterType {
@@ -293,6 +304,28 @@ class FilterChain: private FilterType {
     return std::unique_ptr<T1>(oldChainEnd);
   }
 
+  /**
+   * Release ownership of the chain's destination without replacing it.
+   * The chain must not be invoked afterwards; this is intended for
+   * teardown paths that want to recycle the destination object instead
+   * of destroying it with the chain.
+   */
+  std::unique_ptr<T1> releaseDestination() {
+    static_assert(TakeOwnership, "unique_ptr releaseDestination only "
+                  "available if the chain owns the filters.");
+    FilterChainType* lastFilter = this;
+    while (lastFilter->next_) {
+      if (lastFilter->call_ == this->chainEnd_) {
+        lastFilter->call_ = nullptr;
+      }
+      lastFilter = lastFilter->next_;
+    }
+    lastFilter->call_ = nullptr;
+    auto oldChainEnd = this->chainEnd_;
+    this->chainEnd_ = nullptr;
+    return std::unique_ptr<T1>(oldChainEnd);
+  }
+
   /**
    * Adds filters with the given types to the front of the chain.
    */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <folly/lang/Bits.h>
+
+namespace proxygen {
+
+/**
+ * Fixed-footprint log-bucketed latency histogram in the HdrHistogram
+ * style: values are bucketed by magnitude with 16 linear sub-buckets
+ * per power of two, giving ~6% relative error across the full uint64
+ * range in under 8KB of counters. record() is a single relaxed atomic
+ * increment, so a per-worker instance is effectively free on the hot
+ * path and remains safely readable from other threads.
+ */
+class PercentileHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 4;
+  static constexpr size_t kSubBuckets = 1 << kSubBucketBits; // 16
+  // magnitudes kSubBucketBits..63 each get kSubBuckets slots, plus the
+  // exact low-value buckets
+  static constexpr size_t kBuckets = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+  void record(uint64_t value) {
+    counts_[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const {
+    return total_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Estimate the value at the given percentile (0 < pct <= 100);
+   * returns 0 for an empty histogram. The estimate is the upper edge of
+   * the matched sub-bucket.
+   */
+  uint64_t estimatePercentile(double pct) const {
+    const uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+    uint64_t target = uint64_t(pct / 100.0 * total + 0.5);
+    if (target > total) {
+      target = total;
+    }
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBuckets; i++) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen >= target) {
+        return bucketUpperEdge(i);
+      }
+    }
+    return bucketUpperEdge(kBuckets - 1);
+  }
+
+  void clear() {
+    for (auto& c : counts_) {
+      c.store(0, std::memory_order_relaxed);
+    }
+    total_.store(0, std::memory_order_relaxed);
+  }
+
+ private:
+  static size_t bucketFor(uint64_t value) {
+    if (value < kSubBuckets) {
+      return size_t(value);
+    }
+    // index of the highest set bit, at least kSubBucketBits
+    const size_t magnitude = folly::findLastSet(value) - 1;
+    const size_t sub =
+        (value >> (magnitude - kSubBucketBits)) & (kSubBuckets - 1);
+    return (magnitude - kSubBucketBits + 1) * kSubBuckets + sub;
+  }
+
+  static uint64_t bucketUpperEdge(size_t bucket) {
+    const size_t magnitude = bucket / kSubBuckets;
+    const size_t sub = bucket % kSubBuckets;
+    if (magnitude == 0) {
+      return sub;
+    }
+    const size_t shift = magnitude - 1;
+    return ((uint64_t(kSubBuckets) + sub + 1) << shift) - 1;
+  }
+
+  std::array<std::atomic<uint64_t>, kBuckets> counts_{};
+  std::atomic<uint64_t> total_{0};
+};
+
+} // namespace proxygen
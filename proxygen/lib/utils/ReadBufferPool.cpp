@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/utils/ReadBufferPool.h>
+
+#include <array>
+#include <atomic>
+#include <folly/SingletonThreadLocal.h>
+#include <folly/lang/Bits.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using proxygen::ReadBufferPool;
+
+// size classes: 4K, 8K, ..., 512K
+constexpr uint32_t kMinClassSize = 4096;
+constexpr size_t kNumClasses = 8;
+
+std::atomic<uint32_t> gMaxPooledPerClass{64};
+
+size_t sizeToClass(uint32_t size) {
+  if (size <= kMinClassSize) {
+    return 0;
+  }
+  size_t cls = folly::findLastSet(uint64_t(size - 1)) - 12;
+  return std::min(cls, kNumClasses - 1);
+}
+
+uint32_t classToSize(size_t cls) {
+  return kMinClassSize << cls;
+}
+
+struct PoolState;
+
+/**
+ * Lives at the head of every slab, in front of the buffer bytes. It is
+ * constructed once per slab and survives recycling, so reuse performs
+ * no allocations at all.
+ */
+struct SlabTag {
+  std::weak_ptr<PoolState> pool;
+  std::thread::id owner;
+  size_t sizeClass;
+};
+
+struct PoolState {
+  std::array<std::vector<uint8_t*>, kNumClasses> freeSlabs;
+
+  ~PoolState() {
+    for (auto& cls : freeSlabs) {
+      for (auto slab : cls) {
+        reinterpret_cast<SlabTag*>(slab)->~SlabTag();
+        delete[] slab;
+      }
+    }
+  }
+};
+
+// offset of the buffer bytes within a slab; keeps the data max-aligned
+constexpr size_t kDataOffset =
+    (sizeof(SlabTag) + alignof(std::max_align_t) - 1) &
+    ~(alignof(std::max_align_t) - 1);
+
+struct PoolHolder {
+  std::shared_ptr<PoolState> state{std::make_shared<PoolState>()};
+};
+
+std::shared_ptr<PoolState>& localPool() {
+  struct PoolTag {};
+  return folly::SingletonThreadLocal<PoolHolder, PoolTag>::get().state;
+}
+
+void releaseSlab(void* /*data*/, void* userData) {
+  auto slab = static_cast<uint8_t*>(userData);
+  auto tag = reinterpret_cast<SlabTag*>(slab);
+  if (tag->owner == std::this_thread::get_id()) {
+    if (auto pool = tag->pool.lock()) {
+      auto& cls = pool->freeSlabs[tag->sizeClass];
+      if (cls.size() <
+          gMaxPooledPerClass.load(std::memory_order_relaxed)) {
+        cls.push_back(slab);
+        return;
+      }
+    }
+  }
+  // released off-thread, after thread exit, or the class is full
+  tag->~SlabTag();
+  delete[] slab;
+}
+
+} // anonymous namespace
+
+namespace proxygen {
+
+std::unique_ptr<folly::IOBuf> ReadBufferPool::obtain(uint32_t size) {
+  if (size > classToSize(kNumClasses - 1)) {
+    // too large to pool
+    return folly::IOBuf::create(size);
+  }
+  auto& pool = localPool();
+  const size_t cls = sizeToClass(size);
+  const uint32_t bufSize = classToSize(cls);
+  uint8_t* slab = nullptr;
+  auto& freeList = pool->freeSlabs[cls];
+  if (!freeList.empty()) {
+    slab = freeList.back();
+    freeList.pop_back();
+  } else {
+    slab = new uint8_t[kDataOffset + bufSize];
+    new (slab) SlabTag{pool, std::this_thread::get_id(), cls};
+  }
+  auto buf = folly::IOBuf::takeOwnership(slab + kDataOffset,
+                                         bufSize,
+                                         0 /* length */,
+                                         releaseSlab,
+                                         slab);
+  return buf;
+}
+
+void ReadBufferPool::setMaxPooledPerClass(uint32_t maxBuffers) {
+  gMaxPooledPerClass.store(maxBuffers, std::memory_order_relaxed);
+}
+
+} // namespace proxygen
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+
+namespace proxygen {
+
+/**
+ * Per-thread pool of recycled ingress read buffers.
+ *
+ * Buffers are handed out as ordinary IOBufs; when the last reference is
+ * released on the owning thread, the backing slab goes back on that
+ * thread's free list, so steady-state socket reads allocate nothing.
+ * Buffers released on a different thread (or after their thread exited)
+ * simply free their slab. Slabs are bucketed into power-of-two size
+ * classes so sessions with different read patterns share the pool.
+ */
+class ReadBufferPool {
+ public:
+  /**
+   * Obtain an empty IOBuf with capacity of at least size bytes, reusing
+   * a pooled slab of the matching size class when one is available.
+   */
+  static std::unique_ptr<folly::IOBuf> obtain(uint32_t size);
+
+  /**
+   * Cap on slabs cached per size class per thread (default 64).
+   */
+  static void setMaxPooledPerClass(uint32_t maxBuffers);
+};
+
+} // namespace proxygen
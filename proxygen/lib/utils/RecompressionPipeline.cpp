@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/utils/RecompressionPipeline.h>
+
+#include <folly/io/IOBuf.h>
+
+namespace proxygen {
+
+RecompressionPipeline::RecompressionPipeline(
+    CompressionType ingressType,
+    CompressionType egressType,
+    int egressLevel,
+    std::shared_ptr<const std::string> dictionary)
+    : ingressType_(ingressType),
+      egressType_(egressType),
+      egressLevel_(egressLevel),
+      dictionary_(std::move(dictionary)),
+      decompressor_(ingressType),
+      compressor_(egressType, egressLevel) {
+  applyDictionary();
+}
+
+void RecompressionPipeline::applyDictionary() {
+  if (dictionary_ && !dictionary_->empty()) {
+    // no-op for gzip egress; see setDictionary
+    compressor_.setDictionary(
+        reinterpret_cast<const uint8_t*>(dictionary_->data()),
+        dictionary_->size());
+  }
+}
+
+std::unique_ptr<folly::IOBuf> RecompressionPipeline::transform(
+    const folly::IOBuf* in, bool last) {
+  std::unique_ptr<folly::IOBuf> decompressed;
+  if (in && in->computeChainDataLength() > 0) {
+    decompressed = decompressor_.decompress(in);
+    if (decompressor_.hasError()) {
+      return nullptr;
+    }
+  }
+  // feed the plaintext chunk straight through; an empty chunk with
+  // last=true still flushes the deflate trailer
+  folly::IOBuf empty;
+  auto out =
+      compressor_.compress(decompressed ? decompressed.get() : &empty, last);
+  if (compressor_.hasError()) {
+    return nullptr;
+  }
+  return out;
+}
+
+bool RecompressionPipeline::hasError() {
+  return decompressor_.hasError() || compressor_.hasError();
+}
+
+void RecompressionPipeline::reset() {
+  decompressor_.reset();
+  compressor_.reset();
+  // deflateReset drops any preset dictionary
+  applyDictionary();
+}
+
+} // namespace proxygen
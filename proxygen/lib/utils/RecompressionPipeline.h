@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <proxygen/lib/utils/ZlibStreamCompressor.h>
+#include <proxygen/lib/utils/ZlibStreamDecompressor.h>
+
+namespace folly {
+class IOBuf;
+}
+
+namespace proxygen {
+
+/**
+ * Streaming decompress-then-recompress pipeline for proxy flows that
+ * take origin-compressed bodies and re-emit them at a different level
+ * or format per client.
+ *
+ * Each transform() call inflates one ingress chunk and feeds the
+ * plaintext straight into the deflater, so no more than one chunk of
+ * decompressed data is ever held.  The deflate side draws from the
+ * per-thread context pool (window memory is recycled across messages)
+ * and the inflate window survives reset(), so a long-lived pipeline -
+ * e.g. one per content-type per worker - does no window allocation in
+ * steady state.
+ *
+ * A preset dictionary, shared per content-type by the caller, can be
+ * installed on the egress side; zlib only honors dictionaries for the
+ * DEFLATE format, so it is ignored for gzip egress.
+ */
+class RecompressionPipeline {
+ public:
+  RecompressionPipeline(CompressionType ingressType,
+                        CompressionType egressType,
+                        int egressLevel,
+                        std::shared_ptr<const std::string> dictionary =
+                            nullptr);
+
+  /**
+   * Feed one compressed ingress chunk; returns the recompressed egress
+   * bytes produced so far.  Pass last=true with the final chunk to
+   * flush the deflate stream and emit the trailer.  Returns nullptr
+   * after an error; check hasError().
+   */
+  std::unique_ptr<folly::IOBuf> transform(const folly::IOBuf* in, bool last);
+
+  bool hasError();
+
+  /**
+   * Rewind both sides for the next message, keeping window memory.
+   */
+  void reset();
+
+ private:
+  void applyDictionary();
+
+  CompressionType ingressType_;
+  CompressionType egressType_;
+  int egressLevel_;
+  std::shared_ptr<const std::string> dictionary_;
+  ZlibStreamDecompressor decompressor_;
+  ZlibStreamCompressor compressor_;
+};
+
+} // namespace proxygen
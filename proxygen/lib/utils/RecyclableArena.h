@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <glog/logging.h>
+#include <memory>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * A simple bump allocator intended for objects that share one lifetime,
+ * such as the per-transaction bookkeeping a session creates and throws
+ * away on every request. Individual deallocations are no-ops; all memory
+ * is released wholesale via reset(), which retains the first block so a
+ * recycled arena serves its next owner without touching malloc.
+ *
+ * Not thread-safe; an arena is owned by one transaction/session at a time.
+ */
+class RecyclableArena {
+ public:
+  static constexpr size_t kDefaultBlockSize = 4096;
+
+  explicit RecyclableArena(size_t blockSize = kDefaultBlockSize)
+      : blockSize_(blockSize) {
+  }
+
+  RecyclableArena(const RecyclableArena&) = delete;
+  RecyclableArena& operator=(const RecyclableArena&) = delete;
+
+  void* allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+    size_t offset = (bumpOffset_ + align - 1) & ~(align - 1);
+    if (blocks_.empty() || offset + size > currentBlockSize_) {
+      appendBlock(size);
+      offset = 0;
+    }
+    bumpOffset_ = offset + size;
+    return blocks_.back().get() + offset;
+  }
+
+  /**
+   * Release everything allocated from this arena. Only the first block is
+   * retained for reuse, so a recycled arena holds at most blockSize_ bytes.
+   */
+  void reset() {
+    if (blocks_.size() > 1) {
+      blocks_.erase(blocks_.begin() + 1, blocks_.end());
+    }
+    currentBlockSize_ = firstBlockSize_;
+    bytesAllocated_ = firstBlockSize_;
+    bumpOffset_ = 0;
+  }
+
+  size_t bytesAllocated() const {
+    return bytesAllocated_;
+  }
+
+  /**
+   * STL allocator adaptor so standard containers can draw their nodes from
+   * the arena. deallocate() is a no-op; the memory is reclaimed when the
+   * arena is reset or destroyed.
+   */
+  template <typename T>
+  class Allocator {
+   public:
+    using value_type = T;
+
+    explicit Allocator(RecyclableArena& arena) : arena_(&arena) {
+    }
+
+    template <typename U>
+    /* implicit */ Allocator(const Allocator<U>& other)
+        : arena_(other.arena()) {
+    }
+
+    T* allocate(size_t n) {
+      return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {
+    }
+
+    RecyclableArena* arena() const {
+      return arena_;
+    }
+
+    template <typename U>
+    bool operator==(const Allocator<U>& other) const {
+      return arena_ == other.arena();
+    }
+
+    template <typename U>
+    bool operator!=(const Allocator<U>& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    RecyclableArena* arena_;
+  };
+
+ private:
+  void appendBlock(size_t minSize) {
+    currentBlockSize_ = std::max(blockSize_, minSize);
+    blocks_.emplace_back(new uint8_t[currentBlockSize_]);
+    bytesAllocated_ += currentBlockSize_;
+    if (blocks_.size() == 1) {
+      firstBlockSize_ = currentBlockSize_;
+    }
+    bumpOffset_ = 0;
+  }
+
+  std::vector<std::unique_ptr<uint8_t[]>> blocks_;
+  size_t blockSize_;
+  size_t firstBlockSize_{0};
+  size_t currentBlockSize_{0};
+  size_t bumpOffset_{0};
+  size_t bytesAllocated_{0};
+};
+
+} // namespace proxygen
@@ -13,7 +13,7 @@
 #include <algorithm>
 #include <vector>
 #include <limits>
-#include <math.h>       /* pow */
+#include <cmath>        /* log */
 
 namespace proxygen {
 void RendezvousHash::build(std::vector<std::pair<
@@ -22,6 +22,7 @@ void RendezvousHash::build(std::vector<std::pair<
     std::string key = it->first;
     uint64_t weight = it->second;
     weights_.emplace_back(computeHash(key.c_str(), key.size()), weight);
+    invWeights_.push_back(weight != 0 ? 1.0 / double(weight) : 0);
   }
 }
 
@@ -138,7 +139,8 @@ size_t RendezvousHash::getNthByWeightedHash(
   // optimize if required to return element with max weight, rank ==
   // weights_.size(), keep track of the maxWeightIndex instead of populating
   // scaledWeights array.
-  double maxWeight = -1;
+  // log-domain scores are negative; start below every representable one
+  double maxWeight = -std::numeric_limits<double>::infinity();
   int maxWeightIndex = 0;
 
   std::vector<std::pair<double, size_t>> scaledWeights;
@@ -150,9 +152,15 @@ size_t RendezvousHash::getNthByWeightedHash(
     double combinedHash = computeHash(entry->first + key);
     double scaledHash =
         (double)combinedHash / std::numeric_limits<uint64_t>::max();
-    double scaledWeight = 0;
+    // Score in the log domain: ln(scaledHash) * (1/weight) orders
+    // nodes identically to pow(scaledHash, 1/weight) - ln is strictly
+    // monotonic - but costs a log instead of a pow per node, with the
+    // reciprocal weight precomputed at build time.
+    double scaledWeight;
     if (entry->second != 0) {
-      scaledWeight = pow(scaledHash, (double)1 / entry->second);
+      scaledWeight = std::log(scaledHash) * invWeights_[i];
+    } else {
+      scaledWeight = -std::numeric_limits<double>::infinity();
     }
     if (modRank == 0) {
       if (scaledWeight > maxWeight) {
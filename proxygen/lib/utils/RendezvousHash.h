@@ -40,6 +40,8 @@ class RendezvousHash : public ConsistentHash {
   uint64_t computeHash(uint64_t i) const;
 
   std::vector<std::pair<uint64_t, uint64_t>> weights_;
+  // 1/weight per node, precomputed at build time for the score loop
+  std::vector<double> invWeights_;
 };
 
 } // proxygen
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/utils/SpillBuffer.h>
+
+#include <fcntl.h>
+#include <folly/portability/Unistd.h>
+#include <glog/logging.h>
+
+namespace proxygen {
+
+SpillBuffer::SpillBuffer(std::string dir) : dir_(std::move(dir)) {
+}
+
+SpillBuffer::~SpillBuffer() {
+  if (fd_ >= 0) {
+    ::close(fd_);
+  }
+}
+
+bool SpillBuffer::ensureFile() {
+  if (fd_ >= 0) {
+    return true;
+  }
+  if (error_) {
+    return false;
+  }
+#ifdef O_TMPFILE
+  fd_ = ::open(dir_.c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+#endif
+  if (fd_ < 0) {
+    // O_TMPFILE unsupported (filesystem or platform): named + unlinked
+    auto path = dir_ + "/proxygen-spill-XXXXXX";
+    fd_ = ::mkstemp(&path[0]);
+    if (fd_ >= 0) {
+      ::unlink(path.c_str());
+    }
+  }
+  if (fd_ < 0) {
+    PLOG(ERROR) << "Failed to create spill file in " << dir_;
+    error_ = true;
+    return false;
+  }
+  return true;
+}
+
+bool SpillBuffer::append(const folly::IOBuf& chain) {
+  if (!ensureFile()) {
+    return false;
+  }
+  uint64_t offset = writeOffset_;
+  const folly::IOBuf* current = &chain;
+  do {
+    const uint8_t* data = current->data();
+    size_t remaining = current->length();
+    while (remaining > 0) {
+      auto written = ::pwrite(fd_, data, remaining, offset);
+      if (written < 0) {
+        PLOG(ERROR) << "Spill write failed";
+        error_ = true;
+        // writeOffset_ untouched: the partial bytes are dead and will
+        // be overwritten if the caller retries after clearing state
+        return false;
+      }
+      data += written;
+      remaining -= written;
+      offset += written;
+    }
+    current = current->next();
+  } while (current != &chain);
+  writeOffset_ = offset;
+  return true;
+}
+
+std::unique_ptr<folly::IOBuf> SpillBuffer::splitAtMost(size_t len) {
+  auto available = bytes();
+  if (available == 0 || error_) {
+    return nullptr;
+  }
+  len = std::min<uint64_t>(len, available);
+  auto buf = folly::IOBuf::create(len);
+  uint8_t* data = buf->writableTail();
+  size_t remaining = len;
+  uint64_t offset = readOffset_;
+  while (remaining > 0) {
+    auto bytesRead = ::pread(fd_, data, remaining, offset);
+    if (bytesRead <= 0) {
+      PLOG(ERROR) << "Spill read failed";
+      error_ = true;
+      return nullptr;
+    }
+    data += bytesRead;
+    remaining -= bytesRead;
+    offset += bytesRead;
+  }
+  buf->append(len);
+  readOffset_ = offset;
+  if (readOffset_ == writeOffset_) {
+    // fully drained; reclaim the space
+    if (::ftruncate(fd_, 0) == 0) {
+      readOffset_ = 0;
+      writeOffset_ = 0;
+    }
+  }
+  return buf;
+}
+
+} // namespace proxygen
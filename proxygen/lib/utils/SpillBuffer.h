@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <folly/io/IOBuf.h>
+#include <memory>
+#include <string>
+
+namespace proxygen {
+
+/**
+ * Disk-backed FIFO overflow buffer.  Bytes are appended to an unlinked
+ * temp file (O_TMPFILE, with a mkstemp+unlink fallback) and read back
+ * in order; when fully drained the file is truncated so a long-lived
+ * buffer reclaims its space.  The file is opened lazily on the first
+ * append, so an enabled-but-never-needed spill costs nothing.
+ *
+ * I/O is synchronous pread/pwrite on the caller's thread - page cache
+ * absorbs the common case; the point is converting unbounded memory
+ * growth into disk, not hiding disk latency.  On any I/O error the
+ * buffer latches hasError() and append() returns false without
+ * consuming data, letting the caller fall back to memory.
+ */
+class SpillBuffer {
+ public:
+  explicit SpillBuffer(std::string dir = "/tmp");
+  ~SpillBuffer();
+
+  SpillBuffer(const SpillBuffer&) = delete;
+  SpillBuffer& operator=(const SpillBuffer&) = delete;
+
+  /**
+   * Append the chain's bytes.  Returns false (and does not advance the
+   * write offset) on I/O error; the caller still owns its chain.
+   */
+  bool append(const folly::IOBuf& chain);
+
+  /**
+   * Read and consume up to len bytes from the front; nullptr when
+   * empty or on error.
+   */
+  std::unique_ptr<folly::IOBuf> splitAtMost(size_t len);
+
+  uint64_t bytes() const {
+    return writeOffset_ - readOffset_;
+  }
+
+  bool empty() const {
+    return bytes() == 0;
+  }
+
+  bool hasError() const {
+    return error_;
+  }
+
+ private:
+  bool ensureFile();
+
+  std::string dir_;
+  int fd_{-1};
+  uint64_t readOffset_{0};
+  uint64_t writeOffset_{0};
+  bool error_{false};
+};
+
+} // namespace proxygen
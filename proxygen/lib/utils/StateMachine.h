@@ -57,6 +57,58 @@ class StateMachine {
  * invalid transition is represented by storing a max value instead of
  * S2 index.
  */
+/**
+ * Compile-time variant of TransitionTable: the [NStates x NEvents]
+ * matrix is a constexpr array built entirely at compile time, so the
+ * machines carry no static-init cost and find() is a bounds check plus
+ * one array load. Invalid transitions hold 0xff. Tables can be
+ * validated with static_asserts on find().
+ */
+template <class State, class Event, size_t NStates, size_t NEvents>
+class ConstexprTransitionTable {
+ public:
+  struct Transition {
+    State from;
+    Event event;
+    State to;
+  };
+
+  template <size_t NTransitions>
+  explicit constexpr ConstexprTransitionTable(
+      const Transition (&transitions)[NTransitions])
+      : transitions_{} {
+    static_assert(NStates < 0xff, "state index must fit a uint8_t");
+    for (size_t i = 0; i < NStates * NEvents; i++) {
+      transitions_[i] = kInvalid;
+    }
+    for (size_t i = 0; i < NTransitions; i++) {
+      transitions_[index(transitions[i].from, transitions[i].event)] =
+          static_cast<uint8_t>(transitions[i].to);
+    }
+  }
+
+  constexpr std::pair<State, bool> find(State s, Event e) const {
+    if (static_cast<size_t>(s) >= NStates ||
+        static_cast<size_t>(e) >= NEvents) {
+      return std::pair<State, bool>(s, false);
+    }
+    const uint8_t result = transitions_[index(s, e)];
+    if (result == kInvalid) {
+      return std::pair<State, bool>(s, false);
+    }
+    return std::pair<State, bool>(State(result), true);
+  }
+
+ private:
+  static constexpr uint8_t kInvalid = 0xff;
+
+  static constexpr size_t index(State s, Event e) {
+    return static_cast<size_t>(s) * NEvents + static_cast<size_t>(e);
+  }
+
+  uint8_t transitions_[NStates * NEvents];
+};
+
 template <class State, class Event>
 class TransitionTable  {
  private:
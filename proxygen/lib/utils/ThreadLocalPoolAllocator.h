@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * STL allocator that recycles single-object allocations through a
+ * per-thread free list, for node-based containers whose nodes churn
+ * with request traffic (e.g. a session's transaction map): steady
+ * state stops paying malloc/free per insert/erase.  Bulk allocations
+ * (bucket arrays) pass straight through to operator new.  All
+ * instances of one T share a thread's pool; the pool is capped so a
+ * burst doesn't pin its high-water mark.
+ */
+template <typename T>
+class ThreadLocalPoolAllocator {
+ public:
+  using value_type = T;
+
+  ThreadLocalPoolAllocator() = default;
+
+  template <typename U>
+  /* implicit */ ThreadLocalPoolAllocator(
+      const ThreadLocalPoolAllocator<U>&) noexcept {
+  }
+
+  T* allocate(size_t n) {
+    if (n == 1) {
+      auto& free = pool();
+      if (!free.empty()) {
+        auto ptr = free.back();
+        free.pop_back();
+        return static_cast<T*>(ptr);
+      }
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* ptr, size_t n) {
+    if (n == 1) {
+      auto& free = pool();
+      if (free.size() < kPoolLimit) {
+        free.push_back(ptr);
+        return;
+      }
+    }
+    ::operator delete(ptr);
+  }
+
+  template <typename U>
+  bool operator==(const ThreadLocalPoolAllocator<U>&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const ThreadLocalPoolAllocator<U>&) const noexcept {
+    return false;
+  }
+
+ private:
+  static constexpr size_t kPoolLimit = 256;
+
+  static std::vector<void*>& pool() {
+    struct Pool {
+      std::vector<void*> free;
+      ~Pool() {
+        for (auto ptr : free) {
+          ::operator delete(ptr);
+        }
+      }
+    };
+    static thread_local Pool pool;
+    return pool.free;
+  }
+};
+
+} // namespace proxygen
@@ -13,6 +13,30 @@
 
 namespace proxygen {
 
+namespace {
+
+struct CachedNow {
+  TimePoint value;
+  bool installed{false};
+};
+
+thread_local CachedNow cachedNow;
+
+} // anonymous namespace
+
+TimePoint getCachedNow() {
+  if (cachedNow.installed) {
+    return cachedNow.value;
+  }
+  return getCurrentTime<SteadyClock>();
+}
+
+TimePoint refreshCachedNow() {
+  cachedNow.installed = true;
+  cachedNow.value = getCurrentTime<SteadyClock>();
+  return cachedNow.value;
+}
+
 std::string getDateTimeStr(const ASN1_TIME* const time) {
   if (!time) {
     return "";
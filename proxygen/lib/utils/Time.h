@@ -41,6 +41,24 @@ inline std::chrono::time_point<ClockType> getCurrentTime() {
   return ClockType::now();
 }
 
+/**
+ * Event-loop-cached clock.  An event loop that opts in (see
+ * WorkerThread::enableCachedNow) refreshes the thread's cached
+ * TimePoint once per loop iteration; timestamp consumers that only
+ * need iteration granularity - last-activity tracking, timeout
+ * refreshes, stats - read it without a clock_gettime per call.  On
+ * threads with no refresher installed, getCachedNow() falls back to a
+ * live read.  Long-running callbacks can call refreshCachedNow()
+ * mid-iteration when they need a tighter bound.
+ */
+TimePoint getCachedNow();
+
+/**
+ * Refresh (and install, on first call for this thread) the cached
+ * now.  Returns the fresh value.
+ */
+TimePoint refreshCachedNow();
+
 inline std::chrono::system_clock::time_point
 toSystemTimePoint(TimePoint t) {
   return std::chrono::system_clock::now() +
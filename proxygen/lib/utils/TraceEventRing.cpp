@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/utils/TraceEventRing.h>
+
+#include <chrono>
+#include <folly/lang/Bits.h>
+
+namespace proxygen {
+
+TraceEventRing::TraceEventRing(size_t capacity)
+    : mask_(folly::nextPowTwo(std::max<size_t>(capacity, 2)) - 1),
+      records_(mask_ + 1) {
+}
+
+void TraceEventRing::traceEventAvailable(TraceEvent event) noexcept {
+  const auto rate = sampleOneInN_.load(std::memory_order_relaxed);
+  if (rate == 0) {
+    return;
+  }
+  if (rate > 1 && ++sampleCounter_ % rate != 0) {
+    return;
+  }
+  const auto head = head_.load(std::memory_order_relaxed);
+  const auto tail = tail_.load(std::memory_order_acquire);
+  if (head - tail >= records_.size()) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  auto& record = records_[head & mask_];
+  record.type = event.getType();
+  record.id = event.getID();
+  record.parentId = event.getParentID();
+  record.startUsec = std::chrono::duration_cast<std::chrono::microseconds>(
+                         event.getStartTime().time_since_epoch())
+                         .count();
+  record.endUsec = std::chrono::duration_cast<std::chrono::microseconds>(
+                       event.getEndTime().time_since_epoch())
+                       .count();
+  head_.store(head + 1, std::memory_order_release);
+}
+
+void TraceEventRing::drain(folly::FunctionRef<void(const Record&)> fn) {
+  auto tail = tail_.load(std::memory_order_relaxed);
+  const auto head = head_.load(std::memory_order_acquire);
+  while (tail != head) {
+    fn(records_[tail & mask_]);
+    tail++;
+  }
+  tail_.store(tail, std::memory_order_release);
+}
+
+} // namespace proxygen
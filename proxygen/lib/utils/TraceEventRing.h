@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <folly/Function.h>
+#include <proxygen/lib/utils/TraceEventObserver.h>
+#include <vector>
+
+namespace proxygen {
+
+/**
+ * Always-on tracing backend: a fixed-size SPSC ring of POD-encoded
+ * trace records. The producer side is the worker thread's trace
+ * observer path - recording an event is a sampling check plus one
+ * record store and a release publish, with no allocation and no
+ * locks; when the ring is full new records are dropped and counted.
+ * The consumer side is an external scraper draining from another
+ * thread via drain().
+ *
+ * One instance per worker; single producer, single consumer.
+ */
+class TraceEventRing : public TraceEventObserver {
+ public:
+  /**
+   * POD projection of a TraceEvent: the timeline fields without the
+   * dynamic metadata map.
+   */
+  struct Record {
+    TraceEventType type;
+    uint32_t id;
+    uint32_t parentId;
+    int64_t startUsec;
+    int64_t endUsec;
+  };
+
+  /**
+   * capacity is rounded up to a power of two records.
+   */
+  explicit TraceEventRing(size_t capacity);
+
+  /**
+   * Record one in sampleOneInN events (1 = every event, 0 = none).
+   */
+  void setSampleRate(uint32_t sampleOneInN) {
+    sampleOneInN_.store(sampleOneInN, std::memory_order_relaxed);
+  }
+
+  // TraceEventObserver
+  void traceEventAvailable(TraceEvent event) noexcept override;
+
+  /**
+   * Consume all published records, invoking fn on each in publish
+   * order. Call from the single scraper thread.
+   */
+  void drain(folly::FunctionRef<void(const Record&)> fn);
+
+  uint64_t numDropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  const size_t mask_;
+  std::vector<Record> records_;
+  std::atomic<uint64_t> head_{0}; // next write slot (producer)
+  std::atomic<uint64_t> tail_{0}; // next read slot (consumer)
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint32_t> sampleOneInN_{1};
+  uint32_t sampleCounter_{0}; // producer-thread only
+};
+
+} // namespace proxygen
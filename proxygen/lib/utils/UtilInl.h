@@ -9,9 +9,33 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/lang/Bits.h>
 
 namespace proxygen {
 
+/**
+ * Branch-free byte classification over 8-byte words, used by the bulk
+ * scanning paths in the parsers and validators. Each helper returns a
+ * word with 0x80 set in every lane that matched, 0 if nothing matched.
+ */
+namespace swar {
+
+constexpr uint64_t kOnes = 0x0101010101010101ULL;
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+// lanes with byte value strictly less than n; only valid for n <= 128
+inline uint64_t bytesLessThan(uint64_t w, uint8_t n) {
+  return (w - kOnes * n) & ~w & kHighBits;
+}
+
+// lanes with byte value equal to n
+inline uint64_t bytesEqual(uint64_t w, uint8_t n) {
+  uint64_t x = w ^ (kOnes * n);
+  return (x - kOnes) & ~x & kHighBits;
+}
+
+} // namespace swar
+
 // Case-insensitive string comparison
 inline bool caseInsensitiveEqual(folly::StringPiece s, folly::StringPiece t) {
   if (s.size() != t.size()) {
@@ -46,15 +70,106 @@ inline bool caseUnderscoreInsensitiveEqual(
 }
 
 inline bool validateURL(folly::ByteRange url) {
-  for (auto p: url) {
-    if (p <= 0x20 || p == 0x7f) {
+  const uint8_t* p = url.begin();
+  const uint8_t* end = url.end();
+  // bulk path: reject controls, unescaped spaces and DEL, 32 bytes per
+  // branch, then word-at-a-time
+  auto classify = [](uint64_t w) {
+    return swar::bytesLessThan(w, 0x21) | swar::bytesEqual(w, 0x7f);
+  };
+  while (p + 4 * sizeof(uint64_t) <= end) {
+    uint64_t mask = classify(folly::loadUnaligned<uint64_t>(p));
+    mask |= classify(folly::loadUnaligned<uint64_t>(p + 8));
+    mask |= classify(folly::loadUnaligned<uint64_t>(p + 16));
+    mask |= classify(folly::loadUnaligned<uint64_t>(p + 24));
+    if (mask != 0) {
+      return false;
+    }
+    p += 4 * sizeof(uint64_t);
+  }
+  while (p + sizeof(uint64_t) <= end) {
+    if (classify(folly::loadUnaligned<uint64_t>(p)) != 0) {
+      return false;
+    }
+    p += sizeof(uint64_t);
+  }
+  for (; p != end; ++p) {
+    if (*p <= 0x20 || *p == 0x7f) {
       // no controls or unescaped spaces
       return false;
-      }
+    }
   }
   return true;
 }
 
+/**
+ * Percent-decode a URL component without touching clean input: when
+ * the piece contains no '%' (checked a word at a time), the input
+ * piece itself is returned and the scratch is untouched - the common
+ * unencoded case costs a scan and no allocation.  Otherwise the
+ * decoded bytes are written into scratch and a piece of it is
+ * returned; malformed escapes (truncated or non-hex) pass through
+ * literally, matching lenient URL handling elsewhere.
+ */
+inline folly::StringPiece decodePercent(folly::StringPiece input,
+                                        std::string& scratch) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(input.begin());
+  const uint8_t* end = reinterpret_cast<const uint8_t*>(input.end());
+  const uint8_t* firstEscape = nullptr;
+  while (p + sizeof(uint64_t) <= end && !firstEscape) {
+    uint64_t mask =
+        swar::bytesEqual(folly::loadUnaligned<uint64_t>(p), '%');
+    if (mask != 0) {
+      firstEscape = p + (folly::findFirstSet(mask) - 1) / 8;
+      break;
+    }
+    p += sizeof(uint64_t);
+  }
+  if (!firstEscape) {
+    for (; p != end; ++p) {
+      if (*p == '%') {
+        firstEscape = p;
+        break;
+      }
+    }
+  }
+  if (!firstEscape) {
+    return input;
+  }
+
+  auto hexValue = [](uint8_t c) -> int {
+    if (c >= '0' && c <= '9') {
+      return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+      return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+      return c - 'A' + 10;
+    }
+    return -1;
+  };
+
+  scratch.clear();
+  scratch.reserve(input.size());
+  scratch.append(input.begin(),
+                 reinterpret_cast<const char*>(firstEscape));
+  for (p = firstEscape; p != end;) {
+    if (*p == '%' && end - p >= 3) {
+      const int hi = hexValue(p[1]);
+      const int lo = hexValue(p[2]);
+      if (hi >= 0 && lo >= 0) {
+        scratch.push_back(char((hi << 4) | lo));
+        p += 3;
+        continue;
+      }
+    }
+    scratch.push_back(char(*p));
+    ++p;
+  }
+  return scratch;
+}
+
 inline size_t findLastOf(folly::StringPiece sp, char c) {
   size_t pos = sp.size();
   while (--pos != std::string::npos && sp[pos] != c) {
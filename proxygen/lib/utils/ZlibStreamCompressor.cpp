@@ -8,8 +8,10 @@
 
 #include "proxygen/lib/utils/ZlibStreamCompressor.h"
 
+#include <folly/SingletonThreadLocal.h>
 #include <folly/lang/Bits.h>
 #include <folly/io/Cursor.h>
+#include <vector>
 
 using folly::IOBuf;
 
@@ -45,6 +47,40 @@ int deflateHelper(z_stream* stream, IOBuf* out, int flush) {
 }
 }
 
+struct ZlibStreamCompressor::Context {
+  z_stream stream;
+  CompressionType type;
+  int level;
+
+  ~Context() {
+    deflateEnd(&stream);
+  }
+};
+
+namespace {
+
+// per-thread pool of recycled deflate contexts
+constexpr size_t kMaxPooledContexts = 8;
+
+using ContextPtr = std::unique_ptr<ZlibStreamCompressor::Context,
+                                   ZlibStreamCompressor::ContextDeleter>;
+
+std::vector<ContextPtr>& localContextPool() {
+  struct PoolTag {};
+  return folly::SingletonThreadLocal<std::vector<ContextPtr>, PoolTag>::get();
+}
+
+} // anonymous namespace
+
+void ZlibStreamCompressor::ContextDeleter::operator()(
+    Context* context) const {
+  delete context;
+}
+
+z_stream& ZlibStreamCompressor::stream() {
+  return context_->stream;
+}
+
 void ZlibStreamCompressor::init(CompressionType type, int32_t level) {
 
   DCHECK(type_ == CompressionType::NONE)
@@ -54,24 +90,43 @@ void ZlibStreamCompressor::init(CompressionType type, int32_t level) {
   level_ = level;
   status_ = Z_OK;
 
-  zlibStream_.zalloc = Z_NULL;
-  zlibStream_.zfree = Z_NULL;
-  zlibStream_.opaque = Z_NULL;
-  zlibStream_.total_in = 0;
-  zlibStream_.next_in = Z_NULL;
-  zlibStream_.avail_in = 0;
-  zlibStream_.avail_out = 0;
-  zlibStream_.next_out = Z_NULL;
-
   DCHECK(level_ == Z_DEFAULT_COMPRESSION ||
          (level_ >= Z_NO_COMPRESSION && level_ <= Z_BEST_COMPRESSION))
       << "Invalid Zlib compression level. level=" << level_;
 
+  // reuse a pooled context with matching parameters when available;
+  // deflateReset keeps its allocations
+  auto& pool = localContextPool();
+  for (auto it = pool.begin(); it != pool.end(); ++it) {
+    if ((*it)->type == type_ && (*it)->level == level_) {
+      context_ = std::move(*it);
+      pool.erase(it);
+      status_ = deflateReset(&stream());
+      if (status_ != Z_OK) {
+        LOG(ERROR) << "error resetting pooled zlib stream. r=" << status_;
+      }
+      return;
+    }
+  }
+
+  context_ = ContextPtr(new Context());
+  context_->type = type_;
+  context_->level = level_;
+  auto& zlibStream = stream();
+  zlibStream.zalloc = Z_NULL;
+  zlibStream.zfree = Z_NULL;
+  zlibStream.opaque = Z_NULL;
+  zlibStream.total_in = 0;
+  zlibStream.next_in = Z_NULL;
+  zlibStream.avail_in = 0;
+  zlibStream.avail_out = 0;
+  zlibStream.next_out = Z_NULL;
+
   switch (type_) {
     case CompressionType::GZIP: {
       auto windowBits = type_ == CompressionType::GZIP ? GZIP_WINDOW_BITS
                                                        : DEFLATE_WINDOW_BITS;
-      status_ = deflateInit2(&zlibStream_,
+      status_ = deflateInit2(&zlibStream,
                              level_,
                              Z_DEFLATED,
                              windowBits,
@@ -79,7 +134,7 @@ void ZlibStreamCompressor::init(CompressionType type, int32_t level) {
                              Z_DEFAULT_STRATEGY);
     } break;
     case CompressionType::DEFLATE:
-      status_ = deflateInit(&zlibStream_, level);
+      status_ = deflateInit(&zlibStream, level);
       break;
     default:
       DCHECK(false) << "Unsupported zlib compression type.";
@@ -97,9 +152,28 @@ ZlibStreamCompressor::ZlibStreamCompressor(CompressionType type, int level)
 }
 
 ZlibStreamCompressor::~ZlibStreamCompressor() {
-  if (type_ != CompressionType::NONE) {
-    status_ = deflateEnd(&zlibStream_);
+  if (type_ != CompressionType::NONE && context_) {
+    // errored contexts are not worth keeping; healthy ones go back to
+    // the pool for the next response
+    auto& pool = localContextPool();
+    if (!hasError() && pool.size() < kMaxPooledContexts) {
+      pool.push_back(std::move(context_));
+    }
+  }
+}
+
+void ZlibStreamCompressor::reset() {
+  DCHECK(type_ != CompressionType::NONE) << "Must be initialized";
+  status_ = deflateReset(&stream());
+}
+
+bool ZlibStreamCompressor::setDictionary(const uint8_t* dictionary,
+                                         size_t size) {
+  if (type_ != CompressionType::DEFLATE) {
+    return false;
   }
+  status_ = deflateSetDictionary(&stream(), dictionary, (uInt)size);
+  return status_ == Z_OK;
 }
 
 // Compress an IOBuf chain. Compress can be called multiple times and the
@@ -108,23 +182,24 @@ ZlibStreamCompressor::~ZlibStreamCompressor() {
 std::unique_ptr<IOBuf> ZlibStreamCompressor::compress(const IOBuf* in,
                                                       bool trailer) {
   auto bufferLength = FLAGS_zlib_compressor_buffer_growth;
+  auto& zlibStream = stream();
 
-  auto out = addOutputBuffer(&zlibStream_, bufferLength);
+  auto out = addOutputBuffer(&zlibStream, bufferLength);
 
   for (auto& range : *in) {
     uint64_t remaining = range.size();
     uint64_t written = 0;
     while (remaining) {
       uint32_t step = remaining;
-      zlibStream_.next_in = const_cast<uint8_t*>(range.data() + written);
-      zlibStream_.avail_in = step;
+      zlibStream.next_in = const_cast<uint8_t*>(range.data() + written);
+      zlibStream.avail_in = step;
       remaining -= step;
       written += step;
 
-      while (zlibStream_.avail_in != 0) {
-        status_ = deflateHelper(&zlibStream_, out.get(), Z_NO_FLUSH);
+      while (zlibStream.avail_in != 0) {
+        status_ = deflateHelper(&zlibStream, out.get(), Z_NO_FLUSH);
         if (status_ != Z_OK) {
-          DLOG(FATAL) << "Deflate failed: " << zlibStream_.msg;
+          DLOG(FATAL) << "Deflate failed: " << zlibStream.msg;
           return nullptr;
         }
       }
@@ -133,28 +208,28 @@ std::unique_ptr<IOBuf> ZlibStreamCompressor::compress(const IOBuf* in,
 
   if (trailer) {
     do {
-      status_ = deflateHelper(&zlibStream_, out.get(), Z_FINISH);
+      status_ = deflateHelper(&zlibStream, out.get(), Z_FINISH);
     } while (status_ == Z_OK);
 
     if (status_ != Z_STREAM_END) {
-      DLOG(FATAL) << "Deflate failed: " << zlibStream_.msg;
+      DLOG(FATAL) << "Deflate failed: " << zlibStream.msg;
       return nullptr;
     }
   } else {
     do {
-      status_ = deflateHelper(&zlibStream_, out.get(), Z_SYNC_FLUSH);
-    } while (zlibStream_.avail_out == 0);
+      status_ = deflateHelper(&zlibStream, out.get(), Z_SYNC_FLUSH);
+    } while (zlibStream.avail_out == 0);
 
     if (status_ != Z_OK) {
-      DLOG(FATAL) << "Deflate failed: " << zlibStream_.msg;
+      DLOG(FATAL) << "Deflate failed: " << zlibStream.msg;
       return nullptr;
     }
   }
 
-  out->prev()->trimEnd(zlibStream_.avail_out);
+  out->prev()->trimEnd(zlibStream.avail_out);
 
-  zlibStream_.next_out = Z_NULL;
-  zlibStream_.avail_out = 0;
+  zlibStream.next_out = Z_NULL;
+  zlibStream.avail_out = 0;
 
   return out;
 }
@@ -30,9 +30,30 @@ class ZlibStreamCompressor : public StreamCompressor {
 
   void init(CompressionType type, int level);
 
+  // Pooled deflate state; matching (type, level) contexts are recycled
+  // through a per-thread pool via deflateReset, so steady-state
+  // construction skips deflateInit's ~270KB of allocations.
+  struct Context;
+  struct ContextDeleter {
+    void operator()(Context* context) const;
+  };
+
   std::unique_ptr<folly::IOBuf> compress(const folly::IOBuf* in,
                                          bool trailer = true) override;
 
+  /**
+   * Install a preset dictionary.  Only valid before any data has been
+   * compressed, and only for DEFLATE - the gzip format has no preset
+   * dictionary support.  Returns false if zlib rejects it.
+   */
+  bool setDictionary(const uint8_t* dictionary, size_t size);
+
+  /**
+   * Rewind to the start-of-stream state, keeping the deflate window
+   * allocation.  Any preset dictionary must be re-installed.
+   */
+  void reset();
+
   int getStatus() { return status_; }
 
   bool hasError() override {
@@ -42,9 +63,11 @@ class ZlibStreamCompressor : public StreamCompressor {
   bool finished() { return status_ == Z_STREAM_END; }
 
  private:
+  z_stream& stream();
+
   CompressionType type_{CompressionType::NONE};
   int level_{Z_DEFAULT_COMPRESSION};
-  z_stream zlibStream_;
+  std::unique_ptr<Context, ContextDeleter> context_;
   int status_{-1};
 };
 }
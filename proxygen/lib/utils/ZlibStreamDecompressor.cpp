@@ -44,6 +44,11 @@ ZlibStreamDecompressor::ZlibStreamDecompressor(
   init(type);
 }
 
+void ZlibStreamDecompressor::reset() {
+  DCHECK(type_ != CompressionType::NONE) << "Must be initialized";
+  status_ = inflateReset(&zlibStream_);
+}
+
 ZlibStreamDecompressor::~ZlibStreamDecompressor() {
   if (type_ != CompressionType::NONE) {
     status_ = inflateEnd(&zlibStream_);
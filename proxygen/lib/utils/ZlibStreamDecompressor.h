@@ -47,6 +47,12 @@ class ZlibStreamDecompressor : public StreamDecompressor {
 
   std::unique_ptr<folly::IOBuf> decompress(const folly::IOBuf* in) override;
 
+  /**
+   * Rewind to the start-of-stream state, keeping the inflate window
+   * allocation, so the decompressor can be reused for the next message.
+   */
+  void reset();
+
   int getStatus() {
     return status_;
   }
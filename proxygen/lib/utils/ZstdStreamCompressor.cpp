@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <proxygen/lib/utils/ZstdStreamCompressor.h>
+
+#include <folly/SingletonThreadLocal.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBuf.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t kMaxPooledContexts = 8;
+
+std::vector<ZSTD_CStream*>& localContextPool() {
+  struct PoolTag {};
+  struct Pool {
+    std::vector<ZSTD_CStream*> contexts;
+    ~Pool() {
+      for (auto cstream : contexts) {
+        ZSTD_freeCStream(cstream);
+      }
+    }
+  };
+  return folly::SingletonThreadLocal<Pool, PoolTag>::get().contexts;
+}
+
+ZSTD_CStream* obtainCStream() {
+  auto& pool = localContextPool();
+  if (!pool.empty()) {
+    auto cstream = pool.back();
+    pool.pop_back();
+    return cstream;
+  }
+  return ZSTD_createCStream();
+}
+
+void recycleCStream(ZSTD_CStream* cstream) {
+  if (cstream == nullptr) {
+    return;
+  }
+  auto& pool = localContextPool();
+  if (pool.size() < kMaxPooledContexts) {
+    pool.push_back(cstream);
+  } else {
+    ZSTD_freeCStream(cstream);
+  }
+}
+
+} // anonymous namespace
+
+namespace proxygen {
+
+ZstdStreamCompressor::ZstdStreamCompressor(
+    int level, std::shared_ptr<folly::IOBuf> dictionary)
+    : cstream_(obtainCStream()) {
+  if (cstream_ == nullptr) {
+    error_ = true;
+    return;
+  }
+  size_t rc;
+  if (dictionary) {
+    auto dict = dictionary->coalesce();
+    rc = ZSTD_initCStream_usingDict(
+        cstream_, dict.data(), dict.size(), level);
+  } else {
+    rc = ZSTD_initCStream(cstream_, level);
+  }
+  if (ZSTD_isError(rc)) {
+    error_ = true;
+  }
+}
+
+ZstdStreamCompressor::~ZstdStreamCompressor() {
+  recycleCStream(cstream_);
+}
+
+std::unique_ptr<folly::IOBuf> ZstdStreamCompressor::compress(
+    const folly::IOBuf* in, bool trailer) {
+  if (hasError()) {
+    return nullptr;
+  }
+
+  const size_t outBufAllocSize = ZSTD_CStreamOutSize();
+  auto out = folly::IOBuf::create(outBufAllocSize);
+  auto appender = folly::io::Appender(out.get(), outBufAllocSize);
+
+  for (const folly::ByteRange range : *in) {
+    if (range.data() == nullptr) {
+      continue;
+    }
+    ZSTD_inBuffer ibuf = {range.data(), range.size(), 0};
+    while (ibuf.pos < ibuf.size) {
+      appender.ensure(outBufAllocSize);
+      ZSTD_outBuffer obuf = {appender.writableData(), appender.length(), 0};
+      auto ret = ZSTD_compressStream(cstream_, &obuf, &ibuf);
+      if (ZSTD_isError(ret)) {
+        error_ = true;
+        return nullptr;
+      }
+      appender.append(obuf.pos);
+    }
+  }
+
+  // flush what's buffered; with trailer also write the frame epilogue
+  while (true) {
+    appender.ensure(outBufAllocSize);
+    ZSTD_outBuffer obuf = {appender.writableData(), appender.length(), 0};
+    auto remaining = trailer ? ZSTD_endStream(cstream_, &obuf)
+                             : ZSTD_flushStream(cstream_, &obuf);
+    if (ZSTD_isError(remaining)) {
+      error_ = true;
+      return nullptr;
+    }
+    appender.append(obuf.pos);
+    if (remaining == 0) {
+      break;
+    }
+  }
+  return out;
+}
+
+} // namespace proxygen
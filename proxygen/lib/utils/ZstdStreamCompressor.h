@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+// Dictionary-aware streaming init lives in the static-linking section
+#ifndef ZSTD_STATIC_LINKING_ONLY
+#define ZSTD_STATIC_LINKING_ONLY
+#endif
+
+#include <memory>
+#include <zstd.h>
+
+#include <folly/io/IOBuf.h>
+
+#include <proxygen/lib/utils/StreamCompressor.h>
+
+namespace proxygen {
+
+/**
+ * Streaming zstd compressor implementing the StreamCompressor
+ * interface. ZSTD_CStream contexts are recycled through a per-thread
+ * pool (re-initialized per response), so steady-state construction
+ * performs no context allocations.
+ */
+class ZstdStreamCompressor : public StreamCompressor {
+ public:
+  static constexpr int kDefaultLevel = 3;
+
+  /**
+   * An optional pre-trained dictionary improves ratios on small
+   * responses; the same dictionary must be configured on the
+   * decompressing peer. It is applied per response on top of the
+   * pooled context.
+   */
+  explicit ZstdStreamCompressor(int level = kDefaultLevel,
+                                std::shared_ptr<folly::IOBuf> dictionary =
+                                    nullptr);
+
+  ~ZstdStreamCompressor() override;
+
+  // May return nullptr on error.
+  std::unique_ptr<folly::IOBuf> compress(const folly::IOBuf* in,
+                                         bool trailer = true) override;
+
+  bool hasError() override {
+    return error_;
+  }
+
+ private:
+  // drawn from / returned to the per-thread pool
+  ZSTD_CStream* cstream_{nullptr};
+  bool error_{false};
+};
+
+} // namespace proxygen
@@ -57,6 +57,31 @@ TEST(Base64, DecodePadding) {
   EXPECT_EQ(Base64::urlDecode("YWFh"), "aaa");
 }
 
+TEST(Base64, RoundTripAllBytes) {
+  std::string all;
+  for (int i = 0; i < 256; i++) {
+    all.push_back(char(i));
+  }
+  for (size_t len = 250; len <= 256; len++) {
+    auto sub = all.substr(0, len);
+    auto b64 = Base64::encode(
+        range(sub.data(), static_cast<int64_t>(sub.size())));
+    int padding = (3 - len % 3) % 3;
+    EXPECT_EQ(Base64::decode(b64, padding), sub);
+    EXPECT_EQ(Base64::urlDecode(Base64::urlEncode(
+                  range(sub.data(), static_cast<int64_t>(sub.size())))),
+              sub);
+  }
+}
+
+TEST(Base64, DecodeInvalid) {
+  // invalid characters and misplaced padding decode to empty
+  EXPECT_EQ(Base64::decode("[[[[", 0), "");
+  EXPECT_EQ(Base64::decode("YW=j", 0), "");
+  EXPECT_EQ(Base64::decode("YWJj", 1), "");
+  EXPECT_EQ(Base64::decode("YWJ", 0), "");
+}
+
 TEST(Base64, EncodeDecodeHighBits) {
   EXPECT_EQ(Base64::urlDecode("_--_"), std::string("\xff\xef\xbf", 3));
   EXPECT_EQ(Base64::urlEncode(range("\xff\xef\xbf", 3)), "_--_");
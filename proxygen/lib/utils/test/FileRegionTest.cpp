@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/portability/Fcntl.h>
+#include <folly/portability/GTest.h>
+
+#include "proxygen/lib/utils/FileRegion.h"
+
+using namespace proxygen;
+
+class FileRegionTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    contents_.reserve(64 * 1024);
+    for (size_t i = 0; i < 64 * 1024; i++) {
+      contents_.push_back('a' + (i % 26));
+    }
+    folly::writeFile(contents_, file_.path().c_str());
+    fd_ = open(file_.path().c_str(), O_RDONLY);
+    ASSERT_GE(fd_, 0);
+  }
+
+  void TearDown() override {
+    close(fd_);
+  }
+
+  folly::test::TemporaryFile file_;
+  std::string contents_;
+  int fd_{-1};
+};
+
+TEST_F(FileRegionTest, WholeFile) {
+  auto buf = FileRegion::mmapRange(fd_, 0, contents_.size());
+  ASSERT_NE(buf, nullptr);
+  EXPECT_EQ(buf->computeChainDataLength(), contents_.size());
+  EXPECT_EQ(buf->moveToFbString().toStdString(), contents_);
+}
+
+TEST_F(FileRegionTest, UnalignedRange) {
+  // offsets that don't sit on a page boundary still map correctly
+  auto buf = FileRegion::mmapRange(fd_, 4097, 8192, true /* prefault */);
+  ASSERT_NE(buf, nullptr);
+  EXPECT_EQ(buf->computeChainDataLength(), 8192);
+  EXPECT_EQ(buf->moveToFbString().toStdString(),
+            contents_.substr(4097, 8192));
+}
+
+TEST_F(FileRegionTest, EmptyRange) {
+  auto buf = FileRegion::mmapRange(fd_, 0, 0);
+  EXPECT_EQ(buf, nullptr);
+}
+
+TEST_F(FileRegionTest, BadFd) {
+  auto buf = FileRegion::mmapRange(-1, 0, 4096);
+  EXPECT_EQ(buf, nullptr);
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include "proxygen/lib/utils/PercentileHistogram.h"
+
+using namespace proxygen;
+
+TEST(PercentileHistogramTest, Empty) {
+  PercentileHistogram hist;
+  EXPECT_EQ(hist.count(), 0);
+  EXPECT_EQ(hist.estimatePercentile(50), 0);
+}
+
+TEST(PercentileHistogramTest, ExactLowValues) {
+  PercentileHistogram hist;
+  for (uint64_t v = 0; v < 16; v++) {
+    hist.record(v);
+  }
+  EXPECT_EQ(hist.count(), 16);
+  // low values are bucketed exactly
+  EXPECT_EQ(hist.estimatePercentile(100), 15);
+  EXPECT_EQ(hist.estimatePercentile(6.25), 0);
+}
+
+TEST(PercentileHistogramTest, RelativeError) {
+  PercentileHistogram hist;
+  for (uint64_t i = 0; i < 10000; i++) {
+    hist.record(1000);
+  }
+  hist.record(1000000);
+  auto p50 = hist.estimatePercentile(50);
+  EXPECT_GE(p50, 1000);
+  EXPECT_LE(p50, 1063); // within one sub-bucket (~6%)
+  auto p100 = hist.estimatePercentile(100);
+  EXPECT_GE(p100, 1000000);
+  EXPECT_LE(p100, 1048575);
+}
+
+TEST(PercentileHistogramTest, Clear) {
+  PercentileHistogram hist;
+  hist.record(42);
+  EXPECT_EQ(hist.count(), 1);
+  hist.clear();
+  EXPECT_EQ(hist.count(), 0);
+  EXPECT_EQ(hist.estimatePercentile(99), 0);
+}
+
+TEST(PercentileHistogramTest, HugeValues) {
+  PercentileHistogram hist;
+  hist.record(std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(hist.count(), 1);
+  EXPECT_GE(hist.estimatePercentile(100),
+            std::numeric_limits<uint64_t>::max() / 2);
+}
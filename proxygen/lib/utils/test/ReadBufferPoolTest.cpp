@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <thread>
+
+#include "proxygen/lib/utils/ReadBufferPool.h"
+
+using namespace proxygen;
+
+TEST(ReadBufferPoolTest, ObtainAndRecycle) {
+  auto buf = ReadBufferPool::obtain(4000);
+  ASSERT_NE(buf, nullptr);
+  EXPECT_EQ(buf->length(), 0);
+  EXPECT_GE(buf->capacity(), 4000);
+  const void* data = buf->data();
+  buf.reset();
+  // same thread, same size class: the slab comes back
+  auto buf2 = ReadBufferPool::obtain(4000);
+  EXPECT_EQ(buf2->data(), data);
+}
+
+TEST(ReadBufferPoolTest, SizeClasses) {
+  auto small = ReadBufferPool::obtain(100);
+  EXPECT_GE(small->capacity(), 100);
+  auto big = ReadBufferPool::obtain(50000);
+  EXPECT_GE(big->capacity(), 50000);
+  small.reset();
+  big.reset();
+  // distinct classes recycle independently
+  auto small2 = ReadBufferPool::obtain(100);
+  auto big2 = ReadBufferPool::obtain(50000);
+  EXPECT_GE(small2->capacity(), 100);
+  EXPECT_GE(big2->capacity(), 50000);
+}
+
+TEST(ReadBufferPoolTest, OversizedFallsBack) {
+  auto buf = ReadBufferPool::obtain(4 << 20);
+  ASSERT_NE(buf, nullptr);
+  EXPECT_GE(buf->capacity(), 4 << 20);
+}
+
+TEST(ReadBufferPoolTest, CrossThreadReleaseIsSafe) {
+  auto buf = ReadBufferPool::obtain(4000);
+  std::thread t([buf = std::move(buf)]() mutable { buf.reset(); });
+  t.join();
+}
+
+TEST(ReadBufferPoolTest, ReleaseAfterThreadExitIsSafe) {
+  std::unique_ptr<folly::IOBuf> buf;
+  std::thread t([&buf] { buf = ReadBufferPool::obtain(4000); });
+  t.join();
+  buf.reset();
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+
+#include <deque>
+#include <queue>
+
+#include "proxygen/lib/utils/RecyclableArena.h"
+
+using namespace proxygen;
+
+TEST(RecyclableArenaTest, AllocateWithinBlock) {
+  RecyclableArena arena(128);
+  auto p1 = arena.allocate(16);
+  auto p2 = arena.allocate(16);
+  EXPECT_NE(p1, nullptr);
+  EXPECT_NE(p1, p2);
+  // both allocations fit in a single block
+  EXPECT_EQ(arena.bytesAllocated(), 128);
+}
+
+TEST(RecyclableArenaTest, GrowAndReset) {
+  RecyclableArena arena(64);
+  arena.allocate(48);
+  arena.allocate(48); // spills into a second block
+  EXPECT_EQ(arena.bytesAllocated(), 128);
+  arena.reset();
+  // the first block is retained for reuse
+  EXPECT_EQ(arena.bytesAllocated(), 64);
+  auto p = arena.allocate(48);
+  EXPECT_NE(p, nullptr);
+  EXPECT_EQ(arena.bytesAllocated(), 64);
+}
+
+TEST(RecyclableArenaTest, OversizedAllocation) {
+  RecyclableArena arena(64);
+  auto p = arena.allocate(1024);
+  EXPECT_NE(p, nullptr);
+  EXPECT_EQ(arena.bytesAllocated(), 1024);
+  arena.reset();
+  // the oversized block was first, so it is the one retained
+  EXPECT_EQ(arena.bytesAllocated(), 1024);
+}
+
+TEST(RecyclableArenaTest, StlContainer) {
+  RecyclableArena arena;
+  std::queue<uint64_t, std::deque<uint64_t, RecyclableArena::Allocator<
+      uint64_t>>> q{RecyclableArena::Allocator<uint64_t>(arena)};
+  for (uint64_t i = 0; i < 1000; i++) {
+    q.push(i);
+  }
+  for (uint64_t i = 0; i < 1000; i++) {
+    EXPECT_EQ(q.front(), i);
+    q.pop();
+  }
+  EXPECT_GE(arena.bytesAllocated(), 1000 * sizeof(uint64_t));
+}
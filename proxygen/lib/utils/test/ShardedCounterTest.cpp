@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <thread>
+#include <vector>
+
+#include "proxygen/lib/stats/ShardedCounter.h"
+
+using namespace proxygen;
+
+TEST(ShardedCounterTest, SingleThread) {
+  ShardedCounter counter;
+  EXPECT_EQ(counter.get(), 0);
+  ++counter;
+  counter += 41;
+  EXPECT_EQ(counter.get(), 42);
+  counter.increment(-2);
+  EXPECT_EQ(counter.get(), 40);
+}
+
+TEST(ShardedCounterTest, MultiThread) {
+  ShardedCounter counter;
+  constexpr int kThreads = 8;
+  constexpr int kIncrements = 10000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i < kIncrements; i++) {
+        ++counter;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // exited threads' shards fold into the retained total
+  EXPECT_EQ(counter.get(), kThreads * kIncrements);
+}
+
+TEST(ShardedCounterTest, ReadWhileWriting) {
+  ShardedCounter counter;
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    while (!stop.load()) {
+      ++counter;
+    }
+  });
+  for (int i = 0; i < 100; i++) {
+    EXPECT_GE(counter.get(), 0);
+  }
+  stop = true;
+  writer.join();
+  EXPECT_GT(counter.get(), 0);
+}
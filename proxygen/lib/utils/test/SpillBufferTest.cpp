@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/io/IOBuf.h>
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/utils/SpillBuffer.h>
+
+using namespace proxygen;
+
+namespace {
+
+std::unique_ptr<folly::IOBuf> makePattern(char seed, size_t size) {
+  auto buf = folly::IOBuf::create(size);
+  for (size_t i = 0; i < size; i++) {
+    buf->writableTail()[i] = char(seed + (i % 23));
+  }
+  buf->append(size);
+  return buf;
+}
+
+void expectPattern(const folly::IOBuf* buf, char seed, size_t size) {
+  ASSERT_NE(buf, nullptr);
+  ASSERT_EQ(buf->computeChainDataLength(), size);
+  size_t i = 0;
+  for (auto range : *buf) {
+    for (auto byte : range) {
+      EXPECT_EQ(char(byte), char(seed + (i % 23)));
+      i++;
+    }
+  }
+}
+
+} // namespace
+
+TEST(SpillBufferTest, AppendSplitRoundtrip) {
+  SpillBuffer spill("/tmp");
+  EXPECT_TRUE(spill.empty());
+
+  auto first = makePattern('a', 1000);
+  ASSERT_TRUE(spill.append(*first));
+  EXPECT_EQ(spill.bytes(), 1000);
+
+  // chained input spills as one contiguous run
+  auto chained = makePattern('a', 500);
+  chained->appendChain(makePattern('x', 300));
+  ASSERT_TRUE(spill.append(*chained));
+  EXPECT_EQ(spill.bytes(), 1800);
+
+  expectPattern(spill.splitAtMost(1000).get(), 'a', 1000);
+  EXPECT_EQ(spill.bytes(), 800);
+  expectPattern(spill.splitAtMost(500).get(), 'a', 500);
+  expectPattern(spill.splitAtMost(10000).get(), 'x', 300);
+  EXPECT_TRUE(spill.empty());
+  EXPECT_FALSE(spill.hasError());
+
+  // drained buffers truncate and are reusable
+  auto second = makePattern('q', 64);
+  ASSERT_TRUE(spill.append(*second));
+  expectPattern(spill.splitAtMost(64).get(), 'q', 64);
+  EXPECT_TRUE(spill.empty());
+}
+
+TEST(SpillBufferTest, EmptyAndLazy) {
+  SpillBuffer spill("/tmp");
+  // no file is created until the first append
+  EXPECT_EQ(spill.splitAtMost(100), nullptr);
+  EXPECT_TRUE(spill.empty());
+  EXPECT_FALSE(spill.hasError());
+}
+
+TEST(SpillBufferTest, BadDirectoryLatchesError) {
+  SpillBuffer spill("/nonexistent-spill-dir");
+  auto buf = makePattern('z', 10);
+  EXPECT_FALSE(spill.append(*buf));
+  EXPECT_TRUE(spill.hasError());
+  // the caller keeps its data and can buffer it in memory instead
+  expectPattern(buf.get(), 'z', 10);
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <proxygen/lib/utils/ThreadLocalPoolAllocator.h>
+#include <unordered_map>
+
+using namespace proxygen;
+
+TEST(ThreadLocalPoolAllocatorTest, RecyclesMapNodes) {
+  using Map = std::unordered_map<
+      uint64_t,
+      std::string,
+      std::hash<uint64_t>,
+      std::equal_to<uint64_t>,
+      ThreadLocalPoolAllocator<std::pair<const uint64_t, std::string>>>;
+  Map map;
+  // churn insert/erase; the container must stay correct while nodes
+  // cycle through the pool
+  for (int round = 0; round < 100; round++) {
+    for (uint64_t i = 0; i < 50; i++) {
+      map.emplace(i, std::to_string(i * round));
+    }
+    EXPECT_EQ(map.size(), 50);
+    EXPECT_EQ(map.at(7), std::to_string(7 * round));
+    for (uint64_t i = 0; i < 50; i++) {
+      map.erase(i);
+    }
+    EXPECT_TRUE(map.empty());
+  }
+}
+
+TEST(ThreadLocalPoolAllocatorTest, SingleObjectRoundtrip) {
+  ThreadLocalPoolAllocator<uint64_t> alloc;
+  auto first = alloc.allocate(1);
+  *first = 42;
+  alloc.deallocate(first, 1);
+  // the very next single allocation reuses the pooled slot
+  auto second = alloc.allocate(1);
+  EXPECT_EQ(second, first);
+  alloc.deallocate(second, 1);
+
+  // bulk allocations bypass the pool
+  auto bulk = alloc.allocate(16);
+  EXPECT_NE(bulk, nullptr);
+  alloc.deallocate(bulk, 16);
+}
@@ -20,3 +20,20 @@ TEST(TimeTest, GetDateTimeStr) {
       sys_tp - SystemClock::now());
   ASSERT_EQ("1970-01-01T00:00:00 +0000", getDateTimeStr(tp));
 }
+
+TEST(TimeTest, CachedNow) {
+  // without a refresher installed on this thread, getCachedNow falls
+  // back to a live read
+  auto before = getCurrentTime();
+  auto live = getCachedNow();
+  EXPECT_GE(live, before);
+
+  // once refreshed, reads return the cached value until the next
+  // refresh
+  auto refreshed = refreshCachedNow();
+  EXPECT_EQ(getCachedNow(), refreshed);
+  EXPECT_EQ(getCachedNow(), refreshed);
+  auto again = refreshCachedNow();
+  EXPECT_GE(again, refreshed);
+  EXPECT_EQ(getCachedNow(), again);
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) Facebook, Inc. and its affiliates.
+ * All rights reserved.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <folly/portability/GTest.h>
+#include <thread>
+#include <vector>
+
+#include "proxygen/lib/utils/TraceEventRing.h"
+
+using namespace proxygen;
+
+namespace {
+TraceEvent makeEvent(uint32_t parentId = 0) {
+  TraceEvent event(TraceEventType::TotalRequest, parentId);
+  event.start(getCurrentTime());
+  event.end(getCurrentTime());
+  return event;
+}
+} // namespace
+
+TEST(TraceEventRingTest, RecordAndDrain) {
+  TraceEventRing ring(16);
+  ring.traceEventAvailable(makeEvent(7));
+  ring.traceEventAvailable(makeEvent(7));
+  std::vector<TraceEventRing::Record> drained;
+  ring.drain([&](const TraceEventRing::Record& rec) {
+    drained.push_back(rec);
+  });
+  ASSERT_EQ(drained.size(), 2);
+  EXPECT_EQ(drained[0].type, TraceEventType::TotalRequest);
+  EXPECT_EQ(drained[0].parentId, 7);
+  EXPECT_LE(drained[0].startUsec, drained[0].endUsec);
+  // drained records are consumed
+  size_t more = 0;
+  ring.drain([&](const TraceEventRing::Record&) { more++; });
+  EXPECT_EQ(more, 0);
+}
+
+TEST(TraceEventRingTest, DropsWhenFull) {
+  TraceEventRing ring(4);
+  for (int i = 0; i < 10; i++) {
+    ring.traceEventAvailable(makeEvent());
+  }
+  EXPECT_GT(ring.numDropped(), 0);
+  size_t drained = 0;
+  ring.drain([&](const TraceEventRing::Record&) { drained++; });
+  EXPECT_EQ(drained, 4);
+  // space reclaimed after draining
+  ring.traceEventAvailable(makeEvent());
+  drained = 0;
+  ring.drain([&](const TraceEventRing::Record&) { drained++; });
+  EXPECT_EQ(drained, 1);
+}
+
+TEST(TraceEventRingTest, Sampling) {
+  TraceEventRing ring(64);
+  ring.setSampleRate(10);
+  for (int i = 0; i < 100; i++) {
+    ring.traceEventAvailable(makeEvent());
+  }
+  size_t drained = 0;
+  ring.drain([&](const TraceEventRing::Record&) { drained++; });
+  EXPECT_EQ(drained, 10);
+
+  ring.setSampleRate(0);
+  ring.traceEventAvailable(makeEvent());
+  drained = 0;
+  ring.drain([&](const TraceEventRing::Record&) { drained++; });
+  EXPECT_EQ(drained, 0);
+}
+
+TEST(TraceEventRingTest, CrossThreadDrain) {
+  TraceEventRing ring(1024);
+  std::thread producer([&ring] {
+    for (int i = 0; i < 500; i++) {
+      ring.traceEventAvailable(makeEvent());
+    }
+  });
+  size_t drained = 0;
+  while (drained < 500) {
+    ring.drain([&](const TraceEventRing::Record&) { drained++; });
+  }
+  producer.join();
+  EXPECT_EQ(drained, 500);
+  EXPECT_EQ(ring.numDropped(), 0);
+}
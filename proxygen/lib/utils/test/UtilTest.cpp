@@ -33,3 +33,27 @@ TEST(UtilTest, findLastOf) {
   EXPECT_EQ(findLastOf(p4, '.'), std::string::npos);
   EXPECT_EQ(findLastOf(p5, '.'), 3);
 }
+
+TEST(UtilTest, DecodePercentCleanPassThrough) {
+  std::string scratch("sentinel");
+  folly::StringPiece input("/plain/path/with/no/escapes?and=query");
+  auto out = decodePercent(input, scratch);
+  // clean input returns the input piece itself; scratch untouched
+  EXPECT_EQ(out.begin(), input.begin());
+  EXPECT_EQ(scratch, "sentinel");
+}
+
+TEST(UtilTest, DecodePercentDecodes) {
+  std::string scratch;
+  EXPECT_EQ(decodePercent("a%20b%2Fc", scratch), "a b/c");
+  EXPECT_EQ(decodePercent("%41%61%30", scratch), "Aa0");
+  // malformed escapes pass through literally
+  EXPECT_EQ(decodePercent("x%2", scratch), "x%2");
+  EXPECT_EQ(decodePercent("x%zz-y", scratch), "x%zz-y");
+  EXPECT_EQ(decodePercent("%", scratch), "%");
+  // long runs cross the word-at-a-time scan
+  std::string longInput(100, 'q');
+  longInput += "%21";
+  EXPECT_EQ(decodePercent(longInput, scratch),
+            std::string(100, 'q') + "!");
+}
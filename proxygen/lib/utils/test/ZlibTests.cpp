@@ -12,6 +12,7 @@
 #include <folly/io/IOBuf.h>
 #include <folly/portability/GTest.h>
 #include <glog/logging.h>
+#include <proxygen/lib/utils/RecompressionPipeline.h>
 #include <proxygen/lib/utils/ZlibStreamCompressor.h>
 #include <proxygen/lib/utils/ZlibStreamDecompressor.h>
 
@@ -91,6 +92,18 @@ TEST_F(ZlibTests, CompressDecompressGzip50) {
       { compressThenDecompress(CompressionType::GZIP, 6, makeBuf(50)); });
 }
 
+TEST_F(ZlibTests, PooledContextReuse) {
+  // back-to-back compressors with matching parameters recycle the
+  // deflate state through the per-thread pool; output must stay correct
+  for (int i = 0; i < 3; i++) {
+    ASSERT_NO_FATAL_FAILURE(
+        { compressThenDecompress(CompressionType::GZIP, 6, makeBuf(2000)); });
+  }
+  // a different level must not pick up a level-6 context
+  ASSERT_NO_FATAL_FAILURE(
+      { compressThenDecompress(CompressionType::GZIP, 1, makeBuf(2000)); });
+}
+
 TEST_F(ZlibTests, CompressDecompressDeflate) {
   ASSERT_NO_FATAL_FAILURE(
       { compressThenDecompress(CompressionType::DEFLATE, 6, makeBuf(500)); });
@@ -146,3 +159,54 @@ TEST_F(ZlibTests, CompressDecompressSmallBuffer) {
     compressThenDecompress(CompressionType::GZIP, 4, makeBuf(127));
   });
 }
+
+TEST_F(ZlibTests, RecompressionPipeline) {
+  ASSERT_NO_FATAL_FAILURE({
+    // origin gzip at level 9, recompress for the client at level 1
+    auto original = makeBuf(8000);
+    ZlibStreamCompressor origin(CompressionType::GZIP, 9);
+    auto originCompressed = origin.compress(original.get(), true);
+
+    RecompressionPipeline pipeline(
+        CompressionType::GZIP, CompressionType::GZIP, 1);
+    // feed the origin stream in pieces, as a proxy would
+    auto recompressed = pipeline.transform(originCompressed.get(), true);
+    ASSERT_FALSE(pipeline.hasError());
+    verify(CompressionType::GZIP, original->clone(), std::move(recompressed));
+
+    // the pipeline is reusable for the next message after reset()
+    pipeline.reset();
+    auto second = makeBuf(500);
+    ZlibStreamCompressor origin2(CompressionType::GZIP, 9);
+    auto secondCompressed = origin2.compress(second.get(), true);
+    recompressed = pipeline.transform(secondCompressed.get(), true);
+    ASSERT_FALSE(pipeline.hasError());
+    verify(CompressionType::GZIP, std::move(second), std::move(recompressed));
+  });
+}
+
+TEST_F(ZlibTests, RecompressionPipelineDictionary) {
+  ASSERT_NO_FATAL_FAILURE({
+    auto dictionary = std::make_shared<const std::string>(
+        "{\"status\":\"ok\",\"result\":");
+    std::string body = "{\"status\":\"ok\",\"result\":[1,2,3]}";
+    auto original = IOBuf::copyBuffer(body);
+    ZlibStreamCompressor origin(CompressionType::DEFLATE, 9);
+    auto originCompressed = origin.compress(original.get(), true);
+
+    RecompressionPipeline pipeline(CompressionType::DEFLATE,
+                                   CompressionType::DEFLATE,
+                                   6,
+                                   dictionary);
+    auto recompressed = pipeline.transform(originCompressed.get(), true);
+    ASSERT_FALSE(pipeline.hasError());
+
+    ASSERT_NE(recompressed, nullptr);
+    // the dictionary was really applied: a dictionary-less inflater
+    // stops at Z_NEED_DICT instead of producing data
+    ZlibStreamDecompressor client(CompressionType::DEFLATE);
+    auto decompressed = client.decompress(recompressed.get());
+    EXPECT_TRUE(client.hasError());
+    EXPECT_EQ(client.getStatus(), Z_NEED_DICT);
+  });
+}
@@ -13,6 +13,7 @@
 #include <folly/io/IOBuf.h>
 #include <folly/portability/GTest.h>
 #include <glog/logging.h>
+#include <proxygen/lib/utils/ZstdStreamCompressor.h>
 #include <proxygen/lib/utils/ZstdStreamDecompressor.h>
 
 using namespace folly;
@@ -152,6 +153,46 @@ TEST_F(ZstdTests, CompressDecompressChain) {
   });
 }
 
+TEST_F(ZstdTests, StreamCompressorRoundTrip) {
+  // our pooled streaming compressor against our decompressor, with
+  // context reuse across instances
+  for (int round = 0; round < 3; round++) {
+    auto buf = makeBuf(5000);
+    ZstdStreamCompressor compressor;
+    ASSERT_FALSE(compressor.hasError());
+    auto compressed = compressor.compress(buf.get(), true);
+    ASSERT_NE(compressed, nullptr);
+    ASSERT_FALSE(compressor.hasError());
+
+    ZstdStreamDecompressor decompressor;
+    auto decompressed = decompressor.decompress(compressed.get());
+    ASSERT_NE(decompressed, nullptr);
+    ASSERT_FALSE(decompressor.hasError());
+    EXPECT_TRUE(decompressor.finished());
+    EXPECT_TRUE(folly::IOBufEqualTo()(*buf, *decompressed));
+  }
+}
+
+TEST_F(ZstdTests, StreamCompressorChunks) {
+  // multiple compress calls with a trailer only on the last
+  auto chunk1 = makeBuf(2000);
+  auto chunk2 = makeBuf(3000);
+  ZstdStreamCompressor compressor;
+  auto out = compressor.compress(chunk1.get(), false);
+  ASSERT_NE(out, nullptr);
+  auto out2 = compressor.compress(chunk2.get(), true);
+  ASSERT_NE(out2, nullptr);
+  out->prependChain(std::move(out2));
+
+  ZstdStreamDecompressor decompressor;
+  auto decompressed = decompressor.decompress(out.get());
+  ASSERT_NE(decompressed, nullptr);
+  EXPECT_TRUE(decompressor.finished());
+  auto expected = std::move(chunk1);
+  expected->prependChain(std::move(chunk2));
+  EXPECT_TRUE(folly::IOBufEqualTo()(*expected, *decompressed));
+}
+
 TEST_F(ZstdTests, CompressDecompressStreaming) {
   std::vector<std::unique_ptr<folly::IOBuf>> input_pieces;
   input_pieces.push_back(makeBuf(38));
@@ -0,0 +1,89 @@
+#!/usr/bin/env bash
+# Copyright (c) Facebook, Inc. and its affiliates.
+# All rights reserved.
+#
+# This source code is licensed under the BSD-style license found in the
+# LICENSE file in the root directory of this source tree.
+#
+# Training workload for PGO builds.  Run against a tree configured with
+# -DPROXYGEN_PGO=generate (see the PGO section in the top-level
+# CMakeLists.txt): drives the echo and static samples with h1 and h2
+# traffic, and hq when it was built, so the profiles cover the codec,
+# session and server hot paths.  Afterwards, for clang:
+#
+#   llvm-profdata merge -o <profile-dir>/proxygen.profdata \
+#       <profile-dir>/*.profraw
+#
+# then reconfigure with -DPROXYGEN_PGO=use.
+
+set -e
+
+BUILD_DIR=${1:-_build}
+# absolute, since the static sample is started from a different cwd
+BUILD_DIR=$(cd "$BUILD_DIR" && pwd)
+PORT=${PGO_TRAIN_PORT:-8351}
+DURATION=${PGO_TRAIN_SECONDS:-30}
+DOCROOT=$(mktemp -d)
+
+cleanup() {
+  [ -n "$SERVER_PID" ] && kill "$SERVER_PID" 2>/dev/null || true
+  rm -rf "$DOCROOT"
+}
+trap cleanup EXIT
+
+H2_PORT=$((PORT + 1))
+
+run_load() {
+  # h1 keep-alive on --http_port, h2 prior-knowledge on --h2_port
+  local path=$1
+  local deadline=$(($(date +%s) + DURATION / 2))
+  while [ "$(date +%s)" -lt "$deadline" ]; do
+    curl -s -o /dev/null \
+        "http://127.0.0.1:$PORT$path" "http://127.0.0.1:$PORT$path" \
+        "http://127.0.0.1:$PORT$path" "http://127.0.0.1:$PORT$path"
+    curl -s -o /dev/null --http2-prior-knowledge \
+        "http://127.0.0.1:$H2_PORT$path" "http://127.0.0.1:$H2_PORT$path" \
+        || true
+  done
+}
+
+echo "== echo sample =="
+"$BUILD_DIR/proxygen/httpserver/proxygen_echo" \
+    --http_port "$PORT" --h2_port "$H2_PORT" --ip 127.0.0.1 &
+SERVER_PID=$!
+sleep 1
+run_load "/"
+kill "$SERVER_PID"
+wait "$SERVER_PID" 2>/dev/null || true
+SERVER_PID=""
+
+echo "== static sample =="
+head -c 1048576 /dev/urandom > "$DOCROOT/train.bin"
+# StaticHandler serves paths relative to the server's working directory
+(cd "$DOCROOT" && \
+    exec "$BUILD_DIR/proxygen/httpserver/proxygen_static" \
+        --http_port "$PORT" --h2_port "$H2_PORT" --ip 127.0.0.1) &
+SERVER_PID=$!
+sleep 1
+run_load "/train.bin"
+kill "$SERVER_PID"
+wait "$SERVER_PID" 2>/dev/null || true
+SERVER_PID=""
+
+HQ_BIN="$BUILD_DIR/proxygen/httpserver/hq"
+if [ -x "$HQ_BIN" ]; then
+  echo "== hq sample (h3) =="
+  "$HQ_BIN" --mode=server --port "$PORT" &
+  SERVER_PID=$!
+  sleep 1
+  deadline=$(($(date +%s) + DURATION / 2))
+  while [ "$(date +%s)" -lt "$deadline" ]; do
+    "$HQ_BIN" --mode=client --port "$PORT" --path=/ >/dev/null 2>&1 || true
+  done
+  kill "$SERVER_PID"
+  wait "$SERVER_PID" 2>/dev/null || true
+  SERVER_PID=""
+fi
+
+echo "Training done; profiles are in the directory configured via"
+echo "PROXYGEN_PGO_PROFILE_DIR (default: <build>/pgo-profiles)."